@@ -0,0 +1,71 @@
+/**
+ * @file sat_allocator.h
+ * @brief Pluggable memory allocator interface for SAT containers
+ *
+ * Containers accept a sat_allocator_t in their creation arguments and route
+ * every internal allocation through it. A zero-initialized allocator selects
+ * the C library (malloc, realloc and free), so existing callers are not
+ * affected. Other allocators, such as sat_arena, fill in the callbacks and a
+ * context pointer.
+ */
+
+#ifndef SAT_ALLOCATOR_H_
+#define SAT_ALLOCATOR_H_
+
+#include <stddef.h>
+
+/**
+ * @brief Allocator callback table
+ *
+ * When allocate is NULL the whole table is ignored and the C library is used.
+ * When reallocate is NULL, reallocation is done with allocate, memcpy and
+ * release. When release is NULL, releasing memory is a no-op, which suits
+ * allocators that free everything at once.
+ */
+typedef struct
+{
+    void *context;                                                                                          /**< Passed back to every callback */
+    void *(*allocate) (void *const context, const size_t size);                                             /**< Returns size bytes or NULL */
+    void *(*reallocate) (void *const context, void *const pointer, const size_t old_size, const size_t new_size);   /**< Resizes a block, keeping its contents */
+    void (*release) (void *const context, void *const pointer, const size_t size);                          /**< Gives a block back */
+} sat_allocator_t;
+
+/**
+ * @brief Allocates memory through an allocator
+ *
+ * @param[in] allocator Allocator to use, NULL selects the C library
+ * @param[in] size Number of bytes
+ * @return Pointer to the memory, or NULL on failure
+ */
+void *sat_allocator_allocate (const sat_allocator_t *const allocator, const size_t size);
+
+/**
+ * @brief Allocates zero-filled memory through an allocator
+ *
+ * @param[in] allocator Allocator to use, NULL selects the C library
+ * @param[in] size Number of bytes
+ * @return Pointer to the memory, or NULL on failure
+ */
+void *sat_allocator_allocate_zeroed (const sat_allocator_t *const allocator, const size_t size);
+
+/**
+ * @brief Resizes memory obtained from the same allocator
+ *
+ * @param[in] allocator Allocator that owns the memory, NULL selects the C library
+ * @param[in] pointer Memory to resize, may be NULL
+ * @param[in] old_size Current size in bytes
+ * @param[in] new_size Requested size in bytes
+ * @return Pointer to the resized memory, or NULL on failure (the original is kept)
+ */
+void *sat_allocator_reallocate (const sat_allocator_t *const allocator, void *const pointer, const size_t old_size, const size_t new_size);
+
+/**
+ * @brief Releases memory obtained from the same allocator
+ *
+ * @param[in] allocator Allocator that owns the memory, NULL selects the C library
+ * @param[in] pointer Memory to release, may be NULL
+ * @param[in] size Size in bytes given when the memory was obtained
+ */
+void sat_allocator_release (const sat_allocator_t *const allocator, void *const pointer, const size_t size);
+
+#endif/* SAT_ALLOCATOR_H_ */
@@ -0,0 +1,61 @@
+#include <sat_allocator.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+static inline bool sat_allocator_is_custom (const sat_allocator_t *const allocator)
+{
+    return allocator != NULL && allocator->allocate != NULL;
+}
+
+void *sat_allocator_allocate (const sat_allocator_t *const allocator, const size_t size)
+{
+    if (sat_allocator_is_custom (allocator) == false)
+        return malloc (size);
+
+    return allocator->allocate (allocator->context, size);
+}
+
+void *sat_allocator_allocate_zeroed (const sat_allocator_t *const allocator, const size_t size)
+{
+    if (sat_allocator_is_custom (allocator) == false)
+        return calloc (1, size);
+
+    void *pointer = allocator->allocate (allocator->context, size);
+
+    if (pointer != NULL)
+        memset (pointer, 0, size);
+
+    return pointer;
+}
+
+void *sat_allocator_reallocate (const sat_allocator_t *const allocator, void *const pointer, const size_t old_size, const size_t new_size)
+{
+    if (sat_allocator_is_custom (allocator) == false)
+        return realloc (pointer, new_size);
+
+    if (allocator->reallocate != NULL)
+        return allocator->reallocate (allocator->context, pointer, old_size, new_size);
+
+    void *__new = allocator->allocate (allocator->context, new_size);
+
+    if (__new != NULL && pointer != NULL)
+    {
+        memcpy (__new, pointer, old_size < new_size ? old_size : new_size);
+        sat_allocator_release (allocator, pointer, old_size);
+    }
+
+    return __new;
+}
+
+void sat_allocator_release (const sat_allocator_t *const allocator, void *const pointer, const size_t size)
+{
+    if (sat_allocator_is_custom (allocator) == false)
+    {
+        free (pointer);
+        return;
+    }
+
+    if (allocator->release != NULL && pointer != NULL)
+        allocator->release (allocator->context, pointer, size);
+}
@@ -0,0 +1,59 @@
+#include <sat.h>
+#include <stdio.h>
+
+typedef struct
+{
+    size_t in_use;
+    size_t peak;
+} tracker_t;
+
+static void *tracker_allocate (void *const context, const size_t size)
+{
+    tracker_t *tracker = (tracker_t *) context;
+
+    tracker->in_use += size;
+    if (tracker->in_use > tracker->peak)
+        tracker->peak = tracker->in_use;
+
+    return malloc (size);
+}
+
+static void tracker_release (void *const context, void *const pointer, const size_t size)
+{
+    tracker_t *tracker = (tracker_t *) context;
+
+    tracker->in_use -= size;
+    free (pointer);
+}
+
+int main (int argc, char *argv[])
+{
+    tracker_t tracker = {0};
+
+    sat_array_t *array;
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 8,
+                                                        .object_size = sizeof (int),
+                                                        .mode = sat_array_mode_dynamic,
+                                                        .allocator =
+                                                        {
+                                                            .context = &tracker,
+                                                            .allocate = tracker_allocate,
+                                                            .release = tracker_release,
+                                                        },
+                                                    });
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    for (int i = 0; i < 1000; i++)
+        sat_array_add (array, &i);
+
+    printf ("In use: %zu bytes, peak: %zu bytes\n", tracker.in_use, tracker.peak);
+
+    sat_array_destroy (array);
+
+    printf ("In use after destroy: %zu bytes\n", tracker.in_use);
+
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+
+typedef struct
+{
+    uint32_t allocations;
+    uint32_t releases;
+    size_t in_use;
+} counting_t;
+
+static void *counting_allocate (void *const context, const size_t size)
+{
+    counting_t *counting = (counting_t *) context;
+
+    counting->allocations ++;
+    counting->in_use += size;
+
+    return malloc (size);
+}
+
+static void counting_release (void *const context, void *const pointer, const size_t size)
+{
+    counting_t *counting = (counting_t *) context;
+
+    counting->releases ++;
+    counting->in_use -= size;
+
+    free (pointer);
+}
+
+static bool compare_int (void *key, void *data)
+{
+    return *(int *) key == *(int *) data;
+}
+
+static bool is_equal_int (const void *const element, const void *const new_element)
+{
+    return *(const int *) element == *(const int *) new_element;
+}
+
+static uint32_t hash_int (const void *const key, const uint32_t key_size)
+{
+    (void) key_size;
+    return (uint32_t) *(const int *) key;
+}
+
+static void test_default (void)
+{
+    char *buffer = sat_allocator_allocate_zeroed (NULL, 32);
+    assert (buffer != NULL);
+    assert (buffer [31] == 0);
+
+    memcpy (buffer, "sat", 4);
+
+    buffer = sat_allocator_reallocate (NULL, buffer, 32, 4096);
+    assert (buffer != NULL);
+    assert (strcmp (buffer, "sat") == 0);
+
+    sat_allocator_release (NULL, buffer, 4096);
+
+    // A zero-initialized table behaves like a NULL one.
+    sat_allocator_t allocator = {0};
+
+    buffer = sat_allocator_allocate (&allocator, 16);
+    assert (buffer != NULL);
+    sat_allocator_release (&allocator, buffer, 16);
+}
+
+static void test_reallocate_fallback (void)
+{
+    counting_t counting = {0};
+    sat_allocator_t allocator =
+    {
+        .context = &counting,
+        .allocate = counting_allocate,
+        .release = counting_release,
+    };
+
+    int *numbers = sat_allocator_allocate (&allocator, 4 * sizeof (int));
+    assert (numbers != NULL);
+
+    for (int i = 0; i < 4; i++)
+        numbers [i] = i;
+
+    numbers = sat_allocator_reallocate (&allocator, numbers, 4 * sizeof (int), 64 * sizeof (int));
+    assert (numbers != NULL);
+
+    for (int i = 0; i < 4; i++)
+        assert (numbers [i] == i);
+
+    assert (counting.allocations == 2);
+    assert (counting.releases == 1);
+
+    sat_allocator_release (&allocator, numbers, 64 * sizeof (int));
+
+    assert (counting.in_use == 0);
+}
+
+static void test_containers (void)
+{
+    counting_t counting = {0};
+    sat_allocator_t allocator =
+    {
+        .context = &counting,
+        .allocate = counting_allocate,
+        .release = counting_release,
+    };
+
+    sat_array_t *array;
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 2,
+                                                        .object_size = sizeof (int),
+                                                        .mode = sat_array_mode_dynamic,
+                                                        .allocator = allocator,
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_map_t *map;
+    status = sat_map_create (&map, &(sat_map_args_t)
+                                   {
+                                       .key_size = sizeof (int),
+                                       .value_size = sizeof (int),
+                                       .list_size = 2,
+                                       .mode = sat_map_mode_dynamic,
+                                       .hash = hash_int,
+                                       .allocator = allocator,
+                                   });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_set_t *set;
+    status = sat_set_create (&set, &(sat_set_args_t)
+                                   {
+                                       .size = 2,
+                                       .object_size = sizeof (int),
+                                       .is_equal = is_equal_int,
+                                       .mode = sat_set_mode_dynamic,
+                                       .allocator = allocator,
+                                   });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_queue_t *queue;
+    status = sat_queue_create_with_args (&queue, &(sat_queue_args_t)
+                                                 {
+                                                     .object_size = sizeof (int),
+                                                     .mode = sat_queue_mode_linked,
+                                                     .allocator = allocator,
+                                                 });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_linked_list_t *list;
+    status = sat_linked_list_create_with_args (&list, &(sat_linked_list_args_t)
+                                                      {
+                                                          .object_size = sizeof (int),
+                                                          .allocator = allocator,
+                                                      });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_stack_t *stack;
+    status = sat_stack_create_with_args (&stack, &(sat_stack_args_t)
+                                                 {
+                                                     .size = 128,
+                                                     .object_size = sizeof (int),
+                                                     .allocator = allocator,
+                                                 });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < 100; i++)
+    {
+        int value = i * 2;
+
+        status = sat_array_add (array, &i);
+        assert (sat_status_get_result (&status) == true);
+
+        status = sat_map_add (map, &i, &value);
+        assert (sat_status_get_result (&status) == true);
+
+        status = sat_set_add (set, &i);
+        assert (sat_status_get_result (&status) == true);
+
+        status = sat_queue_enqueue (queue, &i);
+        assert (sat_status_get_result (&status) == true);
+
+        status = sat_linked_list_insert (list, &i);
+        assert (sat_status_get_result (&status) == true);
+
+        status = sat_stack_push (stack, &i);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    int key = 42;
+    int value = 0;
+
+    status = sat_map_get_value_by (map, &key, &value, compare_int);
+    assert (sat_status_get_result (&status) == true);
+    assert (value == 84);
+
+    for (int i = 0; i < 50; i++)
+    {
+        status = sat_queue_dequeue (queue, &value);
+        assert (sat_status_get_result (&status) == true);
+        assert (value == i);
+    }
+
+    assert (counting.allocations > 6);
+    assert (counting.in_use > 0);
+
+    sat_array_destroy (array);
+    sat_map_destroy (map);
+    sat_set_destroy (set);
+    sat_queue_destroy (queue);
+    sat_linked_list_destroy (list);
+    sat_stack_destroy (stack);
+
+    // Every byte requested through the hooks was given back with its size.
+    assert (counting.in_use == 0);
+    assert (counting.allocations == counting.releases);
+}
+
+int main (int argc, char *argv[])
+{
+    test_default ();
+    test_reallocate_fallback ();
+    test_containers ();
+
+    return 0;
+}
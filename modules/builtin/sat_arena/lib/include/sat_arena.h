@@ -0,0 +1,143 @@
+/**
+ * @file sat_arena.h
+ * @brief Region (bump) allocator with mark/reset
+ *
+ * An arena hands out memory by advancing an offset inside large blocks and
+ * never frees individual allocations. Everything carved from it is dropped at
+ * once with sat_arena_reset() or sat_arena_rewind(), which keep the blocks for
+ * the next round, or with sat_arena_destroy().
+ *
+ * sat_arena_get_allocator() exposes the arena as a sat_allocator_t so that
+ * containers created with it allocate from the arena. Such containers can be
+ * abandoned without calling their destroy function when the arena is reset.
+ */
+
+#ifndef SAT_ARENA_H_
+#define SAT_ARENA_H_
+
+#include <sat_status.h>
+#include <sat_allocator.h>
+#include <stddef.h>
+
+/**
+ * @brief Default size, in bytes, of each arena block
+ */
+#define SAT_ARENA_BLOCK_SIZE_DEFAULT    (64 * 1024)
+
+/**
+ * @brief Alignment, in bytes, of every arena allocation
+ */
+#define SAT_ARENA_ALIGNMENT             16
+
+/**
+ * @brief Opaque structure representing an arena
+ */
+typedef struct sat_arena_t sat_arena_t;
+
+/**
+ * @brief Configuration structure for arena creation
+ */
+typedef struct
+{
+    size_t block_size;      /**< Size of each block, 0 selects SAT_ARENA_BLOCK_SIZE_DEFAULT */
+} sat_arena_args_t;
+
+/**
+ * @brief Saved arena position
+ *
+ * Obtained with sat_arena_get_mark() and restored with sat_arena_rewind().
+ * Fields are internal.
+ */
+typedef struct
+{
+    void *block;
+    size_t used;
+} sat_arena_mark_t;
+
+/**
+ * @brief Creates a new arena
+ *
+ * The first block is allocated immediately.
+ *
+ * @param[out] object Pointer to the pointer that will hold the created arena
+ * @param[in] args Pointer to the configuration structure
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note The caller is responsible for calling sat_arena_destroy() to free resources
+ */
+sat_status_t sat_arena_create (sat_arena_t **const object, const sat_arena_args_t *const args);
+
+/**
+ * @brief Allocates memory from the arena
+ *
+ * Requests larger than the block size get a dedicated block.
+ *
+ * @param[in,out] object Pointer to the arena
+ * @param[in] size Number of bytes
+ * @param[out] pointer Pointer to store the address, aligned to SAT_ARENA_ALIGNMENT
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_arena_allocate (sat_arena_t *const object, const size_t size, void **const pointer);
+
+/**
+ * @brief Saves the current arena position
+ *
+ * @param[in] object Pointer to the arena
+ * @param[out] mark Pointer to store the position
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_arena_get_mark (const sat_arena_t *const object, sat_arena_mark_t *const mark);
+
+/**
+ * @brief Drops every allocation made after a mark
+ *
+ * @param[in,out] object Pointer to the arena
+ * @param[in] mark Position obtained from sat_arena_get_mark()
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @warning Marks taken after @p mark become invalid
+ */
+sat_status_t sat_arena_rewind (sat_arena_t *const object, const sat_arena_mark_t *const mark);
+
+/**
+ * @brief Drops every allocation, keeping the blocks for reuse
+ *
+ * @param[in,out] object Pointer to the arena
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_arena_reset (sat_arena_t *const object);
+
+/**
+ * @brief Gets an allocator that carves memory from the arena
+ *
+ * Releasing through the allocator only reclaims the most recent allocation;
+ * other releases are no-ops. Reallocating the most recent allocation grows
+ * it in place when the block has room.
+ *
+ * @param[in] object Pointer to the arena
+ * @param[out] allocator Pointer to store the allocator
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @warning The allocator is only valid while the arena exists
+ */
+sat_status_t sat_arena_get_allocator (sat_arena_t *const object, sat_allocator_t *const allocator);
+
+/**
+ * @brief Retrieves the arena usage
+ *
+ * @param[in] object Pointer to the arena
+ * @param[out] used Bytes handed out since the last reset, including alignment padding
+ * @param[out] reserved Bytes held in blocks
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_arena_get_usage (const sat_arena_t *const object, size_t *const used, size_t *const reserved);
+
+/**
+ * @brief Destroys the arena and frees every block
+ *
+ * @param[in,out] object Pointer to the arena
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_arena_destroy (sat_arena_t *const object);
+
+#endif/* SAT_ARENA_H_ */
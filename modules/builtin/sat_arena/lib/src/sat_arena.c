@@ -0,0 +1,256 @@
+#include <sat_arena.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+typedef struct sat_arena_block_t sat_arena_block_t;
+
+struct sat_arena_block_t
+{
+    sat_arena_block_t *next;
+    size_t size;
+    size_t used;
+    uint8_t data [] __attribute__ ((aligned (SAT_ARENA_ALIGNMENT)));
+};
+
+struct sat_arena_t
+{
+    size_t block_size;
+    sat_arena_block_t *first;
+    sat_arena_block_t *current;
+    uint8_t *last;              // most recent allocation, grown or reclaimed in place
+};
+
+static sat_arena_block_t *sat_arena_block_create (const size_t size);
+static void *sat_arena_bump (sat_arena_t *const object, const size_t size);
+static void *sat_arena_allocator_allocate (void *const context, const size_t size);
+static void *sat_arena_allocator_reallocate (void *const context, void *const pointer, const size_t old_size, const size_t new_size);
+static void sat_arena_allocator_release (void *const context, void *const pointer, const size_t size);
+
+static inline size_t sat_arena_align (const size_t size)
+{
+    return (size + (SAT_ARENA_ALIGNMENT - 1)) & ~((size_t) SAT_ARENA_ALIGNMENT - 1);
+}
+
+sat_status_t sat_arena_create (sat_arena_t **const object, const sat_arena_args_t *const args)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (args, "null args");
+
+    size_t block_size = args->block_size > 0 ? sat_arena_align (args->block_size) : SAT_ARENA_BLOCK_SIZE_DEFAULT;
+
+    sat_arena_t *__object = (sat_arena_t *) calloc (1, sizeof (sat_arena_t));
+    sat_status_return_on_null (__object, "allocation failed");
+
+    __object->block_size = block_size;
+    __object->first = sat_arena_block_create (block_size);
+
+    if (__object->first == NULL)
+    {
+        free (__object);
+        sat_status_return_on_failure ("block allocation failed");
+    }
+
+    __object->current = __object->first;
+
+    *object = __object;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_arena_allocate (sat_arena_t *const object, const size_t size, void **const pointer)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (pointer, "null pointer");
+
+    void *__pointer = sat_arena_bump (object, size);
+    sat_status_return_on_null (__pointer, "block allocation failed");
+
+    *pointer = __pointer;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_arena_get_mark (const sat_arena_t *const object, sat_arena_mark_t *const mark)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (mark, "null mark");
+
+    mark->block = object->current;
+    mark->used = object->current->used;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_arena_rewind (sat_arena_t *const object, const sat_arena_mark_t *const mark)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (mark, "null mark");
+    sat_status_return_on_null (mark->block, "invalid mark");
+
+    object->current = (sat_arena_block_t *) mark->block;
+    object->current->used = mark->used;
+    object->last = NULL;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_arena_reset (sat_arena_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    object->current = object->first;
+    object->current->used = 0;
+    object->last = NULL;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_arena_get_allocator (sat_arena_t *const object, sat_allocator_t *const allocator)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (allocator, "null allocator");
+
+    allocator->context = object;
+    allocator->allocate = sat_arena_allocator_allocate;
+    allocator->reallocate = sat_arena_allocator_reallocate;
+    allocator->release = sat_arena_allocator_release;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_arena_get_usage (const sat_arena_t *const object, size_t *const used, size_t *const reserved)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (used, "null used");
+    sat_status_return_on_null (reserved, "null reserved");
+
+    bool active = true;
+
+    *used = 0;
+    *reserved = 0;
+
+    // Blocks after the current one are left over from before a reset.
+    for (sat_arena_block_t *block = object->first; block != NULL; block = block->next)
+    {
+        if (active == true)
+            *used += block->used;
+
+        *reserved += block->size;
+
+        if (block == object->current)
+            active = false;
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_arena_destroy (sat_arena_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    sat_arena_block_t *block = object->first;
+
+    while (block != NULL)
+    {
+        sat_arena_block_t *next = block->next;
+        free (block);
+
+        block = next;
+    }
+
+    free (object);
+
+    sat_status_return_on_success ();
+}
+
+static sat_arena_block_t *sat_arena_block_create (const size_t size)
+{
+    sat_arena_block_t *block = (sat_arena_block_t *) malloc (sizeof (sat_arena_block_t) + size);
+
+    if (block != NULL)
+    {
+        block->next = NULL;
+        block->size = size;
+        block->used = 0;
+    }
+
+    return block;
+}
+
+static void *sat_arena_bump (sat_arena_t *const object, const size_t size)
+{
+    size_t aligned = sat_arena_align (size > 0 ? size : 1);
+    sat_arena_block_t *block = object->current;
+
+    if (block->size - block->used < aligned)
+    {
+        sat_arena_block_t *next = block->next;
+
+        // Reuse the block kept from a previous round when it is big enough,
+        // otherwise splice a fresh one in after the current block.
+        if (next == NULL || next->size < aligned)
+        {
+            next = sat_arena_block_create (aligned > object->block_size ? aligned : object->block_size);
+            if (next == NULL)
+                return NULL;
+
+            next->next = block->next;
+            block->next = next;
+        }
+
+        next->used = 0;
+        object->current = next;
+        block = next;
+    }
+
+    object->last = block->data + block->used;
+    block->used += aligned;
+
+    return object->last;
+}
+
+static void *sat_arena_allocator_allocate (void *const context, const size_t size)
+{
+    return sat_arena_bump ((sat_arena_t *) context, size);
+}
+
+static void *sat_arena_allocator_reallocate (void *const context, void *const pointer, const size_t old_size, const size_t new_size)
+{
+    sat_arena_t *object = (sat_arena_t *) context;
+    sat_arena_block_t *block = object->current;
+
+    if (pointer == NULL)
+        return sat_arena_bump (object, new_size);
+
+    if (pointer == object->last)
+    {
+        size_t offset = (size_t) (object->last - block->data);
+        size_t aligned = sat_arena_align (new_size > 0 ? new_size : 1);
+
+        if (block->size - offset >= aligned)
+        {
+            block->used = offset + aligned;
+            return pointer;
+        }
+    }
+
+    void *__new = sat_arena_bump (object, new_size);
+
+    if (__new != NULL)
+        memcpy (__new, pointer, old_size < new_size ? old_size : new_size);
+
+    return __new;
+}
+
+static void sat_arena_allocator_release (void *const context, void *const pointer, const size_t size)
+{
+    sat_arena_t *object = (sat_arena_t *) context;
+    (void) size;
+
+    if (pointer == object->last)
+    {
+        object->current->used = (size_t) (object->last - object->current->data);
+        object->last = NULL;
+    }
+}
@@ -0,0 +1,54 @@
+#include <sat.h>
+#include <stdio.h>
+
+typedef struct
+{
+    uint32_t id;
+    char text [32];
+} request_t;
+
+int main (int argc, char *argv[])
+{
+    sat_arena_t *arena;
+
+    sat_status_t status = sat_arena_create (&arena, &(sat_arena_args_t) {.block_size = 0});
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    sat_allocator_t allocator;
+    sat_arena_get_allocator (arena, &allocator);
+
+    // Each round builds its temporary containers from the arena and drops
+    // them together with a single reset.
+    for (uint32_t round = 0; round < 3; round++)
+    {
+        sat_array_t *requests;
+        sat_array_create (&requests, &(sat_array_args_t)
+                                     {
+                                         .size = 16,
+                                         .object_size = sizeof (request_t),
+                                         .mode = sat_array_mode_dynamic,
+                                         .allocator = allocator,
+                                     });
+
+        for (uint32_t i = 0; i < 500; i++)
+        {
+            request_t request = {.id = i};
+            snprintf (request.text, sizeof (request.text), "round %u request %u", round, i);
+
+            sat_array_add (requests, &request);
+        }
+
+        size_t used = 0;
+        size_t reserved = 0;
+        sat_arena_get_usage (arena, &used, &reserved);
+
+        printf ("Round %u: used %zu bytes, reserved %zu bytes\n", round, used, reserved);
+
+        sat_arena_reset (arena);
+    }
+
+    sat_arena_destroy (arena);
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+
+typedef struct
+{
+    uint64_t id;
+    char name [24];
+} arena_item_t;
+
+static bool compare_id (const void *const element, const void *const data)
+{
+    return ((const arena_item_t *) element)->id == *(const uint64_t *) data;
+}
+
+static bool is_equal_id (const void *const element, const void *const new_element)
+{
+    return ((const arena_item_t *) element)->id == ((const arena_item_t *) new_element)->id;
+}
+
+static void test_allocate (void)
+{
+    sat_arena_t *arena;
+    sat_status_t status = sat_arena_create (&arena, &(sat_arena_args_t) {.block_size = 1024});
+    assert (sat_status_get_result (&status) == true);
+
+    void *first = NULL;
+    void *second = NULL;
+
+    status = sat_arena_allocate (arena, 3, &first);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_arena_allocate (arena, 5, &second);
+    assert (sat_status_get_result (&status) == true);
+
+    assert (((uintptr_t) first % SAT_ARENA_ALIGNMENT) == 0);
+    assert (((uintptr_t) second % SAT_ARENA_ALIGNMENT) == 0);
+    assert ((uint8_t *) second - (uint8_t *) first == SAT_ARENA_ALIGNMENT);
+
+    // Larger than a block: served from a dedicated one.
+    void *big = NULL;
+    status = sat_arena_allocate (arena, 8192, &big);
+    assert (sat_status_get_result (&status) == true);
+    memset (big, 0xAB, 8192);
+
+    size_t used = 0;
+    size_t reserved = 0;
+
+    status = sat_arena_get_usage (arena, &used, &reserved);
+    assert (sat_status_get_result (&status) == true);
+    assert (used == 2 * SAT_ARENA_ALIGNMENT + 8192);
+    assert (reserved == 1024 + 8192);
+
+    status = sat_arena_allocate (NULL, 8, &first);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_arena_destroy (arena);
+}
+
+static void test_mark_rewind (void)
+{
+    sat_arena_t *arena;
+    sat_status_t status = sat_arena_create (&arena, &(sat_arena_args_t) {.block_size = 256});
+    assert (sat_status_get_result (&status) == true);
+
+    void *pointer = NULL;
+    sat_arena_allocate (arena, 64, &pointer);
+
+    sat_arena_mark_t mark;
+    status = sat_arena_get_mark (arena, &mark);
+    assert (sat_status_get_result (&status) == true);
+
+    void *scratch = NULL;
+    for (int i = 0; i < 20; i++)
+        sat_arena_allocate (arena, 100, &scratch);
+
+    size_t used = 0;
+    size_t reserved = 0;
+
+    status = sat_arena_rewind (arena, &mark);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_arena_get_usage (arena, &used, &reserved);
+    assert (used == 64);
+
+    // The next allocation lands right after the marked one.
+    void *next = NULL;
+    sat_arena_allocate (arena, 8, &next);
+    assert ((uint8_t *) next == (uint8_t *) pointer + 64);
+
+    sat_arena_destroy (arena);
+}
+
+static void test_reset_reuses_blocks (void)
+{
+    sat_arena_t *arena;
+    sat_status_t status = sat_arena_create (&arena, &(sat_arena_args_t) {.block_size = 4096});
+    assert (sat_status_get_result (&status) == true);
+
+    size_t used = 0;
+    size_t reserved = 0;
+    size_t reserved_first = 0;
+
+    for (int round = 0; round < 10; round++)
+    {
+        void *pointer = NULL;
+
+        for (int i = 0; i < 100; i++)
+        {
+            status = sat_arena_allocate (arena, 200, &pointer);
+            assert (sat_status_get_result (&status) == true);
+            memset (pointer, round, 200);
+        }
+
+        sat_arena_get_usage (arena, &used, &reserved);
+        assert (used == 100 * 208);
+
+        if (round == 0)
+            reserved_first = reserved;
+
+        assert (reserved == reserved_first);
+
+        status = sat_arena_reset (arena);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    sat_arena_get_usage (arena, &used, &reserved);
+    assert (used == 0);
+
+    sat_arena_destroy (arena);
+}
+
+static void test_containers (void)
+{
+    sat_arena_t *arena;
+    sat_status_t status = sat_arena_create (&arena, &(sat_arena_args_t) {.block_size = 16 * 1024});
+    assert (sat_status_get_result (&status) == true);
+
+    sat_allocator_t allocator;
+    status = sat_arena_get_allocator (arena, &allocator);
+    assert (sat_status_get_result (&status) == true);
+
+    size_t used = 0;
+    size_t reserved = 0;
+    size_t reserved_first = 0;
+
+    for (int round = 0; round < 5; round++)
+    {
+        sat_array_t *array;
+        status = sat_array_create (&array, &(sat_array_args_t)
+                                           {
+                                               .size = 4,
+                                               .object_size = sizeof (arena_item_t),
+                                               .mode = sat_array_mode_dynamic,
+                                               .allocator = allocator,
+                                           });
+        assert (sat_status_get_result (&status) == true);
+
+        sat_set_t *set;
+        status = sat_set_create (&set, &(sat_set_args_t)
+                                       {
+                                           .size = 4,
+                                           .object_size = sizeof (arena_item_t),
+                                           .is_equal = is_equal_id,
+                                           .mode = sat_set_mode_dynamic,
+                                           .allocator = allocator,
+                                       });
+        assert (sat_status_get_result (&status) == true);
+
+        sat_linked_list_t *list;
+        status = sat_linked_list_create_with_args (&list, &(sat_linked_list_args_t)
+                                                          {
+                                                              .object_size = sizeof (arena_item_t),
+                                                              .allocator = allocator,
+                                                          });
+        assert (sat_status_get_result (&status) == true);
+
+        sat_queue_t *queue;
+        status = sat_queue_create_with_args (&queue, &(sat_queue_args_t)
+                                                     {
+                                                         .object_size = sizeof (arena_item_t),
+                                                         .mode = sat_queue_mode_ring,
+                                                         .capacity = 4,
+                                                         .allocator = allocator,
+                                                     });
+        assert (sat_status_get_result (&status) == true);
+
+        for (uint64_t i = 0; i < 200; i++)
+        {
+            arena_item_t item = {.id = i};
+            snprintf (item.name, sizeof (item.name), "item-%lu", (unsigned long) i);
+
+            status = sat_array_add (array, &item);
+            assert (sat_status_get_result (&status) == true);
+
+            status = sat_set_add (set, &item);
+            assert (sat_status_get_result (&status) == true);
+
+            status = sat_linked_list_insert (list, &item);
+            assert (sat_status_get_result (&status) == true);
+
+            status = sat_queue_enqueue (queue, &item);
+            assert (sat_status_get_result (&status) == true);
+        }
+
+        uint32_t size = 0;
+        sat_array_get_size (array, &size);
+        assert (size == 200);
+
+        arena_item_t item;
+        status = sat_array_get_object_by (array, 150, &item);
+        assert (sat_status_get_result (&status) == true);
+        assert (item.id == 150 && strcmp (item.name, "item-150") == 0);
+
+        uint64_t id = 99;
+        status = sat_linked_list_get (list, compare_id, &id, &item);
+        assert (sat_status_get_result (&status) == true);
+        assert (strcmp (item.name, "item-99") == 0);
+
+        status = sat_queue_dequeue (queue, &item);
+        assert (sat_status_get_result (&status) == true);
+        assert (item.id == 0);
+
+        // No destroy calls: the whole round is dropped at once.
+        sat_arena_get_usage (arena, &used, &reserved);
+        assert (used > 0);
+
+        if (round == 0)
+            reserved_first = reserved;
+
+        assert (reserved == reserved_first);
+
+        sat_arena_reset (arena);
+    }
+
+    sat_arena_destroy (arena);
+}
+
+int main (int argc, char *argv[])
+{
+    test_allocate ();
+    test_mark_rewind ();
+    test_reset_reuses_blocks ();
+    test_containers ();
+
+    return 0;
+}
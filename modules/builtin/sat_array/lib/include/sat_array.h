@@ -14,8 +14,14 @@
 #define SAT_ARRAY_H_
 
 #include <sat_status.h>
+#include <sat_allocator.h>
 #include <stdint.h>
 
+/**
+ * @brief Capacity multiplier used when sat_array_args_t.growth_factor is 0
+ */
+#define SAT_ARRAY_GROWTH_FACTOR_DEFAULT     2.0f
+
 /**
  * @brief Opaque structure representing a dynamic array
  * 
@@ -33,6 +39,17 @@ typedef struct sat_array_t sat_array_t;
  */
 typedef bool (*sat_array_compare_t) (const void *const element, const void *const param);
 
+/**
+ * @brief Ordering function type for sorting and binary search
+ * 
+ * @param element Pointer to an array element
+ * @param other Pointer to another element, or to the search key in the
+ *              bound and find operations
+ * @return Negative if @p element orders before @p other, zero if they are
+ *         equivalent, positive otherwise
+ */
+typedef int (*sat_array_order_t) (const void *const element, const void *const other);
+
 /**
  * @brief Callback function type for memory allocation notifications
  * 
@@ -64,6 +81,9 @@ typedef struct
     uint32_t size;              /**< Initial capacity of the array */
     uint32_t object_size;       /**< Size in bytes of each array element */
     sat_array_mode_t mode;      /**< Growth mode (static or dynamic) */
+    float growth_factor;        /**< Capacity multiplier on growth (> 1.0), 0 selects SAT_ARRAY_GROWTH_FACTOR_DEFAULT */
+    sat_array_order_t order;    /**< Optional ordering, enables the sorted-insert mode */
+    sat_allocator_t allocator;  /**< Optional allocator for the object and its buffer, zero selects the C library */
     
     /**
      * @brief Memory growth notification configuration
@@ -79,9 +99,12 @@ typedef struct
 /**
  * @brief Buffer descriptor for direct access to the array's internal storage
  *
- * Holds a raw pointer to the contiguous memory block used by the array and
- * the number of elements currently stored. The buffer becomes invalid if the
- * array is resized or destroyed.
+ * Holds a raw pointer to the contiguous memory block used by the array, the
+ * number of elements currently stored and the size of each. The buffer
+ * becomes invalid if the array is resized or destroyed.
+ *
+ * A plain C array can be described the same way, for functions that take a
+ * buffer such as the sat_parallel algorithms.
  *
  * @warning Do not use this structure after calling sat_array_destroy().
  * @warning Do not use this structure after adding elements to a dynamic array,
@@ -89,8 +112,9 @@ typedef struct
  */
 typedef struct
 {
-    void *data;      /**< Pointer to the first element in the internal storage */
-    uint32_t size;   /**< Number of elements currently stored in the array */
+    void *data;             /**< Pointer to the first element in the internal storage */
+    uint32_t size;          /**< Number of elements currently stored in the array */
+    uint32_t object_size;   /**< Size in bytes of each element */
 
 } sat_array_buffer_t;
 
@@ -120,6 +144,8 @@ sat_status_t sat_array_create (sat_array_t **const object, const sat_array_args_
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @note The data is copied into the array using memcpy
+ * @note In sorted-insert mode the element is inserted after its equivalents
+ *       so the array stays ordered (O(log n) search plus one memmove)
  */
 sat_status_t sat_array_add (sat_array_t *const object, const void *const data);
 
@@ -134,6 +160,8 @@ sat_status_t sat_array_add (sat_array_t *const object, const void *const data);
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @warning Index must be less than the current array size
+ * @note In sorted-insert mode the updated element is moved to keep the order,
+ *       so it may end up at a different index
  */
 sat_status_t sat_array_update_by (sat_array_t *const object, const void *const data, const uint32_t index);
 
@@ -148,10 +176,71 @@ sat_status_t sat_array_update_by (sat_array_t *const object, const void *const d
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @warning Index must be less than the current array size
- * @note This operation has O(n) complexity due to element shifting
+ * @note This operation has O(n) complexity, the tail is moved with a single memmove
+ * @see sat_array_swap_remove()
  */
 sat_status_t sat_array_remove_by (sat_array_t *const object, const uint32_t index);
 
+/**
+ * @brief Removes an object from the array without preserving order
+ * 
+ * Moves the last element into the position being removed, so no shifting
+ * takes place.
+ * 
+ * @param[in,out] object Pointer to the sat_array_t object
+ * @param[in] index Index of the object to remove (0-based)
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @warning Index must be less than the current array size
+ * @note This operation has O(1) complexity
+ * @note In sorted-insert mode this falls back to sat_array_remove_by() to keep the order
+ */
+sat_status_t sat_array_swap_remove (sat_array_t *const object, const uint32_t index);
+
+/**
+ * @brief Appends several contiguous objects to the array
+ * 
+ * Copies @p amount elements of object_size bytes from @p data in a single
+ * operation, growing the array at most once in dynamic mode.
+ * 
+ * @param[in,out] object Pointer to the sat_array_t object
+ * @param[in] data Pointer to the first of the elements to be added
+ * @param[in] amount Number of elements to add
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note In static mode nothing is added if all elements do not fit
+ * @note In sorted-insert mode the array is sorted again after the batch is appended
+ */
+sat_status_t sat_array_add_many (sat_array_t *const object, const void *const data, const uint32_t amount);
+
+/**
+ * @brief Ensures the array can hold at least @p capacity elements
+ * 
+ * Grows the internal buffer once so subsequent additions up to @p capacity
+ * do not reallocate. Does nothing if the capacity is already large enough.
+ * 
+ * @param[in,out] object Pointer to the sat_array_t object
+ * @param[in] capacity Minimum number of elements the array must be able to hold
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note Only available in dynamic mode
+ */
+sat_status_t sat_array_reserve (sat_array_t *const object, const uint32_t capacity);
+
+/**
+ * @brief Reduces the capacity of the array to its current size
+ * 
+ * Releases unused memory at the end of the internal buffer. An empty array
+ * keeps room for one element.
+ * 
+ * @param[in,out] object Pointer to the sat_array_t object
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note Only available in dynamic mode
+ * @warning References obtained before this call become invalid
+ */
+sat_status_t sat_array_shrink_to_fit (sat_array_t *const object);
+
 /**
  * @brief Removes an object from the array by matching a parameter using a comparison function
  * 
@@ -315,10 +404,10 @@ void *sat_array_get_reference_by (const sat_array_t *const object, const uint32_
 /**
  * @brief Retrieves a descriptor for the array's internal contiguous buffer
  *
- * Fills @p buffer with a pointer to the array's internal memory block and the
- * current element count. This gives direct access to all stored elements without
- * copying and is useful for bulk operations or passing data to C APIs that expect
- * a plain array.
+ * Fills @p buffer with a pointer to the array's internal memory block, the
+ * current element count and the element size. This gives direct access to all
+ * stored elements without copying and is useful for bulk operations or passing
+ * data to C APIs that expect a plain array.
  *
  * @param[in]  object  Pointer to the sat_array_t object
  * @param[out] buffer  Pointer to a @ref sat_array_buffer_t to be filled
@@ -332,4 +421,57 @@ void *sat_array_get_reference_by (const sat_array_t *const object, const uint32_
  */
 sat_status_t sat_array_get_buffer (const sat_array_t *const object, sat_array_buffer_t *const buffer);
 
+/**
+ * @brief Sorts the array in place
+ * 
+ * Uses an introsort (quicksort with median-of-three pivots, falling back to
+ * heapsort on degenerate inputs and to insertion sort on small ranges), so
+ * the worst case is O(n log n). The sort is not stable.
+ * 
+ * @param[in,out] object Pointer to the sat_array_t object
+ * @param[in] order Ordering function, or NULL to use the one given on creation
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_array_sort (sat_array_t *const object, sat_array_order_t order);
+
+/**
+ * @brief Finds the first position whose element does not order before @p key
+ * 
+ * @param[in] object Pointer to a sat_array_t object sorted by @p order
+ * @param[in] key Pointer to the search key, passed as second argument to @p order
+ * @param[in] order Ordering function, or NULL to use the one given on creation
+ * @param[out] index Position found, equal to the size if every element orders before @p key
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note O(log n) complexity
+ */
+sat_status_t sat_array_lower_bound (const sat_array_t *const object, const void *const key, sat_array_order_t order, uint32_t *const index);
+
+/**
+ * @brief Finds the first position whose element orders after @p key
+ * 
+ * @param[in] object Pointer to a sat_array_t object sorted by @p order
+ * @param[in] key Pointer to the search key, passed as second argument to @p order
+ * @param[in] order Ordering function, or NULL to use the one given on creation
+ * @param[out] index Position found, equal to the size if no element orders after @p key
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note O(log n) complexity
+ */
+sat_status_t sat_array_upper_bound (const sat_array_t *const object, const void *const key, sat_array_order_t order, uint32_t *const index);
+
+/**
+ * @brief Finds an element equivalent to @p key with a binary search
+ * 
+ * @param[in] object Pointer to a sat_array_t object sorted by @p order
+ * @param[in] key Pointer to the search key, passed as second argument to @p order
+ * @param[in] order Ordering function, or NULL to use the one given on creation
+ * @param[out] index Position of the first equivalent element
+ * @return sat_status_t indicating success, or failure if no element matches
+ * 
+ * @note O(log n) complexity
+ * @see sat_array_get_reference_by()
+ */
+sat_status_t sat_array_binary_find (const sat_array_t *const object, const void *const key, sat_array_order_t order, uint32_t *const index);
+
 #endif/* SAT_ARRAY_H_ */
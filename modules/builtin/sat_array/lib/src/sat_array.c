@@ -12,6 +12,9 @@ struct sat_array_t
     uint8_t *buffer;
     bool initialized;
     sat_array_mode_t mode;
+    float growth_factor;
+    sat_array_order_t order;
+    sat_allocator_t allocator;
 
     struct
     {
@@ -27,24 +30,28 @@ static sat_status_t sat_array_is_initialized (const sat_array_t *const object);
 static sat_status_t sat_array_is_args_valid (const sat_array_args_t *const args);
 
 static void sat_array_set_context (sat_array_t *const object, const sat_array_args_t *const args);
-static sat_status_t sat_array_realloc (sat_array_t *const object);
+static sat_status_t sat_array_realloc (sat_array_t *const object, const uint32_t capacity);
+static sat_status_t sat_array_grow (sat_array_t *const object, const uint32_t required);
 
 static void sat_array_configure_iterator (sat_array_t *const object);
 
+static uint32_t sat_array_bound (const sat_array_t *const object, const void *const key, sat_array_order_t order, bool upper);
+static sat_status_t sat_array_insert_at (sat_array_t *const object, const void *const data, const uint32_t index);
+
 sat_status_t sat_array_create (sat_array_t **const object, const sat_array_args_t *const args)
 {
     sat_status_return_on_null (object, "object pointer is NULL");
     sat_status_return_on_error (sat_array_is_args_valid (args));
 
-    sat_array_t *__object = calloc (1, sizeof (struct sat_array_t));
+    sat_array_t *__object = sat_allocator_allocate_zeroed (&args->allocator, sizeof (struct sat_array_t));
     sat_status_return_on_null (__object, "object allocation failed");
 
     sat_array_set_context (__object, args);
 
-    __object->buffer = (uint8_t *) calloc (1, __object->size * __object->object_size);
+    __object->buffer = (uint8_t *) sat_allocator_allocate_zeroed (&args->allocator, (size_t) __object->size * __object->object_size);
     if (__object->buffer == NULL)
     {
-        free (__object);
+        sat_allocator_release (&args->allocator, __object, sizeof (struct sat_array_t));
         sat_status_return_on_failure ("buffer allocation failed");
     }
 
@@ -63,17 +70,16 @@ sat_status_t sat_array_add (sat_array_t *const object, const void *const data)
 
     if (object->mode == sat_array_mode_dynamic && object->amount == object->size)
     {
-        sat_status_return_on_error (sat_array_realloc (object));
-        // in future register a callback to handle situations where
-        // there is no more memory to allocate.
-        if (object->notification.on_increase != NULL)
-        {
-            object->notification.on_increase (object->notification.user, object->size);
-        }
+        sat_status_return_on_error (sat_array_grow (object, object->amount + 1));
     }
 
     sat_status_return_on_greater_than_or_equal (object->amount, object->size, "array is full");
 
+    if (object->order != NULL)
+    {
+        return sat_array_insert_at (object, data, sat_array_bound (object, data, object->order, true));
+    }
+
     memcpy (&object->buffer [object->amount * object->object_size],
             data,
             object->object_size);
@@ -89,6 +95,13 @@ sat_status_t sat_array_update_by (sat_array_t *const object, const void *const d
     sat_status_return_on_null (data, "data pointer is NULL");
     sat_status_return_on_greater_than_or_equal (index, object->amount, "index out of bounds");
 
+    if (object->order != NULL)
+    {
+        // take the element out and insert it again where it belongs
+        sat_status_return_on_error (sat_array_remove_by (object, index));
+        return sat_array_insert_at (object, data, sat_array_bound (object, data, object->order, true));
+    }
+
     memcpy (&object->buffer [index * object->object_size], data, object->object_size);
 
     sat_status_return_on_success ();
@@ -101,17 +114,100 @@ sat_status_t sat_array_remove_by (sat_array_t *const object, uint32_t const inde
 
     sat_status_return_on_equals (object->amount, 0, "no elements to remove");
 
-    memset (&object->buffer [index * object->object_size], 0, object->object_size);
+    memmove (&object->buffer [index * object->object_size],
+             &object->buffer [(index + 1) * object->object_size],
+             (size_t) (object->amount - index - 1) * object->object_size);
+
+    object->amount --;
+
+    memset (&object->buffer [object->amount * object->object_size], 0, object->object_size);
 
-    for (uint32_t i = index; i < object->amount - 1; i++)
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_array_swap_remove (sat_array_t *const object, const uint32_t index)
+{
+    sat_status_return_on_error (sat_array_is_initialized (object));
+    sat_status_return_on_greater_than_or_equal (index, object->amount, "index out of bounds");
+
+    if (object->order != NULL)
     {
-        memcpy (&object->buffer [i * object->object_size], 
-                &object->buffer [(i + 1) * object->object_size],
-                object->object_size);
+        return sat_array_remove_by (object, index);
     }
 
     object->amount --;
 
+    if (index != object->amount)
+    {
+        memcpy (&object->buffer [index * object->object_size],
+                &object->buffer [object->amount * object->object_size],
+                object->object_size);
+    }
+
+    memset (&object->buffer [object->amount * object->object_size], 0, object->object_size);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_array_add_many (sat_array_t *const object, const void *const data, const uint32_t amount)
+{
+    sat_status_return_on_error (sat_array_is_initialized (object));
+    sat_status_return_on_null (data, "data pointer is NULL");
+    sat_status_return_on_greater_than (amount, UINT32_MAX - object->amount, "too many elements");
+
+    uint32_t required = object->amount + amount;
+
+    if (object->mode == sat_array_mode_dynamic && required > object->size)
+    {
+        sat_status_return_on_error (sat_array_grow (object, required));
+    }
+
+    sat_status_return_on_greater_than (required, object->size, "array is full");
+
+    memcpy (&object->buffer [(size_t) object->amount * object->object_size],
+            data,
+            (size_t) amount * object->object_size);
+
+    object->amount = required;
+
+    if (object->order != NULL)
+    {
+        return sat_array_sort (object, NULL);
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_array_reserve (sat_array_t *const object, const uint32_t capacity)
+{
+    sat_status_return_on_error (sat_array_is_initialized (object));
+    sat_status_return_on_not_equals (object->mode, sat_array_mode_dynamic, "static array cannot be resized");
+
+    if (capacity > object->size)
+    {
+        sat_status_return_on_error (sat_array_realloc (object, capacity));
+
+        if (object->notification.on_increase != NULL)
+        {
+            object->notification.on_increase (object->notification.user, object->size);
+        }
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_array_shrink_to_fit (sat_array_t *const object)
+{
+    sat_status_return_on_error (sat_array_is_initialized (object));
+    sat_status_return_on_not_equals (object->mode, sat_array_mode_dynamic, "static array cannot be resized");
+
+    uint32_t capacity = object->amount > 0 ? object->amount : 1;
+
+    if (capacity < object->size)
+    {
+        sat_status_return_on_error (sat_array_realloc (object, capacity));
+    }
+
     sat_status_return_on_success ();
 }
 
@@ -224,6 +320,9 @@ sat_status_t sat_array_clone (const sat_array_t *const object, sat_array_t **con
         .size = object->size,
         .object_size = object->object_size,
         .mode = object->mode,
+        .growth_factor = object->growth_factor,
+        .order = object->order,
+        .allocator = object->allocator,
         .notification =
         {
             .on_increase = NULL,
@@ -253,13 +352,15 @@ sat_status_t sat_array_destroy (sat_array_t *const object)
 {
     sat_status_return_on_error (sat_array_is_initialized (object));
 
-    free (object->buffer);
+    sat_allocator_t allocator = object->allocator;
+
+    sat_allocator_release (&allocator, object->buffer, (size_t) object->size * object->object_size);
     object->buffer = NULL;
 
     object->initialized = false;
 
     // Free the object itself
-    free (object);
+    sat_allocator_release (&allocator, object, sizeof (struct sat_array_t));
     
     sat_status_return_on_success ();
 }
@@ -282,6 +383,11 @@ static sat_status_t sat_array_is_args_valid (const sat_array_args_t *const args)
         sat_status_return_on_failure ("invalid mode");
     }
 
+    if (args->growth_factor != 0.0f && args->growth_factor <= 1.0f)
+    {
+        sat_status_return_on_failure ("growth factor must be greater than 1.0");
+    }
+
     sat_status_return_on_success ();
 }
 
@@ -290,6 +396,9 @@ static void sat_array_set_context (sat_array_t *const object, const sat_array_ar
     object->object_size = args->object_size;
     object->size = args->size;
     object->mode = args->mode;
+    object->growth_factor = args->growth_factor != 0.0f ? args->growth_factor : SAT_ARRAY_GROWTH_FACTOR_DEFAULT;
+    object->order = args->order;
+    object->allocator = args->allocator;
 
     if (args->notification.on_increase != NULL)
     {
@@ -298,13 +407,15 @@ static void sat_array_set_context (sat_array_t *const object, const sat_array_ar
     }
 }
 
-static sat_status_t sat_array_realloc (sat_array_t *const object)
+static sat_status_t sat_array_realloc (sat_array_t *const object, const uint32_t capacity)
 {
-    uint8_t *__new = (uint8_t *) realloc (object->buffer,
-                                          object->size * 2 * object->object_size);
+    uint8_t *__new = (uint8_t *) sat_allocator_reallocate (&object->allocator,
+                                                           object->buffer,
+                                                           (size_t) object->size * object->object_size,
+                                                           (size_t) capacity * object->object_size);
     sat_status_return_on_null (__new, "memory reallocation failed");
 
-    object->size *= 2;
+    object->size = capacity;
 
     // Update the buffer pointer to the new memory location
     object->buffer = __new;
@@ -312,6 +423,30 @@ static sat_status_t sat_array_realloc (sat_array_t *const object)
     sat_status_return_on_success ();
 }
 
+static sat_status_t sat_array_grow (sat_array_t *const object, const uint32_t required)
+{
+    double grown = (double) object->size * object->growth_factor;
+    uint32_t capacity = grown >= (double) UINT32_MAX ? UINT32_MAX : (uint32_t) grown;
+
+    // small arrays with a small factor must still make progress
+    if (capacity <= object->size)
+        capacity = object->size + 1;
+
+    if (capacity < required)
+        capacity = required;
+
+    sat_status_return_on_error (sat_array_realloc (object, capacity));
+
+    // in future register a callback to handle situations where
+    // there is no more memory to allocate.
+    if (object->notification.on_increase != NULL)
+    {
+        object->notification.on_increase (object->notification.user, object->size);
+    }
+
+    sat_status_return_on_success ();
+}
+
 static void *sat_array_next (const void *const object, const uint32_t index)
 {
     sat_array_t *array = (sat_array_t *) object;
@@ -356,6 +491,7 @@ sat_status_t sat_array_get_buffer (const sat_array_t *const object, sat_array_bu
 
     buffer->size = object->amount;
     buffer->data = object->buffer;
+    buffer->object_size = object->object_size;
 
     sat_status_return_on_success ();
 }
@@ -365,4 +501,274 @@ static void sat_array_configure_iterator (sat_array_t *const object)
     object->base.object = object;
     object->base.get_amount = sat_array_get_amount;
     object->base.next = sat_array_next;
-}
\ No newline at end of file
+}
+
+#define SAT_ARRAY_SORT_INSERTION_THRESHOLD    16
+
+typedef struct
+{
+    uint8_t *buffer;
+    uint32_t object_size;
+    sat_array_order_t order;
+    uint8_t *temporary;
+} sat_array_sort_context_t;
+
+static inline uint8_t *sat_array_sort_at (const sat_array_sort_context_t *const context, uint32_t index)
+{
+    return &context->buffer [(size_t) index * context->object_size];
+}
+
+static inline void sat_array_sort_swap (const sat_array_sort_context_t *const context, uint32_t a, uint32_t b)
+{
+    memcpy (context->temporary, sat_array_sort_at (context, a), context->object_size);
+    memcpy (sat_array_sort_at (context, a), sat_array_sort_at (context, b), context->object_size);
+    memcpy (sat_array_sort_at (context, b), context->temporary, context->object_size);
+}
+
+static void sat_array_insertion_sort (const sat_array_sort_context_t *const context, uint32_t low, uint32_t high)
+{
+    for (uint32_t i = low + 1; i < high; i++)
+    {
+        uint32_t j = i;
+
+        // find the insertion point first, then move the block with one memmove
+        while (j > low && context->order (sat_array_sort_at (context, j - 1), sat_array_sort_at (context, i)) > 0)
+        {
+            j--;
+        }
+
+        if (j == i)
+            continue;
+
+        memcpy (context->temporary, sat_array_sort_at (context, i), context->object_size);
+        memmove (sat_array_sort_at (context, j + 1), sat_array_sort_at (context, j), (size_t) (i - j) * context->object_size);
+        memcpy (sat_array_sort_at (context, j), context->temporary, context->object_size);
+    }
+}
+
+static void sat_array_sift_down (const sat_array_sort_context_t *const context, uint32_t low, uint32_t root, uint32_t count)
+{
+    while (true)
+    {
+        uint32_t child = 2 * root + 1;
+
+        if (child >= count)
+            break;
+
+        if (child + 1 < count && context->order (sat_array_sort_at (context, low + child), sat_array_sort_at (context, low + child + 1)) < 0)
+            child++;
+
+        if (context->order (sat_array_sort_at (context, low + root), sat_array_sort_at (context, low + child)) >= 0)
+            break;
+
+        sat_array_sort_swap (context, low + root, low + child);
+        root = child;
+    }
+}
+
+static void sat_array_heap_sort (const sat_array_sort_context_t *const context, uint32_t low, uint32_t high)
+{
+    uint32_t count = high - low;
+
+    for (uint32_t i = count / 2; i > 0; i--)
+    {
+        sat_array_sift_down (context, low, i - 1, count);
+    }
+
+    for (uint32_t end = count - 1; end > 0; end--)
+    {
+        sat_array_sort_swap (context, low, low + end);
+        sat_array_sift_down (context, low, 0, end);
+    }
+}
+
+static uint32_t sat_array_partition (const sat_array_sort_context_t *const context, uint32_t low, uint32_t high)
+{
+    uint32_t middle = low + (high - low) / 2;
+    uint32_t last = high - 1;
+
+    // median of three ends up at low, acting as the pivot
+    if (context->order (sat_array_sort_at (context, middle), sat_array_sort_at (context, low)) < 0)
+        sat_array_sort_swap (context, middle, low);
+
+    if (context->order (sat_array_sort_at (context, last), sat_array_sort_at (context, low)) < 0)
+        sat_array_sort_swap (context, last, low);
+
+    if (context->order (sat_array_sort_at (context, middle), sat_array_sort_at (context, last)) < 0)
+        sat_array_sort_swap (context, middle, last);
+
+    sat_array_sort_swap (context, low, last);
+
+    // Hoare partition around the pivot stored at low
+    uint32_t i = low;
+    uint32_t j = high;
+
+    while (true)
+    {
+        do
+        {
+            i++;
+        } while (i < high && context->order (sat_array_sort_at (context, i), sat_array_sort_at (context, low)) < 0);
+
+        do
+        {
+            j--;
+        } while (context->order (sat_array_sort_at (context, j), sat_array_sort_at (context, low)) > 0);
+
+        if (i >= j)
+            break;
+
+        sat_array_sort_swap (context, i, j);
+    }
+
+    sat_array_sort_swap (context, low, j);
+
+    return j;
+}
+
+static void sat_array_introsort (const sat_array_sort_context_t *const context, uint32_t low, uint32_t high, uint32_t depth)
+{
+    while (high - low > SAT_ARRAY_SORT_INSERTION_THRESHOLD)
+    {
+        if (depth == 0)
+        {
+            sat_array_heap_sort (context, low, high);
+            return;
+        }
+
+        depth--;
+
+        uint32_t pivot = sat_array_partition (context, low, high);
+
+        // recurse into the smaller side to bound the stack depth
+        if (pivot - low < high - pivot - 1)
+        {
+            sat_array_introsort (context, low, pivot, depth);
+            low = pivot + 1;
+        }
+        else
+        {
+            sat_array_introsort (context, pivot + 1, high, depth);
+            high = pivot;
+        }
+    }
+
+    sat_array_insertion_sort (context, low, high);
+}
+
+sat_status_t sat_array_sort (sat_array_t *const object, sat_array_order_t order)
+{
+    sat_status_return_on_error (sat_array_is_initialized (object));
+
+    if (order == NULL)
+        order = object->order;
+
+    sat_status_return_on_null (order, "order function pointer is NULL");
+
+    if (object->amount < 2)
+        sat_status_return_on_success ();
+
+    sat_array_sort_context_t context =
+    {
+        .buffer = object->buffer,
+        .object_size = object->object_size,
+        .order = order,
+        .temporary = malloc (object->object_size),
+    };
+
+    sat_status_return_on_null (context.temporary, "temporary allocation failed");
+
+    uint32_t depth = 0;
+
+    for (uint32_t n = object->amount; n > 0; n >>= 1)
+    {
+        depth += 2;
+    }
+
+    sat_array_introsort (&context, 0, object->amount, depth);
+
+    free (context.temporary);
+
+    sat_status_return_on_success ();
+}
+
+static uint32_t sat_array_bound (const sat_array_t *const object, const void *const key, sat_array_order_t order, bool upper)
+{
+    uint32_t low = 0;
+    uint32_t high = object->amount;
+
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+        int result = order (&object->buffer [(size_t) middle * object->object_size], key);
+
+        if (result < 0 || (upper == true && result == 0))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+static sat_status_t sat_array_insert_at (sat_array_t *const object, const void *const data, const uint32_t index)
+{
+    memmove (&object->buffer [(size_t) (index + 1) * object->object_size],
+             &object->buffer [(size_t) index * object->object_size],
+             (size_t) (object->amount - index) * object->object_size);
+
+    memcpy (&object->buffer [(size_t) index * object->object_size], data, object->object_size);
+
+    object->amount ++;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_array_lower_bound (const sat_array_t *const object, const void *const key, sat_array_order_t order, uint32_t *const index)
+{
+    sat_status_return_on_error (sat_array_is_initialized (object));
+    sat_status_return_on_null (key, "key pointer is NULL");
+    sat_status_return_on_null (index, "index pointer is NULL");
+
+    if (order == NULL)
+        order = object->order;
+
+    sat_status_return_on_null (order, "order function pointer is NULL");
+
+    *index = sat_array_bound (object, key, order, false);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_array_upper_bound (const sat_array_t *const object, const void *const key, sat_array_order_t order, uint32_t *const index)
+{
+    sat_status_return_on_error (sat_array_is_initialized (object));
+    sat_status_return_on_null (key, "key pointer is NULL");
+    sat_status_return_on_null (index, "index pointer is NULL");
+
+    if (order == NULL)
+        order = object->order;
+
+    sat_status_return_on_null (order, "order function pointer is NULL");
+
+    *index = sat_array_bound (object, key, order, true);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_array_binary_find (const sat_array_t *const object, const void *const key, sat_array_order_t order, uint32_t *const index)
+{
+    uint32_t position = 0;
+
+    sat_status_return_on_error (sat_array_lower_bound (object, key, order, &position));
+
+    if (order == NULL)
+        order = object->order;
+
+    sat_status_return_on_greater_than_or_equal (position, object->amount, "object not found");
+    sat_status_return_on_not_equals (order (&object->buffer [(size_t) position * object->object_size], key), 0, "object not found");
+
+    *index = position;
+
+    sat_status_return_on_success ();
+}
@@ -0,0 +1,247 @@
+#include <sat.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+/**
+ * @brief Tests for bulk, reserve and swap-remove operations
+ */
+
+typedef struct
+{
+    uint32_t id;
+    double value;
+
+} record_t;
+
+static uint32_t notified_size = 0;
+
+static void on_increase (void *const user, uint32_t new_size)
+{
+    (void) user;
+    notified_size = new_size;
+}
+
+void test_array_add_many (void)
+{
+    sat_array_t *array = NULL;
+    record_t records [100];
+
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        records [i].id = i;
+        records [i].value = i * 0.5;
+    }
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 4,
+                                                        .object_size = sizeof (record_t),
+                                                        .mode = sat_array_mode_dynamic,
+                                                        .notification =
+                                                        {
+                                                            .on_increase = on_increase,
+                                                        }
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_array_add_many (array, records, 100);
+    assert (sat_status_get_result (&status) == true);
+    assert (notified_size >= 100);
+
+    status = sat_array_add_many (array, records, 10);
+    assert (sat_status_get_result (&status) == true);
+
+    uint32_t size = 0;
+    sat_array_get_size (array, &size);
+    assert (size == 110);
+
+    record_t record;
+    sat_array_get_object_by (array, 99, &record);
+    assert (record.id == 99);
+
+    sat_array_get_object_by (array, 105, &record);
+    assert (record.id == 5);
+
+    sat_array_destroy (array);
+
+    // static arrays reject a batch that does not fit
+    status = sat_array_create (&array, &(sat_array_args_t)
+                                       {
+                                           .size = 8,
+                                           .object_size = sizeof (record_t),
+                                           .mode = sat_array_mode_static
+                                       });
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_array_add_many (array, records, 9);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_array_add_many (array, records, 8);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_array_reserve (array, 16);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_array_destroy (array);
+}
+
+void test_array_reserve_and_shrink (void)
+{
+    sat_array_t *array = NULL;
+    uint32_t capacity = 0;
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 2,
+                                                        .object_size = sizeof (int),
+                                                        .mode = sat_array_mode_dynamic
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_array_reserve (array, 1000);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_array_get_capacity (array, &capacity);
+    assert (capacity == 1000);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        sat_array_add (array, &i);
+    }
+
+    sat_array_get_capacity (array, &capacity);
+    assert (capacity == 1000);
+
+    for (int i = 0; i < 990; i++)
+    {
+        status = sat_array_swap_remove (array, 0);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_array_shrink_to_fit (array);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_array_get_capacity (array, &capacity);
+    assert (capacity == 10);
+
+    sat_array_clear (array);
+
+    status = sat_array_shrink_to_fit (array);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_array_get_capacity (array, &capacity);
+    assert (capacity == 1);
+
+    status = sat_array_add (array, &(int){7});
+    assert (sat_status_get_result (&status) == true);
+
+    sat_array_destroy (array);
+}
+
+void test_array_remove_variants (void)
+{
+    sat_array_t *array = NULL;
+    int value = 0;
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 5,
+                                                        .object_size = sizeof (int),
+                                                        .mode = sat_array_mode_static
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_array_add_many (array, (int []){0, 1, 2, 3, 4}, 5);
+
+    // order preserving
+    status = sat_array_remove_by (array, 1);
+    assert (sat_status_get_result (&status) == true);
+
+    int expected_ordered [] = {0, 2, 3, 4};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        sat_array_get_object_by (array, i, &value);
+        assert (value == expected_ordered [i]);
+    }
+
+    // unordered, the last element takes the removed position
+    status = sat_array_swap_remove (array, 0);
+    assert (sat_status_get_result (&status) == true);
+
+    int expected_swapped [] = {4, 2, 3};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        sat_array_get_object_by (array, i, &value);
+        assert (value == expected_swapped [i]);
+    }
+
+    status = sat_array_swap_remove (array, 2);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_array_swap_remove (array, 2);
+    assert (sat_status_get_result (&status) == false);
+
+    uint32_t size = 0;
+    sat_array_get_size (array, &size);
+    assert (size == 2);
+
+    sat_array_destroy (array);
+}
+
+void test_array_growth_factor (void)
+{
+    sat_array_t *array = NULL;
+    uint32_t capacity = 0;
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 10,
+                                                        .object_size = sizeof (int),
+                                                        .mode = sat_array_mode_dynamic,
+                                                        .growth_factor = 1.5f
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < 11; i++)
+    {
+        sat_array_add (array, &i);
+    }
+
+    sat_array_get_capacity (array, &capacity);
+    assert (capacity == 15);
+
+    sat_array_t *cloned = NULL;
+    status = sat_array_clone (array, &cloned);
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < 5; i++)
+    {
+        sat_array_add (cloned, &i);
+    }
+
+    sat_array_get_capacity (cloned, &capacity);
+    assert (capacity == 22);
+
+    sat_array_destroy (cloned);
+    sat_array_destroy (array);
+
+    status = sat_array_create (&array, &(sat_array_args_t)
+                                       {
+                                           .size = 10,
+                                           .object_size = sizeof (int),
+                                           .mode = sat_array_mode_dynamic,
+                                           .growth_factor = 0.5f
+                                       });
+    assert (sat_status_get_result (&status) == false);
+}
+
+int main(int argc, char *argv [])
+{
+    test_array_add_many ();
+    test_array_reserve_and_shrink ();
+    test_array_remove_variants ();
+    test_array_growth_factor ();
+
+    return 0;
+}
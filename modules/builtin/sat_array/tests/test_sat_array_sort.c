@@ -0,0 +1,194 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+/**
+ * @brief Tests for sorting, sorted insertion and binary search
+ */
+
+typedef struct
+{
+    uint32_t prefix;
+    uint8_t mask;
+    char interface [16];
+
+} route_t;
+
+static int order_int (const void *const element, const void *const other)
+{
+    int a = *(const int *)element;
+    int b = *(const int *)other;
+
+    return (a > b) - (a < b);
+}
+
+static int order_route (const void *const element, const void *const other)
+{
+    const route_t *a = (const route_t *)element;
+    const route_t *b = (const route_t *)other;
+
+    return (a->prefix > b->prefix) - (a->prefix < b->prefix);
+}
+
+static void assert_sorted (sat_array_t *array)
+{
+    uint32_t size = 0;
+    sat_array_get_size (array, &size);
+
+    for (uint32_t i = 1; i < size; i++)
+    {
+        assert (order_int (sat_array_get_reference_by (array, i - 1), sat_array_get_reference_by (array, i)) <= 0);
+    }
+}
+
+void test_array_sort_patterns (void)
+{
+    const uint32_t amount = 10000;
+    sat_array_t *array = NULL;
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = amount,
+                                                        .object_size = sizeof (int),
+                                                        .mode = sat_array_mode_static
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    // random, ascending, descending, all equal and few distinct values
+    for (int pattern = 0; pattern < 5; pattern++)
+    {
+        sat_array_clear (array);
+        srand (pattern);
+
+        for (uint32_t i = 0; i < amount; i++)
+        {
+            int value = pattern == 0 ? rand () :
+                        pattern == 1 ? (int) i :
+                        pattern == 2 ? (int) (amount - i) :
+                        pattern == 3 ? 7 :
+                                       rand () % 4;
+
+            sat_array_add (array, &value);
+        }
+
+        status = sat_array_sort (array, order_int);
+        assert (sat_status_get_result (&status) == true);
+
+        assert_sorted (array);
+    }
+
+    // no ordering configured nor given
+    status = sat_array_sort (array, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_array_destroy (array);
+}
+
+void test_array_sorted_insert (void)
+{
+    sat_array_t *array = NULL;
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 4,
+                                                        .object_size = sizeof (int),
+                                                        .mode = sat_array_mode_dynamic,
+                                                        .order = order_int
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    srand (42);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        status = sat_array_add (array, &(int){rand () % 500});
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    assert_sorted (array);
+
+    status = sat_array_add_many (array, (int []){900, -1, 250}, 3);
+    assert (sat_status_get_result (&status) == true);
+    assert_sorted (array);
+
+    // updates and swap removals keep the order
+    status = sat_array_update_by (array, &(int){-5}, 500);
+    assert (sat_status_get_result (&status) == true);
+    assert (*(int *) sat_array_get_reference_by (array, 0) == -5);
+
+    status = sat_array_swap_remove (array, 0);
+    assert (sat_status_get_result (&status) == true);
+    assert_sorted (array);
+
+    uint32_t size = 0;
+    sat_array_get_size (array, &size);
+    assert (size == 1002);
+    assert (*(int *) sat_array_get_reference_by (array, size - 1) == 900);
+
+    sat_array_destroy (array);
+}
+
+void test_array_binary_search (void)
+{
+    sat_array_t *array = NULL;
+    uint32_t index = 0;
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t)
+                                                    {
+                                                        .size = 8,
+                                                        .object_size = sizeof (route_t),
+                                                        .mode = sat_array_mode_dynamic,
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        // prefixes 0, 10, 20 ... 490, each present twice
+        route_t route = {.prefix = (i % 50) * 10, .mask = 24};
+        snprintf (route.interface, sizeof (route.interface), "eth%u", i);
+
+        sat_array_add (array, &route);
+    }
+
+    status = sat_array_sort (array, order_route);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_array_lower_bound (array, &(route_t){.prefix = 120}, order_route, &index);
+    assert (sat_status_get_result (&status) == true);
+    assert (index == 24);
+
+    status = sat_array_upper_bound (array, &(route_t){.prefix = 120}, order_route, &index);
+    assert (sat_status_get_result (&status) == true);
+    assert (index == 26);
+
+    status = sat_array_lower_bound (array, &(route_t){.prefix = 125}, order_route, &index);
+    assert (sat_status_get_result (&status) == true);
+    assert (index == 26);
+
+    status = sat_array_upper_bound (array, &(route_t){.prefix = 1000}, order_route, &index);
+    assert (sat_status_get_result (&status) == true);
+    assert (index == 100);
+
+    status = sat_array_binary_find (array, &(route_t){.prefix = 480}, order_route, &index);
+    assert (sat_status_get_result (&status) == true);
+    assert (((route_t *) sat_array_get_reference_by (array, index))->prefix == 480);
+
+    status = sat_array_binary_find (array, &(route_t){.prefix = 481}, order_route, &index);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_array_binary_find (array, &(route_t){.prefix = 0}, NULL, &index);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_array_destroy (array);
+}
+
+int main(int argc, char *argv [])
+{
+    test_array_sort_patterns ();
+    test_array_sorted_insert ();
+    test_array_binary_search ();
+
+    return 0;
+}
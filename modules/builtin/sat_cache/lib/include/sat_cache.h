@@ -1,20 +1,29 @@
 /**
  * @file sat_cache.h
- * @brief Simple buffer caching mechanism for temporary data storage
+ * @brief Buffer and keyed LRU caches for temporary data storage
  * @author Cristiano Silva de Souza
  * @date 2025
  * 
  * This module provides a lightweight caching mechanism for storing and retrieving
  * arbitrary data in a fixed-size buffer. It is useful for temporarily caching
  * computed results, network responses, or frequently accessed data.
+ *
+ * For memoizing many results, sat_cache_lru_t keeps a bounded set of keyed
+ * entries with least recently used eviction, optional per-entry time to live,
+ * a get-or-compute helper, hit/miss/eviction counters and an optional sharded,
+ * thread-safe mode.
  */
 
 #ifndef SAT_CACHE_H_
 #define SAT_CACHE_H_
 
 #include <sat_status.h>
+#include <sat_allocator.h>
 #include <stdint.h>
 
+#define SAT_CACHE_LRU_CAPACITY_MAX      (1u << 30)      /**< Largest capacity of a keyed cache */
+#define SAT_CACHE_LRU_SHARDS_MAX        (1u << 16)      /**< Largest number of shards of a keyed cache */
+
 /**
  * @brief Cache object structure
  * 
@@ -150,4 +159,175 @@ sat_status_t sat_cache_clear (sat_cache_t *const object);
  */
 sat_status_t sat_cache_close (sat_cache_t *const object);
 
+/**
+ * @brief Opaque structure representing a keyed LRU cache
+ *
+ * Holds up to a fixed number of key/value entries. Lookups go through a hash
+ * index and are O(1) on average; when the cache is full the least recently
+ * used entry is evicted. Entries may also expire after a time to live.
+ */
+typedef struct sat_cache_lru_t sat_cache_lru_t;
+
+/**
+ * @brief Hash function type for cache keys
+ *
+ * @param key Pointer to the key
+ * @param key_size Size of the key in bytes
+ * @return Hash of the key
+ */
+typedef uint32_t (*sat_cache_hash_t) (const void *const key, const uint32_t key_size);
+
+/**
+ * @brief Function type that produces a value on a cache miss
+ *
+ * Called by sat_cache_lru_get_or_compute() when the key is not cached, for
+ * example to run the database query or HTTP request being memoized.
+ *
+ * @param user User context given to sat_cache_lru_get_or_compute()
+ * @param key Pointer to the key that missed
+ * @param value Buffer of value_size bytes to fill
+ * @return true to cache and return the value, false to report a failure
+ */
+typedef bool (*sat_cache_compute_t) (void *const user, const void *const key, void *const value);
+
+/**
+ * @brief Configuration structure for keyed cache creation
+ *
+ * Setting @c shards makes the cache thread-safe: the entries are split over
+ * that many independently locked shards, picked by key hash, so threads
+ * working on different keys rarely contend. With @c shards at 0 there is a
+ * single shard and no locking.
+ */
+typedef struct
+{
+    uint32_t key_size;          /**< Size in bytes of each key */
+    uint32_t value_size;        /**< Size in bytes of each value */
+    uint32_t capacity;          /**< Maximum number of entries, split evenly across the shards, at most SAT_CACHE_LRU_CAPACITY_MAX */
+    uint64_t ttl;               /**< Default time to live in milliseconds, 0 keeps entries until evicted */
+    uint32_t shards;            /**< Number of locked shards, rounded up to a power of two, 0 disables locking, at most SAT_CACHE_LRU_SHARDS_MAX */
+    sat_cache_hash_t hash;      /**< Optional key hash, defaults to FNV-1a over the key bytes */
+    sat_allocator_t allocator;  /**< Optional allocator for the cache and its entries, zero selects the C library */
+} sat_cache_lru_args_t;
+
+/**
+ * @brief Cache counters
+ *
+ * Retrieved with sat_cache_lru_get_stats(). Counters accumulate from creation
+ * and are not reset by sat_cache_lru_clear().
+ */
+typedef struct
+{
+    uint64_t hits;              /**< Lookups that found a live entry */
+    uint64_t misses;            /**< Lookups that found nothing or an expired entry */
+    uint64_t evictions;         /**< Entries dropped to make room */
+    uint64_t expirations;       /**< Entries dropped because their time to live ran out */
+    uint32_t size;              /**< Entries currently stored */
+    uint32_t capacity;          /**< Maximum number of entries */
+} sat_cache_stats_t;
+
+/**
+ * @brief Creates a keyed LRU cache
+ *
+ * All entries are allocated up front; no allocation happens afterwards.
+ *
+ * @param[out] object Pointer to the pointer that will hold the created cache
+ * @param[in] args Pointer to the configuration structure
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note The caller is responsible for calling sat_cache_lru_destroy() to free resources
+ * @see sat_cache_lru_destroy()
+ */
+sat_status_t sat_cache_lru_create (sat_cache_lru_t **const object, const sat_cache_lru_args_t *const args);
+
+/**
+ * @brief Stores a value using the default time to live
+ *
+ * Replaces the value if the key is already cached. When the cache (or the
+ * key's shard) is full the least recently used entry is evicted.
+ *
+ * @param[in,out] object Pointer to the cache
+ * @param[in] key Pointer to the key
+ * @param[in] value Pointer to the value
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_cache_lru_put (sat_cache_lru_t *const object, const void *const key, const void *const value);
+
+/**
+ * @brief Stores a value with its own time to live
+ *
+ * @param[in,out] object Pointer to the cache
+ * @param[in] key Pointer to the key
+ * @param[in] value Pointer to the value
+ * @param[in] ttl Time to live in milliseconds, 0 keeps the entry until evicted
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_cache_lru_put_with_ttl (sat_cache_lru_t *const object, const void *const key, const void *const value, const uint64_t ttl);
+
+/**
+ * @brief Looks up a value
+ *
+ * A hit marks the entry as most recently used. Expired entries are dropped
+ * and reported as misses.
+ *
+ * @param[in,out] object Pointer to the cache
+ * @param[in] key Pointer to the key
+ * @param[out] value Buffer that receives a copy of the value
+ * @return sat_status_t indicating success, or failure on a miss
+ */
+sat_status_t sat_cache_lru_get (sat_cache_lru_t *const object, const void *const key, void *const value);
+
+/**
+ * @brief Looks up a value, computing and storing it on a miss
+ *
+ * @param[in,out] object Pointer to the cache
+ * @param[in] key Pointer to the key
+ * @param[out] value Buffer that receives the cached or computed value
+ * @param[in] compute Function that produces the value on a miss
+ * @param[in] user User context passed to @p compute
+ * @return sat_status_t indicating success, or failure if @p compute failed
+ *
+ * @note In a sharded cache @p compute runs without holding the shard lock, so
+ *       concurrent misses on the same key may compute it more than once
+ */
+sat_status_t sat_cache_lru_get_or_compute (sat_cache_lru_t *const object, const void *const key, void *const value, sat_cache_compute_t compute, void *const user);
+
+/**
+ * @brief Removes a key from the cache
+ *
+ * @param[in,out] object Pointer to the cache
+ * @param[in] key Pointer to the key
+ * @return sat_status_t indicating success, or failure if the key was not cached
+ */
+sat_status_t sat_cache_lru_remove (sat_cache_lru_t *const object, const void *const key);
+
+/**
+ * @brief Removes every entry
+ *
+ * @param[in,out] object Pointer to the cache
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_cache_lru_clear (sat_cache_lru_t *const object);
+
+/**
+ * @brief Retrieves the cache counters
+ *
+ * @param[in] object Pointer to the cache
+ * @param[out] stats Pointer to store the counters
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note In a sharded cache the shards are read one after the other, so the
+ *       totals are a snapshot while other threads are active
+ */
+sat_status_t sat_cache_lru_get_stats (sat_cache_lru_t *const object, sat_cache_stats_t *const stats);
+
+/**
+ * @brief Destroys the cache and frees all associated resources
+ *
+ * @param[in,out] object Pointer to the cache
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @warning No thread may be using the cache when it is destroyed
+ */
+sat_status_t sat_cache_lru_destroy (sat_cache_lru_t *const object);
+
 #endif/* SAT_CACHE_H_ */
@@ -1,6 +1,94 @@
 #include <sat_cache.h>
+#include <sat_hash.h>
 #include <string.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#define SAT_CACHE_LRU_NONE      UINT32_MAX
+
+typedef struct
+{
+    uint32_t prev;          // towards the most recently used entry
+    uint32_t next;          // towards the least recently used entry, or next free entry
+    uint32_t chain;         // next entry in the same bucket
+    uint32_t hash;
+    uint64_t expires;       // monotonic milliseconds, 0 never expires
+} sat_cache_lru_entry_t;    // followed by the key and the value
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    uint8_t *entries;
+    uint32_t *buckets;
+    uint32_t mask;
+    uint32_t capacity;
+    uint32_t size;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t free;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t expirations;
+} sat_cache_lru_shard_t;
+
+struct sat_cache_lru_t
+{
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t value_offset;
+    uint32_t stride;
+    uint64_t ttl;
+    bool locked;
+    uint32_t shard_count;
+    uint32_t shard_shift;
+    sat_cache_hash_t hash;
+    sat_allocator_t allocator;
+    sat_cache_lru_shard_t *shards;
+};
+
+static uint32_t sat_cache_lru_hash (const sat_cache_lru_t *const object, const void *const key);
+static sat_cache_lru_shard_t *sat_cache_lru_shard_for (const sat_cache_lru_t *const object, const uint32_t hash);
+static void sat_cache_lru_shard_reset (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard);
+static uint32_t sat_cache_lru_find (const sat_cache_lru_t *const object, const sat_cache_lru_shard_t *const shard, const uint32_t hash, const void *const key);
+static void sat_cache_lru_unlink (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard, const uint32_t index);
+static void sat_cache_lru_push_front (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard, const uint32_t index);
+static void sat_cache_lru_drop (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard, const uint32_t index);
+static void sat_cache_lru_release (sat_cache_lru_t *const object, const uint32_t shards);
+static uint64_t sat_cache_lru_now (void);
+
+static inline uint32_t sat_cache_lru_align (const uint32_t size)
+{
+    return (size + 7u) & ~7u;
+}
+
+static inline sat_cache_lru_entry_t *sat_cache_lru_entry (const sat_cache_lru_t *const object, const sat_cache_lru_shard_t *const shard, const uint32_t index)
+{
+    return (sat_cache_lru_entry_t *) (shard->entries + (size_t) index * object->stride);
+}
+
+static inline uint8_t *sat_cache_lru_key (sat_cache_lru_entry_t *const entry)
+{
+    return (uint8_t *) entry + sizeof (sat_cache_lru_entry_t);
+}
+
+static inline uint8_t *sat_cache_lru_value (const sat_cache_lru_t *const object, sat_cache_lru_entry_t *const entry)
+{
+    return (uint8_t *) entry + object->value_offset;
+}
+
+static inline void sat_cache_lru_lock (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard)
+{
+    if (object->locked == true)
+        pthread_mutex_lock (&shard->mutex);
+}
+
+static inline void sat_cache_lru_unlock (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard)
+{
+    if (object->locked == true)
+        pthread_mutex_unlock (&shard->mutex);
+}
 
 sat_status_t sat_cache_init (sat_cache_t *const object)
 {
@@ -80,3 +168,396 @@ sat_status_t sat_cache_close (sat_cache_t *const object)
 
     sat_status_return_on_success ();
 }
+
+sat_status_t sat_cache_lru_create (sat_cache_lru_t **const object, const sat_cache_lru_args_t *const args)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (args, "null args");
+    sat_status_return_on_equals (args->key_size, 0, "zero key size");
+    sat_status_return_on_equals (args->value_size, 0, "zero value size");
+    sat_status_return_on_equals (args->capacity, 0, "zero capacity");
+    sat_status_return_on_greater_than (args->capacity, SAT_CACHE_LRU_CAPACITY_MAX, "capacity too large");
+    sat_status_return_on_greater_than (args->shards, SAT_CACHE_LRU_SHARDS_MAX, "too many shards");
+    sat_status_return_on_greater_than (args->shards, args->capacity, "more shards than entries");
+
+    sat_cache_lru_t *__object = sat_allocator_allocate_zeroed (&args->allocator, sizeof (sat_cache_lru_t));
+    sat_status_return_on_null (__object, "allocation failed");
+
+    __object->key_size = args->key_size;
+    __object->value_size = args->value_size;
+    __object->value_offset = sizeof (sat_cache_lru_entry_t) + sat_cache_lru_align (args->key_size);
+    __object->stride = sat_cache_lru_align (__object->value_offset + args->value_size);
+    __object->ttl = args->ttl;
+    __object->locked = args->shards > 0;
+    __object->shard_count = args->shards > 0 ? sat_hash_next_power_of_two (args->shards) : 1;
+
+    if (__object->shard_count == 0)
+    {
+        sat_allocator_release (&args->allocator, __object, sizeof (sat_cache_lru_t));
+        sat_status_return_on_failure ("too many shards");
+    }
+
+    __object->hash = args->hash != NULL ? args->hash : sat_hash_bytes;
+    __object->allocator = args->allocator;
+
+    // The shard comes from the top bits of the hash, the bucket from the low ones.
+    __object->shard_shift = 32;
+    for (uint32_t count = __object->shard_count; count > 1; count >>= 1)
+        __object->shard_shift --;
+
+    __object->shards = sat_allocator_allocate_zeroed (&args->allocator, __object->shard_count * sizeof (sat_cache_lru_shard_t));
+    if (__object->shards == NULL)
+    {
+        sat_allocator_release (&args->allocator, __object, sizeof (sat_cache_lru_t));
+        sat_status_return_on_failure ("shard allocation failed");
+    }
+
+    uint32_t capacity = (args->capacity + __object->shard_count - 1) / __object->shard_count;
+
+    if (sat_hash_next_power_of_two (capacity) == 0)
+    {
+        sat_cache_lru_release (__object, 0);
+        sat_status_return_on_failure ("capacity too large");
+    }
+
+    for (uint32_t i = 0; i < __object->shard_count; i++)
+    {
+        sat_cache_lru_shard_t *shard = &__object->shards [i];
+
+        shard->capacity = capacity;
+        shard->mask = sat_hash_next_power_of_two (capacity) - 1;
+        shard->entries = sat_allocator_allocate (&args->allocator, (size_t) capacity * __object->stride);
+        shard->buckets = sat_allocator_allocate (&args->allocator, (size_t) (shard->mask + 1) * sizeof (uint32_t));
+
+        if (shard->entries == NULL || shard->buckets == NULL)
+        {
+            sat_cache_lru_release (__object, i + 1);
+            sat_status_return_on_failure ("entry allocation failed");
+        }
+
+        if (__object->locked == true)
+            pthread_mutex_init (&shard->mutex, NULL);
+
+        sat_cache_lru_shard_reset (__object, shard);
+    }
+
+    *object = __object;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_cache_lru_put (sat_cache_lru_t *const object, const void *const key, const void *const value)
+{
+    sat_status_return_on_null (object, "null object");
+
+    return sat_cache_lru_put_with_ttl (object, key, value, object->ttl);
+}
+
+sat_status_t sat_cache_lru_put_with_ttl (sat_cache_lru_t *const object, const void *const key, const void *const value, const uint64_t ttl)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+    sat_status_return_on_null (value, "null value");
+
+    uint32_t hash = sat_cache_lru_hash (object, key);
+    uint64_t expires = ttl > 0 ? sat_cache_lru_now () + ttl : 0;
+    sat_cache_lru_shard_t *shard = sat_cache_lru_shard_for (object, hash);
+
+    sat_cache_lru_lock (object, shard);
+
+    uint32_t index = sat_cache_lru_find (object, shard, hash, key);
+
+    if (index != SAT_CACHE_LRU_NONE)
+        sat_cache_lru_unlink (object, shard, index);
+
+    else
+    {
+        if (shard->free == SAT_CACHE_LRU_NONE)
+        {
+            sat_cache_lru_drop (object, shard, shard->tail);
+            shard->evictions ++;
+        }
+
+        index = shard->free;
+
+        sat_cache_lru_entry_t *entry = sat_cache_lru_entry (object, shard, index);
+        uint32_t *bucket = &shard->buckets [hash & shard->mask];
+
+        shard->free = entry->next;
+        shard->size ++;
+
+        entry->hash = hash;
+        entry->chain = *bucket;
+        *bucket = index;
+
+        memcpy (sat_cache_lru_key (entry), key, object->key_size);
+    }
+
+    sat_cache_lru_entry_t *entry = sat_cache_lru_entry (object, shard, index);
+
+    entry->expires = expires;
+    memcpy (sat_cache_lru_value (object, entry), value, object->value_size);
+
+    sat_cache_lru_push_front (object, shard, index);
+
+    sat_cache_lru_unlock (object, shard);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_cache_lru_get (sat_cache_lru_t *const object, const void *const key, void *const value)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+    sat_status_return_on_null (value, "null value");
+
+    uint32_t hash = sat_cache_lru_hash (object, key);
+    sat_cache_lru_shard_t *shard = sat_cache_lru_shard_for (object, hash);
+    bool found = false;
+
+    sat_cache_lru_lock (object, shard);
+
+    uint32_t index = sat_cache_lru_find (object, shard, hash, key);
+
+    if (index != SAT_CACHE_LRU_NONE)
+    {
+        sat_cache_lru_entry_t *entry = sat_cache_lru_entry (object, shard, index);
+
+        if (entry->expires != 0 && entry->expires <= sat_cache_lru_now ())
+        {
+            sat_cache_lru_drop (object, shard, index);
+            shard->expirations ++;
+        }
+
+        else
+        {
+            memcpy (value, sat_cache_lru_value (object, entry), object->value_size);
+
+            if (shard->head != index)
+            {
+                sat_cache_lru_unlink (object, shard, index);
+                sat_cache_lru_push_front (object, shard, index);
+            }
+
+            found = true;
+        }
+    }
+
+    if (found == true)
+        shard->hits ++;
+    else
+        shard->misses ++;
+
+    sat_cache_lru_unlock (object, shard);
+
+    sat_status_return_on_false (found, "key is not cached");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_cache_lru_get_or_compute (sat_cache_lru_t *const object, const void *const key, void *const value, sat_cache_compute_t compute, void *const user)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+    sat_status_return_on_null (value, "null value");
+    sat_status_return_on_null (compute, "null compute");
+
+    sat_status_t status = sat_cache_lru_get (object, key, value);
+    if (sat_status_get_result (&status) == true)
+        return status;
+
+    sat_status_return_on_false (compute (user, key, value), "compute failed");
+
+    return sat_cache_lru_put (object, key, value);
+}
+
+sat_status_t sat_cache_lru_remove (sat_cache_lru_t *const object, const void *const key)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+
+    uint32_t hash = sat_cache_lru_hash (object, key);
+    sat_cache_lru_shard_t *shard = sat_cache_lru_shard_for (object, hash);
+
+    sat_cache_lru_lock (object, shard);
+
+    uint32_t index = sat_cache_lru_find (object, shard, hash, key);
+
+    if (index != SAT_CACHE_LRU_NONE)
+        sat_cache_lru_drop (object, shard, index);
+
+    sat_cache_lru_unlock (object, shard);
+
+    sat_status_return_on_equals (index, SAT_CACHE_LRU_NONE, "key is not cached");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_cache_lru_clear (sat_cache_lru_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    for (uint32_t i = 0; i < object->shard_count; i++)
+    {
+        sat_cache_lru_shard_t *shard = &object->shards [i];
+
+        sat_cache_lru_lock (object, shard);
+        sat_cache_lru_shard_reset (object, shard);
+        sat_cache_lru_unlock (object, shard);
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_cache_lru_get_stats (sat_cache_lru_t *const object, sat_cache_stats_t *const stats)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (stats, "null stats");
+
+    memset (stats, 0, sizeof (sat_cache_stats_t));
+
+    for (uint32_t i = 0; i < object->shard_count; i++)
+    {
+        sat_cache_lru_shard_t *shard = &object->shards [i];
+
+        sat_cache_lru_lock (object, shard);
+
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->evictions += shard->evictions;
+        stats->expirations += shard->expirations;
+        stats->size += shard->size;
+        stats->capacity += shard->capacity;
+
+        sat_cache_lru_unlock (object, shard);
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_cache_lru_destroy (sat_cache_lru_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    sat_cache_lru_release (object, object->shard_count);
+
+    sat_status_return_on_success ();
+}
+
+static uint32_t sat_cache_lru_hash (const sat_cache_lru_t *const object, const void *const key)
+{
+    // The shard comes from the high bits, the bucket from the low ones.
+    return sat_hash_mix (object->hash (key, object->key_size));
+}
+
+static sat_cache_lru_shard_t *sat_cache_lru_shard_for (const sat_cache_lru_t *const object, const uint32_t hash)
+{
+    uint32_t index = object->shard_shift < 32 ? hash >> object->shard_shift : 0;
+
+    return &object->shards [index];
+}
+
+static void sat_cache_lru_shard_reset (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard)
+{
+    memset (shard->buckets, 0xFF, (size_t) (shard->mask + 1) * sizeof (uint32_t));
+
+    for (uint32_t i = 0; i < shard->capacity; i++)
+        sat_cache_lru_entry (object, shard, i)->next = i + 1 < shard->capacity ? i + 1 : SAT_CACHE_LRU_NONE;
+
+    shard->free = 0;
+    shard->size = 0;
+    shard->head = SAT_CACHE_LRU_NONE;
+    shard->tail = SAT_CACHE_LRU_NONE;
+}
+
+static uint32_t sat_cache_lru_find (const sat_cache_lru_t *const object, const sat_cache_lru_shard_t *const shard, const uint32_t hash, const void *const key)
+{
+    uint32_t index = shard->buckets [hash & shard->mask];
+
+    while (index != SAT_CACHE_LRU_NONE)
+    {
+        sat_cache_lru_entry_t *entry = sat_cache_lru_entry (object, shard, index);
+
+        if (entry->hash == hash && memcmp (sat_cache_lru_key (entry), key, object->key_size) == 0)
+            break;
+
+        index = entry->chain;
+    }
+
+    return index;
+}
+
+static void sat_cache_lru_unlink (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard, const uint32_t index)
+{
+    sat_cache_lru_entry_t *entry = sat_cache_lru_entry (object, shard, index);
+
+    if (entry->prev != SAT_CACHE_LRU_NONE)
+        sat_cache_lru_entry (object, shard, entry->prev)->next = entry->next;
+    else
+        shard->head = entry->next;
+
+    if (entry->next != SAT_CACHE_LRU_NONE)
+        sat_cache_lru_entry (object, shard, entry->next)->prev = entry->prev;
+    else
+        shard->tail = entry->prev;
+}
+
+static void sat_cache_lru_push_front (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard, const uint32_t index)
+{
+    sat_cache_lru_entry_t *entry = sat_cache_lru_entry (object, shard, index);
+
+    entry->prev = SAT_CACHE_LRU_NONE;
+    entry->next = shard->head;
+
+    if (shard->head != SAT_CACHE_LRU_NONE)
+        sat_cache_lru_entry (object, shard, shard->head)->prev = index;
+    else
+        shard->tail = index;
+
+    shard->head = index;
+}
+
+static void sat_cache_lru_drop (const sat_cache_lru_t *const object, sat_cache_lru_shard_t *const shard, const uint32_t index)
+{
+    sat_cache_lru_entry_t *entry = sat_cache_lru_entry (object, shard, index);
+    uint32_t *link = &shard->buckets [entry->hash & shard->mask];
+
+    while (*link != index)
+        link = &sat_cache_lru_entry (object, shard, *link)->chain;
+
+    *link = entry->chain;
+
+    sat_cache_lru_unlink (object, shard, index);
+
+    entry->next = shard->free;
+    shard->free = index;
+    shard->size --;
+}
+
+static void sat_cache_lru_release (sat_cache_lru_t *const object, const uint32_t shards)
+{
+    sat_allocator_t allocator = object->allocator;
+
+    for (uint32_t i = 0; i < shards; i++)
+    {
+        sat_cache_lru_shard_t *shard = &object->shards [i];
+
+        if (object->locked == true && shard->entries != NULL && shard->buckets != NULL)
+            pthread_mutex_destroy (&shard->mutex);
+
+        sat_allocator_release (&allocator, shard->entries, (size_t) shard->capacity * object->stride);
+        sat_allocator_release (&allocator, shard->buckets, (size_t) (shard->mask + 1) * sizeof (uint32_t));
+    }
+
+    sat_allocator_release (&allocator, object->shards, object->shard_count * sizeof (sat_cache_lru_shard_t));
+    sat_allocator_release (&allocator, object, sizeof (sat_cache_lru_t));
+}
+
+static uint64_t sat_cache_lru_now (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000u + (uint64_t) now.tv_nsec / 1000000u;
+}
@@ -1,7 +1,58 @@
 #include <sat.h>
+#include <stdio.h>
+#include <unistd.h>
+
+typedef struct
+{
+    char country [32];
+} geo_t;
+
+static bool slow_geo_lookup (void *const user, const void *const key, void *const value)
+{
+    uint32_t address = *(const uint32_t *) key;
+    geo_t *geo = (geo_t *) value;
+
+    // Stands in for a database query or an HTTP request.
+    usleep (1000);
+
+    snprintf (geo->country, sizeof (geo->country), "%s", (address & 1) ? "BR" : "PT");
+
+    return true;
+}
 
 int main (int argc, char **argv)
 {
-    
+    sat_cache_lru_t *cache;
+
+    sat_status_t status = sat_cache_lru_create (&cache, &(sat_cache_lru_args_t)
+                                                        {
+                                                            .key_size = sizeof (uint32_t),
+                                                            .value_size = sizeof (geo_t),
+                                                            .capacity = 128,
+                                                            .ttl = 60 * 1000,
+                                                        });
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    for (uint32_t request = 0; request < 1000; request++)
+    {
+        uint32_t address = request % 100;
+        geo_t geo;
+
+        sat_cache_lru_get_or_compute (cache, &address, &geo, slow_geo_lookup, NULL);
+    }
+
+    sat_cache_stats_t stats;
+    sat_cache_lru_get_stats (cache, &stats);
+
+    printf ("hits: %lu, misses: %lu, evictions: %lu, size: %u/%u\n",
+            (unsigned long) stats.hits,
+            (unsigned long) stats.misses,
+            (unsigned long) stats.evictions,
+            stats.size,
+            stats.capacity);
+
+    sat_cache_lru_destroy (cache);
+
     return 0;
 }
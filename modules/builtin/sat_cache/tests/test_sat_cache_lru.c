@@ -0,0 +1,285 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct
+{
+    char name [32];
+    uint32_t age;
+} profile_t;
+
+typedef struct
+{
+    uint32_t calls;
+} lookup_t;
+
+static bool lookup_profile (void *const user, const void *const key, void *const value)
+{
+    lookup_t *lookup = (lookup_t *) user;
+    uint32_t id = *(const uint32_t *) key;
+    profile_t *profile = (profile_t *) value;
+
+    lookup->calls ++;
+
+    if (id == 0)
+        return false;
+
+    snprintf (profile->name, sizeof (profile->name), "user-%u", id);
+    profile->age = id % 100;
+
+    return true;
+}
+
+static sat_cache_lru_t *create_cache (uint32_t capacity, uint64_t ttl, uint32_t shards)
+{
+    sat_cache_lru_t *cache = NULL;
+
+    sat_status_t status = sat_cache_lru_create (&cache, &(sat_cache_lru_args_t)
+                                                        {
+                                                            .key_size = sizeof (uint32_t),
+                                                            .value_size = sizeof (profile_t),
+                                                            .capacity = capacity,
+                                                            .ttl = ttl,
+                                                            .shards = shards,
+                                                        });
+    assert (sat_status_get_result (&status) == true);
+
+    return cache;
+}
+
+static void test_put_get (void)
+{
+    sat_cache_lru_t *cache = create_cache (128, 0, 0);
+    profile_t profile = {.name = "John Doe", .age = 36};
+    profile_t recover;
+    uint32_t key = 7;
+
+    sat_status_t status = sat_cache_lru_get (cache, &key, &recover);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_cache_lru_put (cache, &key, &profile);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_cache_lru_get (cache, &key, &recover);
+    assert (sat_status_get_result (&status) == true);
+    assert (strcmp (recover.name, "John Doe") == 0 && recover.age == 36);
+
+    // Storing an existing key replaces the value in place.
+    profile.age = 37;
+    sat_cache_lru_put (cache, &key, &profile);
+    sat_cache_lru_get (cache, &key, &recover);
+    assert (recover.age == 37);
+
+    status = sat_cache_lru_remove (cache, &key);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_cache_lru_remove (cache, &key);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_cache_stats_t stats;
+    sat_cache_lru_get_stats (cache, &stats);
+    assert (stats.hits == 2);
+    assert (stats.misses == 1);
+    assert (stats.size == 0);
+    assert (stats.capacity == 128);
+
+    status = sat_cache_lru_create (NULL, &(sat_cache_lru_args_t) {.key_size = 4, .value_size = 4, .capacity = 1});
+    assert (sat_status_get_result (&status) == false);
+
+    sat_cache_lru_destroy (cache);
+}
+
+static void test_eviction_order (void)
+{
+    sat_cache_lru_t *cache = create_cache (4, 0, 0);
+    profile_t profile = {0};
+    sat_status_t status;
+
+    for (uint32_t key = 1; key <= 4; key++)
+        sat_cache_lru_put (cache, &key, &profile);
+
+    // Touch 1 so that 2 becomes the least recently used entry.
+    uint32_t key = 1;
+    status = sat_cache_lru_get (cache, &key, &profile);
+    assert (sat_status_get_result (&status) == true);
+
+    key = 5;
+    sat_cache_lru_put (cache, &key, &profile);
+
+    key = 2;
+    status = sat_cache_lru_get (cache, &key, &profile);
+    assert (sat_status_get_result (&status) == false);
+
+    for (key = 1; key <= 5; key++)
+    {
+        if (key == 2)
+            continue;
+
+        status = sat_cache_lru_get (cache, &key, &profile);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    // Many more keys than slots: the size stays bounded.
+    for (key = 100; key < 1100; key++)
+        sat_cache_lru_put (cache, &key, &profile);
+
+    sat_cache_stats_t stats;
+    sat_cache_lru_get_stats (cache, &stats);
+    assert (stats.size == 4);
+    assert (stats.evictions == 1 + 1000);
+
+    sat_cache_lru_clear (cache);
+    sat_cache_lru_get_stats (cache, &stats);
+    assert (stats.size == 0);
+
+    key = 1099;
+    status = sat_cache_lru_get (cache, &key, &profile);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_cache_lru_destroy (cache);
+}
+
+static void test_ttl (void)
+{
+    sat_cache_lru_t *cache = create_cache (16, 20, 0);
+    profile_t profile = {0};
+    sat_status_t status;
+
+    uint32_t expiring = 1;
+    uint32_t lasting = 2;
+
+    sat_cache_lru_put (cache, &expiring, &profile);
+    sat_cache_lru_put_with_ttl (cache, &lasting, &profile, 0);
+
+    status = sat_cache_lru_get (cache, &expiring, &profile);
+    assert (sat_status_get_result (&status) == true);
+
+    usleep (40 * 1000);
+
+    status = sat_cache_lru_get (cache, &expiring, &profile);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_cache_lru_get (cache, &lasting, &profile);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_cache_stats_t stats;
+    sat_cache_lru_get_stats (cache, &stats);
+    assert (stats.expirations == 1);
+    assert (stats.size == 1);
+
+    sat_cache_lru_destroy (cache);
+}
+
+static void test_get_or_compute (void)
+{
+    sat_cache_lru_t *cache = create_cache (64, 0, 0);
+    lookup_t lookup = {0};
+    profile_t profile;
+    sat_status_t status;
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (uint32_t id = 1; id <= 10; id++)
+        {
+            status = sat_cache_lru_get_or_compute (cache, &id, &profile, lookup_profile, &lookup);
+            assert (sat_status_get_result (&status) == true);
+            assert (profile.age == id);
+        }
+    }
+
+    assert (lookup.calls == 10);
+
+    // A failed computation is reported and not cached.
+    uint32_t id = 0;
+    status = sat_cache_lru_get_or_compute (cache, &id, &profile, lookup_profile, &lookup);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_cache_lru_get (cache, &id, &profile);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_cache_stats_t stats;
+    sat_cache_lru_get_stats (cache, &stats);
+    assert (stats.hits == 20);
+    assert (stats.size == 10);
+
+    sat_cache_lru_destroy (cache);
+}
+
+#define THREADS     4
+#define OPERATIONS  20000
+
+static void *sharded_worker (void *argument)
+{
+    sat_cache_lru_t *cache = (sat_cache_lru_t *) argument;
+    lookup_t lookup = {0};
+    profile_t profile;
+
+    for (uint32_t i = 0; i < OPERATIONS; i++)
+    {
+        uint32_t id = 1 + (i * 7919u) % 512;
+
+        sat_status_t status = sat_cache_lru_get_or_compute (cache, &id, &profile, lookup_profile, &lookup);
+        assert (sat_status_get_result (&status) == true);
+        assert (profile.age == id % 100);
+    }
+
+    return NULL;
+}
+
+static void test_sharded (void)
+{
+    sat_cache_lru_t *cache = create_cache (256, 0, 8);
+    pthread_t threads [THREADS];
+
+    for (int i = 0; i < THREADS; i++)
+        pthread_create (&threads [i], NULL, sharded_worker, cache);
+
+    for (int i = 0; i < THREADS; i++)
+        pthread_join (threads [i], NULL);
+
+    sat_cache_stats_t stats;
+    sat_cache_lru_get_stats (cache, &stats);
+    assert (stats.hits + stats.misses == THREADS * OPERATIONS);
+    assert (stats.capacity == 256);
+    assert (stats.size <= stats.capacity);
+
+    sat_cache_lru_destroy (cache);
+}
+
+static void test_too_large (void)
+{
+    sat_cache_lru_t *cache = NULL;
+    sat_cache_lru_args_t args =
+    {
+        .key_size = sizeof (uint32_t),
+        .value_size = sizeof (profile_t),
+        .capacity = UINT32_MAX,
+    };
+
+    // Rounding such a capacity up used to hang instead of failing.
+    sat_status_t status = sat_cache_lru_create (&cache, &args);
+    assert (sat_status_get_result (&status) == false);
+
+    args.capacity = SAT_CACHE_LRU_CAPACITY_MAX + 1;
+    status = sat_cache_lru_create (&cache, &args);
+    assert (sat_status_get_result (&status) == false);
+
+    args.capacity = SAT_CACHE_LRU_SHARDS_MAX * 2;
+    args.shards = SAT_CACHE_LRU_SHARDS_MAX + 1;
+    status = sat_cache_lru_create (&cache, &args);
+    assert (sat_status_get_result (&status) == false);
+}
+
+int main (int argc, char *argv[])
+{
+    test_put_get ();
+    test_eviction_order ();
+    test_ttl ();
+    test_get_or_compute ();
+    test_sharded ();
+    test_too_large ();
+
+    return 0;
+}
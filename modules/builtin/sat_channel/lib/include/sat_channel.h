@@ -8,13 +8,84 @@
  * 
  * The channel is useful for producer-consumer patterns, thread synchronization,
  * and message passing between threads within the same process.
+ *
+ * Three modes are available:
+ *
+ * - sat_channel_mode_stream: a plain byte stream; reads may return partial or
+ *   merged writes. This is the original behaviour.
+ * - sat_channel_mode_message: every message is sent with a length header, so
+ *   the reader gets exactly what was sent. A batch of messages goes out in a
+ *   single system call and one read drains as many messages as fit in the
+ *   receive buffer.
+ * - sat_channel_mode_ring: an in-process byte ring shared by one writer and
+ *   one reader. Messages are copied without entering the kernel; an eventfd
+ *   wakes the reader only when the ring turns from empty to non-empty.
+ *
+ * With non_blocking set, both ends can be driven from an event loop: the
+ * descriptors from sat_channel_get_fd() are pollable.
  */
 
 #ifndef SAT_CHANNEL_H_
 #define SAT_CHANNEL_H_
 
 #include <sat_status.h>
+#include <sat_reactor.h>
 #include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Size, in bytes, of the receive buffer or ring allocated when none is given
+ */
+#define SAT_CHANNEL_SIZE_DEFAULT        65536
+
+/**
+ * @brief Largest number of messages gathered into one system call
+ */
+#define SAT_CHANNEL_BATCH               512
+
+/**
+ * @brief Cache line size, in bytes, used to separate the ring indices
+ */
+#define SAT_CHANNEL_CACHE_LINE_SIZE     64
+
+/**
+ * @brief Channel transport
+ */
+typedef enum
+{
+    sat_channel_mode_stream,        /**< Unframed byte stream over a socket pair */
+    sat_channel_mode_message,       /**< Length-framed messages over a socket pair */
+    sat_channel_mode_ring,          /**< Length-framed messages over an in-process ring */
+} sat_channel_mode_t;
+
+/**
+ * @brief Side of the channel a descriptor belongs to
+ */
+typedef enum
+{
+    sat_channel_end_read,           /**< Readable when messages are available */
+    sat_channel_end_write,          /**< Writable when there is room for more */
+} sat_channel_end_t;
+
+/**
+ * @brief Message description used by sat_channel_send_many()
+ */
+typedef struct
+{
+    const void *data;               /**< Message payload */
+    uint32_t size;                  /**< Payload size in bytes, greater than zero */
+} sat_channel_message_t;
+
+typedef struct sat_channel_t sat_channel_t;
+
+/**
+ * @brief Function called on the reactor thread when an attached channel is readable
+ * 
+ * @param object The channel, to be drained with sat_channel_receive() (or
+ *               sat_channel_read() in stream mode)
+ * @param data Context pointer given to sat_channel_attach()
+ */
+typedef void (*sat_channel_handler_t) (sat_channel_t *const object, void *const data);
 
 /**
  * @brief Channel structure
@@ -23,23 +94,37 @@
  * This structure should be treated as opaque and accessed only through
  * the provided API functions.
  */
-typedef struct
+struct sat_channel_t
 {
-    int pair [2];           /**< Pipe file descriptor pair [read_fd, write_fd] */
-    uint8_t *buffer;        /**< Internal buffer (reserved for future use) */
-    uint32_t size;          /**< Buffer size (reserved for future use) */
-} sat_channel_t;
+    int pair [2];           /**< Socket pair [write_fd, read_fd] */
+    uint8_t *buffer;        /**< Receive buffer (message mode) or ring storage (ring mode) */
+    uint32_t size;          /**< Buffer size in bytes */
+    uint32_t start;         /**< First unparsed byte in the receive buffer */
+    uint32_t end;           /**< One past the last received byte */
+    int event;              /**< Reader wakeup eventfd (ring mode) */
+    sat_channel_mode_t mode;
+    bool non_blocking;
+    bool owned;             /**< The buffer was allocated by the channel */
+    uint32_t head __attribute__ ((aligned (SAT_CHANNEL_CACHE_LINE_SIZE)));  /**< Ring read position, written by the reader */
+    sat_reactor_t *reactor; /**< Reactor the read end is attached to, if any */
+    sat_channel_handler_t handler;
+    void *data;
+    uint32_t tail __attribute__ ((aligned (SAT_CHANNEL_CACHE_LINE_SIZE)));  /**< Ring write position, written by the writer */
+};
 
 /**
  * @brief Channel initialization arguments
  * 
- * Configuration parameters for opening a channel. Currently both fields
- * are reserved for future use and can be set to NULL/0.
+ * A zeroed structure opens a blocking stream channel. In message mode the
+ * buffer receives the frames and in ring mode it holds the ring itself; in
+ * both it bounds the largest message (size minus a 4 byte header).
  */
 typedef struct
 {
-    uint8_t *buffer;        /**< Custom buffer (reserved for future use) */
-    uint32_t size;          /**< Custom buffer size (reserved for future use) */
+    uint8_t *buffer;        /**< Caller's buffer, or NULL to allocate one */
+    uint32_t size;          /**< Buffer size, 0 for SAT_CHANNEL_SIZE_DEFAULT; a power of two in ring mode */
+    sat_channel_mode_t mode;    /**< Transport, sat_channel_mode_stream by default */
+    bool non_blocking;      /**< Return instead of waiting when empty or full */
 } sat_channel_args_t;
 
 /**
@@ -67,7 +152,7 @@ sat_status_t sat_channel_init (sat_channel_t *const object);
  * @param args Pointer to initialization arguments (can be NULL or empty struct)
  * @return Status structure indicating success or failure
  * @note The channel must be initialized with sat_channel_init() first
- * @note The args parameter is currently unused; pass NULL or empty struct
+ * @note A caller's buffer must outlive the channel
  * @warning Fails if the system cannot create a pipe (e.g., resource limits)
  * @see sat_channel_init()
  * @see sat_channel_close()
@@ -88,6 +173,7 @@ sat_status_t sat_channel_open (sat_channel_t *const object, const sat_channel_ar
  * @note Write operations are atomic for sizes up to PIPE_BUF (typically 4096 bytes)
  * @note May block if the pipe buffer is full
  * @warning NULL buffer pointer causes undefined behavior
+ * @warning Only available in sat_channel_mode_stream
  * @see sat_channel_read()
  */
 sat_status_t sat_channel_write (sat_channel_t *const object, const uint8_t *const buffer, uint32_t size);
@@ -106,10 +192,104 @@ sat_status_t sat_channel_write (sat_channel_t *const object, const uint8_t *cons
  * @note May read fewer bytes than requested if less data is available
  * @warning NULL buffer pointer causes undefined behavior
  * @warning Buffer must be large enough to hold size bytes
+ * @warning Only available in sat_channel_mode_stream
  * @see sat_channel_write()
  */
 sat_status_t sat_channel_read (sat_channel_t *const object, uint8_t *const buffer, uint32_t size);
 
+/**
+ * @brief Send one message
+ * 
+ * Equivalent to sat_channel_send_many() with a single message.
+ * 
+ * @param object Pointer to the opened channel structure
+ * @param data Pointer to the payload
+ * @param size Payload size in bytes
+ * @return Status structure indicating success or failure
+ * @see sat_channel_send_many()
+ */
+sat_status_t sat_channel_send (sat_channel_t *const object, const void *const data, uint32_t size);
+
+/**
+ * @brief Send a batch of messages
+ * 
+ * In message mode up to SAT_CHANNEL_BATCH messages and their headers are
+ * gathered into one sendmsg() call. In ring mode the batch is copied into the
+ * ring and published at once, so the reader is woken at most once.
+ * 
+ * A non-blocking channel either takes the whole batch or fails with
+ * "channel full" without sending anything; once part of a batch is in the
+ * socket the rest is waited for, so a frame is never left half written.
+ * 
+ * @param object Pointer to the opened channel structure
+ * @param messages Array of messages
+ * @param amount Number of messages in the array
+ * @return Status structure indicating success or failure
+ * @note Not available in sat_channel_mode_stream
+ * @warning Only one thread may send on a channel at a time
+ */
+sat_status_t sat_channel_send_many (sat_channel_t *const object, const sat_channel_message_t *const messages, uint32_t amount);
+
+/**
+ * @brief Receive one message
+ * 
+ * Messages are returned whole and in order. In message mode a single recv()
+ * fills the receive buffer, and later calls are served from it until it runs
+ * out, so a burst of small messages costs one system call.
+ * 
+ * @param object Pointer to the opened channel structure
+ * @param buffer Destination of the payload
+ * @param capacity Size of the destination in bytes
+ * @param[out] size Payload size, or 0 when a non-blocking channel is empty
+ * @return Status structure indicating success or failure
+ * @note A message larger than capacity is left in the channel and the call fails
+ * @note Fails with "channel closed" once the peer is gone and nothing is left
+ * @warning Only one thread may receive from a channel at a time
+ */
+sat_status_t sat_channel_receive (sat_channel_t *const object, void *const buffer, uint32_t capacity, uint32_t *const size);
+
+/**
+ * @brief Get the descriptor that signals one end of the channel
+ * 
+ * The read end becomes readable when a message may be available and the write
+ * end (socket modes only) when there is room to send. Poll it and then call
+ * sat_channel_receive() until it returns a size of 0. In ring mode the read end
+ * is an eventfd that the reader consumes itself.
+ * 
+ * @param object Pointer to the opened channel structure
+ * @param end Which end of the channel
+ * @param[out] fd Pointer to store the descriptor
+ * @return Status structure indicating success or failure
+ * @note The descriptor is owned by the channel and closed by sat_channel_close()
+ */
+sat_status_t sat_channel_get_fd (const sat_channel_t *const object, sat_channel_end_t end, int *const fd);
+
+/**
+ * @brief Run the read end of a channel on a reactor
+ * 
+ * The handler is called on the reactor thread whenever the read end becomes
+ * readable, instead of a thread blocking in sat_channel_receive(). Open the
+ * channel with non_blocking set so the handler can drain it until
+ * sat_channel_receive() reports a size of 0.
+ * 
+ * @param object Pointer to the opened channel structure
+ * @param reactor Pointer to the opened reactor
+ * @param handler Function called when messages are available
+ * @param data Context pointer passed to the handler
+ * @return Status structure indicating success or failure
+ * @note sat_channel_close() detaches the channel
+ * @see sat_channel_detach()
+ */
+sat_status_t sat_channel_attach (sat_channel_t *const object, sat_reactor_t *const reactor, sat_channel_handler_t handler, void *const data);
+
+/**
+ * @brief Stop running a channel on its reactor
+ * 
+ * @param object Pointer to the attached channel structure
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_channel_detach (sat_channel_t *const object);
+
 /**
  * @brief Close a channel
  * 
@@ -1,8 +1,29 @@
 #include <sat_channel.h>
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
+
+#define SAT_CHANNEL_HEADER_SIZE     sizeof (uint32_t)
+#define SAT_CHANNEL_BACKOFF         50000   // ns a blocked ring writer sleeps before looking again
+
+static sat_status_t sat_channel_send_frames (sat_channel_t *const object, const sat_channel_message_t *const messages, uint32_t amount);
+static sat_status_t sat_channel_send_ring (sat_channel_t *const object, const sat_channel_message_t *const messages, uint32_t amount);
+static sat_status_t sat_channel_receive_frames (sat_channel_t *const object, void *const buffer, uint32_t capacity, uint32_t *const size);
+static sat_status_t sat_channel_receive_ring (sat_channel_t *const object, void *const buffer, uint32_t capacity, uint32_t *const size);
+static void sat_channel_ring_copy_in (sat_channel_t *const object, uint32_t position, const void *const data, uint32_t size);
+static void sat_channel_ring_copy_out (const sat_channel_t *const object, uint32_t position, void *const data, uint32_t size);
+static void sat_channel_ring_publish (sat_channel_t *const object, uint32_t start, uint32_t tail);
+static bool sat_channel_set_non_blocking (int fd);
+static void sat_channel_wait (int fd, short events);
+static void sat_channel_on_readable (int fd, uint32_t events, void *data);
 
 sat_status_t sat_channel_init (sat_channel_t *const object)
 {
@@ -16,8 +37,55 @@ sat_status_t sat_channel_init (sat_channel_t *const object)
 sat_status_t sat_channel_open (sat_channel_t *const object, const sat_channel_args_t *const args)
 {
     sat_status_return_on_null (object, "object is null");
-    sat_status_return_on_not_equals (socketpair (AF_LOCAL, SOCK_STREAM, 0, object->pair), 0, "socketpair failed");
-   
+
+    sat_channel_args_t _args = args == NULL ? (sat_channel_args_t) {0} : *args;
+
+    if (_args.mode != sat_channel_mode_ring)
+    {
+        sat_status_return_on_not_equals (socketpair (AF_LOCAL, SOCK_STREAM, 0, object->pair), 0, "socketpair failed");
+
+        if (_args.non_blocking == true && (sat_channel_set_non_blocking (object->pair [0]) == false ||
+                                           sat_channel_set_non_blocking (object->pair [1]) == false))
+        {
+            close (object->pair [0]);
+            close (object->pair [1]);
+
+            sat_status_return_on_failure ("non-blocking setup failed");
+        }
+    }
+
+    object->mode = _args.mode;
+    object->non_blocking = _args.non_blocking;
+
+    if (_args.mode == sat_channel_mode_stream)
+        sat_status_return_on_success ();
+
+    uint32_t size = _args.size == 0 ? SAT_CHANNEL_SIZE_DEFAULT : _args.size;
+
+    if (_args.mode == sat_channel_mode_ring)
+    {
+        // Free-running indices are masked into the ring.
+        sat_status_return_on_false ((size >= 2 * SAT_CHANNEL_HEADER_SIZE && (size & (size - 1)) == 0), "ring size is not a power of two");
+
+        object->event = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        sat_status_return_on_less_than (object->event, 0, "eventfd failed");
+    }
+
+    object->buffer = _args.buffer;
+    object->size = size;
+
+    if (object->buffer == NULL)
+    {
+        object->buffer = (uint8_t *) malloc (size);
+        object->owned = true;
+    }
+
+    if (object->buffer == NULL)
+    {
+        sat_channel_close (object);
+        sat_status_return_on_failure ("buffer allocation failed");
+    }
+
     sat_status_return_on_success ();
 }
 
@@ -26,6 +94,7 @@ sat_status_t sat_channel_write (sat_channel_t *const object, const uint8_t *cons
     sat_status_return_on_null (object, "object is null");
     sat_status_return_on_null (buffer, "buffer is null");
     sat_status_return_on_equals (size, 0, "size is zero");
+    sat_status_return_on_not_equals (object->mode, sat_channel_mode_stream, "channel is not in stream mode");
 
     sat_status_return_on_less_than (send (object->pair [0], buffer, size, 0), 0, "send failed");
 
@@ -37,20 +106,377 @@ sat_status_t sat_channel_read (sat_channel_t *const object, uint8_t *const buffe
     sat_status_return_on_null (object, "object is null");
     sat_status_return_on_null (buffer, "buffer is null");
     sat_status_return_on_equals (size, 0, "size is zero");
+    sat_status_return_on_not_equals (object->mode, sat_channel_mode_stream, "channel is not in stream mode");
 
     sat_status_return_on_less_than (recv (object->pair [1], buffer, size, 0), 0, "recv failed");
 
     sat_status_return_on_success ();
 }
 
+sat_status_t sat_channel_send (sat_channel_t *const object, const void *const data, uint32_t size)
+{
+    return sat_channel_send_many (object, &(sat_channel_message_t) {.data = data, .size = size}, 1);
+}
+
+sat_status_t sat_channel_send_many (sat_channel_t *const object, const sat_channel_message_t *const messages, uint32_t amount)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (messages, "messages is null");
+    sat_status_return_on_equals (amount, 0, "amount is zero");
+    sat_status_return_on_equals (object->mode, sat_channel_mode_stream, "channel is in stream mode");
+
+    // Checked up front so a batch is never cut short by a bad message.
+    for (uint32_t i = 0; i < amount; i++)
+    {
+        sat_status_return_on_null (messages [i].data, "data is null");
+        sat_status_return_on_equals (messages [i].size, 0, "size is zero");
+        sat_status_return_on_greater_than (messages [i].size, object->size - SAT_CHANNEL_HEADER_SIZE, "message too large");
+    }
+
+    if (object->mode == sat_channel_mode_ring)
+        return sat_channel_send_ring (object, messages, amount);
+
+    return sat_channel_send_frames (object, messages, amount);
+}
+
+sat_status_t sat_channel_receive (sat_channel_t *const object, void *const buffer, uint32_t capacity, uint32_t *const size)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (buffer, "buffer is null");
+    sat_status_return_on_null (size, "size is null");
+    sat_status_return_on_equals (object->mode, sat_channel_mode_stream, "channel is in stream mode");
+
+    *size = 0;
+
+    if (object->mode == sat_channel_mode_ring)
+        return sat_channel_receive_ring (object, buffer, capacity, size);
+
+    return sat_channel_receive_frames (object, buffer, capacity, size);
+}
+
+sat_status_t sat_channel_get_fd (const sat_channel_t *const object, sat_channel_end_t end, int *const fd)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (fd, "fd is null");
+
+    if (object->mode == sat_channel_mode_ring)
+    {
+        // The writer only waits for the reader to make room, never for the kernel.
+        sat_status_return_on_not_equals (end, sat_channel_end_read, "ring has no write descriptor");
+
+        *fd = object->event;
+    }
+
+    else
+        *fd = end == sat_channel_end_read ? object->pair [1] : object->pair [0];
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_channel_attach (sat_channel_t *const object, sat_reactor_t *const reactor, sat_channel_handler_t handler, void *const data)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (reactor, "reactor is null");
+    sat_status_return_on_null (handler, "handler is null");
+    sat_status_return_on_not_equals (object->reactor, NULL, "channel already attached");
+
+    int fd;
+
+    sat_status_return_on_error (sat_channel_get_fd (object, sat_channel_end_read, &fd));
+    sat_status_return_on_error (sat_reactor_add (reactor, fd, sat_reactor_event_read, sat_channel_on_readable, object));
+
+    object->reactor = reactor;
+    object->handler = handler;
+    object->data = data;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_channel_detach (sat_channel_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (object->reactor, "channel not attached");
+
+    int fd;
+
+    sat_channel_get_fd (object, sat_channel_end_read, &fd);
+    sat_reactor_remove (object->reactor, fd);
+
+    object->reactor = NULL;
+    object->handler = NULL;
+    object->data = NULL;
+
+    sat_status_return_on_success ();
+}
+
 sat_status_t sat_channel_close (sat_channel_t *const object)
 {
     sat_status_return_on_null (object, "object is null");
 
-    close (object->pair [0]);
-    close (object->pair [1]);
+    if (object->reactor != NULL)
+        sat_channel_detach (object);
+
+    if (object->mode == sat_channel_mode_ring)
+        close (object->event);
+
+    else
+    {
+        close (object->pair [0]);
+        close (object->pair [1]);
+    }
+
+    if (object->owned == true)
+        free (object->buffer);
 
     memset (object, 0, sizeof (sat_channel_t));
 
     sat_status_return_on_success ();
 }
+
+static sat_status_t sat_channel_send_frames (sat_channel_t *const object, const sat_channel_message_t *const messages, uint32_t amount)
+{
+    uint32_t headers [SAT_CHANNEL_BATCH];
+    struct iovec iov [2 * SAT_CHANNEL_BATCH];
+    bool committed = false;
+
+    for (uint32_t offset = 0; offset < amount; offset += SAT_CHANNEL_BATCH)
+    {
+        uint32_t batch = amount - offset < SAT_CHANNEL_BATCH ? amount - offset : SAT_CHANNEL_BATCH;
+
+        for (uint32_t i = 0; i < batch; i++)
+        {
+            headers [i] = messages [offset + i].size;
+
+            iov [2 * i] = (struct iovec) {.iov_base = &headers [i], .iov_len = SAT_CHANNEL_HEADER_SIZE};
+            iov [2 * i + 1] = (struct iovec) {.iov_base = (void *) messages [offset + i].data, .iov_len = messages [offset + i].size};
+        }
+
+        // sendmsg rather than writev for MSG_NOSIGNAL: a vanished reader is an error, not a signal.
+        struct msghdr message = {.msg_iov = iov, .msg_iovlen = 2 * batch};
+
+        while (message.msg_iovlen > 0)
+        {
+            ssize_t sent = sendmsg (object->pair [0], &message, MSG_NOSIGNAL);
+
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                sat_status_return_on_false ((errno == EAGAIN || errno == EWOULDBLOCK), "send failed");
+
+                // Nothing is out yet, so the batch can be refused whole.
+                sat_status_return_on_false (committed, "channel full");
+
+                sat_channel_wait (object->pair [0], POLLOUT);
+                continue;
+            }
+
+            committed = true;
+
+            while (sent > 0 && message.msg_iovlen > 0)
+            {
+                if ((size_t) sent >= message.msg_iov->iov_len)
+                {
+                    sent -= message.msg_iov->iov_len;
+                    message.msg_iov ++;
+                    message.msg_iovlen --;
+                }
+
+                else
+                {
+                    message.msg_iov->iov_base = (uint8_t *) message.msg_iov->iov_base + sent;
+                    message.msg_iov->iov_len -= sent;
+                    sent = 0;
+                }
+            }
+        }
+    }
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_channel_send_ring (sat_channel_t *const object, const sat_channel_message_t *const messages, uint32_t amount)
+{
+    uint32_t tail = __atomic_load_n (&object->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n (&object->head, __ATOMIC_ACQUIRE);
+    uint32_t start = tail;
+
+    if (object->non_blocking == true)
+    {
+        uint64_t total = 0;
+
+        for (uint32_t i = 0; i < amount; i++)
+            total += SAT_CHANNEL_HEADER_SIZE + messages [i].size;
+
+        sat_status_return_on_greater_than (total, object->size - (tail - head), "channel full");
+    }
+
+    for (uint32_t i = 0; i < amount; i++)
+    {
+        uint32_t need = SAT_CHANNEL_HEADER_SIZE + messages [i].size;
+
+        while (object->size - (tail - head) < need)
+        {
+            // Hand over what is written so far so the reader can make room.
+            sat_channel_ring_publish (object, start, tail);
+            start = tail;
+
+            nanosleep (&(struct timespec) {.tv_nsec = SAT_CHANNEL_BACKOFF}, NULL);
+            head = __atomic_load_n (&object->head, __ATOMIC_ACQUIRE);
+        }
+
+        sat_channel_ring_copy_in (object, tail, &messages [i].size, SAT_CHANNEL_HEADER_SIZE);
+        sat_channel_ring_copy_in (object, tail + SAT_CHANNEL_HEADER_SIZE, messages [i].data, messages [i].size);
+
+        tail += need;
+    }
+
+    sat_channel_ring_publish (object, start, tail);
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_channel_receive_frames (sat_channel_t *const object, void *const buffer, uint32_t capacity, uint32_t *const size)
+{
+    while (true)
+    {
+        uint32_t available = object->end - object->start;
+
+        if (available >= SAT_CHANNEL_HEADER_SIZE)
+        {
+            uint32_t length;
+            memcpy (&length, &object->buffer [object->start], SAT_CHANNEL_HEADER_SIZE);
+
+            sat_status_return_on_greater_than (length, object->size - SAT_CHANNEL_HEADER_SIZE, "message too large");
+
+            if (available >= SAT_CHANNEL_HEADER_SIZE + length)
+            {
+                sat_status_return_on_greater_than (length, capacity, "buffer too small");
+
+                memcpy (buffer, &object->buffer [object->start + SAT_CHANNEL_HEADER_SIZE], length);
+                object->start += SAT_CHANNEL_HEADER_SIZE + length;
+                *size = length;
+
+                sat_status_return_on_success ();
+            }
+        }
+
+        // Keep the partial frame and fill the rest of the buffer in one call.
+        if (object->start > 0)
+        {
+            memmove (object->buffer, &object->buffer [object->start], available);
+            object->start = 0;
+            object->end = available;
+        }
+
+        ssize_t received = recv (object->pair [1], &object->buffer [object->end], object->size - object->end, 0);
+
+        if (received > 0)
+            object->end += received;
+
+        else if (received == 0)
+            sat_status_return_on_failure ("channel closed");
+
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            sat_status_return_on_success ();
+
+        else if (errno != EINTR)
+            sat_status_return_on_failure ("recv failed");
+    }
+}
+
+static sat_status_t sat_channel_receive_ring (sat_channel_t *const object, void *const buffer, uint32_t capacity, uint32_t *const size)
+{
+    uint32_t head = __atomic_load_n (&object->head, __ATOMIC_RELAXED);
+
+    while (__atomic_load_n (&object->tail, __ATOMIC_SEQ_CST) == head)
+    {
+        uint64_t count;
+
+        // Drain the wakeup first so a message that lands in between signals again.
+        while (read (object->event, &count, sizeof (count)) < 0 && errno == EINTR)
+            ;
+
+        if (__atomic_load_n (&object->tail, __ATOMIC_SEQ_CST) != head)
+            break;
+
+        if (object->non_blocking == true)
+            sat_status_return_on_success ();
+
+        sat_channel_wait (object->event, POLLIN);
+    }
+
+    uint32_t length;
+    sat_channel_ring_copy_out (object, head, &length, SAT_CHANNEL_HEADER_SIZE);
+
+    sat_status_return_on_greater_than (length, capacity, "buffer too small");
+
+    sat_channel_ring_copy_out (object, head + SAT_CHANNEL_HEADER_SIZE, buffer, length);
+    *size = length;
+
+    // Sequentially consistent against the writer's check in sat_channel_ring_publish().
+    __atomic_store_n (&object->head, head + SAT_CHANNEL_HEADER_SIZE + length, __ATOMIC_SEQ_CST);
+
+    sat_status_return_on_success ();
+}
+
+static void sat_channel_ring_copy_in (sat_channel_t *const object, uint32_t position, const void *const data, uint32_t size)
+{
+    uint32_t offset = position & (object->size - 1);
+    uint32_t first = object->size - offset < size ? object->size - offset : size;
+
+    memcpy (&object->buffer [offset], data, first);
+    memcpy (object->buffer, (const uint8_t *) data + first, size - first);
+}
+
+static void sat_channel_ring_copy_out (const sat_channel_t *const object, uint32_t position, void *const data, uint32_t size)
+{
+    uint32_t offset = position & (object->size - 1);
+    uint32_t first = object->size - offset < size ? object->size - offset : size;
+
+    memcpy (data, &object->buffer [offset], first);
+    memcpy ((uint8_t *) data + first, object->buffer, size - first);
+}
+
+static void sat_channel_ring_publish (sat_channel_t *const object, uint32_t start, uint32_t tail)
+{
+    if (start == tail)
+        return;
+
+    __atomic_store_n (&object->tail, tail, __ATOMIC_SEQ_CST);
+
+    // Only a reader that had caught up may be asleep; one that is behind finds the data itself.
+    if (__atomic_load_n (&object->head, __ATOMIC_SEQ_CST) == start)
+    {
+        uint64_t one = 1;
+
+        while (write (object->event, &one, sizeof (one)) < 0 && errno == EINTR)
+            ;
+    }
+}
+
+static bool sat_channel_set_non_blocking (int fd)
+{
+    int flags = fcntl (fd, F_GETFL, 0);
+
+    return flags >= 0 && fcntl (fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static void sat_channel_wait (int fd, short events)
+{
+    struct pollfd pfd = {.fd = fd, .events = events};
+
+    while (poll (&pfd, 1, -1) < 0 && errno == EINTR)
+        ;
+}
+
+static void sat_channel_on_readable (int fd, uint32_t events, void *data)
+{
+    sat_channel_t *object = (sat_channel_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    object->handler (object, object->data);
+}
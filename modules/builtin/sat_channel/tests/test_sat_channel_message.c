@@ -0,0 +1,246 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <poll.h>
+#include <pthread.h>
+
+#define TEST_MESSAGES       20000
+
+static void test_open (sat_channel_t *const channel, const sat_channel_mode_t mode, const bool non_blocking, const uint32_t size)
+{
+    sat_status_t status = sat_channel_init (channel);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_channel_open (channel, &(sat_channel_args_t) {.mode = mode, .non_blocking = non_blocking, .size = size});
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_expect (sat_channel_t *const channel, const char *const expected)
+{
+    char buffer [64];
+    uint32_t size;
+
+    sat_status_t status = sat_channel_receive (channel, buffer, sizeof (buffer), &size);
+    assert (sat_status_get_result (&status) == true);
+    assert (size == strlen (expected));
+    assert (memcmp (buffer, expected, size) == 0);
+}
+
+static void test_framing (const sat_channel_mode_t mode)
+{
+    sat_channel_t channel;
+    char buffer [64];
+    uint32_t size;
+
+    test_open (&channel, mode, true, 0);
+
+    // Three writes that a stream would hand back as one.
+    sat_channel_send (&channel, "first", 5);
+    sat_channel_send (&channel, "second", 6);
+    sat_channel_send (&channel, "x", 1);
+
+    test_expect (&channel, "first");
+    test_expect (&channel, "second");
+    test_expect (&channel, "x");
+
+    sat_status_t status = sat_channel_receive (&channel, buffer, sizeof (buffer), &size);
+    assert (sat_status_get_result (&status) == true);
+    assert (size == 0);
+
+    // Too small a destination leaves the message where it is.
+    sat_channel_send (&channel, "does not fit", 12);
+
+    status = sat_channel_receive (&channel, buffer, 4, &size);
+    assert (sat_status_get_result (&status) == false);
+
+    test_expect (&channel, "does not fit");
+
+    status = sat_channel_send (&channel, buffer, 0);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_channel_write (&channel, (uint8_t *) buffer, 1);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_channel_close (&channel);
+}
+
+static void test_batch (const sat_channel_mode_t mode)
+{
+    sat_channel_t channel;
+    sat_channel_message_t messages [1000];
+    uint32_t values [1000];
+
+    test_open (&channel, mode, true, 0);
+
+    // More than one sendmsg worth of messages in a single call.
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        values [i] = i;
+        messages [i] = (sat_channel_message_t) {.data = &values [i], .size = sizeof (uint32_t)};
+    }
+
+    sat_status_t status = sat_channel_send_many (&channel, messages, 1000);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        uint32_t value;
+        uint32_t size;
+
+        status = sat_channel_receive (&channel, &value, sizeof (value), &size);
+        assert (sat_status_get_result (&status) == true);
+        assert (size == sizeof (uint32_t));
+        assert (value == i);
+    }
+
+    sat_channel_close (&channel);
+}
+
+static void test_full (void)
+{
+    sat_channel_t channel;
+    uint8_t payload [60] = {0};
+    uint32_t size;
+
+    test_open (&channel, sat_channel_mode_ring, true, 256);
+
+    // Four 64 byte records fill the ring; a batch that does not fit is refused whole.
+    sat_channel_message_t messages [5];
+
+    for (uint32_t i = 0; i < 5; i++)
+        messages [i] = (sat_channel_message_t) {.data = payload, .size = sizeof (payload)};
+
+    sat_status_t status = sat_channel_send_many (&channel, messages, 5);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_channel_send_many (&channel, messages, 4);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_channel_send (&channel, payload, 1);
+    assert (sat_status_get_result (&status) == false);
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        status = sat_channel_receive (&channel, payload, sizeof (payload), &size);
+        assert (sat_status_get_result (&status) == true);
+        assert (size == sizeof (payload));
+    }
+
+    // The free-running indices now wrap a record around the end of the ring.
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        status = sat_channel_send (&channel, "wrapping around", 15);
+        assert (sat_status_get_result (&status) == true);
+
+        test_expect (&channel, "wrapping around");
+    }
+
+    status = sat_channel_send (&channel, payload, 253);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_channel_close (&channel);
+
+    status = sat_channel_init (&channel);
+    status = sat_channel_open (&channel, &(sat_channel_args_t) {.mode = sat_channel_mode_ring, .size = 1000});
+    assert (sat_status_get_result (&status) == false);
+}
+
+static void test_poll (const sat_channel_mode_t mode)
+{
+    sat_channel_t channel;
+    int fd;
+
+    test_open (&channel, mode, true, 0);
+
+    sat_status_t status = sat_channel_get_fd (&channel, sat_channel_end_read, &fd);
+    assert (sat_status_get_result (&status) == true);
+
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    assert (poll (&pfd, 1, 0) == 0);
+
+    sat_channel_send (&channel, "ready", 5);
+    assert (poll (&pfd, 1, 1000) == 1);
+
+    test_expect (&channel, "ready");
+
+    // Draining to empty rearms the descriptor.
+    char buffer [8];
+    uint32_t size;
+
+    status = sat_channel_receive (&channel, buffer, sizeof (buffer), &size);
+    assert (sat_status_get_result (&status) == true);
+    assert (size == 0);
+    assert (poll (&pfd, 1, 0) == 0);
+
+    status = sat_channel_get_fd (&channel, sat_channel_end_write, &fd);
+    assert (sat_status_get_result (&status) == (mode != sat_channel_mode_ring));
+
+    sat_channel_close (&channel);
+}
+
+static void *test_producer (void *args)
+{
+    sat_channel_t *channel = (sat_channel_t *) args;
+    sat_channel_message_t messages [16];
+    uint8_t values [16][8] = {0};
+
+    for (uint32_t i = 0; i < TEST_MESSAGES; i += 16)
+    {
+        for (uint32_t j = 0; j < 16; j++)
+        {
+            uint32_t value = i + j;
+
+            memcpy (values [j], &value, sizeof (value));
+            messages [j] = (sat_channel_message_t) {.data = values [j], .size = sizeof (uint32_t) + j % 4};
+        }
+
+        sat_status_t status = sat_channel_send_many (channel, messages, 16);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    return NULL;
+}
+
+static void test_threads (const sat_channel_mode_t mode)
+{
+    sat_channel_t channel;
+    pthread_t producer;
+
+    // Small enough that the writer has to wait for the reader.
+    test_open (&channel, mode, false, 1024);
+
+    pthread_create (&producer, NULL, test_producer, &channel);
+
+    for (uint32_t i = 0; i < TEST_MESSAGES; i++)
+    {
+        uint8_t buffer [8] = {0};
+        uint32_t size;
+        uint32_t value;
+
+        sat_status_t status = sat_channel_receive (&channel, buffer, sizeof (buffer), &size);
+        assert (sat_status_get_result (&status) == true);
+        assert (size == sizeof (uint32_t) + i % 4);
+
+        memcpy (&value, buffer, sizeof (value));
+        assert (value == i);
+    }
+
+    pthread_join (producer, NULL);
+
+    sat_channel_close (&channel);
+}
+
+int main (int argc, char *argv[])
+{
+    test_framing (sat_channel_mode_message);
+    test_framing (sat_channel_mode_ring);
+    test_batch (sat_channel_mode_message);
+    test_batch (sat_channel_mode_ring);
+    test_full ();
+    test_poll (sat_channel_mode_message);
+    test_poll (sat_channel_mode_ring);
+    test_threads (sat_channel_mode_message);
+    test_threads (sat_channel_mode_ring);
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file sat_concurrent_map.h
+ * @brief Thread-safe hash map with lock striping
+ *
+ * The entries are split over a power of two number of shards, picked from the
+ * key hash. Each shard is an open addressing table guarded by its own
+ * reader-writer lock, so threads working on different keys rarely touch the
+ * same lock and lookups on the same shard proceed in parallel. No operation
+ * takes a lock over the whole map except sat_concurrent_map_snapshot(), which
+ * read-locks every shard for the time it takes to copy the entries.
+ *
+ * Keys and values are fixed size and copied in and out of the map, so no
+ * pointer into the map ever escapes a lock.
+ */
+
+#ifndef SAT_CONCURRENT_MAP_H_
+#define SAT_CONCURRENT_MAP_H_
+
+#include <sat_status.h>
+#include <sat_allocator.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Default number of shards
+ */
+#define SAT_CONCURRENT_MAP_SHARDS_DEFAULT   16
+
+/**
+ * @brief Largest number of shards
+ */
+#define SAT_CONCURRENT_MAP_SHARDS_MAX       (1u << 16)
+
+/**
+ * @brief Opaque structure representing a concurrent map
+ */
+typedef struct sat_concurrent_map_t sat_concurrent_map_t;
+
+/**
+ * @brief Opaque structure holding a copy of the map entries
+ */
+typedef struct sat_concurrent_map_snapshot_t sat_concurrent_map_snapshot_t;
+
+/**
+ * @brief Hash function type for map keys
+ *
+ * @param key Pointer to the key
+ * @param key_size Size of the key in bytes
+ * @return Hash of the key
+ */
+typedef uint32_t (*sat_concurrent_map_hash_t) (const void *const key, const uint32_t key_size);
+
+/**
+ * @brief Function type that produces the value of an absent key
+ *
+ * @param user User context given to sat_concurrent_map_compute_if_absent()
+ * @param key Pointer to the key
+ * @param value Buffer of value_size bytes to fill
+ * @return true to insert the value, false to leave the key absent
+ */
+typedef bool (*sat_concurrent_map_compute_t) (void *const user, const void *const key, void *const value);
+
+/**
+ * @brief Configuration structure for concurrent map creation
+ */
+typedef struct
+{
+    uint32_t key_size;                  /**< Size in bytes of each key */
+    uint32_t value_size;                /**< Size in bytes of each value */
+    uint32_t capacity;                  /**< Expected number of entries, the map grows past it */
+    uint32_t shards;                    /**< Number of shards, rounded up to a power of two, 0 selects SAT_CONCURRENT_MAP_SHARDS_DEFAULT, at most SAT_CONCURRENT_MAP_SHARDS_MAX */
+    sat_concurrent_map_hash_t hash;     /**< Optional key hash, defaults to FNV-1a over the key bytes */
+    sat_allocator_t allocator;          /**< Optional allocator for the map and its tables, zero selects the C library */
+} sat_concurrent_map_args_t;
+
+/**
+ * @brief Creates a new concurrent map
+ *
+ * @param[out] object Pointer to the pointer that will hold the created map
+ * @param[in] args Pointer to the configuration structure
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note The caller is responsible for calling sat_concurrent_map_destroy() to free resources
+ */
+sat_status_t sat_concurrent_map_create (sat_concurrent_map_t **const object, const sat_concurrent_map_args_t *const args);
+
+/**
+ * @brief Inserts a key or replaces its value
+ *
+ * @param[in,out] object Pointer to the map
+ * @param[in] key Pointer to the key
+ * @param[in] value Pointer to the value
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_concurrent_map_put (sat_concurrent_map_t *const object, const void *const key, const void *const value);
+
+/**
+ * @brief Copies the value of a key
+ *
+ * Only read-locks the key's shard.
+ *
+ * @param[in] object Pointer to the map
+ * @param[in] key Pointer to the key
+ * @param[out] value Buffer that receives a copy of the value
+ * @return sat_status_t indicating success, or failure if the key is absent
+ */
+sat_status_t sat_concurrent_map_get (sat_concurrent_map_t *const object, const void *const key, void *const value);
+
+/**
+ * @brief Removes a key
+ *
+ * @param[in,out] object Pointer to the map
+ * @param[in] key Pointer to the key
+ * @param[out] value Optional buffer that receives the removed value, may be NULL
+ * @return sat_status_t indicating success, or failure if the key is absent
+ */
+sat_status_t sat_concurrent_map_remove (sat_concurrent_map_t *const object, const void *const key, void *const value);
+
+/**
+ * @brief Gets the value of a key, inserting a computed one if it is absent
+ *
+ * When the key is present this is a read-locked lookup. Otherwise the shard is
+ * write-locked, the key is looked up again and @p compute is called at most
+ * once, so concurrent callers never compute the same key twice.
+ *
+ * @param[in,out] object Pointer to the map
+ * @param[in] key Pointer to the key
+ * @param[out] value Buffer that receives the existing or computed value
+ * @param[in] compute Function that produces the value
+ * @param[in] user User context passed to @p compute
+ * @return sat_status_t indicating success, or failure if @p compute failed
+ *
+ * @warning @p compute runs with the shard locked and must not use the map
+ */
+sat_status_t sat_concurrent_map_compute_if_absent (sat_concurrent_map_t *const object, const void *const key, void *const value, sat_concurrent_map_compute_t compute, void *const user);
+
+/**
+ * @brief Retrieves the number of entries
+ *
+ * @param[in] object Pointer to the map
+ * @param[out] size Pointer to store the number of entries
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note While other threads are writing the value is a snapshot
+ */
+sat_status_t sat_concurrent_map_get_size (sat_concurrent_map_t *const object, uint32_t *const size);
+
+/**
+ * @brief Copies every entry at a single point in time
+ *
+ * Every shard is read-locked while the entries are copied, so the snapshot
+ * never mixes states from before and after a concurrent write. Writers wait
+ * for the copy; readers do not.
+ *
+ * @param[in] object Pointer to the map
+ * @param[out] snapshot Pointer to the pointer that will hold the snapshot
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note The caller is responsible for calling sat_concurrent_map_snapshot_destroy()
+ */
+sat_status_t sat_concurrent_map_snapshot (sat_concurrent_map_t *const object, sat_concurrent_map_snapshot_t **const snapshot);
+
+/**
+ * @brief Retrieves the number of entries in a snapshot
+ *
+ * @param[in] snapshot Pointer to the snapshot
+ * @param[out] size Pointer to store the number of entries
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_concurrent_map_snapshot_get_size (const sat_concurrent_map_snapshot_t *const snapshot, uint32_t *const size);
+
+/**
+ * @brief Gets an entry of a snapshot
+ *
+ * @param[in] snapshot Pointer to the snapshot
+ * @param[in] index Entry index, lower than the snapshot size
+ * @param[out] key Pointer to store the address of the key
+ * @param[out] value Pointer to store the address of the value
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note The addresses stay valid until the snapshot is destroyed
+ */
+sat_status_t sat_concurrent_map_snapshot_get_entry (const sat_concurrent_map_snapshot_t *const snapshot, const uint32_t index, const void **const key, const void **const value);
+
+/**
+ * @brief Destroys a snapshot
+ *
+ * @param[in,out] snapshot Pointer to the snapshot
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_concurrent_map_snapshot_destroy (sat_concurrent_map_snapshot_t *const snapshot);
+
+/**
+ * @brief Destroys the map and frees all associated resources
+ *
+ * @param[in,out] object Pointer to the map
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @warning No thread may be using the map when it is destroyed
+ */
+sat_status_t sat_concurrent_map_destroy (sat_concurrent_map_t *const object);
+
+#endif/* SAT_CONCURRENT_MAP_H_ */
@@ -0,0 +1,517 @@
+#include <sat_concurrent_map.h>
+#include <sat_hash.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define SAT_CONCURRENT_MAP_CACHE_LINE_SIZE      64
+#define SAT_CONCURRENT_MAP_SHARD_CAPACITY_MIN   8
+
+#define SAT_CONCURRENT_MAP_SLOT_EMPTY           0
+#define SAT_CONCURRENT_MAP_SLOT_DELETED         1
+
+#define SAT_CONCURRENT_MAP_NONE                 UINT32_MAX
+
+// Each shard starts on its own cache line, so that locking one shard does not
+// invalidate the line holding its neighbour's lock.
+typedef struct
+{
+    pthread_rwlock_t lock;
+    uint8_t *slots;         // tag, key and value inline, tag 0 empty, 1 deleted
+    uint32_t capacity;      // power of two
+    uint32_t size;
+    uint32_t used;          // live and deleted slots
+} __attribute__ ((aligned (SAT_CONCURRENT_MAP_CACHE_LINE_SIZE))) sat_concurrent_map_shard_t;
+
+struct sat_concurrent_map_t
+{
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t key_offset;
+    uint32_t value_offset;
+    uint32_t stride;
+    uint32_t shard_count;
+    uint32_t shard_shift;
+    sat_concurrent_map_hash_t hash;
+    sat_allocator_t allocator;
+    sat_concurrent_map_shard_t *shards;
+    void *shards_memory;
+};
+
+struct sat_concurrent_map_snapshot_t
+{
+    uint32_t size;
+    uint32_t key_size;
+    uint32_t value_offset;
+    uint32_t stride;
+    uint8_t *entries;
+    sat_allocator_t allocator;
+};
+
+static uint32_t sat_concurrent_map_tag (const sat_concurrent_map_t *const object, const void *const key);
+static sat_concurrent_map_shard_t *sat_concurrent_map_shard_for (const sat_concurrent_map_t *const object, const uint32_t tag);
+static uint32_t sat_concurrent_map_find (const sat_concurrent_map_t *const object, const sat_concurrent_map_shard_t *const shard, const uint32_t tag, const void *const key);
+static sat_status_t sat_concurrent_map_insert (sat_concurrent_map_t *const object, sat_concurrent_map_shard_t *const shard, const uint32_t tag, const void *const key, const void *const value);
+static bool sat_concurrent_map_grow (sat_concurrent_map_t *const object, sat_concurrent_map_shard_t *const shard);
+static void sat_concurrent_map_release (sat_concurrent_map_t *const object, const uint32_t shards);
+
+static inline uint32_t sat_concurrent_map_align (const uint32_t size)
+{
+    return (size + 7u) & ~7u;
+}
+
+static inline uint8_t *sat_concurrent_map_slot (const sat_concurrent_map_t *const object, const uint8_t *const slots, const uint32_t index)
+{
+    return (uint8_t *) slots + (size_t) index * object->stride;
+}
+
+static inline uint32_t sat_concurrent_map_slot_tag (const uint8_t *const slot)
+{
+    return *(const uint32_t *) slot;
+}
+
+sat_status_t sat_concurrent_map_create (sat_concurrent_map_t **const object, const sat_concurrent_map_args_t *const args)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (args, "null args");
+    sat_status_return_on_equals (args->key_size, 0, "zero key size");
+    sat_status_return_on_equals (args->value_size, 0, "zero value size");
+    sat_status_return_on_greater_than (args->shards, SAT_CONCURRENT_MAP_SHARDS_MAX, "too many shards");
+
+    uint32_t shard_count = sat_hash_next_power_of_two (args->shards > 0 ? args->shards : SAT_CONCURRENT_MAP_SHARDS_DEFAULT);
+    sat_status_return_on_equals (shard_count, 0, "too many shards");
+
+    uint64_t expected = ((uint64_t) args->capacity + shard_count - 1) / shard_count;
+    uint64_t wanted = expected + expected / 3 + 1;
+    sat_status_return_on_greater_than (wanted, UINT32_MAX, "capacity too large");
+
+    uint32_t capacity = sat_hash_next_power_of_two ((uint32_t) wanted);
+    sat_status_return_on_equals (capacity, 0, "capacity too large");
+
+    if (capacity < SAT_CONCURRENT_MAP_SHARD_CAPACITY_MIN)
+        capacity = SAT_CONCURRENT_MAP_SHARD_CAPACITY_MIN;
+
+    sat_concurrent_map_t *__object = sat_allocator_allocate_zeroed (&args->allocator, sizeof (sat_concurrent_map_t));
+    sat_status_return_on_null (__object, "allocation failed");
+
+    __object->key_size = args->key_size;
+    __object->value_size = args->value_size;
+    __object->key_offset = sizeof (uint64_t);
+    __object->value_offset = __object->key_offset + sat_concurrent_map_align (args->key_size);
+    __object->stride = sat_concurrent_map_align (__object->value_offset + args->value_size);
+    __object->shard_count = shard_count;
+    __object->hash = args->hash != NULL ? args->hash : sat_hash_bytes;
+    __object->allocator = args->allocator;
+
+    // The shard comes from the top bits of the tag, the slot from the low ones.
+    __object->shard_shift = 32;
+    for (uint32_t count = __object->shard_count; count > 1; count >>= 1)
+        __object->shard_shift --;
+
+    size_t shards_size = (size_t) __object->shard_count * sizeof (sat_concurrent_map_shard_t) + SAT_CONCURRENT_MAP_CACHE_LINE_SIZE;
+
+    __object->shards_memory = sat_allocator_allocate_zeroed (&args->allocator, shards_size);
+    if (__object->shards_memory == NULL)
+    {
+        sat_allocator_release (&args->allocator, __object, sizeof (sat_concurrent_map_t));
+        sat_status_return_on_failure ("shard allocation failed");
+    }
+
+    uintptr_t base = ((uintptr_t) __object->shards_memory + SAT_CONCURRENT_MAP_CACHE_LINE_SIZE - 1) & ~((uintptr_t) SAT_CONCURRENT_MAP_CACHE_LINE_SIZE - 1);
+    __object->shards = (sat_concurrent_map_shard_t *) base;
+
+    pthread_rwlockattr_t attributes;
+    pthread_rwlockattr_init (&attributes);
+
+    // Readers are the common case; keep a steady stream of them from starving writers.
+    pthread_rwlockattr_setkind_np (&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+
+    for (uint32_t i = 0; i < __object->shard_count; i++)
+    {
+        sat_concurrent_map_shard_t *shard = &__object->shards [i];
+
+        shard->slots = sat_allocator_allocate_zeroed (&args->allocator, (size_t) capacity * __object->stride);
+        if (shard->slots == NULL)
+        {
+            pthread_rwlockattr_destroy (&attributes);
+            sat_concurrent_map_release (__object, i);
+            sat_status_return_on_failure ("table allocation failed");
+        }
+
+        shard->capacity = capacity;
+        pthread_rwlock_init (&shard->lock, &attributes);
+    }
+
+    pthread_rwlockattr_destroy (&attributes);
+
+    *object = __object;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_put (sat_concurrent_map_t *const object, const void *const key, const void *const value)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+    sat_status_return_on_null (value, "null value");
+
+    uint32_t tag = sat_concurrent_map_tag (object, key);
+    sat_concurrent_map_shard_t *shard = sat_concurrent_map_shard_for (object, tag);
+
+    pthread_rwlock_wrlock (&shard->lock);
+
+    sat_status_t status = sat_concurrent_map_insert (object, shard, tag, key, value);
+
+    pthread_rwlock_unlock (&shard->lock);
+
+    return status;
+}
+
+sat_status_t sat_concurrent_map_get (sat_concurrent_map_t *const object, const void *const key, void *const value)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+    sat_status_return_on_null (value, "null value");
+
+    uint32_t tag = sat_concurrent_map_tag (object, key);
+    sat_concurrent_map_shard_t *shard = sat_concurrent_map_shard_for (object, tag);
+
+    pthread_rwlock_rdlock (&shard->lock);
+
+    uint32_t index = sat_concurrent_map_find (object, shard, tag, key);
+
+    if (index != SAT_CONCURRENT_MAP_NONE)
+        memcpy (value, sat_concurrent_map_slot (object, shard->slots, index) + object->value_offset, object->value_size);
+
+    pthread_rwlock_unlock (&shard->lock);
+
+    sat_status_return_on_equals (index, SAT_CONCURRENT_MAP_NONE, "key not found");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_remove (sat_concurrent_map_t *const object, const void *const key, void *const value)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+
+    uint32_t tag = sat_concurrent_map_tag (object, key);
+    sat_concurrent_map_shard_t *shard = sat_concurrent_map_shard_for (object, tag);
+
+    pthread_rwlock_wrlock (&shard->lock);
+
+    uint32_t index = sat_concurrent_map_find (object, shard, tag, key);
+
+    if (index != SAT_CONCURRENT_MAP_NONE)
+    {
+        uint8_t *slot = sat_concurrent_map_slot (object, shard->slots, index);
+
+        if (value != NULL)
+            memcpy (value, slot + object->value_offset, object->value_size);
+
+        *(uint32_t *) slot = SAT_CONCURRENT_MAP_SLOT_DELETED;
+        shard->size --;
+    }
+
+    pthread_rwlock_unlock (&shard->lock);
+
+    sat_status_return_on_equals (index, SAT_CONCURRENT_MAP_NONE, "key not found");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_compute_if_absent (sat_concurrent_map_t *const object, const void *const key, void *const value, sat_concurrent_map_compute_t compute, void *const user)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (key, "null key");
+    sat_status_return_on_null (value, "null value");
+    sat_status_return_on_null (compute, "null compute");
+
+    sat_status_t status = sat_concurrent_map_get (object, key, value);
+    if (sat_status_get_result (&status) == true)
+        return status;
+
+    uint32_t tag = sat_concurrent_map_tag (object, key);
+    sat_concurrent_map_shard_t *shard = sat_concurrent_map_shard_for (object, tag);
+
+    pthread_rwlock_wrlock (&shard->lock);
+
+    // Another writer may have inserted the key between the two locks.
+    uint32_t index = sat_concurrent_map_find (object, shard, tag, key);
+
+    if (index != SAT_CONCURRENT_MAP_NONE)
+    {
+        memcpy (value, sat_concurrent_map_slot (object, shard->slots, index) + object->value_offset, object->value_size);
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    else if (compute (user, key, value) == true)
+        status = sat_concurrent_map_insert (object, shard, tag, key, value);
+
+    else
+        sat_status_set (&status, false, __func__, "compute failed");
+
+    pthread_rwlock_unlock (&shard->lock);
+
+    return status;
+}
+
+sat_status_t sat_concurrent_map_get_size (sat_concurrent_map_t *const object, uint32_t *const size)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (size, "null size");
+
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < object->shard_count; i++)
+    {
+        sat_concurrent_map_shard_t *shard = &object->shards [i];
+
+        pthread_rwlock_rdlock (&shard->lock);
+        total += shard->size;
+        pthread_rwlock_unlock (&shard->lock);
+    }
+
+    *size = total;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_snapshot (sat_concurrent_map_t *const object, sat_concurrent_map_snapshot_t **const snapshot)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (snapshot, "null snapshot");
+
+    sat_concurrent_map_snapshot_t *__snapshot = sat_allocator_allocate_zeroed (&object->allocator, sizeof (sat_concurrent_map_snapshot_t));
+    sat_status_return_on_null (__snapshot, "allocation failed");
+
+    __snapshot->key_size = object->key_size;
+    __snapshot->value_offset = object->value_offset - object->key_offset;
+    __snapshot->stride = object->stride - object->key_offset;
+    __snapshot->allocator = object->allocator;
+
+    // Shards are always locked in index order, so two snapshots cannot deadlock.
+    for (uint32_t i = 0; i < object->shard_count; i++)
+    {
+        pthread_rwlock_rdlock (&object->shards [i].lock);
+        __snapshot->size += object->shards [i].size;
+    }
+
+    if (__snapshot->size > 0)
+        __snapshot->entries = sat_allocator_allocate (&object->allocator, (size_t) __snapshot->size * __snapshot->stride);
+
+    if (__snapshot->entries != NULL)
+    {
+        uint8_t *entry = __snapshot->entries;
+
+        for (uint32_t i = 0; i < object->shard_count; i++)
+        {
+            sat_concurrent_map_shard_t *shard = &object->shards [i];
+
+            for (uint32_t j = 0; j < shard->capacity; j++)
+            {
+                uint8_t *slot = sat_concurrent_map_slot (object, shard->slots, j);
+
+                if (sat_concurrent_map_slot_tag (slot) > SAT_CONCURRENT_MAP_SLOT_DELETED)
+                {
+                    memcpy (entry, slot + object->key_offset, __snapshot->stride);
+                    entry += __snapshot->stride;
+                }
+            }
+        }
+    }
+
+    for (uint32_t i = object->shard_count; i > 0; i--)
+        pthread_rwlock_unlock (&object->shards [i - 1].lock);
+
+    if (__snapshot->size > 0 && __snapshot->entries == NULL)
+    {
+        sat_allocator_release (&object->allocator, __snapshot, sizeof (sat_concurrent_map_snapshot_t));
+        sat_status_return_on_failure ("snapshot allocation failed");
+    }
+
+    *snapshot = __snapshot;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_snapshot_get_size (const sat_concurrent_map_snapshot_t *const snapshot, uint32_t *const size)
+{
+    sat_status_return_on_null (snapshot, "null snapshot");
+    sat_status_return_on_null (size, "null size");
+
+    *size = snapshot->size;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_snapshot_get_entry (const sat_concurrent_map_snapshot_t *const snapshot, const uint32_t index, const void **const key, const void **const value)
+{
+    sat_status_return_on_null (snapshot, "null snapshot");
+    sat_status_return_on_null (key, "null key");
+    sat_status_return_on_null (value, "null value");
+    sat_status_return_on_greater_than_or_equal (index, snapshot->size, "index out of range");
+
+    const uint8_t *entry = snapshot->entries + (size_t) index * snapshot->stride;
+
+    *key = entry;
+    *value = entry + snapshot->value_offset;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_snapshot_destroy (sat_concurrent_map_snapshot_t *const snapshot)
+{
+    sat_status_return_on_null (snapshot, "null snapshot");
+
+    sat_allocator_t allocator = snapshot->allocator;
+
+    sat_allocator_release (&allocator, snapshot->entries, (size_t) snapshot->size * snapshot->stride);
+    sat_allocator_release (&allocator, snapshot, sizeof (sat_concurrent_map_snapshot_t));
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_concurrent_map_destroy (sat_concurrent_map_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    sat_concurrent_map_release (object, object->shard_count);
+
+    sat_status_return_on_success ();
+}
+
+static uint32_t sat_concurrent_map_tag (const sat_concurrent_map_t *const object, const void *const key)
+{
+    // The shard comes from the high bits, the slot from the low ones.
+    uint32_t hash = sat_hash_mix (object->hash (key, object->key_size));
+
+    return hash > SAT_CONCURRENT_MAP_SLOT_DELETED ? hash : hash + 2;
+}
+
+static sat_concurrent_map_shard_t *sat_concurrent_map_shard_for (const sat_concurrent_map_t *const object, const uint32_t tag)
+{
+    uint32_t index = object->shard_shift < 32 ? tag >> object->shard_shift : 0;
+
+    return &object->shards [index];
+}
+
+static uint32_t sat_concurrent_map_find (const sat_concurrent_map_t *const object, const sat_concurrent_map_shard_t *const shard, const uint32_t tag, const void *const key)
+{
+    uint32_t mask = shard->capacity - 1;
+
+    for (uint32_t index = tag & mask, probes = 0; probes < shard->capacity; index = (index + 1) & mask, probes++)
+    {
+        uint8_t *slot = sat_concurrent_map_slot (object, shard->slots, index);
+        uint32_t current = sat_concurrent_map_slot_tag (slot);
+
+        if (current == SAT_CONCURRENT_MAP_SLOT_EMPTY)
+            break;
+
+        if (current == tag && memcmp (slot + object->key_offset, key, object->key_size) == 0)
+            return index;
+    }
+
+    return SAT_CONCURRENT_MAP_NONE;
+}
+
+static sat_status_t sat_concurrent_map_insert (sat_concurrent_map_t *const object, sat_concurrent_map_shard_t *const shard, const uint32_t tag, const void *const key, const void *const value)
+{
+    uint32_t index = sat_concurrent_map_find (object, shard, tag, key);
+
+    if (index != SAT_CONCURRENT_MAP_NONE)
+    {
+        memcpy (sat_concurrent_map_slot (object, shard->slots, index) + object->value_offset, value, object->value_size);
+        sat_status_return_on_success ();
+    }
+
+    // Keep at most three quarters of the slots in use, counting tombstones.
+    if (((uint64_t) shard->used + 1) * 4 > (uint64_t) shard->capacity * 3)
+        sat_status_return_on_false (sat_concurrent_map_grow (object, shard), "table too large or allocation failed");
+
+    uint32_t mask = shard->capacity - 1;
+    uint8_t *slot = NULL;
+
+    for (index = tag & mask; ; index = (index + 1) & mask)
+    {
+        slot = sat_concurrent_map_slot (object, shard->slots, index);
+
+        if (sat_concurrent_map_slot_tag (slot) <= SAT_CONCURRENT_MAP_SLOT_DELETED)
+            break;
+    }
+
+    if (sat_concurrent_map_slot_tag (slot) == SAT_CONCURRENT_MAP_SLOT_EMPTY)
+        shard->used ++;
+
+    *(uint32_t *) slot = tag;
+    memcpy (slot + object->key_offset, key, object->key_size);
+    memcpy (slot + object->value_offset, value, object->value_size);
+
+    shard->size ++;
+
+    sat_status_return_on_success ();
+}
+
+static bool sat_concurrent_map_grow (sat_concurrent_map_t *const object, sat_concurrent_map_shard_t *const shard)
+{
+    // Rebuilding also drops the tombstones, so a churned table may keep its size.
+    uint64_t wanted = ((uint64_t) shard->size + 1) * 2;
+
+    // Past 2^31 slots the table can no longer be addressed with 32 bits.
+    if (wanted > UINT32_MAX)
+        return false;
+
+    uint32_t capacity = sat_hash_next_power_of_two ((uint32_t) wanted);
+
+    if (capacity == 0)
+        return false;
+
+    if (capacity < shard->capacity)
+        capacity = shard->capacity;
+
+    uint8_t *slots = sat_allocator_allocate_zeroed (&object->allocator, (size_t) capacity * object->stride);
+    if (slots == NULL)
+        return false;
+
+    uint32_t mask = capacity - 1;
+
+    for (uint32_t i = 0; i < shard->capacity; i++)
+    {
+        uint8_t *slot = sat_concurrent_map_slot (object, shard->slots, i);
+        uint32_t tag = sat_concurrent_map_slot_tag (slot);
+
+        if (tag <= SAT_CONCURRENT_MAP_SLOT_DELETED)
+            continue;
+
+        uint32_t index = tag & mask;
+
+        while (sat_concurrent_map_slot_tag (sat_concurrent_map_slot (object, slots, index)) != SAT_CONCURRENT_MAP_SLOT_EMPTY)
+            index = (index + 1) & mask;
+
+        memcpy (sat_concurrent_map_slot (object, slots, index), slot, object->stride);
+    }
+
+    sat_allocator_release (&object->allocator, shard->slots, (size_t) shard->capacity * object->stride);
+
+    shard->slots = slots;
+    shard->capacity = capacity;
+    shard->used = shard->size;
+
+    return true;
+}
+
+static void sat_concurrent_map_release (sat_concurrent_map_t *const object, const uint32_t shards)
+{
+    sat_allocator_t allocator = object->allocator;
+
+    for (uint32_t i = 0; i < shards; i++)
+    {
+        sat_concurrent_map_shard_t *shard = &object->shards [i];
+
+        pthread_rwlock_destroy (&shard->lock);
+        sat_allocator_release (&allocator, shard->slots, (size_t) shard->capacity * object->stride);
+    }
+
+    sat_allocator_release (&allocator, object->shards_memory, (size_t) object->shard_count * sizeof (sat_concurrent_map_shard_t) + SAT_CONCURRENT_MAP_CACHE_LINE_SIZE);
+    sat_allocator_release (&allocator, object, sizeof (sat_concurrent_map_t));
+}
@@ -0,0 +1,208 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+/*
+ * Scaling benchmark: threads run a read-mostly mix of lookups and updates on
+ * a shared key space, once on sat_concurrent_map and once on a hashed sat_map
+ * behind a single mutex, for 1 up to N threads.
+ *
+ * usage: sat_concurrent_map_benchmark [operations per thread] [max threads] [read percent]
+ */
+
+#define BENCHMARK_OPERATIONS_DEFAULT    1000000
+#define BENCHMARK_THREADS_DEFAULT       8
+#define BENCHMARK_THREADS_MAX           64
+#define BENCHMARK_READ_PERCENT_DEFAULT  90
+#define BENCHMARK_KEYS                  65536
+
+typedef struct
+{
+    sat_map_t *map;
+    pthread_mutex_t mutex;
+} locked_map_t;
+
+typedef struct
+{
+    sat_concurrent_map_t *concurrent;
+    locked_map_t *locked;
+    uint64_t operations;
+    uint32_t read_percent;
+    uint64_t seed;
+    uint64_t found;
+} benchmark_context_t;
+
+static double benchmark_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static uint64_t benchmark_random (uint64_t *const state)
+{
+    uint64_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+
+    return *state = x;
+}
+
+static uint32_t benchmark_hash (const void *const key, const uint32_t key_size)
+{
+    (void) key_size;
+    return *(const uint32_t *) key;
+}
+
+static bool benchmark_compare (void *key, void *data)
+{
+    return *(uint32_t *) key == *(uint32_t *) data;
+}
+
+static void *concurrent_worker (void *args)
+{
+    benchmark_context_t *context = (benchmark_context_t *) args;
+
+    for (uint64_t i = 0; i < context->operations; i++)
+    {
+        uint64_t random = benchmark_random (&context->seed);
+        uint32_t key = (uint32_t) (random % BENCHMARK_KEYS);
+        uint64_t value = random;
+
+        if ((random >> 32) % 100 < context->read_percent)
+        {
+            sat_status_t status = sat_concurrent_map_get (context->concurrent, &key, &value);
+            context->found += sat_status_get_result (&status) == true;
+        }
+        else
+            sat_concurrent_map_put (context->concurrent, &key, &value);
+    }
+
+    return NULL;
+}
+
+static void *locked_worker (void *args)
+{
+    benchmark_context_t *context = (benchmark_context_t *) args;
+    locked_map_t *locked = context->locked;
+
+    for (uint64_t i = 0; i < context->operations; i++)
+    {
+        uint64_t random = benchmark_random (&context->seed);
+        uint32_t key = (uint32_t) (random % BENCHMARK_KEYS);
+        uint64_t value = random;
+
+        pthread_mutex_lock (&locked->mutex);
+
+        if ((random >> 32) % 100 < context->read_percent)
+        {
+            sat_status_t status = sat_map_get_value_by (locked->map, &key, &value, benchmark_compare);
+            context->found += sat_status_get_result (&status) == true;
+        }
+        else
+        {
+            // sat_map has no replace: remove then add.
+            sat_map_remove (locked->map, &key, benchmark_compare);
+            sat_map_add (locked->map, &key, &value);
+        }
+
+        pthread_mutex_unlock (&locked->mutex);
+    }
+
+    return NULL;
+}
+
+static double benchmark_run (void *(*worker) (void *), benchmark_context_t *base, uint32_t threads)
+{
+    pthread_t thread [BENCHMARK_THREADS_MAX];
+    benchmark_context_t context [BENCHMARK_THREADS_MAX];
+
+    double start = benchmark_now ();
+
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        context [i] = *base;
+        context [i].seed = 0x9E3779B97F4A7C15ull * (i + 1);
+        pthread_create (&thread [i], NULL, worker, &context [i]);
+    }
+
+    for (uint32_t i = 0; i < threads; i++)
+        pthread_join (thread [i], NULL);
+
+    double elapsed = benchmark_now () - start;
+
+    return (double) base->operations * threads / elapsed / 1e6;
+}
+
+int main (int argc, char *argv[])
+{
+    uint64_t operations = argc > 1 ? strtoull (argv [1], NULL, 10) : BENCHMARK_OPERATIONS_DEFAULT;
+    uint32_t max_threads = argc > 2 ? (uint32_t) strtoul (argv [2], NULL, 10) : BENCHMARK_THREADS_DEFAULT;
+    uint32_t read_percent = argc > 3 ? (uint32_t) strtoul (argv [3], NULL, 10) : BENCHMARK_READ_PERCENT_DEFAULT;
+
+    if (max_threads == 0 || max_threads > BENCHMARK_THREADS_MAX)
+        max_threads = BENCHMARK_THREADS_DEFAULT;
+
+    sat_concurrent_map_t *concurrent;
+    sat_status_t status = sat_concurrent_map_create (&concurrent, &(sat_concurrent_map_args_t)
+                                                                  {
+                                                                      .key_size = sizeof (uint32_t),
+                                                                      .value_size = sizeof (uint64_t),
+                                                                      .capacity = BENCHMARK_KEYS,
+                                                                      .hash = benchmark_hash,
+                                                                  });
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    locked_map_t locked;
+    pthread_mutex_init (&locked.mutex, NULL);
+
+    status = sat_map_create (&locked.map, &(sat_map_args_t)
+                                          {
+                                              .key_size = sizeof (uint32_t),
+                                              .value_size = sizeof (uint64_t),
+                                              .list_size = BENCHMARK_KEYS,
+                                              .mode = sat_map_mode_dynamic,
+                                              .hash = benchmark_hash,
+                                          });
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    for (uint32_t key = 0; key < BENCHMARK_KEYS; key++)
+    {
+        uint64_t value = key;
+
+        sat_concurrent_map_put (concurrent, &key, &value);
+        sat_map_add (locked.map, &key, &value);
+    }
+
+    benchmark_context_t base =
+    {
+        .concurrent = concurrent,
+        .locked = &locked,
+        .operations = operations,
+        .read_percent = read_percent,
+    };
+
+    printf ("%u%% reads, %lu operations per thread, %u keys\n", read_percent, (unsigned long) operations, BENCHMARK_KEYS);
+    printf ("%-8s %20s %20s\n", "threads", "concurrent Mops/s", "mutex+map Mops/s");
+
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double sharded = benchmark_run (concurrent_worker, &base, threads);
+        double single = benchmark_run (locked_worker, &base, threads);
+
+        printf ("%-8u %20.2f %20.2f\n", threads, sharded, single);
+    }
+
+    sat_map_destroy (locked.map);
+    pthread_mutex_destroy (&locked.mutex);
+    sat_concurrent_map_destroy (concurrent);
+
+    return 0;
+}
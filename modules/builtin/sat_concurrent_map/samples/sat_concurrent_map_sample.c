@@ -0,0 +1,60 @@
+#include <sat.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+    char address [16];
+    char port [8];
+} node_t;
+
+int main (int argc, char *argv[])
+{
+    sat_concurrent_map_t *nodes;
+
+    sat_status_t status = sat_concurrent_map_create (&nodes, &(sat_concurrent_map_args_t)
+                                                             {
+                                                                 .key_size = 32,
+                                                                 .value_size = sizeof (node_t),
+                                                                 .capacity = 64,
+                                                             });
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    // Keys are fixed size, so pad names into a zeroed buffer.
+    char name [32] = {0};
+    node_t node = {.address = "192.168.0.10", .port = "8080"};
+
+    strncpy (name, "billing", sizeof (name) - 1);
+    sat_concurrent_map_put (nodes, name, &node);
+
+    memset (name, 0, sizeof (name));
+    strncpy (name, "inventory", sizeof (name) - 1);
+    strncpy (node.address, "192.168.0.11", sizeof (node.address) - 1);
+    sat_concurrent_map_put (nodes, name, &node);
+
+    node_t found;
+    status = sat_concurrent_map_get (nodes, name, &found);
+    if (sat_status_get_result (&status) == true)
+        printf ("%s is at %s:%s\n", name, found.address, found.port);
+
+    sat_concurrent_map_snapshot_t *snapshot;
+    sat_concurrent_map_snapshot (nodes, &snapshot);
+
+    uint32_t size = 0;
+    sat_concurrent_map_snapshot_get_size (snapshot, &size);
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        const void *key;
+        const void *value;
+
+        sat_concurrent_map_snapshot_get_entry (snapshot, i, &key, &value);
+        printf ("registered: %s -> %s\n", (const char *) key, ((const node_t *) value)->address);
+    }
+
+    sat_concurrent_map_snapshot_destroy (snapshot);
+    sat_concurrent_map_destroy (nodes);
+
+    return 0;
+}
@@ -0,0 +1,290 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+typedef struct
+{
+    char address [16];
+    uint16_t port;
+} endpoint_t;
+
+typedef struct
+{
+    sat_concurrent_map_t *map;
+    uint32_t first;
+    uint32_t amount;
+    uint32_t *computed;
+} worker_context_t;
+
+static bool compute_endpoint (void *const user, const void *const key, void *const value)
+{
+    uint32_t id = *(const uint32_t *) key;
+    endpoint_t *endpoint = (endpoint_t *) value;
+
+    if (user != NULL)
+        __atomic_add_fetch ((uint32_t *) user, 1, __ATOMIC_RELAXED);
+
+    if (id == 0)
+        return false;
+
+    snprintf (endpoint->address, sizeof (endpoint->address), "10.0.0.%u", id % 256);
+    endpoint->port = (uint16_t) (8000 + id % 1000);
+
+    return true;
+}
+
+static sat_concurrent_map_t *create_map (uint32_t capacity, uint32_t shards)
+{
+    sat_concurrent_map_t *map = NULL;
+
+    sat_status_t status = sat_concurrent_map_create (&map, &(sat_concurrent_map_args_t)
+                                                           {
+                                                               .key_size = sizeof (uint32_t),
+                                                               .value_size = sizeof (endpoint_t),
+                                                               .capacity = capacity,
+                                                               .shards = shards,
+                                                           });
+    assert (sat_status_get_result (&status) == true);
+
+    return map;
+}
+
+static void test_basic (void)
+{
+    sat_concurrent_map_t *map = create_map (4, 2);
+    endpoint_t endpoint;
+    sat_status_t status;
+
+    // Far more entries than the expected capacity: the shards grow.
+    for (uint32_t id = 1; id <= 5000; id++)
+    {
+        compute_endpoint (NULL, &id, &endpoint);
+
+        status = sat_concurrent_map_put (map, &id, &endpoint);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    uint32_t size = 0;
+    sat_concurrent_map_get_size (map, &size);
+    assert (size == 5000);
+
+    uint32_t id = 4242;
+    status = sat_concurrent_map_get (map, &id, &endpoint);
+    assert (sat_status_get_result (&status) == true);
+    assert (strcmp (endpoint.address, "10.0.0.146") == 0 && endpoint.port == 8242);
+
+    endpoint.port = 1;
+    sat_concurrent_map_put (map, &id, &endpoint);
+    sat_concurrent_map_get (map, &id, &endpoint);
+    assert (endpoint.port == 1);
+
+    for (id = 1; id <= 5000; id += 2)
+    {
+        status = sat_concurrent_map_remove (map, &id, id == 1 ? &endpoint : NULL);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    assert (endpoint.port == 8001);
+
+    status = sat_concurrent_map_remove (map, &(uint32_t) {1}, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_concurrent_map_get (map, &(uint32_t) {3}, &endpoint);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_concurrent_map_get_size (map, &size);
+    assert (size == 2500);
+
+    // Reinserting over tombstones keeps every remaining key reachable.
+    for (id = 1; id <= 5000; id += 2)
+    {
+        compute_endpoint (NULL, &id, &endpoint);
+        sat_concurrent_map_put (map, &id, &endpoint);
+    }
+
+    for (id = 1; id <= 5000; id++)
+    {
+        status = sat_concurrent_map_get (map, &id, &endpoint);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    sat_concurrent_map_destroy (map);
+}
+
+static void test_compute_if_absent (void)
+{
+    sat_concurrent_map_t *map = create_map (16, 0);
+    uint32_t computed = 0;
+    endpoint_t endpoint;
+    sat_status_t status;
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (uint32_t id = 1; id <= 8; id++)
+        {
+            status = sat_concurrent_map_compute_if_absent (map, &id, &endpoint, compute_endpoint, &computed);
+            assert (sat_status_get_result (&status) == true);
+            assert (endpoint.port == 8000 + id);
+        }
+    }
+
+    assert (computed == 8);
+
+    uint32_t id = 0;
+    status = sat_concurrent_map_compute_if_absent (map, &id, &endpoint, compute_endpoint, &computed);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_concurrent_map_get (map, &id, &endpoint);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_concurrent_map_destroy (map);
+}
+
+static void test_snapshot (void)
+{
+    sat_concurrent_map_t *map = create_map (64, 4);
+    sat_concurrent_map_snapshot_t *snapshot;
+    endpoint_t endpoint;
+
+    sat_status_t status = sat_concurrent_map_snapshot (map, &snapshot);
+    assert (sat_status_get_result (&status) == true);
+
+    uint32_t size = 1;
+    sat_concurrent_map_snapshot_get_size (snapshot, &size);
+    assert (size == 0);
+    sat_concurrent_map_snapshot_destroy (snapshot);
+
+    for (uint32_t id = 1; id <= 100; id++)
+    {
+        compute_endpoint (NULL, &id, &endpoint);
+        sat_concurrent_map_put (map, &id, &endpoint);
+    }
+
+    status = sat_concurrent_map_snapshot (map, &snapshot);
+    assert (sat_status_get_result (&status) == true);
+
+    // Changes after the snapshot do not show up in it.
+    for (uint32_t id = 1; id <= 100; id++)
+        sat_concurrent_map_remove (map, &id, NULL);
+
+    sat_concurrent_map_snapshot_get_size (snapshot, &size);
+    assert (size == 100);
+
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        const void *key;
+        const void *value;
+
+        status = sat_concurrent_map_snapshot_get_entry (snapshot, i, &key, &value);
+        assert (sat_status_get_result (&status) == true);
+
+        uint32_t id = *(const uint32_t *) key;
+        assert (((const endpoint_t *) value)->port == 8000 + id);
+
+        sum += id;
+    }
+
+    assert (sum == 100 * 101 / 2);
+
+    const void *key;
+    const void *value;
+    status = sat_concurrent_map_snapshot_get_entry (snapshot, size, &key, &value);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_concurrent_map_snapshot_destroy (snapshot);
+    sat_concurrent_map_destroy (map);
+}
+
+static void *worker (void *argument)
+{
+    worker_context_t *context = (worker_context_t *) argument;
+    endpoint_t endpoint;
+
+    for (uint32_t round = 0; round < 20; round++)
+    {
+        for (uint32_t id = context->first; id < context->first + context->amount; id++)
+        {
+            compute_endpoint (NULL, &id, &endpoint);
+            sat_concurrent_map_put (context->map, &id, &endpoint);
+        }
+
+        // Every thread also reads a key range shared with all the others.
+        for (uint32_t id = 1; id <= 64; id++)
+        {
+            sat_status_t status = sat_concurrent_map_compute_if_absent (context->map, &id, &endpoint, compute_endpoint, context->computed);
+            assert (sat_status_get_result (&status) == true);
+            assert (endpoint.port == 8000 + id % 1000);
+        }
+
+        for (uint32_t id = context->first; id < context->first + context->amount; id += 2)
+            sat_concurrent_map_remove (context->map, &id, NULL);
+    }
+
+    return NULL;
+}
+
+static void test_threads (void)
+{
+    enum { threads = 4 };
+
+    sat_concurrent_map_t *map = create_map (256, 8);
+    pthread_t thread [threads];
+    worker_context_t context [threads];
+    uint32_t computed = 0;
+
+    for (uint32_t i = 0; i < threads; i++)
+    {
+        context [i] = (worker_context_t) {.map = map, .first = 1000 + i * 1000, .amount = 500, .computed = &computed};
+        pthread_create (&thread [i], NULL, worker, &context [i]);
+    }
+
+    for (uint32_t i = 0; i < threads; i++)
+        pthread_join (thread [i], NULL);
+
+    // The shared keys were computed exactly once between all threads.
+    assert (computed == 64);
+
+    uint32_t size = 0;
+    sat_concurrent_map_get_size (map, &size);
+    assert (size == 64 + threads * 250);
+
+    sat_concurrent_map_destroy (map);
+}
+
+static void test_too_large (void)
+{
+    sat_concurrent_map_t *map = NULL;
+    sat_concurrent_map_args_t args =
+    {
+        .key_size = sizeof (uint32_t),
+        .value_size = sizeof (endpoint_t),
+        .shards = 0x80000001u,
+    };
+
+    // Rounding such sizes up used to hang instead of failing.
+    sat_status_t status = sat_concurrent_map_create (&map, &args);
+    assert (sat_status_get_result (&status) == false);
+
+    args.shards = SAT_CONCURRENT_MAP_SHARDS_MAX + 1;
+    status = sat_concurrent_map_create (&map, &args);
+    assert (sat_status_get_result (&status) == false);
+
+    args.shards = 1;
+    args.capacity = UINT32_MAX;
+    status = sat_concurrent_map_create (&map, &args);
+    assert (sat_status_get_result (&status) == false);
+}
+
+int main (int argc, char *argv[])
+{
+    test_basic ();
+    test_compute_if_absent ();
+    test_snapshot ();
+    test_threads ();
+    test_too_large ();
+
+    return 0;
+}
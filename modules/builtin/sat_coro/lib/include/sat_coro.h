@@ -0,0 +1,236 @@
+/**
+ * @file sat_coro.h
+ * @brief Stackful coroutines scheduled on a reactor
+ *
+ * This module runs many lightweight fibers on a single thread. Each fiber
+ * has its own stack, so protocol code is written as plain sequential calls:
+ * receive a request, process it, send the answer. When a call would block,
+ * the fiber yields and the runtime switches to another one; the descriptor is
+ * watched by a sat_reactor and the fiber resumes once it is ready.
+ *
+ * On x86-64 a switch saves the callee-saved registers and swaps stack
+ * pointers in a few instructions; other architectures fall back to
+ * swapcontext(), which also saves the signal mask with a system call.
+ *
+ * Stacks are allocated with mmap() behind a guard page and only the pages a
+ * fiber touches take memory, so tens of thousands of sessions fit where the
+ * same number of threads would not. Stacks of finished fibers are pooled and
+ * handed to the next spawned fiber.
+ *
+ * A runtime belongs to the thread that calls sat_coro_run(); to use several
+ * cores, open one runtime per thread, for instance one per listening socket
+ * opened with SO_REUSEPORT.
+ *
+ * Descriptors passed to the I/O functions must be non-blocking.
+ */
+
+#ifndef SAT_CORO_H_
+#define SAT_CORO_H_
+
+#include <sat_status.h>
+#include <sat_reactor.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Stack size of a fiber when none is given
+ */
+#define SAT_CORO_STACK_SIZE_DEFAULT     (64 * 1024)
+
+/**
+ * @brief Number of finished fiber stacks kept for reuse when none is given
+ */
+#define SAT_CORO_POOL_DEFAULT           256
+
+typedef struct sat_coro_t sat_coro_t;
+
+/**
+ * @brief Fiber, internal to the runtime
+ */
+typedef struct sat_coro_fiber_t sat_coro_fiber_t;
+
+/**
+ * @brief Function run by a fiber
+ *
+ * The fiber ends when the function returns.
+ *
+ * @param object The runtime, to be passed to the blocking calls
+ * @param data Context pointer given to sat_coro_spawn()
+ */
+typedef void (*sat_coro_entry_t) (sat_coro_t *const object, void *const data);
+
+/**
+ * @brief Runtime structure
+ *
+ * This structure should be treated as opaque and accessed only through
+ * the provided API functions.
+ */
+struct sat_coro_t
+{
+    sat_reactor_t local;                /**< Reactor used when none is given */
+    sat_reactor_t *reactor;             /**< Reactor the fibers wait on */
+    sat_coro_fiber_t *origin;           /**< Stands for sat_coro_run() while a fiber runs */
+    sat_coro_fiber_t *current;          /**< Running fiber, NULL outside fibers */
+    sat_coro_fiber_t *ready;            /**< First fiber ready to run */
+    sat_coro_fiber_t *ready_last;       /**< Last fiber ready to run */
+    sat_coro_fiber_t **sleepers;        /**< Min-heap of sleeping fibers ordered by deadline */
+    uint32_t sleepers_amount;           /**< Number of sleeping fibers */
+    uint32_t sleepers_capacity;         /**< Number of slots in sleepers */
+    sat_coro_fiber_t *pool;             /**< Finished fibers whose stacks are reused */
+    uint32_t pool_amount;               /**< Number of fibers in pool */
+    uint32_t pool_capacity;             /**< Most fibers kept in pool */
+    uint32_t stack_size;                /**< Usable stack size of each fiber */
+    uint32_t page_size;                 /**< Size of the guard page */
+    uint32_t amount;                    /**< Number of fibers not yet finished */
+    uint32_t waiting;                   /**< Number of fibers waiting on a descriptor */
+    bool owned;                         /**< Whether reactor is local */
+};
+
+/**
+ * @brief Configuration structure for opening a runtime
+ */
+typedef struct
+{
+    uint32_t stack_size;                /**< Stack size of each fiber, 0 for SAT_CORO_STACK_SIZE_DEFAULT */
+    uint32_t pool;                      /**< Finished stacks kept for reuse, 0 for SAT_CORO_POOL_DEFAULT */
+    sat_reactor_t *reactor;             /**< Opened reactor to share, NULL to create one */
+} sat_coro_args_t;
+
+/**
+ * @brief Initialize a runtime
+ *
+ * @param object Pointer to the runtime structure
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_init (sat_coro_t *const object);
+
+/**
+ * @brief Open a runtime
+ *
+ * A shared reactor keeps serving its other descriptors while the fibers run,
+ * as long as sat_coro_run() is what drives it.
+ *
+ * @param object Pointer to the initialized runtime
+ * @param args Pointer to the configuration, or NULL for the defaults
+ * @return Status structure indicating success or failure
+ * @see sat_coro_close()
+ */
+sat_status_t sat_coro_open (sat_coro_t *const object, const sat_coro_args_t *const args);
+
+/**
+ * @brief Create a fiber
+ *
+ * The fiber starts on the next turn of sat_coro_run(). May be called from
+ * within a fiber.
+ *
+ * @param object Pointer to the opened runtime
+ * @param entry Function run by the fiber
+ * @param data Context pointer passed to entry
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_spawn (sat_coro_t *const object, sat_coro_entry_t entry, void *const data);
+
+/**
+ * @brief Run the fibers until all of them have finished
+ *
+ * @param object Pointer to the opened runtime
+ * @return Status structure indicating success or failure
+ * @warning Must not be called from within a fiber
+ */
+sat_status_t sat_coro_run (sat_coro_t *const object);
+
+/**
+ * @brief Let the other ready fibers run
+ *
+ * @param object Pointer to the runtime of the calling fiber
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_yield (sat_coro_t *const object);
+
+/**
+ * @brief Suspend the calling fiber
+ *
+ * @param object Pointer to the runtime of the calling fiber
+ * @param milliseconds Time to sleep
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_sleep (sat_coro_t *const object, uint64_t milliseconds);
+
+/**
+ * @brief Suspend the calling fiber until a descriptor is ready
+ *
+ * @param object Pointer to the runtime of the calling fiber
+ * @param fd Descriptor to wait on
+ * @param events sat_reactor_event_t flags to wait for
+ * @param[out] ready Pointer to store the flags that apply, or NULL
+ * @return Status structure indicating success or failure
+ * @note Only one fiber may wait on a given descriptor at a time
+ */
+sat_status_t sat_coro_wait (sat_coro_t *const object, int fd, uint32_t events, uint32_t *const ready);
+
+/**
+ * @brief Receive data, suspending the calling fiber until some arrives
+ *
+ * @param object Pointer to the runtime of the calling fiber
+ * @param fd Non-blocking socket
+ * @param buffer Destination buffer
+ * @param size Capacity of buffer
+ * @param[out] received Pointer to store the number of bytes received, 0 once the peer closed
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_receive (sat_coro_t *const object, int fd, void *const buffer, uint32_t size, uint32_t *const received);
+
+/**
+ * @brief Send all data, suspending the calling fiber while the socket is full
+ *
+ * @param object Pointer to the runtime of the calling fiber
+ * @param fd Non-blocking socket
+ * @param data Data to send
+ * @param size Number of bytes to send
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_send (sat_coro_t *const object, int fd, const void *const data, uint32_t size);
+
+/**
+ * @brief Accept a connection, suspending the calling fiber until one arrives
+ *
+ * @param object Pointer to the runtime of the calling fiber
+ * @param fd Non-blocking listening socket
+ * @param[out] client Pointer to store the connection, itself non-blocking
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_accept (sat_coro_t *const object, int fd, int *const client);
+
+/**
+ * @brief Connect a socket, suspending the calling fiber until it completes
+ *
+ * @param object Pointer to the runtime of the calling fiber
+ * @param fd Non-blocking socket
+ * @param address Address to connect to
+ * @param length Size of address
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_connect (sat_coro_t *const object, int fd, const struct sockaddr *const address, socklen_t length);
+
+/**
+ * @brief Get the number of fibers not yet finished
+ *
+ * @param object Pointer to the runtime
+ * @param[out] amount Pointer to store the number of fibers
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_coro_get_amount (const sat_coro_t *const object, uint32_t *const amount);
+
+/**
+ * @brief Close the runtime
+ *
+ * Releases the pooled stacks and, unless it was shared, the reactor.
+ *
+ * @param object Pointer to the runtime
+ * @return Status structure indicating success or failure
+ * @warning Every fiber must have finished
+ */
+sat_status_t sat_coro_close (sat_coro_t *const object);
+
+#endif/* SAT_CORO_H_ */
@@ -0,0 +1,649 @@
+#include <sat_coro.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#if !defined (__x86_64__)
+#include <ucontext.h>
+#endif
+
+#define SAT_CORO_SLEEPERS_MIN       16
+
+struct sat_coro_fiber_t
+{
+#if defined (__x86_64__)
+    void *stack_pointer;            // saved by sat_coro_switch
+#else
+    ucontext_t context;
+#endif
+    sat_coro_t *coro;
+    sat_coro_entry_t entry;
+    void *data;
+    uint8_t *stack;                 // mapping, guard page first
+    sat_coro_fiber_t *next;         // ready list or pool
+    uint64_t deadline;
+    uint32_t events;                // flags reported by the last wait
+    bool done;
+};
+
+static sat_status_t sat_coro_allocate (sat_coro_t *const object, sat_coro_fiber_t **const fiber);
+static void sat_coro_release (sat_coro_t *const object, sat_coro_fiber_t *const fiber);
+static void sat_coro_prepare (sat_coro_t *const object, sat_coro_fiber_t *const fiber);
+static void sat_coro_transfer (sat_coro_fiber_t *const from, sat_coro_fiber_t *const to);
+static void sat_coro_push_ready (sat_coro_t *const object, sat_coro_fiber_t *const fiber);
+static void sat_coro_suspend (sat_coro_t *const object);
+static void sat_coro_on_ready (int fd, uint32_t events, void *data);
+static bool sat_coro_sleepers_push (sat_coro_t *const object, sat_coro_fiber_t *const fiber);
+static sat_coro_fiber_t *sat_coro_sleepers_pop (sat_coro_t *const object);
+static void sat_coro_wake_sleepers (sat_coro_t *const object);
+static int sat_coro_get_timeout (const sat_coro_t *const object);
+static uint64_t sat_coro_now (void);
+
+void sat_coro_start (sat_coro_fiber_t *const fiber) __attribute__ ((visibility ("hidden"), noreturn));
+
+#if defined (__x86_64__)
+
+void sat_coro_switch (void **const from, void *const to) __attribute__ ((visibility ("hidden")));
+void sat_coro_boot (void) __attribute__ ((visibility ("hidden")));
+
+/*
+ * Saves the callee-saved registers, the SSE control word and the x87 control
+ * word on the current stack, stores its pointer in *from, then restores the
+ * same from the stack at to. Everything else is caller-saved, so the C code
+ * around the call already keeps it. A new fiber starts in sat_coro_boot with
+ * its pointer in r12, as laid out by sat_coro_prepare().
+ */
+__asm__ (
+    ".text\n"
+    ".globl sat_coro_switch\n"
+    ".hidden sat_coro_switch\n"
+    ".type sat_coro_switch, @function\n"
+    "sat_coro_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size sat_coro_switch, .-sat_coro_switch\n"
+    ".globl sat_coro_boot\n"
+    ".hidden sat_coro_boot\n"
+    ".type sat_coro_boot, @function\n"
+    "sat_coro_boot:\n"
+    "    movq %r12, %rdi\n"
+    "    andq $-16, %rsp\n"
+    "    call sat_coro_start\n"
+    "    ud2\n"
+    ".size sat_coro_boot, .-sat_coro_boot\n"
+);
+
+#else
+
+static void sat_coro_trampoline (unsigned int high, unsigned int low);
+
+#endif
+
+sat_status_t sat_coro_init (sat_coro_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    memset (object, 0, sizeof (sat_coro_t));
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_open (sat_coro_t *const object, const sat_coro_args_t *const args)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_not_equals (object->reactor, NULL, "runtime already open");
+
+    sat_coro_args_t _args = args == NULL ? (sat_coro_args_t) {0} : *args;
+
+    object->page_size = (uint32_t) sysconf (_SC_PAGESIZE);
+
+    uint32_t stack_size = _args.stack_size == 0 ? SAT_CORO_STACK_SIZE_DEFAULT : _args.stack_size;
+
+    // Whole pages, so the guard page of the next mapping stays aligned.
+    object->stack_size = (stack_size + object->page_size - 1) & ~(object->page_size - 1);
+    object->pool_capacity = _args.pool == 0 ? SAT_CORO_POOL_DEFAULT : _args.pool;
+
+    object->origin = (sat_coro_fiber_t *) calloc (1, sizeof (sat_coro_fiber_t));
+    sat_status_return_on_null (object->origin, "origin allocation failed");
+
+    if (_args.reactor != NULL)
+        object->reactor = _args.reactor;
+
+    else
+    {
+        sat_reactor_init (&object->local);
+
+        sat_status_t status = sat_reactor_open (&object->local, NULL);
+
+        if (sat_status_get_result (&status) == false)
+        {
+            free (object->origin);
+            object->origin = NULL;
+
+            return status;
+        }
+
+        object->reactor = &object->local;
+        object->owned = true;
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_spawn (sat_coro_t *const object, sat_coro_entry_t entry, void *const data)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (object->reactor, "runtime not open");
+    sat_status_return_on_null (entry, "entry is null");
+
+    sat_coro_fiber_t *fiber;
+
+    sat_status_return_on_error (sat_coro_allocate (object, &fiber));
+
+    sat_coro_prepare (object, fiber);
+
+    fiber->entry = entry;
+    fiber->data = data;
+    fiber->done = false;
+
+    object->amount ++;
+
+    sat_coro_push_ready (object, fiber);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_run (sat_coro_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (object->reactor, "runtime not open");
+    sat_status_return_on_not_equals (object->current, NULL, "called from a fiber");
+
+    while (object->amount > 0)
+    {
+        sat_coro_wake_sleepers (object);
+
+        // Only the fibers ready at the start of the turn, so a yielding fiber cannot starve the reactor.
+        sat_coro_fiber_t *fiber = object->ready;
+
+        object->ready = NULL;
+        object->ready_last = NULL;
+
+        while (fiber != NULL)
+        {
+            sat_coro_fiber_t *next = fiber->next;
+
+            object->current = fiber;
+            sat_coro_transfer (object->origin, fiber);
+            object->current = NULL;
+
+            if (fiber->done == true)
+                sat_coro_release (object, fiber);
+
+            fiber = next;
+        }
+
+        if (object->amount == 0)
+            break;
+
+        // Polling an own reactor nobody waits on would only cost a system call per turn.
+        if (object->ready != NULL && object->waiting == 0 && object->owned == true)
+            continue;
+
+        sat_status_return_on_error (sat_reactor_run_once (object->reactor, sat_coro_get_timeout (object)));
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_yield (sat_coro_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (object->current, "not called from a fiber");
+
+    sat_coro_push_ready (object, object->current);
+    sat_coro_suspend (object);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_sleep (sat_coro_t *const object, uint64_t milliseconds)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (object->current, "not called from a fiber");
+
+    object->current->deadline = sat_coro_now () + milliseconds;
+
+    sat_status_return_on_false (sat_coro_sleepers_push (object, object->current), "sleepers allocation failed");
+
+    sat_coro_suspend (object);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_wait (sat_coro_t *const object, int fd, uint32_t events, uint32_t *const ready)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (object->current, "not called from a fiber");
+
+    sat_coro_fiber_t *fiber = object->current;
+
+    // sat_coro_on_ready() takes the descriptor back off the reactor.
+    sat_status_return_on_error (sat_reactor_add (object->reactor, fd, events, sat_coro_on_ready, fiber));
+
+    object->waiting ++;
+
+    sat_coro_suspend (object);
+
+    if (ready != NULL)
+        *ready = fiber->events;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_receive (sat_coro_t *const object, int fd, void *const buffer, uint32_t size, uint32_t *const received)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (buffer, "buffer is null");
+    sat_status_return_on_null (received, "received is null");
+
+    while (true)
+    {
+        ssize_t amount = recv (fd, buffer, size, 0);
+
+        if (amount >= 0)
+        {
+            *received = (uint32_t) amount;
+            sat_status_return_on_success ();
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            sat_status_return_on_error (sat_coro_wait (object, fd, sat_reactor_event_read, NULL));
+        }
+
+        else if (errno != EINTR)
+            sat_status_return_on_failure ("recv failed");
+    }
+}
+
+sat_status_t sat_coro_send (sat_coro_t *const object, int fd, const void *const data, uint32_t size)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (data, "data is null");
+
+    uint32_t sent = 0;
+
+    while (sent < size)
+    {
+        ssize_t amount = send (fd, (const uint8_t *) data + sent, size - sent, MSG_NOSIGNAL);
+
+        if (amount >= 0)
+            sent += (uint32_t) amount;
+
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            sat_status_return_on_error (sat_coro_wait (object, fd, sat_reactor_event_write, NULL));
+        }
+
+        else if (errno != EINTR)
+            sat_status_return_on_failure ("send failed");
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_accept (sat_coro_t *const object, int fd, int *const client)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (client, "client is null");
+
+    while (true)
+    {
+        *client = accept4 (fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (*client >= 0)
+            sat_status_return_on_success ();
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            sat_status_return_on_error (sat_coro_wait (object, fd, sat_reactor_event_read, NULL));
+        }
+
+        // A connection that was reset before it was accepted is not an error of the listener.
+        else if (errno != EINTR && errno != ECONNABORTED)
+            sat_status_return_on_failure ("accept failed");
+    }
+}
+
+sat_status_t sat_coro_connect (sat_coro_t *const object, int fd, const struct sockaddr *const address, socklen_t length)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (address, "address is null");
+
+    if (connect (fd, address, length) == 0)
+        sat_status_return_on_success ();
+
+    sat_status_return_on_false ((errno == EINPROGRESS || errno == EINTR), "connect failed");
+
+    sat_status_return_on_error (sat_coro_wait (object, fd, sat_reactor_event_write, NULL));
+
+    int error = 0;
+    socklen_t size = sizeof (error);
+
+    sat_status_return_on_not_equals (getsockopt (fd, SOL_SOCKET, SO_ERROR, &error, &size), 0, "getsockopt failed");
+    sat_status_return_on_not_equals (error, 0, "connect failed");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_get_amount (const sat_coro_t *const object, uint32_t *const amount)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (amount, "amount is null");
+
+    *amount = object->amount;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_coro_close (sat_coro_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_not_equals (object->amount, 0, "fibers still running");
+
+    while (object->pool != NULL)
+    {
+        sat_coro_fiber_t *fiber = object->pool;
+
+        object->pool = fiber->next;
+
+        munmap (fiber->stack, object->page_size + object->stack_size);
+        free (fiber);
+    }
+
+    free (object->sleepers);
+    free (object->origin);
+
+    if (object->owned == true)
+        sat_reactor_close (&object->local);
+
+    memset (object, 0, sizeof (sat_coro_t));
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_coro_allocate (sat_coro_t *const object, sat_coro_fiber_t **const fiber)
+{
+    if (object->pool != NULL)
+    {
+        *fiber = object->pool;
+
+        object->pool = (*fiber)->next;
+        object->pool_amount --;
+
+        sat_status_return_on_success ();
+    }
+
+    sat_coro_fiber_t *_fiber = (sat_coro_fiber_t *) calloc (1, sizeof (sat_coro_fiber_t));
+    sat_status_return_on_null (_fiber, "fiber allocation failed");
+
+    // Pages are only backed by memory once the fiber touches them.
+    void *stack = mmap (NULL, object->page_size + object->stack_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+
+    if (stack == MAP_FAILED)
+    {
+        free (_fiber);
+        sat_status_return_on_failure ("stack allocation failed");
+    }
+
+    // The stack grows down, so an overflow hits the guard page instead of another fiber.
+    if (mprotect (stack, object->page_size, PROT_NONE) != 0)
+    {
+        munmap (stack, object->page_size + object->stack_size);
+        free (_fiber);
+        sat_status_return_on_failure ("guard page failed");
+    }
+
+    _fiber->stack = (uint8_t *) stack;
+    _fiber->coro = object;
+
+    *fiber = _fiber;
+
+    sat_status_return_on_success ();
+}
+
+static void sat_coro_release (sat_coro_t *const object, sat_coro_fiber_t *const fiber)
+{
+    object->amount --;
+
+    if (object->pool_amount < object->pool_capacity)
+    {
+        fiber->next = object->pool;
+        object->pool = fiber;
+        object->pool_amount ++;
+    }
+
+    else
+    {
+        munmap (fiber->stack, object->page_size + object->stack_size);
+        free (fiber);
+    }
+}
+
+void sat_coro_start (sat_coro_fiber_t *const fiber)
+{
+    fiber->entry (fiber->coro, fiber->data);
+
+    fiber->done = true;
+
+    // Never resumed: sat_coro_run() recycles the stack.
+    sat_coro_transfer (fiber, fiber->coro->origin);
+
+    __builtin_unreachable ();
+}
+
+#if defined (__x86_64__)
+
+static void sat_coro_prepare (sat_coro_t *const object, sat_coro_fiber_t *const fiber)
+{
+    uint64_t *top = (uint64_t *) (fiber->stack + object->page_size + object->stack_size);
+
+    // The frame sat_coro_switch() pops, with sat_coro_boot as return address.
+    uint64_t *frame = top - 9;
+
+    frame [0] = 0x037f00001f80;             // default x87 and SSE control words
+    frame [1] = 0;                          // r15
+    frame [2] = 0;                          // r14
+    frame [3] = 0;                          // r13
+    frame [4] = (uint64_t) (uintptr_t) fiber;   // r12
+    frame [5] = 0;                          // rbx
+    frame [6] = 0;                          // rbp
+    frame [7] = (uint64_t) (uintptr_t) sat_coro_boot;
+    frame [8] = 0;
+
+    fiber->stack_pointer = frame;
+}
+
+static void sat_coro_transfer (sat_coro_fiber_t *const from, sat_coro_fiber_t *const to)
+{
+    sat_coro_switch (&from->stack_pointer, to->stack_pointer);
+}
+
+#else
+
+static void sat_coro_prepare (sat_coro_t *const object, sat_coro_fiber_t *const fiber)
+{
+    uintptr_t pointer = (uintptr_t) fiber;
+
+    getcontext (&fiber->context);
+
+    fiber->context.uc_stack.ss_sp = fiber->stack + object->page_size;
+    fiber->context.uc_stack.ss_size = object->stack_size;
+    fiber->context.uc_link = NULL;
+
+    // makecontext only passes ints, so the pointer travels in two halves.
+    makecontext (&fiber->context, (void (*) (void)) sat_coro_trampoline, 2, (unsigned int) ((uint64_t) pointer >> 32), (unsigned int) pointer);
+}
+
+static void sat_coro_transfer (sat_coro_fiber_t *const from, sat_coro_fiber_t *const to)
+{
+    swapcontext (&from->context, &to->context);
+}
+
+static void sat_coro_trampoline (unsigned int high, unsigned int low)
+{
+    sat_coro_start ((sat_coro_fiber_t *) (uintptr_t) ((uint64_t) high << 32 | low));
+}
+
+#endif
+
+static void sat_coro_push_ready (sat_coro_t *const object, sat_coro_fiber_t *const fiber)
+{
+    fiber->next = NULL;
+
+    if (object->ready_last == NULL)
+        object->ready = fiber;
+
+    else
+        object->ready_last->next = fiber;
+
+    object->ready_last = fiber;
+}
+
+static void sat_coro_suspend (sat_coro_t *const object)
+{
+    sat_coro_transfer (object->current, object->origin);
+}
+
+static void sat_coro_on_ready (int fd, uint32_t events, void *data)
+{
+    sat_coro_fiber_t *fiber = (sat_coro_fiber_t *) data;
+
+    sat_reactor_remove (fiber->coro->reactor, fd);
+
+    fiber->coro->waiting --;
+    fiber->events = events;
+
+    sat_coro_push_ready (fiber->coro, fiber);
+}
+
+static bool sat_coro_sleepers_push (sat_coro_t *const object, sat_coro_fiber_t *const fiber)
+{
+    if (object->sleepers_amount == object->sleepers_capacity)
+    {
+        uint32_t capacity = object->sleepers_capacity == 0 ? SAT_CORO_SLEEPERS_MIN : object->sleepers_capacity * 2;
+        sat_coro_fiber_t **sleepers = (sat_coro_fiber_t **) realloc (object->sleepers, capacity * sizeof (sat_coro_fiber_t *));
+
+        if (sleepers == NULL)
+            return false;
+
+        object->sleepers = sleepers;
+        object->sleepers_capacity = capacity;
+    }
+
+    uint32_t index = object->sleepers_amount ++;
+
+    while (index > 0)
+    {
+        uint32_t parent = (index - 1) / 2;
+
+        if (object->sleepers [parent]->deadline <= fiber->deadline)
+            break;
+
+        object->sleepers [index] = object->sleepers [parent];
+        index = parent;
+    }
+
+    object->sleepers [index] = fiber;
+
+    return true;
+}
+
+static sat_coro_fiber_t *sat_coro_sleepers_pop (sat_coro_t *const object)
+{
+    sat_coro_fiber_t *first = object->sleepers [0];
+    sat_coro_fiber_t *last = object->sleepers [-- object->sleepers_amount];
+    uint32_t index = 0;
+
+    while (true)
+    {
+        uint32_t child = index * 2 + 1;
+
+        if (child >= object->sleepers_amount)
+            break;
+
+        if (child + 1 < object->sleepers_amount && object->sleepers [child + 1]->deadline < object->sleepers [child]->deadline)
+            child ++;
+
+        if (last->deadline <= object->sleepers [child]->deadline)
+            break;
+
+        object->sleepers [index] = object->sleepers [child];
+        index = child;
+    }
+
+    if (object->sleepers_amount > 0)
+        object->sleepers [index] = last;
+
+    return first;
+}
+
+static void sat_coro_wake_sleepers (sat_coro_t *const object)
+{
+    if (object->sleepers_amount == 0)
+        return;
+
+    uint64_t now = sat_coro_now ();
+
+    while (object->sleepers_amount > 0 && object->sleepers [0]->deadline <= now)
+        sat_coro_push_ready (object, sat_coro_sleepers_pop (object));
+}
+
+static int sat_coro_get_timeout (const sat_coro_t *const object)
+{
+    if (object->ready != NULL)
+        return 0;
+
+    if (object->sleepers_amount == 0)
+        return -1;
+
+    uint64_t now = sat_coro_now ();
+    uint64_t deadline = object->sleepers [0]->deadline;
+
+    if (deadline <= now)
+        return 0;
+
+    return deadline - now > INT32_MAX ? INT32_MAX : (int) (deadline - now);
+}
+
+static uint64_t sat_coro_now (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
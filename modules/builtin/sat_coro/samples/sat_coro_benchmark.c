@@ -0,0 +1,248 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+
+/*
+ * Measures what a coroutine costs: the time of a switch between two fibers,
+ * compared with handing control between two threads through a pipe, the
+ * resident memory taken by each sleeping fiber, and the round trips that
+ * concurrent sessions over socket pairs complete on a single thread.
+ *
+ * usage: sat_coro_benchmark [fibers] [switches]
+ */
+
+#define BENCHMARK_FIBERS_DEFAULT        10000
+#define BENCHMARK_SWITCHES_DEFAULT      1000000
+#define BENCHMARK_SESSIONS              1000
+#define BENCHMARK_ROUND_TRIPS           100
+
+typedef struct
+{
+    uint64_t switches;
+    uint32_t fibers;
+    uint64_t resident;
+    uint32_t started;
+} benchmark_context_t;
+
+static double benchmark_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static uint64_t benchmark_resident (void)
+{
+    unsigned long size = 0;
+    unsigned long resident = 0;
+
+    FILE *file = fopen ("/proc/self/statm", "r");
+
+    if (file != NULL)
+    {
+        if (fscanf (file, "%lu %lu", &size, &resident) != 2)
+            resident = 0;
+
+        fclose (file);
+    }
+
+    return (uint64_t) resident * (uint64_t) sysconf (_SC_PAGESIZE);
+}
+
+static void switcher (sat_coro_t *const coro, void *const data)
+{
+    benchmark_context_t *context = (benchmark_context_t *) data;
+
+    for (uint64_t i = 0; i < context->switches; i++)
+        sat_coro_yield (coro);
+}
+
+static void benchmark_switch (benchmark_context_t *const context)
+{
+    sat_coro_t coro;
+
+    sat_coro_init (&coro);
+    sat_coro_open (&coro, NULL);
+
+    sat_coro_spawn (&coro, switcher, context);
+    sat_coro_spawn (&coro, switcher, context);
+
+    double start = benchmark_now ();
+    sat_coro_run (&coro);
+    double elapsed = benchmark_now () - start;
+
+    printf ("%-28s %10.1f ns\n", "fiber switch", elapsed * 1e9 / (double) (2 * context->switches));
+
+    sat_coro_close (&coro);
+}
+
+static void *ping_pong (void *args)
+{
+    int *pipes = (int *) args;
+    char byte;
+
+    while (read (pipes [0], &byte, 1) == 1 && byte != 0)
+    {
+        if (write (pipes [1], &byte, 1) != 1)
+            break;
+    }
+
+    return NULL;
+}
+
+static void benchmark_thread_switch (benchmark_context_t *const context)
+{
+    int there [2];
+    int back [2];
+    pthread_t thread;
+    char byte = 1;
+
+    if (pipe (there) != 0 || pipe (back) != 0)
+        return;
+
+    int pipes [2] = {there [0], back [1]};
+
+    pthread_create (&thread, NULL, ping_pong, pipes);
+
+    // Far fewer rounds: each one goes through the kernel scheduler twice.
+    uint64_t rounds = context->switches / 20;
+
+    double start = benchmark_now ();
+
+    for (uint64_t i = 0; i < rounds && write (there [1], &byte, 1) == 1 && read (back [0], &byte, 1) == 1; i++)
+        ;
+
+    double elapsed = benchmark_now () - start;
+
+    byte = 0;
+    if (write (there [1], &byte, 1) == 1)
+        pthread_join (thread, NULL);
+
+    printf ("%-28s %10.1f ns\n", "thread switch through pipe", elapsed * 1e9 / (double) (2 * rounds));
+
+    close (there [0]);
+    close (there [1]);
+    close (back [0]);
+    close (back [1]);
+}
+
+static void sleeper (sat_coro_t *const coro, void *const data)
+{
+    benchmark_context_t *context = (benchmark_context_t *) data;
+    volatile char frame [512];
+
+    // A session keeps some state on its stack.
+    memset ((char *) frame, 1, sizeof (frame));
+
+    if (++ context->started == context->fibers)
+        context->resident = benchmark_resident ();
+
+    sat_coro_sleep (coro, 50);
+}
+
+static void benchmark_memory (benchmark_context_t *const context)
+{
+    sat_coro_t coro;
+
+    sat_coro_init (&coro);
+    sat_coro_open (&coro, &(sat_coro_args_t) {.pool = 1});
+
+    uint64_t before = benchmark_resident ();
+
+    for (uint32_t i = 0; i < context->fibers; i++)
+        sat_coro_spawn (&coro, sleeper, context);
+
+    sat_coro_run (&coro);
+
+    printf ("%-28s %10.1f KiB resident, %u KiB reserved (%u fibers)\n", "memory per fiber",
+            (double) (context->resident - before) / 1024.0 / (double) context->fibers,
+            (coro.stack_size + coro.page_size) / 1024, context->fibers);
+
+    sat_coro_close (&coro);
+}
+
+static void pinger (sat_coro_t *const coro, void *const data)
+{
+    int fd = (int) (intptr_t) data;
+    uint64_t value = 0;
+    uint32_t received;
+
+    for (uint32_t i = 0; i < BENCHMARK_ROUND_TRIPS; i++)
+    {
+        sat_coro_send (coro, fd, &value, sizeof (value));
+        sat_coro_receive (coro, fd, &value, sizeof (value), &received);
+    }
+
+    close (fd);
+}
+
+static void ponger (sat_coro_t *const coro, void *const data)
+{
+    int fd = (int) (intptr_t) data;
+    uint64_t value;
+    uint32_t received;
+
+    while (sat_coro_receive (coro, fd, &value, sizeof (value), &received), received > 0)
+    {
+        value ++;
+        sat_coro_send (coro, fd, &value, sizeof (value));
+    }
+
+    close (fd);
+}
+
+static void benchmark_sessions (void)
+{
+    sat_coro_t coro;
+
+    sat_coro_init (&coro);
+    sat_coro_open (&coro, NULL);
+
+    for (uint32_t i = 0; i < BENCHMARK_SESSIONS; i++)
+    {
+        int pair [2];
+
+        if (socketpair (AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) != 0)
+            break;
+
+        sat_coro_spawn (&coro, pinger, (void *) (intptr_t) pair [0]);
+        sat_coro_spawn (&coro, ponger, (void *) (intptr_t) pair [1]);
+    }
+
+    double start = benchmark_now ();
+    sat_coro_run (&coro);
+    double elapsed = benchmark_now () - start;
+
+    printf ("%-28s %10.0f round trips/s (%u sessions)\n", "sessions on one thread",
+            (double) BENCHMARK_SESSIONS * BENCHMARK_ROUND_TRIPS / elapsed, BENCHMARK_SESSIONS);
+
+    sat_coro_close (&coro);
+}
+
+int main (int argc, char **argv)
+{
+    benchmark_context_t context =
+    {
+        .fibers = argc > 1 ? (uint32_t) atoi (argv [1]) : BENCHMARK_FIBERS_DEFAULT,
+        .switches = argc > 2 ? (uint64_t) atoll (argv [2]) : BENCHMARK_SWITCHES_DEFAULT,
+    };
+
+    if (context.fibers == 0 || context.switches < 20)
+    {
+        fprintf (stderr, "usage: %s [fibers] [switches]\n", argv [0]);
+        return 1;
+    }
+
+    benchmark_switch (&context);
+    benchmark_thread_switch (&context);
+    benchmark_memory (&context);
+    benchmark_sessions ();
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <sat.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+
+#define SERVICE_PORT    9998
+
+static void session (sat_coro_t *const coro, void *const data)
+{
+    int client = (int) (intptr_t) data;
+    char buffer [1024];
+    uint32_t received;
+
+    // Reads like a blocking server, yet every session shares one thread.
+    while (true)
+    {
+        sat_status_t status = sat_coro_receive (coro, client, buffer, sizeof (buffer), &received);
+
+        if (sat_status_get_result (&status) == false || received == 0)
+            break;
+
+        printf ("Server: %.*s", (int) received, buffer);
+
+        sat_coro_send (coro, client, buffer, received);
+    }
+
+    close (client);
+}
+
+static void acceptor (sat_coro_t *const coro, void *const data)
+{
+    int listener = (int) (intptr_t) data;
+
+    while (true)
+    {
+        int client;
+
+        sat_status_t status = sat_coro_accept (coro, listener, &client);
+        if (sat_status_get_result (&status) == false)
+            break;
+
+        sat_coro_spawn (coro, session, (void *) (intptr_t) client);
+    }
+}
+
+int main (int argc, char **argv)
+{
+    sat_coro_t coro;
+    int yes = 1;
+
+    struct sockaddr_in address =
+    {
+        .sin_family = AF_INET,
+        .sin_port = htons (SERVICE_PORT),
+        .sin_addr.s_addr = htonl (INADDR_ANY),
+    };
+
+    int listener = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+    setsockopt (listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof (yes));
+
+    if (bind (listener, (struct sockaddr *) &address, sizeof (address)) != 0 || listen (listener, SOMAXCONN) != 0)
+    {
+        perror ("listen");
+        return 1;
+    }
+
+    sat_coro_init (&coro);
+
+    sat_status_t status = sat_coro_open (&coro, NULL);
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    sat_coro_spawn (&coro, acceptor, (void *) (intptr_t) listener);
+
+    printf ("echo server on port %d, try several \"nc localhost %d\"\n", SERVICE_PORT, SERVICE_PORT);
+
+    sat_coro_run (&coro);
+
+    sat_coro_close (&coro);
+    close (listener);
+
+    return 0;
+}
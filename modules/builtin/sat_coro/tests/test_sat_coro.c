@@ -0,0 +1,281 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define TEST_SESSIONS       200
+
+typedef struct
+{
+    char log [64];
+    uint32_t length;
+} test_log_t;
+
+typedef struct
+{
+    test_log_t *log;
+    char name;
+    uint64_t delay;
+} test_fiber_t;
+
+typedef struct
+{
+    int listener;
+    struct sockaddr_in address;
+    uint32_t served;
+    uint32_t checked;
+} test_server_t;
+
+static void test_open (sat_coro_t *const coro, const sat_coro_args_t *const args)
+{
+    sat_status_t status = sat_coro_init (coro);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_coro_open (coro, args);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_yielder (sat_coro_t *const coro, void *const data)
+{
+    test_fiber_t *fiber = (test_fiber_t *) data;
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        fiber->log->log [fiber->log->length ++] = fiber->name;
+
+        sat_status_t status = sat_coro_yield (coro);
+        assert (sat_status_get_result (&status) == true);
+    }
+}
+
+static void test_yield (void)
+{
+    sat_coro_t coro;
+    test_log_t log = {0};
+    test_fiber_t a = {.log = &log, .name = 'a'};
+    test_fiber_t b = {.log = &log, .name = 'b'};
+
+    test_open (&coro, NULL);
+
+    sat_coro_spawn (&coro, test_yielder, &a);
+    sat_coro_spawn (&coro, test_yielder, &b);
+
+    sat_status_t status = sat_coro_run (&coro);
+    assert (sat_status_get_result (&status) == true);
+    assert (strcmp (log.log, "ababab") == 0);
+
+    // Outside a fiber there is nothing to suspend.
+    status = sat_coro_yield (&coro);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_coro_close (&coro);
+}
+
+static void test_sleeper (sat_coro_t *const coro, void *const data)
+{
+    test_fiber_t *fiber = (test_fiber_t *) data;
+
+    sat_status_t status = sat_coro_sleep (coro, fiber->delay);
+    assert (sat_status_get_result (&status) == true);
+
+    fiber->log->log [fiber->log->length ++] = fiber->name;
+}
+
+static void test_sleep (void)
+{
+    sat_coro_t coro;
+    test_log_t log = {0};
+    test_fiber_t fibers [] =
+    {
+        {.log = &log, .name = 'c', .delay = 30},
+        {.log = &log, .name = 'a', .delay = 10},
+        {.log = &log, .name = 'b', .delay = 20},
+        {.log = &log, .name = 'd', .delay = 40},
+    };
+
+    test_open (&coro, NULL);
+
+    for (uint32_t i = 0; i < 4; i++)
+        sat_coro_spawn (&coro, test_sleeper, &fibers [i]);
+
+    sat_status_t status = sat_coro_run (&coro);
+    assert (sat_status_get_result (&status) == true);
+    assert (strcmp (log.log, "abcd") == 0);
+
+    sat_coro_close (&coro);
+}
+
+static void test_session (sat_coro_t *const coro, void *const data)
+{
+    int client = (int) (intptr_t) data;
+    char buffer [64];
+    uint32_t received;
+
+    // Echo until the peer closes.
+    while (true)
+    {
+        sat_status_t status = sat_coro_receive (coro, client, buffer, sizeof (buffer), &received);
+
+        if (sat_status_get_result (&status) == false || received == 0)
+            break;
+
+        sat_coro_send (coro, client, buffer, received);
+    }
+
+    close (client);
+}
+
+static void test_acceptor (sat_coro_t *const coro, void *const data)
+{
+    test_server_t *server = (test_server_t *) data;
+
+    while (server->served < TEST_SESSIONS)
+    {
+        int client;
+
+        sat_status_t status = sat_coro_accept (coro, server->listener, &client);
+        assert (sat_status_get_result (&status) == true);
+
+        server->served ++;
+
+        sat_coro_spawn (coro, test_session, (void *) (intptr_t) client);
+    }
+}
+
+static void test_client (sat_coro_t *const coro, void *const data)
+{
+    test_server_t *server = (test_server_t *) data;
+    char message [32];
+    char reply [32];
+    uint32_t received = 0;
+
+    int fd = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    assert (fd >= 0);
+
+    sat_status_t status = sat_coro_connect (coro, fd, (struct sockaddr *) &server->address, sizeof (server->address));
+    assert (sat_status_get_result (&status) == true);
+
+    snprintf (message, sizeof (message), "hello %d", fd);
+
+    status = sat_coro_send (coro, fd, message, strlen (message));
+    assert (sat_status_get_result (&status) == true);
+
+    while (received < strlen (message))
+    {
+        uint32_t amount;
+
+        status = sat_coro_receive (coro, fd, reply + received, sizeof (reply) - received, &amount);
+        assert (sat_status_get_result (&status) == true);
+        assert (amount > 0);
+
+        received += amount;
+    }
+
+    assert (memcmp (reply, message, received) == 0);
+
+    server->checked ++;
+
+    close (fd);
+}
+
+static void test_echo (void)
+{
+    sat_coro_t coro;
+    test_server_t server = {.address = {.sin_family = AF_INET}};
+    socklen_t length = sizeof (server.address);
+
+    // Few stacks kept, so most sessions get fresh ones and the rest reuse them.
+    test_open (&coro, &(sat_coro_args_t) {.stack_size = 16 * 1024, .pool = 8});
+
+    inet_pton (AF_INET, "127.0.0.1", &server.address.sin_addr);
+
+    server.listener = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    assert (bind (server.listener, (struct sockaddr *) &server.address, sizeof (server.address)) == 0);
+    assert (listen (server.listener, SOMAXCONN) == 0);
+    assert (getsockname (server.listener, (struct sockaddr *) &server.address, &length) == 0);
+
+    sat_coro_spawn (&coro, test_acceptor, &server);
+
+    for (uint32_t i = 0; i < TEST_SESSIONS; i++)
+        sat_coro_spawn (&coro, test_client, &server);
+
+    sat_status_t status = sat_coro_run (&coro);
+    assert (sat_status_get_result (&status) == true);
+    assert (server.served == TEST_SESSIONS);
+    assert (server.checked == TEST_SESSIONS);
+    assert (coro.pool_amount == 8);
+
+    close (server.listener);
+
+    status = sat_coro_close (&coro);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_on_timer (int fd, uint32_t events, void *data)
+{
+    uint32_t *ticks = (uint32_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    ++ *ticks;
+}
+
+static void test_ticker (sat_coro_t *const coro, void *const data)
+{
+    uint32_t *ticks = (uint32_t *) data;
+
+    // The reactor timer keeps firing while the fiber sleeps on the same loop.
+    while (*ticks < 3)
+        sat_coro_sleep (coro, 5);
+}
+
+static void test_shared_reactor (void)
+{
+    sat_reactor_t reactor;
+    sat_coro_t coro;
+    uint32_t ticks = 0;
+    uint32_t amount;
+    int timer;
+
+    sat_reactor_init (&reactor);
+    sat_reactor_open (&reactor, NULL);
+    sat_reactor_add_timer (&reactor, 2, 2, test_on_timer, &ticks, &timer);
+
+    test_open (&coro, &(sat_coro_args_t) {.reactor = &reactor});
+
+    sat_coro_spawn (&coro, test_ticker, &ticks);
+
+    sat_status_t status = sat_coro_get_amount (&coro, &amount);
+    assert (sat_status_get_result (&status) == true);
+    assert (amount == 1);
+
+    status = sat_coro_close (&coro);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_coro_run (&coro);
+    assert (sat_status_get_result (&status) == true);
+    assert (ticks >= 3);
+
+    sat_coro_close (&coro);
+
+    // Still open: the runtime only closes a reactor it created.
+    status = sat_reactor_remove (&reactor, timer);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_reactor_close (&reactor);
+}
+
+int main (int argc, char *argv[])
+{
+    test_yield ();
+    test_sleep ();
+    test_echo ();
+    test_shared_reactor ();
+
+    return 0;
+}
@@ -7,17 +7,38 @@
  * This module provides an event dispatching system implementing the observer
  * pattern. It allows components to subscribe to events and receive notifications
  * when those events are fired, enabling loose coupling between system components.
+ *
+ * Observers are indexed by event id in a hash table, so firing an event only
+ * visits the observers of that event and registration is unbounded. By
+ * default sat_event_fire() calls the observers on the caller's thread. A
+ * dispatcher opened in asynchronous mode instead queues the event to its own
+ * threads; every event id is bound to one thread, so the events of a given id
+ * are delivered in the order they were fired.
+ *
+ * @warning Every dispatcher passed to sat_event_init() must be released with
+ *          sat_event_close(), even a synchronous one: the observer index is
+ *          allocated as observers are added. Earlier versions kept a fixed
+ *          array of SAT_EVENT_OBSERVER_AMOUNT mappings and needed no close.
  */
 
 #ifndef SAT_EVENT_H_
 #define SAT_EVENT_H_
 
 #include <sat_status.h>
+#include <sat_worker.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
 
-/** @brief Maximum number of event-observer mappings in a dispatcher */
+/**
+ * @brief Former maximum number of event-observer mappings in a dispatcher
+ * @deprecated Registration is unbounded; kept so existing code still builds
+ */
 #define SAT_EVENT_OBSERVER_AMOUNT       10
 
+/** @brief Maximum bytes of event data copied when an event is queued */
+#define SAT_EVENT_DATA_SIZE_MAX         4096
+
 /**
  * @brief Event handler callback function type
  * 
@@ -69,6 +90,31 @@ typedef struct
     void *context;                          /**< Optional context data */
 } sat_event_observer_map_t;
 
+/**
+ * @brief Observers of one event id, internal to the dispatcher
+ */
+typedef struct sat_event_entry_t sat_event_entry_t;
+
+/**
+ * @brief Dispatch mode enumeration
+ */
+typedef enum
+{
+    sat_event_mode_sync,             /**< Observers run on the thread firing the event */
+    sat_event_mode_async,            /**< Events are queued to the dispatcher threads */
+} sat_event_mode_t;
+
+/**
+ * @brief Dispatcher configuration structure
+ */
+typedef struct
+{
+    sat_event_mode_t mode;           /**< Dispatch mode */
+    uint8_t threads;                 /**< Dispatcher threads in asynchronous mode */
+    uint32_t data_size;              /**< Bytes of event data copied when queued, 0 queues the data pointer itself, at most SAT_EVENT_DATA_SIZE_MAX */
+    uint32_t capacity;               /**< Maximum events queued per thread, 0 leaves the queues unbounded */
+} sat_event_args_t;
+
 /**
  * @brief Event dispatcher structure
  * 
@@ -76,8 +122,20 @@ typedef struct
  */
 typedef struct 
 {
-    sat_event_observer_map_t map[SAT_EVENT_OBSERVER_AMOUNT];  /**< Event-observer mappings */
-    uint8_t amount;                                             /**< Number of registered mappings */
+    pthread_rwlock_t lock;           /**< Writers subscribe and unsubscribe, readers deliver events */
+    sat_event_entry_t **buckets;     /**< Hash index of the observed event ids */
+    struct
+    {
+        pthread_mutex_t lock;
+        pthread_cond_t done;         /**< Signaled when no delivery of a generation is left */
+        uint32_t generation;         /**< Bumped by every removal */
+        uint32_t amount [2];         /**< Deliveries in progress, by generation parity */
+    } delivery;                      /**< Lets a removal wait for the deliveries that may still call the observer */
+    uint32_t buckets_amount;         /**< Number of buckets, a power of two */
+    uint32_t events;                 /**< Number of event ids with observers */
+    sat_worker_t *workers;           /**< One single-threaded queue per dispatcher thread in asynchronous mode */
+    uint8_t threads;                 /**< Number of dispatcher threads, 0 in synchronous mode */
+    uint32_t data_size;              /**< Bytes of event data copied when queued */
 } sat_event_dispatcher_t;
 
 /**
@@ -88,11 +146,30 @@ typedef struct
  * @param[out] object Pointer to the dispatcher to initialize
  * @return sat_status_t indicating success or failure of the operation
  * 
- * @note Must be called before using the dispatcher
+ * @note Must be called before using the dispatcher, which is then synchronous
+ * @warning Must be paired with sat_event_close(), which releases what the
+ *          dispatcher allocates
  * @see sat_event_observer_add()
+ * @see sat_event_close()
  */
 sat_status_t sat_event_init (sat_event_dispatcher_t *const object);
 
+/**
+ * @brief Configures the dispatch mode
+ * 
+ * Optional: an initialized dispatcher is synchronous. In asynchronous mode
+ * the dispatcher threads are started here.
+ * 
+ * @param[in,out] object Pointer to the initialized dispatcher
+ * @param[in] args Dispatcher configuration
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note Must be called before any event is fired
+ * @note Fails when data_size exceeds SAT_EVENT_DATA_SIZE_MAX
+ * @see sat_event_close()
+ */
+sat_status_t sat_event_open (sat_event_dispatcher_t *const object, const sat_event_args_t *const args);
+
 /**
  * @brief Registers an observer for an event
  * 
@@ -105,12 +182,31 @@ sat_status_t sat_event_init (sat_event_dispatcher_t *const object);
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @note Multiple observers can be registered for the same event
- * @note Fails if the maximum number of mappings (SAT_EVENT_OBSERVER_AMOUNT) is reached
- * @warning The observer must remain valid for the lifetime of the dispatcher
+ * @note Safe while events are being fired and from an observer handler; an
+ *       observer added during a delivery is called from the next event on
+ * @warning The observer must remain valid until it is removed or the dispatcher is closed
  * @see sat_event_fire()
  */
 sat_status_t sat_event_observer_add (sat_event_dispatcher_t *const object, sat_event_t event, const sat_event_observer_t *const observer);
 
+/**
+ * @brief Unregisters an observer from an event
+ * 
+ * Removes the first registration of the observer for the event. Once this
+ * returns, the observer is not called for that event anymore, even by events
+ * already queued, and it may be released.
+ * 
+ * @param[in,out] object Pointer to the dispatcher
+ * @param[in] event Event identifier
+ * @param[in] observer Pointer to the registered observer
+ * @return sat_status_t indicating success, or failure if the observer was not registered
+ * 
+ * @note Waits for deliveries in progress, except from an observer handler of
+ *       the same dispatcher: there it returns at once, and the deliveries
+ *       under way, its own included, may still call the observer
+ */
+sat_status_t sat_event_observer_remove (sat_event_dispatcher_t *const object, sat_event_t event, const sat_event_observer_t *const observer);
+
 /**
  * @brief Fires an event, notifying all registered observers
  * 
@@ -125,9 +221,33 @@ sat_status_t sat_event_observer_add (sat_event_dispatcher_t *const object, sat_e
  * @note All observers registered for the event will have their handlers called
  * @note The order of notification follows registration order
  * @note If no observers are registered for the event, this is not an error
+ * @note In asynchronous mode the observers are called later on a dispatcher
+ *       thread; with a capacity, blocks while that thread's queue is full
  * @see sat_event_observer_add()
  */
 sat_status_t sat_event_fire (const sat_event_dispatcher_t *const object, sat_event_t event, const void *const data);
 
+/**
+ * @brief Waits until every event fired so far has been delivered
+ * 
+ * Returns at once in synchronous mode.
+ * 
+ * @param[in] object Pointer to the dispatcher
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_event_flush (sat_event_dispatcher_t *const object);
+
+/**
+ * @brief Releases the dispatcher
+ * 
+ * Delivers the events still queued, stops the dispatcher threads and drops
+ * every registration. The dispatcher must be initialized again before reuse.
+ * Required for every initialized dispatcher, synchronous ones included.
+ * 
+ * @param[in,out] object Pointer to the dispatcher
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_event_close (sat_event_dispatcher_t *const object);
+
 
 #endif/* SAT_EVENT_H_ */
@@ -1,5 +1,37 @@
 #include <sat_event.h>
 #include <string.h>
+#include <stdlib.h>
+
+#define SAT_EVENT_BUCKETS_MIN       16
+#define SAT_EVENT_OBSERVERS_MIN     4
+#define SAT_EVENT_SNAPSHOT_MIN      16
+
+struct sat_event_entry_t
+{
+    sat_event_t event;
+    sat_event_observer_map_t *map;  // registration order is notification order
+    uint32_t amount;
+    uint32_t capacity;
+    sat_event_entry_t *next;        // chain of the bucket
+};
+
+typedef struct
+{
+    const sat_event_dispatcher_t *dispatcher;
+    const void *data;               // caller's pointer, used as is when data_size is 0
+    sat_event_t event;
+    uint8_t payload [] __attribute__ ((aligned (16))); // copy of data_size bytes otherwise
+} sat_event_message_t;
+
+static sat_status_t sat_event_insert (sat_event_dispatcher_t *const object, sat_event_t event, const sat_event_observer_t *const observer);
+static sat_event_entry_t *sat_event_find (const sat_event_dispatcher_t *const object, sat_event_t event);
+static void sat_event_grow (sat_event_dispatcher_t *const object);
+static sat_status_t sat_event_notify (const sat_event_dispatcher_t *const object, sat_event_t event, const void *const data);
+static void sat_event_deliver (void *const object);
+
+// Set while a thread runs the handlers of a dispatcher, so that a removal
+// from a handler does not wait for the delivery it is part of.
+static __thread const sat_event_dispatcher_t *sat_event_delivering = NULL;
 
 sat_status_t sat_event_init (sat_event_dispatcher_t *const object)
 {
@@ -7,6 +39,55 @@ sat_status_t sat_event_init (sat_event_dispatcher_t *const object)
 
     memset (object, 0, sizeof (sat_event_dispatcher_t));
 
+    sat_status_return_on_not_equals (pthread_rwlock_init (&object->lock, NULL), 0, "lock init failed");
+    sat_status_return_on_not_equals (pthread_mutex_init (&object->delivery.lock, NULL), 0, "delivery lock init failed");
+    sat_status_return_on_not_equals (pthread_cond_init (&object->delivery.done, NULL), 0, "delivery condition init failed");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_event_open (sat_event_dispatcher_t *const object, const sat_event_args_t *const args)
+{
+    sat_status_return_on_null (object, "object pointer is NULL");
+    sat_status_return_on_null (args, "args pointer is NULL");
+    sat_status_return_on_not_equals (object->threads, 0, "dispatcher already open");
+
+    if (args->mode == sat_event_mode_sync)
+        sat_status_return_on_success ();
+
+    sat_status_return_on_equals (args->threads, 0, "zero threads");
+    sat_status_return_on_greater_than (args->data_size, SAT_EVENT_DATA_SIZE_MAX, "data size too large");
+
+    object->workers = (sat_worker_t *) calloc (args->threads, sizeof (sat_worker_t));
+    sat_status_return_on_null (object->workers, "workers allocation failed");
+
+    for (uint8_t i = 0; i < args->threads; i++)
+    {
+        // A single thread per queue keeps the events of an id in order.
+        sat_worker_init (&object->workers [i]);
+
+        sat_status_t status = sat_worker_open (&object->workers [i], &(sat_worker_args_t)
+                                                                     {
+                                                                         .pool_amount = 1,
+                                                                         .object_size = sizeof (sat_event_message_t) + args->data_size,
+                                                                         .handler = sat_event_deliver,
+                                                                         .capacity = args->capacity,
+                                                                     });
+        if (sat_status_get_result (&status) == false)
+        {
+            for (uint8_t j = 0; j < i; j++)
+                sat_worker_close (&object->workers [j]);
+
+            free (object->workers);
+            object->workers = NULL;
+
+            return status;
+        }
+    }
+
+    object->threads = args->threads;
+    object->data_size = args->data_size;
+
     sat_status_return_on_success ();
 }
 
@@ -14,13 +95,73 @@ sat_status_t sat_event_observer_add (sat_event_dispatcher_t *const object, sat_e
 {
     sat_status_return_on_null (object, "object pointer is NULL");
     sat_status_return_on_null (observer, "observer pointer is NULL");
-    sat_status_return_on_equals (object->amount, SAT_EVENT_OBSERVER_AMOUNT, "observer limit reached");
 
-    object->map [object->amount].event = event;
-    object->map [object->amount].observer = observer;
-    object->map [object->amount].context = (void *)observer;
+    pthread_rwlock_wrlock (&object->lock);
+    sat_status_t status = sat_event_insert (object, event, observer);
+    pthread_rwlock_unlock (&object->lock);
+
+    return status;
+}
+
+sat_status_t sat_event_observer_remove (sat_event_dispatcher_t *const object, sat_event_t event, const sat_event_observer_t *const observer)
+{
+    sat_status_return_on_null (object, "object pointer is NULL");
+    sat_status_return_on_null (observer, "observer pointer is NULL");
+
+    bool found = false;
+    uint32_t generation = 0;
+
+    pthread_rwlock_wrlock (&object->lock);
+
+    sat_event_entry_t **link = object->buckets == NULL ? NULL : &object->buckets [event & (object->buckets_amount - 1)];
+
+    while (link != NULL && *link != NULL && (*link)->event != event)
+        link = &(*link)->next;
+
+    if (link != NULL && *link != NULL)
+    {
+        sat_event_entry_t *entry = *link;
+
+        for (uint32_t i = 0; i < entry->amount && found == false; i++)
+        {
+            if (entry->map [i].observer == observer)
+            {
+                memmove (&entry->map [i], &entry->map [i + 1], (entry->amount - i - 1) * sizeof (sat_event_observer_map_t));
+                entry->amount --;
+                found = true;
+            }
+        }
+
+        if (entry->amount == 0)
+        {
+            *link = entry->next;
+            object->events --;
+
+            free (entry->map);
+            free (entry);
+        }
+    }
+
+    // Deliveries that start from now on have no copy of the observer.
+    pthread_mutex_lock (&object->delivery.lock);
+    generation = object->delivery.generation ++;
+    pthread_mutex_unlock (&object->delivery.lock);
+
+    pthread_rwlock_unlock (&object->lock);
 
-    object->amount ++;
+    sat_status_return_on_false (found, "observer not registered");
+
+    // Those already under way may still call it, so wait for them, unless
+    // this is one of their handlers.
+    if (sat_event_delivering != object)
+    {
+        pthread_mutex_lock (&object->delivery.lock);
+
+        while (object->delivery.amount [generation & 1] > 0)
+            pthread_cond_wait (&object->delivery.done, &object->delivery.lock);
+
+        pthread_mutex_unlock (&object->delivery.lock);
+    }
 
     sat_status_return_on_success ();
 }
@@ -29,15 +170,229 @@ sat_status_t sat_event_fire (const sat_event_dispatcher_t *const object, sat_eve
 {
     sat_status_return_on_null (object, "object pointer is NULL");
 
-    for (uint8_t i = 0; i < object->amount; i++)
+    if (object->threads == 0)
+        return sat_event_notify (object, event, data);
+
+    // Built on the stack, bounded by the largest data size: the queue copies it.
+    uint8_t buffer [sizeof (sat_event_message_t) + SAT_EVENT_DATA_SIZE_MAX] __attribute__ ((aligned (16)));
+    sat_event_message_t *message = (sat_event_message_t *) buffer;
+
+    message->dispatcher = object;
+    message->data = data;
+    message->event = event;
+
+    if (object->data_size > 0 && data != NULL)
+        memcpy (message->payload, data, object->data_size);
+
+    return sat_worker_feed (&object->workers [event % object->threads], message);
+}
+
+sat_status_t sat_event_flush (sat_event_dispatcher_t *const object)
+{
+    sat_status_return_on_null (object, "object pointer is NULL");
+
+    for (uint8_t i = 0; i < object->threads; i++)
+        sat_status_return_on_error (sat_worker_wait_idle (&object->workers [i]));
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_event_close (sat_event_dispatcher_t *const object)
+{
+    sat_status_return_on_null (object, "object pointer is NULL");
+
+    for (uint8_t i = 0; i < object->threads; i++)
     {
-        const sat_event_observer_map_t *const map = &object->map [i];
+        sat_worker_wait_idle (&object->workers [i]);
+        sat_worker_close (&object->workers [i]);
+    }
 
-        if (event == map->event)
+    free (object->workers);
+
+    for (uint32_t i = 0; i < object->buckets_amount; i++)
+    {
+        sat_event_entry_t *entry = object->buckets [i];
+
+        while (entry != NULL)
         {
-            map->observer->base.handler (map->context, data);
+            sat_event_entry_t *next = entry->next;
+
+            free (entry->map);
+            free (entry);
+
+            entry = next;
         }
     }
 
+    free (object->buckets);
+
+    pthread_rwlock_destroy (&object->lock);
+    pthread_mutex_destroy (&object->delivery.lock);
+    pthread_cond_destroy (&object->delivery.done);
+
+    memset (object, 0, sizeof (sat_event_dispatcher_t));
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_event_insert (sat_event_dispatcher_t *const object, sat_event_t event, const sat_event_observer_t *const observer)
+{
+    if (object->buckets == NULL)
+    {
+        object->buckets = (sat_event_entry_t **) calloc (SAT_EVENT_BUCKETS_MIN, sizeof (sat_event_entry_t *));
+        sat_status_return_on_null (object->buckets, "buckets allocation failed");
+
+        object->buckets_amount = SAT_EVENT_BUCKETS_MIN;
+    }
+
+    sat_event_entry_t *entry = sat_event_find (object, event);
+
+    if (entry == NULL)
+    {
+        entry = (sat_event_entry_t *) calloc (1, sizeof (sat_event_entry_t));
+        sat_status_return_on_null (entry, "entry allocation failed");
+
+        uint32_t bucket = event & (object->buckets_amount - 1);
+
+        entry->event = event;
+        entry->next = object->buckets [bucket];
+        object->buckets [bucket] = entry;
+        object->events ++;
+
+        if (object->events > object->buckets_amount)
+            sat_event_grow (object);
+    }
+
+    if (entry->amount == entry->capacity)
+    {
+        uint32_t capacity = entry->capacity == 0 ? SAT_EVENT_OBSERVERS_MIN : entry->capacity * 2;
+        sat_event_observer_map_t *map = (sat_event_observer_map_t *) realloc (entry->map, capacity * sizeof (sat_event_observer_map_t));
+
+        // An entry left empty is found again by the next registration.
+        sat_status_return_on_null (map, "observers allocation failed");
+
+        entry->map = map;
+        entry->capacity = capacity;
+    }
+
+    entry->map [entry->amount].event = event;
+    entry->map [entry->amount].observer = observer;
+    entry->map [entry->amount].context = (void *)observer;
+
+    entry->amount ++;
+
     sat_status_return_on_success ();
-}
\ No newline at end of file
+}
+
+static sat_event_entry_t *sat_event_find (const sat_event_dispatcher_t *const object, sat_event_t event)
+{
+    if (object->buckets == NULL)
+        return NULL;
+
+    // Event ids are usually small and dense, so the low bits index well.
+    sat_event_entry_t *entry = object->buckets [event & (object->buckets_amount - 1)];
+
+    while (entry != NULL && entry->event != event)
+        entry = entry->next;
+
+    return entry;
+}
+
+static void sat_event_grow (sat_event_dispatcher_t *const object)
+{
+    uint32_t buckets_amount = object->buckets_amount * 2;
+    sat_event_entry_t **buckets = (sat_event_entry_t **) calloc (buckets_amount, sizeof (sat_event_entry_t *));
+
+    // Without memory the chains just get longer.
+    if (buckets == NULL)
+        return;
+
+    for (uint32_t i = 0; i < object->buckets_amount; i++)
+    {
+        sat_event_entry_t *entry = object->buckets [i];
+
+        while (entry != NULL)
+        {
+            sat_event_entry_t *next = entry->next;
+            uint32_t bucket = entry->event & (buckets_amount - 1);
+
+            entry->next = buckets [bucket];
+            buckets [bucket] = entry;
+
+            entry = next;
+        }
+    }
+
+    free (object->buckets);
+
+    object->buckets = buckets;
+    object->buckets_amount = buckets_amount;
+}
+
+static sat_status_t sat_event_notify (const sat_event_dispatcher_t *const object, sat_event_t event, const void *const data)
+{
+    sat_event_dispatcher_t *dispatcher = (sat_event_dispatcher_t *) object;
+    sat_event_observer_map_t local [SAT_EVENT_SNAPSHOT_MIN];
+    sat_event_observer_map_t *snapshot = local;
+    uint32_t amount = 0;
+    uint32_t slot = 0;
+
+    pthread_rwlock_rdlock (&dispatcher->lock);
+
+    sat_event_entry_t *entry = sat_event_find (object, event);
+
+    if (entry != NULL && entry->amount > SAT_EVENT_SNAPSHOT_MIN)
+        snapshot = (sat_event_observer_map_t *) malloc (entry->amount * sizeof (sat_event_observer_map_t));
+
+    // Handlers run on a copy and without the lock, so they may add and
+    // remove observers, themselves included.
+    if (entry != NULL && snapshot != NULL)
+    {
+        amount = entry->amount;
+        memcpy (snapshot, entry->map, amount * sizeof (sat_event_observer_map_t));
+
+        pthread_mutex_lock (&dispatcher->delivery.lock);
+        slot = dispatcher->delivery.generation & 1;
+        dispatcher->delivery.amount [slot] ++;
+        pthread_mutex_unlock (&dispatcher->delivery.lock);
+    }
+
+    pthread_rwlock_unlock (&dispatcher->lock);
+
+    sat_status_return_on_null (snapshot, "observers copy allocation failed");
+
+    if (amount > 0)
+    {
+        const sat_event_dispatcher_t *delivering = sat_event_delivering;
+
+        sat_event_delivering = object;
+
+        for (uint32_t i = 0; i < amount; i++)
+            snapshot [i].observer->base.handler (snapshot [i].context, data);
+
+        sat_event_delivering = delivering;
+
+        pthread_mutex_lock (&dispatcher->delivery.lock);
+
+        if (-- dispatcher->delivery.amount [slot] == 0)
+            pthread_cond_broadcast (&dispatcher->delivery.done);
+
+        pthread_mutex_unlock (&dispatcher->delivery.lock);
+    }
+
+    if (snapshot != local)
+        free (snapshot);
+
+    sat_status_return_on_success ();
+}
+
+static void sat_event_deliver (void *const object)
+{
+    sat_event_message_t *message = (sat_event_message_t *) object;
+    const void *data = message->data;
+
+    if (message->dispatcher->data_size > 0 && data != NULL)
+        data = message->payload;
+
+    sat_event_notify (message->dispatcher, message->event, data);
+}
@@ -64,6 +64,9 @@ int main (int argc, char *argv[])
     status = sat_event_fire (&dispatcher, compare_event, &value);
     assert (sat_status_get_result (&status) == true);
 
+    status = sat_event_close (&dispatcher);
+    assert (sat_status_get_result (&status) == true);
+
     return 0;
 }
 
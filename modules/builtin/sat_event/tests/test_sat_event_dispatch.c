@@ -0,0 +1,292 @@
+#include <sat.h>
+#include <assert.h>
+#include <unistd.h>
+#include <time.h>
+
+#define TEST_EVENTS         500
+#define TEST_SEQUENCE       5000
+
+typedef struct
+{
+    sat_event_observer_t observer;
+    uint32_t calls;
+    uint32_t last;
+    uint32_t out_of_order;
+    uint32_t id;
+} counter_t;
+
+static uint32_t test_order [8];
+static uint32_t test_order_amount;
+
+static void count (void *object, const void *data)
+{
+    counter_t *counter = (counter_t *) object;
+
+    (void) data;
+
+    counter->calls ++;
+}
+
+static void record (void *object, const void *data)
+{
+    counter_t *counter = (counter_t *) object;
+
+    (void) data;
+
+    test_order [test_order_amount++] = counter->id;
+}
+
+static void sequence (void *object, const void *data)
+{
+    counter_t *counter = (counter_t *) object;
+    uint32_t value = *(const uint32_t *) data;
+
+    if (counter->calls > 0 && value != counter->last + 1)
+        counter->out_of_order ++;
+
+    counter->last = value;
+    counter->calls ++;
+}
+
+static void slow (void *object, const void *data)
+{
+    counter_t *counter = (counter_t *) object;
+
+    (void) data;
+
+    usleep (10000);
+    __atomic_add_fetch (&counter->calls, 1, __ATOMIC_RELAXED);
+}
+
+typedef struct
+{
+    sat_event_observer_t observer;
+    sat_event_dispatcher_t *dispatcher;
+    counter_t *follow_up;
+    uint32_t calls;
+} once_t;
+
+// Unsubscribes itself and subscribes its follow-up, from inside the handler.
+static void once (void *object, const void *data)
+{
+    once_t *once = (once_t *) object;
+
+    (void) data;
+
+    once->calls ++;
+
+    sat_status_t status = sat_event_observer_remove (once->dispatcher, 5, &once->observer);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_event_observer_add (once->dispatcher, 5, &once->follow_up->observer);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static double test_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static void test_unbounded (void)
+{
+    sat_event_dispatcher_t dispatcher;
+    static counter_t counters [TEST_EVENTS * 2];
+
+    sat_event_init (&dispatcher);
+
+    // Two observers per event, far past the old limit of ten mappings.
+    for (uint32_t i = 0; i < TEST_EVENTS * 2; i++)
+    {
+        counters [i] = (counter_t) {.observer.base.handler = count};
+
+        sat_status_t status = sat_event_observer_add (&dispatcher, (sat_event_t) (i / 2 * 7), &counters [i].observer);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    for (uint32_t i = 0; i < TEST_EVENTS; i++)
+    {
+        for (uint32_t j = 0; j <= i % 3; j++)
+            sat_event_fire (&dispatcher, (sat_event_t) (i * 7), NULL);
+    }
+
+    // Nobody listens: not an error.
+    sat_status_t status = sat_event_fire (&dispatcher, 1, NULL);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < TEST_EVENTS * 2; i++)
+        assert (counters [i].calls == i / 2 % 3 + 1);
+
+    sat_event_close (&dispatcher);
+}
+
+static void test_remove (void)
+{
+    sat_event_dispatcher_t dispatcher;
+    counter_t observers [4];
+
+    sat_event_init (&dispatcher);
+    test_order_amount = 0;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        observers [i] = (counter_t) {.observer.base.handler = record, .id = i};
+        sat_event_observer_add (&dispatcher, 3, &observers [i].observer);
+    }
+
+    sat_status_t status = sat_event_observer_remove (&dispatcher, 3, &observers [1].observer);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_event_observer_remove (&dispatcher, 3, &observers [1].observer);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_event_observer_remove (&dispatcher, 4, &observers [0].observer);
+    assert (sat_status_get_result (&status) == false);
+
+    // The others keep their registration order.
+    sat_event_fire (&dispatcher, 3, NULL);
+
+    assert (test_order_amount == 3);
+    assert (test_order [0] == 0);
+    assert (test_order [1] == 2);
+    assert (test_order [2] == 3);
+
+    for (uint32_t i = 0; i < 4; i++)
+        sat_event_observer_remove (&dispatcher, 3, &observers [i].observer);
+
+    test_order_amount = 0;
+    sat_event_fire (&dispatcher, 3, NULL);
+    assert (test_order_amount == 0);
+
+    sat_event_close (&dispatcher);
+}
+
+static void test_remove_from_handler (void)
+{
+    for (uint8_t threads = 0; threads <= 1; threads++)
+    {
+        sat_event_dispatcher_t dispatcher;
+        counter_t follow_up = {.observer.base.handler = count};
+        once_t observer = {.observer.base.handler = once, .dispatcher = &dispatcher, .follow_up = &follow_up};
+
+        sat_event_init (&dispatcher);
+
+        if (threads > 0)
+            sat_event_open (&dispatcher, &(sat_event_args_t) {.mode = sat_event_mode_async, .threads = threads});
+
+        sat_event_observer_add (&dispatcher, 5, &observer.observer);
+
+        // The first event reaches only the one-shot observer, the others only its follow-up.
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            sat_status_t status = sat_event_fire (&dispatcher, 5, NULL);
+            assert (sat_status_get_result (&status) == true);
+        }
+
+        sat_event_flush (&dispatcher);
+
+        assert (observer.calls == 1);
+        assert (follow_up.calls == 2);
+
+        sat_event_close (&dispatcher);
+    }
+}
+
+static void test_async_order (void)
+{
+    sat_event_dispatcher_t dispatcher;
+    counter_t first = {.observer.base.handler = sequence};
+    counter_t second = {.observer.base.handler = sequence};
+
+    sat_event_init (&dispatcher);
+
+    sat_status_t status = sat_event_open (&dispatcher, &(sat_event_args_t)
+                                                       {
+                                                           .mode = sat_event_mode_async,
+                                                           .threads = 2,
+                                                           .data_size = sizeof (uint32_t),
+                                                       });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_event_observer_add (&dispatcher, 10, &first.observer);
+    sat_event_observer_add (&dispatcher, 11, &second.observer);
+
+    // The payload is copied, so reusing the variable is fine.
+    for (uint32_t i = 0; i < TEST_SEQUENCE; i++)
+    {
+        status = sat_event_fire (&dispatcher, 10, &i);
+        assert (sat_status_get_result (&status) == true);
+
+        status = sat_event_fire (&dispatcher, 11, &i);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_event_flush (&dispatcher);
+    assert (sat_status_get_result (&status) == true);
+
+    assert (first.calls == TEST_SEQUENCE);
+    assert (second.calls == TEST_SEQUENCE);
+    assert (first.out_of_order == 0);
+    assert (second.out_of_order == 0);
+    assert (first.last == TEST_SEQUENCE - 1);
+
+    sat_event_close (&dispatcher);
+}
+
+static void test_async_does_not_block (void)
+{
+    sat_event_dispatcher_t dispatcher;
+    counter_t observer = {.observer.base.handler = slow};
+
+    sat_event_init (&dispatcher);
+    sat_event_open (&dispatcher, &(sat_event_args_t) {.mode = sat_event_mode_async, .threads = 1});
+    sat_event_observer_add (&dispatcher, 1, &observer.observer);
+
+    double start = test_now ();
+
+    for (int i = 0; i < 20; i++)
+        sat_event_fire (&dispatcher, 1, NULL);
+
+    // Twenty 10 ms deliveries, but the firing thread does not wait for them.
+    assert (test_now () - start < 0.1);
+
+    // Queued events are delivered on close.
+    sat_event_close (&dispatcher);
+    assert (observer.calls == 20);
+}
+
+static void test_invalid (void)
+{
+    sat_event_dispatcher_t dispatcher;
+
+    sat_event_init (&dispatcher);
+
+    sat_status_t status = sat_event_open (&dispatcher, &(sat_event_args_t) {.mode = sat_event_mode_async});
+    assert (sat_status_get_result (&status) == false);
+
+    // The queued copy of the data is built on the stack of the firing thread.
+    status = sat_event_open (&dispatcher, &(sat_event_args_t) {.mode = sat_event_mode_async, .threads = 1, .data_size = SAT_EVENT_DATA_SIZE_MAX + 1});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_event_observer_add (&dispatcher, 1, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_event_flush (&dispatcher);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_event_close (&dispatcher);
+}
+
+int main (int argc, char *argv[])
+{
+    test_unbounded ();
+    test_remove ();
+    test_remove_from_handler ();
+    test_async_order ();
+    test_async_does_not_block ();
+    test_invalid ();
+
+    return 0;
+}
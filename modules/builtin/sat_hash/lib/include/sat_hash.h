@@ -0,0 +1,90 @@
+/**
+ * @file sat_hash.h
+ * @brief Hashing helpers shared by the hashed containers
+ * @author SAT Library Contributors
+ * @date 2025
+ *
+ * Internal to the library: sat_map, sat_set, sat_cache, sat_concurrent_map
+ * and sat_scheduler use these, and the header is not installed. They are
+ * inline because they sit on every lookup.
+ */
+
+#ifndef SAT_HASH_H_
+#define SAT_HASH_H_
+
+#include <stdint.h>
+
+#define SAT_HASH_FNV_OFFSET     2166136261u
+#define SAT_HASH_FNV_PRIME      16777619u
+
+/**
+ * @brief FNV-1a over size bytes
+ */
+static inline uint32_t sat_hash_bytes (const void *const data, const uint32_t size)
+{
+    const uint8_t *bytes = (const uint8_t *) data;
+    uint32_t hash = SAT_HASH_FNV_OFFSET;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        hash ^= bytes [i];
+        hash *= SAT_HASH_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief FNV-1a over a string, up to its terminator or size bytes
+ */
+static inline uint32_t sat_hash_string (const char *const string, const uint32_t size)
+{
+    const uint8_t *bytes = (const uint8_t *) string;
+    uint32_t hash = SAT_HASH_FNV_OFFSET;
+
+    for (uint32_t i = 0; i < size && bytes [i] != 0; i++)
+    {
+        hash ^= bytes [i];
+        hash *= SAT_HASH_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Finalizer of MurmurHash3 (fmix32)
+ *
+ * Spreads weak user hashes, often the key itself, over all 32 bits, so
+ * that both the high bits (shards) and the low bits (buckets) vary.
+ */
+static inline uint32_t sat_hash_mix (uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/**
+ * @brief Smallest power of two not below value, 1 for 0
+ *
+ * Returns 0 when value is above 0x80000000, as no such power fits in 32
+ * bits; callers fail on it as too large.
+ */
+static inline uint32_t sat_hash_next_power_of_two (const uint32_t value)
+{
+    uint32_t power = 1;
+
+    if (value > 0x80000000u)
+        return 0;
+
+    while (power < value)
+        power <<= 1;
+
+    return power;
+}
+
+#endif/* SAT_HASH_H_ */
@@ -0,0 +1,59 @@
+#include <sat_hash.h>
+#include <assert.h>
+#include <stdbool.h>
+
+static void test_fnv (void)
+{
+    // Reference values of 32-bit FNV-1a.
+    assert (sat_hash_bytes ("", 0) == 0x811c9dc5u);
+    assert (sat_hash_bytes ("a", 1) == 0xe40c292cu);
+    assert (sat_hash_bytes ("foobar", 6) == 0xbf9cf968u);
+
+    // Strings stop at the terminator or the size, whichever comes first.
+    assert (sat_hash_string ("foobar", UINT32_MAX) == 0xbf9cf968u);
+    assert (sat_hash_string ("foobar\0baz", 10) == 0xbf9cf968u);
+    assert (sat_hash_string ("foobar", 1) == sat_hash_bytes ("f", 1));
+}
+
+static void test_mix (void)
+{
+    bool low_bits [16] = {false};
+    uint32_t seen = 0;
+
+    assert (sat_hash_mix (0) == 0);
+
+    // Keys that differ only in their high bits still reach every low bucket.
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t bucket = sat_hash_mix (i << 24) & 15;
+
+        if (low_bits [bucket] == false)
+        {
+            low_bits [bucket] = true;
+            seen ++;
+        }
+    }
+
+    assert (seen == 16);
+}
+
+static void test_next_power_of_two (void)
+{
+    assert (sat_hash_next_power_of_two (0) == 1);
+    assert (sat_hash_next_power_of_two (1) == 1);
+    assert (sat_hash_next_power_of_two (3) == 4);
+    assert (sat_hash_next_power_of_two (64) == 64);
+    assert (sat_hash_next_power_of_two (65) == 128);
+    assert (sat_hash_next_power_of_two (0x80000000u) == 0x80000000u);
+    assert (sat_hash_next_power_of_two (0x80000001u) == 0);
+    assert (sat_hash_next_power_of_two (UINT32_MAX) == 0);
+}
+
+int main (int argc, char *argv[])
+{
+    test_fnv ();
+    test_mix ();
+    test_next_power_of_two ();
+
+    return 0;
+}
@@ -13,6 +13,7 @@
 #define SAT_LINKED_LIST_H_
 
 #include <sat_status.h>
+#include <sat_allocator.h>
 #include <stdint.h>
 
 /**
@@ -41,6 +42,16 @@ typedef bool (*sat_linked_list_compare_t) (const void *const element, const void
  */
 typedef void  (*sat_linked_list_print_t) (const void *const element);
 
+/**
+ * @brief Configuration structure for linked list creation
+ */
+typedef struct
+{
+    uint32_t object_size;       /**< Size in bytes of each element */
+    uint32_t free_list_limit;   /**< Maximum number of removed nodes kept for reuse, 0 disables the free-list */
+    sat_allocator_t allocator;  /**< Optional allocator for the list and its nodes, zero selects the C library */
+} sat_linked_list_args_t;
+
 /**
  * @brief Creates a new linked list object
  * 
@@ -56,6 +67,22 @@ typedef void  (*sat_linked_list_print_t) (const void *const element);
  */
 sat_status_t sat_linked_list_create (sat_linked_list_t **const object, const uint32_t object_size);
 
+/**
+ * @brief Creates a new linked list object with the given configuration
+ * 
+ * Each node is a single allocation holding the link and the element inline.
+ * When free_list_limit is set, removed nodes are kept on a per-list free-list
+ * and reused by later inserts instead of going back to malloc.
+ * 
+ * @param[out] object Pointer to the pointer that will hold the created list
+ * @param[in] args Pointer to the configuration structure
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note The caller is responsible for calling sat_linked_list_destroy() to free resources
+ * @see sat_linked_list_destroy()
+ */
+sat_status_t sat_linked_list_create_with_args (sat_linked_list_t **const object, const sat_linked_list_args_t *const args);
+
 /**
  * @brief Inserts a new element into the linked list
  * 
@@ -67,7 +94,7 @@ sat_status_t sat_linked_list_create (sat_linked_list_t **const object, const uin
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @note The element is copied into the list using memcpy
- * @note Memory is automatically allocated for the new node
+ * @note The node and its element share one allocation, taken from the free-list when available
  */
 sat_status_t sat_linked_list_insert (sat_linked_list_t *const object, const void *const element);
 
@@ -83,7 +110,7 @@ sat_status_t sat_linked_list_insert (sat_linked_list_t *const object, const void
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @note Only the first matching element is removed
- * @note The memory for the removed node is freed
+ * @note The removed node is freed, or kept on the free-list if it has room
  * @see sat_linked_list_compare_t
  */
 sat_status_t sat_linked_list_remove (sat_linked_list_t *const object, sat_linked_list_compare_t compare, const void *const param);
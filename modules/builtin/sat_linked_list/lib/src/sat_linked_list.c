@@ -9,11 +9,15 @@ static void *sat_linked_list_get_next_address (const void *const object, const v
 static void *sat_linked_list_get_address (const void *const object);
 static void *sat_linked_list_get_data (const void *const address);
 static void sat_linked_list_configure_iterator (sat_linked_list_t *const object);
+static sat_linked_list_internal_t *sat_linked_list_node_acquire (sat_linked_list_t *const object);
+static void sat_linked_list_node_release (sat_linked_list_t *const object, sat_linked_list_internal_t *const node);
 
+// The payload is stored inline right after the node header, so a node is a
+// single allocation and reaching the data costs no extra pointer load.
 struct sat_linked_list_internal_t
 {
-    void *data;
     sat_linked_list_internal_t *next;
+    uint8_t data [] __attribute__ ((aligned));
 };
 
 struct sat_linked_list_t
@@ -21,10 +25,27 @@ struct sat_linked_list_t
     sat_iterator_base_t base;
     uint32_t object_size;
     uint32_t amount;
+    sat_allocator_t allocator;
     sat_linked_list_internal_t *list;
+
+    struct
+    {
+        sat_linked_list_internal_t *nodes;
+        uint32_t amount;
+        uint32_t limit;
+    } free;
 };
 
 sat_status_t sat_linked_list_create (sat_linked_list_t **const object, const uint32_t object_size)
+{
+    return sat_linked_list_create_with_args (object, &(sat_linked_list_args_t)
+                                                     {
+                                                         .object_size = object_size,
+                                                         .free_list_limit = 0
+                                                     });
+}
+
+sat_status_t sat_linked_list_create_with_args (sat_linked_list_t **const object, const sat_linked_list_args_t *const args)
 {
     sat_status_t status;
 
@@ -36,21 +57,29 @@ sat_status_t sat_linked_list_create (sat_linked_list_t **const object, const uin
             break;
         }
 
-        if (object_size == 0)
+        if (args == NULL)
+        {
+            sat_status_failure (&status, "sat liked list create error: args is NULL");
+            break;
+        }
+
+        if (args->object_size == 0)
         {
             sat_status_failure (&status, "sat liked list create error: object size is zero");
             break;
         }
 
-        *object = (sat_linked_list_t *) calloc (1, sizeof (sat_linked_list_t));
+        *object = (sat_linked_list_t *) sat_allocator_allocate_zeroed (&args->allocator, sizeof (sat_linked_list_t));
         if (*object == NULL)
         {
             sat_status_failure (&status, "sat liked list create error: allocation failed");
             break;
         }
 
-        (*object)->object_size = object_size;
+        (*object)->object_size = args->object_size;
+        (*object)->allocator = args->allocator;
         (*object)->list = NULL;
+        (*object)->free.limit = args->free_list_limit;
 
         sat_linked_list_configure_iterator (*object);
 
@@ -79,21 +108,13 @@ sat_status_t sat_linked_list_insert (sat_linked_list_t *const object, const void
             break;
         }
 
-        sat_linked_list_internal_t *_element = calloc (1, sizeof (sat_linked_list_internal_t));
+        sat_linked_list_internal_t *_element = sat_linked_list_node_acquire (object);
         if (_element == NULL)
         {
             sat_status_failure (&status, "sat liked list insert error: allocation failed");
             break;
         }
 
-        _element->data = calloc (1, object->object_size);
-        if (_element->data == NULL)
-        {
-            free (_element);
-            sat_status_failure (&status, "sat liked list insert error: data allocation failed");
-            break;
-        }
-
         memcpy (_element->data, element, object->object_size);
 
         _element->next = object->list;
@@ -132,7 +153,9 @@ sat_status_t sat_linked_list_remove (sat_linked_list_t *const object, sat_linked
         }
 
         sat_linked_list_internal_t *element = object->list;
-        sat_linked_list_internal_t *temp;
+        sat_linked_list_internal_t *temp = NULL;
+
+        sat_status_failure (&status, "sat liked list remove not found error");
 
         while (element != NULL)
         {
@@ -144,8 +167,7 @@ sat_status_t sat_linked_list_remove (sat_linked_list_t *const object, sat_linked
                 else
                     temp->next = element->next;
 
-                free (element->data);
-                free (element);
+                sat_linked_list_node_release (object, element);
 
                 object->amount --;
 
@@ -380,17 +402,28 @@ sat_status_t sat_linked_list_destroy (sat_linked_list_t *const object)
         }
 
         sat_linked_list_internal_t *element = object->list;
+        size_t node_size = sizeof (sat_linked_list_internal_t) + object->object_size;
 
         while (element != NULL)
         {
             sat_linked_list_internal_t *temp = element->next;
-            free (element->data);
-            free (element);
+            sat_allocator_release (&object->allocator, element, node_size);
 
             element = temp;
         }
 
-        free (object);
+        element = object->free.nodes;
+
+        while (element != NULL)
+        {
+            sat_linked_list_internal_t *temp = element->next;
+            sat_allocator_release (&object->allocator, element, node_size);
+
+            element = temp;
+        }
+
+        sat_allocator_t allocator = object->allocator;
+        sat_allocator_release (&allocator, object, sizeof (sat_linked_list_t));
 
         sat_status_success (&status);
 
@@ -399,6 +432,35 @@ sat_status_t sat_linked_list_destroy (sat_linked_list_t *const object)
     return status;
 }
 
+static sat_linked_list_internal_t *sat_linked_list_node_acquire (sat_linked_list_t *const object)
+{
+    sat_linked_list_internal_t *node = object->free.nodes;
+
+    if (node != NULL)
+    {
+        object->free.nodes = node->next;
+        object->free.amount --;
+
+        return node;
+    }
+
+    return (sat_linked_list_internal_t *) sat_allocator_allocate (&object->allocator, sizeof (sat_linked_list_internal_t) + object->object_size);
+}
+
+static void sat_linked_list_node_release (sat_linked_list_t *const object, sat_linked_list_internal_t *const node)
+{
+    if (object->free.amount < object->free.limit)
+    {
+        node->next = object->free.nodes;
+        object->free.nodes = node;
+        object->free.amount ++;
+    }
+    else
+    {
+        sat_allocator_release (&object->allocator, node, sizeof (sat_linked_list_internal_t) + object->object_size);
+    }
+}
+
 static void sat_linked_list_configure_iterator (sat_linked_list_t *const object)
 {
     object->base.object = object;
@@ -0,0 +1,130 @@
+#include <sat.h>
+#include <assert.h>
+#include <stdint.h>
+
+typedef struct
+{
+    uint64_t id;
+    double value;
+} node_item_t;
+
+static bool compare_id (const void *const element, const void *const data)
+{
+    return ((const node_item_t *) element)->id == *(const uint64_t *) data;
+}
+
+static void test_inline_payload (void)
+{
+    sat_linked_list_t *list = NULL;
+    sat_status_t status = sat_linked_list_create (&list, sizeof (node_item_t));
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        node_item_t item = {.id = i, .value = (double) i / 2};
+        status = sat_linked_list_insert (list, &item);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    for (uint64_t i = 0; i < 1000; i += 111)
+    {
+        node_item_t *reference = NULL;
+        status = sat_linked_list_get_ref (list, compare_id, &i, (void **) &reference);
+        assert (sat_status_get_result (&status) == true);
+        assert (((uintptr_t) reference % sizeof (double)) == 0);
+        assert (reference->value == (double) i / 2);
+    }
+
+    // Iteration visits every inline payload once.
+    sat_iterator_t iterator;
+    status = sat_iterator_open (&iterator, (sat_iterator_base_t *) list);
+    assert (sat_status_get_result (&status) == true);
+
+    uint64_t sum = 0;
+    uint32_t count = 0;
+    node_item_t *current = (node_item_t *) sat_iterator_next (&iterator);
+
+    while (current != NULL)
+    {
+        sum += current->id;
+        count ++;
+        current = (node_item_t *) sat_iterator_next (&iterator);
+    }
+
+    assert (count == 1000);
+    assert (sum == 999 * 1000 / 2);
+
+    uint64_t missing = 5000;
+    status = sat_linked_list_remove (list, compare_id, &missing);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_linked_list_destroy (list);
+}
+
+static void test_free_list_reuse (void)
+{
+    sat_linked_list_t *list = NULL;
+    sat_status_t status;
+
+    status = sat_linked_list_create_with_args (&list, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_linked_list_create_with_args (&list, &(sat_linked_list_args_t) {.object_size = 0});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_linked_list_create_with_args (&list, &(sat_linked_list_args_t)
+                                                      {
+                                                          .object_size = sizeof (node_item_t),
+                                                          .free_list_limit = 2
+                                                      });
+    assert (sat_status_get_result (&status) == true);
+
+    node_item_t item = {.id = 1, .value = 1.0};
+    sat_linked_list_insert (list, &item);
+
+    node_item_t *first = NULL;
+    sat_linked_list_get_ref (list, compare_id, &item.id, (void **) &first);
+
+    status = sat_linked_list_remove (list, compare_id, &item.id);
+    assert (sat_status_get_result (&status) == true);
+
+    // The released node is handed back by the next insert.
+    item.id = 2;
+    sat_linked_list_insert (list, &item);
+
+    node_item_t *second = NULL;
+    status = sat_linked_list_get_ref (list, compare_id, &item.id, (void **) &second);
+    assert (sat_status_get_result (&status) == true);
+    assert (second == first);
+    assert (second->id == 2);
+
+    // Churn past the free-list limit.
+    for (uint64_t round = 0; round < 100; round++)
+    {
+        for (uint64_t i = 10; i < 20; i++)
+        {
+            item.id = i;
+            sat_linked_list_insert (list, &item);
+        }
+
+        for (uint64_t i = 10; i < 20; i++)
+        {
+            status = sat_linked_list_remove (list, compare_id, &i);
+            assert (sat_status_get_result (&status) == true);
+        }
+    }
+
+    uint32_t size = 0;
+    sat_linked_list_get_size (list, &size);
+    assert (size == 1);
+
+    sat_linked_list_destroy (list);
+}
+
+int main (int argc, char *argv[])
+{
+    test_inline_payload ();
+    test_free_list_reuse ();
+
+    return 0;
+}
@@ -2,33 +2,92 @@
 #define SAT_MAP_H_
 
 #include <sat_status.h>
+#include <sat_allocator.h>
 #include <stdint.h>
 
+#define SAT_MAP_LIST_SIZE_MAX       (1u << 30)      /**< Largest list_size, so the hashed table fits in 32 bits */
+
 typedef struct sat_map_t sat_map_t;
 
 typedef bool (*sat_map_compare_t) (void *key, void *data);
 typedef void (*sat_map_print_t) (const void *key, const void *value);
 
+/**
+ * @brief Hash function type used by the hashed mode
+ *
+ * @param key Pointer to the key to be hashed
+ * @param key_size Size in bytes of the key as configured in sat_map_args_t
+ * @return 32-bit hash of the key
+ */
+typedef uint32_t (*sat_map_hash_t) (const void *const key, const uint32_t key_size);
+
 typedef enum
 {
     sat_map_mode_static,
     sat_map_mode_dynamic,
 } sat_map_mode_t;
 
+/**
+ * @brief Configuration structure for map creation
+ *
+ * When @c hash is set the map switches to open addressing: keys and values
+ * are stored inline in one contiguous slot array, lookups are O(1) on average
+ * and growth is spread over subsequent operations (incremental rehash).
+ * In that mode @c list_size is the expected amount of entries, which is also
+ * the hard limit when @c mode is sat_map_mode_static. @c list_size may not
+ * exceed SAT_MAP_LIST_SIZE_MAX.
+ */
 typedef struct
 {
     uint32_t key_size;
     uint32_t value_size;
     uint32_t list_size;
     sat_map_mode_t mode;
+    sat_map_hash_t hash;            /**< Optional hash function, enables the hashed mode */
+    sat_map_compare_t compare;      /**< Optional key equality for the hashed mode, defaults to a byte comparison */
+    sat_allocator_t allocator;      /**< Optional allocator for the map, its table and its entries, zero selects the C library */
 } sat_map_args_t;
 
 sat_status_t sat_map_create (sat_map_t **object, sat_map_args_t *args);
+
+/**
+ * @brief Adds a key/value pair to the map
+ *
+ * @note In the hashed mode an existing key has its value replaced.
+ */
 sat_status_t sat_map_add (sat_map_t *object, void *key, void *value);
+
+/**
+ * @brief Removes a key from the map
+ *
+ * @note In the hashed mode @p compare may be NULL, in which case the
+ *       equality configured on creation is used.
+ */
 sat_status_t sat_map_remove (sat_map_t *object, void *key, sat_map_compare_t compare);
 sat_status_t sat_map_get_size (sat_map_t *object, uint32_t *size);
+
+/**
+ * @brief Copies the value associated with a key
+ *
+ * @note In the hashed mode @p compare may be NULL, in which case the
+ *       equality configured on creation is used.
+ */
 sat_status_t sat_map_get_value_by (sat_map_t *object, const void *key, void *value, sat_map_compare_t compare);
 sat_status_t sat_map_debug (sat_map_t *object, sat_map_print_t print);
 sat_status_t sat_map_destroy (sat_map_t *object);
 
+/**
+ * @brief Built-in hash for fixed-size keys (FNV-1a over key_size bytes)
+ */
+uint32_t sat_map_hash_bytes (const void *const key, const uint32_t key_size);
+
+/**
+ * @brief Built-in hash for NUL-terminated string keys
+ *
+ * Hashes up to the terminator or key_size bytes, whichever comes first.
+ * Selecting it also makes the map copy and compare keys as strings, so a
+ * lookup key does not need to be key_size bytes long.
+ */
+uint32_t sat_map_hash_string (const void *const key, const uint32_t key_size);
+
 #endif/* SAT_MAP_H_ */
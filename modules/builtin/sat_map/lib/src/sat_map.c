@@ -2,6 +2,12 @@
 #include <string.h>
 #include <stdlib.h>
 #include <sat_array.h>
+#include <sat_hash.h>
+
+#define SAT_MAP_HASH_ALIGN           8
+#define SAT_MAP_HASH_MIN_CAPACITY    8
+#define SAT_MAP_HASH_REHASH_STEP     32
+
 
 typedef struct 
 {
@@ -9,6 +15,27 @@ typedef struct
     void *value;
 } sat_map_item_t;
 
+typedef enum
+{
+    sat_map_slot_state_empty,
+    sat_map_slot_state_used,
+    sat_map_slot_state_deleted,
+} sat_map_slot_state_t;
+
+typedef struct
+{
+    uint32_t hash;
+    uint8_t state;
+} sat_map_slot_t;
+
+typedef struct
+{
+    uint8_t *slots;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t deleted;
+} sat_map_table_t;
+
 struct sat_map_t
 {
     uint32_t key_size;
@@ -16,13 +43,37 @@ struct sat_map_t
     uint32_t list_size;
     sat_array_t *array;
     sat_map_mode_t mode;
+    sat_allocator_t allocator;
+
+    struct
+    {
+        sat_map_hash_t function;
+        sat_map_compare_t compare;
+        bool is_string;
+        uint32_t key_offset;
+        uint32_t value_offset;
+        uint32_t slot_size;
+        uint32_t min_capacity;
+        sat_map_table_t active;
+        sat_map_table_t old;
+        uint32_t migrate_index;
+        bool rehashing;
+    } hash;
 };
 
 static sat_status_t sat_map_is_args_valid (sat_map_args_t *args);
 static void sat_map_set_context (sat_map_t *object, sat_map_args_t *args);
 static sat_status_t sat_map_buffer_allocate (sat_map_t *object);
 static sat_status_t sat_map_alloc_item (sat_map_t *object, sat_map_item_t *item);
-static sat_status_t sat_map_destroy_item (sat_map_item_t *item);
+static sat_status_t sat_map_destroy_item (sat_map_t *object, sat_map_item_t *item);
+
+static sat_status_t sat_map_hash_create (sat_map_t *const object);
+static sat_status_t sat_map_hash_add (sat_map_t *const object, const void *const key, const void *const value);
+static sat_status_t sat_map_hash_remove (sat_map_t *const object, const void *const key, sat_map_compare_t compare);
+static sat_status_t sat_map_hash_get_value_by (sat_map_t *const object, const void *const key, void *const value, sat_map_compare_t compare);
+static void sat_map_hash_debug (sat_map_t *const object, sat_map_print_t print);
+static void sat_map_hash_destroy (sat_map_t *const object);
+static uint32_t sat_map_hash_get_size (const sat_map_t *const object);
 
 sat_status_t sat_map_create (sat_map_t **object, sat_map_args_t *args)
 {
@@ -40,16 +91,19 @@ sat_status_t sat_map_create (sat_map_t **object, sat_map_args_t *args)
 
         sat_status_set (&status, false, __func__, "sat map allocation error");
 
-        sat_map_t *__object = calloc (1, sizeof (sat_map_t));
+        sat_map_t *__object = sat_allocator_allocate_zeroed (&args->allocator, sizeof (sat_map_t));
         if (__object == NULL)
             break;
 
         sat_map_set_context (__object, args);
 
-        status = sat_map_buffer_allocate (__object);
+        if (__object->hash.function != NULL)
+            status = sat_map_hash_create (__object);
+        else
+            status = sat_map_buffer_allocate (__object);
         if (sat_status_get_result (&status) == false)
         {
-            free (__object);
+            sat_allocator_release (&args->allocator, __object, sizeof (sat_map_t));
             break;
         }
 
@@ -66,7 +120,12 @@ sat_status_t sat_map_add (sat_map_t *object, void *key, void *value)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat map add error");
 
-    if (object != NULL && key != NULL && value != NULL)
+    if (object != NULL && key != NULL && value != NULL && object->hash.function != NULL)
+    {
+        status = sat_map_hash_add (object, key, value);
+    }
+
+    else if (object != NULL && key != NULL && value != NULL)
     {
         sat_map_item_t item;
 
@@ -79,7 +138,7 @@ sat_status_t sat_map_add (sat_map_t *object, void *key, void *value)
             status = sat_array_add (object->array, (void *)&item);
             if (sat_status_get_result (&status) == false)
             {
-                sat_map_destroy_item (&item);
+                sat_map_destroy_item (object, &item);
             }
         }
     }
@@ -91,7 +150,12 @@ sat_status_t sat_map_remove (sat_map_t *object, void *key, sat_map_compare_t com
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat map remove error");
 
-    if (object != NULL && key != NULL && compare != NULL)
+    if (object != NULL && key != NULL && object->hash.function != NULL)
+    {
+        status = sat_map_hash_remove (object, key, compare);
+    }
+
+    else if (object != NULL && key != NULL && compare != NULL)
     {
         uint32_t size;
 
@@ -104,8 +168,7 @@ sat_status_t sat_map_remove (sat_map_t *object, void *key, sat_map_compare_t com
 
             if (compare (item.key, (void *)key) == true)
             {
-                free (item.key);
-                free (item.value);
+                sat_map_destroy_item (object, &item);
 
                 status = sat_array_remove_by (object->array, i);
                 break;
@@ -120,7 +183,13 @@ sat_status_t sat_map_get_size (sat_map_t *object, uint32_t *size)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat map get size error");
 
-    if (object != NULL && size != NULL)
+    if (object != NULL && size != NULL && object->hash.function != NULL)
+    {
+        *size = sat_map_hash_get_size (object);
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    else if (object != NULL && size != NULL)
     {
         status = sat_array_get_size (object->array, size);
     }
@@ -132,7 +201,12 @@ sat_status_t sat_map_get_value_by (sat_map_t *object, const void *key, void *val
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat map get value by error");
 
-    if (object != NULL && key != NULL && value != NULL && compare != NULL)
+    if (object != NULL && key != NULL && value != NULL && object->hash.function != NULL)
+    {
+        status = sat_map_hash_get_value_by (object, key, value, compare);
+    }
+
+    else if (object != NULL && key != NULL && value != NULL && compare != NULL)
     {
         uint32_t size;
 
@@ -159,7 +233,13 @@ sat_status_t sat_map_debug (sat_map_t *object, sat_map_print_t print)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat map debug error");
 
-    if (object != NULL && print != NULL)
+    if (object != NULL && print != NULL && object->hash.function != NULL)
+    {
+        sat_map_hash_debug (object, print);
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    else if (object != NULL && print != NULL)
     {
         uint32_t size;
 
@@ -183,7 +263,16 @@ sat_status_t sat_map_destroy (sat_map_t *object)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat map destroy error");
 
-    if (object != NULL)
+    if (object != NULL && object->hash.function != NULL)
+    {
+        sat_allocator_t allocator = object->allocator;
+
+        sat_map_hash_destroy (object);
+        sat_allocator_release (&allocator, object, sizeof (sat_map_t));
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    else if (object != NULL)
     {
         uint32_t size;
 
@@ -194,11 +283,13 @@ sat_status_t sat_map_destroy (sat_map_t *object)
             sat_map_item_t item;
             sat_array_get_object_by (object->array, i, &item);
 
-            status = sat_map_destroy_item (&item);
+            status = sat_map_destroy_item (object, &item);
         }
 
+        sat_allocator_t allocator = object->allocator;
+
         status = sat_array_destroy (object->array);
-        free (object);
+        sat_allocator_release (&allocator, object, sizeof (sat_map_t));
     }
 
     return status;
@@ -211,7 +302,8 @@ static sat_status_t sat_map_is_args_valid (sat_map_args_t *args)
     if (args != NULL &&
         args->key_size > 0 &&
         args->value_size > 0 &&
-        args->list_size > 0)
+        args->list_size > 0 &&
+        args->list_size <= SAT_MAP_LIST_SIZE_MAX)
     {
         sat_status_set (&status, true, __func__, "");
     }
@@ -225,6 +317,10 @@ static void sat_map_set_context (sat_map_t *object, sat_map_args_t *args)
     object->value_size = args->value_size;
     object->list_size = args->list_size;
     object->mode = args->mode;
+    object->allocator = args->allocator;
+    object->hash.function = args->hash;
+    object->hash.compare = args->compare;
+    object->hash.is_string = args->hash == sat_map_hash_string;
 }
 
 static sat_status_t sat_map_buffer_allocate (sat_map_t *object)
@@ -233,7 +329,8 @@ static sat_status_t sat_map_buffer_allocate (sat_map_t *object)
                                              {
                                                 .size = object->list_size,
                                                 .object_size = sizeof (sat_map_item_t),
-                                                .mode = (sat_array_mode_t) object->mode
+                                                .mode = (sat_array_mode_t) object->mode,
+                                                .allocator = object->allocator
                                              });
 }
 
@@ -243,14 +340,14 @@ static sat_status_t sat_map_alloc_item (sat_map_t *object, sat_map_item_t *item)
 
     if (object != NULL && item != NULL)
     {
-        item->key = calloc (1, object->key_size);
+        item->key = sat_allocator_allocate_zeroed (&object->allocator, object->key_size);
         if (item->key == NULL)
             return sat_status_set (&status, false, __func__, "sat map key allocation error");
 
-        item->value = calloc (1, object->value_size);
+        item->value = sat_allocator_allocate_zeroed (&object->allocator, object->value_size);
         if (item->value == NULL)
         {
-            free(item->key);
+            sat_allocator_release (&object->allocator, item->key, object->key_size);
             return sat_status_set (&status, false, __func__, "sat map value allocation error");
         }
 
@@ -260,18 +357,382 @@ static sat_status_t sat_map_alloc_item (sat_map_t *object, sat_map_item_t *item)
     return status;
 }
 
-static sat_status_t sat_map_destroy_item (sat_map_item_t *item)
+static sat_status_t sat_map_destroy_item (sat_map_t *object, sat_map_item_t *item)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat map destroy item error");
 
     if (item != NULL && item->key != NULL && item->value != NULL)
     {
-        free(item->key);
+        sat_allocator_release (&object->allocator, item->key, object->key_size);
 
-        free(item->value);
+        sat_allocator_release (&object->allocator, item->value, object->value_size);
 
         sat_status_set (&status, true, __func__, "");
     }
 
     return status;
-}
\ No newline at end of file
+}
+
+uint32_t sat_map_hash_bytes (const void *const key, const uint32_t key_size)
+{
+    return sat_hash_bytes (key, key_size);
+}
+
+uint32_t sat_map_hash_string (const void *const key, const uint32_t key_size)
+{
+    return sat_hash_string ((const char *) key, key_size);
+}
+
+static uint32_t sat_map_hash_align (uint32_t size)
+{
+    return (size + SAT_MAP_HASH_ALIGN - 1) & ~(uint32_t) (SAT_MAP_HASH_ALIGN - 1);
+}
+
+static uint32_t sat_map_hash_next_power_of_two (uint64_t value)
+{
+    // 0 for a table too large to address with 32 bits
+    if (value > UINT32_MAX)
+        return 0;
+
+    return sat_hash_next_power_of_two (value > SAT_MAP_HASH_MIN_CAPACITY ? (uint32_t) value : SAT_MAP_HASH_MIN_CAPACITY);
+}
+
+static bool sat_map_hash_is_full (const sat_map_table_t *const table)
+{
+    // keep the load factor, tombstones included, under 75%
+    return ((uint64_t) table->used + table->deleted + 1) * 4 > (uint64_t) table->capacity * 3;
+}
+
+static uint32_t sat_map_hash_compute (const sat_map_t *const object, const void *const key)
+{
+    // mix the user hash so weak functions (e.g. identity) still spread over the table
+    return sat_hash_mix (object->hash.function (key, object->key_size));
+}
+
+static inline sat_map_slot_t *sat_map_hash_slot_at (const sat_map_t *const object, const sat_map_table_t *const table, uint32_t index)
+{
+    return (sat_map_slot_t *) &table->slots [(size_t) index * object->hash.slot_size];
+}
+
+static inline uint8_t *sat_map_hash_slot_key (const sat_map_t *const object, sat_map_slot_t *const slot)
+{
+    return (uint8_t *) slot + object->hash.key_offset;
+}
+
+static inline uint8_t *sat_map_hash_slot_value (const sat_map_t *const object, sat_map_slot_t *const slot)
+{
+    return (uint8_t *) slot + object->hash.value_offset;
+}
+
+static bool sat_map_hash_is_key_equal (const sat_map_t *const object, const void *const stored, const void *const key, sat_map_compare_t compare)
+{
+    if (compare == NULL)
+        compare = object->hash.compare;
+
+    if (compare != NULL)
+        return compare ((void *) stored, (void *) key);
+
+    if (object->hash.is_string == true)
+        return strncmp ((const char *) stored, (const char *) key, object->key_size) == 0;
+
+    return memcmp (stored, key, object->key_size) == 0;
+}
+
+static void sat_map_hash_copy_key (const sat_map_t *const object, uint8_t *const destination, const void *const key)
+{
+    if (object->hash.is_string == true)
+    {
+        size_t length = strnlen ((const char *) key, object->key_size);
+
+        memcpy (destination, key, length);
+        memset (destination + length, 0, object->key_size - length);
+    }
+    else
+    {
+        memcpy (destination, key, object->key_size);
+    }
+}
+
+static sat_status_t sat_map_hash_table_create (const sat_map_t *const object, sat_map_table_t *const table, uint32_t capacity)
+{
+    table->slots = sat_allocator_allocate_zeroed (&object->allocator, (size_t) capacity * object->hash.slot_size);
+    sat_status_return_on_null (table->slots, "sat map hash table allocation error");
+
+    table->capacity = capacity;
+    table->used = 0;
+    table->deleted = 0;
+
+    sat_status_return_on_success ();
+}
+
+static void sat_map_hash_table_destroy (const sat_map_t *const object, sat_map_table_t *const table)
+{
+    sat_allocator_release (&object->allocator, table->slots, (size_t) table->capacity * object->hash.slot_size);
+    memset (table, 0, sizeof (sat_map_table_t));
+}
+
+static sat_map_slot_t *sat_map_hash_table_find (const sat_map_t *const object,
+                                                const sat_map_table_t *const table,
+                                                const void *const key,
+                                                uint32_t hash,
+                                                sat_map_compare_t compare)
+{
+    uint32_t mask = table->capacity - 1;
+
+    for (uint32_t probe = 0, index = hash & mask; probe < table->capacity; probe++, index = (index + 1) & mask)
+    {
+        sat_map_slot_t *slot = sat_map_hash_slot_at (object, table, index);
+
+        if (slot->state == sat_map_slot_state_empty)
+            break;
+
+        sat_status_continue_on_not_equals (slot->state, sat_map_slot_state_used);
+        sat_status_continue_on_not_equals (slot->hash, hash);
+
+        if (sat_map_hash_is_key_equal (object, sat_map_hash_slot_key (object, slot), key, compare) == true)
+            return slot;
+    }
+
+    return NULL;
+}
+
+static sat_map_slot_t *sat_map_hash_table_reserve (const sat_map_t *const object, sat_map_table_t *const table, uint32_t hash)
+{
+    uint32_t mask = table->capacity - 1;
+    uint32_t index = hash & mask;
+    sat_map_slot_t *slot = sat_map_hash_slot_at (object, table, index);
+
+    // the caller guarantees the key is absent and the load factor leaves free slots
+    while (slot->state == sat_map_slot_state_used)
+    {
+        index = (index + 1) & mask;
+        slot = sat_map_hash_slot_at (object, table, index);
+    }
+
+    if (slot->state == sat_map_slot_state_deleted)
+        table->deleted --;
+
+    slot->state = sat_map_slot_state_used;
+    slot->hash = hash;
+    table->used ++;
+
+    return slot;
+}
+
+static sat_map_slot_t *sat_map_hash_find (sat_map_t *const object,
+                                          const void *const key,
+                                          uint32_t hash,
+                                          sat_map_compare_t compare,
+                                          sat_map_table_t **const table)
+{
+    sat_map_slot_t *slot = sat_map_hash_table_find (object, &object->hash.active, key, hash, compare);
+    *table = &object->hash.active;
+
+    if (slot == NULL && object->hash.rehashing == true)
+    {
+        slot = sat_map_hash_table_find (object, &object->hash.old, key, hash, compare);
+        *table = &object->hash.old;
+    }
+
+    return slot;
+}
+
+static void sat_map_hash_move (sat_map_t *const object, sat_map_slot_t *const slot, sat_map_table_t *const from, sat_map_table_t *const to)
+{
+    sat_map_slot_t *moved = sat_map_hash_table_reserve (object, to, slot->hash);
+
+    memcpy ((uint8_t *) moved + object->hash.key_offset,
+            (uint8_t *) slot + object->hash.key_offset,
+            object->hash.slot_size - object->hash.key_offset);
+
+    slot->state = sat_map_slot_state_deleted;
+    from->used --;
+}
+
+static void sat_map_hash_migrate (sat_map_t *const object, uint32_t amount)
+{
+    sat_map_table_t *old = &object->hash.old;
+
+    while (object->hash.rehashing == true && amount > 0)
+    {
+        if (object->hash.migrate_index == old->capacity || old->used == 0)
+        {
+            sat_map_hash_table_destroy (object, old);
+            object->hash.rehashing = false;
+            break;
+        }
+
+        sat_map_slot_t *slot = sat_map_hash_slot_at (object, old, object->hash.migrate_index ++);
+        amount --;
+
+        sat_status_continue_on_not_equals (slot->state, sat_map_slot_state_used);
+
+        sat_map_hash_move (object, slot, old, &object->hash.active);
+    }
+}
+
+static uint32_t sat_map_hash_get_capacity_for (const sat_map_t *const object, uint32_t entries)
+{
+    uint32_t capacity = object->hash.active.capacity;
+
+    if (object->mode == sat_map_mode_dynamic)
+    {
+        capacity = sat_map_hash_next_power_of_two (((uint64_t) entries + 1) * 2);
+
+        if (capacity != 0 && capacity < object->hash.min_capacity)
+            capacity = object->hash.min_capacity;
+    }
+
+    return capacity;
+}
+
+static void sat_map_hash_table_move_all (sat_map_t *const object, sat_map_table_t *const from, sat_map_table_t *const to)
+{
+    for (uint32_t i = 0; i < from->capacity && from->used > 0; i++)
+    {
+        sat_map_slot_t *slot = sat_map_hash_slot_at (object, from, i);
+
+        sat_status_continue_on_not_equals (slot->state, sat_map_slot_state_used);
+
+        sat_map_hash_move (object, slot, from, to);
+    }
+}
+
+static sat_status_t sat_map_hash_start_rehash (sat_map_t *const object)
+{
+    sat_map_table_t table;
+    uint32_t entries = sat_map_hash_get_size (object);
+    uint32_t capacity = sat_map_hash_get_capacity_for (object, entries);
+
+    sat_status_return_on_equals (capacity, 0, "sat map hash table too large");
+    sat_status_return_on_error (sat_map_hash_table_create (object, &table, capacity));
+
+    if (object->hash.rehashing == true)
+    {
+        // the active table filled up before the previous rehash drained,
+        // fold both tables into the new one at once (rare slow path)
+        sat_map_hash_table_move_all (object, &object->hash.old, &table);
+        sat_map_hash_table_move_all (object, &object->hash.active, &table);
+
+        sat_map_hash_table_destroy (object, &object->hash.old);
+        sat_map_hash_table_destroy (object, &object->hash.active);
+
+        object->hash.active = table;
+        object->hash.rehashing = false;
+
+        sat_status_return_on_success ();
+    }
+
+    object->hash.old = object->hash.active;
+    object->hash.active = table;
+    object->hash.migrate_index = 0;
+    object->hash.rehashing = true;
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_map_hash_create (sat_map_t *const object)
+{
+    object->hash.key_offset = sat_map_hash_align (sizeof (sat_map_slot_t));
+    object->hash.value_offset = object->hash.key_offset + sat_map_hash_align (object->key_size);
+    object->hash.slot_size = object->hash.value_offset + sat_map_hash_align (object->value_size);
+    object->hash.min_capacity = sat_map_hash_next_power_of_two ((uint64_t) object->list_size * 4 / 3 + 1);
+
+    sat_status_return_on_equals (object->hash.min_capacity, 0, "sat map hash table too large");
+
+    return sat_map_hash_table_create (object, &object->hash.active, object->hash.min_capacity);
+}
+
+static sat_status_t sat_map_hash_add (sat_map_t *const object, const void *const key, const void *const value)
+{
+    sat_map_table_t *table = NULL;
+
+    sat_map_hash_migrate (object, SAT_MAP_HASH_REHASH_STEP);
+
+    uint32_t hash = sat_map_hash_compute (object, key);
+    sat_map_slot_t *slot = sat_map_hash_find (object, key, hash, NULL, &table);
+
+    if (slot == NULL)
+    {
+        if (object->mode == sat_map_mode_static && sat_map_hash_get_size (object) >= object->list_size)
+            sat_status_return_on_failure ("sat map is full");
+
+        if (sat_map_hash_is_full (&object->hash.active) == true)
+            sat_status_return_on_error (sat_map_hash_start_rehash (object));
+
+        slot = sat_map_hash_table_reserve (object, &object->hash.active, hash);
+        sat_map_hash_copy_key (object, sat_map_hash_slot_key (object, slot), key);
+    }
+
+    memcpy (sat_map_hash_slot_value (object, slot), value, object->value_size);
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_map_hash_remove (sat_map_t *const object, const void *const key, sat_map_compare_t compare)
+{
+    sat_map_table_t *table = NULL;
+
+    sat_map_hash_migrate (object, SAT_MAP_HASH_REHASH_STEP);
+
+    sat_map_slot_t *slot = sat_map_hash_find (object, key, sat_map_hash_compute (object, key), compare, &table);
+    sat_status_return_on_null (slot, "sat map key not found");
+
+    slot->state = sat_map_slot_state_deleted;
+    table->used --;
+    table->deleted ++;
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_map_hash_get_value_by (sat_map_t *const object, const void *const key, void *const value, sat_map_compare_t compare)
+{
+    sat_map_table_t *table = NULL;
+
+    sat_map_slot_t *slot = sat_map_hash_find (object, key, sat_map_hash_compute (object, key), compare, &table);
+    sat_status_return_on_null (slot, "sat map key not found");
+
+    memcpy (value, sat_map_hash_slot_value (object, slot), object->value_size);
+
+    sat_status_return_on_success ();
+}
+
+static void sat_map_hash_table_debug (sat_map_t *const object, const sat_map_table_t *const table, sat_map_print_t print)
+{
+    for (uint32_t i = 0; i < table->capacity; i++)
+    {
+        sat_map_slot_t *slot = sat_map_hash_slot_at (object, table, i);
+
+        sat_status_continue_on_not_equals (slot->state, sat_map_slot_state_used);
+
+        print (sat_map_hash_slot_key (object, slot), sat_map_hash_slot_value (object, slot));
+    }
+}
+
+static void sat_map_hash_debug (sat_map_t *const object, sat_map_print_t print)
+{
+    sat_map_hash_table_debug (object, &object->hash.active, print);
+
+    if (object->hash.rehashing == true)
+        sat_map_hash_table_debug (object, &object->hash.old, print);
+}
+
+static void sat_map_hash_destroy (sat_map_t *const object)
+{
+    sat_map_hash_table_destroy (object, &object->hash.active);
+
+    if (object->hash.rehashing == true)
+        sat_map_hash_table_destroy (object, &object->hash.old);
+
+    object->hash.rehashing = false;
+}
+
+static uint32_t sat_map_hash_get_size (const sat_map_t *const object)
+{
+    uint32_t size = object->hash.active.used;
+
+    if (object->hash.rehashing == true)
+        size += object->hash.old.used;
+
+    return size;
+}
@@ -0,0 +1,199 @@
+#include <sat.h>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_MAP_HASH_AMOUNT    20000
+
+typedef struct
+{
+    char name [32];
+    int port;
+} service_t;
+
+static void test_map_hash_fixed_size_keys (void)
+{
+    sat_map_t *map;
+    uint32_t size;
+
+    sat_status_t status = sat_map_create (&map, &(sat_map_args_t)
+                                                {
+                                                    .list_size = 4,
+                                                    .key_size = sizeof (int),
+                                                    .value_size = sizeof (int),
+                                                    .mode = sat_map_mode_dynamic,
+                                                    .hash = sat_map_hash_bytes
+                                                });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < TEST_MAP_HASH_AMOUNT; i++)
+    {
+        status = sat_map_add (map, &i, &(int){i * 2});
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_map_get_size (map, &size);
+    assert (sat_status_get_result (&status) == true);
+    assert (size == TEST_MAP_HASH_AMOUNT);
+
+    for (int i = 0; i < TEST_MAP_HASH_AMOUNT; i++)
+    {
+        int value = 0;
+
+        status = sat_map_get_value_by (map, &i, &value, NULL);
+        assert (sat_status_get_result (&status) == true);
+        assert (value == i * 2);
+    }
+
+    // replacing an existing key keeps the size
+    status = sat_map_add (map, &(int){7}, &(int){700});
+    assert (sat_status_get_result (&status) == true);
+
+    int value = 0;
+    status = sat_map_get_value_by (map, &(int){7}, &value, NULL);
+    assert (sat_status_get_result (&status) == true);
+    assert (value == 700);
+
+    // remove the even keys
+    for (int i = 0; i < TEST_MAP_HASH_AMOUNT; i += 2)
+    {
+        status = sat_map_remove (map, &i, NULL);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_map_get_size (map, &size);
+    assert (sat_status_get_result (&status) == true);
+    assert (size == TEST_MAP_HASH_AMOUNT / 2);
+
+    status = sat_map_get_value_by (map, &(int){2}, &value, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_map_remove (map, &(int){2}, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_map_get_value_by (map, &(int){3}, &value, NULL);
+    assert (sat_status_get_result (&status) == true);
+    assert (value == 6);
+
+    status = sat_map_destroy (map);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_map_hash_string_keys (void)
+{
+    sat_map_t *map;
+    service_t service;
+
+    sat_status_t status = sat_map_create (&map, &(sat_map_args_t)
+                                                {
+                                                    .list_size = 8,
+                                                    .key_size = 32,
+                                                    .value_size = sizeof (service_t),
+                                                    .mode = sat_map_mode_dynamic,
+                                                    .hash = sat_map_hash_string
+                                                });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        memset (&service, 0, sizeof (service));
+        snprintf (service.name, sizeof (service.name), "service-%d", i);
+        service.port = 1000 + i;
+
+        status = sat_map_add (map, service.name, &service);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    // lookup keys do not need to be key_size bytes long
+    status = sat_map_get_value_by (map, "service-42", &service, NULL);
+    assert (sat_status_get_result (&status) == true);
+    assert (service.port == 1042);
+    assert (strcmp (service.name, "service-42") == 0);
+
+    status = sat_map_remove (map, "service-42", NULL);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_map_get_value_by (map, "service-42", &service, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_map_destroy (map);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_map_hash_static_limit (void)
+{
+    sat_map_t *map;
+    uint32_t size;
+
+    sat_status_t status = sat_map_create (&map, &(sat_map_args_t)
+                                                {
+                                                    .list_size = 3,
+                                                    .key_size = sizeof (int),
+                                                    .value_size = sizeof (int),
+                                                    .mode = sat_map_mode_static,
+                                                    .hash = sat_map_hash_bytes
+                                                });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < 3; i++)
+    {
+        status = sat_map_add (map, &i, &i);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_map_add (map, &(int){3}, &(int){3});
+    assert (sat_status_get_result (&status) == false);
+
+    // churn through remove/add so tombstones force in-place rehashes
+    for (int i = 3; i < 1000; i++)
+    {
+        status = sat_map_remove (map, &(int){i - 3}, NULL);
+        assert (sat_status_get_result (&status) == true);
+
+        status = sat_map_add (map, &i, &i);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_map_get_size (map, &size);
+    assert (sat_status_get_result (&status) == true);
+    assert (size == 3);
+
+    status = sat_map_destroy (map);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_map_hash_too_large (void)
+{
+    sat_map_t *map;
+
+    // Rounding the table up for such a size used to hang instead of failing.
+    sat_status_t status = sat_map_create (&map, &(sat_map_args_t)
+                                                {
+                                                    .list_size = SAT_MAP_LIST_SIZE_MAX + 1,
+                                                    .key_size = sizeof (int),
+                                                    .value_size = sizeof (int),
+                                                    .mode = sat_map_mode_dynamic,
+                                                    .hash = sat_map_hash_bytes
+                                                });
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_map_create (&map, &(sat_map_args_t)
+                                   {
+                                       .list_size = UINT32_MAX,
+                                       .key_size = sizeof (int),
+                                       .value_size = sizeof (int),
+                                       .mode = sat_map_mode_dynamic,
+                                       .hash = sat_map_hash_bytes
+                                   });
+    assert (sat_status_get_result (&status) == false);
+}
+
+int main (int argc, char *argv[])
+{
+    test_map_hash_fixed_size_keys ();
+    test_map_hash_string_keys ();
+    test_map_hash_static_limit ();
+    test_map_hash_too_large ();
+
+    return 0;
+}
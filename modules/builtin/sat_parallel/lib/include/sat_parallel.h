@@ -0,0 +1,214 @@
+/**
+ * @file sat_parallel.h
+ * @brief Data-parallel algorithms over arrays, run on a worker pool
+ *
+ * This module applies work to every element of a contiguous buffer using
+ * several threads: for-each, transform, reduce, filter and sort. Buffers are
+ * described with sat_array_buffer_t, filled by sat_array_get_buffer() for a
+ * sat_array or by hand for a plain C array.
+ *
+ * A call splits its buffer into chunks of at least grain elements, rounded
+ * to whole cache lines so that neighbouring chunks do not write to the same
+ * line, and publishes them to the pool. The calling thread works through the
+ * chunks too, and returns once all of them are done. Chunks are claimed one
+ * at a time, so a slow chunk does not hold back the others. Buffers no larger
+ * than a grain run sequentially on the calling thread, with no
+ * synchronization at all.
+ *
+ * The pool is a sat_worker, either created by the module or shared with the
+ * rest of the application. Calls may be made from several threads at once,
+ * and from within a handler of a shared pool.
+ */
+
+#ifndef SAT_PARALLEL_H_
+#define SAT_PARALLEL_H_
+
+#include <sat_status.h>
+#include <sat_worker.h>
+#include <sat_array.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Fewest elements per chunk when no grain is given
+ */
+#define SAT_PARALLEL_GRAIN_DEFAULT      4096
+
+/**
+ * @brief Function applied to an element by sat_parallel_for_each()
+ *
+ * @param element Pointer to the element, which may be modified
+ * @param user User context given to the call
+ */
+typedef void (*sat_parallel_apply_t) (void *const element, void *const user);
+
+/**
+ * @brief Function computing an output element by sat_parallel_transform()
+ *
+ * @param input Pointer to the input element
+ * @param output Pointer to the output element to write
+ * @param user User context given to the call
+ */
+typedef void (*sat_parallel_transform_t) (const void *const input, void *const output, void *const user);
+
+/**
+ * @brief Function folding an element into a partial result
+ *
+ * @param result Pointer to the partial result to update
+ * @param element Pointer to the element
+ * @param user User context given to the call
+ */
+typedef void (*sat_parallel_accumulate_t) (void *const result, const void *const element, void *const user);
+
+/**
+ * @brief Function merging a partial result into another
+ *
+ * @param result Pointer to the result to update
+ * @param partial Pointer to the partial result of the elements that follow
+ * @param user User context given to the call
+ */
+typedef void (*sat_parallel_combine_t) (void *const result, const void *const partial, void *const user);
+
+/**
+ * @brief Function deciding whether sat_parallel_filter() keeps an element
+ *
+ * @param element Pointer to the element
+ * @param user User context given to the call
+ * @return true to keep the element
+ */
+typedef bool (*sat_parallel_predicate_t) (const void *const element, void *const user);
+
+/**
+ * @brief Parallel runtime structure
+ *
+ * This structure should be treated as opaque and accessed only through
+ * the provided API functions.
+ */
+typedef struct
+{
+    sat_worker_t local;             /**< Pool used when none is given */
+    sat_worker_t *worker;           /**< Pool running the chunks */
+    uint32_t grain;                 /**< Fewest elements per chunk */
+    uint32_t threads;               /**< Threads sharing the work, the caller included */
+    bool owned;                     /**< Whether worker is local */
+} sat_parallel_t;
+
+/**
+ * @brief Configuration structure for opening a parallel runtime
+ */
+typedef struct
+{
+    sat_worker_t *worker;           /**< Opened pool to share, NULL to create one */
+    uint16_t pool_amount;           /**< Threads of a created pool, 0 for one per usable CPU but the caller's */
+    sat_worker_placement_t placement; /**< Placement of the threads of a created pool */
+    uint32_t grain;                 /**< Fewest elements per chunk, 0 selects SAT_PARALLEL_GRAIN_DEFAULT */
+} sat_parallel_args_t;
+
+/**
+ * @brief Initialize a parallel runtime
+ *
+ * @param object Pointer to the runtime structure
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_parallel_init (sat_parallel_t *const object);
+
+/**
+ * @brief Open a parallel runtime
+ *
+ * A shared pool must have been opened with an object_size of at least the
+ * size of a pointer; chunks are submitted to it with sat_worker_submit().
+ *
+ * @param object Pointer to the initialized runtime
+ * @param args Pointer to the configuration, or NULL for the defaults
+ * @return Status structure indicating success or failure
+ * @see sat_parallel_close()
+ */
+sat_status_t sat_parallel_open (sat_parallel_t *const object, const sat_parallel_args_t *const args);
+
+/**
+ * @brief Apply a function to every element
+ *
+ * @param object Pointer to the opened runtime
+ * @param buffer Elements to visit
+ * @param apply Function applied to each element, from several threads
+ * @param user User context passed to apply
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_parallel_for_each (sat_parallel_t *const object, const sat_array_buffer_t *const buffer, sat_parallel_apply_t apply, void *const user);
+
+/**
+ * @brief Compute an output element from every input element
+ *
+ * @param object Pointer to the opened runtime
+ * @param input Elements to read
+ * @param output Elements to write, with room for input->size elements
+ * @param transform Function computing an output element, from several threads
+ * @param user User context passed to transform
+ * @return Status structure indicating success or failure
+ * @note input and output may describe the same memory when their element sizes match
+ */
+sat_status_t sat_parallel_transform (sat_parallel_t *const object, const sat_array_buffer_t *const input, const sat_array_buffer_t *const output, sat_parallel_transform_t transform, void *const user);
+
+/**
+ * @brief Fold every element into a single result
+ *
+ * Each chunk starts from identity and accumulates its elements in order; the
+ * partial results are then combined in the order of their chunks. The result
+ * is therefore the same as a sequential fold whenever combine is associative,
+ * even if it is not commutative.
+ *
+ * @param object Pointer to the opened runtime
+ * @param buffer Elements to fold
+ * @param identity Pointer to the neutral result, result_size bytes
+ * @param result Pointer to store the result, result_size bytes
+ * @param result_size Size of a result
+ * @param accumulate Function folding an element into a partial result
+ * @param combine Function merging two partial results
+ * @param user User context passed to accumulate and combine
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_parallel_reduce (sat_parallel_t *const object, const sat_array_buffer_t *const buffer, const void *const identity, void *const result, uint32_t result_size, sat_parallel_accumulate_t accumulate, sat_parallel_combine_t combine, void *const user);
+
+/**
+ * @brief Copy the elements that satisfy a predicate, keeping their order
+ *
+ * @param object Pointer to the opened runtime
+ * @param input Elements to test
+ * @param[in,out] output Destination with room for input->size elements of the
+ *                same size; its size is set to the number of elements kept
+ * @param predicate Function deciding which elements are kept, called once per element
+ * @param user User context passed to predicate
+ * @return Status structure indicating success or failure
+ * @warning input and output must not overlap
+ */
+sat_status_t sat_parallel_filter (sat_parallel_t *const object, const sat_array_buffer_t *const input, sat_array_buffer_t *const output, sat_parallel_predicate_t predicate, void *const user);
+
+/**
+ * @brief Sort the elements in place
+ *
+ * Chunks are sorted independently, then merged pairwise in rounds; each
+ * merge is itself split into chunks, so every round keeps all the threads
+ * busy. Needs a temporary copy of the buffer.
+ *
+ * @param object Pointer to the opened runtime
+ * @param buffer Elements to sort
+ * @param order Ordering function
+ * @return Status structure indicating success or failure
+ * @note The sort is not stable
+ * @warning Sorting the buffer of a sat_array in sorted-insert mode with another
+ *          order breaks its invariant
+ */
+sat_status_t sat_parallel_sort (sat_parallel_t *const object, const sat_array_buffer_t *const buffer, sat_array_order_t order);
+
+/**
+ * @brief Close the runtime
+ *
+ * Closes the pool unless it was shared.
+ *
+ * @param object Pointer to the runtime
+ * @return Status structure indicating success or failure
+ * @warning No call may be in progress
+ */
+sat_status_t sat_parallel_close (sat_parallel_t *const object);
+
+#endif/* SAT_PARALLEL_H_ */
@@ -0,0 +1,674 @@
+#include <sat_parallel.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+
+#define SAT_PARALLEL_CACHE_LINE_SIZE        64
+#define SAT_PARALLEL_CHUNKS_PER_THREAD      4       // spare chunks let faster threads take more
+#define SAT_PARALLEL_NAME                   "sat_parallel"
+
+typedef struct sat_parallel_job_t sat_parallel_job_t;
+
+typedef void (*sat_parallel_run_t) (const sat_parallel_job_t *const job, const uint32_t chunk);
+
+// One phase of an algorithm. The caller fills in the operation, then the
+// chunks are claimed through next by the caller and the helper tasks alike.
+// Helpers may still be queued when the phase is over, so the job lives on
+// the heap until the last reference is gone.
+struct sat_parallel_job_t
+{
+    sat_parallel_run_t run;
+    uint32_t chunks;
+    uint32_t chunk_size;            // elements per chunk
+    uint32_t amount;                // elements in the buffer
+
+    uint8_t *input;
+    uint32_t input_size;
+    uint8_t *output;
+    uint32_t output_size;
+
+    sat_parallel_apply_t apply;
+    sat_parallel_transform_t transform;
+    sat_parallel_accumulate_t accumulate;
+    sat_parallel_predicate_t predicate;
+    sat_array_order_t order;
+    void *user;
+
+    const void *identity;
+    uint8_t *partials;              // reduce: one result per chunk
+    uint32_t result_size;
+    uint8_t *flags;                 // filter: one per element, whether it is kept
+    uint32_t *counts;               // filter: kept per chunk, then where each chunk starts
+    uint32_t width;                 // sort: length of the sorted runs being merged
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t next;                  // next chunk to claim
+    uint32_t done;                  // chunks finished
+    uint32_t references;            // the caller and the helpers not yet finished
+};
+
+static sat_status_t sat_parallel_is_buffer_valid (const sat_array_buffer_t *const buffer);
+static uint32_t sat_parallel_cpus (void);
+static uint32_t sat_parallel_chunk_size (const sat_parallel_t *const object, const uint32_t amount, const uint32_t object_size);
+static void sat_parallel_split (const sat_parallel_t *const object, sat_parallel_job_t *const job, const uint32_t object_size);
+static sat_status_t sat_parallel_execute (sat_parallel_t *const object, const sat_parallel_job_t *const parameters);
+static sat_status_t sat_parallel_publish (sat_parallel_t *const object, sat_parallel_job_t *const job);
+static void sat_parallel_work (sat_parallel_job_t *const job);
+static void sat_parallel_release (sat_parallel_job_t *const job);
+static void sat_parallel_handler (void *const object);
+static void sat_parallel_task (void *const object, void *const result);
+
+static void sat_parallel_run_apply (const sat_parallel_job_t *const job, const uint32_t chunk);
+static void sat_parallel_run_transform (const sat_parallel_job_t *const job, const uint32_t chunk);
+static void sat_parallel_run_accumulate (const sat_parallel_job_t *const job, const uint32_t chunk);
+static void sat_parallel_run_test (const sat_parallel_job_t *const job, const uint32_t chunk);
+static void sat_parallel_run_gather (const sat_parallel_job_t *const job, const uint32_t chunk);
+static void sat_parallel_run_sort (const sat_parallel_job_t *const job, const uint32_t chunk);
+static void sat_parallel_run_merge (const sat_parallel_job_t *const job, const uint32_t chunk);
+static void sat_parallel_run_copy (const sat_parallel_job_t *const job, const uint32_t chunk);
+static uint32_t sat_parallel_corank (const sat_parallel_job_t *const job, const uint8_t *const a, const uint32_t a_amount, const uint8_t *const b, const uint32_t b_amount, const uint32_t position);
+
+sat_status_t sat_parallel_init (sat_parallel_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    memset (object, 0, sizeof (sat_parallel_t));
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_parallel_open (sat_parallel_t *const object, const sat_parallel_args_t *const args)
+{
+    sat_status_return_on_null (object, "null object");
+
+    sat_parallel_args_t defaults = {0};
+    const sat_parallel_args_t *settings = args != NULL ? args : &defaults;
+
+    object->grain = settings->grain > 0 ? settings->grain : SAT_PARALLEL_GRAIN_DEFAULT;
+    object->worker = NULL;
+    object->owned = false;
+
+    if (settings->worker != NULL)
+    {
+        sat_status_return_on_null (settings->worker->locals, "worker is not open");
+        sat_status_return_on_less_than (settings->worker->object_size, sizeof (sat_parallel_job_t *), "worker objects are smaller than a pointer");
+
+        object->worker = settings->worker;
+    }
+    else
+    {
+        // The calling thread takes chunks too, so it needs no thread of its own.
+        uint32_t amount = settings->pool_amount > 0 ? settings->pool_amount : sat_parallel_cpus () - 1;
+
+        if (amount > UINT16_MAX)
+            amount = UINT16_MAX;
+
+        if (amount > 0)
+        {
+            sat_worker_init (&object->local);
+
+            sat_status_t status = sat_worker_open (&object->local, &(sat_worker_args_t)
+                                                                   {
+                                                                       .pool_amount = (uint16_t) amount,
+                                                                       .object_size = sizeof (sat_parallel_job_t *),
+                                                                       .handler = sat_parallel_handler,
+                                                                       .placement = settings->placement,
+                                                                       .name = SAT_PARALLEL_NAME,
+                                                                   });
+            if (sat_status_get_result (&status) == false)
+            {
+                sat_worker_close (&object->local);
+                return status;
+            }
+
+            object->worker = &object->local;
+            object->owned = true;
+        }
+    }
+
+    object->threads = object->worker != NULL ? (uint32_t) object->worker->threads_amount + 1 : 1;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_parallel_for_each (sat_parallel_t *const object, const sat_array_buffer_t *const buffer, sat_parallel_apply_t apply, void *const user)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (apply, "null apply");
+    sat_status_return_on_error (sat_parallel_is_buffer_valid (buffer));
+
+    sat_parallel_job_t job =
+    {
+        .run = sat_parallel_run_apply,
+        .amount = buffer->size,
+        .input = (uint8_t *) buffer->data,
+        .input_size = buffer->object_size,
+        .apply = apply,
+        .user = user,
+    };
+
+    sat_parallel_split (object, &job, buffer->object_size);
+
+    return sat_parallel_execute (object, &job);
+}
+
+sat_status_t sat_parallel_transform (sat_parallel_t *const object, const sat_array_buffer_t *const input, const sat_array_buffer_t *const output, sat_parallel_transform_t transform, void *const user)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (transform, "null transform");
+    sat_status_return_on_error (sat_parallel_is_buffer_valid (input));
+    sat_status_return_on_null (output, "null output");
+    sat_status_return_on_equals (output->object_size, 0, "output object size is zero");
+    sat_status_return_on_false ((output->data != NULL || input->size == 0), "null output data");
+
+    sat_parallel_job_t job =
+    {
+        .run = sat_parallel_run_transform,
+        .amount = input->size,
+        .input = (uint8_t *) input->data,
+        .input_size = input->object_size,
+        .output = (uint8_t *) output->data,
+        .output_size = output->object_size,
+        .transform = transform,
+        .user = user,
+    };
+
+    // Chunks sized for the wider side, which takes the most cache lines.
+    sat_parallel_split (object, &job, input->object_size > output->object_size ? input->object_size : output->object_size);
+
+    return sat_parallel_execute (object, &job);
+}
+
+sat_status_t sat_parallel_reduce (sat_parallel_t *const object, const sat_array_buffer_t *const buffer, const void *const identity, void *const result, uint32_t result_size, sat_parallel_accumulate_t accumulate, sat_parallel_combine_t combine, void *const user)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_error (sat_parallel_is_buffer_valid (buffer));
+    sat_status_return_on_null (identity, "null identity");
+    sat_status_return_on_null (result, "null result");
+    sat_status_return_on_equals (result_size, 0, "result size is zero");
+    sat_status_return_on_null (accumulate, "null accumulate");
+    sat_status_return_on_null (combine, "null combine");
+
+    if (buffer->size == 0)
+    {
+        memmove (result, identity, result_size);
+        sat_status_return_on_success ();
+    }
+
+    sat_parallel_job_t job =
+    {
+        .run = sat_parallel_run_accumulate,
+        .amount = buffer->size,
+        .input = (uint8_t *) buffer->data,
+        .input_size = buffer->object_size,
+        .accumulate = accumulate,
+        .user = user,
+        .identity = identity,
+        .result_size = result_size,
+    };
+
+    sat_parallel_split (object, &job, buffer->object_size);
+
+    job.partials = (uint8_t *) malloc ((size_t) job.chunks * result_size);
+    sat_status_return_on_null (job.partials, "memory allocation failed");
+
+    sat_status_t status = sat_parallel_execute (object, &job);
+
+    if (sat_status_get_result (&status) == true)
+    {
+        memcpy (result, job.partials, result_size);
+
+        for (uint32_t i = 1; i < job.chunks; i++)
+            combine (result, job.partials + (size_t) i * result_size, user);
+    }
+
+    free (job.partials);
+
+    return status;
+}
+
+sat_status_t sat_parallel_filter (sat_parallel_t *const object, const sat_array_buffer_t *const input, sat_array_buffer_t *const output, sat_parallel_predicate_t predicate, void *const user)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (predicate, "null predicate");
+    sat_status_return_on_error (sat_parallel_is_buffer_valid (input));
+    sat_status_return_on_null (output, "null output");
+    sat_status_return_on_not_equals (output->object_size, input->object_size, "output object size differs from the input");
+    sat_status_return_on_false ((output->data != NULL || input->size == 0), "null output data");
+
+    output->size = 0;
+
+    if (input->size == 0)
+        sat_status_return_on_success ();
+
+    sat_parallel_job_t job =
+    {
+        .run = sat_parallel_run_test,
+        .amount = input->size,
+        .input = (uint8_t *) input->data,
+        .input_size = input->object_size,
+        .output = (uint8_t *) output->data,
+        .output_size = output->object_size,
+        .predicate = predicate,
+        .user = user,
+    };
+
+    sat_parallel_split (object, &job, input->object_size);
+
+    // The predicate runs once; its answers drive the copy.
+    job.flags = (uint8_t *) malloc (job.amount);
+    job.counts = (uint32_t *) malloc ((size_t) job.chunks * sizeof (uint32_t));
+
+    sat_status_t status = sat_status_set (&status, true, __func__, "");
+
+    if (job.flags == NULL || job.counts == NULL)
+        sat_status_set (&status, false, __func__, "memory allocation failed");
+
+    if (sat_status_get_result (&status) == true)
+        status = sat_parallel_execute (object, &job);
+
+    if (sat_status_get_result (&status) == true)
+    {
+        uint32_t kept = 0;
+
+        for (uint32_t i = 0; i < job.chunks; i++)
+        {
+            uint32_t count = job.counts [i];
+
+            job.counts [i] = kept;
+            kept += count;
+        }
+
+        job.run = sat_parallel_run_gather;
+        status = sat_parallel_execute (object, &job);
+
+        if (sat_status_get_result (&status) == true)
+            output->size = kept;
+    }
+
+    free (job.counts);
+    free (job.flags);
+
+    return status;
+}
+
+sat_status_t sat_parallel_sort (sat_parallel_t *const object, const sat_array_buffer_t *const buffer, sat_array_order_t order)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (order, "null order");
+    sat_status_return_on_error (sat_parallel_is_buffer_valid (buffer));
+
+    sat_parallel_job_t job =
+    {
+        .run = sat_parallel_run_sort,
+        .amount = buffer->size,
+        .input = (uint8_t *) buffer->data,
+        .input_size = buffer->object_size,
+        .order = order,
+    };
+
+    sat_parallel_split (object, &job, buffer->object_size);
+
+    if (job.chunks <= 1 || object->worker == NULL)
+    {
+        if (buffer->size > 1)
+            qsort (buffer->data, buffer->size, buffer->object_size, order);
+
+        sat_status_return_on_success ();
+    }
+
+    uint8_t *temporary = (uint8_t *) malloc ((size_t) buffer->size * buffer->object_size);
+    sat_status_return_on_null (temporary, "memory allocation failed");
+
+    sat_status_t status = sat_parallel_execute (object, &job);
+
+    // Runs double every round; each merge is cut into chunks of output, and
+    // since twice a run is a whole number of chunks no chunk spans two merges.
+    uint8_t *source = job.input;
+    uint8_t *destination = temporary;
+
+    for (uint64_t width = job.chunk_size; width < job.amount && sat_status_get_result (&status) == true; width *= 2)
+    {
+        job.run = sat_parallel_run_merge;
+        job.input = source;
+        job.output = destination;
+        job.width = (uint32_t) width;
+
+        status = sat_parallel_execute (object, &job);
+
+        destination = source;
+        source = job.output;
+    }
+
+    if (sat_status_get_result (&status) == true && source != (uint8_t *) buffer->data)
+    {
+        job.run = sat_parallel_run_copy;
+        job.input = source;
+        job.output = (uint8_t *) buffer->data;
+
+        status = sat_parallel_execute (object, &job);
+    }
+
+    free (temporary);
+
+    return status;
+}
+
+sat_status_t sat_parallel_close (sat_parallel_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    if (object->owned == true)
+        sat_worker_close (&object->local);
+
+    memset (object, 0, sizeof (sat_parallel_t));
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_parallel_is_buffer_valid (const sat_array_buffer_t *const buffer)
+{
+    sat_status_return_on_null (buffer, "null buffer");
+    sat_status_return_on_equals (buffer->object_size, 0, "object size is zero");
+    sat_status_return_on_false ((buffer->data != NULL || buffer->size == 0), "null buffer data");
+
+    sat_status_return_on_success ();
+}
+
+static uint32_t sat_parallel_cpus (void)
+{
+    cpu_set_t set;
+
+    if (sched_getaffinity (0, sizeof (set), &set) == 0)
+        return (uint32_t) CPU_COUNT (&set);
+
+    long amount = sysconf (_SC_NPROCESSORS_ONLN);
+
+    return amount > 0 ? (uint32_t) amount : 1;
+}
+
+static uint32_t sat_parallel_chunk_size (const sat_parallel_t *const object, const uint32_t amount, const uint32_t object_size)
+{
+    uint64_t spread = (uint64_t) object->threads * SAT_PARALLEL_CHUNKS_PER_THREAD;
+    uint64_t size = ((uint64_t) amount + spread - 1) / spread;
+
+    if (size < object->grain)
+        size = object->grain;
+
+    // Elements that divide a cache line end chunks on a line boundary.
+    if (object_size < SAT_PARALLEL_CACHE_LINE_SIZE && SAT_PARALLEL_CACHE_LINE_SIZE % object_size == 0)
+    {
+        uint64_t line = SAT_PARALLEL_CACHE_LINE_SIZE / object_size;
+
+        size = (size + line - 1) / line * line;
+    }
+
+    return size < amount ? (uint32_t) size : amount;
+}
+
+static void sat_parallel_split (const sat_parallel_t *const object, sat_parallel_job_t *const job, const uint32_t object_size)
+{
+    job->chunk_size = sat_parallel_chunk_size (object, job->amount, object_size);
+    job->chunks = job->chunk_size > 0 ? (uint32_t) (((uint64_t) job->amount + job->chunk_size - 1) / job->chunk_size) : 0;
+}
+
+static sat_status_t sat_parallel_execute (sat_parallel_t *const object, const sat_parallel_job_t *const parameters)
+{
+    // A single chunk, or nobody to share it with: run it right here.
+    if (parameters->chunks <= 1 || object->worker == NULL)
+    {
+        for (uint32_t i = 0; i < parameters->chunks; i++)
+            parameters->run (parameters, i);
+
+        sat_status_return_on_success ();
+    }
+
+    sat_parallel_job_t *job = (sat_parallel_job_t *) malloc (sizeof (sat_parallel_job_t));
+    sat_status_return_on_null (job, "memory allocation failed");
+
+    *job = *parameters;
+    job->next = 0;
+    job->done = 0;
+    job->references = 1;
+
+    pthread_mutex_init (&job->mutex, NULL);
+    pthread_cond_init (&job->cond, NULL);
+
+    sat_status_t status = sat_parallel_publish (object, job);
+
+    sat_parallel_work (job);
+
+    pthread_mutex_lock (&job->mutex);
+
+    while (__atomic_load_n (&job->done, __ATOMIC_ACQUIRE) < job->chunks)
+        pthread_cond_wait (&job->cond, &job->mutex);
+
+    pthread_mutex_unlock (&job->mutex);
+
+    sat_parallel_release (job);
+
+    return status;
+}
+
+// Queues one helper per thread that could take a chunk. A helper that cannot
+// be queued only means fewer hands: the caller finishes the chunks anyway.
+static sat_status_t sat_parallel_publish (sat_parallel_t *const object, sat_parallel_job_t *const job)
+{
+    uint32_t helpers = object->threads - 1 < job->chunks - 1 ? object->threads - 1 : job->chunks - 1;
+    uint32_t size = object->worker->object_size;
+    uint8_t *data = (uint8_t *) calloc (1, size);
+
+    sat_status_return_on_null (data, "memory allocation failed");
+
+    memcpy (data, &job, sizeof (sat_parallel_job_t *));
+
+    for (uint32_t i = 0; i < helpers; i++)
+    {
+        sat_status_t status;
+
+        __atomic_add_fetch (&job->references, 1, __ATOMIC_RELAXED);
+
+        if (object->owned == true)
+            status = sat_worker_feed (object->worker, data);
+        else
+            status = sat_worker_submit (object->worker, data, &(sat_worker_submit_args_t) {.task = sat_parallel_task}, NULL);
+
+        if (sat_status_get_result (&status) == false)
+        {
+            __atomic_sub_fetch (&job->references, 1, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+
+    free (data);
+
+    sat_status_return_on_success ();
+}
+
+static void sat_parallel_work (sat_parallel_job_t *const job)
+{
+    uint32_t chunk;
+
+    while ((chunk = __atomic_fetch_add (&job->next, 1, __ATOMIC_RELAXED)) < job->chunks)
+    {
+        job->run (job, chunk);
+
+        if (__atomic_add_fetch (&job->done, 1, __ATOMIC_ACQ_REL) == job->chunks)
+        {
+            pthread_mutex_lock (&job->mutex);
+            pthread_cond_broadcast (&job->cond);
+            pthread_mutex_unlock (&job->mutex);
+        }
+    }
+}
+
+static void sat_parallel_release (sat_parallel_job_t *const job)
+{
+    if (__atomic_sub_fetch (&job->references, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        pthread_cond_destroy (&job->cond);
+        pthread_mutex_destroy (&job->mutex);
+        free (job);
+    }
+}
+
+static void sat_parallel_handler (void *const object)
+{
+    sat_parallel_job_t *job;
+
+    memcpy (&job, object, sizeof (sat_parallel_job_t *));
+
+    sat_parallel_work (job);
+    sat_parallel_release (job);
+}
+
+static void sat_parallel_task (void *const object, void *const result)
+{
+    (void) result;
+
+    sat_parallel_handler (object);
+}
+
+static void sat_parallel_run_apply (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    uint64_t begin = (uint64_t) chunk * job->chunk_size;
+    uint64_t end = begin + job->chunk_size < job->amount ? begin + job->chunk_size : job->amount;
+
+    for (uint64_t i = begin; i < end; i++)
+        job->apply (job->input + i * job->input_size, job->user);
+}
+
+static void sat_parallel_run_transform (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    uint64_t begin = (uint64_t) chunk * job->chunk_size;
+    uint64_t end = begin + job->chunk_size < job->amount ? begin + job->chunk_size : job->amount;
+
+    for (uint64_t i = begin; i < end; i++)
+        job->transform (job->input + i * job->input_size, job->output + i * job->output_size, job->user);
+}
+
+static void sat_parallel_run_accumulate (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    uint64_t begin = (uint64_t) chunk * job->chunk_size;
+    uint64_t end = begin + job->chunk_size < job->amount ? begin + job->chunk_size : job->amount;
+    uint8_t *partial = job->partials + (size_t) chunk * job->result_size;
+
+    memcpy (partial, job->identity, job->result_size);
+
+    for (uint64_t i = begin; i < end; i++)
+        job->accumulate (partial, job->input + i * job->input_size, job->user);
+}
+
+static void sat_parallel_run_test (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    uint64_t begin = (uint64_t) chunk * job->chunk_size;
+    uint64_t end = begin + job->chunk_size < job->amount ? begin + job->chunk_size : job->amount;
+    uint32_t kept = 0;
+
+    for (uint64_t i = begin; i < end; i++)
+    {
+        job->flags [i] = job->predicate (job->input + i * job->input_size, job->user) ? 1 : 0;
+        kept += job->flags [i];
+    }
+
+    job->counts [chunk] = kept;
+}
+
+static void sat_parallel_run_gather (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    uint64_t begin = (uint64_t) chunk * job->chunk_size;
+    uint64_t end = begin + job->chunk_size < job->amount ? begin + job->chunk_size : job->amount;
+    uint8_t *destination = job->output + (size_t) job->counts [chunk] * job->output_size;
+
+    for (uint64_t i = begin; i < end; i++)
+    {
+        if (job->flags [i] == 1)
+        {
+            memcpy (destination, job->input + i * job->input_size, job->input_size);
+            destination += job->output_size;
+        }
+    }
+}
+
+static void sat_parallel_run_sort (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    uint64_t begin = (uint64_t) chunk * job->chunk_size;
+    uint64_t end = begin + job->chunk_size < job->amount ? begin + job->chunk_size : job->amount;
+
+    qsort (job->input + begin * job->input_size, (size_t) (end - begin), job->input_size, job->order);
+}
+
+// Writes one chunk of the output of a merge: finds how many elements of each
+// run come before the chunk and how many end up in it, then merges those.
+static void sat_parallel_run_merge (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    const uint64_t size = job->input_size;
+    uint64_t position = (uint64_t) chunk * job->chunk_size;
+    uint64_t pair = position / (2 * (uint64_t) job->width) * (2 * (uint64_t) job->width);
+    uint64_t middle = pair + job->width < job->amount ? pair + job->width : job->amount;
+    uint64_t end = pair + 2 * (uint64_t) job->width < job->amount ? pair + 2 * (uint64_t) job->width : job->amount;
+
+    const uint8_t *a = job->input + pair * size;
+    const uint8_t *b = job->input + middle * size;
+    uint32_t a_amount = (uint32_t) (middle - pair);
+    uint32_t b_amount = (uint32_t) (end - middle);
+
+    uint32_t first = (uint32_t) (position - pair);
+    uint32_t last = (uint32_t) ((position + job->chunk_size < end ? position + job->chunk_size : end) - pair);
+
+    uint32_t i = sat_parallel_corank (job, a, a_amount, b, b_amount, first);
+    uint32_t j = first - i;
+    uint32_t i_end = sat_parallel_corank (job, a, a_amount, b, b_amount, last);
+    uint32_t j_end = last - i_end;
+
+    uint8_t *destination = job->output + position * size;
+
+    while (i < i_end && j < j_end)
+    {
+        // Ties go to the first run.
+        if (job->order (b + j * size, a + i * size) < 0)
+            memcpy (destination, b + j++ * size, size);
+        else
+            memcpy (destination, a + i++ * size, size);
+
+        destination += size;
+    }
+
+    memcpy (destination, a + i * size, (i_end - i) * size);
+    destination += (i_end - i) * size;
+
+    memcpy (destination, b + j * size, (j_end - j) * size);
+}
+
+static void sat_parallel_run_copy (const sat_parallel_job_t *const job, const uint32_t chunk)
+{
+    uint64_t begin = (uint64_t) chunk * job->chunk_size;
+    uint64_t end = begin + job->chunk_size < job->amount ? begin + job->chunk_size : job->amount;
+
+    memcpy (job->output + begin * job->input_size, job->input + begin * job->input_size, (size_t) (end - begin) * job->input_size);
+}
+
+// Number of elements of run a among the first position elements of the
+// merge of a and b, found by binary search.
+static uint32_t sat_parallel_corank (const sat_parallel_job_t *const job, const uint8_t *const a, const uint32_t a_amount, const uint8_t *const b, const uint32_t b_amount, const uint32_t position)
+{
+    const uint64_t size = job->input_size;
+    uint32_t low = position > b_amount ? position - b_amount : 0;
+    uint32_t high = position < a_amount ? position : a_amount;
+
+    while (low < high)
+    {
+        uint32_t i = low + (high - low) / 2;
+        uint32_t j = position - i;
+
+        // a [i] goes before b [j - 1], so more of a belongs in front.
+        if (job->order (a + i * size, b + (j - 1) * size) <= 0)
+            low = i + 1;
+        else
+            high = i;
+    }
+
+    return low;
+}
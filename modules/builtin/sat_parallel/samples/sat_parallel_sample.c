@@ -0,0 +1,173 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Telemetry benchmark: sorts a few million samples by timestamp and folds
+ * them into per-run statistics, once with qsort and a plain loop on a single
+ * thread and once with sat_parallel, then checks that both agree.
+ *
+ * usage: sat_parallel_sample [samples] [threads] [grain]
+ */
+
+#define SAMPLE_AMOUNT_DEFAULT       4000000
+
+typedef struct
+{
+    uint64_t timestamp;
+    uint32_t sensor;
+    float value;
+} sample_t;
+
+typedef struct
+{
+    double sum;
+    float minimum;
+    float maximum;
+    uint64_t count;
+} statistics_t;
+
+static double sample_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static int sample_by_timestamp (const void *const element, const void *const other)
+{
+    const sample_t *a = (const sample_t *) element;
+    const sample_t *b = (const sample_t *) other;
+
+    return (a->timestamp > b->timestamp) - (a->timestamp < b->timestamp);
+}
+
+static void sample_accumulate (void *const result, const void *const element, void *const user)
+{
+    statistics_t *statistics = (statistics_t *) result;
+    const sample_t *sample = (const sample_t *) element;
+
+    statistics->sum += sample->value;
+    statistics->count++;
+
+    if (sample->value < statistics->minimum)
+        statistics->minimum = sample->value;
+
+    if (sample->value > statistics->maximum)
+        statistics->maximum = sample->value;
+}
+
+static void sample_combine (void *const result, const void *const partial, void *const user)
+{
+    statistics_t *statistics = (statistics_t *) result;
+    const statistics_t *other = (const statistics_t *) partial;
+
+    statistics->sum += other->sum;
+    statistics->count += other->count;
+
+    if (other->minimum < statistics->minimum)
+        statistics->minimum = other->minimum;
+
+    if (other->maximum > statistics->maximum)
+        statistics->maximum = other->maximum;
+}
+
+static void sample_generate (sample_t *const samples, const uint32_t amount)
+{
+    uint64_t seed = 88172645463325252ULL;
+
+    // Sensors report out of order, as they would after arriving over a network.
+    for (uint32_t i = 0; i < amount; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        samples [i] = (sample_t)
+        {
+            .timestamp = 1700000000000ULL + seed % (amount * 10ULL),
+            .sensor = (uint32_t) (seed >> 40) % 64,
+            .value = (float) (seed % 100000) / 1000.0f,
+        };
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    uint32_t amount = argc > 1 ? (uint32_t) strtoul (argv [1], NULL, 10) : SAMPLE_AMOUNT_DEFAULT;
+    uint16_t threads = argc > 2 ? (uint16_t) strtoul (argv [2], NULL, 10) : 0;
+    uint32_t grain = argc > 3 ? (uint32_t) strtoul (argv [3], NULL, 10) : 0;
+    statistics_t identity = {.sum = 0.0, .minimum = 1e30f, .maximum = -1e30f, .count = 0};
+    statistics_t sequential = identity;
+    statistics_t parallel_result;
+    sat_parallel_t parallel;
+
+    if (amount == 0)
+        amount = SAMPLE_AMOUNT_DEFAULT;
+
+    sample_t *reference = (sample_t *) malloc ((size_t) amount * sizeof (sample_t));
+    sample_t *samples = (sample_t *) malloc ((size_t) amount * sizeof (sample_t));
+
+    if (reference == NULL || samples == NULL)
+    {
+        fprintf (stderr, "out of memory\n");
+        return 1;
+    }
+
+    sample_generate (reference, amount);
+    memcpy (samples, reference, (size_t) amount * sizeof (sample_t));
+
+    // A pool_amount of 0 takes one thread per usable CPU, the caller included.
+    sat_parallel_init (&parallel);
+
+    sat_status_t status = sat_parallel_open (&parallel, &(sat_parallel_args_t) {.pool_amount = threads > 1 ? threads - 1 : 0, .grain = grain});
+    if (sat_status_get_result (&status) == false)
+    {
+        fprintf (stderr, "%s\n", sat_status_get_motive (&status));
+        return 1;
+    }
+
+    printf ("%u samples of %zu bytes, %u threads, grain %u\n\n", amount, sizeof (sample_t), parallel.threads, parallel.grain);
+    printf ("%-8s %14s %14s\n", "", "sort ms", "reduce ms");
+
+    double start = sample_now ();
+    qsort (reference, amount, sizeof (sample_t), sample_by_timestamp);
+    double sorted = sample_now ();
+
+    for (uint32_t i = 0; i < amount; i++)
+        sample_accumulate (&sequential, &reference [i], NULL);
+
+    double reduced = sample_now ();
+
+    printf ("%-8s %14.1f %14.1f\n", "qsort", (sorted - start) * 1e3, (reduced - sorted) * 1e3);
+
+    sat_array_buffer_t buffer = {.data = samples, .size = amount, .object_size = sizeof (sample_t)};
+
+    start = sample_now ();
+    sat_parallel_sort (&parallel, &buffer, sample_by_timestamp);
+    sorted = sample_now ();
+    sat_parallel_reduce (&parallel, &buffer, &identity, &parallel_result, sizeof (statistics_t), sample_accumulate, sample_combine, NULL);
+    reduced = sample_now ();
+
+    printf ("%-8s %14.1f %14.1f\n", "parallel", (sorted - start) * 1e3, (reduced - sorted) * 1e3);
+
+    // Equal timestamps may come in any order, so only the keys are compared.
+    uint32_t mismatches = 0;
+
+    for (uint32_t i = 0; i < amount; i++)
+        mismatches += samples [i].timestamp != reference [i].timestamp;
+
+    printf ("\n%lu samples, mean %.3f, min %.3f, max %.3f, %u misplaced\n",
+            (unsigned long) parallel_result.count, parallel_result.sum / (double) parallel_result.count,
+            parallel_result.minimum, parallel_result.maximum, mismatches);
+
+    sat_parallel_close (&parallel);
+
+    free (samples);
+    free (reference);
+
+    return mismatches == 0 && parallel_result.count == sequential.count ? 0 : 1;
+}
@@ -0,0 +1,449 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define TEST_AMOUNT     100003
+#define TEST_GRAIN      1000
+
+typedef struct
+{
+    uint32_t key;
+    uint32_t sequence;
+} record_t;
+
+typedef struct
+{
+    uint64_t sum;
+    uint32_t minimum;
+    uint32_t maximum;
+} summary_t;
+
+static void test_ignore (void *const object)
+{
+}
+
+static void test_double (void *const element, void *const user)
+{
+    uint32_t *value = (uint32_t *) element;
+
+    *value *= 2;
+}
+
+static void test_square (const void *const input, void *const output, void *const user)
+{
+    uint64_t value = *(const uint32_t *) input;
+
+    *(uint64_t *) output = value * value;
+}
+
+static void test_accumulate (void *const result, const void *const element, void *const user)
+{
+    summary_t *summary = (summary_t *) result;
+    uint32_t value = *(const uint32_t *) element;
+
+    summary->sum += value;
+
+    if (value < summary->minimum)
+        summary->minimum = value;
+
+    if (value > summary->maximum)
+        summary->maximum = value;
+}
+
+static void test_combine (void *const result, const void *const partial, void *const user)
+{
+    summary_t *summary = (summary_t *) result;
+    const summary_t *other = (const summary_t *) partial;
+
+    summary->sum += other->sum;
+
+    if (other->minimum < summary->minimum)
+        summary->minimum = other->minimum;
+
+    if (other->maximum > summary->maximum)
+        summary->maximum = other->maximum;
+}
+
+// Concatenation is associative but not commutative: it checks the order of
+// the partial results.
+static void test_append (void *const result, const void *const element, void *const user)
+{
+    uint64_t *hash = (uint64_t *) result;
+
+    *hash = *hash * 31 + *(const uint32_t *) element;
+}
+
+static void test_concatenate (void *const result, const void *const partial, void *const user)
+{
+    uint64_t *hash = (uint64_t *) result;
+    const uint64_t *other = (const uint64_t *) partial;
+    uint32_t length = other [1];
+    uint64_t power = 1;
+
+    for (uint32_t i = 0; i < length; i++)
+        power *= 31;
+
+    hash [0] = hash [0] * power + other [0];
+    hash [1] += other [1];
+}
+
+static void test_append_counted (void *const result, const void *const element, void *const user)
+{
+    uint64_t *hash = (uint64_t *) result;
+
+    test_append (result, element, user);
+    hash [1]++;
+}
+
+static bool test_is_multiple (const void *const element, void *const user)
+{
+    return *(const uint32_t *) element % *(uint32_t *) user == 0;
+}
+
+static int test_ascending (const void *const element, const void *const other)
+{
+    uint32_t a = *(const uint32_t *) element;
+    uint32_t b = *(const uint32_t *) other;
+
+    return (a > b) - (a < b);
+}
+
+static int test_by_key (const void *const element, const void *const other)
+{
+    const record_t *a = (const record_t *) element;
+    const record_t *b = (const record_t *) other;
+
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+static void test_fill (uint32_t *const values, const uint32_t amount, uint32_t seed)
+{
+    for (uint32_t i = 0; i < amount; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        values [i] = (seed >> 8) % 1000000;
+    }
+}
+
+static void test_for_each (sat_parallel_t *const parallel)
+{
+    sat_array_t *array;
+    sat_array_buffer_t buffer;
+
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t) {.size = TEST_AMOUNT, .object_size = sizeof (uint32_t)});
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+        sat_array_add (array, &i);
+
+    status = sat_array_get_buffer (array, &buffer);
+    assert (sat_status_get_result (&status) == true);
+    assert (buffer.object_size == sizeof (uint32_t));
+
+    status = sat_parallel_for_each (parallel, &buffer, test_double, NULL);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+        assert (((uint32_t *) buffer.data) [i] == 2 * i);
+
+    sat_array_destroy (array);
+}
+
+static void test_transform (sat_parallel_t *const parallel)
+{
+    uint32_t *values = (uint32_t *) malloc (TEST_AMOUNT * sizeof (uint32_t));
+    uint64_t *squares = (uint64_t *) malloc (TEST_AMOUNT * sizeof (uint64_t));
+
+    test_fill (values, TEST_AMOUNT, 1);
+
+    sat_status_t status = sat_parallel_transform (parallel,
+                                                  &(sat_array_buffer_t) {.data = values, .size = TEST_AMOUNT, .object_size = sizeof (uint32_t)},
+                                                  &(sat_array_buffer_t) {.data = squares, .size = TEST_AMOUNT, .object_size = sizeof (uint64_t)},
+                                                  test_square, NULL);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+        assert (squares [i] == (uint64_t) values [i] * values [i]);
+
+    free (squares);
+    free (values);
+}
+
+static void test_reduce (sat_parallel_t *const parallel)
+{
+    uint32_t *values = (uint32_t *) malloc (TEST_AMOUNT * sizeof (uint32_t));
+    sat_array_buffer_t buffer = {.data = values, .size = TEST_AMOUNT, .object_size = sizeof (uint32_t)};
+    summary_t identity = {.sum = 0, .minimum = UINT32_MAX, .maximum = 0};
+    summary_t expected = identity;
+    summary_t result;
+
+    test_fill (values, TEST_AMOUNT, 2);
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+        test_accumulate (&expected, &values [i], NULL);
+
+    sat_status_t status = sat_parallel_reduce (parallel, &buffer, &identity, &result, sizeof (result), test_accumulate, test_combine, NULL);
+    assert (sat_status_get_result (&status) == true);
+    assert (result.sum == expected.sum);
+    assert (result.minimum == expected.minimum);
+    assert (result.maximum == expected.maximum);
+
+    // Partial results are combined in order.
+    uint64_t hash_identity [2] = {0, 0};
+    uint64_t hash_expected [2] = {0, 0};
+    uint64_t hash [2];
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+        test_append_counted (hash_expected, &values [i], NULL);
+
+    status = sat_parallel_reduce (parallel, &buffer, hash_identity, hash, sizeof (hash), test_append_counted, test_concatenate, NULL);
+    assert (sat_status_get_result (&status) == true);
+    assert (hash [0] == hash_expected [0]);
+    assert (hash [1] == TEST_AMOUNT);
+
+    // An empty buffer yields the identity.
+    buffer.size = 0;
+
+    status = sat_parallel_reduce (parallel, &buffer, &identity, &result, sizeof (result), test_accumulate, test_combine, NULL);
+    assert (sat_status_get_result (&status) == true);
+    assert (result.minimum == UINT32_MAX);
+
+    free (values);
+}
+
+static void test_filter (sat_parallel_t *const parallel)
+{
+    uint32_t *values = (uint32_t *) malloc (TEST_AMOUNT * sizeof (uint32_t));
+    uint32_t *kept = (uint32_t *) malloc (TEST_AMOUNT * sizeof (uint32_t));
+    sat_array_buffer_t output = {.data = kept, .object_size = sizeof (uint32_t)};
+    uint32_t divisor = 7;
+    uint32_t expected = 0;
+
+    test_fill (values, TEST_AMOUNT, 3);
+
+    sat_status_t status = sat_parallel_filter (parallel, &(sat_array_buffer_t) {.data = values, .size = TEST_AMOUNT, .object_size = sizeof (uint32_t)},
+                                               &output, test_is_multiple, &divisor);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+    {
+        if (values [i] % divisor == 0)
+        {
+            assert (expected < output.size);
+            assert (kept [expected] == values [i]);
+            expected++;
+        }
+    }
+
+    assert (output.size == expected);
+    assert (expected > 0);
+
+    // Element sizes must match.
+    output.object_size = sizeof (uint64_t);
+
+    status = sat_parallel_filter (parallel, &(sat_array_buffer_t) {.data = values, .size = TEST_AMOUNT, .object_size = sizeof (uint32_t)},
+                                  &output, test_is_multiple, &divisor);
+    assert (sat_status_get_result (&status) == false);
+
+    free (kept);
+    free (values);
+}
+
+static void test_sort (sat_parallel_t *const parallel)
+{
+    // Sizes around the chunk boundaries, and values with many duplicates.
+    uint32_t amounts [] = {0, 1, 2, TEST_GRAIN - 1, TEST_GRAIN, TEST_GRAIN + 1, 3 * TEST_GRAIN + 17, TEST_AMOUNT, 4 * TEST_AMOUNT};
+    uint32_t moduli [] = {1000000, 3};
+
+    for (uint32_t m = 0; m < sizeof (moduli) / sizeof (moduli [0]); m++)
+    {
+        for (uint32_t a = 0; a < sizeof (amounts) / sizeof (amounts [0]); a++)
+        {
+            uint32_t amount = amounts [a];
+            uint32_t *values = (uint32_t *) malloc ((amount + 1) * sizeof (uint32_t));
+            uint32_t *expected = (uint32_t *) malloc ((amount + 1) * sizeof (uint32_t));
+
+            test_fill (values, amount, a + 10);
+
+            for (uint32_t i = 0; i < amount; i++)
+                values [i] %= moduli [m];
+
+            memcpy (expected, values, amount * sizeof (uint32_t));
+            qsort (expected, amount, sizeof (uint32_t), test_ascending);
+
+            sat_status_t status = sat_parallel_sort (parallel, &(sat_array_buffer_t) {.data = values, .size = amount, .object_size = sizeof (uint32_t)}, test_ascending);
+            assert (sat_status_get_result (&status) == true);
+            assert (memcmp (values, expected, amount * sizeof (uint32_t)) == 0);
+
+            free (expected);
+            free (values);
+        }
+    }
+}
+
+static void test_sort_records (sat_parallel_t *const parallel)
+{
+    sat_array_t *array;
+    sat_array_buffer_t buffer;
+
+    // Elements that do not divide a cache line.
+    sat_status_t status = sat_array_create (&array, &(sat_array_args_t) {.size = TEST_AMOUNT, .object_size = sizeof (record_t) + 4});
+    assert (sat_status_get_result (&status) == true);
+
+    uint32_t seed = 5;
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+    {
+        uint8_t element [sizeof (record_t) + 4] = {0};
+
+        seed = seed * 1103515245 + 12345;
+        memcpy (element, &(record_t) {.key = (seed >> 8) % 5000, .sequence = i}, sizeof (record_t));
+
+        sat_array_add (array, element);
+    }
+
+    status = sat_array_get_buffer (array, &buffer);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_parallel_sort (parallel, &buffer, test_by_key);
+    assert (sat_status_get_result (&status) == true);
+
+    uint64_t sequences = 0;
+
+    for (uint32_t i = 0; i < TEST_AMOUNT; i++)
+    {
+        const record_t *record = (const record_t *) ((uint8_t *) buffer.data + (size_t) i * buffer.object_size);
+
+        if (i > 0)
+            assert (test_by_key ((uint8_t *) record - buffer.object_size, record) <= 0);
+
+        sequences += record->sequence;
+    }
+
+    // Nothing lost or duplicated.
+    assert (sequences == (uint64_t) TEST_AMOUNT * (TEST_AMOUNT - 1) / 2);
+
+    sat_array_destroy (array);
+}
+
+static void test_all (sat_parallel_t *const parallel)
+{
+    test_for_each (parallel);
+    test_transform (parallel);
+    test_reduce (parallel);
+    test_filter (parallel);
+    test_sort (parallel);
+    test_sort_records (parallel);
+}
+
+static void test_owned_pool (void)
+{
+    sat_parallel_t parallel;
+
+    sat_status_t status = sat_parallel_init (&parallel);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_parallel_open (&parallel, &(sat_parallel_args_t) {.pool_amount = 3, .grain = TEST_GRAIN});
+    assert (sat_status_get_result (&status) == true);
+    assert (parallel.threads == 4);
+
+    test_all (&parallel);
+
+    sat_parallel_close (&parallel);
+}
+
+static void test_shared_pool (void)
+{
+    sat_worker_t worker;
+    sat_parallel_t parallel;
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t) {.pool_amount = 2, .object_size = sizeof (void *), .handler = test_ignore});
+    assert (sat_status_get_result (&status) == true);
+
+    sat_parallel_init (&parallel);
+
+    status = sat_parallel_open (&parallel, &(sat_parallel_args_t) {.worker = &worker, .grain = TEST_GRAIN});
+    assert (sat_status_get_result (&status) == true);
+    assert (parallel.threads == 3);
+
+    test_all (&parallel);
+
+    // The pool outlives the runtime.
+    sat_parallel_close (&parallel);
+
+    status = sat_worker_wait_idle (&worker);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_worker_close (&worker);
+}
+
+static void test_default_pool (void)
+{
+    sat_parallel_t parallel;
+
+    // One thread per usable CPU, the caller included; a single CPU gets no
+    // pool and runs everything on the caller.
+    sat_parallel_init (&parallel);
+
+    sat_status_t status = sat_parallel_open (&parallel, NULL);
+    assert (sat_status_get_result (&status) == true);
+    assert (parallel.grain == SAT_PARALLEL_GRAIN_DEFAULT);
+    assert ((parallel.worker == NULL) == (parallel.threads == 1));
+
+    test_all (&parallel);
+
+    sat_parallel_close (&parallel);
+}
+
+static void test_invalid (void)
+{
+    sat_parallel_t parallel;
+    sat_worker_t worker;
+    uint32_t value = 0;
+
+    sat_parallel_init (&parallel);
+
+    // A shared pool must be open and carry a pointer.
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_parallel_open (&parallel, &(sat_parallel_args_t) {.worker = &worker});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_worker_open (&worker, &(sat_worker_args_t) {.pool_amount = 1, .object_size = 1, .handler = test_ignore});
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_parallel_open (&parallel, &(sat_parallel_args_t) {.worker = &worker});
+    assert (sat_status_get_result (&status) == false);
+
+    sat_worker_close (&worker);
+
+    status = sat_parallel_open (&parallel, &(sat_parallel_args_t) {.pool_amount = 1});
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_parallel_for_each (&parallel, NULL, test_double, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_parallel_for_each (&parallel, &(sat_array_buffer_t) {.data = &value, .size = 1, .object_size = 0}, test_double, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_parallel_for_each (&parallel, &(sat_array_buffer_t) {.data = NULL, .size = 1, .object_size = 4}, test_double, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_parallel_sort (&parallel, &(sat_array_buffer_t) {.data = &value, .size = 1, .object_size = 4}, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_parallel_close (&parallel);
+}
+
+int main (int argc, char *argv[])
+{
+    test_owned_pool ();
+    test_shared_pool ();
+    test_default_pool ();
+    test_invalid ();
+
+    return 0;
+}
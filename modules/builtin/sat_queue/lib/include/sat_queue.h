@@ -13,6 +13,7 @@
 #define SAT_QUEUE_H_
 
 #include <sat_status.h>
+#include <sat_allocator.h>
 #include <stdint.h>
 
 /**
@@ -32,6 +33,33 @@ typedef struct sat_queue_t sat_queue_t;
  */
 typedef void (*sat_queue_print_t) (const void *const element);
 
+/**
+ * @brief Queue storage mode
+ * 
+ * Defines how the queue stores its elements.
+ */
+typedef enum
+{
+    sat_queue_mode_linked,  /**< One heap node per element */
+    sat_queue_mode_ring,    /**< Elements inline in a contiguous, growable ring buffer */
+} sat_queue_mode_t;
+
+/**
+ * @brief Default initial capacity, in elements, of a ring mode queue
+ */
+#define SAT_QUEUE_RING_CAPACITY_DEFAULT     64
+
+/**
+ * @brief Configuration structure for queue creation
+ */
+typedef struct
+{
+    uint32_t object_size;       /**< Size in bytes of each element */
+    sat_queue_mode_t mode;      /**< Storage mode */
+    uint32_t capacity;          /**< Initial capacity in elements for the ring mode, 0 selects SAT_QUEUE_RING_CAPACITY_DEFAULT */
+    sat_allocator_t allocator;  /**< Optional allocator for the queue and its elements, zero selects the C library */
+} sat_queue_args_t;
+
 /**
  * @brief Creates a new queue
  * 
@@ -43,10 +71,27 @@ typedef void (*sat_queue_print_t) (const void *const element);
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @note The caller is responsible for calling sat_queue_destroy() to free resources
+ * @note The queue is created in sat_queue_mode_linked
+ * @see sat_queue_create_with_args()
  * @see sat_queue_destroy()
  */
 sat_status_t sat_queue_create (sat_queue_t **const object, uint32_t object_size);
 
+/**
+ * @brief Creates a new queue with the given configuration
+ * 
+ * In sat_queue_mode_ring the elements are stored inline in a contiguous
+ * buffer that doubles when full, so enqueue and dequeue do not allocate.
+ * 
+ * @param[out] object Pointer to the pointer that will hold the created queue
+ * @param[in] args Pointer to the configuration structure
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note The caller is responsible for calling sat_queue_destroy() to free resources
+ * @see sat_queue_destroy()
+ */
+sat_status_t sat_queue_create_with_args (sat_queue_t **const object, const sat_queue_args_t *const args);
+
 /**
  * @brief Adds an element to the back of the queue
  * 
@@ -78,6 +123,43 @@ sat_status_t sat_queue_enqueue (sat_queue_t *const object, const void *const dat
  */
 sat_status_t sat_queue_dequeue (sat_queue_t *const object, void *const data);
 
+/**
+ * @brief Adds several contiguous elements to the back of the queue
+ * 
+ * @param[in,out] object Pointer to the queue
+ * @param[in] data Pointer to the first of @p amount contiguous elements
+ * @param[in] amount Number of elements to enqueue
+ * @return sat_status_t indicating success or failure of the operation
+ * 
+ * @note In ring mode the buffer grows at most once and the elements are
+ *       copied with at most two memcpy calls
+ */
+sat_status_t sat_queue_enqueue_many (sat_queue_t *const object, const void *const data, const uint32_t amount);
+
+/**
+ * @brief Removes up to @p amount elements from the front of the queue
+ * 
+ * @param[in,out] object Pointer to the queue
+ * @param[out] data Buffer able to hold @p amount elements
+ * @param[in] amount Maximum number of elements to dequeue
+ * @param[out] dequeued Number of elements actually dequeued
+ * @return sat_status_t indicating success, or failure if the queue is empty
+ */
+sat_status_t sat_queue_dequeue_many (sat_queue_t *const object, void *const data, const uint32_t amount, uint32_t *const dequeued);
+
+/**
+ * @brief Gets a reference to the element at the front of the queue
+ * 
+ * Returns a pointer to the front element without copying or removing it.
+ * 
+ * @param[in] object Pointer to the queue
+ * @param[out] data Pointer to store the reference to the front element
+ * @return sat_status_t indicating success, or failure if the queue is empty
+ * 
+ * @warning The reference becomes invalid after the next enqueue or dequeue
+ */
+sat_status_t sat_queue_peek (const sat_queue_t *const object, void **const data);
+
 /**
  * @brief Retrieves the current number of elements in the queue
  * 
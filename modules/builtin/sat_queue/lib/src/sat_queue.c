@@ -14,21 +14,65 @@ struct sat_queue_t
 {
     uint32_t object_size;
     uint32_t amount;
+    sat_queue_mode_t mode;
+    sat_allocator_t allocator;
     sat_linked_list_internal_t *start;
     sat_linked_list_internal_t *end;
+
+    struct
+    {
+        uint8_t *buffer;
+        uint32_t capacity;
+        uint32_t head;
+    } ring;
 };
 
+static sat_status_t sat_queue_ring_reserve (sat_queue_t *const object, const uint32_t amount);
+static void sat_queue_ring_write (sat_queue_t *const object, const void *const data, const uint32_t amount);
+static void sat_queue_ring_read (sat_queue_t *const object, void *const data, const uint32_t amount);
+
 sat_status_t sat_queue_create (sat_queue_t **const object, uint32_t object_size)
+{
+    return sat_queue_create_with_args (object, &(sat_queue_args_t)
+                                               {
+                                                   .object_size = object_size,
+                                                   .mode = sat_queue_mode_linked
+                                               });
+}
+
+sat_status_t sat_queue_create_with_args (sat_queue_t **const object, const sat_queue_args_t *const args)
 {
     sat_status_return_on_null (object, "null object");
-    sat_status_return_on_equals (object_size, 0, "zero object size");
-    
-    *object = (sat_queue_t *) calloc (1, sizeof (sat_queue_t));
-    sat_status_return_on_null (*object, "allocation failed");
+    sat_status_return_on_null (args, "null args");
+    sat_status_return_on_equals (args->object_size, 0, "zero object size");
+
+    if (args->mode != sat_queue_mode_linked && args->mode != sat_queue_mode_ring)
+    {
+        sat_status_return_on_failure ("invalid mode");
+    }
+
+    sat_queue_t *__object = (sat_queue_t *) sat_allocator_allocate_zeroed (&args->allocator, sizeof (sat_queue_t));
+    sat_status_return_on_null (__object, "allocation failed");
+
+    __object->allocator = args->allocator;
+    __object->object_size = args->object_size;
+    __object->mode = args->mode;
+    __object->start = NULL;
+    __object->end = NULL;
+
+    if (__object->mode == sat_queue_mode_ring)
+    {
+        __object->ring.capacity = args->capacity > 0 ? args->capacity : SAT_QUEUE_RING_CAPACITY_DEFAULT;
+        __object->ring.buffer = (uint8_t *) sat_allocator_allocate (&args->allocator, (size_t) __object->ring.capacity * __object->object_size);
+
+        if (__object->ring.buffer == NULL)
+        {
+            sat_allocator_release (&args->allocator, __object, sizeof (sat_queue_t));
+            sat_status_return_on_failure ("ring buffer allocation failed");
+        }
+    }
 
-    (*object)->object_size = object_size;
-    (*object)->start = NULL;
-    (*object)->end = NULL;
+    *object = __object;
 
     sat_status_return_on_success ();
 }
@@ -37,13 +81,22 @@ sat_status_t sat_queue_enqueue (sat_queue_t *const object, const void *const dat
 {
     sat_status_return_on_null (object, "null object");
     sat_status_return_on_null (data, "null data pointer");
-    sat_linked_list_internal_t *element = calloc (1, sizeof (sat_linked_list_internal_t));
+
+    if (object->mode == sat_queue_mode_ring)
+    {
+        sat_status_return_on_error (sat_queue_ring_reserve (object, 1));
+        sat_queue_ring_write (object, data, 1);
+
+        sat_status_return_on_success ();
+    }
+
+    sat_linked_list_internal_t *element = sat_allocator_allocate_zeroed (&object->allocator, sizeof (sat_linked_list_internal_t));
     sat_status_return_on_null (element, "element allocation failed");
 
-    element->data = calloc (1, object->object_size);
+    element->data = sat_allocator_allocate (&object->allocator, object->object_size);
     if (element->data == NULL)
     {
-        free (element);
+        sat_allocator_release (&object->allocator, element, sizeof (sat_linked_list_internal_t));
         sat_status_return_on_failure ("data allocation failed");
     }
 
@@ -71,6 +124,13 @@ sat_status_t sat_queue_dequeue (sat_queue_t *const object, void *const data)
     sat_status_return_on_null (data, "null data pointer");
     sat_status_return_on_equals (object->amount, 0, "queue is empty");
 
+    if (object->mode == sat_queue_mode_ring)
+    {
+        sat_queue_ring_read (object, data, 1);
+
+        sat_status_return_on_success ();
+    }
+
     sat_linked_list_internal_t *element = object->start;
 
     memcpy (data, element->data, object->object_size);
@@ -82,8 +142,8 @@ sat_status_t sat_queue_dequeue (sat_queue_t *const object, void *const data)
 
     object->amount --;
 
-    free (element->data);
-    free (element);
+    sat_allocator_release (&object->allocator, element->data, object->object_size);
+    sat_allocator_release (&object->allocator, element, sizeof (sat_linked_list_internal_t));
 
     sat_status_return_on_success ();
 }
@@ -103,6 +163,18 @@ sat_status_t sat_queue_debug (const sat_queue_t *const object, sat_queue_print_t
     sat_status_return_on_null (object, "null object");
     sat_status_return_on_null (print, "null print function");
 
+    if (object->mode == sat_queue_mode_ring)
+    {
+        for (uint32_t i = 0; i < object->amount; i++)
+        {
+            uint32_t position = (object->ring.head + i) % object->ring.capacity;
+
+            print (&object->ring.buffer [(size_t) position * object->object_size]);
+        }
+
+        sat_status_return_on_success ();
+    }
+
     sat_linked_list_internal_t *element = object->start;
 
     while (element != NULL)
@@ -123,13 +195,154 @@ sat_status_t sat_queue_destroy (sat_queue_t *const object)
     while (element != NULL)
     {
         sat_linked_list_internal_t *temp = element->next;
-        free (element->data);
-        free (element);
+        sat_allocator_release (&object->allocator, element->data, object->object_size);
+        sat_allocator_release (&object->allocator, element, sizeof (sat_linked_list_internal_t));
 
         element = temp;
     }
 
-    free (object);
+    sat_allocator_t allocator = object->allocator;
+
+    sat_allocator_release (&allocator, object->ring.buffer, (size_t) object->ring.capacity * object->object_size);
+    sat_allocator_release (&allocator, object, sizeof (sat_queue_t));
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_queue_enqueue_many (sat_queue_t *const object, const void *const data, const uint32_t amount)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data pointer");
+
+    if (object->mode == sat_queue_mode_ring)
+    {
+        sat_status_return_on_error (sat_queue_ring_reserve (object, amount));
+        sat_queue_ring_write (object, data, amount);
+
+        sat_status_return_on_success ();
+    }
+
+    const uint8_t *elements = (const uint8_t *) data;
+
+    for (uint32_t i = 0; i < amount; i++)
+    {
+        sat_status_return_on_error (sat_queue_enqueue (object, &elements [(size_t) i * object->object_size]));
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_queue_dequeue_many (sat_queue_t *const object, void *const data, const uint32_t amount, uint32_t *const dequeued)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data pointer");
+    sat_status_return_on_null (dequeued, "null dequeued pointer");
+    sat_status_return_on_equals (object->amount, 0, "queue is empty");
+
+    uint32_t count = amount < object->amount ? amount : object->amount;
+
+    if (object->mode == sat_queue_mode_ring)
+    {
+        sat_queue_ring_read (object, data, count);
+    }
+    else
+    {
+        uint8_t *elements = (uint8_t *) data;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            sat_queue_dequeue (object, &elements [(size_t) i * object->object_size]);
+        }
+    }
+
+    *dequeued = count;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_queue_peek (const sat_queue_t *const object, void **const data)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data pointer");
+    sat_status_return_on_equals (object->amount, 0, "queue is empty");
+
+    if (object->mode == sat_queue_mode_ring)
+        *data = &object->ring.buffer [(size_t) object->ring.head * object->object_size];
+    else
+        *data = object->start->data;
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_queue_ring_reserve (sat_queue_t *const object, const uint32_t amount)
+{
+    sat_status_return_on_greater_than (amount, UINT32_MAX - object->amount, "queue is full");
+
+    uint32_t required = object->amount + amount;
+
+    if (required <= object->ring.capacity)
+        sat_status_return_on_success ();
+
+    uint32_t capacity = object->ring.capacity;
+
+    while (capacity < required)
+    {
+        capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2;
+    }
+
+    uint8_t *buffer = (uint8_t *) sat_allocator_reallocate (&object->allocator,
+                                                            object->ring.buffer,
+                                                            (size_t) object->ring.capacity * object->object_size,
+                                                            (size_t) capacity * object->object_size);
+    sat_status_return_on_null (buffer, "ring buffer reallocation failed");
+
+    // a wrapped sequence keeps its tail at the start, move the head segment to the new end
+    if (object->ring.head + object->amount > object->ring.capacity)
+    {
+        uint32_t segment = object->ring.capacity - object->ring.head;
+        uint32_t head = capacity - segment;
+
+        memmove (&buffer [(size_t) head * object->object_size],
+                 &buffer [(size_t) object->ring.head * object->object_size],
+                 (size_t) segment * object->object_size);
+
+        object->ring.head = head;
+    }
+
+    object->ring.buffer = buffer;
+    object->ring.capacity = capacity;
 
     sat_status_return_on_success ();
-}
\ No newline at end of file
+}
+
+static void sat_queue_ring_write (sat_queue_t *const object, const void *const data, const uint32_t amount)
+{
+    uint32_t tail = (uint32_t) (((uint64_t) object->ring.head + object->amount) % object->ring.capacity);
+    uint32_t first = object->ring.capacity - tail;
+
+    if (first > amount)
+        first = amount;
+
+    memcpy (&object->ring.buffer [(size_t) tail * object->object_size], data, (size_t) first * object->object_size);
+    memcpy (object->ring.buffer, (const uint8_t *) data + (size_t) first * object->object_size, (size_t) (amount - first) * object->object_size);
+
+    object->amount += amount;
+}
+
+static void sat_queue_ring_read (sat_queue_t *const object, void *const data, const uint32_t amount)
+{
+    uint32_t first = object->ring.capacity - object->ring.head;
+
+    if (first > amount)
+        first = amount;
+
+    memcpy (data, &object->ring.buffer [(size_t) object->ring.head * object->object_size], (size_t) first * object->object_size);
+    memcpy ((uint8_t *) data + (size_t) first * object->object_size, object->ring.buffer, (size_t) (amount - first) * object->object_size);
+
+    object->ring.head = (uint32_t) (((uint64_t) object->ring.head + amount) % object->ring.capacity);
+    object->amount -= amount;
+
+    // restart at the beginning when empty so later batches are not split
+    if (object->amount == 0)
+        object->ring.head = 0;
+}
@@ -0,0 +1,130 @@
+#include <sat.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+typedef struct 
+{
+    uint32_t id;
+    char payload [20];
+} task_t;
+
+static void test_ring_fifo_and_growth (void)
+{
+    sat_queue_t *queue;
+    uint32_t size = 0;
+    task_t task;
+
+    sat_status_t status = sat_queue_create_with_args (&queue, &(sat_queue_args_t)
+                                                              {
+                                                                  .object_size = sizeof (task_t),
+                                                                  .mode = sat_queue_mode_ring,
+                                                                  .capacity = 4
+                                                              });
+    assert (sat_status_get_result (&status) == true);
+
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+
+    // interleave so the ring wraps before it has to grow
+    for (int round = 0; round < 100; round++)
+    {
+        for (int i = 0; i < 3 + round % 5; i++)
+        {
+            task = (task_t) {.id = next_in ++};
+            status = sat_queue_enqueue (queue, &task);
+            assert (sat_status_get_result (&status) == true);
+        }
+
+        for (int i = 0; i < 2 + round % 3; i++)
+        {
+            status = sat_queue_dequeue (queue, &task);
+            assert (sat_status_get_result (&status) == true);
+            assert (task.id == next_out ++);
+        }
+    }
+
+    status = sat_queue_get_size (queue, &size);
+    assert (sat_status_get_result (&status) == true);
+    assert (size == next_in - next_out);
+
+    while (next_out < next_in)
+    {
+        status = sat_queue_dequeue (queue, &task);
+        assert (sat_status_get_result (&status) == true);
+        assert (task.id == next_out ++);
+    }
+
+    status = sat_queue_dequeue (queue, &task);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_queue_destroy (queue);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_batches_and_peek (sat_queue_mode_t mode)
+{
+    sat_queue_t *queue;
+    task_t tasks [50];
+    task_t out [50];
+    uint32_t dequeued = 0;
+    void *front = NULL;
+
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        tasks [i] = (task_t) {.id = i};
+        snprintf (tasks [i].payload, sizeof (tasks [i].payload), "task %u", i);
+    }
+
+    sat_status_t status = sat_queue_create_with_args (&queue, &(sat_queue_args_t)
+                                                              {
+                                                                  .object_size = sizeof (task_t),
+                                                                  .mode = mode,
+                                                                  .capacity = 8
+                                                              });
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_queue_peek (queue, &front);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_queue_enqueue_many (queue, tasks, 5);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_queue_dequeue_many (queue, out, 3, &dequeued);
+    assert (sat_status_get_result (&status) == true);
+    assert (dequeued == 3);
+    assert (out [2].id == 2);
+
+    // wraps around and grows in one batch
+    status = sat_queue_enqueue_many (queue, &tasks [5], 45);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_queue_peek (queue, &front);
+    assert (sat_status_get_result (&status) == true);
+    assert (((task_t *) front)->id == 3);
+
+    status = sat_queue_dequeue_many (queue, out, 50, &dequeued);
+    assert (sat_status_get_result (&status) == true);
+    assert (dequeued == 47);
+
+    for (uint32_t i = 0; i < dequeued; i++)
+    {
+        assert (out [i].id == i + 3);
+        assert (strcmp (out [i].payload, tasks [i + 3].payload) == 0);
+    }
+
+    status = sat_queue_dequeue_many (queue, out, 50, &dequeued);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_queue_destroy (queue);
+    assert (sat_status_get_result (&status) == true);
+}
+
+int main (int argc, char *argv[])
+{
+    test_ring_fifo_and_growth ();
+    test_batches_and_peek (sat_queue_mode_ring);
+    test_batches_and_peek (sat_queue_mode_linked);
+
+    return 0;
+}
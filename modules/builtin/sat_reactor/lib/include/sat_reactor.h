@@ -0,0 +1,261 @@
+/**
+ * @file sat_reactor.h
+ * @brief Single-threaded event loop built on epoll
+ *
+ * This module multiplexes any number of descriptors on one thread. Callers
+ * register a handler for a descriptor and the reactor calls it whenever the
+ * descriptor becomes ready. Besides plain descriptors such as sockets, the
+ * reactor creates and owns descriptors for:
+ *
+ * - timers (timerfd), one-shot or periodic, with millisecond resolution;
+ * - signals (signalfd), delivered as ordinary events instead of interrupting
+ *   whatever the thread was doing;
+ * - wakeups (eventfd), which any thread may trigger with sat_reactor_notify().
+ *
+ * Registrations are kept in a table indexed by descriptor, so looking one up
+ * costs the same with ten sockets as with ten thousand, and a single
+ * epoll_wait() reports up to capacity ready descriptors at once.
+ *
+ * Apart from the functions marked as safe to call from any thread, a reactor
+ * is used from the thread that runs it, usually from within its handlers.
+ *
+ * The SAT I/O modules can run on a reactor instead of their own loops; see
+ * sat_channel_attach(), sat_udp_attach(), sat_tcp_attach() and
+ * sat_scheduler_attach().
+ */
+
+#ifndef SAT_REACTOR_H_
+#define SAT_REACTOR_H_
+
+#include <sat_status.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of ready descriptors handled per wait when none is given
+ */
+#define SAT_REACTOR_CAPACITY_DEFAULT    256
+
+/**
+ * @brief Readiness flags, combined with a bitwise or
+ */
+typedef enum
+{
+    sat_reactor_event_read = 1 << 0,    /**< Data to read, a connection to accept or a peer that closed */
+    sat_reactor_event_write = 1 << 1,   /**< Room to write */
+    sat_reactor_event_error = 1 << 2,   /**< Error or hangup; always reported, never needs to be asked for */
+    sat_reactor_event_edge = 1 << 3,    /**< Report a change of state once instead of while it lasts */
+} sat_reactor_event_t;
+
+/**
+ * @brief Function called when a registered descriptor is ready
+ *
+ * @param fd The descriptor that is ready
+ * @param events The sat_reactor_event_t flags that apply
+ * @param data Context pointer given at registration
+ */
+typedef void (*sat_reactor_handler_t) (int fd, uint32_t events, void *data);
+
+/**
+ * @brief Registration, internal to the reactor
+ */
+typedef struct sat_reactor_source_t sat_reactor_source_t;
+
+/**
+ * @brief Reactor structure
+ *
+ * This structure should be treated as opaque and accessed only through
+ * the provided API functions.
+ */
+typedef struct
+{
+    int epoll;                          /**< The epoll instance */
+    int wakeup;                         /**< eventfd that interrupts the wait on stop */
+    sat_reactor_source_t **sources;     /**< Registrations indexed by descriptor */
+    uint32_t sources_amount;            /**< Number of slots in sources */
+    uint32_t amount;                    /**< Number of registrations */
+    uint32_t generation;                /**< Counter that tells a reused descriptor from the old one */
+    void *events;                       /**< Buffer for epoll_wait() */
+    uint32_t capacity;                  /**< Number of entries in events */
+    bool stopping;                      /**< Set by sat_reactor_stop(), cleared when sat_reactor_run() returns */
+} sat_reactor_t;
+
+/**
+ * @brief Configuration structure for opening a reactor
+ */
+typedef struct
+{
+    uint32_t capacity;                  /**< Ready descriptors handled per wait, 0 for SAT_REACTOR_CAPACITY_DEFAULT */
+} sat_reactor_args_t;
+
+/**
+ * @brief Initialize a reactor
+ *
+ * @param object Pointer to the reactor structure
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_init (sat_reactor_t *const object);
+
+/**
+ * @brief Open a reactor
+ *
+ * Creates the epoll instance and the buffers used by the loop.
+ *
+ * @param object Pointer to the initialized reactor
+ * @param args Pointer to the configuration, or NULL for the defaults
+ * @return Status structure indicating success or failure
+ * @see sat_reactor_close()
+ */
+sat_status_t sat_reactor_open (sat_reactor_t *const object, const sat_reactor_args_t *const args);
+
+/**
+ * @brief Register a descriptor
+ *
+ * The descriptor stays owned by the caller, who must remove it from the
+ * reactor before closing it.
+ *
+ * @param object Pointer to the opened reactor
+ * @param fd Descriptor to watch
+ * @param events sat_reactor_event_t flags to watch for
+ * @param handler Function called when the descriptor is ready
+ * @param data Context pointer passed to the handler
+ * @return Status structure indicating success or failure
+ * @note Fails if the descriptor is already registered
+ */
+sat_status_t sat_reactor_add (sat_reactor_t *const object, int fd, uint32_t events, sat_reactor_handler_t handler, void *const data);
+
+/**
+ * @brief Change the events watched on a registered descriptor
+ *
+ * @param object Pointer to the opened reactor
+ * @param fd Registered descriptor
+ * @param events New sat_reactor_event_t flags
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_modify (sat_reactor_t *const object, int fd, uint32_t events);
+
+/**
+ * @brief Unregister a descriptor
+ *
+ * Descriptors created by the reactor (timers, signals, wakeups) are closed as
+ * well. A handler may remove any descriptor, including its own; events already
+ * collected for a removed descriptor are dropped.
+ *
+ * @param object Pointer to the opened reactor
+ * @param fd Registered descriptor
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_remove (sat_reactor_t *const object, int fd);
+
+/**
+ * @brief Register a timer
+ *
+ * The handler runs timeout milliseconds from now and then, if interval is
+ * not zero, every interval milliseconds. If the loop falls behind, expirations
+ * are merged into a single call.
+ *
+ * @param object Pointer to the opened reactor
+ * @param timeout First expiration in milliseconds, 0 to leave the timer disarmed
+ * @param interval Period in milliseconds, 0 for a one-shot timer
+ * @param handler Function called on expiration
+ * @param data Context pointer passed to the handler
+ * @param[out] fd Pointer to store the timer descriptor, used to rearm or remove it
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_add_timer (sat_reactor_t *const object, uint64_t timeout, uint64_t interval, sat_reactor_handler_t handler, void *const data, int *const fd);
+
+/**
+ * @brief Rearm or disarm a timer
+ *
+ * Safe to call from any thread.
+ *
+ * @param object Pointer to the opened reactor
+ * @param fd Timer descriptor from sat_reactor_add_timer()
+ * @param timeout Next expiration in milliseconds, 0 to disarm
+ * @param interval Period in milliseconds, 0 for a one-shot timer
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_set_timer (sat_reactor_t *const object, int fd, uint64_t timeout, uint64_t interval);
+
+/**
+ * @brief Register a signal
+ *
+ * The signal is blocked in the calling thread and delivered to the handler
+ * by the loop instead.
+ *
+ * @param object Pointer to the opened reactor
+ * @param signal Signal number
+ * @param handler Function called when the signal arrives
+ * @param data Context pointer passed to the handler
+ * @param[out] fd Pointer to store the signal descriptor, used to remove it
+ * @return Status structure indicating success or failure
+ * @warning Other threads must block the signal too, or it may go to them;
+ *          register signals before starting any thread
+ */
+sat_status_t sat_reactor_add_signal (sat_reactor_t *const object, int signal, sat_reactor_handler_t handler, void *const data, int *const fd);
+
+/**
+ * @brief Register a wakeup
+ *
+ * @param object Pointer to the opened reactor
+ * @param handler Function called on the reactor thread after sat_reactor_notify()
+ * @param data Context pointer passed to the handler
+ * @param[out] fd Pointer to store the wakeup descriptor
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_add_wakeup (sat_reactor_t *const object, sat_reactor_handler_t handler, void *const data, int *const fd);
+
+/**
+ * @brief Trigger a wakeup
+ *
+ * Safe to call from any thread. Several notifications before the loop gets
+ * to the wakeup result in a single call of its handler.
+ *
+ * @param object Pointer to the opened reactor
+ * @param fd Wakeup descriptor from sat_reactor_add_wakeup()
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_notify (sat_reactor_t *const object, int fd);
+
+/**
+ * @brief Wait once and run the handlers of the ready descriptors
+ *
+ * @param object Pointer to the opened reactor
+ * @param timeout Longest wait in milliseconds, -1 to wait indefinitely, 0 to only poll
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_run_once (sat_reactor_t *const object, int timeout);
+
+/**
+ * @brief Run the loop on the calling thread until sat_reactor_stop()
+ *
+ * @param object Pointer to the opened reactor
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_run (sat_reactor_t *const object);
+
+/**
+ * @brief Make sat_reactor_run() return
+ *
+ * Safe to call from any thread, including from a handler. A stop requested
+ * while the loop is not running makes the next sat_reactor_run() return
+ * right away.
+ *
+ * @param object Pointer to the opened reactor
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_stop (sat_reactor_t *const object);
+
+/**
+ * @brief Close the reactor
+ *
+ * Closes the descriptors the reactor created. Descriptors registered with
+ * sat_reactor_add() are left open.
+ *
+ * @param object Pointer to the reactor
+ * @return Status structure indicating success or failure
+ * @warning The loop must not be running
+ */
+sat_status_t sat_reactor_close (sat_reactor_t *const object);
+
+#endif/* SAT_REACTOR_H_ */
@@ -0,0 +1,150 @@
+/**
+ * @file sat_reactor_group.h
+ * @brief Reactors on threads of their own, one per CPU
+ *
+ * A group opens a number of reactors and runs each on a thread of its own,
+ * pinned to a CPU the process may use and named after the group. It is what
+ * sits behind the SO_REUSEPORT listeners of sat_tcp and sat_udp: every
+ * listener binds a socket of its own to the shared port and serves it from
+ * one reactor of the group.
+ *
+ * When steered, the kernel hands a connection or datagram to the socket
+ * whose reactor is pinned to the CPU that received it, so it is served on
+ * the core whose caches already hold it.
+ */
+
+#ifndef SAT_REACTOR_GROUP_H_
+#define SAT_REACTOR_GROUP_H_
+
+#include <sat_reactor.h>
+#include <sat_status.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+ * @brief Reactor of a group, internal to the group
+ */
+typedef struct
+{
+    sat_reactor_t reactor;              /**< The loop */
+    pthread_t thread;                   /**< Thread running the loop once started */
+    int cpu;                            /**< CPU the thread is pinned to, -1 for any */
+    bool opened;                        /**< Reactor opened */
+    bool running;                       /**< Thread started and not yet joined */
+} sat_reactor_group_item_t;
+
+/**
+ * @brief Reactor group structure
+ *
+ * This structure should be treated as opaque and accessed only through
+ * the provided API functions.
+ */
+typedef struct
+{
+    sat_reactor_group_item_t *items;    /**< One per reactor */
+    uint16_t amount;                    /**< Number of reactors */
+    bool steer_by_cpu;                  /**< One reactor per CPU, so sat_reactor_group_steer() applies */
+    char name [10];                     /**< Prefix of the thread names, short enough for "/<index>" */
+} sat_reactor_group_t;
+
+/**
+ * @brief Configuration structure for opening a group
+ */
+typedef struct
+{
+    uint16_t amount;                    /**< Number of reactors, each on a thread of its own */
+    const char *name;                   /**< Threads are named "<name>/<index>", NULL for "reactor", at most 9 characters */
+    bool steer_by_cpu;                  /**< At most one reactor per CPU, for sat_reactor_group_steer() */
+} sat_reactor_group_args_t;
+
+/**
+ * @brief Open a group
+ *
+ * Opens the reactors and picks the CPU of each: reactor i goes to the i-th
+ * CPU the process may use, wrapping around when there are more reactors than
+ * CPUs. Nothing runs until sat_reactor_group_start().
+ *
+ * @param object Pointer to the group structure
+ * @param args Pointer to the configuration
+ * @return Status structure indicating success or failure
+ * @note With steer_by_cpu, fails when there are more reactors than CPUs the
+ *       process may use, as the extra ones would never be chosen
+ * @see sat_reactor_group_close()
+ */
+sat_status_t sat_reactor_group_open (sat_reactor_group_t *const object, const sat_reactor_group_args_t *const args);
+
+/**
+ * @brief Get a reactor of the group
+ *
+ * Descriptors are registered on it before the group starts, or from its own
+ * handlers afterwards.
+ *
+ * @param object Pointer to the opened group
+ * @param index Index of the reactor
+ * @return The reactor, or NULL if index is out of range
+ */
+sat_reactor_t *sat_reactor_group_get (sat_reactor_group_t *const object, const uint16_t index);
+
+/**
+ * @brief Steer a SO_REUSEPORT socket group by CPU
+ *
+ * Attaches a classic BPF program to the socket group of the given socket
+ * that maps the CPU of each connection or datagram to the index of the
+ * reactor pinned to it. Traffic from other CPUs is spread by the kernel's
+ * hash as usual.
+ *
+ * @param object Pointer to the opened group
+ * @param socket Any socket of the SO_REUSEPORT group
+ * @return Status structure indicating success or failure
+ * @warning The i-th socket bound to the port must be served by reactor i
+ */
+sat_status_t sat_reactor_group_steer (const sat_reactor_group_t *const object, const int socket);
+
+/**
+ * @brief Get the port a socket is bound to
+ *
+ * With port 0 the kernel picks one when the first socket binds, and the
+ * others of a SO_REUSEPORT group must bind the same.
+ *
+ * @param socket Bound socket
+ * @param[out] service Buffer for the port number as a string
+ * @param size Size of the buffer
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_group_get_service (const int socket, char *const service, const size_t size);
+
+/**
+ * @brief Start the threads of the group
+ *
+ * Each thread is pinned before it starts and runs its reactor until
+ * sat_reactor_group_stop().
+ *
+ * @param object Pointer to the opened group
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_group_start (sat_reactor_group_t *const object);
+
+/**
+ * @brief Stop the threads of the group and wait for them
+ *
+ * The reactors stay open, so their descriptors can be removed and closed
+ * from the calling thread afterwards.
+ *
+ * @param object Pointer to the group
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_group_stop (sat_reactor_group_t *const object);
+
+/**
+ * @brief Close the group
+ *
+ * Stops the threads if they are running and closes the reactors.
+ *
+ * @param object Pointer to the group
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_reactor_group_close (sat_reactor_group_t *const object);
+
+#endif/* SAT_REACTOR_GROUP_H_ */
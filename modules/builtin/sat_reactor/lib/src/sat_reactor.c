@@ -0,0 +1,462 @@
+#include <sat_reactor.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <sys/eventfd.h>
+
+#define SAT_REACTOR_SOURCES_MIN     64
+#define SAT_REACTOR_STOP            UINT64_MAX  // epoll data of the internal wakeup
+
+typedef enum
+{
+    sat_reactor_kind_descriptor,    // owned by the caller
+    sat_reactor_kind_timer,
+    sat_reactor_kind_signal,
+    sat_reactor_kind_wakeup,
+} sat_reactor_kind_t;
+
+struct sat_reactor_source_t
+{
+    int fd;
+    sat_reactor_kind_t kind;
+    uint32_t generation;
+    sat_reactor_handler_t handler;
+    void *data;
+};
+
+static sat_status_t sat_reactor_insert (sat_reactor_t *const object, int fd, sat_reactor_kind_t kind, uint32_t events, sat_reactor_handler_t handler, void *const data);
+static sat_reactor_source_t *sat_reactor_find (const sat_reactor_t *const object, int fd);
+static bool sat_reactor_grow (sat_reactor_t *const object, int fd);
+static bool sat_reactor_consume (const sat_reactor_source_t *const source);
+static uint32_t sat_reactor_to_epoll (uint32_t events);
+static uint32_t sat_reactor_from_epoll (uint32_t events);
+static struct timespec sat_reactor_to_timespec (uint64_t milliseconds);
+
+sat_status_t sat_reactor_init (sat_reactor_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    memset (object, 0, sizeof (sat_reactor_t));
+
+    object->epoll = -1;
+    object->wakeup = -1;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_open (sat_reactor_t *const object, const sat_reactor_args_t *const args)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_not_equals (object->epoll, -1, "reactor already open");
+
+    object->capacity = (args == NULL || args->capacity == 0) ? SAT_REACTOR_CAPACITY_DEFAULT : args->capacity;
+
+    object->events = calloc (object->capacity, sizeof (struct epoll_event));
+    object->epoll = epoll_create1 (EPOLL_CLOEXEC);
+    object->wakeup = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    struct epoll_event event = {.events = EPOLLIN, .data.u64 = SAT_REACTOR_STOP};
+
+    if (object->events == NULL || object->epoll < 0 || object->wakeup < 0 ||
+        epoll_ctl (object->epoll, EPOLL_CTL_ADD, object->wakeup, &event) != 0)
+    {
+        sat_reactor_close (object);
+        sat_status_return_on_failure ("reactor open failed");
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_add (sat_reactor_t *const object, int fd, uint32_t events, sat_reactor_handler_t handler, void *const data)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    return sat_reactor_insert (object, fd, sat_reactor_kind_descriptor, events, handler, data);
+}
+
+sat_status_t sat_reactor_modify (sat_reactor_t *const object, int fd, uint32_t events)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    sat_reactor_source_t *source = sat_reactor_find (object, fd);
+    sat_status_return_on_null (source, "descriptor not registered");
+
+    struct epoll_event event =
+    {
+        .events = sat_reactor_to_epoll (events),
+        .data.u64 = (uint64_t) source->generation << 32 | (uint32_t) fd,
+    };
+
+    sat_status_return_on_not_equals (epoll_ctl (object->epoll, EPOLL_CTL_MOD, fd, &event), 0, "epoll modify failed");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_remove (sat_reactor_t *const object, int fd)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    sat_reactor_source_t *source = sat_reactor_find (object, fd);
+    sat_status_return_on_null (source, "descriptor not registered");
+
+    // Fails harmlessly if the caller already closed the descriptor.
+    epoll_ctl (object->epoll, EPOLL_CTL_DEL, fd, NULL);
+
+    if (source->kind != sat_reactor_kind_descriptor)
+        close (fd);
+
+    object->sources [fd] = NULL;
+    object->amount --;
+
+    free (source);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_add_timer (sat_reactor_t *const object, uint64_t timeout, uint64_t interval, sat_reactor_handler_t handler, void *const data, int *const fd)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (fd, "fd is null");
+
+    int timer = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    sat_status_return_on_less_than (timer, 0, "timerfd failed");
+
+    sat_status_t status = sat_reactor_insert (object, timer, sat_reactor_kind_timer, sat_reactor_event_read, handler, data);
+
+    if (sat_status_get_result (&status) == false)
+    {
+        close (timer);
+        return status;
+    }
+
+    status = sat_reactor_set_timer (object, timer, timeout, interval);
+
+    if (sat_status_get_result (&status) == false)
+    {
+        sat_reactor_remove (object, timer);
+        return status;
+    }
+
+    *fd = timer;
+
+    return status;
+}
+
+sat_status_t sat_reactor_set_timer (sat_reactor_t *const object, int fd, uint64_t timeout, uint64_t interval)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_less_than (fd, 0, "invalid descriptor");
+
+    // Not looked up in the table, which only the reactor thread may touch.
+    struct itimerspec value =
+    {
+        .it_value = sat_reactor_to_timespec (timeout),
+        .it_interval = sat_reactor_to_timespec (interval),
+    };
+
+    sat_status_return_on_not_equals (timerfd_settime (fd, 0, &value, NULL), 0, "timerfd settime failed");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_add_signal (sat_reactor_t *const object, int signal, sat_reactor_handler_t handler, void *const data, int *const fd)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (fd, "fd is null");
+
+    sigset_t set;
+
+    sigemptyset (&set);
+    sat_status_return_on_not_equals (sigaddset (&set, signal), 0, "invalid signal");
+
+    // A signal that is not blocked is delivered the usual way and never reaches the descriptor.
+    sat_status_return_on_not_equals (pthread_sigmask (SIG_BLOCK, &set, NULL), 0, "signal mask failed");
+
+    int descriptor = signalfd (-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+    sat_status_return_on_less_than (descriptor, 0, "signalfd failed");
+
+    sat_status_t status = sat_reactor_insert (object, descriptor, sat_reactor_kind_signal, sat_reactor_event_read, handler, data);
+
+    if (sat_status_get_result (&status) == false)
+    {
+        close (descriptor);
+        return status;
+    }
+
+    *fd = descriptor;
+
+    return status;
+}
+
+sat_status_t sat_reactor_add_wakeup (sat_reactor_t *const object, sat_reactor_handler_t handler, void *const data, int *const fd)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (fd, "fd is null");
+
+    int descriptor = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+    sat_status_return_on_less_than (descriptor, 0, "eventfd failed");
+
+    sat_status_t status = sat_reactor_insert (object, descriptor, sat_reactor_kind_wakeup, sat_reactor_event_read, handler, data);
+
+    if (sat_status_get_result (&status) == false)
+    {
+        close (descriptor);
+        return status;
+    }
+
+    *fd = descriptor;
+
+    return status;
+}
+
+sat_status_t sat_reactor_notify (sat_reactor_t *const object, int fd)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_less_than (fd, 0, "invalid descriptor");
+
+    uint64_t one = 1;
+    ssize_t written;
+
+    while ((written = write (fd, &one, sizeof (one))) < 0 && errno == EINTR)
+        ;
+
+    // A saturated counter is still readable, so the wakeup is not lost.
+    sat_status_return_on_false ((written == sizeof (one) || errno == EAGAIN), "notify failed");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_run_once (sat_reactor_t *const object, int timeout)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_less_than (object->epoll, 0, "reactor not open");
+
+    struct epoll_event *events = (struct epoll_event *) object->events;
+    int amount = epoll_wait (object->epoll, events, object->capacity, timeout);
+
+    if (amount < 0)
+    {
+        sat_status_return_on_not_equals (errno, EINTR, "epoll wait failed");
+        sat_status_return_on_success ();
+    }
+
+    for (int i = 0; i < amount; i++)
+    {
+        if (events [i].data.u64 == SAT_REACTOR_STOP)
+        {
+            uint64_t count;
+            while (read (object->wakeup, &count, sizeof (count)) < 0 && errno == EINTR)
+                ;
+
+            continue;
+        }
+
+        int fd = (int) (uint32_t) events [i].data.u64;
+        sat_reactor_source_t *source = sat_reactor_find (object, fd);
+
+        // Removed by an earlier handler of this batch, maybe replaced by a new one on the same number.
+        if (source == NULL || source->generation != (uint32_t) (events [i].data.u64 >> 32))
+            continue;
+
+        if (sat_reactor_consume (source) == false)
+            continue;
+
+        // The handler may remove the source, so it is not touched afterwards.
+        source->handler (fd, sat_reactor_from_epoll (events [i].events), source->data);
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_run (sat_reactor_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    sat_status_t status = sat_status_success (&status);
+
+    while (__atomic_load_n (&object->stopping, __ATOMIC_ACQUIRE) == false && sat_status_get_result (&status) == true)
+        status = sat_reactor_run_once (object, -1);
+
+    __atomic_store_n (&object->stopping, false, __ATOMIC_RELEASE);
+
+    return status;
+}
+
+sat_status_t sat_reactor_stop (sat_reactor_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    __atomic_store_n (&object->stopping, true, __ATOMIC_RELEASE);
+
+    return sat_reactor_notify (object, object->wakeup);
+}
+
+sat_status_t sat_reactor_close (sat_reactor_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    for (uint32_t i = 0; i < object->sources_amount; i++)
+    {
+        sat_reactor_source_t *source = object->sources [i];
+
+        if (source != NULL && source->kind != sat_reactor_kind_descriptor)
+            close (source->fd);
+
+        free (source);
+    }
+
+    if (object->epoll >= 0)
+        close (object->epoll);
+
+    if (object->wakeup >= 0)
+        close (object->wakeup);
+
+    free (object->sources);
+    free (object->events);
+
+    return sat_reactor_init (object);
+}
+
+static sat_status_t sat_reactor_insert (sat_reactor_t *const object, int fd, sat_reactor_kind_t kind, uint32_t events, sat_reactor_handler_t handler, void *const data)
+{
+    sat_status_return_on_less_than (object->epoll, 0, "reactor not open");
+    sat_status_return_on_less_than (fd, 0, "invalid descriptor");
+    sat_status_return_on_null (handler, "handler is null");
+    sat_status_return_on_false (sat_reactor_grow (object, fd), "sources allocation failed");
+    sat_status_return_on_not_equals (object->sources [fd], NULL, "descriptor already registered");
+
+    sat_reactor_source_t *source = (sat_reactor_source_t *) calloc (1, sizeof (sat_reactor_source_t));
+    sat_status_return_on_null (source, "source allocation failed");
+
+    source->fd = fd;
+    source->kind = kind;
+    source->generation = ++ object->generation;
+    source->handler = handler;
+    source->data = data;
+
+    struct epoll_event event =
+    {
+        .events = sat_reactor_to_epoll (events),
+        .data.u64 = (uint64_t) source->generation << 32 | (uint32_t) fd,
+    };
+
+    if (epoll_ctl (object->epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        free (source);
+        sat_status_return_on_failure ("epoll add failed");
+    }
+
+    object->sources [fd] = source;
+    object->amount ++;
+
+    sat_status_return_on_success ();
+}
+
+static sat_reactor_source_t *sat_reactor_find (const sat_reactor_t *const object, int fd)
+{
+    if (fd < 0 || (uint32_t) fd >= object->sources_amount)
+        return NULL;
+
+    return object->sources [fd];
+}
+
+static bool sat_reactor_grow (sat_reactor_t *const object, int fd)
+{
+    if ((uint32_t) fd < object->sources_amount)
+        return true;
+
+    // Descriptors are handed out lowest first, so the table stays dense.
+    uint32_t amount = object->sources_amount == 0 ? SAT_REACTOR_SOURCES_MIN : object->sources_amount;
+
+    while (amount <= (uint32_t) fd)
+        amount *= 2;
+
+    sat_reactor_source_t **sources = (sat_reactor_source_t **) realloc (object->sources, amount * sizeof (sat_reactor_source_t *));
+
+    if (sources == NULL)
+        return false;
+
+    memset (&sources [object->sources_amount], 0, (amount - object->sources_amount) * sizeof (sat_reactor_source_t *));
+
+    object->sources = sources;
+    object->sources_amount = amount;
+
+    return true;
+}
+
+static bool sat_reactor_consume (const sat_reactor_source_t *const source)
+{
+    bool status = true;
+
+    if (source->kind == sat_reactor_kind_timer || source->kind == sat_reactor_kind_wakeup)
+    {
+        uint64_t count;
+        ssize_t result;
+
+        while ((result = read (source->fd, &count, sizeof (count))) < 0 && errno == EINTR)
+            ;
+
+        // A timer rearmed after it was reported has nothing to read.
+        status = result == sizeof (count);
+    }
+
+    else if (source->kind == sat_reactor_kind_signal)
+    {
+        struct signalfd_siginfo info;
+        ssize_t result;
+
+        status = false;
+
+        while ((result = read (source->fd, &info, sizeof (info))) == sizeof (info) || (result < 0 && errno == EINTR))
+            status = status || result == sizeof (info);
+    }
+
+    return status;
+}
+
+static uint32_t sat_reactor_to_epoll (uint32_t events)
+{
+    uint32_t flags = 0;
+
+    if (events & sat_reactor_event_read)
+        flags |= EPOLLIN;
+
+    if (events & sat_reactor_event_write)
+        flags |= EPOLLOUT;
+
+    if (events & sat_reactor_event_edge)
+        flags |= EPOLLET;
+
+    return flags;
+}
+
+static uint32_t sat_reactor_from_epoll (uint32_t events)
+{
+    uint32_t flags = 0;
+
+    if (events & EPOLLIN)
+        flags |= sat_reactor_event_read;
+
+    if (events & EPOLLOUT)
+        flags |= sat_reactor_event_write;
+
+    if (events & (EPOLLERR | EPOLLHUP))
+        flags |= sat_reactor_event_error;
+
+    return flags;
+}
+
+static struct timespec sat_reactor_to_timespec (uint64_t milliseconds)
+{
+    return (struct timespec)
+    {
+        .tv_sec = (time_t) (milliseconds / 1000),
+        .tv_nsec = (long) (milliseconds % 1000) * 1000000,
+    };
+}
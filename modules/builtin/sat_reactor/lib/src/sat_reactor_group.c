@@ -0,0 +1,230 @@
+#include <sat_reactor_group.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sched.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <linux/filter.h>
+
+#define SAT_REACTOR_GROUP_NAME      "reactor"
+#define SAT_REACTOR_GROUP_ANY       UINT32_MAX  // out of range: the kernel falls back to its hash
+
+static sat_status_t sat_reactor_group_pin (sat_reactor_group_t *const object, const bool steer_by_cpu);
+static void *sat_reactor_group_thread (void *args);
+
+sat_status_t sat_reactor_group_open (sat_reactor_group_t *const object, const sat_reactor_group_args_t *const args)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_null (args, "args is null");
+    sat_status_return_on_equals (args->amount, 0, "no reactors");
+
+    memset (object, 0, sizeof (sat_reactor_group_t));
+
+    object->items = (sat_reactor_group_item_t *) calloc (args->amount, sizeof (sat_reactor_group_item_t));
+    sat_status_return_on_null (object->items, "items allocation failed");
+
+    object->amount = args->amount;
+    object->steer_by_cpu = args->steer_by_cpu;
+
+    snprintf (object->name, sizeof (object->name), "%s", args->name != NULL ? args->name : SAT_REACTOR_GROUP_NAME);
+
+    sat_status_t status = sat_reactor_group_pin (object, args->steer_by_cpu);
+
+    for (uint16_t i = 0; i < object->amount && sat_status_get_result (&status) == true; i++)
+    {
+        sat_reactor_init (&object->items [i].reactor);
+
+        status = sat_reactor_open (&object->items [i].reactor, NULL);
+        object->items [i].opened = sat_status_get_result (&status);
+    }
+
+    if (sat_status_get_result (&status) == false)
+        sat_reactor_group_close (object);
+
+    return status;
+}
+
+sat_reactor_t *sat_reactor_group_get (sat_reactor_group_t *const object, const uint16_t index)
+{
+    return object != NULL && index < object->amount ? &object->items [index].reactor : NULL;
+}
+
+sat_status_t sat_reactor_group_steer (const sat_reactor_group_t *const object, const int socket)
+{
+    sat_status_return_on_null (object, "object is null");
+    sat_status_return_on_false (object->steer_by_cpu, "group not opened to be steered by cpu");
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    uint32_t length = (uint32_t) object->amount * 2 + 2;
+
+    sat_status_return_on_greater_than (length, BPF_MAXINSNS, "too many reactors to steer");
+
+    struct sock_filter *code = (struct sock_filter *) calloc (length, sizeof (struct sock_filter));
+    sat_status_return_on_null (code, "program allocation failed");
+
+    // A jump table from the CPU that took the packet to the index of the
+    // reactor pinned to it, so any set of CPUs the process may use works.
+    code [0] = (struct sock_filter) BPF_STMT (BPF_LD | BPF_W | BPF_ABS, SKF_AD_OFF + SKF_AD_CPU);
+
+    for (uint16_t i = 0; i < object->amount; i++)
+    {
+        code [1 + i * 2] = (struct sock_filter) BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, (uint32_t) object->items [i].cpu, 0, 1);
+        code [2 + i * 2] = (struct sock_filter) BPF_STMT (BPF_RET | BPF_K, i);
+    }
+
+    code [length - 1] = (struct sock_filter) BPF_STMT (BPF_RET | BPF_K, SAT_REACTOR_GROUP_ANY);
+
+    struct sock_fprog program =
+    {
+        .len = (unsigned short) length,
+        .filter = code,
+    };
+
+    int result = setsockopt (socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof (program));
+
+    free (code);
+
+    sat_status_return_on_not_equals (result, 0, "steering program attach failed");
+
+    sat_status_return_on_success ();
+#else
+    sat_status_return_on_failure ("steering by cpu not supported");
+#endif
+}
+
+sat_status_t sat_reactor_group_get_service (const int socket, char *const service, const size_t size)
+{
+    struct sockaddr_storage address;
+    socklen_t length = sizeof (address);
+
+    sat_status_return_on_null (service, "service is null");
+    sat_status_return_on_not_equals (getsockname (socket, (struct sockaddr *) &address, &length), 0, "socket address unknown");
+    sat_status_return_on_not_equals (getnameinfo ((struct sockaddr *) &address, length, NULL, 0, service, size, NI_NUMERICSERV), 0, "service unknown");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_group_start (sat_reactor_group_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    for (uint16_t i = 0; i < object->amount; i++)
+    {
+        sat_reactor_group_item_t *item = &object->items [i];
+        pthread_attr_t attributes;
+        cpu_set_t set;
+
+        if (item->running == true)
+            continue;
+
+        pthread_attr_init (&attributes);
+
+        // Pinned before it starts, so what it serves stays warm in one cache.
+        if (item->cpu >= 0)
+        {
+            CPU_ZERO (&set);
+            CPU_SET (item->cpu, &set);
+            pthread_attr_setaffinity_np (&attributes, sizeof (set), &set);
+        }
+
+        int result = pthread_create (&item->thread, &attributes, sat_reactor_group_thread, &item->reactor);
+
+        pthread_attr_destroy (&attributes);
+
+        sat_status_return_on_not_equals (result, 0, "thread creation failed");
+
+        item->running = true;
+
+        char name [16];
+
+        snprintf (name, sizeof (name), "%s/%u", object->name, (unsigned) i);
+        pthread_setname_np (item->thread, name);
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_group_stop (sat_reactor_group_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    for (uint16_t i = 0; i < object->amount; i++)
+    {
+        if (object->items [i].running == true)
+            sat_reactor_stop (&object->items [i].reactor);
+    }
+
+    for (uint16_t i = 0; i < object->amount; i++)
+    {
+        if (object->items [i].running == true)
+        {
+            pthread_join (object->items [i].thread, NULL);
+            object->items [i].running = false;
+        }
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_reactor_group_close (sat_reactor_group_t *const object)
+{
+    sat_status_return_on_null (object, "object is null");
+
+    sat_reactor_group_stop (object);
+
+    for (uint16_t i = 0; i < object->amount; i++)
+    {
+        if (object->items [i].opened == true)
+            sat_reactor_close (&object->items [i].reactor);
+    }
+
+    free (object->items);
+
+    memset (object, 0, sizeof (sat_reactor_group_t));
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_reactor_group_pin (sat_reactor_group_t *const object, const bool steer_by_cpu)
+{
+    cpu_set_t set;
+    int cpus = 0;
+
+    CPU_ZERO (&set);
+
+    if (sched_getaffinity (0, sizeof (set), &set) == 0)
+        cpus = CPU_COUNT (&set);
+
+    for (uint16_t i = 0; i < object->amount; i++)
+        object->items [i].cpu = -1;
+
+    // Steering picks one reactor per CPU, so a second one on a CPU would
+    // never be picked.
+    sat_status_return_on_false ((steer_by_cpu == false || (cpus > 0 && object->amount <= cpus)), "more reactors than usable cpus to steer by");
+
+    // Reactor i takes the i-th CPU the process may use, wrapping around.
+    for (uint16_t i = 0; i < object->amount && cpus > 0; i++)
+    {
+        int wanted = i % cpus;
+
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET (cpu, &set) && wanted-- == 0)
+            {
+                object->items [i].cpu = cpu;
+                break;
+            }
+        }
+    }
+
+    sat_status_return_on_success ();
+}
+
+static void *sat_reactor_group_thread (void *args)
+{
+    sat_reactor_run ((sat_reactor_t *) args);
+
+    return NULL;
+}
@@ -0,0 +1,107 @@
+#include <sat.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#define SERVICE_NAME    "9999"
+#define BUFFER_SIZE     1024
+
+typedef struct
+{
+    sat_reactor_t *reactor;
+    uint32_t requests;
+} context_t;
+
+static void on_receive (char *buffer, uint32_t *size, void *data)
+{
+    context_t *context = (context_t *) data;
+
+    context->requests ++;
+    printf ("Server: %.*s", (int) *size, buffer);
+}
+
+static void on_send (char *buffer, uint32_t *size, void *data)
+{
+    (void) data;
+
+    const char *reply = "Hello World\n";
+
+    memcpy (buffer, reply, strlen (reply));
+    *size = strlen (reply);
+}
+
+static void on_report (int fd, uint32_t events, void *data)
+{
+    context_t *context = (context_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    printf ("%u requests so far\n", context->requests);
+}
+
+static void on_interrupt (int fd, uint32_t events, void *data)
+{
+    context_t *context = (context_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    printf ("stopping\n");
+    sat_reactor_stop (context->reactor);
+}
+
+int main (int argc, char **argv)
+{
+    sat_reactor_t reactor;
+    sat_tcp_t server;
+    char buffer [BUFFER_SIZE] = {0};
+    int timer;
+    int signal;
+
+    context_t context = {.reactor = &reactor};
+
+    sat_reactor_init (&reactor);
+
+    sat_status_t status = sat_reactor_open (&reactor, NULL);
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    // Ctrl-C ends the loop instead of the process.
+    sat_reactor_add_signal (&reactor, SIGINT, on_interrupt, &context, &signal);
+    sat_reactor_add_timer (&reactor, 5000, 5000, on_report, &context, &timer);
+
+    sat_tcp_init (&server);
+
+    status = sat_tcp_open (&server, &(sat_tcp_args_t)
+                                    {
+                                        .type = sat_tcp_type_server,
+                                        .server =
+                                        {
+                                            .service = SERVICE_NAME,
+                                            .buffer = buffer,
+                                            .size = BUFFER_SIZE,
+                                            .events = {.on_receive = on_receive, .on_send = on_send},
+                                            .data = &context,
+                                            .type = sat_tcp_server_type_interactive,
+                                        }
+                                    });
+    if (sat_status_get_result (&status) == false)
+    {
+        sat_reactor_close (&reactor);
+        return 1;
+    }
+
+    // Any number of clients on this one thread, e.g. several "nc localhost 9999".
+    sat_tcp_attach (&server, &reactor);
+
+    printf ("listening on port %s, Ctrl-C to stop\n", SERVICE_NAME);
+
+    sat_reactor_run (&reactor);
+
+    sat_tcp_close (&server);
+    sat_reactor_close (&reactor);
+
+    return 0;
+}
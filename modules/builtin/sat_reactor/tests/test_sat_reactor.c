@@ -0,0 +1,293 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#define TEST_PAIRS          200
+
+typedef struct
+{
+    sat_reactor_t *reactor;
+    int pairs [TEST_PAIRS][2];
+    uint32_t received;
+    uint32_t calls;
+    int fd;
+} test_context_t;
+
+static void test_open (sat_reactor_t *const reactor)
+{
+    sat_status_t status = sat_reactor_init (reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_open (reactor, &(sat_reactor_args_t) {.capacity = 16});
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_on_readable (int fd, uint32_t events, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+    char buffer [16];
+
+    assert (events & sat_reactor_event_read);
+
+    if (read (fd, buffer, sizeof (buffer)) > 0)
+        context->received ++;
+}
+
+static void test_sockets (void)
+{
+    sat_reactor_t reactor;
+    test_context_t context = {0};
+
+    test_open (&reactor);
+
+    // More descriptors than a single wait reports, spread over a growing table.
+    for (uint32_t i = 0; i < TEST_PAIRS; i++)
+    {
+        assert (socketpair (AF_UNIX, SOCK_STREAM, 0, context.pairs [i]) == 0);
+
+        sat_status_t status = sat_reactor_add (&reactor, context.pairs [i][0], sat_reactor_event_read, test_on_readable, &context);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    sat_status_t status = sat_reactor_add (&reactor, context.pairs [0][0], sat_reactor_event_read, test_on_readable, &context);
+    assert (sat_status_get_result (&status) == false);
+
+    for (uint32_t i = 0; i < TEST_PAIRS; i++)
+        assert (write (context.pairs [i][1], "x", 1) == 1);
+
+    while (context.received < TEST_PAIRS)
+    {
+        status = sat_reactor_run_once (&reactor, 1000);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    // Nothing left to report.
+    status = sat_reactor_run_once (&reactor, 0);
+    assert (sat_status_get_result (&status) == true);
+    assert (context.received == TEST_PAIRS);
+
+    status = sat_reactor_modify (&reactor, context.pairs [0][0], sat_reactor_event_read | sat_reactor_event_write);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < TEST_PAIRS; i++)
+    {
+        status = sat_reactor_remove (&reactor, context.pairs [i][0]);
+        assert (sat_status_get_result (&status) == true);
+
+        close (context.pairs [i][0]);
+        close (context.pairs [i][1]);
+    }
+
+    status = sat_reactor_remove (&reactor, context.pairs [0][0]);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_reactor_close (&reactor);
+}
+
+static void test_on_remove_all (int fd, uint32_t events, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    context->calls ++;
+
+    // Every pair is readable, so the events of the others are already collected.
+    for (uint32_t i = 0; i < 4; i++)
+        sat_reactor_remove (context->reactor, context->pairs [i][0]);
+}
+
+static void test_remove_in_handler (void)
+{
+    sat_reactor_t reactor;
+    test_context_t context = {.reactor = &reactor};
+
+    test_open (&reactor);
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        assert (socketpair (AF_UNIX, SOCK_STREAM, 0, context.pairs [i]) == 0);
+        assert (write (context.pairs [i][1], "x", 1) == 1);
+
+        sat_reactor_add (&reactor, context.pairs [i][0], sat_reactor_event_read, test_on_remove_all, &context);
+    }
+
+    sat_status_t status = sat_reactor_run_once (&reactor, 1000);
+    assert (sat_status_get_result (&status) == true);
+    assert (context.calls == 1);
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        close (context.pairs [i][0]);
+        close (context.pairs [i][1]);
+    }
+
+    sat_reactor_close (&reactor);
+}
+
+static void test_on_timer (int fd, uint32_t events, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    if (++ context->calls == 3)
+        sat_reactor_stop (context->reactor);
+}
+
+static void test_timers (void)
+{
+    sat_reactor_t reactor;
+    test_context_t periodic = {.reactor = &reactor};
+    test_context_t one_shot = {.reactor = &reactor};
+    int fd;
+
+    test_open (&reactor);
+
+    sat_status_t status = sat_reactor_add_timer (&reactor, 5, 5, test_on_timer, &periodic, &fd);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_add_timer (&reactor, 1, 0, test_on_timer, &one_shot, &one_shot.fd);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_run (&reactor);
+    assert (sat_status_get_result (&status) == true);
+    assert (periodic.calls == 3);
+    assert (one_shot.calls == 1);
+
+    // A disarmed timer stays quiet until it is armed again.
+    status = sat_reactor_set_timer (&reactor, fd, 0, 0);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_run_once (&reactor, 20);
+    assert (sat_status_get_result (&status) == true);
+    assert (periodic.calls == 3);
+
+    status = sat_reactor_set_timer (&reactor, one_shot.fd, 1, 0);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_run_once (&reactor, 1000);
+    assert (sat_status_get_result (&status) == true);
+    assert (one_shot.calls == 2);
+
+    status = sat_reactor_remove (&reactor, fd);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_reactor_close (&reactor);
+}
+
+static void test_on_signal (int fd, uint32_t events, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    context->calls ++;
+}
+
+static void test_signal (void)
+{
+    sat_reactor_t reactor;
+    test_context_t context = {0};
+    int fd;
+
+    test_open (&reactor);
+
+    sat_status_t status = sat_reactor_add_signal (&reactor, SIGUSR1, test_on_signal, &context, &fd);
+    assert (sat_status_get_result (&status) == true);
+
+    // Blocked, so it waits for the loop instead of killing the process.
+    raise (SIGUSR1);
+
+    status = sat_reactor_run_once (&reactor, 1000);
+    assert (sat_status_get_result (&status) == true);
+    assert (context.calls == 1);
+
+    sat_reactor_close (&reactor);
+}
+
+static void test_on_wakeup (int fd, uint32_t events, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    context->calls ++;
+    sat_reactor_stop (context->reactor);
+}
+
+static void *test_notifier (void *args)
+{
+    test_context_t *context = (test_context_t *) args;
+
+    usleep (10000);
+
+    sat_status_t status = sat_reactor_notify (context->reactor, context->fd);
+    assert (sat_status_get_result (&status) == true);
+
+    return NULL;
+}
+
+static void *test_stopper (void *args)
+{
+    sat_reactor_t *reactor = (sat_reactor_t *) args;
+
+    usleep (10000);
+    sat_reactor_stop (reactor);
+
+    return NULL;
+}
+
+static void test_threads (void)
+{
+    sat_reactor_t reactor;
+    test_context_t context = {.reactor = &reactor};
+    pthread_t thread;
+
+    test_open (&reactor);
+
+    sat_status_t status = sat_reactor_add_wakeup (&reactor, test_on_wakeup, &context, &context.fd);
+    assert (sat_status_get_result (&status) == true);
+
+    pthread_create (&thread, NULL, test_notifier, &context);
+
+    status = sat_reactor_run (&reactor);
+    assert (sat_status_get_result (&status) == true);
+    assert (context.calls == 1);
+
+    pthread_join (thread, NULL);
+
+    pthread_create (&thread, NULL, test_stopper, &reactor);
+
+    status = sat_reactor_run (&reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    pthread_join (thread, NULL);
+
+    // A stop before the loop runs is not lost.
+    sat_reactor_stop (&reactor);
+
+    status = sat_reactor_run (&reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_reactor_close (&reactor);
+}
+
+int main (int argc, char *argv[])
+{
+    test_sockets ();
+    test_remove_in_handler ();
+    test_timers ();
+    test_signal ();
+    test_threads ();
+
+    return 0;
+}
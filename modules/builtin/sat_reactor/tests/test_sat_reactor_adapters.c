@@ -0,0 +1,314 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define TEST_TCP_SERVICE    "9191"
+
+typedef struct
+{
+    sat_reactor_t *reactor;
+    uint32_t calls;
+} test_context_t;
+
+static void test_open (sat_reactor_t *const reactor)
+{
+    sat_status_t status = sat_reactor_init (reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_open (reactor, NULL);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static int test_connect (int type, uint16_t port)
+{
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons (port)};
+    struct timeval timeout = {.tv_sec = 1};
+
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = socket (AF_INET, type, 0);
+    assert (fd >= 0);
+
+    setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout));
+    assert (connect (fd, (struct sockaddr *) &address, sizeof (address)) == 0);
+
+    return fd;
+}
+
+static void test_on_channel (sat_channel_t *const channel, void *const data)
+{
+    test_context_t *context = (test_context_t *) data;
+    char buffer [16];
+    uint32_t size;
+
+    // Messages already buffered by the channel raise no further event, so drain them all.
+    do
+    {
+        sat_status_t status = sat_channel_receive (channel, buffer, sizeof (buffer), &size);
+        assert (sat_status_get_result (&status) == true);
+
+        if (size > 0)
+            context->calls ++;
+
+    } while (size > 0);
+}
+
+static void test_channel (const sat_channel_mode_t mode)
+{
+    sat_reactor_t reactor;
+    sat_channel_t channel;
+    test_context_t context = {.reactor = &reactor};
+
+    test_open (&reactor);
+
+    sat_channel_init (&channel);
+
+    sat_status_t status = sat_channel_open (&channel, &(sat_channel_args_t) {.mode = mode, .non_blocking = true});
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_channel_attach (&channel, &reactor, test_on_channel, &context);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_channel_attach (&channel, &reactor, test_on_channel, &context);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_channel_send (&channel, "one", 3);
+    sat_channel_send (&channel, "two", 3);
+
+    while (context.calls < 2)
+    {
+        status = sat_reactor_run_once (&reactor, 1000);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    // Closing an attached channel takes it off the reactor.
+    sat_channel_close (&channel);
+
+    sat_reactor_close (&reactor);
+}
+
+static void test_on_receive (char *const buffer, uint32_t *const size, void *const data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    assert (*size == 4);
+    assert (memcmp (buffer, "ping", 4) == 0);
+
+    context->calls ++;
+}
+
+static void test_on_send (char *const buffer, uint32_t *const size, void *const data)
+{
+    (void) data;
+
+    memcpy (buffer, "pong", 4);
+    *size = 4;
+}
+
+static void test_udp (void)
+{
+    sat_reactor_t reactor;
+    sat_udp_t server;
+    test_context_t context = {.reactor = &reactor};
+    char buffer [64];
+    uint16_t port;
+
+    test_open (&reactor);
+
+    sat_udp_init (&server);
+
+    sat_status_t status = sat_udp_open (&server, &(sat_udp_args_t)
+                                                 {
+                                                     .type = sat_udp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = "0",
+                                                         .buffer = buffer,
+                                                         .size = sizeof (buffer),
+                                                         .events = {.on_receive = test_on_receive, .on_send = test_on_send},
+                                                         .data = &context,
+                                                         .type = sat_udp_server_type_async,
+                                                     }
+                                                 });
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_udp_attach (&server, &reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_udp_get_port (&server, &port);
+    assert (sat_status_get_result (&status) == true);
+
+    int client = test_connect (SOCK_DGRAM, port);
+
+    // Several datagrams are served by a single wakeup.
+    for (uint32_t i = 0; i < 3; i++)
+        assert (send (client, "ping", 4, 0) == 4);
+
+    while (context.calls < 3)
+    {
+        status = sat_reactor_run_once (&reactor, 1000);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        char reply [8];
+
+        assert (recv (client, reply, sizeof (reply), 0) == 4);
+        assert (memcmp (reply, "pong", 4) == 0);
+    }
+
+    close (client);
+
+    sat_udp_close (&server);
+    sat_reactor_close (&reactor);
+}
+
+static void test_tcp (void)
+{
+    sat_reactor_t reactor;
+    sat_tcp_t server;
+    test_context_t context = {.reactor = &reactor};
+    char buffer [64];
+    int clients [3];
+
+    test_open (&reactor);
+
+    sat_tcp_init (&server);
+
+    sat_status_t status = sat_tcp_open (&server, &(sat_tcp_args_t)
+                                                 {
+                                                     .type = sat_tcp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = TEST_TCP_SERVICE,
+                                                         .buffer = buffer,
+                                                         .size = sizeof (buffer),
+                                                         .events = {.on_receive = (sat_tcp_event_t) test_on_receive, .on_send = (sat_tcp_event_t) test_on_send},
+                                                         .data = &context,
+                                                         .type = sat_tcp_server_type_interactive,
+                                                     }
+                                                 });
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_tcp_attach (&server, &reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    // Clients are served side by side instead of one after the other.
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        clients [i] = test_connect (SOCK_STREAM, (uint16_t) atoi (TEST_TCP_SERVICE));
+        assert (send (clients [i], "ping", 4, 0) == 4);
+    }
+
+    while (context.calls < 3)
+    {
+        status = sat_reactor_run_once (&reactor, 1000);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        char reply [8];
+
+        assert (recv (clients [i], reply, sizeof (reply), 0) == 4);
+        assert (memcmp (reply, "pong", 4) == 0);
+    }
+
+    // A client that leaves is dropped; the others stay connected.
+    close (clients [0]);
+
+    status = sat_reactor_run_once (&reactor, 1000);
+    assert (sat_status_get_result (&status) == true);
+
+    assert (send (clients [1], "ping", 4, 0) == 4);
+
+    while (context.calls < 4)
+        sat_reactor_run_once (&reactor, 1000);
+
+    sat_tcp_close (&server);
+
+    close (clients [1]);
+    close (clients [2]);
+
+    sat_reactor_close (&reactor);
+}
+
+static void test_on_event (void *object)
+{
+    test_context_t *context = (test_context_t *) object;
+
+    if (++ context->calls == 5)
+        sat_reactor_stop (context->reactor);
+}
+
+static void test_scheduler (void)
+{
+    sat_reactor_t reactor;
+    sat_scheduler_t scheduler;
+    test_context_t periodic = {.reactor = &reactor};
+    test_context_t one_shot = {.reactor = &reactor};
+
+    test_open (&reactor);
+
+    sat_scheduler_init (&scheduler);
+
+    sat_status_t status = sat_scheduler_open (&scheduler, &(sat_scheduler_args_t) {.event_amount = 2, .mode = sat_scheduler_mode_static});
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_scheduler_attach (&scheduler, &reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                         {
+                                             .name = "periodic",
+                                             .object = &periodic,
+                                             .handler = test_on_event,
+                                             .type = sat_scheduler_type_periodic,
+                                             .timeout = 2,
+                                         });
+
+    sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                         {
+                                             .name = "one shot",
+                                             .object = &one_shot,
+                                             .handler = test_on_event,
+                                             .type = sat_scheduler_type_one_shot,
+                                             .timeout = 1,
+                                         });
+
+    status = sat_scheduler_start (&scheduler);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_run (&reactor);
+    assert (sat_status_get_result (&status) == true);
+    assert (periodic.calls == 5);
+    assert (one_shot.calls == 1);
+
+    status = sat_scheduler_stop (&scheduler);
+    assert (sat_status_get_result (&status) == true);
+
+    // Stopped, the timer is disarmed.
+    status = sat_reactor_run_once (&reactor, 20);
+    assert (sat_status_get_result (&status) == true);
+    assert (periodic.calls == 5);
+
+    sat_scheduler_close (&scheduler);
+    sat_reactor_close (&reactor);
+}
+
+int main (int argc, char *argv[])
+{
+    test_channel (sat_channel_mode_message);
+    test_channel (sat_channel_mode_ring);
+    test_udp ();
+    test_tcp ();
+    test_scheduler ();
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define TEST_REACTORS       4
+
+typedef struct
+{
+    uint16_t index;
+    char name [16];
+    uint32_t calls;
+    int fd;
+} test_context_t;
+
+static int test_cpus (void)
+{
+    cpu_set_t set;
+
+    CPU_ZERO (&set);
+    assert (sched_getaffinity (0, sizeof (set), &set) == 0);
+
+    return CPU_COUNT (&set);
+}
+
+static void test_on_wakeup (int fd, uint32_t events, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    pthread_getname_np (pthread_self (), context->name, sizeof (context->name));
+    __atomic_add_fetch (&context->calls, 1, __ATOMIC_RELEASE);
+}
+
+static void test_run (void)
+{
+    sat_reactor_group_t group;
+    test_context_t contexts [TEST_REACTORS];
+
+    sat_status_t status = sat_reactor_group_open (&group, &(sat_reactor_group_args_t) {.amount = TEST_REACTORS, .name = "test"});
+    assert (sat_status_get_result (&status) == true);
+
+    assert (sat_reactor_group_get (&group, TEST_REACTORS) == NULL);
+
+    for (uint16_t i = 0; i < TEST_REACTORS; i++)
+    {
+        contexts [i] = (test_context_t) {.index = i};
+
+        status = sat_reactor_add_wakeup (sat_reactor_group_get (&group, i), test_on_wakeup, &contexts [i], &contexts [i].fd);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_reactor_group_start (&group);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint16_t i = 0; i < TEST_REACTORS; i++)
+        sat_reactor_notify (sat_reactor_group_get (&group, i), contexts [i].fd);
+
+    // Each wakeup runs on the thread of its own reactor.
+    for (uint16_t i = 0; i < TEST_REACTORS; i++)
+    {
+        char name [16];
+
+        while (__atomic_load_n (&contexts [i].calls, __ATOMIC_ACQUIRE) == 0)
+            usleep (1000);
+
+        snprintf (name, sizeof (name), "test/%u", (unsigned) i);
+        assert (strcmp (contexts [i].name, name) == 0);
+    }
+
+    status = sat_reactor_group_stop (&group);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_group_close (&group);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_steer (void)
+{
+    sat_reactor_group_t group;
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_addr.s_addr = htonl (INADDR_LOOPBACK)};
+    char service [8];
+    int cpus = test_cpus ();
+    int enable = 1;
+
+    int fd = socket (AF_INET, SOCK_DGRAM, 0);
+    assert (fd >= 0);
+    assert (setsockopt (fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof (enable)) == 0);
+    assert (bind (fd, (struct sockaddr *) &address, sizeof (address)) == 0);
+
+    sat_status_t status = sat_reactor_group_get_service (fd, service, sizeof (service));
+    assert (sat_status_get_result (&status) == true);
+    assert (atoi (service) > 0);
+
+    // Not opened to be steered.
+    status = sat_reactor_group_open (&group, &(sat_reactor_group_args_t) {.amount = 1});
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_group_steer (&group, fd);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_reactor_group_close (&group);
+
+    // A reactor more than there are CPUs would never be picked.
+    status = sat_reactor_group_open (&group, &(sat_reactor_group_args_t) {.amount = (uint16_t) (cpus + 1), .steer_by_cpu = true});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_reactor_group_open (&group, &(sat_reactor_group_args_t) {.amount = (uint16_t) cpus, .steer_by_cpu = true});
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_reactor_group_steer (&group, fd);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_reactor_group_close (&group);
+
+    close (fd);
+}
+
+static void test_invalid (void)
+{
+    sat_reactor_group_t group;
+
+    sat_status_t status = sat_reactor_group_open (&group, &(sat_reactor_group_args_t) {.amount = 0});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_reactor_group_open (NULL, &(sat_reactor_group_args_t) {.amount = 1});
+    assert (sat_status_get_result (&status) == false);
+
+    assert (sat_reactor_group_get (NULL, 0) == NULL);
+}
+
+int main (int argc, char *argv[])
+{
+    test_run ();
+    test_steer ();
+    test_invalid ();
+
+    return 0;
+}
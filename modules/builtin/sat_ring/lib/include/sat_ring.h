@@ -0,0 +1,194 @@
+/**
+ * @file sat_ring.h
+ * @brief Bounded lock-free ring queues for inter-thread handoff
+ *
+ * This module provides fixed-capacity FIFO queues that move elements between
+ * threads without taking a lock or entering the kernel on the fast path.
+ * Two variants are available:
+ *
+ * - sat_ring_type_spsc: one producer thread and one consumer thread. Each side
+ *   owns its index and keeps a cached copy of the other side's index, so a
+ *   push or pop touches shared cache lines only when the cached view runs out.
+ * - sat_ring_type_mpmc: any number of producers and consumers. Each slot
+ *   carries a sequence number and positions are claimed with a compare and
+ *   swap, so a stalled thread never blocks the others from making progress on
+ *   different slots.
+ *
+ * Producer and consumer indices live on separate cache lines to avoid false
+ * sharing. Blocking push and pop spin briefly and then, depending on the
+ * wakeup mode, yield the processor or sleep on a futex or an eventfd. The
+ * sleeping side is only woken when it has announced itself, so producers and
+ * consumers that keep up with each other never make a system call.
+ */
+
+#ifndef SAT_RING_H_
+#define SAT_RING_H_
+
+#include <sat_status.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Cache line size, in bytes, used to pad the ring indices
+ */
+#define SAT_RING_CACHE_LINE_SIZE    64
+
+/**
+ * @brief Opaque structure representing a ring queue
+ *
+ * This structure holds the internal state of the ring.
+ * Users should not access its fields directly.
+ */
+typedef struct sat_ring_t sat_ring_t;
+
+/**
+ * @brief Ring concurrency model
+ */
+typedef enum
+{
+    sat_ring_type_spsc,     /**< Single producer, single consumer */
+    sat_ring_type_mpmc,     /**< Multiple producers, multiple consumers */
+} sat_ring_type_t;
+
+/**
+ * @brief How blocking calls wait once the ring stays full or empty
+ */
+typedef enum
+{
+    sat_ring_wakeup_spin,       /**< Busy wait, yielding the processor between attempts */
+    sat_ring_wakeup_futex,      /**< Sleep on a private futex until the other side makes progress */
+    sat_ring_wakeup_eventfd,    /**< Consumers sleep on an eventfd that can also be polled, producers on a futex */
+} sat_ring_wakeup_t;
+
+/**
+ * @brief Configuration structure for ring creation
+ */
+typedef struct
+{
+    sat_ring_type_t type;           /**< Concurrency model */
+    sat_ring_wakeup_t wakeup;       /**< Wait strategy for sat_ring_push() and sat_ring_pop() */
+    uint32_t capacity;              /**< Number of elements, rounded up to a power of two */
+    uint32_t object_size;           /**< Size in bytes of each element */
+} sat_ring_args_t;
+
+/**
+ * @brief Creates a new ring queue
+ *
+ * Allocates the ring and all of its slots up front; no further allocation
+ * happens during push or pop.
+ *
+ * @param[out] object Pointer to the pointer that will hold the created ring
+ * @param[in] args Pointer to the configuration structure
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note The caller is responsible for calling sat_ring_destroy() to free resources
+ * @see sat_ring_destroy()
+ */
+sat_status_t sat_ring_create (sat_ring_t **const object, const sat_ring_args_t *const args);
+
+/**
+ * @brief Adds an element to the ring without waiting
+ *
+ * @param[in,out] object Pointer to the ring
+ * @param[in] data Pointer to the element to copy into the ring
+ * @return sat_status_t indicating success, or failure if the ring is full or closed
+ *
+ * @warning In sat_ring_type_spsc only one thread may push
+ */
+sat_status_t sat_ring_try_push (sat_ring_t *const object, const void *const data);
+
+/**
+ * @brief Removes the oldest element from the ring without waiting
+ *
+ * @param[in,out] object Pointer to the ring
+ * @param[out] data Buffer that receives a copy of the element
+ * @return sat_status_t indicating success, or failure if the ring is empty
+ *
+ * @warning In sat_ring_type_spsc only one thread may pop
+ */
+sat_status_t sat_ring_try_pop (sat_ring_t *const object, void *const data);
+
+/**
+ * @brief Adds an element to the ring, waiting while it is full
+ *
+ * @param[in,out] object Pointer to the ring
+ * @param[in] data Pointer to the element to copy into the ring
+ * @return sat_status_t indicating success, or failure if the ring is closed
+ *
+ * @see sat_ring_close()
+ */
+sat_status_t sat_ring_push (sat_ring_t *const object, const void *const data);
+
+/**
+ * @brief Removes the oldest element from the ring, waiting while it is empty
+ *
+ * Elements pushed before the ring was closed are still delivered; the call
+ * fails only once the ring is both closed and empty.
+ *
+ * @param[in,out] object Pointer to the ring
+ * @param[out] data Buffer that receives a copy of the element
+ * @return sat_status_t indicating success, or failure if the ring is closed and empty
+ *
+ * @see sat_ring_close()
+ */
+sat_status_t sat_ring_pop (sat_ring_t *const object, void *const data);
+
+/**
+ * @brief Closes the ring and releases every blocked caller
+ *
+ * Further pushes fail. Pops keep draining the remaining elements.
+ *
+ * @param[in,out] object Pointer to the ring
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_ring_close (sat_ring_t *const object);
+
+/**
+ * @brief Gets the eventfd that signals elements are available
+ *
+ * Only available in sat_ring_wakeup_eventfd. The descriptor is non-blocking
+ * and becomes readable when a consumer sleeping in sat_ring_pop() has to be
+ * woken and permanently after sat_ring_close(). Once this function has been
+ * called, a push that makes an empty ring non-empty signals it as well, so an
+ * event loop can poll the descriptor, read it once and then call
+ * sat_ring_try_pop() until it fails before polling again.
+ *
+ * @param[in] object Pointer to the ring
+ * @param[out] fd Pointer to store the descriptor
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note The descriptor is owned by the ring and closed by sat_ring_destroy()
+ */
+sat_status_t sat_ring_get_fd (sat_ring_t *const object, int *const fd);
+
+/**
+ * @brief Retrieves the number of elements in the ring
+ *
+ * @param[in] object Pointer to the ring
+ * @param[out] size Pointer to store the number of elements
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @note While other threads are pushing or popping the value is a snapshot
+ */
+sat_status_t sat_ring_get_size (const sat_ring_t *const object, uint32_t *const size);
+
+/**
+ * @brief Retrieves the number of slots in the ring
+ *
+ * @param[in] object Pointer to the ring
+ * @param[out] capacity Pointer to store the capacity
+ * @return sat_status_t indicating success or failure of the operation
+ */
+sat_status_t sat_ring_get_capacity (const sat_ring_t *const object, uint32_t *const capacity);
+
+/**
+ * @brief Destroys the ring and frees all associated resources
+ *
+ * @param[in,out] object Pointer to the ring to destroy
+ * @return sat_status_t indicating success or failure of the operation
+ *
+ * @warning No thread may be using the ring when it is destroyed
+ */
+sat_status_t sat_ring_destroy (sat_ring_t *const object);
+
+#endif/* SAT_RING_H_ */
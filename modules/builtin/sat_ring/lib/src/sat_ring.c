@@ -0,0 +1,555 @@
+#include <sat_ring.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define SAT_RING_CAPACITY_MAX       (1u << 30)
+#define SAT_RING_SPIN_LIMIT         128
+#define SAT_RING_CELL_HEADER        8
+
+#define sat_ring_aligned __attribute__ ((aligned (SAT_RING_CACHE_LINE_SIZE)))
+
+typedef struct
+{
+    uint32_t position;      /* next position this side will use */
+    uint32_t cached;        /* last observed position of the other side (spsc) */
+} sat_ring_index_t;
+
+typedef struct
+{
+    uint32_t sequence;      /* futex word, bumped to release sleepers */
+    uint32_t waiting;       /* threads that announced they are about to sleep */
+} sat_ring_waiters_t;
+
+struct sat_ring_t
+{
+    sat_ring_type_t type;
+    sat_ring_wakeup_t wakeup;
+    uint32_t capacity;
+    uint32_t mask;
+    uint32_t object_size;
+    uint32_t stride;
+    uint8_t *buffer;
+    int fd;
+    bool polled;
+    bool closed;
+
+    sat_ring_index_t producer sat_ring_aligned;
+    sat_ring_index_t consumer sat_ring_aligned;
+    sat_ring_waiters_t items sat_ring_aligned;
+    sat_ring_waiters_t spaces sat_ring_aligned;
+};
+
+static bool sat_ring_spsc_push (sat_ring_t *const object, const void *const data, uint32_t *const position);
+static bool sat_ring_spsc_pop (sat_ring_t *const object, void *const data);
+static bool sat_ring_mpmc_push (sat_ring_t *const object, const void *const data, uint32_t *const position);
+static bool sat_ring_mpmc_pop (sat_ring_t *const object, void *const data);
+static bool sat_ring_push_slot (sat_ring_t *const object, const void *const data);
+static bool sat_ring_pop_slot (sat_ring_t *const object, void *const data);
+static void sat_ring_notify_items (sat_ring_t *const object, const uint32_t position);
+static void sat_ring_notify_spaces (sat_ring_t *const object);
+static bool sat_ring_wake (sat_ring_t *const object, sat_ring_waiters_t *const waiters, const bool eventfd);
+static void sat_ring_signal_fd (sat_ring_t *const object, uint64_t value);
+static void sat_ring_sleep (sat_ring_t *const object, sat_ring_waiters_t *const waiters, const uint32_t sequence, const bool eventfd);
+static bool sat_ring_is_closed (const sat_ring_t *const object);
+static void sat_ring_relax (void);
+
+sat_status_t sat_ring_create (sat_ring_t **const object, const sat_ring_args_t *const args)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (args, "null args");
+    sat_status_return_on_equals (args->object_size, 0, "zero object size");
+    sat_status_return_on_equals (args->capacity, 0, "zero capacity");
+    sat_status_return_on_greater_than (args->capacity, SAT_RING_CAPACITY_MAX, "capacity too large");
+
+    if (args->type != sat_ring_type_spsc && args->type != sat_ring_type_mpmc)
+    {
+        sat_status_return_on_failure ("invalid type");
+    }
+
+    if (args->wakeup != sat_ring_wakeup_spin &&
+        args->wakeup != sat_ring_wakeup_futex &&
+        args->wakeup != sat_ring_wakeup_eventfd)
+    {
+        sat_status_return_on_failure ("invalid wakeup");
+    }
+
+    uint32_t capacity = 1;
+    while (capacity < args->capacity)
+        capacity <<= 1;
+
+    uint32_t stride = args->object_size;
+    if (args->type == sat_ring_type_mpmc)
+        stride = SAT_RING_CELL_HEADER + ((args->object_size + 7u) & ~7u);
+
+    void *memory = NULL;
+    if (posix_memalign (&memory, SAT_RING_CACHE_LINE_SIZE, sizeof (sat_ring_t)) != 0)
+    {
+        sat_status_return_on_failure ("allocation failed");
+    }
+
+    sat_ring_t *__object = (sat_ring_t *) memory;
+    memset (__object, 0, sizeof (sat_ring_t));
+
+    __object->type = args->type;
+    __object->wakeup = args->wakeup;
+    __object->capacity = capacity;
+    __object->mask = capacity - 1;
+    __object->object_size = args->object_size;
+    __object->stride = stride;
+    __object->fd = -1;
+
+    if (posix_memalign (&memory, SAT_RING_CACHE_LINE_SIZE, (size_t) capacity * stride) != 0)
+    {
+        free (__object);
+        sat_status_return_on_failure ("ring buffer allocation failed");
+    }
+
+    __object->buffer = (uint8_t *) memory;
+
+    if (__object->type == sat_ring_type_mpmc)
+    {
+        for (uint32_t i = 0; i < capacity; i++)
+        {
+            uint32_t *sequence = (uint32_t *) (__object->buffer + (size_t) i * stride);
+            *sequence = i;
+        }
+    }
+
+    if (__object->wakeup == sat_ring_wakeup_eventfd)
+    {
+        __object->fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (__object->fd < 0)
+        {
+            free (__object->buffer);
+            free (__object);
+            sat_status_return_on_failure ("eventfd creation failed");
+        }
+    }
+
+    *object = __object;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_try_push (sat_ring_t *const object, const void *const data)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data pointer");
+    sat_status_return_on_equals (sat_ring_is_closed (object), true, "ring is closed");
+    sat_status_return_on_false (sat_ring_push_slot (object, data), "ring is full");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_try_pop (sat_ring_t *const object, void *const data)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data pointer");
+    sat_status_return_on_false (sat_ring_pop_slot (object, data), "ring is empty");
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_push (sat_ring_t *const object, const void *const data)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data pointer");
+
+    for (uint32_t spin = 0; ; spin++)
+    {
+        sat_status_return_on_equals (sat_ring_is_closed (object), true, "ring is closed");
+
+        if (sat_ring_push_slot (object, data) == true)
+            break;
+
+        if (spin < SAT_RING_SPIN_LIMIT)
+        {
+            sat_ring_relax ();
+            continue;
+        }
+
+        if (object->wakeup == sat_ring_wakeup_spin)
+        {
+            sched_yield ();
+            continue;
+        }
+
+        // Read the sequence before announcing ourselves: a notifier that
+        // resets the waiting count afterwards also bumps the sequence.
+        uint32_t sequence = __atomic_load_n (&object->spaces.sequence, __ATOMIC_ACQUIRE);
+
+        __atomic_add_fetch (&object->spaces.waiting, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence (__ATOMIC_SEQ_CST);
+
+        if (sat_ring_is_closed (object) == false && sat_ring_push_slot (object, data) == true)
+            break;
+
+        if (sat_ring_is_closed (object) == false)
+            sat_ring_sleep (object, &object->spaces, sequence, false);
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_pop (sat_ring_t *const object, void *const data)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data pointer");
+
+    for (uint32_t spin = 0; ; spin++)
+    {
+        if (sat_ring_pop_slot (object, data) == true)
+            break;
+
+        if (sat_ring_is_closed (object) == true)
+        {
+            // Elements published just before the close are still delivered.
+            sat_status_return_on_false (sat_ring_pop_slot (object, data), "ring is closed");
+            break;
+        }
+
+        if (spin < SAT_RING_SPIN_LIMIT)
+        {
+            sat_ring_relax ();
+            continue;
+        }
+
+        if (object->wakeup == sat_ring_wakeup_spin)
+        {
+            sched_yield ();
+            continue;
+        }
+
+        // Read the sequence before announcing ourselves: a notifier that
+        // resets the waiting count afterwards also bumps the sequence.
+        uint32_t sequence = __atomic_load_n (&object->items.sequence, __ATOMIC_ACQUIRE);
+
+        __atomic_add_fetch (&object->items.waiting, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence (__ATOMIC_SEQ_CST);
+
+        if (sat_ring_pop_slot (object, data) == true)
+            break;
+
+        if (sat_ring_is_closed (object) == false)
+            sat_ring_sleep (object, &object->items, sequence, object->wakeup == sat_ring_wakeup_eventfd);
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_close (sat_ring_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    __atomic_store_n (&object->closed, true, __ATOMIC_SEQ_CST);
+
+    if (object->wakeup == sat_ring_wakeup_spin)
+    {
+        sat_status_return_on_success ();
+    }
+
+    sat_ring_waiters_t *waiters [] = {&object->items, &object->spaces};
+
+    for (uint32_t i = 0; i < sizeof (waiters) / sizeof (waiters [0]); i++)
+    {
+        __atomic_add_fetch (&waiters [i]->sequence, 1, __ATOMIC_RELEASE);
+        syscall (SYS_futex, &waiters [i]->sequence, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    }
+
+    if (object->fd >= 0)
+        sat_ring_signal_fd (object, 1);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_get_fd (sat_ring_t *const object, int *const fd)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (fd, "null fd pointer");
+    sat_status_return_on_not_equals (object->wakeup, sat_ring_wakeup_eventfd, "ring has no eventfd");
+
+    __atomic_store_n (&object->polled, true, __ATOMIC_SEQ_CST);
+
+    *fd = object->fd;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_get_size (const sat_ring_t *const object, uint32_t *const size)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (size, "null size pointer");
+
+    uint32_t consumer = __atomic_load_n (&object->consumer.position, __ATOMIC_ACQUIRE);
+    uint32_t producer = __atomic_load_n (&object->producer.position, __ATOMIC_ACQUIRE);
+    uint32_t amount = producer - consumer;
+
+    if ((int32_t) amount < 0)
+        amount = 0;
+
+    *size = amount > object->capacity ? object->capacity : amount;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_get_capacity (const sat_ring_t *const object, uint32_t *const capacity)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (capacity, "null capacity pointer");
+
+    *capacity = object->capacity;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_ring_destroy (sat_ring_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    if (object->fd >= 0)
+        close (object->fd);
+
+    free (object->buffer);
+    free (object);
+
+    sat_status_return_on_success ();
+}
+
+static bool sat_ring_spsc_push (sat_ring_t *const object, const void *const data, uint32_t *const position)
+{
+    uint32_t tail = object->producer.position;
+
+    if (tail - object->producer.cached == object->capacity)
+    {
+        object->producer.cached = __atomic_load_n (&object->consumer.position, __ATOMIC_ACQUIRE);
+
+        if (tail - object->producer.cached == object->capacity)
+            return false;
+    }
+
+    memcpy (object->buffer + (size_t) (tail & object->mask) * object->stride, data, object->object_size);
+    __atomic_store_n (&object->producer.position, tail + 1, __ATOMIC_RELEASE);
+
+    *position = tail;
+
+    return true;
+}
+
+static bool sat_ring_spsc_pop (sat_ring_t *const object, void *const data)
+{
+    uint32_t head = object->consumer.position;
+
+    if (head == object->consumer.cached)
+    {
+        object->consumer.cached = __atomic_load_n (&object->producer.position, __ATOMIC_ACQUIRE);
+
+        if (head == object->consumer.cached)
+            return false;
+    }
+
+    memcpy (data, object->buffer + (size_t) (head & object->mask) * object->stride, object->object_size);
+    __atomic_store_n (&object->consumer.position, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static bool sat_ring_mpmc_push (sat_ring_t *const object, const void *const data, uint32_t *const position)
+{
+    uint32_t claimed = __atomic_load_n (&object->producer.position, __ATOMIC_RELAXED);
+    uint8_t *cell;
+
+    for (;;)
+    {
+        cell = object->buffer + (size_t) (claimed & object->mask) * object->stride;
+
+        uint32_t sequence = __atomic_load_n ((uint32_t *) cell, __ATOMIC_ACQUIRE);
+        int32_t difference = (int32_t) (sequence - claimed);
+
+        if (difference == 0)
+        {
+            if (__atomic_compare_exchange_n (&object->producer.position, &claimed, claimed + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            claimed = __atomic_load_n (&object->producer.position, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy (cell + SAT_RING_CELL_HEADER, data, object->object_size);
+    __atomic_store_n ((uint32_t *) cell, claimed + 1, __ATOMIC_RELEASE);
+
+    *position = claimed;
+
+    return true;
+}
+
+static bool sat_ring_mpmc_pop (sat_ring_t *const object, void *const data)
+{
+    uint32_t claimed = __atomic_load_n (&object->consumer.position, __ATOMIC_RELAXED);
+    uint8_t *cell;
+
+    for (;;)
+    {
+        cell = object->buffer + (size_t) (claimed & object->mask) * object->stride;
+
+        uint32_t sequence = __atomic_load_n ((uint32_t *) cell, __ATOMIC_ACQUIRE);
+        int32_t difference = (int32_t) (sequence - (claimed + 1));
+
+        if (difference == 0)
+        {
+            if (__atomic_compare_exchange_n (&object->consumer.position, &claimed, claimed + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            claimed = __atomic_load_n (&object->consumer.position, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy (data, cell + SAT_RING_CELL_HEADER, object->object_size);
+    __atomic_store_n ((uint32_t *) cell, claimed + object->capacity, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static bool sat_ring_push_slot (sat_ring_t *const object, const void *const data)
+{
+    uint32_t position;
+    bool pushed;
+
+    if (object->type == sat_ring_type_spsc)
+        pushed = sat_ring_spsc_push (object, data, &position);
+    else
+        pushed = sat_ring_mpmc_push (object, data, &position);
+
+    if (pushed == true && object->wakeup != sat_ring_wakeup_spin)
+        sat_ring_notify_items (object, position);
+
+    return pushed;
+}
+
+static bool sat_ring_pop_slot (sat_ring_t *const object, void *const data)
+{
+    bool popped;
+
+    if (object->type == sat_ring_type_spsc)
+        popped = sat_ring_spsc_pop (object, data);
+    else
+        popped = sat_ring_mpmc_pop (object, data);
+
+    if (popped == true && object->wakeup != sat_ring_wakeup_spin)
+        sat_ring_notify_spaces (object);
+
+    return popped;
+}
+
+static void sat_ring_notify_items (sat_ring_t *const object, const uint32_t position)
+{
+    // Pairs with the fence a consumer issues after announcing itself: either
+    // we see it waiting or it sees the element we just published.
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+
+    bool eventfd = object->wakeup == sat_ring_wakeup_eventfd;
+
+    if (sat_ring_wake (object, &object->items, eventfd) == false &&
+        eventfd == true &&
+        __atomic_load_n (&object->polled, __ATOMIC_RELAXED) == true &&
+        __atomic_load_n (&object->consumer.position, __ATOMIC_RELAXED) == position)
+    {
+        // The consumers had caught up with this element, so the ring was
+        // empty and an external poller may be waiting on the descriptor.
+        sat_ring_signal_fd (object, 1);
+    }
+}
+
+static void sat_ring_notify_spaces (sat_ring_t *const object)
+{
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+
+    sat_ring_wake (object, &object->spaces, false);
+}
+
+static bool sat_ring_wake (sat_ring_t *const object, sat_ring_waiters_t *const waiters, const bool eventfd)
+{
+    if (__atomic_load_n (&waiters->waiting, __ATOMIC_RELAXED) == 0)
+        return false;
+
+    // All sleepers are released at once and announce themselves again if
+    // they have to go back to sleep, so only the first notifier pays for
+    // the system call.
+    if (__atomic_exchange_n (&waiters->waiting, 0, __ATOMIC_ACQ_REL) == 0)
+        return false;
+
+    if (eventfd == true)
+    {
+        sat_ring_signal_fd (object, 1);
+    }
+    else
+    {
+        __atomic_add_fetch (&waiters->sequence, 1, __ATOMIC_RELEASE);
+        syscall (SYS_futex, &waiters->sequence, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    }
+
+    return true;
+}
+
+static void sat_ring_signal_fd (sat_ring_t *const object, uint64_t value)
+{
+    ssize_t written = write (object->fd, &value, sizeof (value));
+    (void) written;
+}
+
+static void sat_ring_sleep (sat_ring_t *const object, sat_ring_waiters_t *const waiters, const uint32_t sequence, const bool eventfd)
+{
+    if (eventfd == false)
+    {
+        // Returns immediately if a notifier bumped the sequence after we read it.
+        syscall (SYS_futex, &waiters->sequence, FUTEX_WAIT_PRIVATE, sequence, NULL, NULL, 0);
+        return;
+    }
+
+    struct pollfd descriptor = {.fd = object->fd, .events = POLLIN};
+
+    if (poll (&descriptor, 1, -1) <= 0)
+        return;
+
+    // The close notification is left in place so every poller keeps seeing it.
+    if (sat_ring_is_closed (object) == true)
+        return;
+
+    uint64_t value;
+    ssize_t got = read (object->fd, &value, sizeof (value));
+    (void) got;
+}
+
+static bool sat_ring_is_closed (const sat_ring_t *const object)
+{
+    return __atomic_load_n (&object->closed, __ATOMIC_ACQUIRE);
+}
+
+static void sat_ring_relax (void)
+{
+#if defined (__x86_64__) || defined (__i386__)
+    __builtin_ia32_pause ();
+#elif defined (__aarch64__)
+    __asm__ __volatile__ ("yield");
+#else
+    __asm__ __volatile__ ("" ::: "memory");
+#endif
+}
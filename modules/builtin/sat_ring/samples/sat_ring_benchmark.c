@@ -0,0 +1,247 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+/*
+ * Contention benchmark: moves small messages between producer and consumer
+ * threads through sat_ring and, as a reference, through a sat_queue guarded by
+ * a mutex and condition variable, the classic locked work queue.
+ *
+ * usage: sat_ring_benchmark [messages] [max threads per side]
+ */
+
+#define BENCHMARK_MESSAGES_DEFAULT      5000000
+#define BENCHMARK_THREADS_DEFAULT       4
+#define BENCHMARK_THREADS_MAX           64
+#define BENCHMARK_CAPACITY              1024
+
+typedef struct
+{
+    sat_queue_t *queue;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool closed;
+} locked_queue_t;
+
+typedef struct
+{
+    sat_ring_t *ring;
+    locked_queue_t *locked;
+    uint64_t amount;
+    uint64_t sum;
+} benchmark_context_t;
+
+static const char *wakeup_names [] = {"spin", "futex", "eventfd"};
+
+static double benchmark_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static void *ring_producer (void *args)
+{
+    benchmark_context_t *context = (benchmark_context_t *) args;
+
+    for (uint64_t i = 0; i < context->amount; i++)
+        sat_ring_push (context->ring, &i);
+
+    return NULL;
+}
+
+static void *ring_consumer (void *args)
+{
+    benchmark_context_t *context = (benchmark_context_t *) args;
+    uint64_t value;
+
+    while (true)
+    {
+        sat_status_t status = sat_ring_pop (context->ring, &value);
+        if (sat_status_get_result (&status) == false)
+            break;
+
+        context->sum += value;
+    }
+
+    return NULL;
+}
+
+static void *locked_producer (void *args)
+{
+    benchmark_context_t *context = (benchmark_context_t *) args;
+    locked_queue_t *locked = context->locked;
+
+    for (uint64_t i = 0; i < context->amount; i++)
+    {
+        pthread_mutex_lock (&locked->mutex);
+        sat_queue_enqueue (locked->queue, &i);
+        pthread_cond_signal (&locked->cond);
+        pthread_mutex_unlock (&locked->mutex);
+    }
+
+    return NULL;
+}
+
+static void *locked_consumer (void *args)
+{
+    benchmark_context_t *context = (benchmark_context_t *) args;
+    locked_queue_t *locked = context->locked;
+    uint64_t value;
+
+    while (true)
+    {
+        pthread_mutex_lock (&locked->mutex);
+
+        sat_status_t status = sat_queue_dequeue (locked->queue, &value);
+
+        while (sat_status_get_result (&status) == false && locked->closed == false)
+        {
+            pthread_cond_wait (&locked->cond, &locked->mutex);
+            status = sat_queue_dequeue (locked->queue, &value);
+        }
+
+        pthread_mutex_unlock (&locked->mutex);
+
+        if (sat_status_get_result (&status) == false)
+            break;
+
+        context->sum += value;
+    }
+
+    return NULL;
+}
+
+static void benchmark_report (const char *name, const char *wakeup, uint32_t producers, uint32_t consumers, uint64_t messages, double elapsed, uint64_t sum, uint64_t expected)
+{
+    printf ("%-12s %-8s %3u x %-3u %10.2f Mmsg/s %8.1f ns/msg %s\n",
+            name,
+            wakeup,
+            producers,
+            consumers,
+            (double) messages / elapsed / 1e6,
+            elapsed * 1e9 / (double) messages,
+            sum == expected ? "" : "CHECKSUM MISMATCH");
+}
+
+static void benchmark_run (bool use_ring, sat_ring_type_t type, sat_ring_wakeup_t wakeup, uint32_t producers, uint32_t consumers, uint64_t messages)
+{
+    pthread_t producer_threads [BENCHMARK_THREADS_MAX];
+    pthread_t consumer_threads [BENCHMARK_THREADS_MAX];
+    benchmark_context_t producer_contexts [BENCHMARK_THREADS_MAX] = {0};
+    benchmark_context_t consumer_contexts [BENCHMARK_THREADS_MAX] = {0};
+    locked_queue_t locked = {0};
+    sat_ring_t *ring = NULL;
+
+    uint64_t amount = messages / producers;
+    uint64_t expected = (uint64_t) producers * (amount * (amount - 1) / 2);
+
+    if (use_ring == true)
+    {
+        sat_status_t status = sat_ring_create (&ring, &(sat_ring_args_t)
+                                                      {
+                                                          .type = type,
+                                                          .wakeup = wakeup,
+                                                          .capacity = BENCHMARK_CAPACITY,
+                                                          .object_size = sizeof (uint64_t)
+                                                      });
+        if (sat_status_get_result (&status) == false)
+        {
+            fprintf (stderr, "%s\n", sat_status_get_motive (&status));
+            return;
+        }
+    }
+    else
+    {
+        sat_queue_create_with_args (&locked.queue, &(sat_queue_args_t)
+                                                   {
+                                                       .object_size = sizeof (uint64_t),
+                                                       .mode = sat_queue_mode_ring,
+                                                       .capacity = BENCHMARK_CAPACITY
+                                                   });
+        pthread_mutex_init (&locked.mutex, NULL);
+        pthread_cond_init (&locked.cond, NULL);
+    }
+
+    double start = benchmark_now ();
+
+    for (uint32_t i = 0; i < consumers; i++)
+    {
+        consumer_contexts [i] = (benchmark_context_t) {.ring = ring, .locked = &locked};
+        pthread_create (&consumer_threads [i], NULL, use_ring ? ring_consumer : locked_consumer, &consumer_contexts [i]);
+    }
+
+    for (uint32_t i = 0; i < producers; i++)
+    {
+        producer_contexts [i] = (benchmark_context_t) {.ring = ring, .locked = &locked, .amount = amount};
+        pthread_create (&producer_threads [i], NULL, use_ring ? ring_producer : locked_producer, &producer_contexts [i]);
+    }
+
+    for (uint32_t i = 0; i < producers; i++)
+        pthread_join (producer_threads [i], NULL);
+
+    if (use_ring == true)
+    {
+        sat_ring_close (ring);
+    }
+    else
+    {
+        pthread_mutex_lock (&locked.mutex);
+        locked.closed = true;
+        pthread_cond_broadcast (&locked.cond);
+        pthread_mutex_unlock (&locked.mutex);
+    }
+
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < consumers; i++)
+    {
+        pthread_join (consumer_threads [i], NULL);
+        sum += consumer_contexts [i].sum;
+    }
+
+    double elapsed = benchmark_now () - start;
+
+    if (use_ring == true)
+    {
+        benchmark_report (type == sat_ring_type_spsc ? "ring spsc" : "ring mpmc", wakeup_names [wakeup], producers, consumers, amount * producers, elapsed, sum, expected);
+        sat_ring_destroy (ring);
+    }
+    else
+    {
+        benchmark_report ("mutex queue", "cond", producers, consumers, amount * producers, elapsed, sum, expected);
+        pthread_cond_destroy (&locked.cond);
+        pthread_mutex_destroy (&locked.mutex);
+        sat_queue_destroy (locked.queue);
+    }
+}
+
+int main (int argc, char **argv)
+{
+    uint64_t messages = argc > 1 ? strtoull (argv [1], NULL, 10) : BENCHMARK_MESSAGES_DEFAULT;
+    uint32_t threads = argc > 2 ? (uint32_t) strtoul (argv [2], NULL, 10) : BENCHMARK_THREADS_DEFAULT;
+
+    if (messages == 0 || threads == 0 || threads > BENCHMARK_THREADS_MAX)
+    {
+        fprintf (stderr, "usage: %s [messages] [threads 1-%d]\n", argv [0], BENCHMARK_THREADS_MAX);
+        return 1;
+    }
+
+    benchmark_run (false, sat_ring_type_spsc, sat_ring_wakeup_spin, 1, 1, messages);
+
+    for (sat_ring_wakeup_t wakeup = sat_ring_wakeup_spin; wakeup <= sat_ring_wakeup_eventfd; wakeup++)
+        benchmark_run (true, sat_ring_type_spsc, wakeup, 1, 1, messages);
+
+    for (uint32_t count = 1; count <= threads; count *= 2)
+    {
+        benchmark_run (false, sat_ring_type_mpmc, sat_ring_wakeup_spin, count, count, messages);
+
+        for (sat_ring_wakeup_t wakeup = sat_ring_wakeup_spin; wakeup <= sat_ring_wakeup_eventfd; wakeup++)
+            benchmark_run (true, sat_ring_type_mpmc, wakeup, count, count, messages);
+    }
+
+    return 0;
+}
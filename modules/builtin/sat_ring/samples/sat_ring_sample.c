@@ -0,0 +1,51 @@
+#include <sat.h>
+#include <stdio.h>
+#include <pthread.h>
+
+static void *consumer (void *args)
+{
+    sat_ring_t *ring = (sat_ring_t *) args;
+    int value;
+
+    while (true)
+    {
+        sat_status_t status = sat_ring_pop (ring, &value);
+        if (sat_status_get_result (&status) == false)
+            break;
+
+        printf ("received %d\n", value);
+    }
+
+    return NULL;
+}
+
+int main (int argc, char **argv)
+{
+    sat_ring_t *ring = NULL;
+    pthread_t thread;
+
+    sat_status_t status = sat_ring_create (&ring, &(sat_ring_args_t)
+                                                  {
+                                                      .type = sat_ring_type_spsc,
+                                                      .wakeup = sat_ring_wakeup_futex,
+                                                      .capacity = 16,
+                                                      .object_size = sizeof (int)
+                                                  });
+    if (sat_status_get_result (&status) == false)
+    {
+        fprintf (stderr, "%s\n", sat_status_get_motive (&status));
+        return 1;
+    }
+
+    pthread_create (&thread, NULL, consumer, ring);
+
+    for (int i = 0; i < 10; i++)
+        sat_ring_push (ring, &i);
+
+    sat_ring_close (ring);
+    pthread_join (thread, NULL);
+
+    sat_ring_destroy (ring);
+
+    return 0;
+}
@@ -0,0 +1,291 @@
+#include <sat.h>
+#include <assert.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+
+#define TEST_RING_MESSAGES      200000
+#define TEST_RING_THREADS       4
+
+typedef struct
+{
+    sat_ring_t *ring;
+    uint32_t id;
+    uint32_t amount;
+    uint64_t sum;
+    uint32_t received;
+} test_ring_context_t;
+
+static void test_ring_args (void)
+{
+    sat_ring_t *ring = NULL;
+    sat_status_t status;
+
+    status = sat_ring_create (NULL, &(sat_ring_args_t) {.capacity = 8, .object_size = 4});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_ring_create (&ring, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_ring_create (&ring, &(sat_ring_args_t) {.capacity = 8, .object_size = 0});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_ring_create (&ring, &(sat_ring_args_t) {.capacity = 0, .object_size = 4});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_ring_create (&ring, &(sat_ring_args_t) {.capacity = 5, .object_size = 4});
+    assert (sat_status_get_result (&status) == true);
+
+    uint32_t capacity = 0;
+    status = sat_ring_get_capacity (ring, &capacity);
+    assert (sat_status_get_result (&status) == true);
+    assert (capacity == 8);
+
+    int fd = -1;
+    status = sat_ring_get_fd (ring, &fd);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_ring_destroy (ring);
+}
+
+static void test_ring_single_thread (sat_ring_type_t type)
+{
+    sat_ring_t *ring = NULL;
+    sat_status_t status = sat_ring_create (&ring, &(sat_ring_args_t)
+                                                  {
+                                                      .type = type,
+                                                      .capacity = 4,
+                                                      .object_size = sizeof (uint32_t)
+                                                  });
+    assert (sat_status_get_result (&status) == true);
+
+    uint32_t value = 0;
+    status = sat_ring_try_pop (ring, &value);
+    assert (sat_status_get_result (&status) == false);
+
+    // Several laps around the ring exercise the index wrap.
+    uint32_t next = 0;
+    uint32_t expected = 0;
+
+    for (uint32_t lap = 0; lap < 10; lap++)
+    {
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            status = sat_ring_try_push (ring, &next);
+            assert (sat_status_get_result (&status) == true);
+            next ++;
+        }
+
+        status = sat_ring_try_push (ring, &next);
+        assert (sat_status_get_result (&status) == false);
+
+        uint32_t size = 0;
+        sat_ring_get_size (ring, &size);
+        assert (size == 4);
+
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            status = sat_ring_try_pop (ring, &value);
+            assert (sat_status_get_result (&status) == true);
+            assert (value == expected);
+            expected ++;
+        }
+
+        status = sat_ring_try_pop (ring, &value);
+        assert (sat_status_get_result (&status) == false);
+    }
+
+    sat_ring_destroy (ring);
+}
+
+static void *test_ring_producer (void *args)
+{
+    test_ring_context_t *context = (test_ring_context_t *) args;
+
+    for (uint32_t i = 0; i < context->amount; i++)
+    {
+        uint64_t value = ((uint64_t) context->id << 32) | i;
+        sat_status_t status = sat_ring_push (context->ring, &value);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    return NULL;
+}
+
+static void *test_ring_consumer (void *args)
+{
+    test_ring_context_t *context = (test_ring_context_t *) args;
+    uint32_t last [TEST_RING_THREADS] = {0};
+    bool seen [TEST_RING_THREADS] = {false};
+    uint64_t value;
+
+    while (true)
+    {
+        sat_status_t status = sat_ring_pop (context->ring, &value);
+        if (sat_status_get_result (&status) == false)
+            break;
+
+        uint32_t producer = (uint32_t) (value >> 32);
+        uint32_t sequence = (uint32_t) value;
+
+        // Elements from one producer arrive in the order they were pushed.
+        assert (producer < TEST_RING_THREADS);
+        assert (seen [producer] == false || sequence > last [producer]);
+
+        seen [producer] = true;
+        last [producer] = sequence;
+        context->sum += sequence;
+        context->received ++;
+    }
+
+    return NULL;
+}
+
+static void test_ring_threads (sat_ring_type_t type, sat_ring_wakeup_t wakeup, uint32_t producers, uint32_t consumers)
+{
+    sat_ring_t *ring = NULL;
+    sat_status_t status = sat_ring_create (&ring, &(sat_ring_args_t)
+                                                  {
+                                                      .type = type,
+                                                      .wakeup = wakeup,
+                                                      .capacity = 64,
+                                                      .object_size = sizeof (uint64_t)
+                                                  });
+    assert (sat_status_get_result (&status) == true);
+
+    pthread_t producer_threads [TEST_RING_THREADS];
+    pthread_t consumer_threads [TEST_RING_THREADS];
+    test_ring_context_t producer_contexts [TEST_RING_THREADS] = {0};
+    test_ring_context_t consumer_contexts [TEST_RING_THREADS] = {0};
+    uint32_t amount = TEST_RING_MESSAGES / producers;
+
+    for (uint32_t i = 0; i < consumers; i++)
+    {
+        consumer_contexts [i].ring = ring;
+        pthread_create (&consumer_threads [i], NULL, test_ring_consumer, &consumer_contexts [i]);
+    }
+
+    for (uint32_t i = 0; i < producers; i++)
+    {
+        producer_contexts [i] = (test_ring_context_t) {.ring = ring, .id = i, .amount = amount};
+        pthread_create (&producer_threads [i], NULL, test_ring_producer, &producer_contexts [i]);
+    }
+
+    for (uint32_t i = 0; i < producers; i++)
+        pthread_join (producer_threads [i], NULL);
+
+    status = sat_ring_close (ring);
+    assert (sat_status_get_result (&status) == true);
+
+    uint64_t sum = 0;
+    uint32_t received = 0;
+
+    for (uint32_t i = 0; i < consumers; i++)
+    {
+        pthread_join (consumer_threads [i], NULL);
+        sum += consumer_contexts [i].sum;
+        received += consumer_contexts [i].received;
+    }
+
+    assert (received == amount * producers);
+    assert (sum == (uint64_t) producers * ((uint64_t) amount * (amount - 1) / 2));
+
+    uint64_t value = 0;
+    status = sat_ring_try_push (ring, &value);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_ring_destroy (ring);
+}
+
+static void *test_ring_blocked_pop (void *args)
+{
+    uint32_t value;
+    sat_status_t status = sat_ring_pop ((sat_ring_t *) args, &value);
+    assert (sat_status_get_result (&status) == false);
+
+    return NULL;
+}
+
+static void test_ring_close_releases (sat_ring_wakeup_t wakeup)
+{
+    sat_ring_t *ring = NULL;
+    sat_status_t status = sat_ring_create (&ring, &(sat_ring_args_t)
+                                                  {
+                                                      .type = sat_ring_type_mpmc,
+                                                      .wakeup = wakeup,
+                                                      .capacity = 4,
+                                                      .object_size = sizeof (uint32_t)
+                                                  });
+    assert (sat_status_get_result (&status) == true);
+
+    pthread_t threads [2];
+    for (uint32_t i = 0; i < 2; i++)
+        pthread_create (&threads [i], NULL, test_ring_blocked_pop, ring);
+
+    usleep (50000);
+    sat_ring_close (ring);
+
+    for (uint32_t i = 0; i < 2; i++)
+        pthread_join (threads [i], NULL);
+
+    sat_ring_destroy (ring);
+}
+
+static void test_ring_eventfd (void)
+{
+    sat_ring_t *ring = NULL;
+    sat_status_t status = sat_ring_create (&ring, &(sat_ring_args_t)
+                                                  {
+                                                      .type = sat_ring_type_spsc,
+                                                      .wakeup = sat_ring_wakeup_eventfd,
+                                                      .capacity = 4,
+                                                      .object_size = sizeof (uint32_t)
+                                                  });
+    assert (sat_status_get_result (&status) == true);
+
+    int fd = -1;
+    status = sat_ring_get_fd (ring, &fd);
+    assert (sat_status_get_result (&status) == true);
+    assert (fd >= 0);
+
+    struct pollfd descriptor = {.fd = fd, .events = POLLIN};
+    assert (poll (&descriptor, 1, 0) == 0);
+
+    // Pushing into an empty ring makes the descriptor readable.
+    uint32_t value = 7;
+    sat_ring_try_push (ring, &value);
+    assert (poll (&descriptor, 1, 0) == 1);
+
+    uint64_t counter;
+    assert (read (fd, &counter, sizeof (counter)) == sizeof (counter));
+
+    value = 0;
+    status = sat_ring_try_pop (ring, &value);
+    assert (sat_status_get_result (&status) == true);
+    assert (value == 7);
+    assert (poll (&descriptor, 1, 0) == 0);
+
+    sat_ring_destroy (ring);
+}
+
+int main (int argc, char **argv)
+{
+    test_ring_args ();
+    test_ring_single_thread (sat_ring_type_spsc);
+    test_ring_single_thread (sat_ring_type_mpmc);
+
+    test_ring_threads (sat_ring_type_spsc, sat_ring_wakeup_spin, 1, 1);
+    test_ring_threads (sat_ring_type_spsc, sat_ring_wakeup_futex, 1, 1);
+    test_ring_threads (sat_ring_type_spsc, sat_ring_wakeup_eventfd, 1, 1);
+    test_ring_threads (sat_ring_type_mpmc, sat_ring_wakeup_spin, TEST_RING_THREADS, TEST_RING_THREADS);
+    test_ring_threads (sat_ring_type_mpmc, sat_ring_wakeup_futex, TEST_RING_THREADS, TEST_RING_THREADS);
+    test_ring_threads (sat_ring_type_mpmc, sat_ring_wakeup_eventfd, TEST_RING_THREADS, 2);
+
+    test_ring_close_releases (sat_ring_wakeup_spin);
+    test_ring_close_releases (sat_ring_wakeup_futex);
+    test_ring_close_releases (sat_ring_wakeup_eventfd);
+
+    test_ring_eventfd ();
+
+    return 0;
+}
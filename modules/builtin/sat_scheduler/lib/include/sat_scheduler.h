@@ -9,14 +9,35 @@
  * The scheduler uses millisecond precision timing and can manage multiple
  * events with different intervals. Events are identified by name and can
  * carry custom context data.
+ *
+ * Events are kept in a min-heap ordered by deadline. The scheduler thread
+ * sleeps on a condition variable until the earliest deadline, and adding an
+ * event wakes it up, so an idle scheduler costs no CPU and picking the next
+ * event does not depend on how many there are. Events are indexed by name
+ * and by handle, so adding and cancelling them while the scheduler runs,
+ * from any thread, costs O(log n).
+ *
+ * Handlers run on the scheduler thread by default. With a pool_amount they
+ * are dispatched to a sat_worker pool instead, so a slow handler no longer
+ * delays the others; each event then picks what happens when it comes due
+ * while its previous run is still going. Periodic events are rescheduled
+ * either a timeout after the previous run ended (fixed delay) or a timeout
+ * after the previous deadline (fixed rate), and the deadlines a fixed-rate
+ * event falls behind on are counted rather than run in a burst.
+ *
+ * Attached to a sat_reactor, the scheduler has no thread of its own: a
+ * reactor timer is armed for the earliest deadline and the due events run
+ * on the reactor thread, next to its sockets.
  */
 
 #ifndef SAT_SCHEDULER_H_
 #define SAT_SCHEDULER_H_
 
 #include <sat_status.h>
-#include <sat_set.h>
+#include <sat_worker.h>
+#include <sat_reactor.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <pthread.h>
 
 /**
@@ -30,6 +51,19 @@
  */
 typedef void (*sat_scheduler_handler_t) (void *object);
 
+/**
+ * @brief Scheduled event with its deadline, internal to the scheduler
+ */
+typedef struct sat_scheduler_entry_t sat_scheduler_entry_t;
+
+/**
+ * @brief Handle identifying a scheduled event
+ * 
+ * Handles are never reused, so cancelling an event that already ended
+ * fails instead of hitting another event. 0 is never a valid handle.
+ */
+typedef uint64_t sat_scheduler_handle_t;
+
 /**
  * @brief Scheduler instance structure
  * 
@@ -39,10 +73,26 @@ typedef void (*sat_scheduler_handler_t) (void *object);
  */
 typedef struct 
 {
-    sat_set_t *set;              /**< Set containing scheduled events */
-    uint16_t events_amount;      /**< Maximum number of events */
-    pthread_t thread;            /**< Scheduler thread handle */
-    bool running;                /**< Scheduler running state */
+    pthread_mutex_t mutex;           /**< Mutex guarding the heap */
+    pthread_cond_t cond;             /**< Condition variable the thread sleeps on until the next deadline */
+    sat_scheduler_entry_t **heap;    /**< Min-heap of events ordered by deadline */
+    uint32_t size;                   /**< Number of events in the heap */
+    uint32_t capacity;               /**< Number of slots in the heap */
+    uint32_t amount;                 /**< Number of events, including those being run */
+    sat_scheduler_entry_t *entries;  /**< Every event, in the heap or being run */
+    sat_scheduler_entry_t **names;   /**< Hash index of the named events */
+    sat_scheduler_entry_t **handles; /**< Hash index of the events by handle */
+    uint32_t buckets;                /**< Number of buckets of each index */
+    sat_scheduler_handle_t next_handle; /**< Last handle given out */
+    uint16_t events_amount;          /**< Maximum number of events */
+    bool dynamic;                    /**< Whether the heap grows past events_amount */
+    sat_worker_t worker;             /**< Pool the handlers run on when pooled */
+    bool pooled;                     /**< Whether handlers run on the worker pool */
+    pthread_t thread;                /**< Scheduler thread handle */
+    bool started;                    /**< Whether the thread was started and not yet joined */
+    bool running;                    /**< Scheduler running state */
+    sat_reactor_t *reactor;          /**< Reactor the events run on instead of the thread, if attached */
+    int timer;                       /**< Reactor timer armed for the earliest deadline */
 } sat_scheduler_t;
 
 /**
@@ -67,6 +117,30 @@ typedef enum
     sat_scheduler_type_one_shot, /**< Event executes once then is removed */
 } sat_scheduler_type_t;
 
+/**
+ * @brief Periodic timing enumeration
+ * 
+ * Defines where the next deadline of a periodic event is measured from.
+ */
+typedef enum
+{
+    sat_scheduler_timing_fixed_delay, /**< A timeout after the previous run ended */
+    sat_scheduler_timing_fixed_rate,  /**< A timeout after the previous deadline, without drift */
+} sat_scheduler_timing_t;
+
+/**
+ * @brief Overlap policy enumeration
+ * 
+ * Defines what a pooled fixed-rate event does when it comes due while its
+ * previous run has not finished. Fixed-delay and one-shot events never overlap.
+ */
+typedef enum
+{
+    sat_scheduler_overlap_skip,       /**< Drop this run and count it as skipped */
+    sat_scheduler_overlap_queue,      /**< Run it as soon as the previous run ends */
+    sat_scheduler_overlap_concurrent, /**< Run it right away, alongside the previous one */
+} sat_scheduler_overlap_t;
+
 /**
  * @brief Scheduler configuration structure
  * 
@@ -76,6 +150,7 @@ typedef struct
 {
     uint16_t event_amount;           /**< Maximum number of events */
     sat_scheduler_mode_t mode;       /**< Scheduler mode (static/dynamic) */
+    uint16_t pool_amount;            /**< Worker threads running the handlers, 0 runs them on the scheduler thread */
 } sat_scheduler_args_t;
 
 /**
@@ -86,13 +161,28 @@ typedef struct
 typedef struct
 {
     void *object;                    /**< Context object for handler */
-    char *name;                      /**< Event name (must be unique) */
+    char *name;                      /**< Event name (must be unique), NULL for an event only reached by its handle */
     sat_scheduler_handler_t handler; /**< Event handler function */
     sat_scheduler_type_t type;       /**< Event type (periodic/one-shot) */
     uint64_t timeout;                /**< Timeout in milliseconds */
-    uint64_t last_update;            /**< Last execution timestamp */
+    uint64_t last_update;            /**< Unused, deadlines are tracked internally */
+    sat_scheduler_timing_t timing;   /**< Periodic timing, fixed delay by default */
+    sat_scheduler_overlap_t overlap; /**< Overlap policy when pooled, skip by default */
 } sat_scheduler_event_t;
 
+/**
+ * @brief Per-event counters
+ */
+typedef struct
+{
+    uint64_t executions;             /**< Runs started */
+    uint64_t missed;                 /**< Fixed-rate deadlines passed over because the event fell behind */
+    uint64_t skipped;                /**< Runs dropped by the skip overlap policy */
+    uint32_t queued;                 /**< Runs waiting on the queue overlap policy */
+    uint32_t active;                 /**< Runs in progress */
+    uint64_t lateness_max;           /**< Longest delay between a deadline and its run, in milliseconds */
+} sat_scheduler_event_stats_t;
+
 /**
  * @brief Initialize a scheduler object
  * 
@@ -119,9 +209,11 @@ sat_status_t sat_scheduler_open (sat_scheduler_t *const object, const sat_schedu
 /**
  * @brief Add an event to the scheduler
  * 
- * Adds a new event to the scheduler's event collection. The event
- * will not execute until the scheduler is started. Event names must
- * be unique within the scheduler.
+ * Adds a new event to the scheduler's event collection. Before the
+ * scheduler is started the event waits for the start; while it runs,
+ * the event is due one timeout from now and the scheduler thread is
+ * woken up to account for it. Event names must be unique within the
+ * scheduler.
  * 
  * @param object Pointer to scheduler object
  * @param event Pointer to event structure to add
@@ -129,6 +221,59 @@ sat_status_t sat_scheduler_open (sat_scheduler_t *const object, const sat_schedu
  */
 sat_status_t sat_scheduler_add_event (sat_scheduler_t *const object, const sat_scheduler_event_t *const event);
 
+/**
+ * @brief Add an event to the scheduler and get its handle
+ * 
+ * Same as sat_scheduler_add_event(), and stores a handle that
+ * sat_scheduler_cancel() accepts. Meant for short-lived timers, which
+ * may leave the name NULL.
+ * 
+ * @param object Pointer to scheduler object
+ * @param event Pointer to event structure to add
+ * @param handle Pointer to store the event handle
+ * @return Status indicating success or failure
+ */
+sat_status_t sat_scheduler_schedule (sat_scheduler_t *const object, const sat_scheduler_event_t *const event, sat_scheduler_handle_t *const handle);
+
+/**
+ * @brief Cancel an event by handle
+ * 
+ * The event will not run again. A run already in progress is not
+ * interrupted, and its handler may cancel its own event.
+ * 
+ * @param object Pointer to scheduler object
+ * @param handle Handle returned by sat_scheduler_schedule()
+ * @return Status indicating success, or failure if the event already ended
+ */
+sat_status_t sat_scheduler_cancel (sat_scheduler_t *const object, const sat_scheduler_handle_t handle);
+
+/**
+ * @brief Cancel an event by name
+ * 
+ * Like sat_scheduler_cancel(). The name can be used again right away.
+ * 
+ * @param object Pointer to scheduler object
+ * @param name Name of the event
+ * @return Status indicating success, or failure if no event has that name
+ */
+sat_status_t sat_scheduler_cancel_by_name (sat_scheduler_t *const object, const char *const name);
+
+/**
+ * @brief Run the scheduler on a reactor instead of its own thread
+ * 
+ * Must be called before sat_scheduler_start(), which then arms a reactor
+ * timer for the earliest deadline rather than starting a thread. Unpooled
+ * handlers run on the reactor thread. Events may still be added and
+ * cancelled from any thread, and sat_scheduler_stop() may be called from
+ * any thread, but sat_scheduler_close() must be called on the reactor
+ * thread or while the reactor is not running.
+ * 
+ * @param object Pointer to the opened scheduler object
+ * @param reactor Pointer to the opened reactor
+ * @return Status indicating success or failure
+ */
+sat_status_t sat_scheduler_attach (sat_scheduler_t *const object, sat_reactor_t *const reactor);
+
 /**
  * @brief Start the scheduler
  * 
@@ -144,8 +289,12 @@ sat_status_t sat_scheduler_start (sat_scheduler_t *const object);
 /**
  * @brief Stop the scheduler
  * 
- * Stops the scheduler thread and waits for it to terminate. Events
- * are preserved but no longer execute until the scheduler is restarted.
+ * Stops the scheduler thread and waits for it to terminate, and for the
+ * handlers running on the pool to return. Events are preserved but no
+ * longer execute until the scheduler is restarted; queued overlapping
+ * runs are dropped. When called from an event handler, the handler itself
+ * is not waited for and an unpooled thread is joined by
+ * sat_scheduler_close().
  * 
  * @param object Pointer to scheduler object
  * @return Status indicating success or failure
@@ -174,6 +323,16 @@ sat_status_t sat_scheduler_is_running (sat_scheduler_t *const object);
  */
 sat_status_t sat_scheduler_get_amount (const sat_scheduler_t *const object, uint16_t *const amount);
 
+/**
+ * @brief Get the counters of an event
+ * 
+ * @param object Pointer to scheduler object
+ * @param name Name of the event
+ * @param stats Pointer to store the counters
+ * @return Status indicating success, or failure if no event has that name
+ */
+sat_status_t sat_scheduler_get_event_stats (sat_scheduler_t *const object, const char *const name, sat_scheduler_event_stats_t *const stats);
+
 /**
  * @brief Close and cleanup the scheduler
  * 
@@ -1,11 +1,70 @@
 #include <sat_scheduler.h>
+#include <sat_hash.h>
 #include <string.h>
-#include <unistd.h>
-#include <sat_time.h>
+#include <stdlib.h>
+#include <time.h>
 
-static bool sat_scheduler_is_equal (const void *const element, const void *const new_element);
+#define SAT_SCHEDULER_NOT_IN_HEAP   UINT32_MAX
+#define SAT_SCHEDULER_BUCKETS_MIN   16
+
+struct sat_scheduler_entry_t
+{
+    sat_scheduler_event_t event;
+    sat_scheduler_handle_t handle;
+    uint64_t deadline;          // monotonic time in milliseconds
+    uint32_t position;          // index in the heap, kept up to date by the sift functions
+    uint32_t active;            // runs in progress
+    uint32_t queued;            // runs held back by the queue overlap policy
+    bool cancelled;             // out of the indexes, freed once its runs end
+    uint64_t executions;
+    uint64_t missed;
+    uint64_t skipped;
+    uint64_t lateness_max;
+    sat_scheduler_entry_t *next;
+    sat_scheduler_entry_t *previous;
+    sat_scheduler_entry_t *name_next;   // chain of the name index bucket
+    sat_scheduler_entry_t *handle_next; // chain of the handle index bucket
+};
+
+typedef struct
+{
+    sat_scheduler_t *scheduler;
+    sat_scheduler_entry_t *entry;
+} sat_scheduler_dispatch_t;
+
+// Scheduler whose handler the calling thread is running, if any.
+static __thread sat_scheduler_t *sat_scheduler_dispatching;
+
+static sat_status_t sat_scheduler_add (sat_scheduler_t *const object, const sat_scheduler_event_t *const event, sat_scheduler_handle_t *const handle);
+static sat_status_t sat_scheduler_remove (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
 static bool sat_scheduler_is_event_valid (const sat_scheduler_event_t *const event);
+static sat_scheduler_entry_t *sat_scheduler_find (const sat_scheduler_t *const object, const char *const name);
+static sat_scheduler_entry_t *sat_scheduler_find_handle (const sat_scheduler_t *const object, const sat_scheduler_handle_t handle);
+static void sat_scheduler_link (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static void sat_scheduler_unlink (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static void sat_scheduler_retire (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static uint64_t sat_scheduler_now (void);
+
+static void sat_scheduler_index_add (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static void sat_scheduler_index_remove (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static void sat_scheduler_index_grow (sat_scheduler_t *const object);
+
+static bool sat_scheduler_admit (sat_scheduler_entry_t *const entry);
+static void sat_scheduler_advance (sat_scheduler_entry_t *const entry, const uint64_t now);
+static bool sat_scheduler_complete (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static void sat_scheduler_execute (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static void sat_scheduler_dispatch (void *const object);
+
+static bool sat_scheduler_heap_push (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry);
+static void sat_scheduler_heap_remove (sat_scheduler_t *const object, const uint32_t position);
+static void sat_scheduler_heap_sift_up (sat_scheduler_t *const object, uint32_t position);
+static void sat_scheduler_heap_sift_down (sat_scheduler_t *const object, uint32_t position);
+
+static bool sat_scheduler_run_next (sat_scheduler_t *const object, uint64_t *const deadline);
+static void sat_scheduler_wake (sat_scheduler_t *const object);
+static void sat_scheduler_arm (sat_scheduler_t *const object);
 static void *sat_scheduler_main_handler (void *const context);
+static void sat_scheduler_on_timer (int fd, uint32_t events, void *data);
 
 sat_status_t sat_scheduler_init (sat_scheduler_t *const object)
 {
@@ -28,7 +87,7 @@ sat_status_t sat_scheduler_init (sat_scheduler_t *const object)
 
 sat_status_t sat_scheduler_open (sat_scheduler_t *const object, const sat_scheduler_args_t *const args)
 {
-    sat_status_t status;
+    sat_status_t status = sat_status_success (&status);
 
     do
     {
@@ -50,16 +109,63 @@ sat_status_t sat_scheduler_open (sat_scheduler_t *const object, const sat_schedu
             break;
         }
 
-        status = sat_set_create (&object->set, &(sat_set_args_t)
-                                                {
-                                                    .size = args->event_amount,
-                                                    .object_size = sizeof (sat_scheduler_event_t),
-                                                    .is_equal = sat_scheduler_is_equal,
-                                                    .mode = (sat_set_mode_t) args->mode
-                                                });
-        sat_status_break_on_error (status);
+        uint32_t buckets = SAT_SCHEDULER_BUCKETS_MIN;
+
+        while (buckets < args->event_amount)
+            buckets *= 2;
+
+        object->heap = (sat_scheduler_entry_t **) calloc (args->event_amount, sizeof (sat_scheduler_entry_t *));
+        object->names = (sat_scheduler_entry_t **) calloc (buckets, sizeof (sat_scheduler_entry_t *));
+        object->handles = (sat_scheduler_entry_t **) calloc (buckets, sizeof (sat_scheduler_entry_t *));
+
+        if (object->heap == NULL || object->names == NULL || object->handles == NULL)
+        {
+            free (object->heap);
+            free (object->names);
+            free (object->handles);
+            object->heap = NULL;
+
+            status = sat_status_set (&status, false, __func__, "sat scheduler open error: memory allocation failed");
+            break;
+        }
+
+        object->buckets = buckets;
+
+        if (args->pool_amount > 0)
+        {
+            sat_worker_init (&object->worker);
+
+            status = sat_worker_open (&object->worker, &(sat_worker_args_t)
+                                                       {
+                                                           .pool_amount = args->pool_amount,
+                                                           .object_size = sizeof (sat_scheduler_dispatch_t),
+                                                           .handler = sat_scheduler_dispatch,
+                                                       });
+            if (sat_status_get_result (&status) == false)
+            {
+                free (object->heap);
+                free (object->names);
+                free (object->handles);
+                object->heap = NULL;
+                break;
+            }
+
+            object->pooled = true;
+        }
+
+        // Deadlines are monotonic, so the sleep must be measured on the same clock.
+        pthread_condattr_t attributes;
+        pthread_condattr_init (&attributes);
+        pthread_condattr_setclock (&attributes, CLOCK_MONOTONIC);
+
+        pthread_mutex_init (&object->mutex, NULL);
+        pthread_cond_init (&object->cond, &attributes);
+
+        pthread_condattr_destroy (&attributes);
 
+        object->capacity = args->event_amount;
         object->events_amount = args->event_amount;
+        object->dynamic = args->mode == sat_scheduler_mode_dynamic;
 
     } while (false);
 
@@ -68,23 +174,105 @@ sat_status_t sat_scheduler_open (sat_scheduler_t *const object, const sat_schedu
 
 sat_status_t sat_scheduler_add_event (sat_scheduler_t *const object, const sat_scheduler_event_t *const event)
 {
-    sat_status_t status;
+    return sat_scheduler_add (object, event, NULL);
+}
+
+sat_status_t sat_scheduler_schedule (sat_scheduler_t *const object, const sat_scheduler_event_t *const event, sat_scheduler_handle_t *const handle)
+{
+    sat_status_t status = sat_status_success (&status);
 
     do
     {
-        if (object == NULL)
+        if (handle == NULL)
         {
-            status = sat_status_set (&status, false, __func__, "sat scheduler add event error: null object");
+            status = sat_status_set (&status, false, __func__, "sat scheduler schedule error: null handle");
             break;
         }
 
-        if (sat_scheduler_is_event_valid (event) == false)
+        status = sat_scheduler_add (object, event, handle);
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_scheduler_cancel (sat_scheduler_t *const object, const sat_scheduler_handle_t handle)
+{
+    sat_status_t status = sat_status_success (&status);
+
+    do
+    {
+        if (object == NULL || object->events_amount == 0)
         {
-            status = sat_status_set (&status, false, __func__, "sat scheduler add event error: null event");
+            status = sat_status_set (&status, false, __func__, "sat scheduler cancel error: null object");
             break;
         }
 
-        status = sat_set_add (object->set, (void *)event);
+        pthread_mutex_lock (&object->mutex);
+        status = sat_scheduler_remove (object, sat_scheduler_find_handle (object, handle));
+        pthread_mutex_unlock (&object->mutex);
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_scheduler_cancel_by_name (sat_scheduler_t *const object, const char *const name)
+{
+    sat_status_t status = sat_status_success (&status);
+
+    do
+    {
+        if (object == NULL || object->events_amount == 0)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler cancel error: null object");
+            break;
+        }
+
+        if (name == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler cancel error: null name");
+            break;
+        }
+
+        pthread_mutex_lock (&object->mutex);
+        status = sat_scheduler_remove (object, sat_scheduler_find (object, name));
+        pthread_mutex_unlock (&object->mutex);
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_scheduler_attach (sat_scheduler_t *const object, sat_reactor_t *const reactor)
+{
+    sat_status_t status = sat_status_success (&status);
+
+    do
+    {
+        if (object == NULL || object->events_amount == 0)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler attach error: null object");
+            break;
+        }
+
+        if (reactor == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler attach error: null reactor");
+            break;
+        }
+
+        if (object->started == true || object->reactor != NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler attach error: already started or attached");
+            break;
+        }
+
+        // Created disarmed; the start arms it for the earliest deadline.
+        status = sat_reactor_add_timer (reactor, 0, 0, sat_scheduler_on_timer, object, &object->timer);
+        sat_status_break_on_error (status);
+
+        object->reactor = reactor;
 
     } while (false);
 
@@ -100,10 +288,48 @@ sat_status_t sat_scheduler_start (sat_scheduler_t *const object)
         status = sat_status_set (&status, false, __func__, "sat scheduler start error: null object");
         return status;
     }
-   
-    object->running = true;
 
-    pthread_create (&object->thread, NULL, sat_scheduler_main_handler, object);
+    if (object->started == true)
+    {
+        status = sat_status_set (&status, false, __func__, "sat scheduler start error: already started");
+        return status;
+    }
+
+    pthread_mutex_lock (&object->mutex);
+
+    // All events begin timing from the moment the scheduler starts. The
+    // relative order is unchanged only if the timeouts are, so rebuild the heap.
+    uint64_t now = sat_scheduler_now ();
+
+    for (uint32_t i = 0; i < object->size; i++)
+        object->heap [i]->deadline = now + object->heap [i]->event.timeout;
+
+    for (uint32_t i = object->size / 2; i > 0; i--)
+        sat_scheduler_heap_sift_down (object, i - 1);
+
+    __atomic_store_n (&object->running, true, __ATOMIC_RELEASE);
+
+    // Set before the thread exists so a handler calling stop sees it.
+    object->started = true;
+
+    // On a reactor the timer takes the place of the thread.
+    if (object->reactor != NULL)
+    {
+        sat_scheduler_arm (object);
+        pthread_mutex_unlock (&object->mutex);
+
+        return status;
+    }
+
+    pthread_mutex_unlock (&object->mutex);
+
+    if (pthread_create (&object->thread, NULL, sat_scheduler_main_handler, object) != 0)
+    {
+        __atomic_store_n (&object->running, false, __ATOMIC_RELEASE);
+        object->started = false;
+        status = sat_status_set (&status, false, __func__, "sat scheduler start error: thread creation failed");
+        return status;
+    }
 
     return status;
 }
@@ -118,9 +344,35 @@ sat_status_t sat_scheduler_stop (sat_scheduler_t *const object)
         return status;
     }
 
-    object->running = false;
+    if (object->started == false)
+        return status;
+
+    pthread_mutex_lock (&object->mutex);
+
+    __atomic_store_n (&object->running, false, __ATOMIC_RELEASE);
+
+    if (object->reactor != NULL)
+        sat_reactor_set_timer (object->reactor, object->timer, 0, 0);
+
+    else
+        pthread_cond_signal (&object->cond);
 
-    pthread_join (object->thread, NULL);
+    pthread_mutex_unlock (&object->mutex);
+
+    if (object->reactor != NULL)
+        object->started = false;
+
+    // A handler stopping its own scheduler cannot join itself; the thread
+    // exits when the handler returns and is joined on close.
+    else if (pthread_equal (pthread_self (), object->thread) == 0)
+    {
+        pthread_join (object->thread, NULL);
+        object->started = false;
+    }
+
+    // Nor can a pooled handler wait for the pool it runs on.
+    if (object->pooled == true && sat_scheduler_dispatching != object)
+        sat_worker_wait_idle (&object->worker);
 
     return status;
 }
@@ -128,7 +380,7 @@ sat_status_t sat_scheduler_stop (sat_scheduler_t *const object)
 sat_status_t sat_scheduler_is_running (sat_scheduler_t *object)
 {
     sat_status_t status = sat_status_success (&status);
-    
+
     do
     {
         if (object == NULL)
@@ -137,7 +389,7 @@ sat_status_t sat_scheduler_is_running (sat_scheduler_t *object)
             break;
         }
 
-        if (object->running == false)
+        if (__atomic_load_n (&object->running, __ATOMIC_ACQUIRE) == false)
         {
             sat_status_set (&status, false, __func__, "sat scheduler is running error: not running");
             break;
@@ -166,7 +418,49 @@ sat_status_t sat_scheduler_get_amount (const sat_scheduler_t *const object, uint
             break;
         }
 
-        sat_set_get_size (object->set, (uint32_t *)amount);
+        *amount = (uint16_t) __atomic_load_n (&object->amount, __ATOMIC_RELAXED);
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_scheduler_get_event_stats (sat_scheduler_t *const object, const char *const name, sat_scheduler_event_stats_t *const stats)
+{
+    sat_status_t status = sat_status_success (&status);
+
+    do
+    {
+        if (object == NULL || object->events_amount == 0)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler get event stats error: null object");
+            break;
+        }
+
+        if (name == NULL || stats == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler get event stats error: null argument");
+            break;
+        }
+
+        pthread_mutex_lock (&object->mutex);
+
+        sat_scheduler_entry_t *entry = sat_scheduler_find (object, name);
+
+        if (entry == NULL)
+            status = sat_status_set (&status, false, __func__, "sat scheduler get event stats error: event not found");
+
+        else
+        {
+            stats->executions = entry->executions;
+            stats->missed = entry->missed;
+            stats->skipped = entry->skipped;
+            stats->queued = entry->queued;
+            stats->active = entry->active;
+            stats->lateness_max = entry->lateness_max;
+        }
+
+        pthread_mutex_unlock (&object->mutex);
 
     } while (false);
 
@@ -185,24 +479,142 @@ sat_status_t sat_scheduler_close (sat_scheduler_t *object)
 
     sat_scheduler_stop (object);
 
-    sat_set_destroy (object->set);
+    if (object->reactor != NULL)
+        sat_reactor_remove (object->reactor, object->timer);
+
+    // Runs still queued on the pool are dropped along with the events.
+    if (object->pooled == true)
+        sat_worker_close (&object->worker);
+
+    if (object->heap != NULL)
+    {
+        while (object->entries != NULL)
+        {
+            sat_scheduler_entry_t *entry = object->entries;
+
+            sat_scheduler_unlink (object, entry);
+            free (entry);
+        }
+
+        free (object->heap);
+        free (object->names);
+        free (object->handles);
+
+        pthread_cond_destroy (&object->cond);
+        pthread_mutex_destroy (&object->mutex);
+    }
 
     memset (object, 0, sizeof (sat_scheduler_t));
 
     return status;
 }
 
-static bool sat_scheduler_is_equal (const void *const element, const void *const new_element)
+static sat_status_t sat_scheduler_add (sat_scheduler_t *const object, const sat_scheduler_event_t *const event, sat_scheduler_handle_t *const handle)
 {
-    bool status = false;
+    sat_status_t status = sat_status_success (&status);
 
-    sat_scheduler_event_t *__element = (sat_scheduler_event_t *)element;
-    sat_scheduler_event_t *__new_element = (sat_scheduler_event_t *)new_element;
+    do
+    {
+        if (object == NULL || object->events_amount == 0)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler add event error: null object");
+            break;
+        }
+
+        if (sat_scheduler_is_event_valid (event) == false)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler add event error: null event");
+            break;
+        }
+
+        sat_scheduler_entry_t *entry = (sat_scheduler_entry_t *) calloc (1, sizeof (sat_scheduler_entry_t));
+        if (entry == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler add event error: memory allocation failed");
+            break;
+        }
+
+        entry->event = *event;
+
+        pthread_mutex_lock (&object->mutex);
+
+        if (event->name != NULL && sat_scheduler_find (object, event->name) != NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler add event error: name already in use");
+        }
+
+        // Events being run still own a slot they return to.
+        else if (object->dynamic == false && object->amount == object->events_amount)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler add event error: scheduler is full");
+        }
+
+        else
+        {
+            // Before the start every deadline is reset anyway.
+            entry->deadline = sat_scheduler_now () + event->timeout;
+
+            if (sat_scheduler_heap_push (object, entry) == false)
+                status = sat_status_set (&status, false, __func__, "sat scheduler add event error: memory allocation failed");
 
-    if (strcmp (__element->name, __new_element->name) == 0)
+            else
+            {
+                entry->handle = ++ object->next_handle;
+
+                if (object->amount >= object->buckets)
+                    sat_scheduler_index_grow (object);
+
+                sat_scheduler_index_add (object, entry);
+                sat_scheduler_link (object, entry);
+                __atomic_add_fetch (&object->amount, 1, __ATOMIC_RELAXED);
+
+                if (handle != NULL)
+                    *handle = entry->handle;
+
+                // Only a new earliest deadline shortens the current sleep.
+                if (entry->position == 0)
+                    sat_scheduler_wake (object);
+            }
+        }
+
+        pthread_mutex_unlock (&object->mutex);
+
+        if (sat_status_get_result (&status) == false)
+            free (entry);
+
+    } while (false);
+
+    return status;
+}
+
+static sat_status_t sat_scheduler_remove (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    sat_status_t status = sat_status_success (&status);
+
+    do
     {
-        status = true;
-    }
+        // Already fired one-shots and cancelled events are gone from the indexes.
+        if (entry == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat scheduler cancel error: event not found");
+            break;
+        }
+
+        sat_scheduler_retire (object, entry);
+        entry->cancelled = true;
+
+        // The next deadline can only be later, so the thread needs no wakeup.
+        if (entry->position != SAT_SCHEDULER_NOT_IN_HEAP)
+            sat_scheduler_heap_remove (object, entry->position);
+
+        // A running event is freed by its last run.
+        if (entry->active == 0)
+        {
+            sat_scheduler_unlink (object, entry);
+            free (entry);
+        }
+
+    } while (false);
 
     return status;
 }
@@ -211,10 +623,10 @@ static bool sat_scheduler_is_event_valid (const sat_scheduler_event_t *const eve
 {
     bool status = false;
 
+    // Events without a name are only reachable through their handle.
     if (event != NULL &&
         event->handler != NULL &&
-        event->name != NULL &&
-        strlen (event->name) > 0)
+        (event->name == NULL || strlen (event->name) > 0))
     {
         status = true;
     }
@@ -222,49 +634,469 @@ static bool sat_scheduler_is_event_valid (const sat_scheduler_event_t *const eve
     return status;
 }
 
+static sat_scheduler_entry_t *sat_scheduler_find (const sat_scheduler_t *const object, const char *const name)
+{
+    sat_scheduler_entry_t *entry = object->names [sat_hash_string (name, UINT32_MAX) & (object->buckets - 1)];
+
+    while (entry != NULL && strcmp (entry->event.name, name) != 0)
+        entry = entry->name_next;
+
+    return entry;
+}
+
+static sat_scheduler_entry_t *sat_scheduler_find_handle (const sat_scheduler_t *const object, const sat_scheduler_handle_t handle)
+{
+    sat_scheduler_entry_t *entry = object->handles [handle & (object->buckets - 1)];
+
+    while (entry != NULL && entry->handle != handle)
+        entry = entry->handle_next;
+
+    return entry;
+}
+
+static void sat_scheduler_link (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    entry->previous = NULL;
+    entry->next = object->entries;
+
+    if (object->entries != NULL)
+        object->entries->previous = entry;
+
+    object->entries = entry;
+}
+
+static void sat_scheduler_unlink (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    if (entry->previous != NULL)
+        entry->previous->next = entry->next;
+    else
+        object->entries = entry->next;
+
+    if (entry->next != NULL)
+        entry->next->previous = entry->previous;
+}
+
+static void sat_scheduler_retire (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    if (entry->cancelled == false)
+    {
+        sat_scheduler_index_remove (object, entry);
+        __atomic_sub_fetch (&object->amount, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static uint64_t sat_scheduler_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
+
+static void sat_scheduler_index_add (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    // Handles are sequential, so their low bits spread them evenly.
+    uint32_t bucket = entry->handle & (object->buckets - 1);
+
+    entry->handle_next = object->handles [bucket];
+    object->handles [bucket] = entry;
+
+    if (entry->event.name != NULL)
+    {
+        bucket = sat_hash_string (entry->event.name, UINT32_MAX) & (object->buckets - 1);
+
+        entry->name_next = object->names [bucket];
+        object->names [bucket] = entry;
+    }
+}
+
+static void sat_scheduler_index_remove (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    sat_scheduler_entry_t **link = &object->handles [entry->handle & (object->buckets - 1)];
+
+    while (*link != entry)
+        link = &(*link)->handle_next;
+
+    *link = entry->handle_next;
+
+    if (entry->event.name != NULL)
+    {
+        link = &object->names [sat_hash_string (entry->event.name, UINT32_MAX) & (object->buckets - 1)];
+
+        while (*link != entry)
+            link = &(*link)->name_next;
+
+        *link = entry->name_next;
+    }
+}
+
+static void sat_scheduler_index_grow (sat_scheduler_t *const object)
+{
+    uint32_t buckets = object->buckets * 2;
+    sat_scheduler_entry_t **names = (sat_scheduler_entry_t **) calloc (buckets, sizeof (sat_scheduler_entry_t *));
+    sat_scheduler_entry_t **handles = (sat_scheduler_entry_t **) calloc (buckets, sizeof (sat_scheduler_entry_t *));
+
+    // Without memory the chains just get longer.
+    if (names == NULL || handles == NULL)
+    {
+        free (names);
+        free (handles);
+        return;
+    }
+
+    free (object->names);
+    free (object->handles);
+
+    object->names = names;
+    object->handles = handles;
+    object->buckets = buckets;
+
+    for (sat_scheduler_entry_t *entry = object->entries; entry != NULL; entry = entry->next)
+    {
+        if (entry->cancelled == false)
+            sat_scheduler_index_add (object, entry);
+    }
+}
+
+static bool sat_scheduler_heap_push (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    if (object->size == object->capacity)
+    {
+        uint32_t capacity = object->capacity * 2;
+        sat_scheduler_entry_t **heap = (sat_scheduler_entry_t **) realloc (object->heap, capacity * sizeof (sat_scheduler_entry_t *));
+
+        if (heap == NULL)
+            return false;
+
+        object->heap = heap;
+        object->capacity = capacity;
+    }
+
+    entry->position = object->size;
+    object->heap [object->size++] = entry;
+
+    sat_scheduler_heap_sift_up (object, entry->position);
+
+    return true;
+}
+
+static void sat_scheduler_heap_remove (sat_scheduler_t *const object, const uint32_t position)
+{
+    sat_scheduler_entry_t *last = object->heap [--object->size];
+
+    object->heap [position]->position = SAT_SCHEDULER_NOT_IN_HEAP;
+
+    if (position < object->size)
+    {
+        // The last entry fills the hole and moves whichever way its deadline says.
+        object->heap [position] = last;
+        last->position = position;
+
+        sat_scheduler_heap_sift_up (object, position);
+        sat_scheduler_heap_sift_down (object, last->position);
+    }
+}
+
+static void sat_scheduler_heap_sift_up (sat_scheduler_t *const object, uint32_t position)
+{
+    sat_scheduler_entry_t *entry = object->heap [position];
+
+    while (position > 0)
+    {
+        uint32_t parent = (position - 1) / 2;
+
+        if (object->heap [parent]->deadline <= entry->deadline)
+            break;
+
+        object->heap [position] = object->heap [parent];
+        object->heap [position]->position = position;
+        position = parent;
+    }
+
+    object->heap [position] = entry;
+    entry->position = position;
+}
+
+static void sat_scheduler_heap_sift_down (sat_scheduler_t *const object, uint32_t position)
+{
+    sat_scheduler_entry_t *entry = object->heap [position];
+
+    while (true)
+    {
+        uint32_t child = position * 2 + 1;
+
+        if (child >= object->size)
+            break;
+
+        if (child + 1 < object->size && object->heap [child + 1]->deadline < object->heap [child]->deadline)
+            child ++;
+
+        if (entry->deadline <= object->heap [child]->deadline)
+            break;
+
+        object->heap [position] = object->heap [child];
+        object->heap [position]->position = position;
+        position = child;
+    }
+
+    object->heap [position] = entry;
+    entry->position = position;
+}
+
+static bool sat_scheduler_run_next (sat_scheduler_t *const object, uint64_t *const deadline)
+{
+    if (object->size == 0)
+    {
+        *deadline = 0;
+        return false;
+    }
+
+    sat_scheduler_entry_t *entry = object->heap [0];
+    uint64_t now = sat_scheduler_now ();
+
+    if (entry->deadline > now)
+    {
+        *deadline = entry->deadline;
+        return false;
+    }
+
+    // The event leaves the heap while it is dispatched without the lock,
+    // so handlers may add events or stop the scheduler.
+    sat_scheduler_heap_remove (object, 0);
+
+    if (now - entry->deadline > entry->lateness_max)
+        entry->lateness_max = now - entry->deadline;
+
+    bool dispatch = sat_scheduler_admit (entry);
+
+    // A fixed-rate event goes back right away, so its next deadline does
+    // not depend on how long this run takes. The slot it left is still free.
+    if (entry->event.type == sat_scheduler_type_periodic &&
+        entry->event.timing == sat_scheduler_timing_fixed_rate)
+    {
+        sat_scheduler_advance (entry, now);
+        sat_scheduler_heap_push (object, entry);
+    }
+
+    pthread_mutex_unlock (&object->mutex);
+
+    if (dispatch == true && object->pooled == false)
+        sat_scheduler_execute (object, entry);
+
+    else if (dispatch == true)
+    {
+        sat_scheduler_dispatch_t record = {.scheduler = object, .entry = entry};
+        sat_status_t status = sat_worker_feed (&object->worker, &record);
+
+        if (sat_status_get_result (&status) == false)
+        {
+            pthread_mutex_lock (&object->mutex);
+
+            entry->queued = 0;
+            sat_scheduler_complete (object, entry);
+
+            pthread_mutex_unlock (&object->mutex);
+        }
+    }
+
+    pthread_mutex_lock (&object->mutex);
+
+    return true;
+}
+
+static void sat_scheduler_wake (sat_scheduler_t *const object)
+{
+    if (object->reactor == NULL)
+        pthread_cond_signal (&object->cond);
+
+    // Before the start there is nothing to arm; the start does it.
+    else if (__atomic_load_n (&object->running, __ATOMIC_ACQUIRE) == true)
+        sat_scheduler_arm (object);
+}
+
+static void sat_scheduler_arm (sat_scheduler_t *const object)
+{
+    uint64_t timeout = 0;
+
+    if (object->size > 0)
+    {
+        uint64_t now = sat_scheduler_now ();
+
+        // A timeout of 0 would disarm the timer, so an overdue event waits a millisecond.
+        timeout = object->heap [0]->deadline > now ? object->heap [0]->deadline - now : 1;
+    }
+
+    sat_reactor_set_timer (object->reactor, object->timer, timeout, 0);
+}
+
 static void *sat_scheduler_main_handler (void *const context)
 {
     sat_scheduler_t *const object = (sat_scheduler_t *const)context;
-    uint32_t size;
-    sat_scheduler_event_t event;
-    uint64_t current;
 
-    sat_set_get_size (object->set, &size);
+    pthread_mutex_lock (&object->mutex);
+
+    while (__atomic_load_n (&object->running, __ATOMIC_ACQUIRE) == true)
+    {
+        uint64_t deadline;
+
+        if (sat_scheduler_run_next (object, &deadline) == true)
+            continue;
+
+        if (deadline == 0)
+        {
+            pthread_cond_wait (&object->cond, &object->mutex);
+            continue;
+        }
+
+        struct timespec timeout =
+        {
+            .tv_sec = (time_t) (deadline / 1000),
+            .tv_nsec = (long) (deadline % 1000) * 1000000,
+        };
+
+        // Woken up early by a new event, a stop or a spurious wakeup: look again.
+        pthread_cond_timedwait (&object->cond, &object->mutex, &timeout);
+    }
+
+    pthread_mutex_unlock (&object->mutex);
+
+    return NULL;
+}
+
+static void sat_scheduler_on_timer (int fd, uint32_t events, void *data)
+{
+    sat_scheduler_t *const object = (sat_scheduler_t *const) data;
+    uint64_t deadline;
+
+    (void) fd;
+    (void) events;
+
+    pthread_mutex_lock (&object->mutex);
+
+    while (__atomic_load_n (&object->running, __ATOMIC_ACQUIRE) == true && sat_scheduler_run_next (object, &deadline) == true)
+        ;
+
+    if (__atomic_load_n (&object->running, __ATOMIC_ACQUIRE) == true)
+        sat_scheduler_arm (object);
+
+    pthread_mutex_unlock (&object->mutex);
+}
+
+static bool sat_scheduler_admit (sat_scheduler_entry_t *const entry)
+{
+    bool status = true;
 
-    for (uint32_t i = 0; i < size; i++)
+    // Only a pooled fixed-rate event can come due while it is still running.
+    if (entry->active > 0 && entry->event.overlap == sat_scheduler_overlap_skip)
     {
-        sat_set_get_object_by (object->set, i, &event);
-        event.last_update = sat_time_get_epoch_now_ms ();
-        sat_set_update_by (object->set, &event, i);
+        entry->skipped ++;
+        status = false;
     }
 
-    while (object->running)
+    else if (entry->active > 0 && entry->event.overlap == sat_scheduler_overlap_queue)
     {
-        current = sat_time_get_epoch_now_ms ();
+        entry->queued ++;
+        status = false;
+    }
 
-        for (uint32_t i = 0; i < size; i++)
+    else
+    {
+        entry->active ++;
+        entry->executions ++;
+    }
+
+    return status;
+}
+
+static void sat_scheduler_advance (sat_scheduler_entry_t *const entry, const uint64_t now)
+{
+    uint64_t timeout = entry->event.timeout;
+
+    if (timeout == 0)
+    {
+        entry->deadline = now;
+        return;
+    }
+
+    entry->deadline += timeout;
+
+    // Deadlines the event fell behind on are counted, not run back to back.
+    if (entry->deadline < now)
+    {
+        uint64_t behind = (now - entry->deadline + timeout - 1) / timeout;
+
+        entry->missed += behind;
+        entry->deadline += behind * timeout;
+    }
+}
+
+static bool sat_scheduler_complete (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    if (entry->queued > 0)
+    {
+        // A queued run takes over the one that just ended.
+        if (__atomic_load_n (&object->running, __ATOMIC_ACQUIRE) == true && entry->cancelled == false)
         {
-            sat_set_get_object_by (object->set, i, &event);
+            entry->queued --;
+            entry->executions ++;
+            return true;
+        }
 
-            if (current > (event.timeout + event.last_update))
-            {
-                event.handler (event.object);
+        entry->queued = 0;
+    }
 
-                if (event.type == sat_scheduler_type_one_shot)
-                {
-                    sat_set_remove_by (object->set, i);
-                    sat_set_get_size (object->set, &size);
+    if (--entry->active > 0)
+        return false;
 
-                    continue;
-                }
+    if (entry->cancelled == true || entry->event.type == sat_scheduler_type_one_shot)
+    {
+        sat_scheduler_retire (object, entry);
+        sat_scheduler_unlink (object, entry);
+        free (entry);
+    }
 
-                event.last_update = sat_time_get_epoch_now_ms ();
-                sat_set_update_by (object->set, &event, i);
-            }
+    else if (entry->event.timing == sat_scheduler_timing_fixed_delay)
+    {
+        // The next period starts when the handler returns.
+        entry->deadline = sat_scheduler_now () + entry->event.timeout;
+
+        if (sat_scheduler_heap_push (object, entry) == false)
+        {
+            sat_scheduler_retire (object, entry);
+            sat_scheduler_unlink (object, entry);
+            free (entry);
         }
 
-        usleep (10);
+        else if (entry->position == 0 && object->pooled == true)
+            sat_scheduler_wake (object);
     }
 
-    return NULL;
-}
\ No newline at end of file
+    return false;
+}
+
+static void sat_scheduler_execute (sat_scheduler_t *const object, sat_scheduler_entry_t *const entry)
+{
+    sat_scheduler_t *previous = sat_scheduler_dispatching;
+    bool again;
+
+    sat_scheduler_dispatching = object;
+
+    do
+    {
+        entry->event.handler (entry->event.object);
+
+        pthread_mutex_lock (&object->mutex);
+        again = sat_scheduler_complete (object, entry);
+        pthread_mutex_unlock (&object->mutex);
+
+    } while (again == true);
+
+    sat_scheduler_dispatching = previous;
+}
+
+static void sat_scheduler_dispatch (void *const object)
+{
+    sat_scheduler_dispatch_t *dispatch = (sat_scheduler_dispatch_t *) object;
+
+    sat_scheduler_execute (dispatch->scheduler, dispatch->entry);
+}
@@ -1,7 +1,69 @@
 #include <sat.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static void scan (void *object)
+{
+    (void) object;
+
+    // Stands in for a scan that sometimes takes longer than its period.
+    usleep (250000);
+    printf ("scan done\n");
+}
+
+static void heartbeat (void *object)
+{
+    uint32_t *beats = (uint32_t *) object;
+
+    printf ("heartbeat %u\n", ++ *beats);
+}
 
 int main (int argc, char **argv)
 {
-    
+    sat_scheduler_t scheduler;
+    sat_scheduler_event_stats_t stats;
+    uint32_t beats = 0;
+
+    sat_scheduler_init (&scheduler);
+
+    sat_status_t status = sat_scheduler_open (&scheduler, &(sat_scheduler_args_t)
+                                                          {
+                                                              .event_amount = 2,
+                                                              .mode = sat_scheduler_mode_static,
+                                                              .pool_amount = 2,
+                                                          });
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                         {
+                                             .name = "scan",
+                                             .handler = scan,
+                                             .type = sat_scheduler_type_periodic,
+                                             .timeout = 100,
+                                             .timing = sat_scheduler_timing_fixed_rate,
+                                             .overlap = sat_scheduler_overlap_skip,
+                                         });
+
+    sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                         {
+                                             .name = "heartbeat",
+                                             .object = &beats,
+                                             .handler = heartbeat,
+                                             .type = sat_scheduler_type_periodic,
+                                             .timeout = 200,
+                                             .timing = sat_scheduler_timing_fixed_rate,
+                                         });
+
+    sat_scheduler_start (&scheduler);
+    sleep (1);
+    sat_scheduler_stop (&scheduler);
+
+    sat_scheduler_get_event_stats (&scheduler, "scan", &stats);
+    printf ("scan: %lu runs, %lu skipped while still running\n",
+            (unsigned long) stats.executions, (unsigned long) stats.skipped);
+
+    sat_scheduler_close (&scheduler);
+
     return 0;
 }
@@ -0,0 +1,278 @@
+#include <sat.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define TEST_PRODUCERS      4
+#define TEST_TIMERS         1000
+
+typedef struct
+{
+    sat_scheduler_t *scheduler;
+    uint32_t id;
+} producer_t;
+
+static uint8_t test_fired [TEST_PRODUCERS * TEST_TIMERS];
+static uint8_t test_cancelled [TEST_PRODUCERS * TEST_TIMERS];
+static uint32_t test_calls;
+static sat_scheduler_t *test_scheduler;
+static sat_scheduler_handle_t test_self;
+
+static void fire (void *object)
+{
+    __atomic_add_fetch (&test_fired [(uintptr_t) object], 1, __ATOMIC_RELAXED);
+}
+
+static void count (void *object)
+{
+    (void) object;
+
+    __atomic_add_fetch (&test_calls, 1, __ATOMIC_RELAXED);
+}
+
+static void slow (void *object)
+{
+    (void) object;
+
+    __atomic_add_fetch (&test_calls, 1, __ATOMIC_RELAXED);
+    usleep (50000);
+}
+
+static void cancel_self (void *object)
+{
+    (void) object;
+
+    __atomic_add_fetch (&test_calls, 1, __ATOMIC_RELAXED);
+
+    sat_status_t status = sat_scheduler_cancel (test_scheduler, test_self);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_open (sat_scheduler_t *const scheduler, const uint16_t amount, const sat_scheduler_mode_t mode, const uint8_t pool)
+{
+    sat_status_t status = sat_scheduler_init (scheduler);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_scheduler_open (scheduler, &(sat_scheduler_args_t) {.event_amount = amount, .mode = mode, .pool_amount = pool});
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_wait_amount (sat_scheduler_t *const scheduler, const uint16_t expected)
+{
+    uint16_t amount;
+
+    for (int i = 0; i < 3000; i++)
+    {
+        sat_scheduler_get_amount (scheduler, &amount);
+
+        if (amount == expected)
+            return;
+
+        usleep (1000);
+    }
+
+    assert (amount == expected);
+}
+
+static void *producer (void *args)
+{
+    producer_t *producer = (producer_t *) args;
+
+    for (uint32_t i = 0; i < TEST_TIMERS; i++)
+    {
+        uint32_t index = producer->id * TEST_TIMERS + i;
+        sat_scheduler_handle_t handle = 0;
+
+        // Connection timeouts: anonymous, short-lived, mostly cancelled.
+        sat_status_t status = sat_scheduler_schedule (producer->scheduler, &(sat_scheduler_event_t)
+                                                                           {
+                                                                               .object = (void *) (uintptr_t) index,
+                                                                               .handler = fire,
+                                                                               .type = sat_scheduler_type_one_shot,
+                                                                               .timeout = 50 + i % 50,
+                                                                           }, &handle);
+        assert (sat_status_get_result (&status) == true);
+        assert (handle != 0);
+
+        if (i % 2 == 0)
+        {
+            status = sat_scheduler_cancel (producer->scheduler, handle);
+            assert (sat_status_get_result (&status) == true);
+
+            test_cancelled [index] = 1;
+        }
+    }
+
+    return NULL;
+}
+
+static void test_many_timers (void)
+{
+    sat_scheduler_t scheduler;
+    pthread_t threads [TEST_PRODUCERS];
+    producer_t producers [TEST_PRODUCERS];
+
+    test_open (&scheduler, 16, sat_scheduler_mode_dynamic, 0);
+    sat_scheduler_start (&scheduler);
+
+    for (uint32_t i = 0; i < TEST_PRODUCERS; i++)
+    {
+        producers [i] = (producer_t) {.scheduler = &scheduler, .id = i};
+        pthread_create (&threads [i], NULL, producer, &producers [i]);
+    }
+
+    for (uint32_t i = 0; i < TEST_PRODUCERS; i++)
+        pthread_join (threads [i], NULL);
+
+    test_wait_amount (&scheduler, 0);
+    sat_scheduler_stop (&scheduler);
+
+    for (uint32_t i = 0; i < TEST_PRODUCERS * TEST_TIMERS; i++)
+        assert (test_fired [i] == (test_cancelled [i] ? 0 : 1));
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_handles (void)
+{
+    sat_scheduler_t scheduler;
+    sat_scheduler_handle_t handle;
+
+    test_open (&scheduler, 2, sat_scheduler_mode_static, 0);
+    test_calls = 0;
+
+    sat_scheduler_event_t event =
+    {
+        .name = "timeout",
+        .handler = count,
+        .type = sat_scheduler_type_one_shot,
+        .timeout = 10,
+    };
+
+    sat_status_t status = sat_scheduler_schedule (&scheduler, &event, &handle);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_scheduler_start (&scheduler);
+    test_wait_amount (&scheduler, 0);
+
+    // Fired one-shots are gone, and their handle is not given to anyone else.
+    status = sat_scheduler_cancel (&scheduler, handle);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_scheduler_cancel (&scheduler, 0);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_scheduler_handle_t next;
+    event.timeout = 60000;
+    status = sat_scheduler_schedule (&scheduler, &event, &next);
+    assert (sat_status_get_result (&status) == true);
+    assert (next != handle);
+
+    status = sat_scheduler_cancel (&scheduler, next);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_scheduler_cancel (&scheduler, next);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_scheduler_schedule (&scheduler, &event, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_cancel_by_name (void)
+{
+    sat_scheduler_t scheduler;
+
+    test_open (&scheduler, 1, sat_scheduler_mode_static, 0);
+    test_calls = 0;
+
+    sat_scheduler_event_t event =
+    {
+        .name = "poll",
+        .handler = count,
+        .type = sat_scheduler_type_periodic,
+        .timeout = 5,
+    };
+
+    sat_scheduler_add_event (&scheduler, &event);
+    sat_scheduler_start (&scheduler);
+
+    while (__atomic_load_n (&test_calls, __ATOMIC_RELAXED) < 3)
+        usleep (1000);
+
+    sat_status_t status = sat_scheduler_cancel_by_name (&scheduler, "poll");
+    assert (sat_status_get_result (&status) == true);
+
+    // A run may have been in progress while cancelling.
+    usleep (20000);
+    uint32_t calls = __atomic_load_n (&test_calls, __ATOMIC_RELAXED);
+    usleep (50000);
+    assert (__atomic_load_n (&test_calls, __ATOMIC_RELAXED) == calls);
+
+    status = sat_scheduler_cancel_by_name (&scheduler, "poll");
+    assert (sat_status_get_result (&status) == false);
+
+    // The slot and the name are free again.
+    status = sat_scheduler_add_event (&scheduler, &event);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_cancel_running (uint8_t pool)
+{
+    sat_scheduler_t scheduler;
+    sat_scheduler_handle_t handle;
+
+    test_open (&scheduler, 2, sat_scheduler_mode_static, pool);
+    test_calls = 0;
+    test_scheduler = &scheduler;
+
+    sat_status_t status = sat_scheduler_schedule (&scheduler, &(sat_scheduler_event_t)
+                                                              {
+                                                                  .handler = cancel_self,
+                                                                  .type = sat_scheduler_type_periodic,
+                                                                  .timeout = 5,
+                                                                  .timing = sat_scheduler_timing_fixed_rate,
+                                                              }, &test_self);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_scheduler_schedule (&scheduler, &(sat_scheduler_event_t)
+                                                 {
+                                                     .handler = slow,
+                                                     .type = sat_scheduler_type_periodic,
+                                                     .timeout = 20,
+                                                 }, &handle);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_scheduler_start (&scheduler);
+
+    while (__atomic_load_n (&test_calls, __ATOMIC_RELAXED) < 2)
+        usleep (1000);
+
+    // Cancelled while its handler sleeps; it is freed when the run ends.
+    usleep (10000);
+    status = sat_scheduler_cancel (&scheduler, handle);
+    assert (sat_status_get_result (&status) == true);
+
+    uint16_t amount;
+    sat_scheduler_get_amount (&scheduler, &amount);
+    assert (amount == 0);
+
+    usleep (100000);
+    assert (__atomic_load_n (&test_calls, __ATOMIC_RELAXED) == 2);
+
+    sat_scheduler_close (&scheduler);
+}
+
+int main (int argc, char *argv[])
+{
+    test_many_timers ();
+    test_handles ();
+    test_cancel_by_name ();
+    test_cancel_running (0);
+    test_cancel_running (2);
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <sat.h>
+#include <assert.h>
+#include <unistd.h>
+
+typedef struct
+{
+    uint32_t sleep;
+    uint32_t calls;
+    uint32_t inflight;
+    uint32_t inflight_max;
+} probe_t;
+
+static sat_scheduler_t *test_scheduler;
+static uint32_t test_stopped;
+
+static void probe (void *object)
+{
+    probe_t *probe = (probe_t *) object;
+
+    uint32_t inflight = __atomic_add_fetch (&probe->inflight, 1, __ATOMIC_ACQ_REL);
+    uint32_t max = __atomic_load_n (&probe->inflight_max, __ATOMIC_RELAXED);
+
+    while (inflight > max && __atomic_compare_exchange_n (&probe->inflight_max, &max, inflight, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false)
+        ;
+
+    __atomic_add_fetch (&probe->calls, 1, __ATOMIC_RELAXED);
+    usleep (probe->sleep * 1000);
+
+    __atomic_sub_fetch (&probe->inflight, 1, __ATOMIC_ACQ_REL);
+}
+
+static void late_once (void *object)
+{
+    probe_t *probe = (probe_t *) object;
+
+    if (__atomic_fetch_add (&probe->calls, 1, __ATOMIC_RELAXED) == 0)
+        usleep (55000);
+}
+
+static void stop_self (void *object)
+{
+    (void) object;
+
+    sat_scheduler_stop (test_scheduler);
+    __atomic_store_n (&test_stopped, 1, __ATOMIC_RELEASE);
+}
+
+static void test_open (sat_scheduler_t *const scheduler, const uint8_t pool)
+{
+    sat_status_t status = sat_scheduler_init (scheduler);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_scheduler_open (scheduler, &(sat_scheduler_args_t)
+                                            {
+                                                .event_amount = 4,
+                                                .mode = sat_scheduler_mode_static,
+                                                .pool_amount = pool,
+                                            });
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_add (sat_scheduler_t *const scheduler, char *name, probe_t *probe, sat_scheduler_handler_t handler,
+                      uint64_t timeout, sat_scheduler_timing_t timing, sat_scheduler_overlap_t overlap)
+{
+    sat_status_t status = sat_scheduler_add_event (scheduler, &(sat_scheduler_event_t)
+                                                              {
+                                                                  .name = name,
+                                                                  .object = probe,
+                                                                  .handler = handler,
+                                                                  .type = sat_scheduler_type_periodic,
+                                                                  .timeout = timeout,
+                                                                  .timing = timing,
+                                                                  .overlap = overlap,
+                                                              });
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_slow_does_not_delay (void)
+{
+    sat_scheduler_t scheduler;
+    probe_t slow = {.sleep = 200};
+    probe_t fast = {.sleep = 0};
+
+    test_open (&scheduler, 2);
+
+    test_add (&scheduler, "slow", &slow, probe, 10, sat_scheduler_timing_fixed_delay, sat_scheduler_overlap_skip);
+    test_add (&scheduler, "fast", &fast, probe, 10, sat_scheduler_timing_fixed_rate, sat_scheduler_overlap_skip);
+
+    sat_scheduler_start (&scheduler);
+    usleep (300000);
+    sat_scheduler_stop (&scheduler);
+
+    // On the scheduler thread the fast event would have waited on the slow one.
+    assert (fast.calls >= 15);
+    assert (slow.calls >= 1 && slow.calls <= 2);
+    assert (slow.inflight_max == 1);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_overlap (sat_scheduler_overlap_t overlap)
+{
+    sat_scheduler_t scheduler;
+    probe_t probe_ = {.sleep = 35};
+    sat_scheduler_event_stats_t stats;
+    uint32_t queued_max = 0;
+
+    test_open (&scheduler, 4);
+    test_add (&scheduler, "overlap", &probe_, probe, 10, sat_scheduler_timing_fixed_rate, overlap);
+
+    sat_scheduler_start (&scheduler);
+
+    for (int i = 0; i < 20; i++)
+    {
+        usleep (10000);
+
+        sat_status_t status = sat_scheduler_get_event_stats (&scheduler, "overlap", &stats);
+        assert (sat_status_get_result (&status) == true);
+
+        if (stats.queued > queued_max)
+            queued_max = stats.queued;
+    }
+
+    sat_scheduler_stop (&scheduler);
+    sat_scheduler_get_event_stats (&scheduler, "overlap", &stats);
+
+    assert (stats.active == 0);
+    assert (stats.queued == 0);
+    assert (stats.executions == probe_.calls);
+
+    switch (overlap)
+    {
+        case sat_scheduler_overlap_skip:
+            assert (probe_.inflight_max == 1);
+            assert (stats.skipped > 0);
+            break;
+
+        case sat_scheduler_overlap_queue:
+            assert (probe_.inflight_max == 1);
+            assert (stats.skipped == 0);
+            assert (queued_max > 0);
+            break;
+
+        case sat_scheduler_overlap_concurrent:
+            assert (probe_.inflight_max >= 2);
+            assert (stats.skipped == 0);
+            break;
+    }
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_fixed_rate (void)
+{
+    sat_scheduler_t scheduler;
+    probe_t steady = {.sleep = 5};
+    sat_scheduler_event_stats_t stats;
+
+    test_open (&scheduler, 0);
+    test_add (&scheduler, "steady", &steady, probe, 10, sat_scheduler_timing_fixed_rate, sat_scheduler_overlap_skip);
+
+    sat_scheduler_start (&scheduler);
+    usleep (505000);
+    sat_scheduler_stop (&scheduler);
+
+    // Fixed delay would have stretched every period by the handler time.
+    sat_scheduler_get_event_stats (&scheduler, "steady", &stats);
+    assert (stats.executions + stats.missed >= 45);
+    assert (stats.executions + stats.missed <= 51);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_missed (void)
+{
+    sat_scheduler_t scheduler;
+    probe_t late = {0};
+    sat_scheduler_event_stats_t stats;
+
+    test_open (&scheduler, 0);
+    test_add (&scheduler, "late", &late, late_once, 10, sat_scheduler_timing_fixed_rate, sat_scheduler_overlap_skip);
+
+    sat_scheduler_start (&scheduler);
+    usleep (150000);
+    sat_scheduler_stop (&scheduler);
+
+    // The first run overstays by 45 ms: the deadlines in between are counted, not replayed.
+    sat_scheduler_get_event_stats (&scheduler, "late", &stats);
+    assert (stats.missed >= 3);
+    assert (stats.lateness_max >= 40);
+    assert (stats.executions == late.calls);
+
+    sat_status_t status = sat_scheduler_get_event_stats (&scheduler, "unknown", &stats);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_stop_from_pool (void)
+{
+    sat_scheduler_t scheduler;
+
+    test_open (&scheduler, 2);
+    test_scheduler = &scheduler;
+    test_stopped = 0;
+
+    sat_status_t status = sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                                               {
+                                                                   .name = "stop",
+                                                                   .handler = stop_self,
+                                                                   .type = sat_scheduler_type_one_shot,
+                                                                   .timeout = 10,
+                                                               });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_scheduler_start (&scheduler);
+
+    while (__atomic_load_n (&test_stopped, __ATOMIC_ACQUIRE) == 0)
+        usleep (1000);
+
+    status = sat_scheduler_is_running (&scheduler);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_scheduler_close (&scheduler);
+}
+
+int main (int argc, char *argv[])
+{
+    test_slow_does_not_delay ();
+    test_overlap (sat_scheduler_overlap_skip);
+    test_overlap (sat_scheduler_overlap_queue);
+    test_overlap (sat_scheduler_overlap_concurrent);
+    test_fixed_rate ();
+    test_missed ();
+    test_stop_from_pool ();
+
+    return 0;
+}
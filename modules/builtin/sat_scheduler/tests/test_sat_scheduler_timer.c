@@ -0,0 +1,216 @@
+#include <sat.h>
+#include <assert.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/resource.h>
+
+static uint32_t test_order [8];
+static uint32_t test_fired;
+static uint32_t test_ticks;
+
+static void record (void *object)
+{
+    uint32_t index = __atomic_fetch_add (&test_fired, 1, __ATOMIC_ACQ_REL);
+
+    if (index < 8)
+        test_order [index] = (uint32_t) (uintptr_t) object;
+}
+
+static void tick (void *object)
+{
+    (void) object;
+
+    __atomic_add_fetch (&test_ticks, 1, __ATOMIC_RELAXED);
+}
+
+static double test_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static double test_cpu (void)
+{
+    struct rusage usage;
+    getrusage (RUSAGE_SELF, &usage);
+
+    return (double) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           (double) (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static void test_open (sat_scheduler_t *const scheduler, const uint16_t amount, const sat_scheduler_mode_t mode)
+{
+    sat_status_t status = sat_scheduler_init (scheduler);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_scheduler_open (scheduler, &(sat_scheduler_args_t) {.event_amount = amount, .mode = mode});
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_idle_does_not_spin (void)
+{
+    sat_scheduler_t scheduler;
+
+    test_open (&scheduler, 5, sat_scheduler_mode_static);
+    test_ticks = 0;
+
+    const char *names [] = {"announce", "scan", "heartbeat", "interest", "ageing"};
+
+    for (int i = 0; i < 5; i++)
+    {
+        sat_status_t status = sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                                                   {
+                                                                       .name = (char *) names [i],
+                                                                       .handler = tick,
+                                                                       .type = sat_scheduler_type_periodic,
+                                                                       .timeout = 100 + i * 50,
+                                                                   });
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    double cpu = test_cpu ();
+
+    sat_scheduler_start (&scheduler);
+    usleep (500000);
+    sat_scheduler_stop (&scheduler);
+
+    // A polling loop would have burnt most of the half second.
+    assert (test_cpu () - cpu < 0.1);
+    assert (test_ticks >= 5);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_add_while_running (void)
+{
+    sat_scheduler_t scheduler;
+
+    test_open (&scheduler, 2, sat_scheduler_mode_dynamic);
+    test_fired = 0;
+
+    sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                         {
+                                             .name = "far",
+                                             .handler = record,
+                                             .type = sat_scheduler_type_one_shot,
+                                             .timeout = 60000,
+                                         });
+
+    sat_scheduler_start (&scheduler);
+    usleep (20000);
+
+    // The thread sleeps until the far deadline; the new event must wake it.
+    double start = test_now ();
+
+    sat_status_t status = sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                                               {
+                                                                   .name = "near",
+                                                                   .object = (void *) 1,
+                                                                   .handler = record,
+                                                                   .type = sat_scheduler_type_one_shot,
+                                                                   .timeout = 10,
+                                                               });
+    assert (sat_status_get_result (&status) == true);
+
+    while (__atomic_load_n (&test_fired, __ATOMIC_ACQUIRE) == 0)
+    {
+        assert (test_now () - start < 2.0);
+        usleep (1000);
+    }
+
+    // Joining the thread publishes what the handlers wrote.
+    sat_scheduler_stop (&scheduler);
+    assert (test_order [0] == 1);
+
+    uint16_t amount = 0;
+    sat_scheduler_get_amount (&scheduler, &amount);
+    assert (amount == 1);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_deadline_order (void)
+{
+    sat_scheduler_t scheduler;
+    uint32_t timeouts [] = {60, 10, 40, 20, 50, 30};
+    char names [6][8];
+
+    test_open (&scheduler, 2, sat_scheduler_mode_dynamic);
+    test_fired = 0;
+
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        snprintf (names [i], sizeof (names [i]), "e%u", i);
+
+        sat_status_t status = sat_scheduler_add_event (&scheduler, &(sat_scheduler_event_t)
+                                                                   {
+                                                                       .name = names [i],
+                                                                       .object = (void *) (uintptr_t) timeouts [i],
+                                                                       .handler = record,
+                                                                       .type = sat_scheduler_type_one_shot,
+                                                                       .timeout = timeouts [i],
+                                                                   });
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    sat_scheduler_start (&scheduler);
+
+    while (__atomic_load_n (&test_fired, __ATOMIC_ACQUIRE) < 6)
+        usleep (1000);
+
+    sat_scheduler_stop (&scheduler);
+
+    for (uint32_t i = 0; i < 6; i++)
+        assert (test_order [i] == (i + 1) * 10);
+
+    uint16_t amount = 0;
+    sat_scheduler_get_amount (&scheduler, &amount);
+    assert (amount == 0);
+
+    sat_scheduler_close (&scheduler);
+}
+
+static void test_capacity_and_names (void)
+{
+    sat_scheduler_t scheduler;
+
+    test_open (&scheduler, 2, sat_scheduler_mode_static);
+
+    sat_scheduler_event_t event =
+    {
+        .name = "first",
+        .handler = tick,
+        .type = sat_scheduler_type_periodic,
+        .timeout = 1000,
+    };
+
+    sat_status_t status = sat_scheduler_add_event (&scheduler, &event);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_scheduler_add_event (&scheduler, &event);
+    assert (sat_status_get_result (&status) == false);
+
+    event.name = "second";
+    status = sat_scheduler_add_event (&scheduler, &event);
+    assert (sat_status_get_result (&status) == true);
+
+    event.name = "third";
+    status = sat_scheduler_add_event (&scheduler, &event);
+    assert (sat_status_get_result (&status) == false);
+
+    // Closing a scheduler that was never started must not join anything.
+    status = sat_scheduler_close (&scheduler);
+    assert (sat_status_get_result (&status) == true);
+}
+
+int main (int argc, char *argv[])
+{
+    test_idle_does_not_spin ();
+    test_add_while_running ();
+    test_deadline_order ();
+    test_capacity_and_names ();
+
+    return 0;
+}
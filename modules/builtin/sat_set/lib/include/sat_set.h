@@ -14,6 +14,7 @@
 #define SAT_SET_H_
 
 #include <sat_status.h>
+#include <sat_allocator.h>
 #include <stdint.h>
 
 /**
@@ -45,6 +46,17 @@ typedef bool (*sat_set_compare_t) (const void *const element, const void *const
  */
 typedef bool (*sat_set_is_equal_t) (const void *const element, const void *const new_element);
 
+/**
+ * @brief Hash function type for the hashed mode
+ * 
+ * Hashes the identity of an element (or of a search parameter). Two inputs
+ * considered equal must produce the same hash.
+ * 
+ * @param data Pointer to the element or search parameter to hash
+ * @return 32-bit hash value
+ */
+typedef uint32_t (*sat_set_hash_t) (const void *const data);
+
 /**
  * @brief Set growth mode
  * 
@@ -60,6 +72,11 @@ typedef enum
  * @brief Configuration structure for set creation
  * 
  * Contains all parameters needed to create and configure a new set.
+ * 
+ * Setting @c hash.element enables the hashed mode: a hash index is kept next
+ * to the dense element storage, making sat_set_add() O(1) on average. Setting
+ * @c hash.param as well makes the *_by_parameter functions O(1), as long as
+ * the parameter hashes to the same value as the elements it matches.
  */
 typedef struct
 {
@@ -67,6 +84,16 @@ typedef struct
     uint32_t object_size;       /**< Size in bytes of each set element */
     sat_set_is_equal_t is_equal;/**< Function to check element equality */
     sat_set_mode_t mode;        /**< Growth mode (static or dynamic) */
+    sat_allocator_t allocator;  /**< Optional allocator for the set and its storage, zero selects the C library */
+
+    /**
+     * @brief Optional hash functions for the hashed mode
+     */
+    struct
+    {
+        sat_set_hash_t element; /**< Hashes an element, enables the hashed mode */
+        sat_set_hash_t param;   /**< Hashes a search parameter, enables O(1) parameter lookups */
+    } hash;
 } sat_set_args_t;
 
 /**
@@ -111,7 +138,8 @@ sat_status_t sat_set_add (sat_set_t *const object, const void *const data);
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @warning Index must be less than the current set size
- * @note This does not check for duplicates
+ * @note This does not check for duplicates, except in the hashed mode where
+ *       an update that would duplicate another element is rejected
  */
 sat_status_t sat_set_update_by (sat_set_t *const object, const void *const data, uint32_t index);
 
@@ -127,6 +155,8 @@ sat_status_t sat_set_update_by (sat_set_t *const object, const void *const data,
  * 
  * @warning Index must be less than the current set size
  * @note This operation has O(n) complexity due to element shifting
+ * @note In the hashed mode the last element is moved into the freed position
+ *       instead, making removal O(1) but not order preserving
  */
 sat_status_t sat_set_remove_by (sat_set_t *const object, uint32_t index);
 
@@ -143,6 +173,8 @@ sat_status_t sat_set_remove_by (sat_set_t *const object, uint32_t index);
  * @return sat_status_t indicating success or failure of the operation
  * 
  * @note Only the first matching element is removed
+ * @note In the hashed mode with @c hash.param set, only elements hashing like
+ *       @p param are compared, and the last element fills the freed position
  * @see sat_set_compare_t
  */
 sat_status_t sat_set_remove_by_parameter (sat_set_t *const object, const void *const param, sat_set_compare_t compare, void *const data);
@@ -1,9 +1,20 @@
 #include <sat_set.h>
 #include <sat_array.h>
+#include <sat_hash.h>
 #include <string.h>
 #include <stdlib.h>
 #include <sat_iterator.h>
 
+#define SAT_SET_INDEX_MIN_CAPACITY   16
+#define SAT_SET_INDEX_EMPTY          0
+#define SAT_SET_INDEX_DELETED        UINT32_MAX
+
+typedef struct
+{
+    uint32_t hash;
+    uint32_t position;      // element index + 1, or one of the markers above
+} sat_set_bucket_t;
+
 struct sat_set_t
 {
     sat_iterator_base_t base;
@@ -13,6 +24,17 @@ struct sat_set_t
     sat_set_is_equal_t is_equal;
     uint32_t size;
     sat_set_mode_t mode;
+    sat_allocator_t allocator;
+
+    struct
+    {
+        sat_set_hash_t element;
+        sat_set_hash_t param;
+        sat_set_bucket_t *buckets;
+        uint32_t capacity;
+        uint32_t used;
+        uint32_t deleted;
+    } hash;
 };
 
 static void *sat_set_next (const void *const object, const uint32_t index);
@@ -23,6 +45,13 @@ static void sat_set_set_context (sat_set_t *const object, const sat_set_args_t *
 static sat_status_t sat_set_buffer_allocate (sat_set_t *const object);
 
 static void sat_set_on_increase (void *const user, uint32_t new_size);
+
+static bool sat_set_is_hashed (const sat_set_t *const object);
+static sat_status_t sat_set_index_rebuild (sat_set_t *const object);
+static sat_status_t sat_set_hashed_add (sat_set_t *const object, const void *const data);
+static sat_status_t sat_set_hashed_update_by (sat_set_t *const object, const void *const data, const uint32_t index);
+static sat_status_t sat_set_hashed_remove_by (sat_set_t *const object, const uint32_t index);
+static sat_status_t sat_set_hashed_find_by_parameter (const sat_set_t *const object, const void *const param, sat_set_compare_t compare, uint32_t *const index);
 sat_status_t sat_set_create (sat_set_t **const object, const sat_set_args_t *const args)
 {
     sat_status_t status;
@@ -39,14 +68,14 @@ sat_status_t sat_set_create (sat_set_t **const object, const sat_set_args_t *con
             break;
         }
         
-        sat_set_t *__object = calloc (1, sizeof (struct sat_set_t));
+        sat_set_t *__object = sat_allocator_allocate_zeroed (&args->allocator, sizeof (struct sat_set_t));
         if (__object == NULL)
             break;
 
-        __object->element = calloc (1, args->object_size);
+        __object->element = sat_allocator_allocate_zeroed (&args->allocator, args->object_size);
         if (__object->element == NULL)
         {
-            free (__object);
+            sat_allocator_release (&args->allocator, __object, sizeof (struct sat_set_t));
             break;
         }
 
@@ -55,12 +84,25 @@ sat_status_t sat_set_create (sat_set_t **const object, const sat_set_args_t *con
         status = sat_set_buffer_allocate (__object);
         if (sat_status_get_result (&status) == false)
         {
-            free (__object->element);
-            free (__object);
+            sat_allocator_release (&args->allocator, __object->element, args->object_size);
+            sat_allocator_release (&args->allocator, __object, sizeof (struct sat_set_t));
 
             break;
         }
 
+        if (sat_set_is_hashed (__object) == true)
+        {
+            status = sat_set_index_rebuild (__object);
+            if (sat_status_get_result (&status) == false)
+            {
+                sat_array_destroy (__object->array);
+                sat_allocator_release (&args->allocator, __object->element, args->object_size);
+                sat_allocator_release (&args->allocator, __object, sizeof (struct sat_set_t));
+
+                break;
+            }
+        }
+
         __object->base.object = __object;
         __object->base.get_amount = sat_set_get_amount;
         __object->base.next = sat_set_next;
@@ -78,7 +120,12 @@ sat_status_t sat_set_add (sat_set_t *const object, const void *const data)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat set add error");
 
-    if (object != NULL && data != NULL)
+    if (object != NULL && data != NULL && sat_set_is_hashed (object) == true)
+    {
+        status = sat_set_hashed_add (object, data);
+    }
+
+    else if (object != NULL && data != NULL)
     {
         uint32_t amount = 0;
         uint32_t index;
@@ -87,11 +134,8 @@ sat_status_t sat_set_add (sat_set_t *const object, const void *const data)
 
         for (index = 0; index < amount; index++)
         {
-            memset (object->element, 0, object->object_size);
-
-            sat_array_get_object_by (object->array, index, object->element);
-
-            if (object->is_equal (object->element, data) == true)
+            // compare in place, there is no need to copy every element out
+            if (object->is_equal (sat_array_get_reference_by (object->array, index), data) == true)
             {
                 break;
             }
@@ -110,7 +154,12 @@ sat_status_t sat_set_update_by (sat_set_t *const object, const void *const data,
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat set update by error");
 
-    if (object != NULL)
+    if (object != NULL && data != NULL && sat_set_is_hashed (object) == true)
+    {
+        status = sat_set_hashed_update_by (object, data, index);
+    }
+
+    else if (object != NULL)
     {
         status = sat_array_update_by (object->array, data, index);
     }
@@ -122,7 +171,12 @@ sat_status_t sat_set_remove_by (sat_set_t *const object, const uint32_t index)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat set remove by error");
 
-    if (object != NULL)
+    if (object != NULL && sat_set_is_hashed (object) == true)
+    {
+        status = sat_set_hashed_remove_by (object, index);
+    }
+
+    else if (object != NULL)
     {
         status = sat_array_remove_by (object->array, index);
     }
@@ -134,7 +188,21 @@ sat_status_t sat_set_remove_by_parameter (sat_set_t *const object, const void *c
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat set remove by parameter error");
 
-    if (object != NULL)
+    if (object != NULL && sat_set_is_hashed (object) == true)
+    {
+        uint32_t index;
+
+        status = sat_set_hashed_find_by_parameter (object, param, compare, &index);
+        if (sat_status_get_result (&status) == true)
+        {
+            if (data != NULL)
+                memcpy (data, sat_array_get_reference_by (object->array, index), object->object_size);
+
+            status = sat_set_hashed_remove_by (object, index);
+        }
+    }
+
+    else if (object != NULL)
     {
         status = sat_array_remove_by_parameter (object->array, param, (sat_array_compare_t)compare, data);
     }
@@ -158,7 +226,18 @@ sat_status_t sat_set_get_object_by_parameter (const sat_set_t *const object, con
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat set get object by parameter error");
 
-    if (object != NULL)
+    if (object != NULL && data != NULL && sat_set_is_hashed (object) == true)
+    {
+        uint32_t index;
+
+        status = sat_set_hashed_find_by_parameter (object, param, compare, &index);
+        if (sat_status_get_result (&status) == true)
+        {
+            status = sat_array_get_object_by (object->array, index, data);
+        }
+    }
+
+    else if (object != NULL)
     {
         status = sat_array_get_object_by_parameter (object->array, param, (sat_array_compare_t)compare, data);
     }
@@ -170,7 +249,18 @@ sat_status_t sat_set_get_object_ref_by_parameter (sat_set_t *const object, const
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat set get object ref by parameter error");
 
-    if (object != NULL)
+    if (object != NULL && data != NULL && sat_set_is_hashed (object) == true)
+    {
+        uint32_t index;
+
+        status = sat_set_hashed_find_by_parameter (object, param, compare, &index);
+        if (sat_status_get_result (&status) == true)
+        {
+            *data = sat_array_get_reference_by (object->array, index);
+        }
+    }
+
+    else if (object != NULL)
     {
         status = sat_array_get_object_ref_by_parameter (object->array, param, (sat_array_compare_t)compare, data);
     }
@@ -198,8 +288,11 @@ sat_status_t sat_set_destroy (sat_set_t *object)
     {
         status = sat_array_destroy (object->array);
 
-        free ((*object).element);
-        free (object);
+        sat_allocator_t allocator = object->allocator;
+
+        sat_allocator_release (&allocator, object->hash.buckets, (size_t) object->hash.capacity * sizeof (sat_set_bucket_t));
+        sat_allocator_release (&allocator, object->element, object->object_size);
+        sat_allocator_release (&allocator, object, sizeof (struct sat_set_t));
     }
 
     return status;
@@ -221,6 +314,12 @@ sat_status_t sat_set_clone (const sat_set_t *const object, sat_set_t **const clo
             .object_size = object->object_size,
             .is_equal    = object->is_equal,
             .mode        = object->mode,
+            .allocator   = object->allocator,
+            .hash =
+            {
+                .element = object->hash.element,
+                .param   = object->hash.param,
+            },
         };
 
         status = sat_set_create (cloned, &args);
@@ -238,6 +337,17 @@ sat_status_t sat_set_clone (const sat_set_t *const object, sat_set_t **const clo
             break;
         }
 
+        if (sat_set_is_hashed (*cloned) == true)
+        {
+            status = sat_set_index_rebuild (*cloned);
+            if (sat_status_get_result (&status) == false)
+            {
+                sat_set_destroy (*cloned);
+                *cloned = NULL;
+                break;
+            }
+        }
+
     } while (false);
 
     return status;
@@ -264,6 +374,9 @@ static void sat_set_set_context (sat_set_t *const object, const sat_set_args_t *
     object->is_equal = args->is_equal;
     object->mode = args->mode;
     object->size = args->size;
+    object->hash.element = args->hash.element;
+    object->hash.param = args->hash.param;
+    object->allocator = args->allocator;
 }
 
 static sat_status_t sat_set_buffer_allocate (sat_set_t *object)
@@ -273,6 +386,7 @@ static sat_status_t sat_set_buffer_allocate (sat_set_t *object)
                                                 .size = object->size,
                                                 .object_size = object->object_size,
                                                 .mode = (sat_array_mode_t) object->mode,
+                                                .allocator = object->allocator,
                                                 .notification =
                                                 {
                                                     .on_increase = sat_set_on_increase,
@@ -311,4 +425,251 @@ static void sat_set_on_increase (void *const user, uint32_t new_size)
     sat_set_t *set = (sat_set_t *) user;
     
     set->size = new_size;
-}
\ No newline at end of file
+}
+
+static bool sat_set_is_hashed (const sat_set_t *const object)
+{
+    return object->hash.element != NULL;
+}
+
+static uint32_t sat_set_index_capacity_for (uint32_t amount)
+{
+    uint64_t wanted = ((uint64_t) amount + 1) * 2;
+
+    if (wanted > UINT32_MAX)
+        return 0;
+
+    return sat_hash_next_power_of_two (wanted > SAT_SET_INDEX_MIN_CAPACITY ? (uint32_t) wanted : SAT_SET_INDEX_MIN_CAPACITY);
+}
+
+static sat_set_bucket_t *sat_set_index_reserve (sat_set_t *const object, uint32_t hash)
+{
+    uint32_t mask = object->hash.capacity - 1;
+    uint32_t index = hash & mask;
+
+    // the load factor is kept under 75%, so a free bucket always exists
+    while (object->hash.buckets [index].position != SAT_SET_INDEX_EMPTY &&
+           object->hash.buckets [index].position != SAT_SET_INDEX_DELETED)
+    {
+        index = (index + 1) & mask;
+    }
+
+    if (object->hash.buckets [index].position == SAT_SET_INDEX_DELETED)
+        object->hash.deleted --;
+
+    object->hash.used ++;
+    object->hash.buckets [index].hash = hash;
+
+    return &object->hash.buckets [index];
+}
+
+static sat_set_bucket_t *sat_set_index_find_position (const sat_set_t *const object, uint32_t hash, uint32_t position)
+{
+    uint32_t mask = object->hash.capacity - 1;
+
+    for (uint32_t probe = 0, index = hash & mask; probe < object->hash.capacity; probe++, index = (index + 1) & mask)
+    {
+        sat_set_bucket_t *bucket = &object->hash.buckets [index];
+
+        if (bucket->position == SAT_SET_INDEX_EMPTY)
+            break;
+
+        if (bucket->position == position + 1)
+            return bucket;
+    }
+
+    return NULL;
+}
+
+static sat_status_t sat_set_index_rebuild (sat_set_t *const object)
+{
+    uint32_t amount = 0;
+
+    sat_array_get_size (object->array, &amount);
+
+    uint32_t capacity = sat_set_index_capacity_for (amount);
+    sat_status_return_on_equals (capacity, 0, "too many elements to index");
+
+    sat_set_bucket_t *buckets = sat_allocator_allocate_zeroed (&object->allocator, (size_t) capacity * sizeof (sat_set_bucket_t));
+    sat_status_return_on_null (buckets, "index allocation failed");
+
+    sat_allocator_release (&object->allocator, object->hash.buckets, (size_t) object->hash.capacity * sizeof (sat_set_bucket_t));
+
+    object->hash.buckets = buckets;
+    object->hash.capacity = capacity;
+    object->hash.used = 0;
+    object->hash.deleted = 0;
+
+    for (uint32_t i = 0; i < amount; i++)
+    {
+        uint32_t hash = sat_hash_mix (object->hash.element (sat_array_get_reference_by (object->array, i)));
+
+        sat_set_index_reserve (object, hash)->position = i + 1;
+    }
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_set_index_find (const sat_set_t *const object, const void *const data, uint32_t hash, uint32_t *const index)
+{
+    uint32_t mask = object->hash.capacity - 1;
+
+    for (uint32_t probe = 0, i = hash & mask; probe < object->hash.capacity; probe++, i = (i + 1) & mask)
+    {
+        sat_set_bucket_t *bucket = &object->hash.buckets [i];
+
+        if (bucket->position == SAT_SET_INDEX_EMPTY)
+            break;
+
+        if (bucket->position == SAT_SET_INDEX_DELETED)
+            continue;
+
+        sat_status_continue_on_not_equals (bucket->hash, hash);
+        sat_status_continue_on_false (object->is_equal (sat_array_get_reference_by (object->array, bucket->position - 1), data));
+
+        *index = bucket->position - 1;
+
+        sat_status_return_on_success ();
+    }
+
+    sat_status_return_on_failure ("object not found");
+}
+
+static sat_status_t sat_set_index_ensure_room (sat_set_t *const object)
+{
+    if (((uint64_t) object->hash.used + object->hash.deleted + 1) * 4 > (uint64_t) object->hash.capacity * 3)
+    {
+        return sat_set_index_rebuild (object);
+    }
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_set_hashed_add (sat_set_t *const object, const void *const data)
+{
+    uint32_t index;
+    uint32_t amount = 0;
+    uint32_t hash = sat_hash_mix (object->hash.element (data));
+
+    sat_status_t status = sat_set_index_find (object, data, hash, &index);
+    sat_status_return_on_equals (sat_status_get_result (&status), true, "object already exists");
+
+    sat_status_return_on_error (sat_set_index_ensure_room (object));
+
+    sat_array_get_size (object->array, &amount);
+    sat_status_return_on_error (sat_array_add (object->array, data));
+
+    sat_set_index_reserve (object, hash)->position = amount + 1;
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_set_hashed_update_by (sat_set_t *const object, const void *const data, const uint32_t index)
+{
+    uint32_t found;
+    void *current = sat_array_get_reference_by (object->array, index);
+    sat_status_return_on_null (current, "index out of bounds");
+
+    uint32_t hash = sat_hash_mix (object->hash.element (data));
+
+    sat_status_t status = sat_set_index_find (object, data, hash, &found);
+    if (sat_status_get_result (&status) == true && found != index)
+    {
+        sat_status_return_on_failure ("object already exists");
+    }
+
+    // make room before touching the element, a rebuild reads the array contents
+    sat_status_return_on_error (sat_set_index_ensure_room (object));
+
+    sat_set_bucket_t *bucket = sat_set_index_find_position (object, sat_hash_mix (object->hash.element (current)), index);
+    sat_status_return_on_null (bucket, "index is corrupted");
+
+    sat_status_return_on_error (sat_array_update_by (object->array, data, index));
+
+    bucket->position = SAT_SET_INDEX_DELETED;
+    object->hash.used --;
+    object->hash.deleted ++;
+
+    sat_set_index_reserve (object, hash)->position = index + 1;
+
+    sat_status_return_on_success ();
+}
+
+static sat_status_t sat_set_hashed_remove_by (sat_set_t *const object, const uint32_t index)
+{
+    uint32_t amount = 0;
+    void *current = sat_array_get_reference_by (object->array, index);
+    sat_status_return_on_null (current, "index out of bounds");
+
+    sat_array_get_size (object->array, &amount);
+
+    sat_set_bucket_t *bucket = sat_set_index_find_position (object, sat_hash_mix (object->hash.element (current)), index);
+    sat_status_return_on_null (bucket, "index is corrupted");
+
+    bucket->position = SAT_SET_INDEX_DELETED;
+    object->hash.used --;
+    object->hash.deleted ++;
+
+    uint32_t last = amount - 1;
+
+    if (index != last)
+    {
+        // fill the hole with the last element so nothing has to be shifted
+        void *moved = sat_array_get_reference_by (object->array, last);
+
+        bucket = sat_set_index_find_position (object, sat_hash_mix (object->hash.element (moved)), last);
+        sat_status_return_on_null (bucket, "index is corrupted");
+
+        sat_status_return_on_error (sat_array_update_by (object->array, moved, index));
+        bucket->position = index + 1;
+    }
+
+    return sat_array_remove_by (object->array, last);
+}
+
+static sat_status_t sat_set_hashed_find_by_parameter (const sat_set_t *const object, const void *const param, sat_set_compare_t compare, uint32_t *const index)
+{
+    sat_status_return_on_null (param, "parameter pointer is NULL");
+    sat_status_return_on_null (compare, "compare function pointer is NULL");
+
+    if (object->hash.param == NULL)
+    {
+        uint32_t amount = 0;
+
+        sat_array_get_size (object->array, &amount);
+
+        for (uint32_t i = 0; i < amount; i++)
+        {
+            sat_status_continue_on_false (compare (sat_array_get_reference_by (object->array, i), param));
+
+            *index = i;
+
+            sat_status_return_on_success ();
+        }
+
+        sat_status_return_on_failure ("object not found");
+    }
+
+    uint32_t hash = sat_hash_mix (object->hash.param (param));
+    uint32_t mask = object->hash.capacity - 1;
+
+    for (uint32_t probe = 0, i = hash & mask; probe < object->hash.capacity; probe++, i = (i + 1) & mask)
+    {
+        sat_set_bucket_t *bucket = &object->hash.buckets [i];
+
+        if (bucket->position == SAT_SET_INDEX_EMPTY)
+            break;
+
+        if (bucket->position == SAT_SET_INDEX_DELETED)
+            continue;
+
+        sat_status_continue_on_not_equals (bucket->hash, hash);
+        sat_status_continue_on_false (compare (sat_array_get_reference_by (object->array, bucket->position - 1), param));
+
+        *index = bucket->position - 1;
+
+        sat_status_return_on_success ();
+    }
+
+    sat_status_return_on_failure ("object not found");
+}
@@ -313,6 +313,120 @@ static void test_dynamic_mode (void)
     sat_set_destroy (set);
 }
 
+// Hash of the identity field used by is_equal
+static uint32_t hash_person (const void *const data)
+{
+    const person_t *person = (const person_t *)data;
+
+    return (uint32_t) person->id;
+}
+
+// Hash of a search parameter, consistent with hash_person
+static uint32_t hash_id (const void *const data)
+{
+    return (uint32_t) *(const int *)data;
+}
+
+// Test: hashed mode keeps uniqueness, O(1) lookups and dense iteration
+static void test_hashed_mode (void)
+{
+    sat_set_t *set = NULL;
+    sat_status_t status = sat_set_create (&set, &(sat_set_args_t)
+    {
+        .size        = 4,
+        .object_size = sizeof (person_t),
+        .is_equal    = is_equal,
+        .mode        = sat_set_mode_dynamic,
+        .hash =
+        {
+            .element = hash_person,
+            .param   = hash_id,
+        },
+    });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < 5000; i++)
+    {
+        person_t p = {.id = i, .age = i % 90};
+        snprintf (p.name, sizeof (p.name), "Person %d", i);
+
+        status = sat_set_add (set, &p);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    // duplicates are rejected
+    status = sat_set_add (set, &(person_t){.id = 42});
+    assert (sat_status_get_result (&status) == false);
+
+    uint32_t size = 0;
+    sat_set_get_size (set, &size);
+    assert (size == 5000);
+
+    person_t found;
+    status = sat_set_get_object_by_parameter (set, &(int){1234}, compare_by_id, &found);
+    assert (sat_status_get_result (&status) == true);
+    assert (found.id == 1234);
+    assert (strcmp (found.name, "Person 1234") == 0);
+
+    // remove every odd id, the last element fills each hole
+    for (int i = 1; i < 5000; i += 2)
+    {
+        person_t removed;
+
+        status = sat_set_remove_by_parameter (set, &i, compare_by_id, &removed);
+        assert (sat_status_get_result (&status) == true);
+        assert (removed.id == i);
+    }
+
+    sat_set_get_size (set, &size);
+    assert (size == 2500);
+
+    status = sat_set_get_object_by_parameter (set, &(int){1235}, compare_by_id, &found);
+    assert (sat_status_get_result (&status) == false);
+
+    // the index follows elements moved by removal
+    for (uint32_t i = 0; i < size; i++)
+    {
+        person_t *ref = NULL;
+
+        sat_set_get_object_by (set, i, &found);
+        assert (found.id % 2 == 0);
+
+        status = sat_set_get_object_ref_by_parameter (set, &found.id, compare_by_id, (void **)&ref);
+        assert (sat_status_get_result (&status) == true);
+        assert (ref->id == found.id);
+    }
+
+    // an update cannot duplicate another element
+    person_t first;
+    person_t second;
+
+    sat_set_get_object_by (set, 0, &first);
+    sat_set_get_object_by (set, 1, &second);
+
+    status = sat_set_update_by (set, &second, 0);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_set_get_object_by (set, 0, &found);
+    assert (found.id == first.id);
+
+    status = sat_set_update_by (set, &(person_t){.id = 9999}, 0);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_set_get_object_by_parameter (set, &(int){9999}, compare_by_id, &found);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_set_t *cloned = NULL;
+    status = sat_set_clone (set, &cloned);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_set_add (cloned, &(person_t){.id = 9999});
+    assert (sat_status_get_result (&status) == false);
+
+    sat_set_destroy (cloned);
+    sat_set_destroy (set);
+}
+
 int main (int argc, char *argv[])
 {
     test_create_destroy ();
@@ -325,6 +439,7 @@ int main (int argc, char *argv[])
     test_get_object_ref_by_parameter ();
     test_clone ();
     test_dynamic_mode ();
+    test_hashed_mode ();
 
     return 0;
 }
\ No newline at end of file
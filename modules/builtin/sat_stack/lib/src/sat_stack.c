@@ -1,5 +1,4 @@
 #include <sat_stack.h>
-#include <stdlib.h>
 #include <string.h>
 
 struct sat_stack_t
@@ -8,27 +7,39 @@ struct sat_stack_t
     uint32_t object_size;
     uint32_t amount;
     void *buffer;
+    sat_allocator_t allocator;
 };
 
 sat_status_t sat_stack_create (sat_stack_t **const object, uint32_t size, uint32_t object_size)
+{
+    return sat_stack_create_with_args (object, &(sat_stack_args_t)
+                                               {
+                                                   .size = size,
+                                                   .object_size = object_size,
+                                               });
+}
+
+sat_status_t sat_stack_create_with_args (sat_stack_t **const object, const sat_stack_args_t *const args)
 {
     sat_status_return_on_null (object, "null object pointer");
-    sat_status_return_on_equals (size, 0, "size is zero");
-    sat_status_return_on_equals (object_size, 0, "object size is zero");
+    sat_status_return_on_null (args, "null args pointer");
+    sat_status_return_on_equals (args->size, 0, "size is zero");
+    sat_status_return_on_equals (args->object_size, 0, "object size is zero");
 
-    *object = calloc (1, sizeof (struct sat_stack_t));
+    *object = sat_allocator_allocate_zeroed (&args->allocator, sizeof (struct sat_stack_t));
     sat_status_return_on_null (*object, "memory allocation failed");
 
-    (*object)->buffer = calloc (1, size * object_size);
+    (*object)->buffer = sat_allocator_allocate_zeroed (&args->allocator, (size_t) args->size * args->object_size);
     if ((*object)->buffer == NULL)
     {
-        free (*object);
+        sat_allocator_release (&args->allocator, *object, sizeof (struct sat_stack_t));
         *object = NULL;
         sat_status_return_on_failure ("buffer memory allocation failed");
     }
 
-    (*object)->size = size;
-    (*object)->object_size = object_size;
+    (*object)->size = args->size;
+    (*object)->object_size = args->object_size;
+    (*object)->allocator = args->allocator;
 
     sat_status_return_on_success ();
 }
@@ -73,8 +84,10 @@ sat_status_t sat_stack_destroy (sat_stack_t *const object)
     sat_status_return_on_null (object, "null object pointer");
     sat_status_return_on_null (object->buffer, "null buffer pointer");
 
-    free (object->buffer);
-    free (object);
+    sat_allocator_t allocator = object->allocator;
+
+    sat_allocator_release (&allocator, object->buffer, (size_t) object->size * object->object_size);
+    sat_allocator_release (&allocator, object, sizeof (struct sat_stack_t));
 
     sat_status_return_on_success ();
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef SAT_TCP_FRAMER_H_
+#define SAT_TCP_FRAMER_H_
+
+#include <sat_tcp_types.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    sat_tcp_framer_result_frame,        // a whole frame starts the data
+    sat_tcp_framer_result_partial,      // more bytes are needed
+    sat_tcp_framer_result_invalid,      // the peer broke the framing
+
+} sat_tcp_framer_result_t;
+
+typedef struct
+{
+    uint32_t offset;                    // where the payload starts
+    uint32_t size;                      // of the payload
+    uint32_t used;                      // bytes of the whole frame; when partial, those needed if known, else 0
+} sat_tcp_frame_t;
+
+bool sat_tcp_framer_is_valid (const sat_tcp_framer_t *framer);
+uint32_t sat_tcp_framer_get_limit (const sat_tcp_framer_t *framer);
+sat_tcp_framer_result_t sat_tcp_framer_next (const sat_tcp_framer_t *framer, const char *data, uint32_t size, uint32_t *scanned, sat_tcp_frame_t *frame);
+
+#endif/* SAT_TCP_FRAMER_H_ */
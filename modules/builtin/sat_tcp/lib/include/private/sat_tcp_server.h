@@ -3,9 +3,14 @@
 
 #include <sat_tcp_types.h>
 #include <sat_status.h>
+#include <sat_reactor.h>
 
 sat_status_t sat_tcp_server_open (sat_tcp_server_t **object, sat_tcp_server_args_t *args);
 sat_status_t sat_tcp_server_run (sat_tcp_server_t *object);
 int sat_tcp_server_get_socket (sat_tcp_server_t *object);
+uint32_t sat_tcp_server_get_connections (sat_tcp_server_t *object);
+sat_status_t sat_tcp_server_attach (sat_tcp_server_t *object, sat_reactor_t *reactor);
+sat_status_t sat_tcp_server_detach (sat_tcp_server_t *object);
+void sat_tcp_server_destroy (sat_tcp_server_t *object);
 
 #endif/* SAT_TCP_SERVER_H_ */
@@ -9,6 +9,7 @@
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <stdbool.h>
 
 
 typedef struct 
@@ -21,6 +22,10 @@ typedef struct
     {
         sat_tcp_event_t on_receive;
         sat_tcp_event_t on_send;
+        sat_tcp_connection_event_t on_open;
+        sat_tcp_connection_receive_t on_data;
+        sat_tcp_connection_event_t on_close;
+        sat_tcp_connection_frame_t on_frame;
     } events;
 
     void *data;
@@ -29,10 +34,18 @@ typedef struct
 
     sat_tcp_server_type_t type;
 
+    uint32_t backlog;
+    uint32_t idle_timeout;
+
+    bool reuse_port;                // one of several listeners bound to the same port
+
+    sat_tcp_framer_t framer;
+
 } sat_tcp_server_abstract_t;
 
 void sat_tcp_server_abstract_copy_to_context (sat_tcp_server_abstract_t *object, sat_tcp_server_args_t *args);
 sat_status_t sat_tcp_server_abstract_is_args_valid (sat_tcp_server_args_t *args);
 sat_status_t sat_tcp_server_abstract_configure (sat_tcp_server_abstract_t *object, struct addrinfo *info_list);
+struct addrinfo *sat_tcp_server_abstract_get_info_list (const char *service);
 
 #endif/* SAT_TCP_SERVER_ABSTRACT_H_ */
@@ -0,0 +1,19 @@
+#ifndef SAT_TCP_SERVER_ASYNC_H_
+#define SAT_TCP_SERVER_ASYNC_H_
+
+#include <sat_tcp_server_abstract.h>
+#include <sat_reactor.h>
+
+#define SAT_TCP_SERVER_ASYNC_BURST          16      // reads or accepts per wakeup before yielding to other sockets
+#define SAT_TCP_SERVER_ASYNC_RUN_TIMEOUT    100     // milliseconds sat_tcp_run waits for events
+
+typedef struct sat_tcp_server_async_t sat_tcp_server_async_t;
+
+sat_status_t sat_tcp_server_async_open (sat_tcp_server_async_t **object, sat_tcp_server_abstract_t *abstract);
+sat_status_t sat_tcp_server_async_run (sat_tcp_server_async_t *object);
+sat_status_t sat_tcp_server_async_attach (sat_tcp_server_async_t *object, sat_reactor_t *reactor);
+sat_status_t sat_tcp_server_async_detach (sat_tcp_server_async_t *object);
+uint32_t sat_tcp_server_async_get_connections (sat_tcp_server_async_t *object);
+void sat_tcp_server_async_destroy (sat_tcp_server_async_t *object);
+
+#endif/* SAT_TCP_SERVER_ASYNC_H_ */
@@ -0,0 +1,13 @@
+#ifndef SAT_TCP_SERVER_LISTENERS_H_
+#define SAT_TCP_SERVER_LISTENERS_H_
+
+#include <sat_tcp_server_abstract.h>
+
+typedef struct sat_tcp_server_listeners_t sat_tcp_server_listeners_t;
+
+sat_status_t sat_tcp_server_listeners_open (sat_tcp_server_listeners_t **object, sat_tcp_server_args_t *args);
+int sat_tcp_server_listeners_get_socket (sat_tcp_server_listeners_t *object);
+uint32_t sat_tcp_server_listeners_get_connections (sat_tcp_server_listeners_t *object);
+void sat_tcp_server_listeners_destroy (sat_tcp_server_listeners_t *object);
+
+#endif/* SAT_TCP_SERVER_LISTENERS_H_ */
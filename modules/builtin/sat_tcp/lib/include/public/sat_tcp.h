@@ -3,6 +3,7 @@
 
 #include <sat_status.h>
 #include <stdint.h>
+#include <sat_reactor.h>
 #include <sat_tcp_types.h>
 
 typedef struct 
@@ -27,6 +28,15 @@ sat_status_t sat_tcp_open (sat_tcp_t *object, sat_tcp_args_t *args);
 sat_status_t sat_tcp_run (sat_tcp_t *object);
 sat_status_t sat_tcp_send (sat_tcp_t *object, const char *data, uint32_t size);
 sat_status_t sat_tcp_receive (sat_tcp_t *object, char *data, uint32_t *size);
+sat_status_t sat_tcp_attach (sat_tcp_t *object, sat_reactor_t *reactor);
+sat_status_t sat_tcp_get_connections (sat_tcp_t *object, uint32_t *amount);
 sat_status_t sat_tcp_close (sat_tcp_t *object);
 
+// Connections of the async server type, valid from on_open until on_close returns.
+sat_status_t sat_tcp_connection_send (sat_tcp_connection_t *connection, const char *data, uint32_t size);
+sat_status_t sat_tcp_connection_close (sat_tcp_connection_t *connection);
+int sat_tcp_connection_get_socket (sat_tcp_connection_t *connection);
+void sat_tcp_connection_set_user (sat_tcp_connection_t *connection, void *user);
+void *sat_tcp_connection_get_user (sat_tcp_connection_t *connection);
+
 #endif/* SAT_TCP_H_ */
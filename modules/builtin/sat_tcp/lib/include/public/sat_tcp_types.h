@@ -2,11 +2,26 @@
 #define SAT_TCP_TYPES_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #define SAT_TCP_HOSTNAME_SIZE       1024
+#define SAT_TCP_FRAMER_MAX_SIZE     (1024 * 1024)       // largest payload a framer accepts unless told otherwise
+
+typedef struct sat_tcp_connection_t sat_tcp_connection_t;
 
 typedef void (*sat_tcp_event_t) (char *buffer, uint32_t *size, void *data);
 
+// Connection-level events of the async server type.
+typedef void (*sat_tcp_connection_event_t) (sat_tcp_connection_t *connection, void *data);
+
+// Returns how many bytes were used; the rest stays in the connection's
+// input buffer and is given again, followed by the next bytes received.
+typedef uint32_t (*sat_tcp_connection_receive_t) (sat_tcp_connection_t *connection, const char *buffer, uint32_t size, void *data);
+
+// A complete frame without its length prefix or delimiter, pointing into the
+// connection's input buffer; valid until the callback returns.
+typedef void (*sat_tcp_connection_frame_t) (sat_tcp_connection_t *connection, const char *frame, uint32_t size, void *data);
+
 typedef enum 
 {
     sat_tcp_type_server,
@@ -16,9 +31,51 @@ typedef enum
 typedef enum 
 {
     sat_tcp_server_type_interactive,
+    sat_tcp_server_type_async,
 
 } sat_tcp_server_type_t;
 
+typedef enum
+{
+    sat_tcp_framer_type_none,           // on_data is given the bytes as they arrive
+    sat_tcp_framer_type_length,         // each frame starts with the length of its payload
+    sat_tcp_framer_type_delimiter,      // each frame ends with a delimiter
+    sat_tcp_framer_type_fixed,          // every frame has the same size
+
+} sat_tcp_framer_type_t;
+
+typedef enum
+{
+    sat_tcp_framer_endian_big,          // network order
+    sat_tcp_framer_endian_little,
+
+} sat_tcp_framer_endian_t;
+
+typedef struct
+{
+    sat_tcp_framer_type_t type;
+    uint32_t max_size;                  // largest payload, 0 for SAT_TCP_FRAMER_MAX_SIZE; a larger one closes the connection
+
+    struct
+    {
+        uint8_t width;                  // bytes of the prefix: 1, 2, 4 or 8
+        sat_tcp_framer_endian_t endian;
+        bool inclusive;                 // the length counts the prefix too
+    } length;
+
+    struct
+    {
+        const char *bytes;
+        uint32_t size;                  // 0 for strlen (bytes)
+    } delimiter;
+
+    struct
+    {
+        uint32_t size;
+    } fixed;
+
+} sat_tcp_framer_t;
+
 typedef struct sat_tcp_server_t sat_tcp_server_t;
 typedef struct sat_tcp_client_t sat_tcp_client_t;
 
@@ -32,12 +89,25 @@ typedef struct
     {
         sat_tcp_event_t on_receive;
         sat_tcp_event_t on_send;
+
+        sat_tcp_connection_event_t on_open;         // async: a client connected
+        sat_tcp_connection_receive_t on_data;       // async: replaces on_receive and on_send
+        sat_tcp_connection_event_t on_close;        // async: the connection is about to be closed
+        sat_tcp_connection_frame_t on_frame;        // async: a complete frame, replaces on_data with a framer
     } events;
 
     void *data;
 
     sat_tcp_server_type_t type;
 
+    uint32_t backlog;               // pending connections, 0 for SOMAXCONN
+    uint32_t idle_timeout;          // async: milliseconds without traffic before a connection is closed, 0 never
+
+    uint16_t listeners;             // async: SO_REUSEPORT sockets on the port, each served by a pinned thread, 0 or 1 for one
+    bool steer_by_cpu;              // listeners: a connection goes to the listener of the CPU that received it
+
+    sat_tcp_framer_t framer;        // async: splits the input into frames for on_frame
+
 } sat_tcp_server_args_t;
 
 typedef struct 
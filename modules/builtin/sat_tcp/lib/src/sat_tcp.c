@@ -92,6 +92,33 @@ sat_status_t sat_tcp_receive (sat_tcp_t *object, char *data, uint32_t *size)
     return status;
 }
 
+sat_status_t sat_tcp_attach (sat_tcp_t *object, sat_reactor_t *reactor)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp attach error");
+
+    // Accepts and serves any number of clients on the reactor instead of sat_tcp_run.
+    if (object != NULL && reactor != NULL && object->type == sat_tcp_type_server)
+    {
+        status = sat_tcp_server_attach (object->server, reactor);
+    }
+
+    return status;
+}
+
+sat_status_t sat_tcp_get_connections (sat_tcp_t *object, uint32_t *amount)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp get connections error");
+
+    if (object != NULL && amount != NULL && object->type == sat_tcp_type_server)
+    {
+        *amount = sat_tcp_server_get_connections (object->server);
+
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    return status;
+}
+
 sat_status_t sat_tcp_close (sat_tcp_t *object)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp close error");
@@ -100,6 +127,9 @@ sat_status_t sat_tcp_close (sat_tcp_t *object)
     {
         int socket = sat_tcp_get_socket (object);
 
+        if (object->type == sat_tcp_type_server)
+            sat_tcp_server_detach (object->server);
+
         shutdown (socket, SHUT_RDWR);
 
         sat_tcp_type_destroy (object);
@@ -141,7 +171,7 @@ static int sat_tcp_get_socket (sat_tcp_t *object)
 static void sat_tcp_type_destroy (sat_tcp_t *object)
 {
     if (object->type == sat_tcp_type_server)
-        free (object->server);
+        sat_tcp_server_destroy (object->server);
     else 
         free (object->client);
 }
\ No newline at end of file
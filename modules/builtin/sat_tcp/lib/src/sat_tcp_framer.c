@@ -0,0 +1,161 @@
+#include <sat_tcp_framer.h>
+#include <string.h>
+
+static uint32_t sat_tcp_framer_get_max_size (const sat_tcp_framer_t *framer);
+static uint32_t sat_tcp_framer_get_delimiter_size (const sat_tcp_framer_t *framer);
+static uint64_t sat_tcp_framer_read_length (const sat_tcp_framer_t *framer, const unsigned char *data);
+static sat_tcp_framer_result_t sat_tcp_framer_next_length (const sat_tcp_framer_t *framer, const char *data, uint32_t size, sat_tcp_frame_t *frame);
+static sat_tcp_framer_result_t sat_tcp_framer_next_delimiter (const sat_tcp_framer_t *framer, const char *data, uint32_t size, uint32_t *scanned, sat_tcp_frame_t *frame);
+static sat_tcp_framer_result_t sat_tcp_framer_next_fixed (const sat_tcp_framer_t *framer, uint32_t size, sat_tcp_frame_t *frame);
+
+bool sat_tcp_framer_is_valid (const sat_tcp_framer_t *framer)
+{
+    bool valid = false;
+    uint8_t width = framer->length.width;
+
+    if (framer->type == sat_tcp_framer_type_none)
+        valid = true;
+
+    else if (framer->type == sat_tcp_framer_type_length)
+        valid = (width == 1 || width == 2 || width == 4 || width == 8) &&
+                (framer->length.endian == sat_tcp_framer_endian_big || framer->length.endian == sat_tcp_framer_endian_little);
+
+    else if (framer->type == sat_tcp_framer_type_delimiter)
+        valid = framer->delimiter.bytes != NULL && sat_tcp_framer_get_delimiter_size (framer) > 0;
+
+    else if (framer->type == sat_tcp_framer_type_fixed)
+        valid = framer->fixed.size > 0 && framer->fixed.size <= sat_tcp_framer_get_max_size (framer);
+
+    // The whole frame, prefix or delimiter included, must fit an input buffer.
+    if (framer->type != sat_tcp_framer_type_none && sat_tcp_framer_get_limit (framer) == 0)
+        valid = false;
+
+    return valid;
+}
+
+uint32_t sat_tcp_framer_get_limit (const sat_tcp_framer_t *framer)
+{
+    uint64_t limit = 0;
+
+    if (framer->type == sat_tcp_framer_type_length)
+        limit = (uint64_t) framer->length.width + sat_tcp_framer_get_max_size (framer);
+
+    else if (framer->type == sat_tcp_framer_type_delimiter)
+        limit = (uint64_t) sat_tcp_framer_get_delimiter_size (framer) + sat_tcp_framer_get_max_size (framer);
+
+    else if (framer->type == sat_tcp_framer_type_fixed)
+        limit = framer->fixed.size;
+
+    return limit <= UINT32_MAX ? (uint32_t) limit : 0;
+}
+
+sat_tcp_framer_result_t sat_tcp_framer_next (const sat_tcp_framer_t *framer, const char *data, uint32_t size, uint32_t *scanned, sat_tcp_frame_t *frame)
+{
+    sat_tcp_framer_result_t result = sat_tcp_framer_result_invalid;
+
+    *frame = (sat_tcp_frame_t) {0};
+
+    if (framer->type == sat_tcp_framer_type_length)
+        result = sat_tcp_framer_next_length (framer, data, size, frame);
+
+    else if (framer->type == sat_tcp_framer_type_delimiter)
+        result = sat_tcp_framer_next_delimiter (framer, data, size, scanned, frame);
+
+    else if (framer->type == sat_tcp_framer_type_fixed)
+        result = sat_tcp_framer_next_fixed (framer, size, frame);
+
+    return result;
+}
+
+static uint32_t sat_tcp_framer_get_max_size (const sat_tcp_framer_t *framer)
+{
+    return framer->max_size > 0 ? framer->max_size : SAT_TCP_FRAMER_MAX_SIZE;
+}
+
+static uint32_t sat_tcp_framer_get_delimiter_size (const sat_tcp_framer_t *framer)
+{
+    uint32_t size = framer->delimiter.size;
+
+    if (size == 0 && framer->delimiter.bytes != NULL)
+        size = (uint32_t) strlen (framer->delimiter.bytes);
+
+    return size;
+}
+
+static uint64_t sat_tcp_framer_read_length (const sat_tcp_framer_t *framer, const unsigned char *data)
+{
+    uint64_t length = 0;
+    uint8_t width = framer->length.width;
+
+    // Most significant byte first, wherever it is.
+    for (uint8_t i = 0; i < width; i++)
+        length = (length << 8) | data [framer->length.endian == sat_tcp_framer_endian_big ? i : width - 1 - i];
+
+    return length;
+}
+
+static sat_tcp_framer_result_t sat_tcp_framer_next_length (const sat_tcp_framer_t *framer, const char *data, uint32_t size, sat_tcp_frame_t *frame)
+{
+    uint8_t width = framer->length.width;
+
+    frame->used = width;
+
+    if (size < width)
+        return sat_tcp_framer_result_partial;
+
+    uint64_t length = sat_tcp_framer_read_length (framer, (const unsigned char *) data);
+
+    if (framer->length.inclusive == true)
+    {
+        if (length < width)
+            return sat_tcp_framer_result_invalid;
+
+        length -= width;
+    }
+
+    if (length > sat_tcp_framer_get_max_size (framer))
+        return sat_tcp_framer_result_invalid;
+
+    // Known from the prefix, so the input buffer can grow once to fit it.
+    frame->offset = width;
+    frame->size = (uint32_t) length;
+    frame->used = width + (uint32_t) length;
+
+    return size < frame->used ? sat_tcp_framer_result_partial : sat_tcp_framer_result_frame;
+}
+
+static sat_tcp_framer_result_t sat_tcp_framer_next_delimiter (const sat_tcp_framer_t *framer, const char *data, uint32_t size, uint32_t *scanned, sat_tcp_frame_t *frame)
+{
+    uint32_t delimiter_size = sat_tcp_framer_get_delimiter_size (framer);
+    uint32_t max_size = sat_tcp_framer_get_max_size (framer);
+
+    // Bytes searched on earlier reads are not searched again, except for the
+    // tail that may hold the start of a delimiter.
+    uint32_t start = *scanned >= delimiter_size ? *scanned - (delimiter_size - 1) : 0;
+    const char *found = NULL;
+
+    if (start < size)
+        found = (const char *) memmem (data + start, size - start, framer->delimiter.bytes, delimiter_size);
+
+    if (found == NULL)
+    {
+        *scanned = size;
+
+        return (uint64_t) size >= (uint64_t) max_size + delimiter_size ? sat_tcp_framer_result_invalid : sat_tcp_framer_result_partial;
+    }
+
+    *scanned = 0;
+
+    frame->size = (uint32_t) (found - data);
+    frame->used = frame->size + delimiter_size;
+
+    return frame->size > max_size ? sat_tcp_framer_result_invalid : sat_tcp_framer_result_frame;
+}
+
+static sat_tcp_framer_result_t sat_tcp_framer_next_fixed (const sat_tcp_framer_t *framer, uint32_t size, sat_tcp_frame_t *frame)
+{
+    frame->size = framer->fixed.size;
+    frame->used = framer->fixed.size;
+
+    return size < frame->used ? sat_tcp_framer_result_partial : sat_tcp_framer_result_frame;
+}
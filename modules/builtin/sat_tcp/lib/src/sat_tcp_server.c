@@ -1,20 +1,36 @@
 #include <sat_tcp_server.h>
 #include <sat_tcp_server_abstract.h>
+#include <sat_tcp_server_async.h>
+#include <sat_tcp_server_listeners.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <math.h>
 
+#define SAT_TCP_SERVER_CLIENTS_MIN      16
+
 struct sat_tcp_server_t
 {
     sat_tcp_server_abstract_t abstract;
+    sat_tcp_server_async_t *async;  // connections of the async type
+    sat_tcp_server_listeners_t *listeners;  // async type on several threads, each with its own socket
+    sat_reactor_t *reactor;
+    int *clients;               // connections accepted on the reactor
+    uint32_t clients_amount;
+    uint32_t clients_capacity;
 };
 
-static struct addrinfo *sat_tcp_server_get_info_list (sat_tcp_server_args_t *args);
+static void sat_tcp_server_on_accept (int fd, uint32_t events, void *data);
+static void sat_tcp_server_on_client (int fd, uint32_t events, void *data);
+static bool sat_tcp_server_track (sat_tcp_server_t *object, int client);
+static void sat_tcp_server_drop (sat_tcp_server_t *object, int client);
 
 sat_status_t sat_tcp_server_open (sat_tcp_server_t **object, sat_tcp_server_args_t *args)
 {
@@ -33,7 +49,23 @@ sat_status_t sat_tcp_server_open (sat_tcp_server_t **object, sat_tcp_server_args
 
         sat_tcp_server_abstract_copy_to_context (&__object->abstract, args);
 
-        struct addrinfo *info_list = sat_tcp_server_get_info_list (args);
+        // The listeners bind sockets of their own and serve them from their threads.
+        if (args->listeners > 1)
+        {
+            __object->abstract.socket = -1;
+
+            status = sat_tcp_server_listeners_open (&__object->listeners, args);
+            if (sat_status_get_result (&status) == false)
+            {
+                free (__object);
+                break;
+            }
+
+            *object = __object;
+            break;
+        }
+
+        struct addrinfo *info_list = sat_tcp_server_abstract_get_info_list (args->service);
 
         if (info_list == NULL)
         {
@@ -51,6 +83,17 @@ sat_status_t sat_tcp_server_open (sat_tcp_server_t **object, sat_tcp_server_args
 
         freeaddrinfo (info_list);
 
+        if (__object->abstract.type == sat_tcp_server_type_async)
+        {
+            status = sat_tcp_server_async_open (&__object->async, &__object->abstract);
+            if (sat_status_get_result (&status) == false)
+            {
+                close (__object->abstract.socket);
+                free (__object);
+                break;
+            }
+        }
+
         *object = __object;
 
     } while (false);
@@ -65,7 +108,18 @@ sat_status_t sat_tcp_server_run (sat_tcp_server_t *object)
     struct sockaddr_in address_in;
     socklen_t length = sizeof (address_in);
 
-    if (object->abstract.socket >= 0)
+    // The listener threads do the work; waiting here keeps the caller's loop from spinning.
+    if (object->listeners != NULL)
+    {
+        usleep (SAT_TCP_SERVER_ASYNC_RUN_TIMEOUT * 1000);
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    // One turn of the event loop, serving every connection that is ready.
+    else if (object->async != NULL)
+        status = sat_tcp_server_async_run (object->async);
+
+    else if (object->abstract.socket >= 0)
     {
         int client_accept = accept (object->abstract.socket, (struct sockaddr *)&address_in, &length);
 
@@ -77,21 +131,197 @@ sat_status_t sat_tcp_server_run (sat_tcp_server_t *object)
 
 int sat_tcp_server_get_socket (sat_tcp_server_t *object)
 {
-    return object->abstract.socket;
+    return object->listeners != NULL ? sat_tcp_server_listeners_get_socket (object->listeners) : object->abstract.socket;
 }
 
-static struct addrinfo *sat_tcp_server_get_info_list (sat_tcp_server_args_t *args)
+uint32_t sat_tcp_server_get_connections (sat_tcp_server_t *object)
 {
-    struct addrinfo hints;
-    struct addrinfo *info_list = NULL;
+    uint32_t amount = object->clients_amount;
 
-    memset(&hints, 0, sizeof (hints));
+    if (object->listeners != NULL)
+        amount = sat_tcp_server_listeners_get_connections (object->listeners);
 
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-    hints.ai_flags = AI_PASSIVE;
+    else if (object->async != NULL)
+        amount = sat_tcp_server_async_get_connections (object->async);
 
-    getaddrinfo (NULL, args->service, &hints, &info_list);
+    return amount;
+}
+
+sat_status_t sat_tcp_server_attach (sat_tcp_server_t *object, sat_reactor_t *reactor)
+{
+    sat_status_t status;
+
+    do
+    {
+        if (object->listeners != NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server attach error: served by its listeners");
+            break;
+        }
+
+        if (object->async != NULL)
+        {
+            status = sat_tcp_server_async_attach (object->async, reactor);
+            break;
+        }
 
-    return info_list;
+        if (object->reactor != NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server attach error: already attached");
+            break;
+        }
+
+        // Accepting must not block the loop when a client gives up in between.
+        int flags = fcntl (object->abstract.socket, F_GETFL);
+
+        if (flags < 0 || fcntl (object->abstract.socket, F_SETFL, flags | O_NONBLOCK) < 0)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server attach error: non blocking failed");
+            break;
+        }
+
+        status = sat_reactor_add (reactor, object->abstract.socket, sat_reactor_event_read, sat_tcp_server_on_accept, object);
+        sat_status_break_on_error (status);
+
+        object->reactor = reactor;
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_tcp_server_detach (sat_tcp_server_t *object)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server detach error: not attached");
+
+    if (object->async != NULL)
+        status = sat_tcp_server_async_detach (object->async);
+
+    else if (object->reactor != NULL)
+    {
+        while (object->clients_amount > 0)
+            sat_tcp_server_drop (object, object->clients [object->clients_amount - 1]);
+
+        free (object->clients);
+        object->clients = NULL;
+        object->clients_capacity = 0;
+
+        status = sat_reactor_remove (object->reactor, object->abstract.socket);
+        object->reactor = NULL;
+    }
+
+    return status;
 }
+
+void sat_tcp_server_destroy (sat_tcp_server_t *object)
+{
+    if (object->listeners != NULL)
+        sat_tcp_server_listeners_destroy (object->listeners);
+
+    else if (object->async != NULL)
+        sat_tcp_server_async_destroy (object->async);
+
+    else if (object->reactor != NULL)
+        sat_tcp_server_detach (object);
+
+    if (object->abstract.socket >= 0)
+        close (object->abstract.socket);
+
+    free (object);
+}
+
+static void sat_tcp_server_on_accept (int fd, uint32_t events, void *data)
+{
+    sat_tcp_server_t *object = (sat_tcp_server_t *) data;
+
+    (void) events;
+
+    while (true)
+    {
+        int client = accept4 (fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (client < 0)
+            break;
+
+        if (sat_tcp_server_track (object, client) == false)
+        {
+            close (client);
+            continue;
+        }
+
+        sat_status_t status = sat_reactor_add (object->reactor, client, sat_reactor_event_read, sat_tcp_server_on_client, object);
+
+        if (sat_status_get_result (&status) == false)
+        {
+            object->clients_amount --;
+            close (client);
+        }
+    }
+}
+
+static void sat_tcp_server_on_client (int fd, uint32_t events, void *data)
+{
+    sat_tcp_server_t *object = (sat_tcp_server_t *) data;
+    sat_tcp_server_abstract_t *abstract = &object->abstract;
+
+    (void) events;
+
+    // One read per wakeup keeps a busy client from starving the others.
+    ssize_t received = recv (fd, abstract->buffer, abstract->size, 0);
+
+    // Terminated rather than cleared, for callbacks that expect a string.
+    if (received >= 0 && (uint32_t) received < abstract->size)
+        abstract->buffer [received] = 0;
+
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR))
+    {
+        sat_tcp_server_drop (object, fd);
+    }
+
+    else if (received > 0 && abstract->events.on_receive != NULL)
+    {
+        uint32_t size = (uint32_t) received;
+
+        abstract->events.on_receive (abstract->buffer, &size, abstract->data);
+
+        if (abstract->events.on_send != NULL)
+        {
+            abstract->events.on_send (abstract->buffer, &size, abstract->data);
+            send (fd, abstract->buffer, (int)fmin (size, abstract->size), MSG_NOSIGNAL);
+        }
+    }
+}
+
+static bool sat_tcp_server_track (sat_tcp_server_t *object, int client)
+{
+    if (object->clients_amount == object->clients_capacity)
+    {
+        uint32_t capacity = object->clients_capacity == 0 ? SAT_TCP_SERVER_CLIENTS_MIN : object->clients_capacity * 2;
+        int *clients = (int *) realloc (object->clients, capacity * sizeof (int));
+
+        if (clients == NULL)
+            return false;
+
+        object->clients = clients;
+        object->clients_capacity = capacity;
+    }
+
+    object->clients [object->clients_amount ++] = client;
+
+    return true;
+}
+
+static void sat_tcp_server_drop (sat_tcp_server_t *object, int client)
+{
+    for (uint32_t i = 0; i < object->clients_amount; i++)
+    {
+        if (object->clients [i] == client)
+        {
+            object->clients [i] = object->clients [-- object->clients_amount];
+            break;
+        }
+    }
+
+    sat_reactor_remove (object->reactor, client);
+    close (client);
+}
\ No newline at end of file
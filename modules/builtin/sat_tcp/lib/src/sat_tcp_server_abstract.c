@@ -1,5 +1,6 @@
 #include <sat_tcp_server_abstract.h>
 #include <sat_tcp_server_interactive.h>
+#include <sat_tcp_framer.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,15 +24,34 @@ void sat_tcp_server_abstract_copy_to_context (sat_tcp_server_abstract_t *object,
     object->service = args->service;
     object->events.on_receive = args->events.on_receive;
     object->events.on_send = args->events.on_send;
+    object->events.on_open = args->events.on_open;
+    object->events.on_data = args->events.on_data;
+    object->events.on_close = args->events.on_close;
+    object->events.on_frame = args->events.on_frame;
     object->data = args->data;
     object->type = args->type;
+    object->backlog = args->backlog > 0 ? args->backlog : SOMAXCONN;
+    object->idle_timeout = args->idle_timeout;
+    object->framer = args->framer;
 }
 
 sat_status_t sat_tcp_server_abstract_is_args_valid (sat_tcp_server_args_t *args)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server args error");
 
-    if (args->buffer != NULL &&
+    bool async = args->type == sat_tcp_server_type_async;
+    bool framed = args->framer.type != sat_tcp_framer_type_none;
+
+    // Connections of the async type read into buffers of their own, so with
+    // on_data or on_frame the shared buffer is not needed.
+    bool has_buffer = args->buffer != NULL || (async == true && (args->events.on_data != NULL || framed == true));
+
+    // Frames go to on_frame only, and only the async type splits them.
+    bool has_framer = framed == (args->events.on_frame != NULL) &&
+                      (framed == false || (async == true && sat_tcp_framer_is_valid (&args->framer) == true));
+
+    if (has_buffer == true &&
+        has_framer == true &&
         args->size > 0 && 
         args->service != NULL)
     {
@@ -73,6 +93,22 @@ sat_status_t sat_tcp_server_abstract_configure (sat_tcp_server_abstract_t *objec
     return status;
 }
 
+struct addrinfo *sat_tcp_server_abstract_get_info_list (const char *service)
+{
+    struct addrinfo hints;
+    struct addrinfo *info_list = NULL;
+
+    memset(&hints, 0, sizeof (hints));
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    getaddrinfo (NULL, service, &hints, &info_list);
+
+    return info_list;
+}
+
 static sat_status_t sat_tcp_server_abstract_set_socket (sat_tcp_server_abstract_t *object, struct addrinfo *info)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server set socket error");
@@ -90,7 +126,9 @@ static sat_status_t sat_tcp_server_abstract_set_reuse_address (sat_tcp_server_ab
     sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server set reuse address error");
     int yes = 1;
 
-    if (setsockopt (object->socket, SOL_SOCKET, SO_REUSEADDR, (void *)&yes, sizeof (yes)) == 0)
+    // Every listener of a group sets SO_REUSEPORT before binding, or the port is taken.
+    if (setsockopt (object->socket, SOL_SOCKET, SO_REUSEADDR, (void *)&yes, sizeof (yes)) == 0 &&
+        (object->reuse_port == false || setsockopt (object->socket, SOL_SOCKET, SO_REUSEPORT, (void *)&yes, sizeof (yes)) == 0))
         sat_status_set (&status, true, __func__, "");
 
     return status;
@@ -110,7 +148,8 @@ static sat_status_t sat_tcp_server_abstract_listen (sat_tcp_server_abstract_t *o
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server listen error");
     
-    if (listen (object->socket, 1) >= 0)
+    // Room for the clients that connect while others are served.
+    if (listen (object->socket, (int) object->backlog) >= 0)
         sat_status_set (&status, true, __func__, "");
 
     return status;
@@ -128,5 +167,13 @@ static sat_status_t sat_tcp_server_abstract_select_type (sat_tcp_server_abstract
         sat_status_set (&status, true, __func__, "");
     }
 
+    // Served on a reactor only, by sat_tcp_server_async.
+    else if (object->type == sat_tcp_server_type_async)
+    {
+        object->base = (sat_tcp_server_base_t) {.handle_client = NULL};
+
+        sat_status_set (&status, true, __func__, "");
+    }
+
     return status;
 }
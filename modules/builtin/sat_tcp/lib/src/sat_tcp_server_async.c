@@ -0,0 +1,777 @@
+#include <sat_tcp_server_async.h>
+#include <sat_tcp_framer.h>
+#include <sat_tcp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#define SAT_TCP_SERVER_ASYNC_EVENTS     (sat_reactor_event_read | sat_reactor_event_edge)
+
+struct sat_tcp_connection_t
+{
+    sat_tcp_server_async_t *server;
+    int socket;
+    uint32_t events;                    // reactor events being watched
+    char *input;                        // abstract size bytes, allocated on the first read, grown for frames
+    uint32_t input_begin;               // bytes before it were used, and are reclaimed lazily
+    uint32_t input_size;                // end of the bytes received
+    uint32_t input_capacity;
+    uint32_t input_scanned;             // of the pending frame, searched for a delimiter already
+    uint32_t input_wanted;              // of the pending frame, needed as far as known
+    char *output;                       // bytes the socket could not take yet
+    uint32_t output_begin;
+    uint32_t output_end;
+    uint32_t output_capacity;
+    uint64_t active;                    // milliseconds, when traffic last went through
+    void *user;
+    bool busy;                          // inside a callback, dropping waits until it returns
+    bool closing;                       // dropped as soon as the output is flushed
+    bool broken;                        // the peer is gone, the output is discarded
+    sat_tcp_connection_t *previous;     // idle list, least recently active first
+    sat_tcp_connection_t *next;
+};
+
+struct sat_tcp_server_async_t
+{
+    sat_tcp_server_abstract_t *abstract;
+    sat_reactor_t local;                // reactor driven by sat_tcp_run
+    sat_reactor_t *reactor;
+    bool owned;
+    int timer;
+    int spare;                          // given up to refuse a client when out of descriptors
+    sat_tcp_connection_t *oldest;
+    sat_tcp_connection_t *newest;
+    uint32_t amount;                    // read from other threads when there are several listeners
+};
+
+static uint64_t sat_tcp_server_async_now (void);
+static void sat_tcp_server_async_on_accept (int fd, uint32_t events, void *data);
+static void sat_tcp_server_async_on_connection (int fd, uint32_t events, void *data);
+static void sat_tcp_server_async_on_timer (int fd, uint32_t events, void *data);
+static bool sat_tcp_server_async_refuse (sat_tcp_server_async_t *object, int fd);
+static void sat_tcp_server_async_adopt (sat_tcp_server_async_t *object, int client);
+static void sat_tcp_server_async_read (sat_tcp_connection_t *connection);
+static bool sat_tcp_server_async_reserve (sat_tcp_connection_t *connection);
+static bool sat_tcp_server_async_deliver (sat_tcp_connection_t *connection);
+static uint32_t sat_tcp_server_async_frames (sat_tcp_connection_t *connection, const char *data, uint32_t size);
+static bool sat_tcp_server_async_flush (sat_tcp_connection_t *connection);
+static bool sat_tcp_server_async_settle (sat_tcp_connection_t *connection);
+static bool sat_tcp_server_async_append (sat_tcp_connection_t *connection, const char *data, uint32_t size);
+static void sat_tcp_server_async_watch (sat_tcp_connection_t *connection, uint32_t events);
+static void sat_tcp_server_async_touch (sat_tcp_connection_t *connection);
+static void sat_tcp_server_async_unlink (sat_tcp_connection_t *connection);
+static void sat_tcp_server_async_drop (sat_tcp_connection_t *connection);
+
+sat_status_t sat_tcp_server_async_open (sat_tcp_server_async_t **object, sat_tcp_server_abstract_t *abstract)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server async open error");
+
+    sat_tcp_server_async_t *__object = calloc (1, sizeof (sat_tcp_server_async_t));
+
+    if (__object != NULL)
+    {
+        __object->abstract = abstract;
+        __object->timer = -1;
+        __object->spare = open ("/dev/null", O_RDONLY | O_CLOEXEC);
+
+        *object = __object;
+
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    return status;
+}
+
+sat_status_t sat_tcp_server_async_run (sat_tcp_server_async_t *object)
+{
+    sat_status_t status;
+
+    do
+    {
+        if (object->reactor == NULL)
+        {
+            sat_reactor_init (&object->local);
+
+            status = sat_reactor_open (&object->local, NULL);
+            sat_status_break_on_error (status);
+
+            status = sat_tcp_server_async_attach (object, &object->local);
+            if (sat_status_get_result (&status) == false)
+            {
+                sat_reactor_close (&object->local);
+                break;
+            }
+
+            object->owned = true;
+        }
+
+        else if (object->owned == false)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server async run error: attached to a reactor");
+            break;
+        }
+
+        status = sat_reactor_run_once (&object->local, SAT_TCP_SERVER_ASYNC_RUN_TIMEOUT);
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_tcp_server_async_attach (sat_tcp_server_async_t *object, sat_reactor_t *reactor)
+{
+    sat_status_t status;
+
+    do
+    {
+        if (object->reactor != NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server async attach error: already attached");
+            break;
+        }
+
+        int socket = object->abstract->socket;
+        int flags = fcntl (socket, F_GETFL);
+
+        if (flags < 0 || fcntl (socket, F_SETFL, flags | O_NONBLOCK) < 0)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server async attach error: non blocking failed");
+            break;
+        }
+
+        status = sat_reactor_add (reactor, socket, SAT_TCP_SERVER_ASYNC_EVENTS, sat_tcp_server_async_on_accept, object);
+        sat_status_break_on_error (status);
+
+        // Checking a quarter of the timeout closes idle connections at most 25% late.
+        if (object->abstract->idle_timeout > 0)
+        {
+            uint64_t period = object->abstract->idle_timeout / 4 > 0 ? object->abstract->idle_timeout / 4 : 1;
+
+            status = sat_reactor_add_timer (reactor, period, period, sat_tcp_server_async_on_timer, object, &object->timer);
+            if (sat_status_get_result (&status) == false)
+            {
+                sat_reactor_remove (reactor, socket);
+                break;
+            }
+        }
+
+        object->reactor = reactor;
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_tcp_server_async_detach (sat_tcp_server_async_t *object)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server async detach error: not attached");
+
+    if (object->reactor != NULL)
+    {
+        while (object->oldest != NULL)
+            sat_tcp_server_async_drop (object->oldest);
+
+        if (object->timer >= 0)
+        {
+            sat_reactor_remove (object->reactor, object->timer);
+            object->timer = -1;
+        }
+
+        status = sat_reactor_remove (object->reactor, object->abstract->socket);
+        object->reactor = NULL;
+
+        if (object->owned == true)
+        {
+            sat_reactor_close (&object->local);
+            object->owned = false;
+        }
+    }
+
+    return status;
+}
+
+uint32_t sat_tcp_server_async_get_connections (sat_tcp_server_async_t *object)
+{
+    return __atomic_load_n (&object->amount, __ATOMIC_RELAXED);
+}
+
+void sat_tcp_server_async_destroy (sat_tcp_server_async_t *object)
+{
+    if (object->reactor != NULL)
+        sat_tcp_server_async_detach (object);
+
+    if (object->spare >= 0)
+        close (object->spare);
+
+    free (object);
+}
+
+sat_status_t sat_tcp_connection_send (sat_tcp_connection_t *connection, const char *data, uint32_t size)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp connection send error");
+
+    if (connection != NULL && data != NULL && size > 0 && connection->closing == false)
+    {
+        uint32_t sent = 0;
+
+        // Straight to the socket unless earlier bytes are still waiting.
+        while (connection->output_begin == connection->output_end && sent < size)
+        {
+            ssize_t written = send (connection->socket, data + sent, size - sent, MSG_NOSIGNAL);
+
+            if (written > 0)
+                sent += (uint32_t) written;
+
+            else if (written < 0 && errno == EINTR)
+                continue;
+
+            else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+
+            else
+            {
+                // Left for the reactor to report, so that the caller's
+                // pointer stays valid until its callback returns.
+                connection->broken = true;
+                connection->closing = true;
+                sat_tcp_server_async_watch (connection, SAT_TCP_SERVER_ASYNC_EVENTS | sat_reactor_event_write);
+
+                return status;
+            }
+        }
+
+        if (sent > 0)
+            sat_tcp_server_async_touch (connection);
+
+        if (sent < size)
+        {
+            if (sat_tcp_server_async_append (connection, data + sent, size - sent) == false)
+            {
+                status = sat_status_set (&status, false, __func__, "sat tcp connection send error: out of memory");
+                return status;
+            }
+
+            sat_tcp_server_async_watch (connection, SAT_TCP_SERVER_ASYNC_EVENTS | sat_reactor_event_write);
+        }
+
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    return status;
+}
+
+sat_status_t sat_tcp_connection_close (sat_tcp_connection_t *connection)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp connection close error");
+
+    if (connection != NULL)
+    {
+        if (connection->closing == false)
+        {
+            connection->closing = true;
+
+            // Otherwise dropped when the callback returns or the output is flushed.
+            if (connection->busy == false && connection->output_begin == connection->output_end)
+                sat_tcp_server_async_drop (connection);
+        }
+
+        sat_status_set (&status, true, __func__, "");
+    }
+
+    return status;
+}
+
+int sat_tcp_connection_get_socket (sat_tcp_connection_t *connection)
+{
+    return connection != NULL ? connection->socket : -1;
+}
+
+void sat_tcp_connection_set_user (sat_tcp_connection_t *connection, void *user)
+{
+    if (connection != NULL)
+        connection->user = user;
+}
+
+void *sat_tcp_connection_get_user (sat_tcp_connection_t *connection)
+{
+    return connection != NULL ? connection->user : NULL;
+}
+
+static uint64_t sat_tcp_server_async_now (void)
+{
+    struct timespec now;
+
+    // A few milliseconds of resolution is plenty for idle timeouts, and the
+    // coarse clock is cheaper to read on every receive.
+    clock_gettime (CLOCK_MONOTONIC_COARSE, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
+
+static void sat_tcp_server_async_on_accept (int fd, uint32_t events, void *data)
+{
+    sat_tcp_server_async_t *object = (sat_tcp_server_async_t *) data;
+
+    (void) events;
+
+    for (uint32_t i = 0; i < SAT_TCP_SERVER_ASYNC_BURST; i++)
+    {
+        int client = accept4 (fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (client >= 0)
+            sat_tcp_server_async_adopt (object, client);
+
+        else if (errno == EINTR || errno == ECONNABORTED)
+            continue;
+
+        else if ((errno == EMFILE || errno == ENFILE) && sat_tcp_server_async_refuse (object, fd) == true)
+            continue;
+
+        else
+            return;
+    }
+
+    // More clients may be waiting; modifying the registration reports the
+    // edge again instead of leaving them until the next connection arrives.
+    sat_reactor_modify (object->reactor, fd, SAT_TCP_SERVER_ASYNC_EVENTS);
+}
+
+static void sat_tcp_server_async_on_connection (int fd, uint32_t events, void *data)
+{
+    sat_tcp_connection_t *connection = (sat_tcp_connection_t *) data;
+
+    (void) fd;
+
+    if ((events & sat_reactor_event_write) && sat_tcp_server_async_flush (connection) == false)
+        return;
+
+    // A hangup or an error shows up as an empty or failed read.
+    if (events & (sat_reactor_event_read | sat_reactor_event_error))
+        sat_tcp_server_async_read (connection);
+}
+
+static void sat_tcp_server_async_on_timer (int fd, uint32_t events, void *data)
+{
+    sat_tcp_server_async_t *object = (sat_tcp_server_async_t *) data;
+    uint64_t now = sat_tcp_server_async_now ();
+
+    (void) fd;
+    (void) events;
+
+    while (object->oldest != NULL && now - object->oldest->active >= object->abstract->idle_timeout)
+        sat_tcp_server_async_drop (object->oldest);
+}
+
+// Out of descriptors, a pending client would keep the listening socket ready
+// forever; the spare descriptor makes room to accept it and hang up.
+static bool sat_tcp_server_async_refuse (sat_tcp_server_async_t *object, int fd)
+{
+    if (object->spare < 0)
+        return false;
+
+    close (object->spare);
+
+    int client = accept (fd, NULL, NULL);
+
+    if (client >= 0)
+        close (client);
+
+    object->spare = open ("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    return client >= 0;
+}
+
+static void sat_tcp_server_async_adopt (sat_tcp_server_async_t *object, int client)
+{
+    sat_tcp_connection_t *connection = calloc (1, sizeof (sat_tcp_connection_t));
+
+    if (connection == NULL)
+    {
+        close (client);
+        return;
+    }
+
+    connection->server = object;
+    connection->socket = client;
+    connection->events = SAT_TCP_SERVER_ASYNC_EVENTS;
+
+    sat_status_t status = sat_reactor_add (object->reactor, client, connection->events, sat_tcp_server_async_on_connection, connection);
+
+    if (sat_status_get_result (&status) == false)
+    {
+        free (connection);
+        close (client);
+        return;
+    }
+
+    sat_tcp_server_async_touch (connection);
+    __atomic_add_fetch (&object->amount, 1, __ATOMIC_RELAXED);
+
+    if (object->abstract->events.on_open != NULL)
+    {
+        connection->busy = true;
+        object->abstract->events.on_open (connection, object->abstract->data);
+        connection->busy = false;
+
+        sat_tcp_server_async_settle (connection);
+    }
+}
+
+static void sat_tcp_server_async_read (sat_tcp_connection_t *connection)
+{
+    sat_tcp_server_abstract_t *abstract = connection->server->abstract;
+
+    if (connection->input == NULL)
+    {
+        connection->input = (char *) malloc (abstract->size);
+
+        if (connection->input == NULL)
+        {
+            sat_tcp_server_async_drop (connection);
+            return;
+        }
+
+        connection->input_capacity = abstract->size;
+    }
+
+    for (uint32_t i = 0; i < SAT_TCP_SERVER_ASYNC_BURST && connection->closing == false; i++)
+    {
+        // A full buffer the application does not consume can never make progress.
+        if (sat_tcp_server_async_reserve (connection) == false)
+        {
+            sat_tcp_server_async_drop (connection);
+            return;
+        }
+
+        ssize_t received = recv (connection->socket,
+                                 connection->input + connection->input_size,
+                                 connection->input_capacity - connection->input_size,
+                                 0);
+
+        if (received > 0)
+        {
+            connection->input_size += (uint32_t) received;
+            sat_tcp_server_async_touch (connection);
+
+            if (sat_tcp_server_async_deliver (connection) == false)
+                return;
+        }
+
+        else if (received < 0 && errno == EINTR)
+            continue;
+
+        else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+
+        else
+        {
+            sat_tcp_server_async_drop (connection);
+            return;
+        }
+    }
+
+    // Budget spent with data possibly left: ask for the edge again so that
+    // the other connections get their turn first.
+    if (connection->closing == false)
+        sat_reactor_modify (connection->server->reactor, connection->socket, connection->events);
+}
+
+// Room at the end of the input for the next read. Used bytes at the front
+// are reclaimed once they outweigh the room left, so a stream of small frames
+// is not moved after each one, and a framer waiting for a longer frame than
+// fits grows the buffer, at once to the size a length prefix announced.
+static bool sat_tcp_server_async_reserve (sat_tcp_connection_t *connection)
+{
+    sat_tcp_server_abstract_t *abstract = connection->server->abstract;
+    uint32_t pending = connection->input_size - connection->input_begin;
+
+    if (connection->input_begin > 0 && connection->input_capacity - connection->input_size <= connection->input_begin)
+    {
+        memmove (connection->input, connection->input + connection->input_begin, pending);
+
+        connection->input_begin = 0;
+        connection->input_size = pending;
+    }
+
+    if (connection->input_size < connection->input_capacity)
+        return true;
+
+    if (abstract->framer.type == sat_tcp_framer_type_none)
+        return false;
+
+    uint32_t limit = sat_tcp_framer_get_limit (&abstract->framer);
+    uint64_t capacity = (uint64_t) connection->input_capacity * 2;
+
+    if (capacity < connection->input_wanted)
+        capacity = connection->input_wanted;
+
+    if (capacity > limit)
+        capacity = limit;
+
+    if (capacity <= connection->input_capacity)
+        return false;
+
+    char *input = (char *) realloc (connection->input, (size_t) capacity);
+
+    if (input == NULL)
+        return false;
+
+    connection->input = input;
+    connection->input_capacity = (uint32_t) capacity;
+
+    return true;
+}
+
+static bool sat_tcp_server_async_deliver (sat_tcp_connection_t *connection)
+{
+    sat_tcp_server_abstract_t *abstract = connection->server->abstract;
+    const char *data = connection->input + connection->input_begin;
+    uint32_t size = connection->input_size - connection->input_begin;
+    uint32_t used = size;
+
+    connection->busy = true;
+
+    if (abstract->framer.type != sat_tcp_framer_type_none)
+        used = sat_tcp_server_async_frames (connection, data, size);
+
+    else if (abstract->events.on_data != NULL)
+    {
+        used = abstract->events.on_data (connection, data, size, abstract->data);
+
+        if (used > size)
+            used = size;
+    }
+
+    // Without on_data the shared buffer callbacks work as on the other server types.
+    else if (abstract->events.on_receive != NULL)
+    {
+        // Terminated rather than cleared, for callbacks that expect a string.
+        memcpy (abstract->buffer, data, size);
+
+        if (size < abstract->size)
+            abstract->buffer [size] = 0;
+
+        abstract->events.on_receive (abstract->buffer, &size, abstract->data);
+
+        if (abstract->events.on_send != NULL)
+        {
+            abstract->events.on_send (abstract->buffer, &size, abstract->data);
+            sat_tcp_connection_send (connection, abstract->buffer, size < abstract->size ? size : abstract->size);
+        }
+    }
+
+    connection->busy = false;
+
+    connection->input_begin += used;
+
+    if (connection->input_begin == connection->input_size)
+    {
+        connection->input_begin = 0;
+        connection->input_size = 0;
+    }
+
+    return sat_tcp_server_async_settle (connection);
+}
+
+// Hands each complete frame to on_frame where it lies in the input buffer.
+static uint32_t sat_tcp_server_async_frames (sat_tcp_connection_t *connection, const char *data, uint32_t size)
+{
+    sat_tcp_server_abstract_t *abstract = connection->server->abstract;
+    uint32_t used = 0;
+
+    while (connection->closing == false)
+    {
+        sat_tcp_frame_t frame;
+        sat_tcp_framer_result_t result = sat_tcp_framer_next (&abstract->framer, data + used, size - used, &connection->input_scanned, &frame);
+
+        if (result == sat_tcp_framer_result_partial)
+        {
+            connection->input_wanted = frame.used;
+            break;
+        }
+
+        // Broken framing cannot be resynchronized; replies already queued still go out.
+        if (result == sat_tcp_framer_result_invalid)
+        {
+            connection->closing = true;
+            break;
+        }
+
+        abstract->events.on_frame (connection, data + used + frame.offset, frame.size, abstract->data);
+
+        used += frame.used;
+    }
+
+    return used;
+}
+
+static bool sat_tcp_server_async_flush (sat_tcp_connection_t *connection)
+{
+    while (connection->output_begin < connection->output_end && connection->broken == false)
+    {
+        ssize_t written = send (connection->socket,
+                                connection->output + connection->output_begin,
+                                connection->output_end - connection->output_begin,
+                                MSG_NOSIGNAL);
+
+        if (written > 0)
+        {
+            connection->output_begin += (uint32_t) written;
+            sat_tcp_server_async_touch (connection);
+        }
+
+        else if (written < 0 && errno == EINTR)
+            continue;
+
+        else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        else
+        {
+            connection->broken = true;
+            connection->closing = true;
+        }
+    }
+
+    if (connection->output_begin == connection->output_end)
+    {
+        connection->output_begin = 0;
+        connection->output_end = 0;
+
+        sat_tcp_server_async_watch (connection, SAT_TCP_SERVER_ASYNC_EVENTS);
+    }
+
+    return sat_tcp_server_async_settle (connection);
+}
+
+// Drops a connection that was closed, once nothing is left to send.
+static bool sat_tcp_server_async_settle (sat_tcp_connection_t *connection)
+{
+    if (connection->closing == true && (connection->broken == true || connection->output_begin == connection->output_end))
+    {
+        sat_tcp_server_async_drop (connection);
+        return false;
+    }
+
+    return true;
+}
+
+static bool sat_tcp_server_async_append (sat_tcp_connection_t *connection, const char *data, uint32_t size)
+{
+    uint32_t pending = connection->output_end - connection->output_begin;
+
+    if (size > UINT32_MAX - pending)
+        return false;
+
+    if (connection->output_begin > 0)
+    {
+        memmove (connection->output, connection->output + connection->output_begin, pending);
+        connection->output_begin = 0;
+        connection->output_end = pending;
+    }
+
+    if (pending + size > connection->output_capacity)
+    {
+        uint64_t capacity = connection->output_capacity > 0 ? (uint64_t) connection->output_capacity * 2 : connection->server->abstract->size;
+
+        if (capacity < (uint64_t) pending + size)
+            capacity = (uint64_t) pending + size;
+
+        if (capacity > UINT32_MAX)
+            capacity = UINT32_MAX;
+
+        char *output = (char *) realloc (connection->output, (size_t) capacity);
+
+        if (output == NULL)
+            return false;
+
+        connection->output = output;
+        connection->output_capacity = (uint32_t) capacity;
+    }
+
+    memcpy (connection->output + connection->output_end, data, size);
+    connection->output_end += size;
+
+    return true;
+}
+
+static void sat_tcp_server_async_watch (sat_tcp_connection_t *connection, uint32_t events)
+{
+    if (connection->events != events)
+    {
+        sat_reactor_modify (connection->server->reactor, connection->socket, events);
+        connection->events = events;
+    }
+}
+
+// Moves the connection to the end of the idle list, which stays ordered by
+// last activity, so the timer only looks at the connections that expired.
+static void sat_tcp_server_async_touch (sat_tcp_connection_t *connection)
+{
+    sat_tcp_server_async_t *object = connection->server;
+
+    connection->active = sat_tcp_server_async_now ();
+
+    if (object->newest == connection)
+        return;
+
+    if (object->oldest == connection || connection->previous != NULL)
+        sat_tcp_server_async_unlink (connection);
+
+    connection->previous = object->newest;
+    connection->next = NULL;
+
+    if (object->newest != NULL)
+        object->newest->next = connection;
+    else
+        object->oldest = connection;
+
+    object->newest = connection;
+}
+
+static void sat_tcp_server_async_unlink (sat_tcp_connection_t *connection)
+{
+    sat_tcp_server_async_t *object = connection->server;
+
+    if (connection->previous != NULL)
+        connection->previous->next = connection->next;
+    else
+        object->oldest = connection->next;
+
+    if (connection->next != NULL)
+        connection->next->previous = connection->previous;
+    else
+        object->newest = connection->previous;
+
+    connection->previous = NULL;
+    connection->next = NULL;
+}
+
+static void sat_tcp_server_async_drop (sat_tcp_connection_t *connection)
+{
+    sat_tcp_server_async_t *object = connection->server;
+
+    connection->closing = true;
+
+    if (object->abstract->events.on_close != NULL)
+    {
+        connection->busy = true;
+        object->abstract->events.on_close (connection, object->abstract->data);
+    }
+
+    sat_tcp_server_async_unlink (connection);
+
+    sat_reactor_remove (object->reactor, connection->socket);
+    close (connection->socket);
+
+    __atomic_sub_fetch (&object->amount, 1, __ATOMIC_RELAXED);
+
+    free (connection->input);
+    free (connection->output);
+    free (connection);
+}
@@ -31,10 +31,12 @@ static sat_status_t sat_tcp_server_interactive_handle_client (void *object, int
     {
         while (true)
         {
-            memset (abstract->buffer, 0, abstract->size);
-
             size = recv (client, abstract->buffer, abstract->size, 0);
 
+            // Terminated rather than cleared, for callbacks that expect a string.
+            if (size < abstract->size)
+                abstract->buffer [size] = 0;
+
             if (size == 0)
                 break;
 
@@ -0,0 +1,179 @@
+#include <sat_tcp_server_listeners.h>
+#include <sat_tcp_server_async.h>
+#include <sat_reactor_group.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct
+{
+    sat_tcp_server_abstract_t abstract;
+    sat_tcp_server_async_t *async;
+    char *buffer;                       // shared buffer of the legacy events, one per thread
+} sat_tcp_server_listener_t;
+
+struct sat_tcp_server_listeners_t
+{
+    sat_tcp_server_listener_t *items;
+    uint16_t amount;
+    sat_reactor_group_t group;          // reactor i serves the socket of listener i
+    bool grouped;
+    char service [NI_MAXSERV];          // the port every listener binds, fixed by the first one
+};
+
+static sat_status_t sat_tcp_server_listeners_add (sat_tcp_server_listener_t *listener, sat_tcp_server_args_t *args, const char *service, sat_reactor_t *reactor);
+static void sat_tcp_server_listeners_remove (sat_tcp_server_listener_t *listener);
+
+sat_status_t sat_tcp_server_listeners_open (sat_tcp_server_listeners_t **object, sat_tcp_server_args_t *args)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server listeners open error: out of memory");
+
+    do
+    {
+        if (args->type != sat_tcp_server_type_async)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server listeners open error: async type only");
+            break;
+        }
+
+        sat_tcp_server_listeners_t *__object = calloc (1, sizeof (sat_tcp_server_listeners_t));
+        if (__object == NULL)
+            break;
+
+        __object->items = calloc (args->listeners, sizeof (sat_tcp_server_listener_t));
+        if (__object->items == NULL)
+        {
+            free (__object);
+            break;
+        }
+
+        snprintf (__object->service, sizeof (__object->service), "%s", args->service);
+
+        status = sat_reactor_group_open (&__object->group, &(sat_reactor_group_args_t)
+                                                           {
+                                                               .amount = args->listeners,
+                                                               .name = "sat_tcp",
+                                                               .steer_by_cpu = args->steer_by_cpu,
+                                                           });
+
+        __object->grouped = sat_status_get_result (&status);
+
+        for (uint16_t i = 0; i < args->listeners && sat_status_get_result (&status) == true; i++)
+        {
+            status = sat_tcp_server_listeners_add (&__object->items [i], args, __object->service, sat_reactor_group_get (&__object->group, i));
+            __object->amount ++;
+
+            // With port 0 the kernel picks one, and the rest of the group must join it.
+            if (sat_status_get_result (&status) == true && i == 0)
+                status = sat_reactor_group_get_service (__object->items [0].abstract.socket, __object->service, sizeof (__object->service));
+        }
+
+        if (sat_status_get_result (&status) == true && args->steer_by_cpu == true)
+            status = sat_reactor_group_steer (&__object->group, __object->items [0].abstract.socket);
+
+        if (sat_status_get_result (&status) == true)
+            status = sat_reactor_group_start (&__object->group);
+
+        if (sat_status_get_result (&status) == false)
+        {
+            sat_tcp_server_listeners_destroy (__object);
+            break;
+        }
+
+        *object = __object;
+
+    } while (false);
+
+    return status;
+}
+
+int sat_tcp_server_listeners_get_socket (sat_tcp_server_listeners_t *object)
+{
+    return object->items [0].abstract.socket;
+}
+
+uint32_t sat_tcp_server_listeners_get_connections (sat_tcp_server_listeners_t *object)
+{
+    uint32_t amount = 0;
+
+    for (uint16_t i = 0; i < object->amount; i++)
+        amount += sat_tcp_server_async_get_connections (object->items [i].async);
+
+    return amount;
+}
+
+void sat_tcp_server_listeners_destroy (sat_tcp_server_listeners_t *object)
+{
+    // The loops are stopped first, so the connections are closed from here.
+    if (object->grouped == true)
+        sat_reactor_group_stop (&object->group);
+
+    for (uint16_t i = 0; i < object->amount; i++)
+        sat_tcp_server_listeners_remove (&object->items [i]);
+
+    if (object->grouped == true)
+        sat_reactor_group_close (&object->group);
+
+    free (object->items);
+    free (object);
+}
+
+static sat_status_t sat_tcp_server_listeners_add (sat_tcp_server_listener_t *listener, sat_tcp_server_args_t *args, const char *service, sat_reactor_t *reactor)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat tcp server listeners add error: out of memory");
+
+    do
+    {
+        sat_tcp_server_abstract_copy_to_context (&listener->abstract, args);
+
+        listener->abstract.socket = -1;
+        listener->abstract.service = service;
+        listener->abstract.reuse_port = true;
+
+        // The legacy events write into the shared buffer, so each thread needs its own.
+        if (args->buffer != NULL)
+        {
+            listener->buffer = (char *) malloc (args->size);
+            if (listener->buffer == NULL)
+                break;
+
+            listener->abstract.buffer = listener->buffer;
+        }
+
+        struct addrinfo *info_list = sat_tcp_server_abstract_get_info_list (service);
+        if (info_list == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat tcp server listeners add error: unknown service");
+            break;
+        }
+
+        status = sat_tcp_server_abstract_configure (&listener->abstract, info_list);
+        freeaddrinfo (info_list);
+
+        if (sat_status_get_result (&status) == false)
+        {
+            listener->abstract.socket = -1;
+            break;
+        }
+
+        status = sat_tcp_server_async_open (&listener->async, &listener->abstract);
+        sat_status_break_on_error (status);
+
+        status = sat_tcp_server_async_attach (listener->async, reactor);
+
+    } while (false);
+
+    return status;
+}
+
+static void sat_tcp_server_listeners_remove (sat_tcp_server_listener_t *listener)
+{
+    if (listener->async != NULL)
+        sat_tcp_server_async_destroy (listener->async);
+
+    if (listener->abstract.socket >= 0)
+        close (listener->abstract.socket);
+
+    free (listener->buffer);
+}
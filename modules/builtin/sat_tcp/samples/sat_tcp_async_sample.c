@@ -0,0 +1,98 @@
+#include <sat.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+
+/*
+ * Line echo server on the async server type: any number of clients, each
+ * answered line by line, and closed after 30 seconds without traffic.
+ *
+ * usage: sat_tcp_async_sample [port]
+ * try:   nc localhost 5000
+ */
+
+#define SAMPLE_SERVICE_DEFAULT      "5000"
+#define SAMPLE_LINE_SIZE            4096
+#define SAMPLE_IDLE_TIMEOUT         30000
+
+static volatile sig_atomic_t running = 1;
+
+static void sample_on_signal (int signal)
+{
+    (void) signal;
+
+    running = 0;
+}
+
+static void sample_on_open (sat_tcp_connection_t *connection, void *data)
+{
+    printf ("client %d connected\n", sat_tcp_connection_get_socket (connection));
+}
+
+static void sample_on_close (sat_tcp_connection_t *connection, void *data)
+{
+    printf ("client %d gone\n", sat_tcp_connection_get_socket (connection));
+}
+
+static uint32_t sample_on_data (sat_tcp_connection_t *connection, const char *buffer, uint32_t size, void *data)
+{
+    const char *end = memchr (buffer, '\n', size);
+    uint32_t used = 0;
+
+    // Whole lines only; a partial one is given again with what follows it.
+    while (end != NULL)
+    {
+        uint32_t length = (uint32_t) (end - (buffer + used)) + 1;
+
+        sat_tcp_connection_send (connection, buffer + used, length);
+
+        used += length;
+        end = memchr (buffer + used, '\n', size - used);
+    }
+
+    return used;
+}
+
+int main (int argc, char **argv)
+{
+    sat_tcp_t server;
+    uint32_t connections = 0;
+
+    signal (SIGINT, sample_on_signal);
+    signal (SIGTERM, sample_on_signal);
+
+    sat_tcp_init (&server);
+
+    sat_status_t status = sat_tcp_open (&server, &(sat_tcp_args_t)
+                                                 {
+                                                     .type = sat_tcp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = argc > 1 ? argv [1] : SAMPLE_SERVICE_DEFAULT,
+                                                         .size = SAMPLE_LINE_SIZE,
+                                                         .events =
+                                                         {
+                                                             .on_open = sample_on_open,
+                                                             .on_data = sample_on_data,
+                                                             .on_close = sample_on_close,
+                                                         },
+                                                         .type = sat_tcp_server_type_async,
+                                                         .idle_timeout = SAMPLE_IDLE_TIMEOUT,
+                                                     },
+                                                 });
+    if (sat_status_get_result (&status) == false)
+    {
+        fprintf (stderr, "%s\n", sat_status_get_motive (&status));
+        return 1;
+    }
+
+    while (running)
+        sat_tcp_run (&server);
+
+    sat_tcp_get_connections (&server, &connections);
+    printf ("closing %u connections\n", connections);
+
+    sat_tcp_close (&server);
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/*
+ * Listener benchmark: an echo server of the async type, first with a single
+ * listener driven by sat_tcp_run, then with 2 up to N SO_REUSEPORT listeners
+ * on threads of their own. Client threads measure two loads against each:
+ * short connections (connect, one echo, close), which stress accepting, and
+ * echoes on connections kept open, which stress reading.
+ *
+ * The clients share the host with the server, so run it on a machine with
+ * more cores than client threads plus listeners to see the listeners scale.
+ *
+ * usage: sat_tcp_benchmark [seconds] [max listeners] [client threads] [steer]
+ */
+
+#define BENCHMARK_SERVICE               "5001"
+#define BENCHMARK_PORT                  5001
+#define BENCHMARK_SECONDS_DEFAULT       2
+#define BENCHMARK_LISTENERS_DEFAULT     4
+#define BENCHMARK_CLIENTS_DEFAULT       4
+#define BENCHMARK_CONNECTIONS           8       // kept open by each client thread
+#define BENCHMARK_MESSAGE_SIZE          64
+
+typedef struct
+{
+    bool persistent;
+    double deadline;
+    uint64_t done;
+    pthread_t thread;
+} benchmark_client_t;
+
+static volatile bool benchmark_serving;
+
+static double benchmark_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static uint32_t benchmark_on_data (sat_tcp_connection_t *connection, const char *buffer, uint32_t size, void *data)
+{
+    sat_tcp_connection_send (connection, buffer, size);
+
+    return size;
+}
+
+// The single listener is turned by a thread of its own, as an application would.
+static void *benchmark_serve (void *args)
+{
+    sat_tcp_t *server = (sat_tcp_t *) args;
+
+    while (benchmark_serving == true)
+        sat_tcp_run (server);
+
+    return NULL;
+}
+
+static int benchmark_connect (void)
+{
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons (BENCHMARK_PORT)};
+    struct linger linger = {.l_onoff = 1, .l_linger = 0};
+    int yes = 1;
+
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = socket (AF_INET, SOCK_STREAM, 0);
+
+    // Reset on close, or the short connections run out of ports in TIME_WAIT.
+    setsockopt (fd, SOL_SOCKET, SO_LINGER, &linger, sizeof (linger));
+    setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof (yes));
+
+    if (connect (fd, (struct sockaddr *) &address, sizeof (address)) != 0)
+    {
+        close (fd);
+        fd = -1;
+    }
+
+    return fd;
+}
+
+static bool benchmark_echo (int fd)
+{
+    char message [BENCHMARK_MESSAGE_SIZE] = {0};
+    size_t received = 0;
+
+    if (send (fd, message, sizeof (message), 0) != sizeof (message))
+        return false;
+
+    while (received < sizeof (message))
+    {
+        ssize_t size = recv (fd, message + received, sizeof (message) - received, 0);
+
+        if (size <= 0)
+            return false;
+
+        received += (size_t) size;
+    }
+
+    return true;
+}
+
+static void *benchmark_client (void *args)
+{
+    benchmark_client_t *client = (benchmark_client_t *) args;
+    int fds [BENCHMARK_CONNECTIONS];
+
+    if (client->persistent == false)
+    {
+        while (benchmark_now () < client->deadline)
+        {
+            int fd = benchmark_connect ();
+
+            if (fd >= 0 && benchmark_echo (fd) == true)
+                client->done ++;
+
+            if (fd >= 0)
+                close (fd);
+        }
+    }
+
+    else
+    {
+        for (uint32_t i = 0; i < BENCHMARK_CONNECTIONS; i++)
+            fds [i] = benchmark_connect ();
+
+        for (uint32_t i = 0; benchmark_now () < client->deadline; i = (i + 1) % BENCHMARK_CONNECTIONS)
+        {
+            if (fds [i] >= 0 && benchmark_echo (fds [i]) == true)
+                client->done ++;
+        }
+
+        for (uint32_t i = 0; i < BENCHMARK_CONNECTIONS; i++)
+        {
+            if (fds [i] >= 0)
+                close (fds [i]);
+        }
+    }
+
+    return NULL;
+}
+
+static double benchmark_load (uint32_t clients, double seconds, bool persistent)
+{
+    benchmark_client_t *items = (benchmark_client_t *) calloc (clients, sizeof (benchmark_client_t));
+    uint64_t done = 0;
+
+    if (items == NULL)
+        return 0.0;
+
+    double start = benchmark_now ();
+
+    for (uint32_t i = 0; i < clients; i++)
+    {
+        items [i] = (benchmark_client_t) {.persistent = persistent, .deadline = start + seconds};
+        pthread_create (&items [i].thread, NULL, benchmark_client, &items [i]);
+    }
+
+    for (uint32_t i = 0; i < clients; i++)
+    {
+        pthread_join (items [i].thread, NULL);
+        done += items [i].done;
+    }
+
+    double elapsed = benchmark_now () - start;
+
+    free (items);
+
+    return (double) done / elapsed / 1e3;
+}
+
+static bool benchmark_run (uint16_t listeners, bool steer, uint32_t clients, double seconds, double *connections, double *echoes)
+{
+    sat_tcp_t server;
+    pthread_t serve;
+
+    sat_tcp_init (&server);
+
+    sat_status_t status = sat_tcp_open (&server, &(sat_tcp_args_t)
+                                                 {
+                                                     .type = sat_tcp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = BENCHMARK_SERVICE,
+                                                         .size = 4096,
+                                                         .events = {.on_data = benchmark_on_data},
+                                                         .type = sat_tcp_server_type_async,
+                                                         .listeners = listeners,
+                                                         .steer_by_cpu = steer,
+                                                     },
+                                                 });
+    if (sat_status_get_result (&status) == false)
+    {
+        fprintf (stderr, "%s\n", sat_status_get_motive (&status));
+        return false;
+    }
+
+    benchmark_serving = true;
+
+    if (listeners == 1)
+        pthread_create (&serve, NULL, benchmark_serve, &server);
+
+    *connections = benchmark_load (clients, seconds, false);
+    *echoes = benchmark_load (clients, seconds, true);
+
+    benchmark_serving = false;
+
+    if (listeners == 1)
+        pthread_join (serve, NULL);
+
+    sat_tcp_close (&server);
+
+    return true;
+}
+
+int main (int argc, char *argv[])
+{
+    double seconds = argc > 1 ? atof (argv [1]) : BENCHMARK_SECONDS_DEFAULT;
+    uint32_t max_listeners = argc > 2 ? (uint32_t) strtoul (argv [2], NULL, 10) : BENCHMARK_LISTENERS_DEFAULT;
+    uint32_t clients = argc > 3 ? (uint32_t) strtoul (argv [3], NULL, 10) : BENCHMARK_CLIENTS_DEFAULT;
+    bool steer = argc > 4 && strcmp (argv [4], "steer") == 0;
+
+    if (seconds <= 0)
+        seconds = BENCHMARK_SECONDS_DEFAULT;
+
+    if (max_listeners == 0 || max_listeners > UINT16_MAX)
+        max_listeners = BENCHMARK_LISTENERS_DEFAULT;
+
+    if (clients == 0)
+        clients = BENCHMARK_CLIENTS_DEFAULT;
+
+    printf ("%u client threads, %.1f s per load, %d byte echoes%s\n", clients, seconds, BENCHMARK_MESSAGE_SIZE, steer ? ", steered by cpu" : "");
+    printf ("%-10s %20s %20s\n", "listeners", "Kconnections/s", "Kechoes/s");
+
+    for (uint32_t listeners = 1; listeners <= max_listeners; listeners *= 2)
+    {
+        double connections = 0.0;
+        double echoes = 0.0;
+
+        if (benchmark_run ((uint16_t) listeners, steer, clients, seconds, &connections, &echoes) == false)
+            return 1;
+
+        char label [16];
+
+        snprintf (label, sizeof (label), listeners == 1 ? "1 (run)" : "%u", listeners);
+        printf ("%-10s %20.1f %20.1f\n", label, connections, echoes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,412 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define TEST_SERVICE        "4322"
+#define TEST_PORT           4322
+#define TEST_BUFFER_SIZE    256
+#define TEST_CLIENTS        600
+#define TEST_BULK_SIZE      (4 * 1024 * 1024)
+
+typedef struct
+{
+    uint32_t opened;
+    uint32_t closed;
+    uint32_t lines;
+} test_context_t;
+
+static test_context_t context;
+
+static uint64_t test_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
+
+static int test_connect (void)
+{
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons (TEST_PORT)};
+
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = socket (AF_INET, SOCK_STREAM, 0);
+    assert (fd >= 0);
+    assert (connect (fd, (struct sockaddr *) &address, sizeof (address)) == 0);
+
+    return fd;
+}
+
+static void test_open (sat_tcp_t *const server, const sat_tcp_server_args_t *const args)
+{
+    memset (&context, 0, sizeof (context));
+
+    sat_status_t status = sat_tcp_init (server);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_tcp_open (server, &(sat_tcp_args_t) {.type = sat_tcp_type_server, .server = *args});
+    assert (sat_status_get_result (&status) == true);
+}
+
+static uint32_t test_connections (sat_tcp_t *const server)
+{
+    uint32_t amount = 0;
+
+    sat_status_t status = sat_tcp_get_connections (server, &amount);
+    assert (sat_status_get_result (&status) == true);
+
+    return amount;
+}
+
+// Turns the server loop until it holds the expected number of connections.
+static void test_wait_connections (sat_tcp_t *const server, uint32_t amount)
+{
+    uint64_t deadline = test_now () + 5000;
+
+    while (test_connections (server) != amount)
+    {
+        assert (test_now () < deadline);
+
+        sat_status_t status = sat_tcp_run (server);
+        assert (sat_status_get_result (&status) == true);
+    }
+}
+
+// Reads from a client, turning the server loop while nothing has arrived.
+static size_t test_read (sat_tcp_t *const server, int fd, char *const buffer, size_t size)
+{
+    uint64_t deadline = test_now () + 5000;
+
+    while (true)
+    {
+        ssize_t received = recv (fd, buffer, size, MSG_DONTWAIT);
+
+        if (received >= 0)
+            return (size_t) received;
+
+        assert (errno == EAGAIN || errno == EWOULDBLOCK);
+        assert (test_now () < deadline);
+
+        sat_tcp_run (server);
+    }
+}
+
+static void test_on_open (sat_tcp_connection_t *connection, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    context->opened ++;
+
+    sat_tcp_connection_set_user (connection, (void *) (uintptr_t) context->opened);
+}
+
+static void test_on_close (sat_tcp_connection_t *connection, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    context->closed ++;
+}
+
+// Answers every complete line and keeps a partial one for later.
+static uint32_t test_on_line (sat_tcp_connection_t *connection, const char *buffer, uint32_t size, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+    uint32_t used = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (buffer [i] == '\n')
+        {
+            char reply [TEST_BUFFER_SIZE];
+            int length = snprintf (reply, sizeof (reply), "%lu:%.*s", (unsigned long) (uintptr_t) sat_tcp_connection_get_user (connection), (int) (i - used), buffer + used);
+
+            sat_status_t status = sat_tcp_connection_send (connection, reply, (uint32_t) length + 1);
+            assert (sat_status_get_result (&status) == true);
+
+            if (strncmp (buffer + used, "quit", 4) == 0)
+                sat_tcp_connection_close (connection);
+
+            context->lines ++;
+            used = i + 1;
+        }
+    }
+
+    return used;
+}
+
+static uint32_t test_on_bulk (sat_tcp_connection_t *connection, const char *buffer, uint32_t size, void *data)
+{
+    char *bulk = (char *) malloc (TEST_BULK_SIZE);
+
+    assert (bulk != NULL);
+
+    for (uint32_t i = 0; i < TEST_BULK_SIZE; i++)
+        bulk [i] = (char) (i % 251);
+
+    // Far more than the socket takes at once: the rest waits for room.
+    sat_status_t status = sat_tcp_connection_send (connection, bulk, TEST_BULK_SIZE);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_tcp_connection_close (connection);
+
+    free (bulk);
+
+    return size;
+}
+
+static void test_legacy_on_receive (char *buffer, uint32_t *size, void *data)
+{
+    assert (strcmp (buffer, "ping") == 0);
+}
+
+static void test_legacy_on_send (char *buffer, uint32_t *size, void *data)
+{
+    strcpy (buffer, "pong");
+    *size = 5;
+}
+
+static void test_many_clients (void)
+{
+    sat_tcp_t server;
+    int *clients = (int *) malloc (TEST_CLIENTS * sizeof (int));
+    char buffer [TEST_BUFFER_SIZE];
+
+    test_open (&server, &(sat_tcp_server_args_t)
+                        {
+                            .service = TEST_SERVICE,
+                            .size = TEST_BUFFER_SIZE,
+                            .events = {.on_open = test_on_open, .on_data = test_on_line, .on_close = test_on_close},
+                            .data = &context,
+                            .type = sat_tcp_server_type_async,
+                            .backlog = 128,
+                        });
+
+    // All of them connected at once, in rounds smaller than the backlog.
+    for (uint32_t i = 0; i < TEST_CLIENTS; i++)
+    {
+        clients [i] = test_connect ();
+
+        if ((i + 1) % 64 == 0)
+            test_wait_connections (&server, i + 1);
+    }
+
+    test_wait_connections (&server, TEST_CLIENTS);
+    assert (context.opened == TEST_CLIENTS);
+
+    // Each line arrives in two pieces, and only the second completes it.
+    for (uint32_t i = 0; i < TEST_CLIENTS; i++)
+        assert (send (clients [i], "hel", 3, 0) == 3);
+
+    for (uint32_t i = 0; i < 2; i++)
+        sat_tcp_run (&server);
+
+    for (uint32_t i = 0; i < TEST_CLIENTS; i++)
+        assert (send (clients [i], "lo\n", 3, 0) == 3);
+
+    for (uint32_t i = 0; i < TEST_CLIENTS; i++)
+    {
+        size_t size = test_read (&server, clients [i], buffer, sizeof (buffer));
+
+        assert (size > 0);
+        assert (strcmp (strchr (buffer, ':'), ":hello") == 0);
+    }
+
+    assert (context.lines == TEST_CLIENTS);
+
+    // Closed by the application, after its last reply is sent.
+    assert (send (clients [0], "quit\n", 5, 0) == 5);
+
+    size_t size = test_read (&server, clients [0], buffer, sizeof (buffer));
+    assert (size > 0);
+    assert (test_read (&server, clients [0], buffer, sizeof (buffer)) == 0);
+
+    // Closed by the peer.
+    for (uint32_t i = 0; i < TEST_CLIENTS; i++)
+        close (clients [i]);
+
+    test_wait_connections (&server, 0);
+    assert (context.closed == TEST_CLIENTS);
+
+    sat_status_t status = sat_tcp_close (&server);
+    assert (sat_status_get_result (&status) == true);
+
+    free (clients);
+}
+
+static void test_idle_timeout (void)
+{
+    sat_tcp_t server;
+    char buffer [TEST_BUFFER_SIZE];
+
+    test_open (&server, &(sat_tcp_server_args_t)
+                        {
+                            .service = TEST_SERVICE,
+                            .size = TEST_BUFFER_SIZE,
+                            .events = {.on_open = test_on_open, .on_data = test_on_line, .on_close = test_on_close},
+                            .data = &context,
+                            .type = sat_tcp_server_type_async,
+                            .idle_timeout = 200,
+                        });
+
+    int quiet = test_connect ();
+    int chatty = test_connect ();
+
+    test_wait_connections (&server, 2);
+
+    uint64_t start = test_now ();
+
+    // Traffic keeps a connection open past the timeout.
+    while (test_now () - start < 400)
+    {
+        assert (send (chatty, "tick\n", 5, 0) == 5);
+        assert (test_read (&server, chatty, buffer, sizeof (buffer)) > 0);
+
+        usleep (20000);
+    }
+
+    assert (test_connections (&server) == 1);
+    assert (context.closed == 1);
+    assert (test_read (&server, quiet, buffer, sizeof (buffer)) == 0);
+
+    test_wait_connections (&server, 0);
+    assert (test_now () - start < 1000);
+
+    close (quiet);
+    close (chatty);
+
+    sat_tcp_close (&server);
+}
+
+static void test_bulk (void)
+{
+    sat_tcp_t server;
+    char *buffer = (char *) malloc (TEST_BULK_SIZE + 1);
+    size_t total = 0;
+
+    test_open (&server, &(sat_tcp_server_args_t)
+                        {
+                            .service = TEST_SERVICE,
+                            .size = TEST_BUFFER_SIZE,
+                            .events = {.on_data = test_on_bulk, .on_close = test_on_close},
+                            .data = &context,
+                            .type = sat_tcp_server_type_async,
+                        });
+
+    int fd = test_connect ();
+
+    assert (send (fd, "go", 2, 0) == 2);
+
+    // The server flushes as the client makes room, then hangs up.
+    while (true)
+    {
+        size_t size = test_read (&server, fd, buffer + total, TEST_BULK_SIZE - total > 65536 ? 65536 : TEST_BULK_SIZE - total + 1);
+
+        if (size == 0)
+            break;
+
+        total += size;
+    }
+
+    assert (total == TEST_BULK_SIZE);
+
+    for (uint32_t i = 0; i < TEST_BULK_SIZE; i++)
+        assert (buffer [i] == (char) (i % 251));
+
+    test_wait_connections (&server, 0);
+    assert (context.closed == 1);
+
+    close (fd);
+    sat_tcp_close (&server);
+    free (buffer);
+}
+
+static void test_legacy_events (void)
+{
+    sat_tcp_t server;
+    sat_reactor_t reactor;
+    char shared [TEST_BUFFER_SIZE];
+    char buffer [TEST_BUFFER_SIZE];
+
+    test_open (&server, &(sat_tcp_server_args_t)
+                        {
+                            .service = TEST_SERVICE,
+                            .buffer = shared,
+                            .size = TEST_BUFFER_SIZE,
+                            .events = {.on_receive = test_legacy_on_receive, .on_send = test_legacy_on_send},
+                            .type = sat_tcp_server_type_async,
+                        });
+
+    // On a reactor of the application instead of sat_tcp_run.
+    sat_reactor_init (&reactor);
+
+    sat_status_t status = sat_reactor_open (&reactor, NULL);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_tcp_attach (&server, &reactor);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_tcp_run (&server);
+    assert (sat_status_get_result (&status) == false);
+
+    int fd = test_connect ();
+
+    assert (send (fd, "ping", 4, 0) == 4);
+
+    uint64_t deadline = test_now () + 5000;
+    ssize_t size;
+
+    while ((size = recv (fd, buffer, sizeof (buffer), MSG_DONTWAIT)) < 0)
+    {
+        assert (test_now () < deadline);
+        sat_reactor_run_once (&reactor, 10);
+    }
+
+    assert (size == 5);
+    assert (strcmp (buffer, "pong") == 0);
+
+    close (fd);
+
+    sat_tcp_close (&server);
+    sat_reactor_close (&reactor);
+}
+
+static void test_invalid (void)
+{
+    sat_tcp_t server;
+
+    sat_tcp_init (&server);
+
+    // Without on_data the shared buffer is still needed.
+    sat_status_t status = sat_tcp_open (&server, &(sat_tcp_args_t)
+                                                 {
+                                                     .type = sat_tcp_type_server,
+                                                     .server = {.service = TEST_SERVICE, .size = TEST_BUFFER_SIZE, .type = sat_tcp_server_type_async},
+                                                 });
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_tcp_connection_send (NULL, "x", 1);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_tcp_connection_close (NULL);
+    assert (sat_status_get_result (&status) == false);
+}
+
+int main (int argc, char *argv[])
+{
+    test_many_clients ();
+    test_idle_timeout ();
+    test_bulk ();
+    test_legacy_events ();
+    test_invalid ();
+
+    return 0;
+}
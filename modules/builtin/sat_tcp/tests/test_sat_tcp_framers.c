@@ -0,0 +1,314 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define TEST_SERVICE        "4324"
+#define TEST_PORT           4324
+#define TEST_BUFFER_SIZE    256
+#define TEST_LARGE_SIZE     (100 * 1024)
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t closed;
+} test_context_t;
+
+static test_context_t context;
+
+static uint64_t test_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
+
+static int test_connect (void)
+{
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons (TEST_PORT)};
+
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = socket (AF_INET, SOCK_STREAM, 0);
+    assert (fd >= 0);
+    assert (connect (fd, (struct sockaddr *) &address, sizeof (address)) == 0);
+
+    return fd;
+}
+
+// Every frame comes back as its payload followed by a newline.
+static void test_on_frame (sat_tcp_connection_t *connection, const char *frame, uint32_t size, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    context->frames ++;
+
+    sat_tcp_connection_send (connection, frame, size);
+    sat_tcp_connection_send (connection, "\n", 1);
+}
+
+static void test_on_close (sat_tcp_connection_t *connection, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    context->closed ++;
+}
+
+static void test_open (sat_tcp_t *const server, const sat_tcp_framer_t *const framer)
+{
+    memset (&context, 0, sizeof (context));
+
+    sat_status_t status = sat_tcp_init (server);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_tcp_open (server, &(sat_tcp_args_t)
+                                   {
+                                       .type = sat_tcp_type_server,
+                                       .server =
+                                       {
+                                           .service = TEST_SERVICE,
+                                           .size = TEST_BUFFER_SIZE,
+                                           .events = {.on_frame = test_on_frame, .on_close = test_on_close},
+                                           .data = &context,
+                                           .type = sat_tcp_server_type_async,
+                                           .framer = *framer,
+                                       },
+                                   });
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_send (sat_tcp_t *const server, int fd, const void *data, size_t size)
+{
+    assert (send (fd, data, size, 0) == (ssize_t) size);
+
+    // Read before the next piece is sent, as a rule.
+    sat_tcp_run (server);
+}
+
+// Reads until the expected bytes have arrived, turning the server loop meanwhile.
+static void test_expect (sat_tcp_t *const server, int fd, const char *expected, size_t size)
+{
+    char *buffer = (char *) malloc (size);
+    uint64_t deadline = test_now () + 5000;
+    size_t total = 0;
+
+    assert (buffer != NULL);
+
+    while (total < size)
+    {
+        ssize_t received = recv (fd, buffer + total, size - total, MSG_DONTWAIT);
+
+        if (received > 0)
+            total += (size_t) received;
+
+        else
+        {
+            assert (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+            assert (test_now () < deadline);
+
+            sat_tcp_run (server);
+        }
+    }
+
+    assert (memcmp (buffer, expected, size) == 0);
+
+    free (buffer);
+}
+
+static void test_expect_closed (sat_tcp_t *const server, int fd)
+{
+    uint64_t deadline = test_now () + 5000;
+    char buffer [TEST_BUFFER_SIZE];
+
+    while (recv (fd, buffer, sizeof (buffer), MSG_DONTWAIT) != 0)
+    {
+        assert (test_now () < deadline);
+        sat_tcp_run (server);
+    }
+}
+
+static void test_length (void)
+{
+    sat_tcp_t server;
+
+    test_open (&server, &(sat_tcp_framer_t) {.type = sat_tcp_framer_type_length, .length = {.width = 2, .endian = sat_tcp_framer_endian_big}});
+
+    int fd = test_connect ();
+
+    // Several frames in one piece, the last one split inside its prefix.
+    test_send (&server, fd, "\x00\x03one\x00\x03two\x00\x00\x00", 13);
+    test_send (&server, fd, "\x05three", 6);
+
+    test_expect (&server, fd, "one\ntwo\n\nthree\n", 15);
+    assert (context.frames == 4);
+
+    close (fd);
+    sat_tcp_close (&server);
+}
+
+static void test_length_large (void)
+{
+    sat_tcp_t server;
+    char *frame = (char *) malloc (TEST_LARGE_SIZE + 4);
+    char *expected = (char *) malloc (TEST_LARGE_SIZE + 1);
+
+    // Little endian, counting its own four bytes.
+    test_open (&server, &(sat_tcp_framer_t) {.type = sat_tcp_framer_type_length, .length = {.width = 4, .endian = sat_tcp_framer_endian_little, .inclusive = true}});
+
+    uint32_t length = TEST_LARGE_SIZE + 4;
+
+    for (uint32_t i = 0; i < 4; i++)
+        frame [i] = (char) (length >> (8 * i));
+
+    for (uint32_t i = 0; i < TEST_LARGE_SIZE; i++)
+        frame [4 + i] = expected [i] = (char) ('a' + i % 26);
+
+    expected [TEST_LARGE_SIZE] = '\n';
+
+    // Far more than the input buffer holds at first.
+    int fd = test_connect ();
+
+    for (uint32_t sent = 0; sent < length; sent += 4096)
+        test_send (&server, fd, frame + sent, length - sent < 4096 ? length - sent : 4096);
+
+    test_expect (&server, fd, expected, TEST_LARGE_SIZE + 1);
+    assert (context.frames == 1);
+
+    close (fd);
+    sat_tcp_close (&server);
+
+    free (frame);
+    free (expected);
+}
+
+static void test_delimiter (void)
+{
+    sat_tcp_t server;
+    char *line = (char *) malloc (TEST_LARGE_SIZE + 2);
+
+    test_open (&server, &(sat_tcp_framer_t) {.type = sat_tcp_framer_type_delimiter, .delimiter = {.bytes = "\r\n"}});
+
+    int fd = test_connect ();
+
+    // A delimiter split across reads.
+    test_send (&server, fd, "a\r", 2);
+    test_send (&server, fd, "\nbb\r\nc", 6);
+    test_send (&server, fd, "\r\n", 2);
+
+    test_expect (&server, fd, "a\nbb\nc\n", 7);
+
+    // A line far longer than the input buffer, searched as it arrives.
+    memset (line, 'x', TEST_LARGE_SIZE);
+    memcpy (line + TEST_LARGE_SIZE, "\r\n", 2);
+
+    for (uint32_t sent = 0; sent < TEST_LARGE_SIZE + 2; sent += 4096)
+        test_send (&server, fd, line + sent, TEST_LARGE_SIZE + 2 - sent < 4096 ? TEST_LARGE_SIZE + 2 - sent : 4096);
+
+    line [TEST_LARGE_SIZE] = '\n';
+    test_expect (&server, fd, line, TEST_LARGE_SIZE + 1);
+    assert (context.frames == 4);
+
+    close (fd);
+    sat_tcp_close (&server);
+
+    free (line);
+}
+
+static void test_fixed (void)
+{
+    sat_tcp_t server;
+
+    test_open (&server, &(sat_tcp_framer_t) {.type = sat_tcp_framer_type_fixed, .fixed = {.size = 4}});
+
+    int fd = test_connect ();
+
+    test_send (&server, fd, "abcdefghij", 10);
+    test_expect (&server, fd, "abcd\nefgh\n", 10);
+
+    test_send (&server, fd, "kl", 2);
+    test_expect (&server, fd, "ijkl\n", 5);
+    assert (context.frames == 3);
+
+    close (fd);
+    sat_tcp_close (&server);
+}
+
+static void test_too_large (void)
+{
+    sat_tcp_t server;
+
+    test_open (&server, &(sat_tcp_framer_t) {.type = sat_tcp_framer_type_length, .max_size = 16, .length = {.width = 1}});
+
+    int fd = test_connect ();
+
+    // The valid frame is answered before the connection is closed.
+    test_send (&server, fd, "\x02ok\x20", 4);
+
+    test_expect (&server, fd, "ok\n", 3);
+    test_expect_closed (&server, fd);
+    assert (context.closed == 1);
+
+    close (fd);
+    sat_tcp_close (&server);
+
+    // Nor may a delimiter take longer to show up.
+    test_open (&server, &(sat_tcp_framer_t) {.type = sat_tcp_framer_type_delimiter, .max_size = 16, .delimiter = {.bytes = "\n"}});
+
+    fd = test_connect ();
+
+    test_send (&server, fd, "0123456789abcdefg", 17);
+    test_expect_closed (&server, fd);
+    assert (context.frames == 0);
+
+    close (fd);
+    sat_tcp_close (&server);
+}
+
+static void test_invalid (void)
+{
+    sat_tcp_t server;
+    char buffer [TEST_BUFFER_SIZE];
+
+    sat_tcp_server_args_t args [] =
+    {
+        // A framer without on_frame, and on_frame without a framer.
+        {.service = TEST_SERVICE, .size = TEST_BUFFER_SIZE, .type = sat_tcp_server_type_async, .framer = {.type = sat_tcp_framer_type_fixed, .fixed = {.size = 4}}},
+        {.service = TEST_SERVICE, .size = TEST_BUFFER_SIZE, .type = sat_tcp_server_type_async, .events = {.on_frame = test_on_frame}},
+
+        // Only the async type splits frames.
+        {.service = TEST_SERVICE, .buffer = buffer, .size = TEST_BUFFER_SIZE, .events = {.on_frame = test_on_frame}, .framer = {.type = sat_tcp_framer_type_fixed, .fixed = {.size = 4}}},
+
+        // Framers that cannot work.
+        {.service = TEST_SERVICE, .size = TEST_BUFFER_SIZE, .type = sat_tcp_server_type_async, .events = {.on_frame = test_on_frame}, .framer = {.type = sat_tcp_framer_type_length, .length = {.width = 3}}},
+        {.service = TEST_SERVICE, .size = TEST_BUFFER_SIZE, .type = sat_tcp_server_type_async, .events = {.on_frame = test_on_frame}, .framer = {.type = sat_tcp_framer_type_delimiter}},
+        {.service = TEST_SERVICE, .size = TEST_BUFFER_SIZE, .type = sat_tcp_server_type_async, .events = {.on_frame = test_on_frame}, .framer = {.type = sat_tcp_framer_type_fixed}},
+    };
+
+    for (uint32_t i = 0; i < sizeof (args) / sizeof (args [0]); i++)
+    {
+        sat_tcp_init (&server);
+
+        sat_status_t status = sat_tcp_open (&server, &(sat_tcp_args_t) {.type = sat_tcp_type_server, .server = args [i]});
+        assert (sat_status_get_result (&status) == false);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    test_length ();
+    test_length_large ();
+    test_delimiter ();
+    test_fixed ();
+    test_too_large ();
+    test_invalid ();
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define TEST_SERVICE        "4323"
+#define TEST_PORT           4323
+#define TEST_BUFFER_SIZE    256
+#define TEST_LISTENERS      4
+#define TEST_CLIENTS        64
+
+typedef struct
+{
+    uint32_t opened;
+    uint32_t closed;
+    uint32_t threads;
+} test_context_t;
+
+static test_context_t context;
+static __thread bool serving;
+
+static uint64_t test_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
+
+// Steering takes at most one listener per CPU the process may use.
+static uint16_t test_cpus (void)
+{
+    cpu_set_t set;
+
+    CPU_ZERO (&set);
+    assert (sched_getaffinity (0, sizeof (set), &set) == 0);
+
+    return (uint16_t) CPU_COUNT (&set);
+}
+
+static int test_connect (void)
+{
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons (TEST_PORT)};
+
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = socket (AF_INET, SOCK_STREAM, 0);
+    assert (fd >= 0);
+    assert (connect (fd, (struct sockaddr *) &address, sizeof (address)) == 0);
+
+    return fd;
+}
+
+static void test_open (sat_tcp_t *const server, const sat_tcp_server_args_t *const args)
+{
+    memset (&context, 0, sizeof (context));
+
+    sat_status_t status = sat_tcp_init (server);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_tcp_open (server, &(sat_tcp_args_t) {.type = sat_tcp_type_server, .server = *args});
+    assert (sat_status_get_result (&status) == true);
+}
+
+// The listener threads serve on their own; this only waits for them.
+static void test_wait_connections (sat_tcp_t *const server, uint32_t amount)
+{
+    uint64_t deadline = test_now () + 5000;
+    uint32_t current = 0;
+
+    while (sat_tcp_get_connections (server, &current), current != amount)
+    {
+        assert (test_now () < deadline);
+        usleep (1000);
+    }
+}
+
+static void test_on_open (sat_tcp_connection_t *connection, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    // Counts the threads that took at least one client.
+    if (serving == false)
+    {
+        serving = true;
+        __atomic_add_fetch (&context->threads, 1, __ATOMIC_RELAXED);
+    }
+
+    __atomic_add_fetch (&context->opened, 1, __ATOMIC_RELAXED);
+}
+
+static void test_on_close (sat_tcp_connection_t *connection, void *data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    __atomic_add_fetch (&context->closed, 1, __ATOMIC_RELAXED);
+}
+
+static uint32_t test_on_data (sat_tcp_connection_t *connection, const char *buffer, uint32_t size, void *data)
+{
+    sat_tcp_connection_send (connection, buffer, size);
+
+    return size;
+}
+
+static void test_echo (int fd)
+{
+    char buffer [TEST_BUFFER_SIZE];
+
+    assert (send (fd, "ping", 4, 0) == 4);
+    assert (recv (fd, buffer, sizeof (buffer), 0) == 4);
+    assert (memcmp (buffer, "ping", 4) == 0);
+}
+
+static void test_spread (void)
+{
+    sat_tcp_t server;
+    int clients [TEST_CLIENTS];
+
+    test_open (&server, &(sat_tcp_server_args_t)
+                        {
+                            .service = TEST_SERVICE,
+                            .size = TEST_BUFFER_SIZE,
+                            .events = {.on_open = test_on_open, .on_data = test_on_data, .on_close = test_on_close},
+                            .data = &context,
+                            .type = sat_tcp_server_type_async,
+                            .listeners = TEST_LISTENERS,
+                        });
+
+    // Served by the listener threads, with nothing to run here.
+    for (uint32_t i = 0; i < TEST_CLIENTS; i++)
+    {
+        clients [i] = test_connect ();
+        test_echo (clients [i]);
+    }
+
+    test_wait_connections (&server, TEST_CLIENTS);
+
+    assert (__atomic_load_n (&context.opened, __ATOMIC_RELAXED) == TEST_CLIENTS);
+    assert (__atomic_load_n (&context.threads, __ATOMIC_RELAXED) > 1);
+
+    sat_status_t status = sat_tcp_run (&server);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < TEST_CLIENTS / 2; i++)
+        close (clients [i]);
+
+    test_wait_connections (&server, TEST_CLIENTS / 2);
+
+    // The rest are closed with the server.
+    status = sat_tcp_close (&server);
+    assert (sat_status_get_result (&status) == true);
+    assert (context.closed == TEST_CLIENTS);
+
+    for (uint32_t i = TEST_CLIENTS / 2; i < TEST_CLIENTS; i++)
+        close (clients [i]);
+}
+
+static void test_steer (void)
+{
+    sat_tcp_t server;
+    sat_tcp_server_args_t args =
+    {
+        .service = TEST_SERVICE,
+        .size = TEST_BUFFER_SIZE,
+        .events = {.on_data = test_on_data},
+        .type = sat_tcp_server_type_async,
+        .listeners = test_cpus (),
+        .steer_by_cpu = true,
+    };
+
+    test_open (&server, &args);
+
+    int fd = test_connect ();
+    char buffer [TEST_BUFFER_SIZE];
+
+    // On a single CPU the one listener is turned by sat_tcp_run.
+    assert (send (fd, "ping", 4, 0) == 4);
+
+    while (args.listeners == 1 && recv (fd, buffer, sizeof (buffer), MSG_PEEK | MSG_DONTWAIT) <= 0)
+        sat_tcp_run (&server);
+
+    assert (recv (fd, buffer, sizeof (buffer), 0) == 4);
+    assert (memcmp (buffer, "ping", 4) == 0);
+
+    close (fd);
+    sat_tcp_close (&server);
+
+    // A listener more would share a CPU and never be steered to.
+    args.listeners ++;
+
+    sat_tcp_init (&server);
+
+    sat_status_t status = sat_tcp_open (&server, &(sat_tcp_args_t) {.type = sat_tcp_type_server, .server = args});
+    assert (sat_status_get_result (&status) == false);
+}
+
+static void test_invalid (void)
+{
+    sat_tcp_t server;
+    sat_reactor_t reactor;
+    char buffer [TEST_BUFFER_SIZE];
+
+    sat_tcp_init (&server);
+
+    // Only the async type runs on listeners.
+    sat_status_t status = sat_tcp_open (&server, &(sat_tcp_args_t)
+                                                 {
+                                                     .type = sat_tcp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = TEST_SERVICE,
+                                                         .buffer = buffer,
+                                                         .size = TEST_BUFFER_SIZE,
+                                                         .type = sat_tcp_server_type_interactive,
+                                                         .listeners = TEST_LISTENERS,
+                                                     },
+                                                 });
+    assert (sat_status_get_result (&status) == false);
+
+    // Nor can a server with reactors of its own be attached to another.
+    test_open (&server, &(sat_tcp_server_args_t)
+                        {
+                            .service = TEST_SERVICE,
+                            .size = TEST_BUFFER_SIZE,
+                            .events = {.on_data = test_on_data},
+                            .type = sat_tcp_server_type_async,
+                            .listeners = TEST_LISTENERS,
+                        });
+
+    sat_reactor_init (&reactor);
+    sat_reactor_open (&reactor, NULL);
+
+    status = sat_tcp_attach (&server, &reactor);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_tcp_close (&server);
+    sat_reactor_close (&reactor);
+}
+
+int main (int argc, char *argv[])
+{
+    test_spread ();
+    test_steer ();
+    test_invalid ();
+
+    return 0;
+}
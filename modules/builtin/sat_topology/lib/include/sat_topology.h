@@ -0,0 +1,146 @@
+/**
+ * @file sat_topology.h
+ * @brief CPU and memory topology of the host, read from sysfs
+ *
+ * This module describes how the logical CPUs of the machine relate to each
+ * other: which ones are SMT siblings of the same physical core, which cores
+ * share a last level cache, and which package (socket) and NUMA node each
+ * one belongs to. The layout is read once from /sys/devices/system; when
+ * sysfs is missing, every online CPU is reported as a core of its own on a
+ * single node.
+ *
+ * From that description the module derives placement orders for thread
+ * pools: compact keeps threads close together so they share caches, scatter
+ * spreads them over nodes, caches and cores before doubling up on SMT
+ * siblings. It also provides a sat_allocator_t that places memory on a given
+ * NUMA node, so a thread pinned to a node can keep its data there.
+ *
+ * No NUMA library is needed; memory is bound with the mbind() system call,
+ * and on kernels or hosts without NUMA support the allocator simply returns
+ * ordinary anonymous memory.
+ */
+
+#ifndef SAT_TOPOLOGY_H_
+#define SAT_TOPOLOGY_H_
+
+#include <sat_status.h>
+#include <sat_allocator.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Order in which CPUs are handed out to threads
+ */
+typedef enum
+{
+    sat_topology_policy_compact,    /**< SMT siblings first, then cores sharing a cache, then the next cache and node */
+    sat_topology_policy_scatter,    /**< One CPU per node, then per cache, then per core; SMT siblings last */
+} sat_topology_policy_t;
+
+/**
+ * @brief Description of one logical CPU
+ */
+typedef struct
+{
+    uint32_t id;                    /**< Logical CPU number, as used by sched_setaffinity() */
+    uint32_t core;                  /**< Physical core, numbered from 0 across all packages */
+    uint32_t thread;                /**< Rank among the SMT siblings of its core, 0 for the first */
+    uint32_t cache;                 /**< Last level cache, numbered from 0 */
+    uint32_t package;               /**< Physical package, as numbered by the kernel */
+    uint32_t node;                  /**< NUMA node, as numbered by the kernel */
+} sat_topology_cpu_t;
+
+/**
+ * @brief Topology structure
+ *
+ * The arrays are filled by sat_topology_open() and may be read directly.
+ */
+typedef struct
+{
+    sat_topology_cpu_t *cpus;       /**< Usable CPUs, by ascending id */
+    uint32_t cpus_amount;           /**< Number of entries in cpus */
+    uint32_t cores_amount;          /**< Number of physical cores */
+    uint32_t caches_amount;         /**< Number of last level caches */
+    uint32_t packages_amount;       /**< Number of packages */
+    uint32_t *nodes;                /**< NUMA nodes holding usable CPUs, ascending */
+    uint32_t nodes_amount;          /**< Number of entries in nodes */
+} sat_topology_t;
+
+/**
+ * @brief Configuration structure for opening a topology
+ */
+typedef struct
+{
+    const char *root;               /**< Directory holding devices/system, NULL for /sys */
+} sat_topology_args_t;
+
+/**
+ * @brief Initialize a topology
+ *
+ * @param object Pointer to the topology structure
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_topology_init (sat_topology_t *const object);
+
+/**
+ * @brief Discover the topology
+ *
+ * When reading the running system, CPUs outside the affinity mask of the
+ * calling thread are left out, since no thread it creates could run there.
+ * A different root reads a copy of the sysfs tree as is.
+ *
+ * @param object Pointer to the initialized topology
+ * @param args Pointer to the configuration, or NULL for the defaults
+ * @return Status structure indicating success or failure
+ * @see sat_topology_close()
+ */
+sat_status_t sat_topology_open (sat_topology_t *const object, const sat_topology_args_t *const args);
+
+/**
+ * @brief Look a CPU up by its number
+ *
+ * @param object Pointer to the opened topology
+ * @param id Logical CPU number
+ * @param[out] cpu Pointer to store the description, valid until the topology is closed
+ * @return Status structure indicating success or failure, failing when the CPU is not usable
+ */
+sat_status_t sat_topology_find (const sat_topology_t *const object, uint32_t id, const sat_topology_cpu_t **const cpu);
+
+/**
+ * @brief Compute a placement order
+ *
+ * Fills cpus with amount logical CPU numbers in the order threads should be
+ * placed on them. When amount exceeds the number of CPUs the order starts
+ * over, so several threads share each CPU.
+ *
+ * @param object Pointer to the opened topology
+ * @param policy Placement policy
+ * @param[out] cpus Array of amount entries
+ * @param amount Number of entries to fill
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_topology_order (const sat_topology_t *const object, sat_topology_policy_t policy, uint32_t *const cpus, uint32_t amount);
+
+/**
+ * @brief Get an allocator placing its memory on a NUMA node
+ *
+ * Every block is mapped on its own pages, so the allocator suits a few large
+ * buffers such as queue storage rather than many small objects. Memory is
+ * preferably taken from the node and falls back to others when it is full.
+ *
+ * @param object Pointer to the opened topology, which must outlive the memory
+ * @param node NUMA node number, one of nodes
+ * @param[out] allocator Pointer to store the allocator
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_topology_get_allocator (const sat_topology_t *const object, uint32_t node, sat_allocator_t *const allocator);
+
+/**
+ * @brief Close the topology
+ *
+ * @param object Pointer to the topology
+ * @return Status structure indicating success or failure
+ */
+sat_status_t sat_topology_close (sat_topology_t *const object);
+
+#endif/* SAT_TOPOLOGY_H_ */
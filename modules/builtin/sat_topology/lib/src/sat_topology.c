@@ -0,0 +1,618 @@
+#include <sat_topology.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <sched.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define SAT_TOPOLOGY_ROOT_DEFAULT       "/sys"
+#define SAT_TOPOLOGY_PATH_SIZE          256
+#define SAT_TOPOLOGY_TEXT_SIZE          4096
+#define SAT_TOPOLOGY_UNKNOWN            UINT32_MAX
+#define SAT_TOPOLOGY_NODES_MAX          1024        // bits of the mbind() node mask
+#define SAT_TOPOLOGY_MPOL_PREFERRED     1           // from linux/mempolicy.h
+
+// Sort key of a CPU, compared field by field.
+typedef struct
+{
+    uint32_t key [5];
+    uint32_t id;
+} sat_topology_rank_t;
+
+static bool sat_topology_read (const char *const path, char *const buffer, const size_t size);
+static bool sat_topology_read_number (const char *const path, uint32_t *const value);
+static uint32_t sat_topology_parse_list (const char *const text, uint8_t *const set, const uint32_t limit);
+static uint8_t *sat_topology_online (const char *const root, uint32_t *const limit);
+static void sat_topology_restrict (uint8_t *const set, const uint32_t limit);
+static uint32_t sat_topology_last_level_cache (const char *const root, const uint32_t id);
+static bool sat_topology_read_nodes (sat_topology_t *const object, const char *const root);
+static void sat_topology_number (sat_topology_t *const object, const uint32_t *const cores);
+static int sat_topology_compare (const void *const first, const void *const second);
+static int sat_topology_compare_node (const void *const first, const void *const second);
+
+static size_t sat_topology_round (const size_t size);
+static void sat_topology_bind (void *const memory, const size_t length, const uint32_t node);
+static void *sat_topology_allocate (void *const context, const size_t size);
+static void *sat_topology_reallocate (void *const context, void *const pointer, const size_t old_size, const size_t new_size);
+static void sat_topology_release (void *const context, void *const pointer, const size_t size);
+
+sat_status_t sat_topology_init (sat_topology_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    memset (object, 0, sizeof (sat_topology_t));
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_topology_open (sat_topology_t *const object, const sat_topology_args_t *const args)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_not_equals (object->cpus, NULL, "topology already open");
+
+    const char *root = (args != NULL && args->root != NULL) ? args->root : SAT_TOPOLOGY_ROOT_DEFAULT;
+    char path [SAT_TOPOLOGY_PATH_SIZE];
+    uint32_t limit = 0;
+
+    uint8_t *online = sat_topology_online (root, &limit);
+    sat_status_return_on_null (online, "memory allocation failed");
+
+    if (args == NULL || args->root == NULL)
+        sat_topology_restrict (online, limit);
+
+    for (uint32_t id = 0; id < limit; id++)
+        object->cpus_amount += online [id];
+
+    if (object->cpus_amount == 0)
+    {
+        free (online);
+        sat_status_return_on_failure ("no usable cpu");
+    }
+
+    object->cpus = (sat_topology_cpu_t *) calloc (object->cpus_amount, sizeof (sat_topology_cpu_t));
+    uint32_t *cores = (uint32_t *) calloc (object->cpus_amount, sizeof (uint32_t));
+
+    if (object->cpus == NULL || cores == NULL)
+    {
+        free (cores);
+        free (online);
+        sat_topology_close (object);
+        sat_status_return_on_failure ("memory allocation failed");
+    }
+
+    for (uint32_t id = 0, i = 0; id < limit; id++)
+    {
+        if (online [id] == 0)
+            continue;
+
+        sat_topology_cpu_t *cpu = &object->cpus [i];
+
+        cpu->id = id;
+        cpu->cache = sat_topology_last_level_cache (root, id);
+
+        // Without a topology directory every CPU stands for a core of its own.
+        snprintf (path, sizeof (path), "%s/devices/system/cpu/cpu%u/topology/core_id", root, id);
+        if (sat_topology_read_number (path, &cores [i]) == false)
+            cores [i] = id;
+
+        snprintf (path, sizeof (path), "%s/devices/system/cpu/cpu%u/topology/physical_package_id", root, id);
+        if (sat_topology_read_number (path, &cpu->package) == false)
+            cpu->package = 0;
+
+        i++;
+    }
+
+    free (online);
+
+    bool nodes = sat_topology_read_nodes (object, root);
+
+    sat_topology_number (object, cores);
+    free (cores);
+
+    if (nodes == false)
+    {
+        sat_topology_close (object);
+        sat_status_return_on_failure ("memory allocation failed");
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_topology_find (const sat_topology_t *const object, uint32_t id, const sat_topology_cpu_t **const cpu)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (cpu, "null cpu");
+    sat_status_return_on_null (object->cpus, "topology is not open");
+
+    for (uint32_t i = 0; i < object->cpus_amount; i++)
+    {
+        if (object->cpus [i].id == id)
+        {
+            *cpu = &object->cpus [i];
+            sat_status_return_on_success ();
+        }
+    }
+
+    sat_status_return_on_failure ("cpu is not usable");
+}
+
+sat_status_t sat_topology_order (const sat_topology_t *const object, sat_topology_policy_t policy, uint32_t *const cpus, uint32_t amount)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (cpus, "null cpus");
+    sat_status_return_on_null (object->cpus, "topology is not open");
+    sat_status_return_on_false ((policy == sat_topology_policy_compact || policy == sat_topology_policy_scatter), "invalid policy");
+
+    sat_topology_rank_t *ranks = (sat_topology_rank_t *) calloc (object->cpus_amount, sizeof (sat_topology_rank_t));
+    sat_status_return_on_null (ranks, "memory allocation failed");
+
+    for (uint32_t i = 0; i < object->cpus_amount; i++)
+    {
+        const sat_topology_cpu_t *cpu = &object->cpus [i];
+        sat_topology_rank_t *rank = &ranks [i];
+
+        rank->id = cpu->id;
+
+        if (policy == sat_topology_policy_compact)
+        {
+            rank->key [0] = cpu->node;
+            rank->key [1] = cpu->package;
+            rank->key [2] = cpu->cache;
+            rank->key [3] = cpu->core;
+            rank->key [4] = cpu->thread;
+            continue;
+        }
+
+        // Scatter: rank of the core within its cache, of the cache within its
+        // node, and of the node. Each core is counted through its thread 0.
+        uint32_t core_rank = 0;
+        uint32_t cache_rank = 0;
+        uint32_t node_rank = 0;
+
+        for (uint32_t j = 0; j < object->cpus_amount; j++)
+        {
+            const sat_topology_cpu_t *other = &object->cpus [j];
+
+            if (other->thread == 0 && other->cache == cpu->cache && other->core < cpu->core)
+                core_rank ++;
+        }
+
+        for (uint32_t j = 0; j < object->nodes_amount && object->nodes [j] != cpu->node; j++)
+            node_rank ++;
+
+        for (uint32_t cache = 0; cache < cpu->cache; cache++)
+        {
+            for (uint32_t j = 0; j < object->cpus_amount; j++)
+            {
+                if (object->cpus [j].cache == cache && object->cpus [j].node == cpu->node)
+                {
+                    cache_rank ++;
+                    break;
+                }
+            }
+        }
+
+        rank->key [0] = cpu->thread;
+        rank->key [1] = core_rank;
+        rank->key [2] = cache_rank;
+        rank->key [3] = node_rank;
+        rank->key [4] = cpu->id;
+    }
+
+    qsort (ranks, object->cpus_amount, sizeof (sat_topology_rank_t), sat_topology_compare);
+
+    for (uint32_t i = 0; i < amount; i++)
+        cpus [i] = ranks [i % object->cpus_amount].id;
+
+    free (ranks);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_topology_get_allocator (const sat_topology_t *const object, uint32_t node, sat_allocator_t *const allocator)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (allocator, "null allocator");
+    sat_status_return_on_null (object->nodes, "topology is not open");
+
+    for (uint32_t i = 0; i < object->nodes_amount; i++)
+    {
+        if (object->nodes [i] == node)
+        {
+            *allocator = (sat_allocator_t)
+            {
+                .context = &object->nodes [i],
+                .allocate = sat_topology_allocate,
+                .reallocate = sat_topology_reallocate,
+                .release = sat_topology_release,
+            };
+
+            sat_status_return_on_success ();
+        }
+    }
+
+    sat_status_return_on_failure ("unknown node");
+}
+
+sat_status_t sat_topology_close (sat_topology_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+
+    free (object->cpus);
+    free (object->nodes);
+
+    memset (object, 0, sizeof (sat_topology_t));
+
+    sat_status_return_on_success ();
+}
+
+static bool sat_topology_read (const char *const path, char *const buffer, const size_t size)
+{
+    FILE *file = fopen (path, "r");
+
+    if (file == NULL)
+        return false;
+
+    size_t length = fread (buffer, 1, size - 1, file);
+    buffer [length] = 0;
+
+    fclose (file);
+
+    return length > 0;
+}
+
+static bool sat_topology_read_number (const char *const path, uint32_t *const value)
+{
+    char text [32];
+
+    if (sat_topology_read (path, text, sizeof (text)) == false || isdigit ((unsigned char) text [0]) == 0)
+        return false;
+
+    *value = (uint32_t) strtoul (text, NULL, 10);
+
+    return true;
+}
+
+// Parses a sysfs list such as "0-3,8,10-11", marking the members below limit
+// in set when one is given. Returns the highest member plus one.
+static uint32_t sat_topology_parse_list (const char *const text, uint8_t *const set, const uint32_t limit)
+{
+    const char *cursor = text;
+    uint32_t end = 0;
+
+    while (isdigit ((unsigned char) *cursor))
+    {
+        char *next;
+        uint32_t first = (uint32_t) strtoul (cursor, &next, 10);
+        uint32_t last = first;
+
+        if (*next == '-')
+            last = (uint32_t) strtoul (next + 1, &next, 10);
+
+        for (uint32_t id = first; set != NULL && id <= last && id < limit; id++)
+            set [id] = 1;
+
+        if (last + 1 > end)
+            end = last + 1;
+
+        cursor = *next == ',' ? next + 1 : next;
+    }
+
+    return end;
+}
+
+static uint8_t *sat_topology_online (const char *const root, uint32_t *const limit)
+{
+    char path [SAT_TOPOLOGY_PATH_SIZE];
+    char text [SAT_TOPOLOGY_TEXT_SIZE];
+    uint8_t *set;
+
+    snprintf (path, sizeof (path), "%s/devices/system/cpu/online", root);
+
+    if (sat_topology_read (path, text, sizeof (text)) == true && (*limit = sat_topology_parse_list (text, NULL, 0)) > 0)
+    {
+        set = (uint8_t *) calloc (*limit, sizeof (uint8_t));
+        if (set != NULL)
+            sat_topology_parse_list (text, set, *limit);
+
+        return set;
+    }
+
+    long amount = sysconf (_SC_NPROCESSORS_ONLN);
+
+    *limit = amount > 0 ? (uint32_t) amount : 1;
+
+    set = (uint8_t *) calloc (*limit, sizeof (uint8_t));
+    if (set != NULL)
+        memset (set, 1, *limit);
+
+    return set;
+}
+
+static void sat_topology_restrict (uint8_t *const set, const uint32_t limit)
+{
+    // The kernel refuses masks smaller than its own, which may exceed the online CPUs.
+    size_t count = limit > CPU_SETSIZE ? limit : CPU_SETSIZE;
+    size_t size = CPU_ALLOC_SIZE (count);
+    cpu_set_t *mask = CPU_ALLOC (count);
+
+    if (mask == NULL)
+        return;
+
+    if (sched_getaffinity (0, size, mask) == 0)
+    {
+        for (uint32_t id = 0; id < limit; id++)
+        {
+            if (CPU_ISSET_S (id, size, mask) == 0)
+                set [id] = 0;
+        }
+    }
+
+    CPU_FREE (mask);
+}
+
+// Identifies the last level cache of a CPU by the lowest CPU sharing it.
+static uint32_t sat_topology_last_level_cache (const char *const root, const uint32_t id)
+{
+    char path [SAT_TOPOLOGY_PATH_SIZE];
+    char text [SAT_TOPOLOGY_TEXT_SIZE];
+    uint32_t level_max = 0;
+    uint32_t cache = SAT_TOPOLOGY_UNKNOWN;
+
+    for (uint32_t index = 0; ; index++)
+    {
+        uint32_t level;
+
+        snprintf (path, sizeof (path), "%s/devices/system/cpu/cpu%u/cache/index%u/level", root, id, index);
+        if (sat_topology_read_number (path, &level) == false)
+            break;
+
+        snprintf (path, sizeof (path), "%s/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", root, id, index);
+        if (level < level_max || sat_topology_read (path, text, sizeof (text)) == false || isdigit ((unsigned char) text [0]) == 0)
+            continue;
+
+        level_max = level;
+        cache = (uint32_t) strtoul (text, NULL, 10);
+    }
+
+    return cache;
+}
+
+static bool sat_topology_read_nodes (sat_topology_t *const object, const char *const root)
+{
+    char path [SAT_TOPOLOGY_PATH_SIZE];
+    char text [SAT_TOPOLOGY_TEXT_SIZE];
+    uint32_t capacity = 0;
+
+    snprintf (path, sizeof (path), "%s/devices/system/node", root);
+
+    DIR *directory = opendir (path);
+    struct dirent *entry = NULL;
+
+    while (directory != NULL && (entry = readdir (directory)) != NULL)
+    {
+        if (strncmp (entry->d_name, "node", 4) != 0 || isdigit ((unsigned char) entry->d_name [4]) == 0)
+            continue;
+
+        uint32_t node = (uint32_t) strtoul (entry->d_name + 4, NULL, 10);
+        bool used = false;
+
+        snprintf (path, sizeof (path), "%s/devices/system/node/node%u/cpulist", root, node);
+        if (sat_topology_read (path, text, sizeof (text)) == false)
+            continue;
+
+        uint32_t limit = sat_topology_parse_list (text, NULL, 0);
+        uint8_t *set = (uint8_t *) calloc (limit > 0 ? limit : 1, sizeof (uint8_t));
+
+        if (set == NULL)
+            break;
+
+        sat_topology_parse_list (text, set, limit);
+
+        for (uint32_t i = 0; i < object->cpus_amount; i++)
+        {
+            if (object->cpus [i].id < limit && set [object->cpus [i].id] == 1)
+            {
+                object->cpus [i].node = node;
+                used = true;
+            }
+        }
+
+        free (set);
+
+        // Nodes holding only memory, or only CPUs this process may not use, are left out.
+        if (used == false)
+            continue;
+
+        if (object->nodes_amount == capacity)
+        {
+            capacity = capacity > 0 ? capacity * 2 : 4;
+
+            uint32_t *nodes = (uint32_t *) realloc (object->nodes, capacity * sizeof (uint32_t));
+            if (nodes == NULL)
+                break;
+
+            object->nodes = nodes;
+        }
+
+        object->nodes [object->nodes_amount ++] = node;
+    }
+
+    if (directory != NULL)
+        closedir (directory);
+
+    if (object->nodes_amount == 0)
+    {
+        // No NUMA information: a single node 0 holds everything.
+        free (object->nodes);
+
+        object->nodes = (uint32_t *) calloc (1, sizeof (uint32_t));
+        if (object->nodes == NULL)
+            return false;
+
+        object->nodes_amount = 1;
+
+        for (uint32_t i = 0; i < object->cpus_amount; i++)
+            object->cpus [i].node = 0;
+
+        return true;
+    }
+
+    qsort (object->nodes, object->nodes_amount, sizeof (uint32_t), sat_topology_compare_node);
+
+    return entry == NULL;
+}
+
+// Replaces the kernel core numbers, which repeat across packages, and the
+// cache identifiers by consecutive indexes in order of first appearance.
+static void sat_topology_number (sat_topology_t *const object, const uint32_t *const cores)
+{
+    for (uint32_t i = 0; i < object->cpus_amount; i++)
+    {
+        sat_topology_cpu_t *cpu = &object->cpus [i];
+        uint32_t j;
+
+        cpu->thread = 0;
+
+        for (j = 0; j < i; j++)
+        {
+            if (object->cpus [j].package == cpu->package && cores [j] == cores [i])
+            {
+                cpu->core = object->cpus [j].core;
+                cpu->thread ++;
+            }
+        }
+
+        if (cpu->thread == 0)
+            cpu->core = object->cores_amount ++;
+
+        for (j = 0; j < i && object->cpus [j].package != cpu->package; j++)
+            ;
+
+        if (j == i)
+            object->packages_amount ++;
+    }
+
+    // Without cache information, a package stands for its last level cache.
+    uint32_t *keys = (uint32_t *) calloc (object->cpus_amount, sizeof (uint32_t));
+
+    for (uint32_t i = 0; i < object->cpus_amount && keys != NULL; i++)
+    {
+        keys [i] = object->cpus [i].cache;
+
+        if (keys [i] == SAT_TOPOLOGY_UNKNOWN)
+        {
+            uint32_t j;
+
+            for (j = 0; object->cpus [j].package != object->cpus [i].package; j++)
+                ;
+
+            keys [i] = object->cpus [j].id;
+        }
+    }
+
+    for (uint32_t i = 0; i < object->cpus_amount; i++)
+    {
+        uint32_t j;
+
+        for (j = 0; keys != NULL && j < i && keys [j] != keys [i]; j++)
+            ;
+
+        object->cpus [i].cache = (keys == NULL || j == i) ? object->caches_amount ++ : object->cpus [j].cache;
+    }
+
+    free (keys);
+}
+
+static int sat_topology_compare (const void *const first, const void *const second)
+{
+    const sat_topology_rank_t *a = (const sat_topology_rank_t *) first;
+    const sat_topology_rank_t *b = (const sat_topology_rank_t *) second;
+
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        if (a->key [i] != b->key [i])
+            return a->key [i] < b->key [i] ? -1 : 1;
+    }
+
+    return a->id < b->id ? -1 : a->id > b->id;
+}
+
+static int sat_topology_compare_node (const void *const first, const void *const second)
+{
+    uint32_t a = *(const uint32_t *) first;
+    uint32_t b = *(const uint32_t *) second;
+
+    return a < b ? -1 : a > b;
+}
+
+static size_t sat_topology_round (const size_t size)
+{
+    size_t page = (size_t) sysconf (_SC_PAGESIZE);
+
+    return size > 0 ? (size + page - 1) & ~(page - 1) : page;
+}
+
+static void sat_topology_bind (void *const memory, const size_t length, const uint32_t node)
+{
+#if defined (SYS_mbind)
+    const uint32_t bits = 8 * sizeof (unsigned long);
+    unsigned long mask [SAT_TOPOLOGY_NODES_MAX / (8 * sizeof (unsigned long))] = {0};
+
+    if (node >= SAT_TOPOLOGY_NODES_MAX)
+        return;
+
+    mask [node / bits] = 1UL << (node % bits);
+
+    // Preferred rather than bound: a full node spills over instead of failing.
+    // Without NUMA support the call fails and the memory stays where it lands.
+    syscall (SYS_mbind, memory, length, SAT_TOPOLOGY_MPOL_PREFERRED, mask, SAT_TOPOLOGY_NODES_MAX + 1, 0);
+#else
+    (void) memory;
+    (void) length;
+    (void) node;
+#endif
+}
+
+static void *sat_topology_allocate (void *const context, const size_t size)
+{
+    size_t length = sat_topology_round (size);
+
+    void *memory = mmap (NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        return NULL;
+
+    // Pages are placed when first touched, so binding before use is enough.
+    sat_topology_bind (memory, length, *(const uint32_t *) context);
+
+    return memory;
+}
+
+static void *sat_topology_reallocate (void *const context, void *const pointer, const size_t old_size, const size_t new_size)
+{
+    if (pointer == NULL)
+        return sat_topology_allocate (context, new_size);
+
+    size_t old_length = sat_topology_round (old_size);
+    size_t new_length = sat_topology_round (new_size);
+
+    if (old_length == new_length)
+        return pointer;
+
+    // The policy belongs to the mapping, so the grown part stays on the node.
+    void *memory = mremap (pointer, old_length, new_length, MREMAP_MAYMOVE);
+
+    return memory != MAP_FAILED ? memory : NULL;
+}
+
+static void sat_topology_release (void *const context, void *const pointer, const size_t size)
+{
+    (void) context;
+
+    if (pointer != NULL)
+        munmap (pointer, sat_topology_round (size));
+}
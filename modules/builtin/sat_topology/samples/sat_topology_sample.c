@@ -0,0 +1,58 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void print_order (const sat_topology_t *const topology, sat_topology_policy_t policy, const char *const name)
+{
+    uint32_t *order = (uint32_t *) calloc (topology->cpus_amount, sizeof (uint32_t));
+
+    if (order == NULL)
+        return;
+
+    sat_topology_order (topology, policy, order, topology->cpus_amount);
+
+    printf ("%-8s", name);
+
+    for (uint32_t i = 0; i < topology->cpus_amount; i++)
+        printf (" %u", order [i]);
+
+    printf ("\n");
+
+    free (order);
+}
+
+int main (int argc, char **argv)
+{
+    sat_topology_t topology;
+
+    sat_topology_init (&topology);
+
+    // An optional argument reads a copy of a sysfs tree instead of /sys.
+    sat_status_t status = sat_topology_open (&topology, &(sat_topology_args_t) {.root = argc > 1 ? argv [1] : NULL});
+    if (sat_status_get_result (&status) == false)
+    {
+        fprintf (stderr, "%s\n", sat_status_get_motive (&status));
+        return 1;
+    }
+
+    printf ("%u cpus, %u cores, %u last level caches, %u packages, %u nodes\n\n",
+            topology.cpus_amount, topology.cores_amount, topology.caches_amount, topology.packages_amount, topology.nodes_amount);
+
+    printf ("%5s %5s %7s %6s %8s %5s\n", "cpu", "core", "thread", "cache", "package", "node");
+
+    for (uint32_t i = 0; i < topology.cpus_amount; i++)
+    {
+        const sat_topology_cpu_t *cpu = &topology.cpus [i];
+
+        printf ("%5u %5u %7u %6u %8u %5u\n", cpu->id, cpu->core, cpu->thread, cpu->cache, cpu->package, cpu->node);
+    }
+
+    printf ("\nplacement order\n");
+
+    print_order (&topology, sat_topology_policy_compact, "compact");
+    print_order (&topology, sat_topology_policy_scatter, "scatter");
+
+    sat_topology_close (&topology);
+
+    return 0;
+}
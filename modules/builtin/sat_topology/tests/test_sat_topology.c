@@ -0,0 +1,277 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <sys/stat.h>
+
+typedef struct
+{
+    const char *path;
+    const char *content;
+} test_file_t;
+
+// Two packages of two cores with two SMT threads each, one node and one
+// last level cache per package, numbered the way Linux usually does: the
+// first thread of every core, then their siblings. Node 2 only has memory.
+static const test_file_t test_two_sockets [] =
+{
+    {"devices/system/cpu/online", "0-7\n"},
+    {"devices/system/cpu/cpu0/topology/core_id", "0\n"},
+    {"devices/system/cpu/cpu1/topology/core_id", "1\n"},
+    {"devices/system/cpu/cpu2/topology/core_id", "0\n"},
+    {"devices/system/cpu/cpu3/topology/core_id", "1\n"},
+    {"devices/system/cpu/cpu4/topology/core_id", "0\n"},
+    {"devices/system/cpu/cpu5/topology/core_id", "1\n"},
+    {"devices/system/cpu/cpu6/topology/core_id", "0\n"},
+    {"devices/system/cpu/cpu7/topology/core_id", "1\n"},
+    {"devices/system/cpu/cpu0/topology/physical_package_id", "0\n"},
+    {"devices/system/cpu/cpu1/topology/physical_package_id", "0\n"},
+    {"devices/system/cpu/cpu2/topology/physical_package_id", "1\n"},
+    {"devices/system/cpu/cpu3/topology/physical_package_id", "1\n"},
+    {"devices/system/cpu/cpu4/topology/physical_package_id", "0\n"},
+    {"devices/system/cpu/cpu5/topology/physical_package_id", "0\n"},
+    {"devices/system/cpu/cpu6/topology/physical_package_id", "1\n"},
+    {"devices/system/cpu/cpu7/topology/physical_package_id", "1\n"},
+    {"devices/system/cpu/cpu0/cache/index0/level", "1\n"},
+    {"devices/system/cpu/cpu0/cache/index0/shared_cpu_list", "0,4\n"},
+    {"devices/system/cpu/cpu0/cache/index1/level", "3\n"},
+    {"devices/system/cpu/cpu0/cache/index1/shared_cpu_list", "0-1,4-5\n"},
+    {"devices/system/cpu/cpu1/cache/index0/level", "3\n"},
+    {"devices/system/cpu/cpu1/cache/index0/shared_cpu_list", "0-1,4-5\n"},
+    {"devices/system/cpu/cpu2/cache/index0/level", "3\n"},
+    {"devices/system/cpu/cpu2/cache/index0/shared_cpu_list", "2-3,6-7\n"},
+    {"devices/system/cpu/cpu3/cache/index0/level", "3\n"},
+    {"devices/system/cpu/cpu3/cache/index0/shared_cpu_list", "2-3,6-7\n"},
+    {"devices/system/cpu/cpu4/cache/index0/level", "3\n"},
+    {"devices/system/cpu/cpu4/cache/index0/shared_cpu_list", "0-1,4-5\n"},
+    {"devices/system/cpu/cpu5/cache/index0/level", "3\n"},
+    {"devices/system/cpu/cpu5/cache/index0/shared_cpu_list", "0-1,4-5\n"},
+    {"devices/system/cpu/cpu6/cache/index0/level", "3\n"},
+    {"devices/system/cpu/cpu6/cache/index0/shared_cpu_list", "2-3,6-7\n"},
+    {"devices/system/cpu/cpu7/cache/index0/level", "3\n"},
+    {"devices/system/cpu/cpu7/cache/index0/shared_cpu_list", "2-3,6-7\n"},
+    {"devices/system/node/node1/cpulist", "2-3,6-7\n"},
+    {"devices/system/node/node0/cpulist", "0-1,4-5\n"},
+    {"devices/system/node/node2/cpulist", "\n"},
+    {NULL, NULL},
+};
+
+// Only the list of online CPUs, as in some containers.
+static const test_file_t test_bare [] =
+{
+    {"devices/system/cpu/online", "0-2,5\n"},
+    {NULL, NULL},
+};
+
+static void test_create (char *const root, const test_file_t *const files)
+{
+    char path [512];
+
+    strcpy (root, "/tmp/test_sat_topology_XXXXXX");
+    assert (mkdtemp (root) != NULL);
+
+    for (const test_file_t *file = files; file->path != NULL; file++)
+    {
+        snprintf (path, sizeof (path), "%s/%s", root, file->path);
+
+        for (char *slash = strchr (path + strlen (root) + 1, '/'); slash != NULL; slash = strchr (slash + 1, '/'))
+        {
+            *slash = 0;
+            mkdir (path, 0700);
+            *slash = '/';
+        }
+
+        FILE *stream = fopen (path, "w");
+        assert (stream != NULL);
+
+        fputs (file->content, stream);
+        fclose (stream);
+    }
+}
+
+static int test_remove_entry (const char *path, const struct stat *info, int flag, struct FTW *ftw)
+{
+    (void) info;
+    (void) flag;
+    (void) ftw;
+
+    return remove (path);
+}
+
+static void test_remove (const char *const root)
+{
+    assert (nftw (root, test_remove_entry, 16, FTW_DEPTH | FTW_PHYS) == 0);
+}
+
+static void test_two_socket_layout (void)
+{
+    sat_topology_t topology;
+    char root [64];
+
+    test_create (root, test_two_sockets);
+
+    sat_status_t status = sat_topology_init (&topology);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_topology_open (&topology, &(sat_topology_args_t) {.root = root});
+    assert (sat_status_get_result (&status) == true);
+
+    assert (topology.cpus_amount == 8);
+    assert (topology.cores_amount == 4);
+    assert (topology.caches_amount == 2);
+    assert (topology.packages_amount == 2);
+    assert (topology.nodes_amount == 2);
+    assert (topology.nodes [0] == 0 && topology.nodes [1] == 1);
+
+    const sat_topology_cpu_t *cpu;
+
+    status = sat_topology_find (&topology, 6, &cpu);
+    assert (sat_status_get_result (&status) == true);
+    assert (cpu->id == 6);
+    assert (cpu->package == 1);
+    assert (cpu->node == 1);
+    assert (cpu->thread == 1);
+    assert (cpu->core == topology.cpus [2].core);
+    assert (cpu->cache == topology.cpus [3].cache);
+    assert (cpu->cache != topology.cpus [0].cache);
+
+    status = sat_topology_find (&topology, 8, &cpu);
+    assert (sat_status_get_result (&status) == false);
+
+    // Compact fills a core, then its neighbours on the same node.
+    uint32_t order [10];
+    const uint32_t compact [] = {0, 4, 1, 5, 2, 6, 3, 7};
+
+    status = sat_topology_order (&topology, sat_topology_policy_compact, order, 8);
+    assert (sat_status_get_result (&status) == true);
+    assert (memcmp (order, compact, sizeof (compact)) == 0);
+
+    // Scatter alternates nodes, then cores, and leaves the siblings for last.
+    const uint32_t scatter [] = {0, 2, 1, 3, 4, 6, 5, 7, 0, 2};
+
+    status = sat_topology_order (&topology, sat_topology_policy_scatter, order, 10);
+    assert (sat_status_get_result (&status) == true);
+    assert (memcmp (order, scatter, sizeof (scatter)) == 0);
+
+    status = sat_topology_order (&topology, (sat_topology_policy_t) 7, order, 8);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_topology_close (&topology);
+    assert (sat_status_get_result (&status) == true);
+
+    test_remove (root);
+}
+
+static void test_bare_layout (void)
+{
+    sat_topology_t topology;
+    char root [64];
+
+    test_create (root, test_bare);
+
+    sat_topology_init (&topology);
+
+    sat_status_t status = sat_topology_open (&topology, &(sat_topology_args_t) {.root = root});
+    assert (sat_status_get_result (&status) == true);
+
+    assert (topology.cpus_amount == 4);
+    assert (topology.cpus [3].id == 5);
+    assert (topology.cores_amount == 4);
+    assert (topology.caches_amount == 1);
+    assert (topology.packages_amount == 1);
+    assert (topology.nodes_amount == 1 && topology.nodes [0] == 0);
+
+    sat_topology_close (&topology);
+
+    test_remove (root);
+}
+
+static void test_running_system (void)
+{
+    sat_topology_t topology;
+    const sat_topology_cpu_t *cpu;
+
+    sat_topology_init (&topology);
+
+    sat_status_t status = sat_topology_open (&topology, NULL);
+    assert (sat_status_get_result (&status) == true);
+
+    assert (topology.cpus_amount > 0);
+    assert (topology.cores_amount > 0 && topology.cores_amount <= topology.cpus_amount);
+    assert (topology.nodes_amount > 0);
+
+    status = sat_topology_find (&topology, topology.cpus [0].id, &cpu);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_topology_open (&topology, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_topology_close (&topology);
+}
+
+static void test_allocator (void)
+{
+    sat_topology_t topology;
+    sat_allocator_t allocator;
+
+    sat_topology_init (&topology);
+    sat_topology_open (&topology, NULL);
+
+    sat_status_t status = sat_topology_get_allocator (&topology, UINT32_MAX, &allocator);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_topology_get_allocator (&topology, topology.nodes [0], &allocator);
+    assert (sat_status_get_result (&status) == true);
+
+    uint8_t *memory = (uint8_t *) sat_allocator_allocate_zeroed (&allocator, 100);
+    assert (memory != NULL);
+    assert (memory [99] == 0);
+
+    memset (memory, 7, 100);
+
+    // Grows in place or moves, keeping the contents either way.
+    memory = (uint8_t *) sat_allocator_reallocate (&allocator, memory, 100, 3 * 4096 + 1);
+    assert (memory != NULL);
+    assert (memory [0] == 7 && memory [99] == 7);
+
+    memory [3 * 4096] = 1;
+
+    sat_allocator_release (&allocator, memory, 3 * 4096 + 1);
+
+    // Containers take it like any other allocator.
+    sat_queue_t *queue;
+
+    status = sat_queue_create_with_args (&queue, &(sat_queue_args_t)
+                                                 {
+                                                     .object_size = sizeof (uint64_t),
+                                                     .mode = sat_queue_mode_ring,
+                                                     .allocator = allocator,
+                                                 });
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint64_t i = 0; i < 10000; i++)
+        sat_queue_enqueue (queue, &i);
+
+    for (uint64_t i = 0, value; i < 10000; i++)
+    {
+        sat_queue_dequeue (queue, &value);
+        assert (value == i);
+    }
+
+    sat_queue_destroy (queue);
+
+    sat_topology_close (&topology);
+}
+
+int main (int argc, char *argv[])
+{
+    test_two_socket_layout ();
+    test_bare_layout ();
+    test_running_system ();
+    test_allocator ();
+
+    return 0;
+}
@@ -4,11 +4,15 @@
 // #include <sat_udp.h>
 #include <sat_udp_types.h>
 #include <sat_status.h>
+#include <sat_reactor.h>
 
 sat_status_t sat_udp_server_open (sat_udp_server_t **const object, const sat_udp_server_args_t *const args);
 sat_status_t sat_udp_server_run (sat_udp_server_t *const object);
 sat_status_t sat_udp_server_get_port (sat_udp_server_t *const object, uint16_t *const port);
 int sat_udp_server_get_socket (sat_udp_server_t *const object);
+sat_status_t sat_udp_server_attach (sat_udp_server_t *const object, sat_reactor_t *const reactor);
+sat_status_t sat_udp_server_detach (sat_udp_server_t *const object);
+void sat_udp_server_destroy (sat_udp_server_t *const object);
 
 #endif/* SAT_UDP_SERVER_H_ */
 
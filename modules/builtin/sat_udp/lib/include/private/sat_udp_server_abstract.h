@@ -9,6 +9,7 @@
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <stdbool.h>
 
 typedef struct 
 {
@@ -28,6 +29,8 @@ typedef struct
 
     sat_udp_server_type_t type;
 
+    bool reuse_port;                // one of several listeners bound to the same port
+
 } sat_udp_server_abstract_t;
 
 sat_status_t sat_udp_server_abstract_open (sat_udp_server_abstract_t *const object, const sat_udp_server_args_t *const args);
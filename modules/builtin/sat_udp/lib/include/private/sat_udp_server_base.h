@@ -9,6 +9,7 @@ typedef struct
     void *object;
     sat_status_t (*open) (void *const object, const sat_udp_server_args_t *const args);
     sat_status_t (*run) (void *const object);
+    sat_status_t (*receive) (void *const object);   // handles what is already waiting, NULL if unsupported
     int (*get_socket) (const void *const object);
 
 } sat_udp_server_base_t;
@@ -0,0 +1,13 @@
+#ifndef SAT_UDP_SERVER_LISTENERS_H_
+#define SAT_UDP_SERVER_LISTENERS_H_
+
+#include <sat_udp_types.h>
+#include <sat_status.h>
+
+typedef struct sat_udp_server_listeners_t sat_udp_server_listeners_t;
+
+sat_status_t sat_udp_server_listeners_open (sat_udp_server_listeners_t **const object, const sat_udp_server_args_t *const args);
+int sat_udp_server_listeners_get_socket (const sat_udp_server_listeners_t *const object);
+void sat_udp_server_listeners_destroy (sat_udp_server_listeners_t *const object);
+
+#endif/* SAT_UDP_SERVER_LISTENERS_H_ */
@@ -13,6 +13,7 @@
 #define SAT_UDP_H_
 
 #include <sat_status.h>
+#include <sat_reactor.h>
 #include <stdint.h>
 #include <sat_udp_types.h>
 
@@ -96,9 +97,27 @@ sat_status_t sat_udp_open (sat_udp_t *const object, const sat_udp_args_t *const
  * @warning Only valid for server type with sat_udp_server_type_async
  * @note For interactive servers, use sat_udp_receive() instead
  * @note Server runs in background thread until sat_udp_close() is called
+ * @note With listeners, their threads receive and this only waits 100 ms
  */
 sat_status_t sat_udp_run (sat_udp_t *const object);
 
+/**
+ * @brief Run an asynchronous UDP server on a reactor
+ * 
+ * Instead of calling sat_udp_run() in a loop, the server socket is registered
+ * with the reactor and the on_receive and on_send events are called on the
+ * reactor thread whenever datagrams arrive, up to 64 datagrams per wakeup.
+ * 
+ * @param[in,out] object Pointer to an opened UDP server object
+ * @param[in] reactor Pointer to an opened reactor
+ * @return sat_status_t indicating success or failure
+ * 
+ * @warning Only valid for server type with sat_udp_server_type_async
+ * @warning Fails for servers with listeners, which run reactors of their own
+ * @note sat_udp_close() removes the socket from the reactor
+ */
+sat_status_t sat_udp_attach (sat_udp_t *const object, sat_reactor_t *const reactor);
+
 /**
  * @brief Send data via UDP
  * 
@@ -12,6 +12,7 @@
 #define SAT_UDP_TYPES_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @brief Maximum hostname buffer size
@@ -111,6 +112,9 @@ typedef struct
 
     sat_udp_server_mode_t mode;      /**< Communication mode (unicast or multicast) */
 
+    uint16_t listeners;              /**< Async: SO_REUSEPORT sockets on the port, each served by a pinned thread (0 or 1 for one) */
+    bool steer_by_cpu;               /**< Listeners: a datagram goes to the listener of the CPU that received it */
+
 } sat_udp_server_args_t;
 
 /**
@@ -216,15 +216,40 @@ sat_status_t sat_udp_receive (const sat_udp_t *const object, char *const data, u
     return status;
 }
 
+sat_status_t sat_udp_attach (sat_udp_t *const object, sat_reactor_t *const reactor)
+{
+    sat_status_t status;
+
+    do
+    {
+        if (object == NULL || reactor == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat udp attach error: null object or reactor");
+            break;
+        }
+
+        if (object->type != sat_udp_type_server)
+        {
+            status = sat_status_set (&status, false, __func__, "sat udp attach error: invalid type");
+            break;
+        }
+
+        status = sat_udp_server_attach (object->server, reactor);
+
+    } while (false);
+
+    return status;
+}
+
 sat_status_t sat_udp_close (sat_udp_t *object)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat udp close error");
 
     if (object != NULL)
     {
-        int socket = sat_udp_get_socket (object);
-        
-        close (socket);
+        // The socket leaves the reactor before it is closed.
+        if (object->type == sat_udp_type_server)
+            sat_udp_server_detach (object->server);
 
         sat_udp_type_destroy (object);
 
@@ -271,9 +296,12 @@ static int sat_udp_get_socket (const sat_udp_t *const object)
 static void sat_udp_type_destroy (sat_udp_t *object)
 {
     if (object->type == sat_udp_type_server)
-        free (object->server);
+        sat_udp_server_destroy (object->server);
     else 
+    {
+        close (sat_udp_client_get_socket (object->client));
         free (object->client);
+    }
 }
 
 static sat_status_t sat_udp_type_open (sat_udp_t *const object, const sat_udp_args_t *const args)
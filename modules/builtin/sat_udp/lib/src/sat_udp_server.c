@@ -2,6 +2,7 @@
 #include <sat_udp_server_base.h>
 #include <sat_udp_server_interactive.h>
 #include <sat_udp_server_async.h>
+#include <sat_udp_server_listeners.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,9 +17,12 @@
 struct sat_udp_server_t
 {
     sat_udp_server_base_t *base;
+    sat_reactor_t *reactor;
+    sat_udp_server_listeners_t *listeners;  // async type on several threads, each with its own socket
 };
 
 static sat_status_t sat_udp_server_select_type (sat_udp_server_t *const object, sat_udp_server_type_t type);
+static void sat_udp_server_on_readable (int fd, uint32_t events, void *data);
 
 sat_status_t sat_udp_server_open (sat_udp_server_t **const object, const sat_udp_server_args_t *const args)
 {
@@ -33,6 +37,20 @@ sat_status_t sat_udp_server_open (sat_udp_server_t **const object, const sat_udp
             break;
         }
 
+        // The listeners bind sockets of their own and serve them from their threads.
+        if (args->listeners > 1)
+        {
+            status = sat_udp_server_listeners_open (&__object->listeners, args);
+            if (sat_status_get_result (&status) == false)
+            {
+                free (__object);
+                break;
+            }
+
+            *object = __object;
+            break;
+        }
+
         status = sat_udp_server_select_type (__object, args->type);
         if (sat_status_get_result (&status) == false)
         {
@@ -58,14 +76,22 @@ sat_status_t sat_udp_server_run (sat_udp_server_t *const object)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "run error");
 
-    status = object->base->run (object->base);
+    // The listener threads do the work; waiting here keeps the caller's loop from spinning.
+    if (object->listeners != NULL)
+    {
+        usleep (100 * 1000);
+        sat_status_success (&status);
+    }
+
+    else
+        status = object->base->run (object->base);
 
     return status;
 }
 
 int sat_udp_server_get_socket (sat_udp_server_t *object)
 {
-    return object->base->get_socket (object->base);
+    return object->listeners != NULL ? sat_udp_server_listeners_get_socket (object->listeners) : object->base->get_socket (object->base);
 }
 
 sat_status_t sat_udp_server_get_port (sat_udp_server_t *object, uint16_t *port)
@@ -89,6 +115,73 @@ sat_status_t sat_udp_server_get_port (sat_udp_server_t *object, uint16_t *port)
     return status;
 }
 
+sat_status_t sat_udp_server_attach (sat_udp_server_t *const object, sat_reactor_t *const reactor)
+{
+    sat_status_t status;
+
+    do
+    {
+        if (object->listeners != NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat udp server attach error: served by its listeners");
+            break;
+        }
+
+        if (object->base->receive == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat udp server attach error: only async servers can be attached");
+            break;
+        }
+
+        if (object->reactor != NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat udp server attach error: already attached");
+            break;
+        }
+
+        status = sat_reactor_add (reactor, sat_udp_server_get_socket (object), sat_reactor_event_read, sat_udp_server_on_readable, object);
+        sat_status_break_on_error (status);
+
+        object->reactor = reactor;
+
+    } while (false);
+
+    return status;
+}
+
+sat_status_t sat_udp_server_detach (sat_udp_server_t *const object)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat udp server detach error: not attached");
+
+    if (object->reactor != NULL)
+    {
+        status = sat_reactor_remove (object->reactor, sat_udp_server_get_socket (object));
+        object->reactor = NULL;
+    }
+
+    return status;
+}
+
+void sat_udp_server_destroy (sat_udp_server_t *const object)
+{
+    if (object->listeners != NULL)
+        sat_udp_server_listeners_destroy (object->listeners);
+    else
+        close (sat_udp_server_get_socket (object));
+
+    free (object);
+}
+
+static void sat_udp_server_on_readable (int fd, uint32_t events, void *data)
+{
+    sat_udp_server_t *object = (sat_udp_server_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    object->base->receive (object->base);
+}
+
 static sat_status_t sat_udp_server_select_type (sat_udp_server_t *object, sat_udp_server_type_t type)
 {
     sat_status_t status = sat_status_set (&status, false, __func__, "sat udp server select type error");
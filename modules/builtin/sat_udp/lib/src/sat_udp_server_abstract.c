@@ -84,6 +84,8 @@ sat_status_t sat_udp_server_abstract_open (sat_udp_server_abstract_t *const obje
         }
 
         status = sat_udp_server_abstract_configure (object, info_list);
+        freeaddrinfo (info_list);
+
         sat_status_break_on_error (status);
 
         sat_udp_server_abstract_copy_to_context (object, args);
@@ -151,6 +153,12 @@ static sat_status_t sat_udp_server_abstract_set_reuse_address (sat_udp_server_ab
         sat_status_set (&status, false, __func__, "sat udp server abstract set reuse address error");
     }
 
+    // Every listener of a group sets it before binding, or the port is taken.
+    else if (object->reuse_port == true && setsockopt (object->socket, SOL_SOCKET, SO_REUSEPORT, (void *)&yes, sizeof (yes)) != 0)
+    {
+        sat_status_set (&status, false, __func__, "sat udp server abstract set reuse port error");
+    }
+
     return status;
 }
 
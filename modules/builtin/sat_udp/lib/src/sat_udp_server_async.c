@@ -9,95 +9,79 @@
 
 static sat_status_t sat_udp_server_async_open (void *const object, const sat_udp_server_args_t *const args);
 static sat_status_t sat_udp_server_async_run (void *const object);
+static sat_status_t sat_udp_server_async_receive (void *const object);
 static int sat_udp_server_async_get_socket (const void *const object);
 
 sat_udp_server_base_t *sat_udp_server_async_create (void)
 {
-    static sat_udp_server_async_t async =
-    {
-        .abstract.base =
-        {
-            .object = &async,
-            .open = sat_udp_server_async_open,
-            .run = sat_udp_server_async_run,
-            .get_socket = sat_udp_server_async_get_socket
-        } 
-    };
+    static sat_udp_server_async_t async;
+
+    sat_udp_server_async_init (&async);
 
     return (sat_udp_server_base_t *)&async;
 }
 
+// For instances of their own, as each listener needs.
+void sat_udp_server_async_init (sat_udp_server_async_t *const object)
+{
+    object->abstract.base = (sat_udp_server_base_t)
+    {
+        .object = object,
+        .open = sat_udp_server_async_open,
+        .run = sat_udp_server_async_run,
+        .receive = sat_udp_server_async_receive,
+        .get_socket = sat_udp_server_async_get_socket
+    };
+}
+
 static sat_status_t sat_udp_server_async_run (void *const object)
 {
-    sat_status_t status = sat_status_set (&status, false, __func__, "sat udp server async error");
+    sat_status_t status = sat_status_set (&status, true, __func__, "");
 
     sat_udp_server_async_t *const async = (sat_udp_server_async_t *const) object;
 
-    async->read = async->master;
-
-    struct timeval timeout = 
+    struct pollfd pfd =
     {
-        .tv_sec = 0,
-        .tv_usec = 100000
+        .fd = async->abstract.socket,
+        .events = POLLIN,
     };
 
-    int __status = select (async->max_socket + 1, &async->read, 0, 0, &timeout);
+    int __status = poll (&pfd, 1, 100);
 
     if (__status < 0)
-    {
-        // failed
-        sat_status_set (&status, false, __func__, "Select returns a error");
-    }
-    else if (__status == 0)
-    {
-        //timeout
-        sat_status_set (&status, true, __func__, "");
-    }
+        sat_status_set (&status, false, __func__, "sat udp server async error: poll failed");
+
+    else if (__status > 0)
+        status = sat_udp_server_async_receive (object);
+
+    return status;
+}
+
+static sat_status_t sat_udp_server_async_receive (void *const object)
+{
+    sat_status_t status = sat_status_set (&status, true, __func__, "");
 
-    if (FD_ISSET (async->abstract.socket, &async->read))
+    sat_udp_server_async_t *const async = (sat_udp_server_async_t *const) object;
+
+    // Bounded so a flood on one socket does not starve the rest of a reactor.
+    for (uint32_t i = 0; i < SAT_UDP_SERVER_ASYNC_BURST; i++)
     {
         struct sockaddr_storage source;
         socklen_t length = sizeof (source);
-        uint32_t size;
-        struct pollfd pfd;
-        pfd.fd = async->abstract.socket;
-        pfd.events = POLLIN;
-        pfd.revents = 0;
 
-        int poll_result = poll (&pfd, 1, 5000);
+        memset (async->abstract.buffer, 0, async->abstract.size);
 
-        if (poll_result > 0 && (pfd.revents & POLLIN))
-        {
-            // Data available, receive it
-            memset (async->abstract.buffer, 0, async->abstract.size);
-            size = recvfrom (async->abstract.socket,
-                        async->abstract.buffer,
-                        async->abstract.size,
-                        0,
-                        (struct sockaddr *)&source,
-                        &length);
-
-            async->abstract.buffer [size] = 0;
-        }
-        else if (poll_result == 0)
-        {
-            // Timeout occurred
-            sat_status_set (&status, false, __func__, "sat udp receive timeout");
-        }
-        else
-        {
-            // Error occurred
-            sat_status_set (&status, false, __func__, "sat udp receive poll error");
-        }
+        ssize_t received = recvfrom (async->abstract.socket,
+                                     async->abstract.buffer,
+                                     async->abstract.size,
+                                     MSG_DONTWAIT,
+                                     (struct sockaddr *)&source,
+                                     &length);
 
-        // size = recvfrom (async->abstract.socket,
-        //                 async->abstract.buffer,
-        //                 async->abstract.size,
-        //                 0,
-        //                 (struct sockaddr *)&source,
-        //                 &length);
+        if (received < 0)
+            break;
 
-        // async->abstract.buffer [size] = 0;
+        uint32_t size = (uint32_t) received;
 
         if (async->abstract.events.on_receive)
             async->abstract.events.on_receive (async->abstract.buffer, &size, async->abstract.data);
@@ -111,14 +95,12 @@ static sat_status_t sat_udp_server_async_run (void *const object)
                     size,
                     0,
                     (struct sockaddr *)&source,
-                    sizeof (source));                    
+                    length);
         }
-
-        memset (async->abstract.buffer, 0, async->abstract.size);
-
-        sat_status_set (&status, true, __func__, "");
     }
 
+    memset (async->abstract.buffer, 0, async->abstract.size);
+
     return status;
 }
 
@@ -126,17 +108,7 @@ static sat_status_t sat_udp_server_async_open (void *const object, const sat_udp
 {
     sat_udp_server_async_t *const async = (sat_udp_server_async_t *const) object;
 
-    sat_status_t status = sat_udp_server_abstract_open (&async->abstract, args);
-
-    if (sat_status_get_result (&status) == true)
-    {
-        FD_ZERO (&async->master);
-        FD_SET (async->abstract.socket, &async->master);
-
-        async->max_socket = async->abstract.socket;
-    }
-
-    return status;
+    return sat_udp_server_abstract_open (&async->abstract, args);
 }
 
 static int sat_udp_server_async_get_socket (const void *const object)
@@ -0,0 +1,170 @@
+#include <sat_udp_server_listeners.h>
+#include <sat_udp_server_async.h>
+#include <sat_reactor_group.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+
+typedef struct
+{
+    sat_udp_server_async_t async;
+    char *buffer;                       // receive buffer of this thread
+    bool bound;
+} sat_udp_server_listener_t;
+
+struct sat_udp_server_listeners_t
+{
+    sat_udp_server_listener_t *items;
+    uint16_t amount;
+    sat_reactor_group_t group;          // reactor i serves the socket of listener i
+    bool grouped;
+    char service [NI_MAXSERV];          // the port every listener binds, fixed by the first one
+};
+
+static sat_status_t sat_udp_server_listeners_add (sat_udp_server_listener_t *const listener, const sat_udp_server_args_t *const args, const char *const service, sat_reactor_t *const reactor);
+static void sat_udp_server_listeners_remove (sat_udp_server_listener_t *const listener);
+static void sat_udp_server_listeners_on_readable (int fd, uint32_t events, void *data);
+
+sat_status_t sat_udp_server_listeners_open (sat_udp_server_listeners_t **const object, const sat_udp_server_args_t *const args)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat udp server listeners open error: memory allocation failed");
+
+    do
+    {
+        if (args->type != sat_udp_server_type_async)
+        {
+            status = sat_status_set (&status, false, __func__, "sat udp server listeners open error: async type only");
+            break;
+        }
+
+        if (args->service == NULL)
+        {
+            status = sat_status_set (&status, false, __func__, "sat udp server listeners open error: null service");
+            break;
+        }
+
+        sat_udp_server_listeners_t *__object = calloc (1, sizeof (sat_udp_server_listeners_t));
+        if (__object == NULL)
+            break;
+
+        __object->items = calloc (args->listeners, sizeof (sat_udp_server_listener_t));
+        if (__object->items == NULL)
+        {
+            free (__object);
+            break;
+        }
+
+        snprintf (__object->service, sizeof (__object->service), "%s", args->service);
+
+        status = sat_reactor_group_open (&__object->group, &(sat_reactor_group_args_t)
+                                                           {
+                                                               .amount = args->listeners,
+                                                               .name = "sat_udp",
+                                                               .steer_by_cpu = args->steer_by_cpu,
+                                                           });
+
+        __object->grouped = sat_status_get_result (&status);
+
+        for (uint16_t i = 0; i < args->listeners && sat_status_get_result (&status) == true; i++)
+        {
+            status = sat_udp_server_listeners_add (&__object->items [i], args, __object->service, sat_reactor_group_get (&__object->group, i));
+            __object->amount ++;
+
+            // With port 0 the kernel picks one, and the rest of the group must join it.
+            if (sat_status_get_result (&status) == true && i == 0)
+                status = sat_reactor_group_get_service (sat_udp_server_listeners_get_socket (__object), __object->service, sizeof (__object->service));
+        }
+
+        if (sat_status_get_result (&status) == true && args->steer_by_cpu == true)
+            status = sat_reactor_group_steer (&__object->group, sat_udp_server_listeners_get_socket (__object));
+
+        if (sat_status_get_result (&status) == true)
+            status = sat_reactor_group_start (&__object->group);
+
+        if (sat_status_get_result (&status) == false)
+        {
+            sat_udp_server_listeners_destroy (__object);
+            break;
+        }
+
+        *object = __object;
+
+    } while (false);
+
+    return status;
+}
+
+int sat_udp_server_listeners_get_socket (const sat_udp_server_listeners_t *const object)
+{
+    return sat_udp_server_abstract_get_socket (&object->items [0].async.abstract);
+}
+
+void sat_udp_server_listeners_destroy (sat_udp_server_listeners_t *const object)
+{
+    if (object->grouped == true)
+        sat_reactor_group_stop (&object->group);
+
+    for (uint16_t i = 0; i < object->amount; i++)
+        sat_udp_server_listeners_remove (&object->items [i]);
+
+    if (object->grouped == true)
+        sat_reactor_group_close (&object->group);
+
+    free (object->items);
+    free (object);
+}
+
+static sat_status_t sat_udp_server_listeners_add (sat_udp_server_listener_t *const listener, const sat_udp_server_args_t *const args, const char *const service, sat_reactor_t *const reactor)
+{
+    sat_status_t status = sat_status_set (&status, false, __func__, "sat udp server listeners add error: memory allocation failed");
+
+    do
+    {
+        // The events write into the buffer, so each thread needs its own.
+        listener->buffer = (char *) malloc (args->size > 0 ? args->size : 1);
+        if (listener->buffer == NULL)
+            break;
+
+        sat_udp_server_args_t __args = *args;
+
+        __args.service = service;
+        __args.buffer = args->buffer != NULL ? listener->buffer : NULL;
+
+        sat_udp_server_async_init (&listener->async);
+        listener->async.abstract.reuse_port = true;
+
+        status = listener->async.abstract.base.open (&listener->async, &__args);
+        sat_status_break_on_error (status);
+
+        listener->bound = true;
+
+        status = sat_reactor_add (reactor,
+                                  sat_udp_server_abstract_get_socket (&listener->async.abstract),
+                                  sat_reactor_event_read,
+                                  sat_udp_server_listeners_on_readable,
+                                  listener);
+
+    } while (false);
+
+    return status;
+}
+
+static void sat_udp_server_listeners_remove (sat_udp_server_listener_t *const listener)
+{
+    if (listener->bound == true)
+        close (sat_udp_server_abstract_get_socket (&listener->async.abstract));
+
+    free (listener->buffer);
+}
+
+static void sat_udp_server_listeners_on_readable (int fd, uint32_t events, void *data)
+{
+    sat_udp_server_listener_t *listener = (sat_udp_server_listener_t *) data;
+
+    (void) fd;
+    (void) events;
+
+    listener->async.abstract.base.receive (&listener->async);
+}
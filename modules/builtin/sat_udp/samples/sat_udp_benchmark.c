@@ -0,0 +1,204 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/*
+ * Listener benchmark: an echo server of the async type, first with a single
+ * listener driven by sat_udp_run, then with 2 up to N SO_REUSEPORT listeners
+ * on threads of their own. Each client thread sends from a socket of its own
+ * and waits for every reply, so the kernel spreads the clients over the
+ * listeners by their ports, or by CPU when steered.
+ *
+ * The clients share the host with the server, so run it on a machine with
+ * more cores than client threads plus listeners to see the listeners scale.
+ *
+ * usage: sat_udp_benchmark [seconds] [max listeners] [client threads] [steer]
+ */
+
+#define BENCHMARK_SECONDS_DEFAULT       2
+#define BENCHMARK_LISTENERS_DEFAULT     4
+#define BENCHMARK_CLIENTS_DEFAULT       4
+#define BENCHMARK_MESSAGE_SIZE          64
+#define BENCHMARK_BUFFER_SIZE           2048
+
+typedef struct
+{
+    uint16_t port;
+    double deadline;
+    uint64_t done;
+    pthread_t thread;
+} benchmark_client_t;
+
+static volatile bool benchmark_serving;
+
+static double benchmark_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+// Replies with the datagram as it came.
+static void benchmark_on_send (char *const buffer, uint32_t *const size, void *const data)
+{
+}
+
+// The single listener is turned by a thread of its own, as an application would.
+static void *benchmark_serve (void *args)
+{
+    sat_udp_t *server = (sat_udp_t *) args;
+
+    while (benchmark_serving == true)
+        sat_udp_run (server);
+
+    return NULL;
+}
+
+static void *benchmark_client (void *args)
+{
+    benchmark_client_t *client = (benchmark_client_t *) args;
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons (client->port)};
+    struct timeval timeout = {.tv_usec = 100000};
+    char message [BENCHMARK_MESSAGE_SIZE] = {0};
+
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    int fd = socket (AF_INET, SOCK_DGRAM, 0);
+
+    // A lost datagram costs a timeout instead of the whole run.
+    setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout));
+    connect (fd, (struct sockaddr *) &address, sizeof (address));
+
+    while (benchmark_now () < client->deadline)
+    {
+        if (send (fd, message, sizeof (message), 0) == sizeof (message) &&
+            recv (fd, message, sizeof (message), 0) == sizeof (message))
+        {
+            client->done ++;
+        }
+    }
+
+    close (fd);
+
+    return NULL;
+}
+
+static double benchmark_load (uint16_t port, uint32_t clients, double seconds)
+{
+    benchmark_client_t *items = (benchmark_client_t *) calloc (clients, sizeof (benchmark_client_t));
+    uint64_t done = 0;
+
+    if (items == NULL)
+        return 0.0;
+
+    double start = benchmark_now ();
+
+    for (uint32_t i = 0; i < clients; i++)
+    {
+        items [i] = (benchmark_client_t) {.port = port, .deadline = start + seconds};
+        pthread_create (&items [i].thread, NULL, benchmark_client, &items [i]);
+    }
+
+    for (uint32_t i = 0; i < clients; i++)
+    {
+        pthread_join (items [i].thread, NULL);
+        done += items [i].done;
+    }
+
+    double elapsed = benchmark_now () - start;
+
+    free (items);
+
+    return (double) done / elapsed / 1e3;
+}
+
+static bool benchmark_run (uint16_t listeners, bool steer, uint32_t clients, double seconds, double *echoes)
+{
+    sat_udp_t server;
+    pthread_t serve;
+    char buffer [BENCHMARK_BUFFER_SIZE];
+    uint16_t port = 0;
+
+    sat_udp_init (&server);
+
+    sat_status_t status = sat_udp_open (&server, &(sat_udp_args_t)
+                                                 {
+                                                     .type = sat_udp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = "0",
+                                                         .buffer = buffer,
+                                                         .size = sizeof (buffer),
+                                                         .events = {.on_send = benchmark_on_send},
+                                                         .type = sat_udp_server_type_async,
+                                                         .listeners = listeners,
+                                                         .steer_by_cpu = steer,
+                                                     },
+                                                 });
+    if (sat_status_get_result (&status) == false)
+    {
+        fprintf (stderr, "%s\n", sat_status_get_motive (&status));
+        return false;
+    }
+
+    sat_udp_get_port (&server, &port);
+
+    benchmark_serving = true;
+
+    if (listeners == 1)
+        pthread_create (&serve, NULL, benchmark_serve, &server);
+
+    *echoes = benchmark_load (port, clients, seconds);
+
+    benchmark_serving = false;
+
+    if (listeners == 1)
+        pthread_join (serve, NULL);
+
+    sat_udp_close (&server);
+
+    return true;
+}
+
+int main (int argc, char *argv[])
+{
+    double seconds = argc > 1 ? atof (argv [1]) : BENCHMARK_SECONDS_DEFAULT;
+    uint32_t max_listeners = argc > 2 ? (uint32_t) strtoul (argv [2], NULL, 10) : BENCHMARK_LISTENERS_DEFAULT;
+    uint32_t clients = argc > 3 ? (uint32_t) strtoul (argv [3], NULL, 10) : BENCHMARK_CLIENTS_DEFAULT;
+    bool steer = argc > 4 && strcmp (argv [4], "steer") == 0;
+
+    if (seconds <= 0)
+        seconds = BENCHMARK_SECONDS_DEFAULT;
+
+    if (max_listeners == 0 || max_listeners > UINT16_MAX)
+        max_listeners = BENCHMARK_LISTENERS_DEFAULT;
+
+    if (clients == 0)
+        clients = BENCHMARK_CLIENTS_DEFAULT;
+
+    printf ("%u client threads, %.1f s per run, %d byte datagrams%s\n", clients, seconds, BENCHMARK_MESSAGE_SIZE, steer ? ", steered by cpu" : "");
+    printf ("%-10s %20s\n", "listeners", "Kechoes/s");
+
+    for (uint32_t listeners = 1; listeners <= max_listeners; listeners *= 2)
+    {
+        double echoes = 0.0;
+        char label [16];
+
+        if (benchmark_run ((uint16_t) listeners, steer, clients, seconds, &echoes) == false)
+            return 1;
+
+        snprintf (label, sizeof (label), listeners == 1 ? "1 (run)" : "%u", listeners);
+        printf ("%-10s %20.1f\n", label, echoes);
+    }
+
+    return 0;
+}
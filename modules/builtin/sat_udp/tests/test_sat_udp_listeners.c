@@ -0,0 +1,227 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define TEST_BUFFER_SIZE    256
+#define TEST_LISTENERS      4
+#define TEST_CLIENTS        64
+
+typedef struct
+{
+    uint32_t received;
+    uint32_t threads;
+} test_context_t;
+
+static test_context_t context;
+static __thread bool serving;
+
+static void test_on_receive (char *const buffer, uint32_t *const size, void *const data)
+{
+    test_context_t *context = (test_context_t *) data;
+
+    // Counts the threads that took at least one datagram.
+    if (serving == false)
+    {
+        serving = true;
+        __atomic_add_fetch (&context->threads, 1, __ATOMIC_RELAXED);
+    }
+
+    __atomic_add_fetch (&context->received, 1, __ATOMIC_RELAXED);
+}
+
+// The datagram goes back as it came.
+static void test_on_send (char *const buffer, uint32_t *const size, void *const data)
+{
+}
+
+// Steering takes at most one listener per CPU the process may use.
+static uint16_t test_cpus (void)
+{
+    cpu_set_t set;
+
+    CPU_ZERO (&set);
+    assert (sched_getaffinity (0, sizeof (set), &set) == 0);
+
+    return (uint16_t) CPU_COUNT (&set);
+}
+
+static void test_open (sat_udp_t *const server, char *const buffer, uint16_t *const port, uint16_t listeners, bool steer)
+{
+    memset (&context, 0, sizeof (context));
+
+    sat_status_t status = sat_udp_init (server);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_udp_open (server, &(sat_udp_args_t)
+                                   {
+                                       .type = sat_udp_type_server,
+                                       .server =
+                                       {
+                                           .service = "0",
+                                           .buffer = buffer,
+                                           .size = TEST_BUFFER_SIZE,
+                                           .events = {.on_receive = test_on_receive, .on_send = test_on_send},
+                                           .data = &context,
+                                           .type = sat_udp_server_type_async,
+                                           .listeners = listeners,
+                                           .steer_by_cpu = steer,
+                                       },
+                                   });
+    assert (sat_status_get_result (&status) == true);
+
+    // Every listener joined the port the kernel picked for the first one.
+    status = sat_udp_get_port (server, port);
+    assert (sat_status_get_result (&status) == true);
+    assert (*port > 0);
+}
+
+static int test_client (void)
+{
+    struct timeval timeout = {.tv_sec = 5};
+
+    int fd = socket (AF_INET, SOCK_DGRAM, 0);
+    assert (fd >= 0);
+    assert (setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout)) == 0);
+
+    return fd;
+}
+
+static void test_echo (int fd, uint16_t port)
+{
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons (port)};
+    char buffer [TEST_BUFFER_SIZE];
+
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    assert (sendto (fd, "ping", 4, 0, (struct sockaddr *) &address, sizeof (address)) == 4);
+    assert (recv (fd, buffer, sizeof (buffer), 0) == 4);
+    assert (memcmp (buffer, "ping", 4) == 0);
+}
+
+static void test_spread (void)
+{
+    sat_udp_t server;
+    char buffer [TEST_BUFFER_SIZE];
+    uint16_t port;
+
+    test_open (&server, buffer, &port, TEST_LISTENERS, false);
+
+    // Each client has a port of its own, and so a listener of its own.
+    for (uint32_t i = 0; i < TEST_CLIENTS; i++)
+    {
+        int fd = test_client ();
+
+        test_echo (fd, port);
+        close (fd);
+    }
+
+    assert (__atomic_load_n (&context.received, __ATOMIC_RELAXED) == TEST_CLIENTS);
+    assert (__atomic_load_n (&context.threads, __ATOMIC_RELAXED) > 1);
+
+    sat_status_t status = sat_udp_run (&server);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_udp_close (&server);
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_steer (void)
+{
+    sat_udp_t server;
+    char buffer [TEST_BUFFER_SIZE];
+    uint16_t port;
+
+    struct sockaddr_in address = {.sin_family = AF_INET};
+    uint16_t listeners = test_cpus ();
+
+    test_open (&server, buffer, &port, listeners, true);
+
+    int fd = test_client ();
+
+    address.sin_port = htons (port);
+    inet_pton (AF_INET, "127.0.0.1", &address.sin_addr);
+
+    // On a single CPU the one listener is turned by sat_udp_run.
+    assert (sendto (fd, "ping", 4, 0, (struct sockaddr *) &address, sizeof (address)) == 4);
+
+    while (listeners == 1 && recv (fd, buffer, sizeof (buffer), MSG_PEEK | MSG_DONTWAIT) <= 0)
+        sat_udp_run (&server);
+
+    assert (recv (fd, buffer, sizeof (buffer), 0) == 4);
+    assert (memcmp (buffer, "ping", 4) == 0);
+
+    close (fd);
+    sat_udp_close (&server);
+
+    // A listener more would share a CPU and never be steered to.
+    sat_udp_init (&server);
+
+    sat_status_t status = sat_udp_open (&server, &(sat_udp_args_t)
+                                                 {
+                                                     .type = sat_udp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = "0",
+                                                         .buffer = buffer,
+                                                         .size = TEST_BUFFER_SIZE,
+                                                         .events = {.on_send = test_on_send},
+                                                         .type = sat_udp_server_type_async,
+                                                         .listeners = test_cpus () + 1,
+                                                         .steer_by_cpu = true,
+                                                     },
+                                                 });
+    assert (sat_status_get_result (&status) == false);
+}
+
+static void test_invalid (void)
+{
+    sat_udp_t server;
+    sat_reactor_t reactor;
+    char buffer [TEST_BUFFER_SIZE];
+    uint16_t port;
+
+    sat_udp_init (&server);
+
+    // Only the async type runs on listeners.
+    sat_status_t status = sat_udp_open (&server, &(sat_udp_args_t)
+                                                 {
+                                                     .type = sat_udp_type_server,
+                                                     .server =
+                                                     {
+                                                         .service = "0",
+                                                         .buffer = buffer,
+                                                         .size = TEST_BUFFER_SIZE,
+                                                         .type = sat_udp_server_type_interactive,
+                                                         .listeners = TEST_LISTENERS,
+                                                     },
+                                                 });
+    assert (sat_status_get_result (&status) == false);
+
+    // Nor can a server with reactors of its own be attached to another.
+    test_open (&server, buffer, &port, TEST_LISTENERS, false);
+
+    sat_reactor_init (&reactor);
+    sat_reactor_open (&reactor, NULL);
+
+    status = sat_udp_attach (&server, &reactor);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_udp_close (&server);
+    sat_reactor_close (&reactor);
+}
+
+int main (int argc, char *argv[])
+{
+    test_spread ();
+    test_steer ();
+    test_invalid ();
+
+    return 0;
+}
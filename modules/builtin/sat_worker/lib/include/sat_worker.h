@@ -5,9 +5,25 @@
  * @date December 2025
  * 
  * This module provides a worker thread pool implementation that allows parallel
- * processing of tasks using a queue-based work distribution system. It manages
- * a pool of worker threads that process tasks from a shared queue, providing
- * an efficient way to handle concurrent workloads.
+ * processing of tasks using a queue-based work distribution system. Each
+ * worker thread owns a local queue guarded by its own lock; tasks are spread
+ * over the local queues, workers take them in batches and run the handler
+ * with no lock held, and a worker whose queue is empty steals from the
+ * others before going to sleep.
+ *
+ * Besides fire-and-forget feeding, tasks can be submitted with a future that
+ * carries the task result and can be waited on, and with a completion
+ * callback. sat_worker_wait_idle() joins everything fed so far.
+ *
+ * A capacity bounds the number of queued tasks: feeding blocks, fails or
+ * times out when the pool is full, and water mark callbacks tell the caller
+ * when to start and stop shedding load. sat_worker_get_stats() reports the
+ * queue depth and latency histograms.
+ *
+ * Threads are named after the pool and may be pinned to CPUs chosen from the
+ * host topology (see sat_topology): packed on neighbouring cores, spread over
+ * nodes and caches, or placed on an explicit list. On hosts with several NUMA
+ * nodes, the queue and buffers of a pinned thread are placed on its node.
  */
 
 #ifndef SAT_WORKER_H_
@@ -15,6 +31,7 @@
 
 #include <sat_status.h>
 #include <sat_queue.h>
+#include <sat_topology.h>
 #include <pthread.h>
 #include <stdbool.h>
 
@@ -29,23 +46,112 @@
  */
 typedef void (*sat_worker_handler_t) (void *const object);
 
+/**
+ * @brief Function type run for a submitted task
+ *
+ * @param object Pointer to the task data
+ * @param result Buffer of result_size bytes stored in the task future, NULL when result_size is 0
+ */
+typedef void (*sat_worker_task_t) (void *const object, void *const result);
+
+/**
+ * @brief Function type called once a submitted task has run
+ *
+ * Runs on the worker thread, right before the task future is completed.
+ *
+ * @param user User context given at submission
+ * @param object Pointer to the task data
+ * @param result Pointer to the task result, NULL when result_size is 0
+ */
+typedef void (*sat_worker_completion_t) (void *const user, void *const object, void *const result);
+
+/**
+ * @brief Function type called when the queue depth crosses a water mark
+ *
+ * Runs on the thread that made the depth cross the mark, a feeder for the
+ * high mark and a worker for the low one, so it must be short.
+ *
+ * @param user User context given in sat_worker_args_t
+ * @param depth Number of queued tasks right after the crossing
+ */
+typedef void (*sat_worker_water_mark_t) (void *const user, const uint32_t depth);
+
+/**
+ * @brief Opaque handle to the outcome of a submitted task
+ */
+typedef struct sat_worker_future_t sat_worker_future_t;
+
+/**
+ * @brief Default number of tasks a worker takes from a queue at once
+ */
+#define SAT_WORKER_BATCH_SIZE_DEFAULT   16
+
+/**
+ * @brief Number of buckets of the latency histograms
+ *
+ * Bucket 0 counts durations under 1 microsecond, bucket i durations in
+ * [2^(i-1), 2^i) microseconds, and the last bucket everything longer.
+ */
+#define SAT_WORKER_HISTOGRAM_BUCKETS    24
+
+/**
+ * @brief Prefix of the thread names when none is given
+ */
+#define SAT_WORKER_NAME_DEFAULT         "sat_worker"
+
+/**
+ * @brief Where the worker threads run
+ */
+typedef enum
+{
+    sat_worker_placement_none,       /**< Wherever the kernel schedules them */
+    sat_worker_placement_compact,    /**< Pinned close together, sharing cores and caches first */
+    sat_worker_placement_scatter,    /**< Pinned apart, one per node, cache and core first */
+    sat_worker_placement_explicit,   /**< Thread i pinned to cpus [i % cpus_amount] */
+} sat_worker_placement_t;
+
+/**
+ * @brief Per-thread task queue, internal to the worker pool
+ */
+typedef struct sat_worker_local_t sat_worker_local_t;
+
 /**
  * @brief Worker thread pool structure
  * 
- * This structure manages a pool of worker threads that process tasks from
- * a shared queue. It includes synchronization primitives for thread-safe
- * queue access and condition variables for efficient thread coordination.
+ * This structure manages a pool of worker threads, each with its own task
+ * queue. The mutex and condition variable are only used to park idle threads;
+ * tasks are queued and dequeued under the lock of the local queue involved.
  */
 typedef struct 
 {
-    pthread_mutex_t mutex;           /**< Mutex for thread synchronization */
-    pthread_cond_t cond;             /**< Condition variable for thread signaling */
+    pthread_mutex_t mutex;           /**< Mutex guarding idle threads */
+    pthread_cond_t cond;             /**< Condition variable idle threads wait on */
     pthread_t *threads;              /**< Array of worker thread handles */
-    uint8_t threads_amount;          /**< Number of worker threads in the pool */
-    sat_queue_t *queue;              /**< Work queue for task distribution */
+    uint16_t threads_amount;         /**< Number of worker threads in the pool */
+    sat_worker_local_t *locals;      /**< One task queue per worker thread */
+    pthread_cond_t idle;             /**< Condition variable sat_worker_wait_idle() waits on */
     uint32_t object_size;            /**< Size of each task object in bytes */
+    uint32_t slot_size;              /**< Size of a queued task, object plus bookkeeping */
+    uint32_t batch_size;             /**< Maximum tasks taken from a queue at once */
     sat_worker_handler_t handler;    /**< Task processing callback function */
+    pthread_cond_t room;             /**< Condition variable feeders wait on while the pool is full */
+    uint32_t capacity;               /**< Maximum queued tasks, 0 when unbounded */
+    uint32_t high_water;             /**< Depth that triggers on_high_water, 0 when disabled */
+    uint32_t low_water;              /**< Depth that triggers on_low_water after a high crossing */
+    sat_worker_water_mark_t on_high_water; /**< Called when the depth reaches high_water */
+    sat_worker_water_mark_t on_low_water;  /**< Called when the depth falls back to low_water */
+    void *user;                      /**< User context passed to the water mark callbacks */
+    bool saturated;                  /**< Whether the depth crossed high_water and not yet low_water */
+    uint32_t feed_waiters;           /**< Feeders blocked on a full pool */
+    uint32_t depth_max;              /**< Highest depth seen */
+    uint64_t rejected;               /**< Feeds refused because the pool was full */
+    uint32_t next;                   /**< Round-robin cursor for tasks fed from outside the pool */
+    int32_t pending;                 /**< Tasks queued or being queued, and not yet taken */
+    uint32_t sleepers;               /**< Threads parked on the condition variable */
+    uint32_t outstanding;            /**< Tasks fed and not yet completed */
+    uint32_t idle_waiters;           /**< Threads blocked in sat_worker_wait_idle() */
     bool running;                    /**< Flag indicating if worker pool is active */
+    sat_topology_t topology;         /**< Host topology, read when the threads are pinned */
 } sat_worker_t;
 
 /**
@@ -56,11 +162,47 @@ typedef struct
  */
 typedef struct 
 {
-    uint8_t pool_amount;             /**< Number of worker threads to create */
+    uint16_t pool_amount;            /**< Number of worker threads to create */
     uint32_t object_size;            /**< Size of each task object in bytes */
     sat_worker_handler_t handler;    /**< Callback function for task processing */
+    uint32_t batch_size;             /**< Tasks taken from a queue at once, 0 selects SAT_WORKER_BATCH_SIZE_DEFAULT */
+    uint32_t capacity;               /**< Maximum queued tasks, 0 leaves the pool unbounded */
+    uint32_t high_water;             /**< Depth that triggers on_high_water, 0 disables the water marks */
+    uint32_t low_water;              /**< Depth that triggers on_low_water, lower than high_water */
+    sat_worker_water_mark_t on_high_water; /**< Optional callback run when the depth reaches high_water */
+    sat_worker_water_mark_t on_low_water;  /**< Optional callback run when the depth falls back to low_water */
+    void *user;                      /**< User context passed to the water mark callbacks */
+    sat_worker_placement_t placement; /**< Where the threads run, sat_worker_placement_none by default */
+    const uint32_t *cpus;            /**< Logical CPU numbers for sat_worker_placement_explicit */
+    uint32_t cpus_amount;            /**< Number of entries in cpus */
+    const char *name;                /**< Prefix of the thread names, NULL selects SAT_WORKER_NAME_DEFAULT */
 } sat_worker_args_t;
 
+/**
+ * @brief Snapshot of the pool statistics
+ */
+typedef struct
+{
+    uint32_t depth;                  /**< Tasks queued right now */
+    uint32_t depth_max;              /**< Highest depth seen since the pool was opened */
+    uint32_t capacity;               /**< Configured capacity, 0 when unbounded */
+    uint64_t completed;              /**< Tasks that have run */
+    uint64_t rejected;               /**< Feeds refused because the pool was full */
+    uint64_t wait [SAT_WORKER_HISTOGRAM_BUCKETS]; /**< Histogram of the time between feeding and starting a task */
+    uint64_t run [SAT_WORKER_HISTOGRAM_BUCKETS];  /**< Histogram of the time the tasks took to run */
+} sat_worker_stats_t;
+
+/**
+ * @brief Options of a submitted task
+ */
+typedef struct
+{
+    sat_worker_task_t task;              /**< Function run instead of the pool handler, NULL runs the handler */
+    uint32_t result_size;                /**< Bytes reserved for the task result, only used with task */
+    sat_worker_completion_t on_complete; /**< Optional callback run after the task */
+    void *user;                          /**< User context passed to on_complete */
+} sat_worker_submit_args_t;
+
 /**
  * @brief Initialize a worker thread pool object
  * 
@@ -91,15 +233,20 @@ sat_status_t sat_worker_init (sat_worker_t *const object);
  * @note The handler function must be thread-safe as it will be called concurrently
  * @note pool_amount must be greater than 0
  * @note object_size must be greater than 0
+ * @note Threads are named "<name>/<index>", cut to the 15 characters the
+ *       kernel keeps
+ * @note A pinned pool fails to open when a CPU it would use is offline or
+ *       outside the affinity mask of the caller
  */
 sat_status_t sat_worker_open (sat_worker_t *const object, const sat_worker_args_t *const args);
 
 /**
  * @brief Submit a task to the worker pool for processing
  * 
- * Enqueues a task into the worker pool's queue. One of the worker threads will
- * dequeue and process the task using the registered handler function. This
- * operation is thread-safe and can be called from multiple threads.
+ * Enqueues a task into one of the worker queues. Tasks fed from outside the
+ * pool are spread round-robin; tasks fed from a handler go to the queue of
+ * the thread running it, where idle threads can steal them. This operation
+ * is thread-safe and can be called from multiple threads.
  * 
  * @param[in,out] object Pointer to active worker pool
  * @param[in] data Pointer to task data to be processed (will be copied)
@@ -109,9 +256,115 @@ sat_status_t sat_worker_open (sat_worker_t *const object, const sat_worker_args_
  * 
  * @note The data is copied into the queue, so the caller can free/reuse the source
  * @note If all workers are busy, the task waits in the queue
+ * @note With a capacity, blocks while the pool is full; a handler feeding its
+ *       own pool never blocks and gets a failure instead
  */
 sat_status_t sat_worker_feed (sat_worker_t *const object, const void *const data);
 
+/**
+ * @brief Submit a task unless the pool is full
+ * 
+ * @param[in,out] object Pointer to active worker pool
+ * @param[in] data Pointer to task data to be processed (will be copied)
+ * @return Status indicating success, or failure if the pool is full
+ */
+sat_status_t sat_worker_try_feed (sat_worker_t *const object, const void *const data);
+
+/**
+ * @brief Submit a task, waiting a bounded time for room in the pool
+ * 
+ * @param[in,out] object Pointer to active worker pool
+ * @param[in] data Pointer to task data to be processed (will be copied)
+ * @param[in] timeout Maximum time to wait in milliseconds
+ * @return Status indicating success, or failure if the pool stayed full
+ */
+sat_status_t sat_worker_feed_timed (sat_worker_t *const object, const void *const data, const uint32_t timeout);
+
+/**
+ * @brief Submit several tasks with a single queue lock
+ * 
+ * @param[in,out] object Pointer to active worker pool
+ * @param[in] data Pointer to @p amount contiguous task objects (will be copied)
+ * @param[in] amount Number of tasks
+ * @return Status indicating success or failure
+ * 
+ * @note All tasks land in one queue; idle threads steal from it
+ * @note With a capacity, blocks until all of them fit and fails if @p amount exceeds it
+ */
+sat_status_t sat_worker_feed_many (sat_worker_t *const object, const void *const data, const uint32_t amount);
+
+/**
+ * @brief Submit a task and get a handle to its outcome
+ * 
+ * The task data is copied like with sat_worker_feed(). When @p future is not
+ * NULL it receives a handle that sat_worker_future_wait() blocks on until the
+ * task has run, and that carries the result written by args->task.
+ * 
+ * @param[in,out] object Pointer to active worker pool
+ * @param[in] data Pointer to task data to be processed (will be copied)
+ * @param[in] args Task options, NULL behaves like sat_worker_feed()
+ * @param[out] future Optional pointer that receives the task handle, may be NULL
+ * @return Status indicating success or failure
+ * 
+ * @note Every future must be released with sat_worker_future_destroy()
+ * @note With a capacity, blocks while the pool is full like sat_worker_feed()
+ */
+sat_status_t sat_worker_submit (sat_worker_t *const object, const void *const data, const sat_worker_submit_args_t *const args, sat_worker_future_t **const future);
+
+/**
+ * @brief Wait until every task fed so far has completed
+ * 
+ * Tasks fed by handlers while waiting are waited for as well, so a fan-out
+ * started from a single task is joined as a whole.
+ * 
+ * @param[in] object Pointer to active worker pool
+ * @return Status indicating success or failure
+ * 
+ * @warning Must not be called from a handler, which would wait for itself
+ */
+sat_status_t sat_worker_wait_idle (sat_worker_t *const object);
+
+/**
+ * @brief Read the pool statistics
+ * 
+ * The counters are gathered from every worker without stopping them, so they
+ * may be a few tasks apart from each other.
+ * 
+ * @param[in] object Pointer to active worker pool
+ * @param[out] stats Structure that receives the statistics
+ * @return Status indicating success or failure
+ */
+sat_status_t sat_worker_get_stats (sat_worker_t *const object, sat_worker_stats_t *const stats);
+
+/**
+ * @brief Wait for a submitted task to complete
+ * 
+ * @param[in] future Task handle
+ * @param[out] result Optional buffer of result_size bytes that receives the result, may be NULL
+ * @return Status indicating success, or failure if the pool was closed before the task ran
+ */
+sat_status_t sat_worker_future_wait (sat_worker_future_t *const future, void *const result);
+
+/**
+ * @brief Check whether a submitted task has completed, without blocking
+ * 
+ * @param[in] future Task handle
+ * @param[out] done Set to true once the task has run or was dropped by sat_worker_close()
+ * @return Status indicating success or failure
+ */
+sat_status_t sat_worker_future_is_done (sat_worker_future_t *const future, bool *const done);
+
+/**
+ * @brief Release a task handle
+ * 
+ * May be called before the task has run; the task still runs and the handle
+ * is freed once it completes.
+ * 
+ * @param[in] future Task handle
+ * @return Status indicating success or failure
+ */
+sat_status_t sat_worker_future_destroy (sat_worker_future_t *const future);
+
 /**
  * @brief Shutdown and cleanup the worker thread pool
  * 
@@ -125,7 +378,8 @@ sat_status_t sat_worker_feed (sat_worker_t *const object, const void *const data
  * @retval SAT_STATUS_ERROR Failed to close (null object)
  * 
  * @note This function blocks until all worker threads have terminated
- * @note Any tasks remaining in the queue will not be processed
+ * @note Any tasks remaining in the queue will not be processed, their futures
+ *       report failure and their completion callbacks are not called
  */
 sat_status_t sat_worker_close (sat_worker_t *const object);
 
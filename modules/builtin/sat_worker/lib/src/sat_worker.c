@@ -1,10 +1,87 @@
 #include <sat_worker.h>
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <sched.h>
+
+#define SAT_WORKER_CACHE_LINE_SIZE      64
+#define SAT_WORKER_SLOT_ALIGNMENT       16
+#define SAT_WORKER_WAIT_FOREVER         -1
+#define SAT_WORKER_NAME_SIZE            16      // kernel limit, terminator included
+
+typedef enum
+{
+    sat_worker_future_state_pending,
+    sat_worker_future_state_done,
+    sat_worker_future_state_cancelled,
+} sat_worker_future_state_t;
+
+struct sat_worker_future_t
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t references;    // one for the caller, one for the queued task
+    uint32_t state;
+    uint32_t result_size;
+    uint8_t result [] __attribute__ ((aligned (SAT_WORKER_SLOT_ALIGNMENT)));
+};
+
+// Header stored in front of every queued task object. Plain feeds leave it zeroed.
+typedef struct
+{
+    sat_worker_task_t task;
+    sat_worker_completion_t on_complete;
+    void *user;
+    sat_worker_future_t *future;
+    uint64_t enqueued;      // monotonic time in nanoseconds, for the wait histogram
+} __attribute__ ((aligned (SAT_WORKER_SLOT_ALIGNMENT))) sat_worker_slot_t;
+
+// Each local queue sits on its own cache line so that a thread locking its
+// queue does not invalidate the line holding its neighbour's lock.
+struct sat_worker_local_t
+{
+    pthread_mutex_t mutex;
+    sat_queue_t *queue;
+    uint32_t amount;        // mirror of the queue size, readable without the lock
+    uint8_t *staging;       // batch_size slots, filled under the lock before enqueueing
+    sat_worker_t *worker;
+    uint16_t index;
+    int32_t cpu;            // CPU the thread is pinned to, -1 when it is not
+    sat_allocator_t allocator;  // places the queue and buffers on the node of cpu
+
+    // Only written by the owning thread, summed up by sat_worker_get_stats.
+    uint64_t completed;
+    uint64_t wait [SAT_WORKER_HISTOGRAM_BUCKETS];
+    uint64_t run [SAT_WORKER_HISTOGRAM_BUCKETS];
+} __attribute__ ((aligned (SAT_WORKER_CACHE_LINE_SIZE)));
+
+static __thread sat_worker_local_t *sat_worker_current = NULL;
 
 static sat_status_t sat_worker_is_args_valid (const sat_worker_args_t *const args);
-static sat_status_t sat_worker_threads_allocation (sat_worker_t *const object, uint8_t amount);
-static sat_status_t sat_worker_threads_start (sat_worker_t *const object);
+static sat_status_t sat_worker_threads_allocation (sat_worker_t *const object, uint16_t amount);
+static sat_status_t sat_worker_locals_create (sat_worker_t *const object, const sat_worker_args_t *const args);
+static sat_status_t sat_worker_place (sat_worker_t *const object, const sat_worker_args_t *const args);
+static void sat_worker_locals_destroy (sat_worker_t *const object, const uint16_t amount);
+static sat_status_t sat_worker_threads_start (sat_worker_t *const object, const char *const name);
+
+static sat_status_t sat_worker_enqueue (sat_worker_t *const object, const void *const data, const uint32_t amount, const sat_worker_slot_t *const header, const int64_t timeout);
+static bool sat_worker_try_reserve (sat_worker_t *const object, const uint32_t amount);
+static sat_status_t sat_worker_reserve (sat_worker_t *const object, const uint32_t amount, const int64_t timeout);
+static void sat_worker_unreserve (sat_worker_t *const object, const uint32_t amount);
+static sat_worker_local_t *sat_worker_local_for_feed (sat_worker_t *const object);
+static void sat_worker_done (sat_worker_t *const object, const uint32_t amount);
+static void sat_worker_run (sat_worker_t *const worker, sat_worker_slot_t *const slot);
+static void sat_worker_cancel (sat_worker_slot_t *const slot);
+static void sat_worker_future_complete (sat_worker_future_t *const future, const uint32_t state);
+static void sat_worker_future_release (sat_worker_future_t *const future);
+static void sat_worker_wake (sat_worker_t *const object, const uint32_t amount);
+static uint32_t sat_worker_take (sat_worker_local_t *const local, uint8_t *const batch, const uint32_t limit);
+static uint32_t sat_worker_steal (sat_worker_local_t *const self, uint8_t *const batch);
+static void sat_worker_sleep (sat_worker_t *const worker);
+static uint64_t sat_worker_now (void);
+static void sat_worker_record (uint64_t *const histogram, const uint64_t nanoseconds);
 
 static void *sat_worker_thread_function (void *const args);
 
@@ -22,6 +99,29 @@ sat_status_t sat_worker_init (sat_worker_t *const object)
         sat_status_return_on_failure ("condition variable initialization failed");
     }
 
+    if (pthread_cond_init (&object->idle, NULL) != 0)
+    {
+        pthread_cond_destroy (&object->cond);
+        pthread_mutex_destroy (&object->mutex);
+        sat_status_return_on_failure ("condition variable initialization failed");
+    }
+
+    // Timed feeds wait against the monotonic clock.
+    pthread_condattr_t attributes;
+    pthread_condattr_init (&attributes);
+    pthread_condattr_setclock (&attributes, CLOCK_MONOTONIC);
+
+    int result = pthread_cond_init (&object->room, &attributes);
+    pthread_condattr_destroy (&attributes);
+
+    if (result != 0)
+    {
+        pthread_cond_destroy (&object->idle);
+        pthread_cond_destroy (&object->cond);
+        pthread_mutex_destroy (&object->mutex);
+        sat_status_return_on_failure ("condition variable initialization failed");
+    }
+
     sat_status_return_on_success ();
 }
 
@@ -32,59 +132,231 @@ sat_status_t sat_worker_open (sat_worker_t *const object, const sat_worker_args_
     sat_status_return_on_error (sat_worker_is_args_valid (args));
 
     object->object_size = args->object_size;
+    object->slot_size = (sizeof (sat_worker_slot_t) + args->object_size + SAT_WORKER_SLOT_ALIGNMENT - 1) & ~(SAT_WORKER_SLOT_ALIGNMENT - 1);
     object->threads_amount = args->pool_amount;
     object->handler = args->handler;
+    object->batch_size = args->batch_size > 0 ? args->batch_size : SAT_WORKER_BATCH_SIZE_DEFAULT;
+    object->capacity = args->capacity;
+    object->high_water = args->high_water;
+    object->low_water = args->low_water;
+    object->on_high_water = args->on_high_water;
+    object->on_low_water = args->on_low_water;
+    object->user = args->user;
+
+    sat_status_return_on_error (sat_worker_locals_create (object, args));
 
-    sat_status_return_on_error (sat_queue_create (&object->queue, args->object_size));
     sat_status_t status = sat_worker_threads_allocation (object, args->pool_amount);
     if (sat_status_get_result (&status) == false)
     {
-        sat_queue_destroy (object->queue);
+        sat_worker_locals_destroy (object, object->threads_amount);
         sat_status_return_on_error (status);
     }
 
-    status = sat_worker_threads_start (object);
+    // Threads test this flag as soon as they start.
+    __atomic_store_n (&object->running, true, __ATOMIC_RELEASE);
+
+    status = sat_worker_threads_start (object, args->name != NULL ? args->name : SAT_WORKER_NAME_DEFAULT);
     if (sat_status_get_result (&status) == false)
     {
-        free (object->threads);
-        sat_queue_destroy (object->queue);
+        sat_worker_locals_destroy (object, object->threads_amount);
+        object->threads = NULL;
         sat_status_return_on_error (status);
     }
 
-    object->running = true;
-
     sat_status_return_on_success ();
 }
 
 sat_status_t sat_worker_feed (sat_worker_t *const object, const void *const data)
+{
+    return sat_worker_feed_many (object, data, 1);
+}
+
+sat_status_t sat_worker_try_feed (sat_worker_t *const object, const void *const data)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data");
+    sat_status_return_on_null (object->locals, "worker is not open");
+
+    return sat_worker_enqueue (object, data, 1, NULL, 0);
+}
+
+sat_status_t sat_worker_feed_timed (sat_worker_t *const object, const void *const data, const uint32_t timeout)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data");
+    sat_status_return_on_null (object->locals, "worker is not open");
+
+    return sat_worker_enqueue (object, data, 1, NULL, timeout);
+}
+
+sat_status_t sat_worker_feed_many (sat_worker_t *const object, const void *const data, const uint32_t amount)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (data, "null data");
+    sat_status_return_on_null (object->locals, "worker is not open");
+    sat_status_return_on_equals (amount, 0, "zero amount");
+
+    return sat_worker_enqueue (object, data, amount, NULL, SAT_WORKER_WAIT_FOREVER);
+}
+
+sat_status_t sat_worker_submit (sat_worker_t *const object, const void *const data, const sat_worker_submit_args_t *const args, sat_worker_future_t **const future)
 {
     sat_status_return_on_null (object, "null object");
     sat_status_return_on_null (data, "null data");
+    sat_status_return_on_null (object->locals, "worker is not open");
+
+    sat_worker_slot_t header = {0};
+
+    if (args != NULL)
+    {
+        header.task = args->task;
+        header.on_complete = args->on_complete;
+        header.user = args->user;
+    }
+
+    uint32_t result_size = (args != NULL && args->task != NULL) ? args->result_size : 0;
+
+    // Fire-and-forget tasks without a result do not need a handle at all.
+    if (future != NULL || result_size > 0)
+    {
+        header.future = (sat_worker_future_t *) calloc (1, sizeof (sat_worker_future_t) + result_size);
+        sat_status_return_on_null (header.future, "memory allocation failed");
+
+        pthread_mutex_init (&header.future->mutex, NULL);
+        pthread_cond_init (&header.future->cond, NULL);
+        header.future->references = future != NULL ? 2 : 1;
+        header.future->result_size = result_size;
+    }
+
+    sat_status_t status = sat_worker_enqueue (object, data, 1, &header, SAT_WORKER_WAIT_FOREVER);
+
+    if (sat_status_get_result (&status) == false)
+    {
+        if (header.future != NULL)
+        {
+            pthread_cond_destroy (&header.future->cond);
+            pthread_mutex_destroy (&header.future->mutex);
+            free (header.future);
+        }
+
+        return status;
+    }
+
+    if (future != NULL)
+        *future = header.future;
+
+    return status;
+}
+
+sat_status_t sat_worker_wait_idle (sat_worker_t *const object)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (object->locals, "worker is not open");
 
     pthread_mutex_lock (&object->mutex);
 
-    sat_status_t status = sat_queue_enqueue (object->queue, data);
-    
-    pthread_cond_signal (&object->cond);
+    // Pairs with the decrement in sat_worker_done, like sleepers and pending.
+    __atomic_add_fetch (&object->idle_waiters, 1, __ATOMIC_SEQ_CST);
+
+    while (__atomic_load_n (&object->outstanding, __ATOMIC_SEQ_CST) > 0)
+        pthread_cond_wait (&object->idle, &object->mutex);
+
+    __atomic_sub_fetch (&object->idle_waiters, 1, __ATOMIC_SEQ_CST);
+
     pthread_mutex_unlock (&object->mutex);
 
-    return status;
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_worker_get_stats (sat_worker_t *const object, sat_worker_stats_t *const stats)
+{
+    sat_status_return_on_null (object, "null object");
+    sat_status_return_on_null (stats, "null stats");
+    sat_status_return_on_null (object->locals, "worker is not open");
+
+    memset (stats, 0, sizeof (sat_worker_stats_t));
+
+    int32_t depth = __atomic_load_n (&object->pending, __ATOMIC_RELAXED);
+
+    stats->depth = depth > 0 ? (uint32_t) depth : 0;
+    stats->depth_max = __atomic_load_n (&object->depth_max, __ATOMIC_RELAXED);
+    stats->capacity = object->capacity;
+    stats->rejected = __atomic_load_n (&object->rejected, __ATOMIC_RELAXED);
+
+    for (uint16_t i = 0; i < object->threads_amount; i++)
+    {
+        sat_worker_local_t *local = &object->locals [i];
+
+        stats->completed += __atomic_load_n (&local->completed, __ATOMIC_RELAXED);
+
+        for (uint32_t j = 0; j < SAT_WORKER_HISTOGRAM_BUCKETS; j++)
+        {
+            stats->wait [j] += __atomic_load_n (&local->wait [j], __ATOMIC_RELAXED);
+            stats->run [j] += __atomic_load_n (&local->run [j], __ATOMIC_RELAXED);
+        }
+    }
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_worker_future_wait (sat_worker_future_t *const future, void *const result)
+{
+    sat_status_return_on_null (future, "null future");
+
+    uint32_t state = __atomic_load_n (&future->state, __ATOMIC_ACQUIRE);
+
+    if (state == sat_worker_future_state_pending)
+    {
+        pthread_mutex_lock (&future->mutex);
+
+        while ((state = __atomic_load_n (&future->state, __ATOMIC_ACQUIRE)) == sat_worker_future_state_pending)
+            pthread_cond_wait (&future->cond, &future->mutex);
+
+        pthread_mutex_unlock (&future->mutex);
+    }
+
+    sat_status_return_on_equals (state, sat_worker_future_state_cancelled, "task cancelled");
+
+    if (result != NULL && future->result_size > 0)
+        memcpy (result, future->result, future->result_size);
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_worker_future_is_done (sat_worker_future_t *const future, bool *const done)
+{
+    sat_status_return_on_null (future, "null future");
+    sat_status_return_on_null (done, "null done");
+
+    *done = __atomic_load_n (&future->state, __ATOMIC_ACQUIRE) != sat_worker_future_state_pending;
+
+    sat_status_return_on_success ();
+}
+
+sat_status_t sat_worker_future_destroy (sat_worker_future_t *const future)
+{
+    sat_status_return_on_null (future, "null future");
+
+    sat_worker_future_release (future);
+
+    sat_status_return_on_success ();
 }
 
 sat_status_t sat_worker_close (sat_worker_t *const object)
 {
     sat_status_return_on_null (object, "null object");
 
-    object->running = false;
-        
-    // Wake up all threads
+    __atomic_store_n (&object->running, false, __ATOMIC_SEQ_CST);
+
+    // Wake up all threads, and the feeders waiting for room
     pthread_mutex_lock (&object->mutex);
     pthread_cond_broadcast (&object->cond);
+    pthread_cond_broadcast (&object->room);
     pthread_mutex_unlock (&object->mutex);
 
     if (object->threads != NULL)
     {
-        for (uint8_t i = 0; i < object->threads_amount; i++)
+        for (uint16_t i = 0; i < object->threads_amount; i++)
         {
             pthread_join (object->threads [i], NULL);
         }
@@ -92,14 +364,32 @@ sat_status_t sat_worker_close (sat_worker_t *const object)
         free (object->threads);
     }
 
-    if (object->queue != NULL)
+    if (object->locals != NULL)
     {
-        sat_queue_destroy (object->queue);
+        // Tasks nobody will run any more still have to release their futures.
+        uint8_t *slot = (uint8_t *) malloc (object->slot_size);
+
+        for (uint16_t i = 0; i < object->threads_amount && slot != NULL; i++)
+        {
+            sat_worker_local_t *local = &object->locals [i];
+
+            for (; local->amount > 0; local->amount --)
+            {
+                sat_queue_dequeue (local->queue, slot);
+                sat_worker_cancel ((sat_worker_slot_t *) slot);
+            }
+        }
+
+        free (slot);
+
+        sat_worker_locals_destroy (object, object->threads_amount);
     }
 
-    // Destroy mutex and condition variable
+    // Destroy mutex and condition variables
     pthread_mutex_destroy (&object->mutex);
     pthread_cond_destroy (&object->cond);
+    pthread_cond_destroy (&object->idle);
+    pthread_cond_destroy (&object->room);
 
     sat_status_return_on_success ();
 }
@@ -110,11 +400,26 @@ static sat_status_t sat_worker_is_args_valid (const sat_worker_args_t *const arg
     sat_status_return_on_null (args->handler, "handler is null");
     sat_status_return_on_equals (args->object_size, 0, "object size is zero");
     sat_status_return_on_equals (args->pool_amount, 0, "pool amount is zero");
+    sat_status_return_on_greater_than (args->placement, sat_worker_placement_explicit, "invalid placement");
+
+    if (args->placement == sat_worker_placement_explicit)
+    {
+        sat_status_return_on_null (args->cpus, "cpus is null");
+        sat_status_return_on_equals (args->cpus_amount, 0, "cpus amount is zero");
+    }
+
+    if (args->high_water > 0)
+    {
+        sat_status_return_on_greater_than_or_equal (args->low_water, args->high_water, "low water mark is not below the high one");
+
+        if (args->capacity > 0)
+            sat_status_return_on_greater_than (args->high_water, args->capacity, "high water mark is above the capacity");
+    }
 
     sat_status_return_on_success ();
 }
 
-static sat_status_t sat_worker_threads_allocation (sat_worker_t *const object, uint8_t amount)
+static sat_status_t sat_worker_threads_allocation (sat_worker_t *const object, uint16_t amount)
 {
     object->threads = (pthread_t *) calloc (1, sizeof (pthread_t) * amount);
 
@@ -123,62 +428,591 @@ static sat_status_t sat_worker_threads_allocation (sat_worker_t *const object, u
     sat_status_return_on_success ();
 }
 
-static sat_status_t sat_worker_threads_start (sat_worker_t *const object)
+static sat_status_t sat_worker_locals_create (sat_worker_t *const object, const sat_worker_args_t *const args)
 {
-    for (uint8_t i = 0; i < object->threads_amount; i++)
+    void *memory = NULL;
+
+    sat_status_return_on_not_equals (posix_memalign (&memory, SAT_WORKER_CACHE_LINE_SIZE, sizeof (sat_worker_local_t) * object->threads_amount), 0, "memory allocation failed");
+
+    object->locals = (sat_worker_local_t *) memory;
+    memset (object->locals, 0, sizeof (sat_worker_local_t) * object->threads_amount);
+
+    sat_status_t status = sat_worker_place (object, args);
+    if (sat_status_get_result (&status) == false)
+    {
+        sat_worker_locals_destroy (object, 0);
+        return status;
+    }
+
+    for (uint16_t i = 0; i < object->threads_amount; i++)
     {
-        if (pthread_create (&object->threads [i], NULL, sat_worker_thread_function, object) != 0)
+        sat_worker_local_t *local = &object->locals [i];
+
+        status = sat_queue_create_with_args (&local->queue, &(sat_queue_args_t)
+                                                            {
+                                                                .object_size = object->slot_size,
+                                                                .mode = sat_queue_mode_ring,
+                                                                .allocator = local->allocator
+                                                            });
+        if (sat_status_get_result (&status) == false)
+        {
+            sat_worker_locals_destroy (object, i);
+            return status;
+        }
+
+        local->staging = (uint8_t *) sat_allocator_allocate_zeroed (&local->allocator, (size_t) object->batch_size * object->slot_size);
+        if (local->staging == NULL)
+        {
+            sat_queue_destroy (local->queue);
+            sat_worker_locals_destroy (object, i);
+            sat_status_return_on_failure ("memory allocation failed");
+        }
+
+        pthread_mutex_init (&local->mutex, NULL);
+        local->worker = object;
+        local->index = i;
+    }
+
+    sat_status_return_on_success ();
+}
+
+// Picks the CPU of every thread and, when the host has several NUMA nodes,
+// an allocator that keeps the memory of the thread on the node of its CPU.
+static sat_status_t sat_worker_place (sat_worker_t *const object, const sat_worker_args_t *const args)
+{
+    for (uint16_t i = 0; i < object->threads_amount; i++)
+        object->locals [i].cpu = -1;
+
+    if (args->placement == sat_worker_placement_none)
+        sat_status_return_on_success ();
+
+    sat_topology_init (&object->topology);
+    sat_status_return_on_error (sat_topology_open (&object->topology, NULL));
+
+    uint32_t *cpus = (uint32_t *) calloc (object->threads_amount, sizeof (uint32_t));
+    sat_status_return_on_null (cpus, "memory allocation failed");
+
+    sat_status_t status = sat_status_set (&status, true, __func__, "");
+
+    if (args->placement == sat_worker_placement_explicit)
+    {
+        for (uint16_t i = 0; i < object->threads_amount; i++)
+            cpus [i] = args->cpus [i % args->cpus_amount];
+    }
+    else
+    {
+        sat_topology_policy_t policy = args->placement == sat_worker_placement_compact ? sat_topology_policy_compact : sat_topology_policy_scatter;
+
+        status = sat_topology_order (&object->topology, policy, cpus, object->threads_amount);
+    }
+
+    for (uint16_t i = 0; i < object->threads_amount && sat_status_get_result (&status) == true; i++)
+    {
+        sat_worker_local_t *local = &object->locals [i];
+        const sat_topology_cpu_t *cpu;
+
+        status = sat_topology_find (&object->topology, cpus [i], &cpu);
+        if (sat_status_get_result (&status) == false)
+            break;
+
+        local->cpu = (int32_t) cpu->id;
+
+        if (object->topology.nodes_amount > 1)
+            status = sat_topology_get_allocator (&object->topology, cpu->node, &local->allocator);
+    }
+
+    free (cpus);
+
+    return status;
+}
+
+static void sat_worker_locals_destroy (sat_worker_t *const object, const uint16_t amount)
+{
+    for (uint16_t i = 0; i < amount; i++)
+    {
+        sat_worker_local_t *local = &object->locals [i];
+
+        sat_queue_destroy (local->queue);
+        sat_allocator_release (&local->allocator, local->staging, (size_t) object->batch_size * object->slot_size);
+        pthread_mutex_destroy (&local->mutex);
+    }
+
+    free (object->locals);
+    object->locals = NULL;
+
+    // The allocators of the locals point into the topology.
+    sat_topology_close (&object->topology);
+}
+
+static sat_status_t sat_worker_threads_start (sat_worker_t *const object, const char *const name)
+{
+    for (uint16_t i = 0; i < object->threads_amount; i++)
+    {
+        sat_worker_local_t *local = &object->locals [i];
+        pthread_attr_t attributes;
+        cpu_set_t *set = NULL;
+
+        pthread_attr_init (&attributes);
+
+        // Pinned before it starts, so the thread never runs anywhere else.
+        if (local->cpu >= 0 && (set = CPU_ALLOC (local->cpu + 1)) != NULL)
+        {
+            size_t size = CPU_ALLOC_SIZE (local->cpu + 1);
+
+            CPU_ZERO_S (size, set);
+            CPU_SET_S (local->cpu, size, set);
+            pthread_attr_setaffinity_np (&attributes, size, set);
+        }
+
+        int result = pthread_create (&object->threads [i], &attributes, sat_worker_thread_function, local);
+
+        pthread_attr_destroy (&attributes);
+
+        if (set != NULL)
+            CPU_FREE (set);
+
+        if (result != 0)
         {
             // If thread creation fails, we need to clean up the threads that were already created
-            for (uint8_t j = 0; j < i; j++)
+            __atomic_store_n (&object->running, false, __ATOMIC_SEQ_CST);
+
+            pthread_mutex_lock (&object->mutex);
+            pthread_cond_broadcast (&object->cond);
+            pthread_mutex_unlock (&object->mutex);
+
+            for (uint16_t j = 0; j < i; j++)
             {
                 pthread_join (object->threads [j], NULL);
             }
-            
+
             free (object->threads);
             sat_status_return_on_failure ("thread creation failed");
         }
+
+        char suffix [8];
+        char label [SAT_WORKER_NAME_SIZE];
+
+        // The index is kept whole, the prefix gives way.
+        snprintf (suffix, sizeof (suffix), "/%u", (unsigned) i);
+        snprintf (label, sizeof (label), "%.*s%s", (int) (sizeof (label) - 1 - strlen (suffix)), name, suffix);
+
+        pthread_setname_np (object->threads [i], label);
     }
 
     sat_status_return_on_success ();
 }
 
+static sat_status_t sat_worker_enqueue (sat_worker_t *const object, const void *const data, const uint32_t amount, const sat_worker_slot_t *const header, const int64_t timeout)
+{
+    sat_status_return_on_error (sat_worker_reserve (object, amount, timeout));
+
+    sat_worker_local_t *local = sat_worker_local_for_feed (object);
+    sat_status_t status = sat_status_set (&status, true, __func__, "");
+    uint32_t enqueued = 0;
+    uint64_t now = sat_worker_now ();
+
+    // Counted before the tasks become visible so that a fast completion never
+    // brings the count below zero.
+    __atomic_add_fetch (&object->outstanding, amount, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_lock (&local->mutex);
+
+    while (enqueued < amount)
+    {
+        uint32_t chunk = amount - enqueued < object->batch_size ? amount - enqueued : object->batch_size;
+
+        for (uint32_t i = 0; i < chunk; i++)
+        {
+            sat_worker_slot_t *slot = (sat_worker_slot_t *) (local->staging + (size_t) i * object->slot_size);
+
+            if (header != NULL)
+                *slot = *header;
+            else
+                memset (slot, 0, sizeof (sat_worker_slot_t));
+
+            slot->enqueued = now;
+            memcpy (slot + 1, (const uint8_t *) data + (size_t) (enqueued + i) * object->object_size, object->object_size);
+        }
+
+        status = sat_queue_enqueue_many (local->queue, local->staging, chunk);
+        if (sat_status_get_result (&status) == false)
+            break;
+
+        enqueued += chunk;
+        __atomic_add_fetch (&local->amount, chunk, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_unlock (&local->mutex);
+
+    if (enqueued > 0)
+        sat_worker_wake (object, enqueued);
+
+    if (enqueued < amount)
+    {
+        sat_worker_unreserve (object, amount - enqueued);
+        sat_worker_done (object, amount - enqueued);
+    }
+
+    return status;
+}
+
+static bool sat_worker_try_reserve (sat_worker_t *const object, const uint32_t amount)
+{
+    int32_t depth = __atomic_load_n (&object->pending, __ATOMIC_RELAXED);
+
+    // The depth is counted before the tasks are queued, so sat_worker_sleep
+    // may briefly see work that is not visible yet; it then just retries.
+    do
+    {
+        if (object->capacity > 0 && (int64_t) depth + amount > object->capacity)
+            return false;
+    }
+    while (__atomic_compare_exchange_n (&object->pending, &depth, depth + (int32_t) amount, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) == false);
+
+    uint32_t reached = (uint32_t) depth + amount;
+    uint32_t max = __atomic_load_n (&object->depth_max, __ATOMIC_RELAXED);
+
+    while (reached > max && __atomic_compare_exchange_n (&object->depth_max, &max, reached, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false)
+        ;
+
+    if (object->high_water > 0 && reached >= object->high_water)
+    {
+        bool saturated = false;
+
+        if (__atomic_compare_exchange_n (&object->saturated, &saturated, true, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) == true &&
+            object->on_high_water != NULL)
+        {
+            object->on_high_water (object->user, reached);
+        }
+    }
+
+    return true;
+}
+
+static sat_status_t sat_worker_reserve (sat_worker_t *const object, const uint32_t amount, const int64_t timeout)
+{
+    sat_status_return_on_false ((object->capacity == 0 || amount <= object->capacity), "amount exceeds the capacity");
+
+    if (sat_worker_try_reserve (object, amount) == true)
+        sat_status_return_on_success ();
+
+    // A handler waiting for room in its own pool could wait for itself.
+    if (timeout == 0 || (sat_worker_current != NULL && sat_worker_current->worker == object))
+    {
+        __atomic_add_fetch (&object->rejected, 1, __ATOMIC_RELAXED);
+        sat_status_return_on_failure ("worker is full");
+    }
+
+    struct timespec deadline;
+    clock_gettime (CLOCK_MONOTONIC, &deadline);
+
+    if (timeout > 0)
+    {
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (timeout % 1000) * 1000000;
+
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec ++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    bool reserved = false;
+
+    pthread_mutex_lock (&object->mutex);
+
+    // Pairs with the load in sat_worker_unreserve, like sleepers and pending.
+    __atomic_add_fetch (&object->feed_waiters, 1, __ATOMIC_SEQ_CST);
+
+    while ((reserved = sat_worker_try_reserve (object, amount)) == false &&
+           __atomic_load_n (&object->running, __ATOMIC_SEQ_CST) == true)
+    {
+        if (timeout < 0)
+            pthread_cond_wait (&object->room, &object->mutex);
+
+        else if (pthread_cond_timedwait (&object->room, &object->mutex, &deadline) == ETIMEDOUT)
+        {
+            reserved = sat_worker_try_reserve (object, amount);
+            break;
+        }
+    }
+
+    __atomic_sub_fetch (&object->feed_waiters, 1, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock (&object->mutex);
+
+    if (reserved == false)
+    {
+        __atomic_add_fetch (&object->rejected, 1, __ATOMIC_RELAXED);
+        sat_status_return_on_failure ("worker is full");
+    }
+
+    sat_status_return_on_success ();
+}
+
+static void sat_worker_unreserve (sat_worker_t *const object, const uint32_t amount)
+{
+    int32_t depth = __atomic_sub_fetch (&object->pending, (int32_t) amount, __ATOMIC_SEQ_CST);
+
+    if (object->high_water > 0 && depth <= (int32_t) object->low_water)
+    {
+        bool saturated = true;
+
+        if (__atomic_compare_exchange_n (&object->saturated, &saturated, false, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) == true &&
+            object->on_low_water != NULL)
+        {
+            object->on_low_water (object->user, (uint32_t) depth);
+        }
+    }
+
+    if (object->capacity == 0 || __atomic_load_n (&object->feed_waiters, __ATOMIC_SEQ_CST) == 0)
+        return;
+
+    pthread_mutex_lock (&object->mutex);
+    pthread_cond_broadcast (&object->room);
+    pthread_mutex_unlock (&object->mutex);
+}
+
+static sat_worker_local_t *sat_worker_local_for_feed (sat_worker_t *const object)
+{
+    // Work spawned by a handler stays with its thread, where it is still cache hot.
+    if (sat_worker_current != NULL && sat_worker_current->worker == object)
+        return sat_worker_current;
+
+    uint32_t next = __atomic_fetch_add (&object->next, 1, __ATOMIC_RELAXED);
+
+    return &object->locals [next % object->threads_amount];
+}
+
+static void sat_worker_wake (sat_worker_t *const object, const uint32_t amount)
+{
+    // Pairs with the sleepers increment in sat_worker_sleep: either the sleeper
+    // sees the new pending count or this load sees the sleeper.
+    if (__atomic_load_n (&object->sleepers, __ATOMIC_SEQ_CST) == 0)
+        return;
+
+    pthread_mutex_lock (&object->mutex);
+
+    if (amount > 1)
+        pthread_cond_broadcast (&object->cond);
+    else
+        pthread_cond_signal (&object->cond);
+
+    pthread_mutex_unlock (&object->mutex);
+}
+
+static void sat_worker_done (sat_worker_t *const object, const uint32_t amount)
+{
+    if (__atomic_sub_fetch (&object->outstanding, amount, __ATOMIC_SEQ_CST) > 0)
+        return;
+
+    if (__atomic_load_n (&object->idle_waiters, __ATOMIC_SEQ_CST) == 0)
+        return;
+
+    pthread_mutex_lock (&object->mutex);
+    pthread_cond_broadcast (&object->idle);
+    pthread_mutex_unlock (&object->mutex);
+}
+
+static void sat_worker_run (sat_worker_t *const worker, sat_worker_slot_t *const slot)
+{
+    void *const object = slot + 1;
+    void *const result = (slot->future != NULL && slot->future->result_size > 0) ? slot->future->result : NULL;
+
+    if (slot->task != NULL)
+        slot->task (object, result);
+    else
+        worker->handler (object);
+
+    if (slot->on_complete != NULL)
+        slot->on_complete (slot->user, object, result);
+
+    if (slot->future != NULL)
+    {
+        sat_worker_future_complete (slot->future, sat_worker_future_state_done);
+        sat_worker_future_release (slot->future);
+    }
+}
+
+static void sat_worker_cancel (sat_worker_slot_t *const slot)
+{
+    if (slot->future != NULL)
+    {
+        sat_worker_future_complete (slot->future, sat_worker_future_state_cancelled);
+        sat_worker_future_release (slot->future);
+    }
+}
+
+static void sat_worker_future_complete (sat_worker_future_t *const future, const uint32_t state)
+{
+    pthread_mutex_lock (&future->mutex);
+
+    __atomic_store_n (&future->state, state, __ATOMIC_RELEASE);
+    pthread_cond_broadcast (&future->cond);
+
+    pthread_mutex_unlock (&future->mutex);
+}
+
+static void sat_worker_future_release (sat_worker_future_t *const future)
+{
+    if (__atomic_sub_fetch (&future->references, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    pthread_cond_destroy (&future->cond);
+    pthread_mutex_destroy (&future->mutex);
+    free (future);
+}
+
+static uint32_t sat_worker_take (sat_worker_local_t *const local, uint8_t *const batch, const uint32_t limit)
+{
+    uint32_t taken = 0;
+
+    if (__atomic_load_n (&local->amount, __ATOMIC_RELAXED) == 0)
+        return 0;
+
+    pthread_mutex_lock (&local->mutex);
+
+    sat_queue_dequeue_many (local->queue, batch, limit, &taken);
+    __atomic_sub_fetch (&local->amount, taken, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock (&local->mutex);
+
+    return taken;
+}
+
+static uint32_t sat_worker_steal (sat_worker_local_t *const self, uint8_t *const batch)
+{
+    sat_worker_t *worker = self->worker;
+
+    for (uint16_t i = 1; i < worker->threads_amount; i++)
+    {
+        sat_worker_local_t *victim = &worker->locals [(self->index + i) % worker->threads_amount];
+        uint32_t taken = 0;
+
+        // Peek without the lock first so that empty victims cost nothing.
+        if (__atomic_load_n (&victim->amount, __ATOMIC_RELAXED) == 0)
+            continue;
+
+        pthread_mutex_lock (&victim->mutex);
+
+        // Take half of the victim's work, so that it keeps the rest for itself.
+        uint32_t limit = (victim->amount + 1) / 2;
+        if (limit > worker->batch_size)
+            limit = worker->batch_size;
+
+        if (limit > 0)
+        {
+            sat_queue_dequeue_many (victim->queue, batch, limit, &taken);
+            __atomic_sub_fetch (&victim->amount, taken, __ATOMIC_RELAXED);
+        }
+
+        pthread_mutex_unlock (&victim->mutex);
+
+        if (taken > 0)
+            return taken;
+    }
+
+    return 0;
+}
+
+static void sat_worker_sleep (sat_worker_t *const worker)
+{
+    pthread_mutex_lock (&worker->mutex);
+
+    __atomic_add_fetch (&worker->sleepers, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n (&worker->pending, __ATOMIC_SEQ_CST) <= 0 &&
+        __atomic_load_n (&worker->running, __ATOMIC_SEQ_CST) == true)
+    {
+        pthread_cond_wait (&worker->cond, &worker->mutex);
+    }
+
+    __atomic_sub_fetch (&worker->sleepers, 1, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock (&worker->mutex);
+}
+
+static uint64_t sat_worker_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static void sat_worker_record (uint64_t *const histogram, const uint64_t nanoseconds)
+{
+    uint64_t microseconds = nanoseconds / 1000;
+    uint32_t bucket = microseconds == 0 ? 0 : 64 - __builtin_clzll (microseconds);
+
+    if (bucket >= SAT_WORKER_HISTOGRAM_BUCKETS)
+        bucket = SAT_WORKER_HISTOGRAM_BUCKETS - 1;
+
+    // Single writer: a plain increment published atomically for the readers.
+    __atomic_store_n (&histogram [bucket], histogram [bucket] + 1, __ATOMIC_RELAXED);
+}
+
 static void *sat_worker_thread_function (void *const args)
 {
-    sat_worker_t *const worker = (sat_worker_t *const)args;
-    sat_status_t status;
+    sat_worker_local_t *const local = (sat_worker_local_t *const) args;
+    sat_worker_t *const worker = local->worker;
 
-    uint8_t *const object = (uint8_t *const) malloc (worker->object_size);
-    if (object == NULL)
+    uint8_t *const batch = (uint8_t *const) sat_allocator_allocate (&local->allocator, (size_t) worker->slot_size * worker->batch_size);
+    if (batch == NULL)
     {
         return NULL;
     }
 
-    while (worker->running)
+    sat_worker_current = local;
+
+    while (__atomic_load_n (&worker->running, __ATOMIC_ACQUIRE))
     {
-        pthread_mutex_lock (&worker->mutex);
+        uint32_t taken = sat_worker_take (local, batch, worker->batch_size);
 
-        memset (object, 0, worker->object_size);
-        status = sat_queue_dequeue (worker->queue, object);
+        if (taken == 0)
+            taken = sat_worker_steal (local, batch);
 
-        if (sat_status_get_result (&status) == false)
+        if (taken == 0)
         {
-            pthread_cond_wait (&worker->cond, &worker->mutex);
-            if (worker->running)
-            {
-                status = sat_queue_dequeue (worker->queue, object);
-            }
+            sat_worker_sleep (worker);
+            continue;
         }
 
-        if (sat_status_get_result (&status) == true && worker->running)
+        sat_worker_unreserve (worker, taken);
+
+        // Handlers run with no lock held, so the whole pool works in parallel.
+        // Each clock read ends one task and starts the next.
+        uint64_t start = sat_worker_now ();
+
+        for (uint32_t i = 0; i < taken; i++)
         {
-            worker->handler (object);
+            sat_worker_slot_t *slot = (sat_worker_slot_t *) (batch + (size_t) i * worker->slot_size);
+
+            if (__atomic_load_n (&worker->running, __ATOMIC_RELAXED) == false)
+            {
+                sat_worker_cancel (slot);
+                continue;
+            }
+
+            sat_worker_record (local->wait, start > slot->enqueued ? start - slot->enqueued : 0);
+
+            sat_worker_run (worker, slot);
+
+            uint64_t end = sat_worker_now ();
+
+            sat_worker_record (local->run, end - start);
+            __atomic_store_n (&local->completed, local->completed + 1, __ATOMIC_RELAXED);
+
+            start = end;
         }
 
-        pthread_mutex_unlock (&worker->mutex);
+        sat_worker_done (worker, taken);
     }
 
-    free (object);
+    sat_worker_current = NULL;
+
+    sat_allocator_release (&local->allocator, batch, (size_t) worker->slot_size * worker->batch_size);
 
     return NULL;
-}
\ No newline at end of file
+}
@@ -0,0 +1,135 @@
+#include <sat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+/*
+ * Scaling benchmark: feeds small CPU-bound tasks to pools of 1 up to N
+ * threads, once one task per sat_worker_feed call and once in bursts through
+ * sat_worker_feed_many, and reports the completed tasks per second.
+ *
+ * The placement (none, compact or scatter) pins the threads; on hosts with
+ * several NUMA nodes, compare the policies with a work per task that touches
+ * memory as much as it computes.
+ *
+ * usage: sat_worker_benchmark [tasks] [max threads] [work per task] [placement]
+ */
+
+#define BENCHMARK_TASKS_DEFAULT         1000000
+#define BENCHMARK_THREADS_DEFAULT       8
+#define BENCHMARK_WORK_DEFAULT          200
+#define BENCHMARK_BURST                 64
+
+typedef struct
+{
+    uint64_t seed;
+    uint32_t work;
+} benchmark_task_t;
+
+static uint64_t benchmark_done;
+static uint64_t benchmark_sink;
+
+static double benchmark_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static void benchmark_handler (void *object)
+{
+    benchmark_task_t *task = (benchmark_task_t *) object;
+    uint64_t x = task->seed;
+
+    for (uint32_t i = 0; i < task->work; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+
+    __atomic_add_fetch (&benchmark_sink, x & 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch (&benchmark_done, 1, __ATOMIC_RELEASE);
+}
+
+static double benchmark_run (uint16_t threads, uint64_t tasks, uint32_t work, bool burst, sat_worker_placement_t placement)
+{
+    sat_worker_t worker;
+    benchmark_task_t batch [BENCHMARK_BURST];
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                                    {
+                                                        .handler = benchmark_handler,
+                                                        .object_size = sizeof (benchmark_task_t),
+                                                        .pool_amount = threads,
+                                                        .placement = placement,
+                                                    });
+    if (sat_status_get_result (&status) == false)
+        return 0.0;
+
+    __atomic_store_n (&benchmark_done, 0, __ATOMIC_RELAXED);
+
+    double start = benchmark_now ();
+
+    for (uint64_t i = 0; i < tasks; i += BENCHMARK_BURST)
+    {
+        uint32_t amount = tasks - i < BENCHMARK_BURST ? (uint32_t) (tasks - i) : BENCHMARK_BURST;
+
+        for (uint32_t j = 0; j < amount; j++)
+            batch [j] = (benchmark_task_t) {.seed = i + j + 1, .work = work};
+
+        if (burst == true)
+            sat_worker_feed_many (&worker, batch, amount);
+        else
+        {
+            for (uint32_t j = 0; j < amount; j++)
+                sat_worker_feed (&worker, &batch [j]);
+        }
+    }
+
+    while (__atomic_load_n (&benchmark_done, __ATOMIC_ACQUIRE) < tasks)
+        sched_yield ();
+
+    double elapsed = benchmark_now () - start;
+
+    sat_worker_close (&worker);
+
+    return (double) tasks / elapsed / 1e6;
+}
+
+int main (int argc, char *argv[])
+{
+    uint64_t tasks = argc > 1 ? strtoull (argv [1], NULL, 10) : BENCHMARK_TASKS_DEFAULT;
+    uint32_t max_threads = argc > 2 ? (uint32_t) strtoul (argv [2], NULL, 10) : BENCHMARK_THREADS_DEFAULT;
+    uint32_t work = argc > 3 ? (uint32_t) strtoul (argv [3], NULL, 10) : BENCHMARK_WORK_DEFAULT;
+    const char *placement = argc > 4 ? argv [4] : "none";
+    sat_worker_placement_t policy = sat_worker_placement_none;
+
+    if (max_threads == 0 || max_threads > UINT16_MAX)
+        max_threads = BENCHMARK_THREADS_DEFAULT;
+
+    if (strcmp (placement, "compact") == 0)
+        policy = sat_worker_placement_compact;
+    else if (strcmp (placement, "scatter") == 0)
+        policy = sat_worker_placement_scatter;
+    else
+        placement = "none";
+
+    printf ("%lu tasks, %u rounds of work per task, placement %s\n", (unsigned long) tasks, work, placement);
+    printf ("%-8s %20s %20s\n", "threads", "feed Mtasks/s", "feed_many Mtasks/s");
+
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double single = benchmark_run ((uint16_t) threads, tasks, work, false, policy);
+        double burst = benchmark_run ((uint16_t) threads, tasks, work, true, policy);
+
+        printf ("%-8u %20.2f %20.2f\n", threads, single, burst);
+    }
+
+    return benchmark_sink == UINT64_MAX;
+}
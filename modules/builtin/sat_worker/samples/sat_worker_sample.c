@@ -1,7 +1,78 @@
 #include <sat.h>
+#include <stdio.h>
+
+#define SAMPLE_PARTS        8
+#define SAMPLE_PART_SIZE    1000
+
+typedef struct
+{
+    uint32_t from;
+    uint32_t to;
+} part_t;
+
+static void print_part (void *const object)
+{
+    part_t *part = (part_t *) object;
+
+    printf ("fed part [%u, %u)\n", part->from, part->to);
+}
+
+static void sum_part (void *const object, void *const result)
+{
+    part_t *part = (part_t *) object;
+    uint64_t sum = 0;
+
+    for (uint32_t i = part->from; i < part->to; i++)
+        sum += i;
+
+    *(uint64_t *) result = sum;
+}
 
 int main (int argc, char **argv)
 {
-    
+    sat_worker_t worker;
+    sat_worker_future_t *futures [SAMPLE_PARTS];
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                                    {
+                                                        .handler = print_part,
+                                                        .object_size = sizeof (part_t),
+                                                        .pool_amount = 4,
+                                                    });
+    if (sat_status_get_result (&status) == false)
+        return 1;
+
+    // Fire and forget, then wait for the pool to drain.
+    for (uint32_t i = 0; i < SAMPLE_PARTS; i++)
+        sat_worker_feed (&worker, &(part_t) {.from = i * SAMPLE_PART_SIZE, .to = (i + 1) * SAMPLE_PART_SIZE});
+
+    sat_worker_wait_idle (&worker);
+
+    // Fan out with futures and join the results.
+    for (uint32_t i = 0; i < SAMPLE_PARTS; i++)
+    {
+        sat_worker_submit (&worker, &(part_t) {.from = i * SAMPLE_PART_SIZE, .to = (i + 1) * SAMPLE_PART_SIZE},
+                           &(sat_worker_submit_args_t) {.task = sum_part, .result_size = sizeof (uint64_t)},
+                           &futures [i]);
+    }
+
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < SAMPLE_PARTS; i++)
+    {
+        uint64_t sum = 0;
+
+        sat_worker_future_wait (futures [i], &sum);
+        sat_worker_future_destroy (futures [i]);
+
+        total += sum;
+    }
+
+    printf ("sum of [0, %u) = %lu\n", SAMPLE_PARTS * SAMPLE_PART_SIZE, (unsigned long) total);
+
+    sat_worker_close (&worker);
+
     return 0;
 }
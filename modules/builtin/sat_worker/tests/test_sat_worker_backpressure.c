@@ -0,0 +1,351 @@
+#include <sat.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+typedef struct
+{
+    uint32_t kind;
+} task_t;
+
+enum
+{
+    task_kind_plain,
+    task_kind_gated,
+    task_kind_slow,
+    task_kind_refeed,
+};
+
+static sat_worker_t *test_worker;
+static uint32_t test_gate;
+static uint32_t test_started;
+static uint32_t test_refeed_failed;
+static uint32_t test_refeed_started;
+static uint32_t test_filled;
+static uint32_t test_high_calls;
+static uint32_t test_low_calls;
+static uint32_t test_high_depth;
+
+static void handler (void *const object)
+{
+    task_t *task = (task_t *) object;
+
+    switch (task->kind)
+    {
+        case task_kind_gated:
+            __atomic_store_n (&test_started, 1, __ATOMIC_RELEASE);
+
+            while (__atomic_load_n (&test_gate, __ATOMIC_ACQUIRE) == 0)
+                usleep (1000);
+            break;
+
+        case task_kind_slow:
+            usleep (2000);
+            break;
+
+        case task_kind_refeed:
+        {
+            __atomic_store_n (&test_refeed_started, 1, __ATOMIC_RELEASE);
+
+            while (__atomic_load_n (&test_filled, __ATOMIC_ACQUIRE) == 0)
+                usleep (1000);
+
+            // The pool is full: a blocking feed from a handler must fail, not hang.
+            sat_status_t status = sat_worker_feed (test_worker, &(task_t) {.kind = task_kind_plain});
+            if (sat_status_get_result (&status) == false)
+                __atomic_store_n (&test_refeed_failed, 1, __ATOMIC_RELEASE);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+static void on_high_water (void *const user, const uint32_t depth)
+{
+    (void) user;
+
+    __atomic_add_fetch (&test_high_calls, 1, __ATOMIC_RELAXED);
+    __atomic_store_n (&test_high_depth, depth, __ATOMIC_RELAXED);
+}
+
+static void on_low_water (void *const user, const uint32_t depth)
+{
+    (void) depth;
+
+    __atomic_add_fetch (&test_low_calls, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch ((uint32_t *) user, 1, __ATOMIC_RELAXED);
+}
+
+static double test_now (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+static void test_block_worker (sat_worker_t *const worker)
+{
+    test_gate = 0;
+    test_started = 0;
+
+    sat_status_t status = sat_worker_feed (worker, &(task_t) {.kind = task_kind_gated});
+    assert (sat_status_get_result (&status) == true);
+
+    while (__atomic_load_n (&test_started, __ATOMIC_ACQUIRE) == 0)
+        usleep (1000);
+}
+
+static void *blocking_feeder (void *args)
+{
+    sat_status_t status = sat_worker_feed ((sat_worker_t *) args, &(task_t) {.kind = task_kind_plain});
+    assert (sat_status_get_result (&status) == true);
+
+    return NULL;
+}
+
+static void test_feed_modes (void)
+{
+    sat_worker_t worker;
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                                    {
+                                                        .handler = handler,
+                                                        .object_size = sizeof (task_t),
+                                                        .pool_amount = 1,
+                                                        .capacity = 4,
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    test_block_worker (&worker);
+
+    for (int i = 0; i < 4; i++)
+    {
+        status = sat_worker_try_feed (&worker, &(task_t) {.kind = task_kind_plain});
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    status = sat_worker_try_feed (&worker, &(task_t) {.kind = task_kind_plain});
+    assert (sat_status_get_result (&status) == false);
+
+    double start = test_now ();
+
+    status = sat_worker_feed_timed (&worker, &(task_t) {.kind = task_kind_plain}, 50);
+    assert (sat_status_get_result (&status) == false);
+    assert (test_now () - start >= 0.045);
+
+    // More than the capacity can never fit.
+    task_t burst [5] = {0};
+    status = sat_worker_feed_many (&worker, burst, 5);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_worker_stats_t stats;
+    status = sat_worker_get_stats (&worker, &stats);
+    assert (sat_status_get_result (&status) == true);
+    assert (stats.depth == 4);
+    assert (stats.depth_max == 4);
+    assert (stats.capacity == 4);
+    assert (stats.rejected == 2);
+
+    // A blocking feeder waits until the gate opens and room is made.
+    pthread_t feeder;
+    pthread_create (&feeder, NULL, blocking_feeder, &worker);
+
+    usleep (20000);
+    __atomic_store_n (&test_gate, 1, __ATOMIC_RELEASE);
+
+    pthread_join (feeder, NULL);
+
+    sat_worker_wait_idle (&worker);
+
+    sat_worker_get_stats (&worker, &stats);
+    assert (stats.depth == 0);
+    assert (stats.completed == 6);
+
+    sat_worker_close (&worker);
+}
+
+static void test_water_marks (void)
+{
+    sat_worker_t worker;
+    uint32_t user = 0;
+
+    test_high_calls = 0;
+    test_low_calls = 0;
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                                    {
+                                                        .handler = handler,
+                                                        .object_size = sizeof (task_t),
+                                                        .pool_amount = 1,
+                                                        .capacity = 8,
+                                                        .high_water = 6,
+                                                        .low_water = 2,
+                                                        .on_high_water = on_high_water,
+                                                        .on_low_water = on_low_water,
+                                                        .user = &user,
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int round = 0; round < 2; round++)
+    {
+        test_block_worker (&worker);
+
+        for (int i = 0; i < 5; i++)
+            sat_worker_feed (&worker, &(task_t) {.kind = task_kind_plain});
+
+        assert (test_high_calls == (uint32_t) round);
+
+        for (int i = 0; i < 3; i++)
+            sat_worker_feed (&worker, &(task_t) {.kind = task_kind_plain});
+
+        // Crossed once, no matter how many feeds stay above the mark.
+        assert (test_high_calls == (uint32_t) round + 1);
+        assert (test_high_depth == 6);
+        assert (test_low_calls == (uint32_t) round);
+
+        __atomic_store_n (&test_gate, 1, __ATOMIC_RELEASE);
+        sat_worker_wait_idle (&worker);
+
+        assert (test_low_calls == (uint32_t) round + 1);
+    }
+
+    assert (user == 2);
+
+    sat_worker_close (&worker);
+}
+
+static void test_histograms (void)
+{
+    sat_worker_t worker;
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                                    {
+                                                        .handler = handler,
+                                                        .object_size = sizeof (task_t),
+                                                        .pool_amount = 2,
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    for (int i = 0; i < 20; i++)
+        sat_worker_feed (&worker, &(task_t) {.kind = task_kind_slow});
+
+    sat_worker_wait_idle (&worker);
+
+    sat_worker_stats_t stats;
+    sat_worker_get_stats (&worker, &stats);
+
+    uint64_t waited = 0;
+    uint64_t ran = 0;
+    uint64_t slow = 0;
+
+    for (uint32_t i = 0; i < SAT_WORKER_HISTOGRAM_BUCKETS; i++)
+    {
+        waited += stats.wait [i];
+        ran += stats.run [i];
+
+        // 2 ms lands in [1024, 2048) microseconds or above.
+        if (i >= 11)
+            slow += stats.run [i];
+    }
+
+    assert (stats.completed == 20);
+    assert (waited == 20);
+    assert (ran == 20);
+    assert (slow == 20);
+
+    sat_worker_close (&worker);
+}
+
+static void test_handler_never_blocks (void)
+{
+    sat_worker_t worker;
+
+    test_worker = &worker;
+    test_refeed_failed = 0;
+    test_refeed_started = 0;
+    test_filled = 0;
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                                    {
+                                                        .handler = handler,
+                                                        .object_size = sizeof (task_t),
+                                                        .pool_amount = 1,
+                                                        .capacity = 2,
+                                                        .batch_size = 1,
+                                                    });
+    assert (sat_status_get_result (&status) == true);
+
+    sat_worker_feed (&worker, &(task_t) {.kind = task_kind_refeed});
+
+    while (__atomic_load_n (&test_refeed_started, __ATOMIC_ACQUIRE) == 0)
+        usleep (1000);
+
+    // The only thread is busy in the handler, so nothing drains the pool.
+    for (int i = 0; i < 2; i++)
+    {
+        status = sat_worker_try_feed (&worker, &(task_t) {.kind = task_kind_plain});
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    __atomic_store_n (&test_filled, 1, __ATOMIC_RELEASE);
+    sat_worker_wait_idle (&worker);
+
+    assert (test_refeed_failed == 1);
+
+    sat_worker_close (&worker);
+}
+
+static void test_invalid (void)
+{
+    sat_worker_t worker;
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                                    {
+                                                        .handler = handler,
+                                                        .object_size = sizeof (task_t),
+                                                        .pool_amount = 1,
+                                                        .high_water = 4,
+                                                        .low_water = 4,
+                                                    });
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_worker_open (&worker, &(sat_worker_args_t)
+                                       {
+                                           .handler = handler,
+                                           .object_size = sizeof (task_t),
+                                           .pool_amount = 1,
+                                           .capacity = 4,
+                                           .high_water = 8,
+                                       });
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_worker_try_feed (&worker, &(task_t) {0});
+    assert (sat_status_get_result (&status) == false);
+
+    sat_worker_close (&worker);
+}
+
+int main (int argc, char *argv[])
+{
+    test_feed_modes ();
+    test_water_marks ();
+    test_histograms ();
+    test_handler_never_blocks ();
+    test_invalid ();
+
+    return 0;
+}
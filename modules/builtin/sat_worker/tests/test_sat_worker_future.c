@@ -0,0 +1,256 @@
+#include <sat.h>
+#include <assert.h>
+#include <unistd.h>
+
+#define TEST_TASKS          256
+
+typedef struct
+{
+    uint32_t from;
+    uint32_t to;
+} range_t;
+
+static uint32_t test_handled;
+static uint32_t test_completed;
+static uint32_t test_gate;
+static uint32_t test_started;
+
+static void handler (void *const object)
+{
+    (void) object;
+
+    usleep (100);
+    __atomic_add_fetch (&test_handled, 1, __ATOMIC_RELAXED);
+}
+
+static void sum_range (void *const object, void *const result)
+{
+    range_t *range = (range_t *) object;
+    uint64_t sum = 0;
+
+    for (uint32_t i = range->from; i < range->to; i++)
+        sum += i;
+
+    *(uint64_t *) result = sum;
+}
+
+static void wait_gate (void *const object, void *const result)
+{
+    (void) object;
+    (void) result;
+
+    __atomic_store_n (&test_started, 1, __ATOMIC_RELEASE);
+
+    while (__atomic_load_n (&test_gate, __ATOMIC_ACQUIRE) == 0)
+        usleep (1000);
+}
+
+static void on_complete (void *const user, void *const object, void *const result)
+{
+    uint64_t *total = (uint64_t *) user;
+
+    (void) object;
+
+    __atomic_add_fetch (total, *(uint64_t *) result, __ATOMIC_RELAXED);
+    __atomic_add_fetch (&test_completed, 1, __ATOMIC_RELAXED);
+}
+
+static void test_open (sat_worker_t *const worker, const uint8_t threads)
+{
+    sat_status_t status = sat_worker_init (worker);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_worker_open (worker, &(sat_worker_args_t)
+                                      {
+                                          .handler = handler,
+                                          .object_size = sizeof (range_t),
+                                          .pool_amount = threads,
+                                      });
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_future_result (void)
+{
+    sat_worker_t worker;
+    sat_worker_future_t *futures [TEST_TASKS];
+
+    test_open (&worker, 4);
+
+    // Fan out the sum of 0..TEST_TASKS*100 and join it through the futures.
+    for (uint32_t i = 0; i < TEST_TASKS; i++)
+    {
+        range_t range = {.from = i * 100, .to = (i + 1) * 100};
+
+        sat_status_t status = sat_worker_submit (&worker, &range, &(sat_worker_submit_args_t)
+                                                                  {
+                                                                      .task = sum_range,
+                                                                      .result_size = sizeof (uint64_t),
+                                                                  }, &futures [i]);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < TEST_TASKS; i++)
+    {
+        uint64_t sum = 0;
+
+        sat_status_t status = sat_worker_future_wait (futures [i], &sum);
+        assert (sat_status_get_result (&status) == true);
+
+        bool done = false;
+        sat_worker_future_is_done (futures [i], &done);
+        assert (done == true);
+
+        total += sum;
+        sat_worker_future_destroy (futures [i]);
+    }
+
+    uint64_t n = TEST_TASKS * 100;
+    assert (total == n * (n - 1) / 2);
+
+    sat_worker_close (&worker);
+}
+
+static void test_completion_callback (void)
+{
+    sat_worker_t worker;
+    uint64_t total = 0;
+
+    test_open (&worker, 3);
+    test_completed = 0;
+
+    for (uint32_t i = 0; i < TEST_TASKS; i++)
+    {
+        range_t range = {.from = 0, .to = i + 1};
+
+        // No future: the callback alone reports the result.
+        sat_status_t status = sat_worker_submit (&worker, &range, &(sat_worker_submit_args_t)
+                                                                  {
+                                                                      .task = sum_range,
+                                                                      .result_size = sizeof (uint64_t),
+                                                                      .on_complete = on_complete,
+                                                                      .user = &total,
+                                                                  }, NULL);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    sat_status_t status = sat_worker_wait_idle (&worker);
+    assert (sat_status_get_result (&status) == true);
+
+    assert (test_completed == TEST_TASKS);
+
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < TEST_TASKS; i++)
+        expected += i * (i + 1) / 2;
+
+    assert (total == expected);
+
+    sat_worker_close (&worker);
+}
+
+static void test_wait_idle (void)
+{
+    sat_worker_t worker;
+
+    test_open (&worker, 4);
+    test_handled = 0;
+
+    for (uint32_t round = 0; round < 3; round++)
+    {
+        for (uint32_t i = 0; i < TEST_TASKS; i++)
+        {
+            sat_status_t status = sat_worker_feed (&worker, &(range_t) {0});
+            assert (sat_status_get_result (&status) == true);
+        }
+
+        sat_status_t status = sat_worker_wait_idle (&worker);
+        assert (sat_status_get_result (&status) == true);
+
+        assert (__atomic_load_n (&test_handled, __ATOMIC_RELAXED) == (round + 1) * TEST_TASKS);
+    }
+
+    // Nothing outstanding: returns at once.
+    sat_status_t status = sat_worker_wait_idle (&worker);
+    assert (sat_status_get_result (&status) == true);
+
+    sat_worker_close (&worker);
+}
+
+static void test_cancelled_on_close (void)
+{
+    sat_worker_t worker;
+    sat_worker_future_t *blocker;
+    sat_worker_future_t *queued [8];
+
+    test_open (&worker, 1);
+    test_gate = 0;
+    test_started = 0;
+
+    sat_status_t status = sat_worker_submit (&worker, &(range_t) {0}, &(sat_worker_submit_args_t) {.task = wait_gate}, &blocker);
+    assert (sat_status_get_result (&status) == true);
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        status = sat_worker_submit (&worker, &(range_t) {0}, NULL, &queued [i]);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    while (__atomic_load_n (&test_started, __ATOMIC_ACQUIRE) == 0)
+        usleep (1000);
+
+    // One handle is dropped before its task ran; the pool frees it later.
+    sat_worker_future_destroy (queued [7]);
+
+    bool done = true;
+    sat_worker_future_is_done (queued [0], &done);
+    assert (done == false);
+
+    __atomic_store_n (&test_gate, 1, __ATOMIC_RELEASE);
+    sat_worker_close (&worker);
+
+    status = sat_worker_future_wait (blocker, NULL);
+    assert (sat_status_get_result (&status) == true);
+    sat_worker_future_destroy (blocker);
+
+    // Queued behind the blocker on the single thread, so possibly never run.
+    for (uint32_t i = 0; i < 7; i++)
+    {
+        sat_worker_future_is_done (queued [i], &done);
+        assert (done == true);
+
+        sat_worker_future_wait (queued [i], NULL);
+        sat_worker_future_destroy (queued [i]);
+    }
+}
+
+static void test_invalid (void)
+{
+    sat_worker_t worker;
+    sat_worker_future_t *future = NULL;
+
+    sat_worker_init (&worker);
+
+    sat_status_t status = sat_worker_submit (&worker, &(range_t) {0}, NULL, &future);
+    assert (sat_status_get_result (&status) == false);
+    assert (future == NULL);
+
+    status = sat_worker_wait_idle (&worker);
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_worker_future_wait (NULL, NULL);
+    assert (sat_status_get_result (&status) == false);
+
+    sat_worker_close (&worker);
+}
+
+int main (int argc, char *argv[])
+{
+    test_future_result ();
+    test_completion_callback ();
+    test_wait_idle ();
+    test_cancelled_on_close ();
+    test_invalid ();
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include <sat.h>
+#include <assert.h>
+#include <string.h>
+#include <sched.h>
+
+#define TEST_THREADS_MANY   300
+#define TEST_TASKS          3000
+
+typedef struct
+{
+    uint32_t value;
+} task_t;
+
+static uint64_t test_sum;
+static int32_t test_cpu_expected;
+static uint32_t test_misplaced;
+
+static void test_handler (void *const object)
+{
+    task_t *task = (task_t *) object;
+
+    if (test_cpu_expected >= 0 && sched_getcpu () != test_cpu_expected)
+        __atomic_add_fetch (&test_misplaced, 1, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch (&test_sum, task->value, __ATOMIC_RELAXED);
+}
+
+static void test_run (sat_worker_t *const worker)
+{
+    __atomic_store_n (&test_sum, 0, __ATOMIC_RELAXED);
+
+    for (uint32_t i = 1; i <= TEST_TASKS; i++)
+    {
+        sat_status_t status = sat_worker_feed (worker, &(task_t) {.value = i});
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    sat_status_t status = sat_worker_wait_idle (worker);
+    assert (sat_status_get_result (&status) == true);
+
+    assert (__atomic_load_n (&test_sum, __ATOMIC_RELAXED) == (uint64_t) TEST_TASKS * (TEST_TASKS + 1) / 2);
+}
+
+static sat_status_t test_open (sat_worker_t *const worker, const sat_worker_args_t *const args)
+{
+    sat_worker_args_t copy = *args;
+
+    copy.handler = test_handler;
+    copy.object_size = sizeof (task_t);
+
+    sat_status_t status = sat_worker_init (worker);
+    assert (sat_status_get_result (&status) == true);
+
+    return sat_worker_open (worker, &copy);
+}
+
+static void test_many_threads (void)
+{
+    sat_worker_t worker;
+    sat_worker_stats_t stats;
+    char name [16];
+
+    test_cpu_expected = -1;
+
+    // More threads than a byte can count, each named after the pool.
+    sat_status_t status = test_open (&worker, &(sat_worker_args_t) {.pool_amount = TEST_THREADS_MANY, .name = "a_very_long_pool_name"});
+    assert (sat_status_get_result (&status) == true);
+    assert (worker.threads_amount == TEST_THREADS_MANY);
+
+    assert (pthread_getname_np (worker.threads [0], name, sizeof (name)) == 0);
+    assert (strcmp (name, "a_very_long_p/0") == 0);
+
+    assert (pthread_getname_np (worker.threads [TEST_THREADS_MANY - 1], name, sizeof (name)) == 0);
+    assert (strcmp (name, "a_very_long/299") == 0);
+
+    test_run (&worker);
+
+    status = sat_worker_get_stats (&worker, &stats);
+    assert (sat_status_get_result (&status) == true);
+    assert (stats.completed == TEST_TASKS);
+
+    sat_worker_close (&worker);
+}
+
+static void test_default_name (void)
+{
+    sat_worker_t worker;
+    char name [16];
+
+    test_cpu_expected = -1;
+
+    sat_status_t status = test_open (&worker, &(sat_worker_args_t) {.pool_amount = 2});
+    assert (sat_status_get_result (&status) == true);
+
+    assert (pthread_getname_np (worker.threads [1], name, sizeof (name)) == 0);
+    assert (strcmp (name, SAT_WORKER_NAME_DEFAULT "/1") == 0);
+
+    sat_worker_close (&worker);
+}
+
+static void test_explicit (const sat_topology_t *const topology)
+{
+    sat_worker_t worker;
+    uint32_t cpus [] = {topology->cpus [topology->cpus_amount - 1].id};
+
+    test_cpu_expected = (int32_t) cpus [0];
+    test_misplaced = 0;
+
+    // Every thread of the pool shares the single CPU given.
+    sat_status_t status = test_open (&worker, &(sat_worker_args_t)
+                                              {
+                                                  .pool_amount = 4,
+                                                  .placement = sat_worker_placement_explicit,
+                                                  .cpus = cpus,
+                                                  .cpus_amount = 1,
+                                              });
+    assert (sat_status_get_result (&status) == true);
+
+    test_run (&worker);
+    assert (test_misplaced == 0);
+
+    sat_worker_close (&worker);
+}
+
+static void test_policies (const sat_topology_t *const topology)
+{
+    sat_worker_placement_t placements [] = {sat_worker_placement_compact, sat_worker_placement_scatter};
+
+    test_cpu_expected = -1;
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        sat_worker_t worker;
+        cpu_set_t set;
+
+        // Twice as many threads as CPUs: the placement order starts over.
+        sat_status_t status = test_open (&worker, &(sat_worker_args_t)
+                                                  {
+                                                      .pool_amount = (uint16_t) (2 * topology->cpus_amount),
+                                                      .placement = placements [i],
+                                                  });
+        assert (sat_status_get_result (&status) == true);
+
+        for (uint16_t j = 0; j < worker.threads_amount; j++)
+        {
+            assert (pthread_getaffinity_np (worker.threads [j], sizeof (set), &set) == 0);
+            assert (CPU_COUNT (&set) == 1);
+        }
+
+        test_run (&worker);
+
+        sat_worker_close (&worker);
+    }
+}
+
+static void test_invalid (void)
+{
+    sat_worker_t worker;
+    uint32_t unknown [] = {100000};
+
+    sat_status_t status = test_open (&worker, &(sat_worker_args_t) {.pool_amount = 2, .placement = sat_worker_placement_explicit});
+    assert (sat_status_get_result (&status) == false);
+    sat_worker_close (&worker);
+
+    status = test_open (&worker, &(sat_worker_args_t) {.pool_amount = 2, .placement = (sat_worker_placement_t) 9});
+    assert (sat_status_get_result (&status) == false);
+    sat_worker_close (&worker);
+
+    status = test_open (&worker, &(sat_worker_args_t)
+                                 {
+                                     .pool_amount = 2,
+                                     .placement = sat_worker_placement_explicit,
+                                     .cpus = unknown,
+                                     .cpus_amount = 1,
+                                 });
+    assert (sat_status_get_result (&status) == false);
+    assert (worker.locals == NULL);
+    sat_worker_close (&worker);
+}
+
+int main (int argc, char *argv[])
+{
+    sat_topology_t topology;
+
+    sat_topology_init (&topology);
+
+    sat_status_t status = sat_topology_open (&topology, NULL);
+    assert (sat_status_get_result (&status) == true);
+
+    test_many_threads ();
+    test_default_name ();
+    test_explicit (&topology);
+    test_policies (&topology);
+    test_invalid ();
+
+    sat_topology_close (&topology);
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <sat.h>
+#include <assert.h>
+#include <sched.h>
+#include <time.h>
+
+#define TEST_TASKS          10000
+#define TEST_CHILDREN       64
+
+typedef struct
+{
+    uint32_t kind;
+    uint32_t value;
+} task_t;
+
+enum
+{
+    task_kind_count,
+    task_kind_rendezvous,
+    task_kind_spawn,
+};
+
+static sat_worker_t *test_worker;
+static uint32_t test_done;
+static uint64_t test_sum;
+static uint32_t test_arrived;
+static uint32_t test_rendezvous_failed;
+
+static void test_wait_for (uint32_t *const counter, const uint32_t expected)
+{
+    struct timespec start;
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+
+    while (__atomic_load_n (counter, __ATOMIC_ACQUIRE) < expected)
+    {
+        clock_gettime (CLOCK_MONOTONIC, &now);
+        assert (now.tv_sec - start.tv_sec < 10);
+
+        sched_yield ();
+    }
+}
+
+static void handler (void *object)
+{
+    task_t *task = (task_t *) object;
+
+    switch (task->kind)
+    {
+        case task_kind_rendezvous:
+        {
+            // Only completes if another handler is running at the same time.
+            struct timespec start;
+            struct timespec now;
+
+            __atomic_add_fetch (&test_arrived, 1, __ATOMIC_ACQ_REL);
+            clock_gettime (CLOCK_MONOTONIC, &start);
+
+            while (__atomic_load_n (&test_arrived, __ATOMIC_ACQUIRE) < 2)
+            {
+                clock_gettime (CLOCK_MONOTONIC, &now);
+                if (now.tv_sec - start.tv_sec >= 5)
+                {
+                    __atomic_store_n (&test_rendezvous_failed, 1, __ATOMIC_RELEASE);
+                    break;
+                }
+
+                sched_yield ();
+            }
+            break;
+        }
+
+        case task_kind_spawn:
+        {
+            // Children land on this thread's queue and must be stolen by the others.
+            task_t children [TEST_CHILDREN];
+
+            for (uint32_t i = 0; i < TEST_CHILDREN; i++)
+                children [i] = (task_t) {.kind = task_kind_count, .value = i + 1};
+
+            sat_status_t status = sat_worker_feed_many (test_worker, children, TEST_CHILDREN);
+            assert (sat_status_get_result (&status) == true);
+            break;
+        }
+
+        default:
+            __atomic_add_fetch (&test_sum, task->value, __ATOMIC_RELAXED);
+            break;
+    }
+
+    __atomic_add_fetch (&test_done, 1, __ATOMIC_ACQ_REL);
+}
+
+static void test_open (sat_worker_t *const worker, const uint8_t threads, const uint32_t batch_size)
+{
+    test_worker = worker;
+    test_done = 0;
+    test_sum = 0;
+
+    sat_status_t status = sat_worker_init (worker);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_worker_open (worker, &(sat_worker_args_t)
+                                      {
+                                          .handler = handler,
+                                          .object_size = sizeof (task_t),
+                                          .pool_amount = threads,
+                                          .batch_size = batch_size,
+                                      });
+    assert (sat_status_get_result (&status) == true);
+}
+
+static void test_all_tasks_run (void)
+{
+    sat_worker_t worker;
+
+    test_open (&worker, 4, 0);
+
+    for (uint32_t i = 1; i <= TEST_TASKS; i++)
+    {
+        sat_status_t status = sat_worker_feed (&worker, &(task_t) {.kind = task_kind_count, .value = i});
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    test_wait_for (&test_done, TEST_TASKS);
+    assert (test_sum == (uint64_t) TEST_TASKS * (TEST_TASKS + 1) / 2);
+
+    sat_worker_close (&worker);
+}
+
+static void test_feed_many (void)
+{
+    sat_worker_t worker;
+    task_t tasks [100];
+
+    test_open (&worker, 3, 8);
+
+    for (uint32_t i = 0; i < 100; i++)
+        tasks [i] = (task_t) {.kind = task_kind_count, .value = i + 1};
+
+    for (uint32_t round = 0; round < 10; round++)
+    {
+        sat_status_t status = sat_worker_feed_many (&worker, tasks, 100);
+        assert (sat_status_get_result (&status) == true);
+    }
+
+    sat_status_t status = sat_worker_feed_many (&worker, tasks, 0);
+    assert (sat_status_get_result (&status) == false);
+
+    test_wait_for (&test_done, 1000);
+    assert (test_sum == 10 * 5050);
+
+    sat_worker_close (&worker);
+}
+
+static void test_handlers_run_in_parallel (void)
+{
+    sat_worker_t worker;
+
+    test_open (&worker, 2, 1);
+
+    test_arrived = 0;
+    test_rendezvous_failed = 0;
+
+    sat_worker_feed (&worker, &(task_t) {.kind = task_kind_rendezvous});
+    sat_worker_feed (&worker, &(task_t) {.kind = task_kind_rendezvous});
+
+    test_wait_for (&test_done, 2);
+    assert (test_rendezvous_failed == 0);
+
+    sat_worker_close (&worker);
+}
+
+static void test_spawned_tasks_are_stolen (void)
+{
+    sat_worker_t worker;
+
+    test_open (&worker, 4, 4);
+
+    for (uint32_t i = 0; i < 10; i++)
+        sat_worker_feed (&worker, &(task_t) {.kind = task_kind_spawn});
+
+    test_wait_for (&test_done, 10 + 10 * TEST_CHILDREN);
+    assert (test_sum == 10 * (TEST_CHILDREN * (TEST_CHILDREN + 1) / 2));
+
+    sat_worker_close (&worker);
+}
+
+static void test_invalid (void)
+{
+    sat_worker_t worker;
+
+    sat_status_t status = sat_worker_init (&worker);
+    assert (sat_status_get_result (&status) == true);
+
+    status = sat_worker_feed (&worker, &(task_t) {0});
+    assert (sat_status_get_result (&status) == false);
+
+    status = sat_worker_open (&worker, &(sat_worker_args_t) {.handler = handler, .object_size = sizeof (task_t)});
+    assert (sat_status_get_result (&status) == false);
+
+    sat_worker_close (&worker);
+}
+
+int main (int argc, char *argv[])
+{
+    test_all_tasks_run ();
+    test_feed_many ();
+    test_handlers_run_in_parallel ();
+    test_spawned_tasks_are_stolen ();
+    test_invalid ();
+
+    return 0;
+}
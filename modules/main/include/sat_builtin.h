@@ -1,10 +1,17 @@
 #include <sat_status.h>
+#include <sat_reactor.h>
+#include <sat_reactor_group.h>
+#include <sat_coro.h>
+#include <sat_allocator.h>
+#include <sat_topology.h>
+#include <sat_arena.h>
 #include <sat_iterator.h>
 #include <sat_array.h>
 #include <sat_cache.h>
 #include <sat_plugin.h>
 #include <sat_uuid.h>
 #include <sat_queue.h>
+#include <sat_ring.h>
 #include <sat_linked_list.h>
 #include <sat_directory.h>
 #include <sat_set.h>
@@ -13,6 +20,7 @@
 #include <sat_udp.h>
 #include <sat_network.h>
 #include <sat_worker.h>
+#include <sat_parallel.h>
 #include <sat_time.h>
 #include <sat_stack.h>
 #include <sat_process.h>
@@ -21,6 +29,7 @@
 #include <sat_validation.h>
 #include <sat_log.h>
 #include <sat_map.h>
+#include <sat_concurrent_map.h>
 #include <sat_tcp.h>
 #include <sat_scheduler.h>
 #include <sat_shared_memory.h>